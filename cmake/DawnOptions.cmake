@@ -26,6 +26,8 @@ option(DAWN_PYTHON "Build and install the Python module" ON)
 
 # Testing
 option(DAWN_TESTING "Enable testing" ON)
+option(DAWN_DIFFERENTIAL_TESTING "Enable differential execution testing of the generated code" ON)
+option(DAWN_BENCHMARKS "Enable benchmarks" OFF)
 
 # Documentation
 option(DAWN_DOCUMENTATION "Enable documentation" OFF)
@@ -35,5 +37,7 @@ mchbuild_export_options(DAWN
   DAWN_ASSERTS 
   DAWN_USE_CCACHE
   DAWN_TESTING
+  DAWN_DIFFERENTIAL_TESTING
+  DAWN_BENCHMARKS
   DAWN_DOCUMENTATION
 )
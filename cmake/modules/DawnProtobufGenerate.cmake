@@ -36,12 +36,14 @@ include(CMakeParseArguments)
 #   the generated sources (C++ only).
 # ``PROTOS``
 #   List of proto files to compile.
+# ``INCLUDE_DIRS``
+#   List of additional directories in which to search for imported proto files.
 # ``LANGUAGE``
 #   Language to compile to [default: cpp]. 
 #
 function(dawn_protobuf_generate)
   set(one_value_args OUT_FILES OUT_INCLUDE_DIRS LANGUAGE)
-  set(multi_value_args PROTOS)
+  set(multi_value_args PROTOS INCLUDE_DIRS)
   cmake_parse_arguments(ARG "${options}" "${one_value_args}" "${multi_value_args}" ${ARGN})
 
   if(NOT("${ARG_UNPARSED_ARGUMENTS}" STREQUAL ""))
@@ -82,6 +84,11 @@ function(dawn_protobuf_generate)
     endif()
   endforeach()
 
+  foreach(dir ${ARG_INCLUDE_DIRS})
+    get_filename_component(abs_path ${dir} ABSOLUTE)
+    list(APPEND include_path "-I${abs_path}")
+  endforeach()
+
   # Generate a script to invoke protoc (this is needed to set the LD_LIBRARY_PATH as google 
   # doesn't know about RPATH support in CMake ...)
   get_property(libprotoc_loc TARGET protobuf::libprotoc PROPERTY LOCATION)
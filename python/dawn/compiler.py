@@ -0,0 +1,418 @@
+#!/usr/bin/python3
+# -*- coding: utf-8 -*-
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##                          _                      
+##                         | |                     
+##                       __| | __ ___      ___ ___  
+##                      / _` |/ _` \ \ /\ / / '_  | 
+##                     | (_| | (_| |\ V  V /| | | |
+##                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+##
+##
+##  This file is distributed under the MIT License (MIT). 
+##  See LICENSE.txt for details.
+##
+##===------------------------------------------------------------------------------------------===##
+
+""" In-process compilation of SIRs via the C API of Dawn (libDawnC)
+
+The serialized protobuf bytes of a `SIR` are passed directly to the compiler, i.e there is no JSON
+round trip and no external process. The compilations release the GIL (the C library is called via
+ctypes), so several Python threads can compile concurrently. `compile_batch` and `compile_async`
+run the compilations on the internal thread pool of Dawn. The entry point is named `compile_sir` to
+not shadow the builtin `compile` on `from dawn.compiler import *`.
+
+The shared library is located via the environment variable `DAWN_C_LIBRARY` or, if unset, the
+install location recorded in `dawn.config`.
+"""
+
+from collections import namedtuple
+from ctypes import (CDLL, POINTER, Structure, byref, c_char, c_char_p, c_double, c_int, c_size_t,
+                    c_void_p, string_at)
+from enum import IntEnum
+from os import environ
+from threading import Lock
+from typing import Dict, List, Union
+
+from dawn.error import CompileError
+
+
+class CodeGenKind(IntEnum):
+    """ Code generation backend (`DawnCodeGenKind`) """
+    GTClang = 0
+    GTClangNaiveCXX = 1
+    GTClangOptCXX = 2
+
+
+class DiagnosticsKind(IntEnum):
+    """ Kind of a diagnostic (`DawnDiagnosticsKind`) """
+    Note = 0
+    Warning = 1
+    Error = 2
+
+
+class DawnTypeKind(IntEnum):
+    """ Type of an option (`DawnTypeKind`) """
+    Integer = 0
+    Double = 1
+    Char = 2
+
+
+Diagnostic = namedtuple('Diagnostic', ['kind', 'line', 'column', 'filename', 'message'])
+Diagnostic.__doc__ = """ Diagnostic emitted during compilation """
+
+
+class _dawnDiagnostic(Structure):
+    _fields_ = [('Kind', c_int), ('Line', c_int), ('Column', c_int), ('Filename', c_char_p),
+                ('Message', c_char_p)]
+
+
+class _dawnOptionsEntry(Structure):
+    _fields_ = [('Type', c_int), ('SizeInBytes', c_size_t), ('Value', c_void_p)]
+
+
+_library = None
+_library_lock = Lock()
+
+
+def _declare(library, name, restype, *argtypes):
+    function = getattr(library, name)
+    function.restype = restype
+    function.argtypes = list(argtypes)
+
+
+def _load_library() -> CDLL:
+    """ Load libDawnC (once) and declare the used functions """
+    global _library
+    with _library_lock:
+        if _library is None:
+            path = environ.get('DAWN_C_LIBRARY')
+            if not path:
+                from dawn.config import __dawn_install_dawnc_library__
+                path = __dawn_install_dawnc_library__
+
+            library = CDLL(path)
+            diagnostics = POINTER(POINTER(_dawnDiagnostic))
+            _declare(library, 'dawnCompileWithDiagnostics', c_void_p, c_char_p, c_size_t, c_void_p,
+                     c_int, c_void_p, c_void_p, diagnostics, POINTER(c_int))
+            _declare(library, 'dawnCompileBatch', c_int, POINTER(c_char_p), POINTER(c_size_t),
+                     c_int, c_void_p, c_int, POINTER(c_void_p), POINTER(POINTER(_dawnDiagnostic)),
+                     POINTER(c_int))
+            _declare(library, 'dawnCompileAsync', c_void_p, c_char_p, c_size_t, c_void_p, c_int,
+                     c_void_p, c_void_p)
+            _declare(library, 'dawnCompileFuturePoll', c_int, c_void_p)
+            _declare(library, 'dawnCompileFutureWait', None, c_void_p)
+            _declare(library, 'dawnCompileFutureGetWithDiagnostics', c_void_p, c_void_p, c_void_p,
+                     c_void_p, diagnostics, POINTER(c_int))
+            _declare(library, 'dawnCompileFutureDestroy', None, c_void_p)
+            _declare(library, 'dawnDiagnosticsDestroy', None, POINTER(_dawnDiagnostic), c_int)
+
+            _declare(library, 'dawnTranslationUnitDestroy', None, c_void_p)
+            _declare(library, 'dawnTranslationUnitViewStencil', c_int, c_void_p, c_char_p,
+                     POINTER(c_void_p), POINTER(c_size_t))
+            _declare(library, 'dawnTranslationUnitViewGlobals', None, c_void_p, POINTER(c_void_p),
+                     POINTER(c_size_t))
+            _declare(library, 'dawnTranslationUnitGetNumPPDefines', c_int, c_void_p)
+            _declare(library, 'dawnTranslationUnitViewPPDefine', None, c_void_p, c_int,
+                     POINTER(c_void_p), POINTER(c_size_t))
+            _declare(library, 'dawnTranslationUnitGetStencilIterator', c_void_p, c_void_p)
+            _declare(library, 'dawnStencilIteratorNext', c_int, c_void_p, POINTER(c_void_p),
+                     POINTER(c_size_t), POINTER(c_void_p), POINTER(c_size_t))
+            _declare(library, 'dawnStencilIteratorDestroy', None, c_void_p)
+
+            _declare(library, 'dawnOptionsCreate', c_void_p)
+            _declare(library, 'dawnOptionsDestroy', None, c_void_p)
+            _declare(library, 'dawnOptionsHas', c_int, c_void_p, c_char_p)
+            _declare(library, 'dawnOptionsGet', POINTER(_dawnOptionsEntry), c_void_p, c_char_p)
+            _declare(library, 'dawnOptionsSet', None, c_void_p, c_char_p,
+                     POINTER(_dawnOptionsEntry))
+            _declare(library, 'dawnOptionsEntryCreateInteger', POINTER(_dawnOptionsEntry), c_int)
+            _declare(library, 'dawnOptionsEntryCreateDouble', POINTER(_dawnOptionsEntry), c_double)
+            _declare(library, 'dawnOptionsEntryCreateString', POINTER(_dawnOptionsEntry), c_char_p)
+            _declare(library, 'dawnOptionsEntryDestroy', None, POINTER(_dawnOptionsEntry))
+            _library = library
+    return _library
+
+
+class TranslationUnit:
+    """ Generated code of a compilation
+
+    The code is owned by the C library, the `*_view` methods return `memoryview`s of it which keep
+    the translation unit alive (no copy is made). The other accessors return Python strings.
+    """
+
+    def __init__(self, handle: int, diagnostics: List[Diagnostic]):
+        self._library = _load_library()
+        self._handle = handle
+        self.diagnostics = diagnostics
+
+    def __del__(self):
+        if getattr(self, '_handle', None):
+            self._library.dawnTranslationUnitDestroy(self._handle)
+            self._handle = None
+
+    def _view(self, data: c_void_p, size: c_size_t) -> memoryview:
+        buffer = (c_char * size.value).from_address(data.value) if size.value else bytearray()
+        # The buffer references the memory of the translation unit, keep it alive
+        if size.value:
+            buffer._translation_unit = self
+        return memoryview(buffer).cast('B')
+
+    def stencil_view(self, name: str) -> memoryview:
+        """ Get a view of the generated code of the stencil `name`
+
+        :raises KeyError: There is no stencil `name`
+        """
+        data, size = c_void_p(), c_size_t()
+        if not self._library.dawnTranslationUnitViewStencil(self._handle, name.encode(),
+                                                            byref(data), byref(size)):
+            raise KeyError(name)
+        return self._view(data, size)
+
+    def globals_view(self) -> memoryview:
+        """ Get a view of the generated code of the global variables """
+        data, size = c_void_p(), c_size_t()
+        self._library.dawnTranslationUnitViewGlobals(self._handle, byref(data), byref(size))
+        return self._view(data, size)
+
+    def get_stencil(self, name: str) -> str:
+        """ Get the generated code of the stencil `name`
+
+        :raises KeyError: There is no stencil `name`
+        """
+        return self.stencil_view(name).tobytes().decode()
+
+    def get_globals(self) -> str:
+        """ Get the generated code of the global variables """
+        return self.globals_view().tobytes().decode()
+
+    def get_pp_defines(self) -> List[str]:
+        """ Get the preprocessor defines required by the generated code """
+        defines = []
+        data, size = c_void_p(), c_size_t()
+        for i in range(self._library.dawnTranslationUnitGetNumPPDefines(self._handle)):
+            self._library.dawnTranslationUnitViewPPDefine(self._handle, i, byref(data),
+                                                          byref(size))
+            defines.append(string_at(data, size.value).decode())
+        return defines
+
+    def get_stencils(self) -> Dict[str, str]:
+        """ Get the generated code of all stencils (mapped by name) """
+        stencils = {}
+        iterator = self._library.dawnTranslationUnitGetStencilIterator(self._handle)
+        name, name_size, code, code_size = c_void_p(), c_size_t(), c_void_p(), c_size_t()
+        while self._library.dawnStencilIteratorNext(iterator, byref(name), byref(name_size),
+                                                    byref(code), byref(code_size)):
+            stencils[string_at(name, name_size.value).decode()] = string_at(
+                code, code_size.value).decode()
+        self._library.dawnStencilIteratorDestroy(iterator)
+        return stencils
+
+
+class _Options:
+    """ `dawnOptions_t` built from a dictionary mapping option names (e.g 'SplitStencils') to values
+    """
+
+    def __init__(self, library: CDLL, options: Dict[str, Union[bool, int, float, str]]):
+        self._library = library
+        self.handle = library.dawnOptionsCreate() if options else None
+        try:
+            for name, value in (options or {}).items():
+                self._set(name.encode(), value)
+        except:
+            self.destroy()
+            raise
+
+    def _set(self, name: bytes, value):
+        if not self._library.dawnOptionsHas(self.handle, name):
+            raise KeyError("unknown option '{}'".format(name.decode()))
+
+        current = self._library.dawnOptionsGet(self.handle, name)
+        kind = current.contents.Type
+        self._library.dawnOptionsEntryDestroy(current)
+
+        if kind == DawnTypeKind.Integer and isinstance(value, (bool, int)):
+            entry = self._library.dawnOptionsEntryCreateInteger(int(value))
+        elif kind == DawnTypeKind.Double and isinstance(value, (int, float)):
+            entry = self._library.dawnOptionsEntryCreateDouble(float(value))
+        elif kind == DawnTypeKind.Char and isinstance(value, str):
+            entry = self._library.dawnOptionsEntryCreateString(value.encode())
+        else:
+            raise TypeError("invalid value {!r} for option '{}' of type {}".format(
+                value, name.decode(), DawnTypeKind(kind).name))
+        self._library.dawnOptionsSet(self.handle, name, entry)
+        self._library.dawnOptionsEntryDestroy(entry)
+
+    def destroy(self):
+        if self.handle:
+            self._library.dawnOptionsDestroy(self.handle)
+            self.handle = None
+
+
+def _serialize(sir) -> bytes:
+    """ Get the serialized protobuf bytes of `sir` (a `SIR` message or bytes) """
+    return bytes(sir) if isinstance(sir, (bytes, bytearray)) else sir.SerializeToString()
+
+
+def _wrap_result(library: CDLL, handle, array, num: int) -> TranslationUnit:
+    """ Wrap the translation unit `handle` and take ownership of its `num` diagnostics `array`
+
+    :raises CompileError: The compilation failed (`handle` is null)
+    """
+    diagnostics = []
+    for i in range(num):
+        d = array[i]
+        diagnostics.append(Diagnostic(DiagnosticsKind(d.Kind), d.Line, d.Column,
+                                      d.Filename.decode(), d.Message.decode()))
+    library.dawnDiagnosticsDestroy(array, num)
+
+    if not handle:
+        errors = [d.message for d in diagnostics if d.kind == DiagnosticsKind.Error]
+        raise CompileError("compilation failed: " + ("; ".join(errors) or "unknown error"),
+                           diagnostics)
+    return TranslationUnit(handle, diagnostics)
+
+
+def _take_result(library: CDLL, get_result) -> TranslationUnit:
+    """ Run `get_result(diagnostics, num_diagnostics)` and wrap the translation unit it returns
+
+    :raises CompileError: The compilation failed
+    """
+    array, num = POINTER(_dawnDiagnostic)(), c_int(0)
+    handle = get_result(byref(array), byref(num))
+    return _wrap_result(library, handle, array, num.value)
+
+
+def compile_sir(sir, backend: CodeGenKind = CodeGenKind.GTClang,
+                options: Dict[str, Union[bool, int, float, str]] = None) -> TranslationUnit:
+    """ Compile `sir` and return the generated code
+
+    The GIL is released during the compilation.
+
+    :param sir:      `SIR` message or its serialized protobuf bytes
+    :param backend:  Code generation backend
+    :param options:  Compiler options mapped by name (e.g `{'SplitStencils': True}`)
+    :raises CompileError: The compilation failed
+    """
+    library = _load_library()
+    data = _serialize(sir)
+    compile_options = _Options(library, options)
+    try:
+        return _take_result(library, lambda diagnostics, num: library.dawnCompileWithDiagnostics(
+            data, len(data), compile_options.handle, int(backend), None, None, diagnostics, num))
+    finally:
+        compile_options.destroy()
+
+
+class Future:
+    """ Compilation running on the thread pool of Dawn (see `compile_async`) """
+
+    def __init__(self, library: CDLL, handle: int):
+        self._library = library
+        self._handle = handle
+        self._result = None
+
+    def __del__(self):
+        if getattr(self, '_handle', None):
+            self._library.dawnCompileFutureDestroy(self._handle)
+            self._handle = None
+
+    def done(self) -> bool:
+        """ Check if the compilation finished (never blocks) """
+        return self._result is not None or bool(self._library.dawnCompileFuturePoll(self._handle))
+
+    def wait(self):
+        """ Block until the compilation finished (the GIL is released while waiting) """
+        if self._result is None:
+            self._library.dawnCompileFutureWait(self._handle)
+
+    def result(self) -> TranslationUnit:
+        """ Block until the compilation finished and return the generated code
+
+        :raises CompileError: The compilation failed
+        """
+        if self._result is None:
+            try:
+                self._result = _take_result(
+                    self._library,
+                    lambda diagnostics, num: self._library.dawnCompileFutureGetWithDiagnostics(
+                        self._handle, None, None, diagnostics, num))
+            except CompileError as e:
+                self._result = e
+        if isinstance(self._result, CompileError):
+            raise self._result
+        return self._result
+
+
+def compile_async(sir, backend: CodeGenKind = CodeGenKind.GTClang,
+                  options: Dict[str, Union[bool, int, float, str]] = None) -> Future:
+    """ Start compiling `sir` on the thread pool of Dawn
+
+    :param sir:      `SIR` message or its serialized protobuf bytes
+    :param backend:  Code generation backend
+    :param options:  Compiler options mapped by name
+    """
+    library = _load_library()
+    data = _serialize(sir)
+    compile_options = _Options(library, options)
+    try:
+        return Future(library, library.dawnCompileAsync(data, len(data), compile_options.handle,
+                                                        int(backend), None, None))
+    finally:
+        compile_options.destroy()
+
+
+def compile_batch(sirs, backend: CodeGenKind = CodeGenKind.GTClang,
+                  options: Dict[str, Union[bool, int, float, str]] = None) -> List[TranslationUnit]:
+    """ Compile all `sirs` concurrently on the thread pool of Dawn
+
+    The GIL is released until all compilations finished.
+
+    :param sirs:     `SIR` messages or their serialized protobuf bytes
+    :param backend:  Code generation backend
+    :param options:  Compiler options mapped by name
+    :raises CompileError: At least one compilation failed, the results (`None` for the failed
+                          compilations) are available as `results` of the exception
+    """
+    library = _load_library()
+    data = [_serialize(sir) for sir in sirs]
+    num = len(data)
+    handles = (c_void_p * num)()
+    arrays = (POINTER(_dawnDiagnostic) * num)()
+    nums = (c_int * num)()
+
+    compile_options = _Options(library, options)
+    try:
+        library.dawnCompileBatch((c_char_p * num)(*data), (c_size_t * num)(*map(len, data)), num,
+                                 compile_options.handle, int(backend), handles, arrays, nums)
+    finally:
+        compile_options.destroy()
+
+    results, failures = [], []
+    for index in range(num):
+        try:
+            results.append(_wrap_result(library, handles[index], arrays[index], nums[index]))
+        except CompileError as e:
+            results.append(None)
+            failures.append((index, e))
+
+    if failures:
+        error = CompileError(
+            "{} of {} compilations failed: ".format(len(failures), num) + "; ".join(
+                "[{}] {}".format(index, e) for index, e in failures),
+            [d for _, e in failures for d in e.diagnostics])
+        error.results = results
+        raise error
+    return results
+
+
+__all__ = [
+    'CodeGenKind',
+    'DiagnosticsKind',
+    'Diagnostic',
+    'TranslationUnit',
+    'Future',
+    'compile_sir',
+    'compile_async',
+    'compile_batch',
+]
@@ -27,3 +27,14 @@ class ParseError(Error):
 class SIRError(Error):
     """ Thrown in case of an invalid SIR configuration. """
     pass
+
+
+class CompileError(Error):
+    """ Thrown in case of a failed compilation.
+
+    The diagnostics of the compilation are available as `diagnostics`.
+    """
+
+    def __init__(self, message, diagnostics=()):
+        super().__init__(message)
+        self.diagnostics = list(diagnostics)
@@ -14,7 +14,7 @@
 ##
 ##===------------------------------------------------------------------------------------------===##
 
-from collections import Iterable
+from collections.abc import Iterable
 from sys import path as sys_path
 from typing import List, TypeVar
 
@@ -225,7 +225,7 @@ def makeExpr(expr: ExprType):
     elif isinstance(expr, VarAccessExpr):
         wrapped_expr.var_access_expr.CopyFrom(expr)
     elif isinstance(expr, FieldAccessExpr):
-        wrapped_expr.var_access_expr.CopyFrom(expr)
+        wrapped_expr.field_access_expr.CopyFrom(expr)
     elif isinstance(expr, LiteralAccessExpr):
         wrapped_expr.literal_access_expr.CopyFrom(expr)
     else:
@@ -252,11 +252,11 @@ def makeStmt(stmt: StmtType):
     elif isinstance(stmt, VarDeclStmt):
         wrapped_stmt.var_decl_stmt.CopyFrom(stmt)
     elif isinstance(stmt, VerticalRegionDeclStmt):
-        wrapped_stmt.var_decl_stmt.CopyFrom(stmt)
+        wrapped_stmt.vertical_region_decl_stmt.CopyFrom(stmt)
     elif isinstance(stmt, StencilCallDeclStmt):
-        wrapped_stmt.var_decl_stmt.CopyFrom(stmt)
+        wrapped_stmt.stencil_call_decl_stmt.CopyFrom(stmt)
     elif isinstance(stmt, BoundaryConditionDeclStmt):
-        wrapped_stmt.var_decl_stmt.CopyFrom(stmt)
+        wrapped_stmt.boundary_condition_decl_stmt.CopyFrom(stmt)
     elif isinstance(stmt, IfStmt):
         wrapped_stmt.if_stmt.CopyFrom(stmt)
     else:
@@ -0,0 +1,179 @@
+#!/usr/bin/python3
+# -*- coding: utf-8 -*-
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##                          _                      
+##                         | |                     
+##                       __| | __ ___      ___ ___  
+##                      / _` |/ _` \ \ /\ / / '_  | 
+##                     | (_| | (_| |\ V  V /| | | |
+##                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+##
+##
+##  This file is distributed under the MIT License (MIT). 
+##  See LICENSE.txt for details.
+##
+##===------------------------------------------------------------------------------------------===##
+
+""" Generator of synthetic, parameterized SIRs
+
+The generated stencils have a known shape which makes them suitable for measuring how the compiler
+scales with the size of its input (see `test/benchmark/dawn/Compiler`):
+
+  - `num_stencils` stencils, each with
+  - `num_stages` statements forming a chain of temporaries read at horizontal offsets (every
+    statement ends up in its own stage),
+  - `num_fields` fields (`num_fields - 1` input fields and the output field),
+  - calls to stencil functions nested `call_depth` levels deep (a Laplacian at the innermost
+    level), and
+  - `num_intervals` vertical regions covering the vertical domain.
+
+Usage (writes Byte encoded SIRs, one per value of the swept parameter):
+
+    python3 -m dawn.synthetic --stencils 4 --stages 8 --sweep fields 2,4,8,16 -o synthetic
+"""
+
+import argparse
+from os import path
+from sys import path as sys_path
+from typing import List
+
+sys_path.insert(1, path.join(path.dirname(path.realpath(__file__)), ".."))
+
+from dawn.error import SIRError
+from dawn.sir import *
+from dawn.sir import ExprType, StencilFunctionArg
+
+
+def _lap(make_access) -> ExprType:
+    """ Five point Laplacian of the field accessed by `make_access(offset)` """
+    return makeBinaryOperator(
+        makeBinaryOperator(
+            makeBinaryOperator(make_access([1, 0, 0]), "+", make_access([-1, 0, 0])), "+",
+            makeBinaryOperator(make_access([0, 1, 0]), "+", make_access([0, -1, 0]))), "-",
+        makeBinaryOperator(makeLiteralAccessExpr("4.0", BuiltinType.Float), "*",
+                           make_access([0, 0, 0])))
+
+
+def makeSyntheticStencilFunctions(call_depth: int) -> List[StencilFunction]:
+    """ Create the stencil functions `fun_1` ... `fun_<call_depth>`
+
+    `fun_1(in)` computes the Laplacian of `in`, `fun_<d>(in)` returns `fun_<d-1>(in) + in`.
+    """
+    functions = []
+    for depth in range(1, call_depth + 1):
+        if depth == 1:
+            body = _lap(lambda offset: makeFieldAccessExpr("in", offset))
+        else:
+            body = makeBinaryOperator(
+                makeStencilFunCallExpr("fun_{}".format(depth - 1), [makeFieldAccessExpr("in")]),
+                "+", makeFieldAccessExpr("in"))
+
+        argument = StencilFunctionArg()
+        argument.field_value.CopyFrom(makeField("in"))
+
+        function = StencilFunction()
+        function.name = "fun_{}".format(depth)
+        function.arguments.extend([argument])
+        function.asts.extend([makeAST(makeBlockStmt([makeReturnStmt(body)]))])
+        functions.append(function)
+    return functions
+
+
+def makeSyntheticStencil(name: str, num_stages: int, num_fields: int, call_depth: int,
+                         num_intervals: int) -> Stencil:
+    """ Create a stencil `name` (see module documentation for the meaning of the parameters) """
+    if num_stages < 1 or num_fields < 2 or call_depth < 0 or num_intervals < 1:
+        raise SIRError("invalid parameters of a synthetic stencil")
+
+    inputs = ["in_{}".format(i) for i in range(num_fields - 1)]
+    temporaries = ["tmp_{}".format(i) for i in range(num_stages - 1)]
+    targets = temporaries + ["out"]
+
+    # Stage `i` computes `targets[i]` from `targets[i - 1]` (or the first input) at offsets
+    statements = []
+    for stage, target in enumerate(targets):
+        source = temporaries[stage - 1] if stage > 0 else inputs[0]
+        if call_depth > 0:
+            value = makeStencilFunCallExpr("fun_{}".format(call_depth),
+                                           [makeFieldAccessExpr(source)])
+        else:
+            value = _lap(lambda offset: makeFieldAccessExpr(source, offset))
+        value = makeBinaryOperator(value, "+",
+                                   makeFieldAccessExpr(inputs[(stage + 1) % len(inputs)]))
+        statements.append(makeExprStmt(makeAssignmentExpr(makeFieldAccessExpr(target), value)))
+
+    # Split the vertical domain into `num_intervals` intervals (the last one spans the remainder)
+    vertical_regions = []
+    for i in range(num_intervals):
+        upper = (Interval.Start, i) if i < num_intervals - 1 else (Interval.End, 0)
+        interval = makeInterval(Interval.Start, upper[0], i, upper[1])
+        vertical_regions.append(makeVerticalRegionDeclStmt(makeVerticalRegion(
+            makeAST(makeBlockStmt(statements)), interval, VerticalRegion.Forward)))
+
+    stencil = Stencil()
+    stencil.name = name
+    stencil.fields.extend([makeField(f) for f in inputs + ["out"]])
+    stencil.fields.extend([makeField(f, is_temporary=True) for f in temporaries])
+    stencil.ast.CopyFrom(makeAST(makeBlockStmt(vertical_regions)))
+    return stencil
+
+
+def makeSyntheticSIR(num_stencils: int = 1, num_stages: int = 1, num_fields: int = 2,
+                     call_depth: int = 0, num_intervals: int = 1) -> SIR:
+    """ Create a synthetic SIR (see module documentation for the meaning of the parameters) """
+    sir = SIR()
+    sir.filename = "synthetic.cpp"
+    sir.stencil_functions.extend(makeSyntheticStencilFunctions(call_depth))
+    sir.stencils.extend([
+        makeSyntheticStencil("stencil_{}".format(i), num_stages, num_fields, call_depth,
+                             num_intervals) for i in range(num_stencils)])
+    return sir
+
+
+def main(argv=None):
+    parameters = ["stencils", "stages", "fields", "call_depth", "intervals"]
+
+    parser = argparse.ArgumentParser(description="Generate synthetic SIRs")
+    parser.add_argument("--stencils", type=int, default=1, help="number of stencils")
+    parser.add_argument("--stages", type=int, default=1, help="number of stages per stencil")
+    parser.add_argument("--fields", type=int, default=2, help="number of fields per stencil")
+    parser.add_argument("--call-depth", type=int, default=0, help="depth of the function calls")
+    parser.add_argument("--intervals", type=int, default=1, help="number of vertical intervals")
+    parser.add_argument("--sweep", nargs=2, metavar=("PARAMETER", "VALUES"),
+                        help="generate one SIR per value of the comma separated list VALUES of "
+                             "PARAMETER (one of {})".format(", ".join(parameters)))
+    parser.add_argument("--json", action="store_true", help="write JSON instead of Byte SIRs")
+    parser.add_argument("-o", "--output", default="synthetic", help="prefix of the output files")
+    args = parser.parse_args(argv)
+
+    sweep = [None]
+    if args.sweep:
+        parameter = args.sweep[0].replace("-", "_")
+        if parameter not in parameters:
+            parser.error("unknown parameter '{}'".format(args.sweep[0]))
+        sweep = [int(value) for value in args.sweep[1].split(",")]
+
+    for value in sweep:
+        config = {p: getattr(args, p) for p in parameters}
+        filename = args.output
+        if value is not None:
+            config[parameter] = value
+            filename += "_{}_{}".format(parameter, value)
+        filename += ".sir"
+
+        sir = makeSyntheticSIR(config["stencils"], config["stages"], config["fields"],
+                               config["call_depth"], config["intervals"])
+        with open(filename, "w" if args.json else "wb") as file:
+            file.write(to_json(sir) if args.json else sir.SerializeToString())
+        print(filename)
+
+
+if __name__ == "__main__":
+    main()
+
+
+__all__ = [
+    'makeSyntheticStencilFunctions',
+    'makeSyntheticStencil',
+    'makeSyntheticSIR',
+]
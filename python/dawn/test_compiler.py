@@ -0,0 +1,133 @@
+#!/usr/bin/python3
+# -*- coding: utf-8 -*-
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##                          _                      
+##                         | |                     
+##                       __| | __ ___      ___ ___  
+##                      / _` |/ _` \ \ /\ / / '_  | 
+##                     | (_| | (_| |\ V  V /| | | |
+##                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+##
+##
+##  This file is distributed under the MIT License (MIT). 
+##  See LICENSE.txt for details.
+##
+##===------------------------------------------------------------------------------------------===##
+
+from os import path
+from sys import path as sys_path
+
+sys_path.insert(1, path.join(path.dirname(path.realpath(__file__)), ".."))
+
+import threading
+import unittest
+
+from dawn.compiler import *
+from dawn.error import CompileError
+from dawn.sir import *
+
+
+def makeCopyStencilSIR() -> SIR:
+    """ Create a SIR with the stencil `copy` computing `out = in` """
+    vr = makeVerticalRegion(
+        makeAST(makeBlockStmt([makeExprStmt(
+            makeAssignmentExpr(makeFieldAccessExpr("out"), makeFieldAccessExpr("in")))])),
+        makeInterval(Interval.Start, Interval.End), VerticalRegion.Forward)
+
+    stencil = Stencil()
+    stencil.name = "copy"
+    stencil.fields.extend([makeField("in"), makeField("out")])
+    stencil.ast.CopyFrom(makeAST(makeBlockStmt([makeVerticalRegionDeclStmt(vr)])))
+
+    sir = SIR()
+    sir.filename = "test_compiler.py"
+    sir.stencils.extend([stencil])
+    return sir
+
+
+def libraryAvailable() -> bool:
+    """ Check if libDawnC can be loaded """
+    try:
+        from dawn.compiler import _load_library
+        _load_library()
+        return True
+    except (ImportError, OSError):
+        return False
+
+
+@unittest.skipUnless(libraryAvailable(), "libDawnC is not available")
+class TestCompile(unittest.TestCase):
+    def test_compile(self):
+        tu = compile_sir(makeCopyStencilSIR())
+        self.assertEqual(list(tu.get_stencils().keys()), ["copy"])
+        self.assertIn("copy", tu.get_stencil("copy"))
+        self.assertNotEqual(tu.get_pp_defines(), [])
+
+    def test_serialized_input(self):
+        sir = makeCopyStencilSIR()
+        self.assertEqual(compile_sir(sir.SerializeToString()).get_stencil("copy"),
+                         compile_sir(sir).get_stencil("copy"))
+
+    def test_views(self):
+        tu = compile_sir(makeCopyStencilSIR())
+        view = tu.stencil_view("copy")
+        code = tu.get_stencil("copy")
+        del tu
+        # The view keeps the translation unit alive
+        self.assertEqual(view.tobytes().decode(), code)
+
+    def test_unknown_stencil(self):
+        tu = compile_sir(makeCopyStencilSIR())
+        with self.assertRaises(KeyError):
+            tu.get_stencil("invalid")
+
+    def test_options(self):
+        tu = compile_sir(makeCopyStencilSIR(), CodeGenKind.GTClangNaiveCXX, {'KeepVarnames': True})
+        self.assertIn("copy", tu.get_stencils())
+        with self.assertRaises(KeyError):
+            compile_sir(makeCopyStencilSIR(), options={'invalid': 1})
+        with self.assertRaises(TypeError):
+            compile_sir(makeCopyStencilSIR(), options={'KeepVarnames': "yes"})
+
+    def test_failure(self):
+        with self.assertRaises(CompileError) as context:
+            compile_sir(b"invalid")
+        self.assertEqual(context.exception.diagnostics[0].kind, DiagnosticsKind.Error)
+
+
+@unittest.skipUnless(libraryAvailable(), "libDawnC is not available")
+class TestConcurrentCompile(unittest.TestCase):
+    def test_batch(self):
+        sir = makeCopyStencilSIR()
+        reference = compile_sir(sir).get_stencil("copy")
+        tus = compile_batch([sir] * 4)
+        self.assertEqual([tu.get_stencil("copy") for tu in tus], [reference] * 4)
+
+    def test_batch_failure(self):
+        sir = makeCopyStencilSIR()
+        with self.assertRaises(CompileError) as context:
+            compile_batch([sir, b"invalid", sir])
+        self.assertEqual([tu is None for tu in context.exception.results], [False, True, False])
+
+    def test_async(self):
+        future = compile_async(makeCopyStencilSIR())
+        future.wait()
+        self.assertTrue(future.done())
+        self.assertIn("copy", future.result().get_stencils())
+
+    def test_threads(self):
+        sir = makeCopyStencilSIR()
+        results = []
+        threads = [
+            threading.Thread(target=lambda: results.append(compile_sir(sir).get_stencil("copy")))
+            for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(len(results), 4)
+        self.assertEqual(len(set(results)), 1)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -15,62 +15,46 @@
 #include "dawn-c/Compiler.h"
 #include "dawn-c/ErrorHandling.h"
 #include "dawn-c/util/Allocate.h"
+#include "dawn-c/util/CompileFutureWrapper.h"
 #include "dawn-c/util/CompilerWrapper.h"
 #include "dawn-c/util/OptionsWrapper.h"
-#include "dawn/SIR/SIRSerializer.h"
+#include "dawn-c/util/TranslationUnitWrapper.h"
 #include "dawn/Support/STLExtras.h"
 #include "dawn/Support/Unreachable.h"
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <mutex>
 using namespace dawn::util;
 
-static dawn::DawnCompiler::CodeGenKind getCodeGenKind(DawnCodeGenKind codegen) {
-  switch(codegen) {
-  case DC_GTClang:
-    return dawn::DawnCompiler::CG_GTClang;
-  case DC_GTClangNaiveCXX:
-    return dawn::DawnCompiler::CG_GTClangNaiveCXX;
-  case DC_GTClangOptCXX:
-    return dawn::DawnCompiler::CG_GTClangOptCXX;
-  default:
-    dawn_unreachable("invalid CodeGenKind");
-  }
-}
-
-static DawnDiagnosticsKind getDawnDiagnosticsKind(dawn::DiagnosticsKind diag) {
-  switch(diag) {
-  case dawn::DiagnosticsKind::Note:
-    return DD_Note;
-  case dawn::DiagnosticsKind::Warning:
-    return DD_Warning;
-  case dawn::DiagnosticsKind::Error:
-    return DD_Error;
-  default:
-    dawn_unreachable("invalid dawn::DiagnosticsKind");
-  }
-}
-
 static void dawnDefaultDiagnosticsHandler(DawnDiagnosticsKind diag, int line, int column,
                                           const char* filename, const char* msg) {
+  // Don't interleave the diagnostics of concurrent compilations
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+
   std::cerr << filename << ":" << line << ":" << column << ": ";
   switch(diag) {
   case DD_Note:
     std::cerr << "note";
+    break;
   case DD_Warning:
     std::cerr << "warning";
+    break;
   case DD_Error:
     std::cerr << "error";
+    break;
   default:
     dawn_unreachable("invalid DawnDiagnosticsKind");
   }
   std::cerr << ": " << msg << std::endl;
 }
 
-static dawnDiagnosticsHandler_t DiagnosticsHandler = dawnDefaultDiagnosticsHandler;
+static std::atomic<dawnDiagnosticsHandler_t> DiagnosticsHandler(dawnDefaultDiagnosticsHandler);
 
 void dawnReportDiagnostic(DawnDiagnosticsKind diag, int line, int column, const char* filename,
                           const char* msg) {
-  DiagnosticsHandler(diag, line, column, filename, msg);
+  DiagnosticsHandler.load()(diag, line, column, filename, msg);
 }
 
 void dawnInstallDiagnosticsHandler(dawnDiagnosticsHandler_t handler) {
@@ -81,12 +65,7 @@ dawnTranslationUnit_t* dawnCompile(const char* SIR, size_t size, const dawnOptio
                                    DawnCodeGenKind codeGenKind) {
   dawnTranslationUnit_t* translationUnit = nullptr;
 
-  // Deserialize the SIR
   try {
-    std::string sirStr(SIR, size);
-    auto inMemorySIR =
-        dawn::SIRSerializer::deserializeFromString(sirStr, dawn::SIRSerializer::SK_Byte);
-
     // Prepare options
     std::unique_ptr<dawn::Options> compileOptions = dawn::make_unique<dawn::Options>();
     if(options)
@@ -94,22 +73,134 @@ dawnTranslationUnit_t* dawnCompile(const char* SIR, size_t size, const dawnOptio
 
     // Run the compiler
     dawn::DawnCompiler compiler(compileOptions.get());
-    auto TU = compiler.compile(inMemorySIR, getCodeGenKind(codeGenKind));
-
-    // Report diganostics
-    if(compiler.getDiagnostics().hasDiags()) {
-      for(const auto& diag : compiler.getDiagnostics().getQueue())
-        dawnReportDiagnostic(getDawnDiagnosticsKind(diag->getDiagKind()),
-                             diag->getSourceLocation().Line, diag->getSourceLocation().Column,
-                             diag->getFilename().c_str(), diag->getMessage().c_str());
+    std::vector<dawn::DiagnosticsMessage> diagnostics;
+    auto TU = compileSIR(compiler, SIR, size, codeGenKind, diagnostics);
+    reportDiagnostics(diagnostics);
+
+    if(!TU)
+      throw std::runtime_error("compilation failed");
+    translationUnit = allocateTranslationUnit(std::move(TU));
+
+  } catch(std::exception& e) {
+    dawnFatalError(e.what());
+  }
+
+  return translationUnit;
+}
+
+/// @brief Run `compile` and pass its diagnostics to the caller (a thrown exception is turned into
+/// an error)
+template <class CompileFunctionType>
+static dawnTranslationUnit_t* compileWithDiagnostics(CompileFunctionType&& compile,
+                                                     dawnDiagnosticsCallback_t callback,
+                                                     void* userData, dawnDiagnostic_t** diagnostics,
+                                                     int* numDiagnostics) {
+  std::vector<dawn::DiagnosticsMessage> messages;
+  std::unique_ptr<dawn::codegen::TranslationUnit> TU;
+
+  try {
+    TU = compile(messages);
+  } catch(std::exception& e) {
+    messages.emplace_back(dawn::DiagnosticsKind::Error, dawn::SourceLocation(), "", e.what());
+  }
+
+  collectDiagnostics(messages, callback, userData, diagnostics, numDiagnostics);
+  return TU ? allocateTranslationUnit(std::move(TU)) : nullptr;
+}
+
+dawnTranslationUnit_t* dawnCompileWithDiagnostics(const char* SIR, size_t size,
+                                                  const dawnOptions_t* options,
+                                                  DawnCodeGenKind codeGenKind,
+                                                  dawnDiagnosticsCallback_t callback,
+                                                  void* userData, dawnDiagnostic_t** diagnostics,
+                                                  int* numDiagnostics) {
+  return compileWithDiagnostics(
+      [&](std::vector<dawn::DiagnosticsMessage>& messages) {
+        dawn::Options compileOptions;
+        if(options)
+          toConstOptionsWrapper(options)->setDawnOptions(&compileOptions);
+        dawn::DawnCompiler compiler(&compileOptions);
+        return compileSIR(compiler, SIR, size, codeGenKind, messages);
+      },
+      callback, userData, diagnostics, numDiagnostics);
+}
+
+void dawnDiagnosticsDestroy(dawnDiagnostic_t* diagnostics, int numDiagnostics) {
+  if(diagnostics) {
+    for(int i = 0; i < numDiagnostics; ++i) {
+      std::free(diagnostics[i].Filename);
+      std::free(diagnostics[i].Message);
     }
+    std::free(diagnostics);
+  }
+}
+
+dawnCompiler_t* dawnCompilerCreate(const dawnOptions_t* options) {
+  dawn::Options compileOptions;
+  if(options)
+    toConstOptionsWrapper(options)->setDawnOptions(&compileOptions);
+
+  dawnCompiler_t* compiler = allocate<dawnCompiler_t>();
+  compiler->Impl = new CompilerHandle(&compileOptions);
+  compiler->OwnsData = 1;
+  return compiler;
+}
+
+void dawnCompilerDestroy(dawnCompiler_t* compiler) {
+  if(compiler) {
+    CompilerHandle* handle = toCompilerHandle(compiler);
+    if(compiler->OwnsData)
+      delete handle;
+    std::free(compiler);
+  }
+}
+
+dawnTranslationUnit_t* dawnCompilerCompile(dawnCompiler_t* compiler, const char* SIR, size_t size,
+                                           DawnCodeGenKind codeGenKind) {
+  dawnTranslationUnit_t* translationUnit = nullptr;
 
-    if(!TU || compiler.getDiagnostics().hasErrors())
+  try {
+    std::vector<dawn::DiagnosticsMessage> diagnostics;
+    auto TU = toCompilerHandle(compiler)->compile(SIR, size, codeGenKind, diagnostics);
+    reportDiagnostics(diagnostics);
+
+    if(!TU)
       throw std::runtime_error("compilation failed");
+    translationUnit = allocateTranslationUnit(std::move(TU));
+
+  } catch(std::exception& e) {
+    dawnFatalError(e.what());
+  }
+
+  return translationUnit;
+}
+
+dawnTranslationUnit_t* dawnCompilerCompileWithDiagnostics(
+    dawnCompiler_t* compiler, const char* SIR, size_t size, DawnCodeGenKind codeGenKind,
+    dawnDiagnosticsCallback_t callback, void* userData, dawnDiagnostic_t** diagnostics,
+    int* numDiagnostics) {
+  CompilerHandle* handle = toCompilerHandle(compiler);
+  return compileWithDiagnostics(
+      [&](std::vector<dawn::DiagnosticsMessage>& messages) {
+        return handle->compile(SIR, size, codeGenKind, messages);
+      },
+      callback, userData, diagnostics, numDiagnostics);
+}
+
+void dawnCompilerClearCache(dawnCompiler_t* compiler) { toCompilerHandle(compiler)->clearCache(); }
+
+/// @brief Take the result of `future`, report its diagnostics and wrap the translation unit
+static dawnTranslationUnit_t* takeResult(CompileFuture* future) {
+  dawnTranslationUnit_t* translationUnit = nullptr;
+
+  try {
+    std::vector<dawn::DiagnosticsMessage> diagnostics;
+    auto TU = future->get(diagnostics);
+    reportDiagnostics(diagnostics);
 
-    translationUnit = allocate<dawnTranslationUnit_t>();
-    translationUnit->Impl = new dawn::codegen::TranslationUnit(std::move(*TU.get()));
-    translationUnit->OwnsData = 1;
+    if(!TU)
+      throw std::runtime_error("compilation failed");
+    translationUnit = allocateTranslationUnit(std::move(TU));
 
   } catch(std::exception& e) {
     dawnFatalError(e.what());
@@ -117,3 +208,86 @@ dawnTranslationUnit_t* dawnCompile(const char* SIR, size_t size, const dawnOptio
 
   return translationUnit;
 }
+
+int dawnCompileBatch(const char* const* SIRs, const size_t* sizes, int num,
+                     const dawnOptions_t* options, DawnCodeGenKind codeGenKind,
+                     dawnTranslationUnit_t** translationUnits, dawnDiagnostic_t** diagnostics,
+                     int* numDiagnostics) {
+  dawn::Options compileOptions;
+  if(options)
+    toConstOptionsWrapper(options)->setDawnOptions(&compileOptions);
+
+  // The call blocks until all compilations finished, i.e the SIRs and options can be borrowed
+  std::vector<std::unique_ptr<CompileFuture>> futures;
+  for(int i = 0; i < num; ++i)
+    futures.emplace_back(CompileFuture::borrow(SIRs[i], sizes[i], compileOptions, codeGenKind));
+
+  int numFailed = 0;
+  for(int i = 0; i < num; ++i) {
+    std::vector<dawn::DiagnosticsMessage> messages;
+    std::unique_ptr<dawn::codegen::TranslationUnit> TU;
+    try {
+      TU = futures[i]->get(messages);
+    } catch(std::exception& e) {
+      messages.emplace_back(dawn::DiagnosticsKind::Error, dawn::SourceLocation(), "", e.what());
+    }
+
+    if(diagnostics || numDiagnostics)
+      collectDiagnostics(messages, nullptr, nullptr, diagnostics ? &diagnostics[i] : nullptr,
+                         numDiagnostics ? &numDiagnostics[i] : nullptr);
+    else
+      reportDiagnostics(messages);
+
+    translationUnits[i] = TU ? allocateTranslationUnit(std::move(TU)) : nullptr;
+    numFailed += translationUnits[i] == nullptr;
+  }
+  return numFailed;
+}
+
+dawnCompileFuture_t* dawnCompileAsync(const char* SIR, size_t size, const dawnOptions_t* options,
+                                      DawnCodeGenKind codeGenKind, dawnCompileCallback_t callback,
+                                      void* userData) {
+  dawn::Options compileOptions;
+  if(options)
+    toConstOptionsWrapper(options)->setDawnOptions(&compileOptions);
+
+  std::function<void()> onFinished;
+  if(callback)
+    onFinished = [callback, userData]() { callback(userData); };
+
+  dawnCompileFuture_t* future = allocate<dawnCompileFuture_t>();
+  future->Impl = new CompileFuture(SIR, size, compileOptions, codeGenKind, onFinished);
+  future->OwnsData = 1;
+  return future;
+}
+
+int dawnCompileFuturePoll(const dawnCompileFuture_t* future) {
+  return toConstCompileFuture(future)->isDone();
+}
+
+void dawnCompileFutureWait(const dawnCompileFuture_t* future) {
+  toConstCompileFuture(future)->wait();
+}
+
+dawnTranslationUnit_t* dawnCompileFutureGet(dawnCompileFuture_t* future) {
+  return takeResult(toCompileFuture(future));
+}
+
+dawnTranslationUnit_t*
+dawnCompileFutureGetWithDiagnostics(dawnCompileFuture_t* future, dawnDiagnosticsCallback_t callback,
+                                    void* userData, dawnDiagnostic_t** diagnostics,
+                                    int* numDiagnostics) {
+  CompileFuture* handle = toCompileFuture(future);
+  return compileWithDiagnostics(
+      [&](std::vector<dawn::DiagnosticsMessage>& messages) { return handle->get(messages); },
+      callback, userData, diagnostics, numDiagnostics);
+}
+
+void dawnCompileFutureDestroy(dawnCompileFuture_t* future) {
+  if(future) {
+    CompileFuture* handle = toCompileFuture(future);
+    if(future->OwnsData)
+      delete handle;
+    std::free(future);
+  }
+}
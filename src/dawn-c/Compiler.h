@@ -45,7 +45,9 @@ typedef void (*dawnDiagnosticsHandler_t)(DawnDiagnosticsKind diag, int line, int
 /**
  * @brief Install a diagnostics handler
  *
- * By default, the diagnostics will be formatted and printed to `stderr`.
+ * By default, the diagnostics will be formatted and printed to `stderr`. The handler is shared by
+ * all threads, i.e it needs to be thread-safe if compilations are run concurrently. Use the
+ * `...WithDiagnostics` functions to receive the diagnostics of a single compilation.
  *
  * @param handler   New diagnostics handler (or if `NULL` is passed the default handler will be
  *                  restored)
@@ -65,6 +67,186 @@ extern dawnTranslationUnit_t* dawnCompile(const char* SIR, size_t size,
                                           const dawnOptions_t* options,
                                           DawnCodeGenKind codeGenKind);
 
+/**
+ * @brief Per-compilation diagnostics callback
+ *
+ * @param userData    Context passed to the compile function
+ */
+typedef void (*dawnDiagnosticsCallback_t)(DawnDiagnosticsKind diag, int line, int column,
+                                          const char* filename, const char* msg, void* userData);
+
+/**
+ * @brief Run the compiler on the byte-string serialized SIR and hand the diagnostics to the caller
+ *
+ * Same as @ref dawnCompile but neither the installed DiagnosticsHandler nor the FatalErrorHandler
+ * are invoked: all diagnostics (including the reason of a failed compilation, as an error) are
+ * passed to `callback` and/or collected in `diagnostics`. Concurrent calls from several threads
+ * are supported.
+ *
+ * @param SIR             Byte string serialized data of the SIR
+ * @param size            Size of the serialized SIR data
+ * @param options         Options of the compilation (if `NULL` is passed the default options are
+ *                        used)
+ * @param codeGenKind     Code generation backend to use
+ * @param callback        Invoked on the calling thread for each diagnostic (may be `NULL`)
+ * @param userData        Passed to `callback`
+ * @param diagnostics     Receives a newly allocated array of the diagnostics (may be `NULL`), the
+ *                        array needs to be freed via @ref dawnDiagnosticsDestroy
+ * @param numDiagnostics  Receives the size of the `diagnostics` array (may be `NULL`)
+ * @return Translation unit of the generated code or `NULL` on failure
+ */
+extern dawnTranslationUnit_t*
+dawnCompileWithDiagnostics(const char* SIR, size_t size, const dawnOptions_t* options,
+                           DawnCodeGenKind codeGenKind, dawnDiagnosticsCallback_t callback,
+                           void* userData, dawnDiagnostic_t** diagnostics, int* numDiagnostics);
+
+/**
+ * @brief Free an array of diagnostics returned by one of the `...WithDiagnostics` functions
+ */
+extern void dawnDiagnosticsDestroy(dawnDiagnostic_t* diagnostics, int numDiagnostics);
+
+/**
+ * @brief Create a compiler which can be reused for many compilations
+ *
+ * The compiler keeps its options and the generated translation units across compilations:
+ * compiling the same serialized SIR with the same backend again returns a copy of the cached
+ * translation unit (and reports the same diagnostics). The compiler can be shared by several
+ * threads, its compilations are serialized.
+ *
+ * The compiler needs to be destroyed via @ref dawnCompilerDestroy.
+ *
+ * @param options     Options of the compilations (if `NULL` is passed the default options are used)
+ */
+extern dawnCompiler_t* dawnCompilerCreate(const dawnOptions_t* options);
+
+/**
+ * @brief Destroy the compiler and its cache
+ */
+extern void dawnCompilerDestroy(dawnCompiler_t* compiler);
+
+/**
+ * @brief Run `compiler` on the byte-string serialized SIR and return the generated code
+ *
+ * @param compiler    Compiler to use (see @ref dawnCompilerCreate)
+ * @param SIR         Byte string serialized data of the SIR
+ * @param size        Size of the serialized SIR data
+ * @param codeGenKind Code generation backend to use
+ * @return Translation unit of the generated code or `NULL` on failure
+ */
+extern dawnTranslationUnit_t* dawnCompilerCompile(dawnCompiler_t* compiler, const char* SIR,
+                                                  size_t size, DawnCodeGenKind codeGenKind);
+
+/**
+ * @brief Run `compiler` on the byte-string serialized SIR and hand the diagnostics to the caller
+ *
+ * @see dawnCompilerCompile
+ * @see dawnCompileWithDiagnostics
+ */
+extern dawnTranslationUnit_t* dawnCompilerCompileWithDiagnostics(
+    dawnCompiler_t* compiler, const char* SIR, size_t size, DawnCodeGenKind codeGenKind,
+    dawnDiagnosticsCallback_t callback, void* userData, dawnDiagnostic_t** diagnostics,
+    int* numDiagnostics);
+
+/**
+ * @brief Drop the translation units cached by `compiler`
+ */
+extern void dawnCompilerClearCache(dawnCompiler_t* compiler);
+
+/**
+ * @brief Run the compiler on an array of byte-string serialized SIRs
+ *
+ * The SIRs are compiled concurrently on an internal thread pool (one thread per hardware thread).
+ * The SIRs are not copied as the call blocks until all compilations finished. A failed compilation
+ * does not invoke the FatalErrorHandler: its translation unit is `NULL` and the reason of the
+ * failure is passed on as an error diagnostic. The diagnostics of each compilation are returned in
+ * `diagnostics`, if both `diagnostics` and `numDiagnostics` are `NULL` they are reported via the
+ * installed DiagnosticsHandler on the calling thread instead (in the order of the SIRs).
+ *
+ * @param SIRs              Array of `num` byte string serialized SIRs
+ * @param sizes             Sizes of the serialized SIRs
+ * @param num               Number of SIRs
+ * @param options           Options of the compilations (if `NULL` is passed the default options
+ *                          are used)
+ * @param codeGenKind       Code generation backend to use
+ * @param translationUnits  Array of size `num` which receives the translation units of the
+ *                          generated code (`NULL` for the failed compilations)
+ * @param diagnostics       Array of size `num` which receives a newly allocated array of the
+ *                          diagnostics of each compilation (may be `NULL`), the arrays need to be
+ *                          freed via @ref dawnDiagnosticsDestroy
+ * @param numDiagnostics    Array of size `num` which receives the sizes of the `diagnostics`
+ *                          arrays (may be `NULL`)
+ * @return Number of failed compilations
+ */
+extern int dawnCompileBatch(const char* const* SIRs, const size_t* sizes, int num,
+                            const dawnOptions_t* options, DawnCodeGenKind codeGenKind,
+                            dawnTranslationUnit_t** translationUnits,
+                            dawnDiagnostic_t** diagnostics, int* numDiagnostics);
+
+/**
+ * @brief Callback invoked once an asynchronous compilation finished
+ *
+ * The callback runs on a thread of the internal thread pool. It must not start and wait for other
+ * compilations.
+ */
+typedef void (*dawnCompileCallback_t)(void* userData);
+
+/**
+ * @brief Start compiling the byte-string serialized SIR on the internal thread pool
+ *
+ * The SIR and the options are copied, i.e they can be released as soon as the function returns.
+ * The result is retrieved via @ref dawnCompileFutureGet, the future needs to be destroyed via
+ * @ref dawnCompileFutureDestroy.
+ *
+ * @param SIR         Byte string serialized data of the SIR
+ * @param size        Size of the serialized SIR data
+ * @param options     Options of the compilation (if `NULL` is passed the default options are used)
+ * @param codeGenKind Code generation backend to use
+ * @param callback    Invoked with `userData` once the compilation finished (may be `NULL`)
+ * @param userData    Passed to `callback`
+ */
+extern dawnCompileFuture_t* dawnCompileAsync(const char* SIR, size_t size,
+                                             const dawnOptions_t* options,
+                                             DawnCodeGenKind codeGenKind,
+                                             dawnCompileCallback_t callback, void* userData);
+
+/**
+ * @brief Check if the compilation finished, i.e if @ref dawnCompileFutureGet would not block
+ * @return `1` if the compilation finished, `0` otherwise
+ */
+extern int dawnCompileFuturePoll(const dawnCompileFuture_t* future);
+
+/**
+ * @brief Block until the compilation finished
+ */
+extern void dawnCompileFutureWait(const dawnCompileFuture_t* future);
+
+/**
+ * @brief Block until the compilation finished and return the generated code
+ *
+ * The diagnostics of the compilation are reported on the calling thread. The result can only be
+ * retrieved once.
+ *
+ * @return Translation unit of the generated code or `NULL` on failure
+ */
+extern dawnTranslationUnit_t* dawnCompileFutureGet(dawnCompileFuture_t* future);
+
+/**
+ * @brief Block until the compilation finished and hand the generated code and the diagnostics to
+ * the caller
+ *
+ * @see dawnCompileFutureGet
+ * @see dawnCompileWithDiagnostics
+ */
+extern dawnTranslationUnit_t*
+dawnCompileFutureGetWithDiagnostics(dawnCompileFuture_t* future, dawnDiagnosticsCallback_t callback,
+                                    void* userData, dawnDiagnostic_t** diagnostics,
+                                    int* numDiagnostics);
+
+/**
+ * @brief Destroy the future (the result of a running compilation is discarded)
+ */
+extern void dawnCompileFutureDestroy(dawnCompileFuture_t* future);
+
 /** @} */
 
 #ifdef __cplusplus
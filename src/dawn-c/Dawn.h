@@ -26,8 +26,10 @@
  * @ingroup dawn_c
  */
 
-#include "dawn-c/DawnCompiler.h"
+#include "dawn-c/Compiler.h"
 #include "dawn-c/ErrorHandling.h"
 #include "dawn-c/Options.h"
+#include "dawn-c/Service.h"
+#include "dawn-c/TranslationUnit.h"
 
 #endif
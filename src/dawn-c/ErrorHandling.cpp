@@ -13,6 +13,7 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn-c/ErrorHandling.h"
+#include <atomic>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
@@ -26,18 +27,19 @@ static void dawnDefaultFatalErrorHandler(const char* reason) {
   std::exit(1);
 }
 
-static dawnFatalErrorHandler_t FatalErrorHandler = dawnDefaultFatalErrorHandler;
+static std::atomic<dawnFatalErrorHandler_t> FatalErrorHandler(dawnDefaultFatalErrorHandler);
 
 void dawnInstallFatalErrorHandler(dawnFatalErrorHandler_t handler) {
   FatalErrorHandler = handler ? handler : dawnDefaultFatalErrorHandler;
 }
 
 void dawnFatalError(const char* reason) {
-  assert(FatalErrorHandler);
-  (*FatalErrorHandler)(reason);
+  dawnFatalErrorHandler_t handler = FatalErrorHandler.load();
+  assert(handler);
+  (*handler)(reason);
 }
 
-static struct ErrorState {
+static thread_local struct ErrorState {
   bool HasError = false;
   std::string ErrorMsg = "";
 } errorState;
@@ -48,6 +48,8 @@ typedef void (*dawnFatalErrorHandler_t)(const char* reason);
  * translate the errror into an exception. This function allows you to install a callback that will
  * be invoked after a fatal error occurred.
  *
+ * The handler is shared by all threads, it is invoked on the thread which encountered the error.
+ *
  * @param handler   New error handler (or if `NULL` is passed the default handler will be restored)
  */
 extern void dawnInstallFatalErrorHandler(dawnFatalErrorHandler_t handler);
@@ -56,7 +58,8 @@ extern void dawnInstallFatalErrorHandler(dawnFatalErrorHandler_t handler);
  * @brief Store the the current state of the error which can be queried via
  * @ref dawnStateErrorHandlerHasError as well as @ref dawnStateErrorHandlerGetErrorMessage
  *
- * This error handler is **not** thread-safe.
+ * The error state is kept per thread, i.e the error state of a thread only reflects the errors
+ * encountered by that thread.
  */
 extern void dawnStateErrorHandler(const char* reason);
 
@@ -80,7 +83,7 @@ extern int dawnStateErrorHandlerHasError(void);
 extern char* dawnStateErrorHandlerGetErrorMessage(void);
 
 /**
- * @brief Reset the current error state
+ * @brief Reset the current error state (of the calling thread)
  */
 extern void dawnStateErrorHandlerResetState(void);
 
@@ -0,0 +1,495 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn-c/Service.h"
+#include "dawn-c/ErrorHandling.h"
+#include "dawn-c/util/CompilerWrapper.h"
+#include "dawn-c/util/TranslationUnitWrapper.h"
+#include "dawn/Support/NonCopyable.h"
+#include "dawn/Support/STLExtras.h"
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace dawn::util;
+
+namespace {
+
+/// @brief Kinds of messages exchanged between the clients and the service
+///
+/// Each message consists of a `MessageHeader` followed by `Size` bytes of payload. The service
+/// answers each `MK_Compile` and `MK_Shutdown` request with a `MK_Result` message.
+enum MessageKind : std::uint32_t { MK_Compile = 1, MK_Shutdown = 2, MK_Result = 3 };
+
+/// @brief Header of a message (both ends run on the same machine, the native byte order is used)
+struct MessageHeader {
+  std::uint32_t Magic;
+  std::uint32_t Kind;
+  std::uint64_t Size;
+};
+
+const std::uint32_t MessageMagic = 0x4e574144; // "DAWN"
+
+/// @brief Maximum payload size of a message, larger messages are rejected
+const std::uint64_t MaxMessageSize = std::uint64_t(1) << 30;
+
+/// @brief Socket which is closed when going out of scope
+class Socket : dawn::NonCopyable {
+  int fd_;
+
+public:
+  explicit Socket(int fd) : fd_(fd) {}
+  ~Socket() {
+    if(fd_ >= 0)
+      ::close(fd_);
+  }
+
+  int get() const { return fd_; }
+};
+
+std::string getErrorMessage(const std::string& what, const char* socketPath) {
+  return what + " '" + socketPath + "': " + std::strerror(errno);
+}
+
+bool writeAll(int fd, const char* data, std::size_t size) {
+#ifdef MSG_NOSIGNAL
+  const int flags = MSG_NOSIGNAL; // Don't raise SIGPIPE if the peer went away
+#else
+  const int flags = 0;
+#endif
+  while(size > 0) {
+    ssize_t n = ::send(fd, data, size, flags);
+    if(n < 0 && errno == EINTR)
+      continue;
+    if(n <= 0)
+      return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool readAll(int fd, char* data, std::size_t size) {
+  while(size > 0) {
+    ssize_t n = ::recv(fd, data, size, 0);
+    if(n < 0 && errno == EINTR)
+      continue;
+    if(n <= 0)
+      return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool sendMessage(int fd, MessageKind kind, const std::string& payload) {
+  MessageHeader header{MessageMagic, kind, payload.size()};
+  return writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+         writeAll(fd, payload.data(), payload.size());
+}
+
+/// @returns `false` if the connection was closed or the message is malformed (or exceeds
+/// `MaxMessageSize`)
+bool receiveMessage(int fd, MessageKind& kind, std::string& payload) {
+  MessageHeader header;
+  if(!readAll(fd, reinterpret_cast<char*>(&header), sizeof(header)) ||
+     header.Magic != MessageMagic || header.Size > MaxMessageSize)
+    return false;
+  kind = static_cast<MessageKind>(header.Kind);
+  payload.resize(header.Size);
+  return readAll(fd, &payload[0], payload.size());
+}
+
+/// @brief Append integers and length-prefixed strings to a buffer
+class Encoder {
+  std::string& buffer_;
+
+public:
+  Encoder(std::string& buffer) : buffer_(buffer) {}
+
+  void putInt(std::uint64_t value) {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void putString(const std::string& str) {
+    putInt(str.size());
+    buffer_.append(str);
+  }
+};
+
+/// @brief Read the values written by an `Encoder`
+class Decoder {
+  const std::string& buffer_;
+  std::size_t pos_;
+
+public:
+  Decoder(const std::string& buffer) : buffer_(buffer), pos_(0) {}
+
+  std::uint64_t getInt() {
+    std::uint64_t value;
+    std::memcpy(&value, get(sizeof(value)), sizeof(value));
+    return value;
+  }
+
+  std::string getString() {
+    std::size_t size = getInt();
+    return std::string(get(size), size);
+  }
+
+  /// @brief Get the remaining bytes
+  const char* getRest(std::size_t& size) {
+    size = buffer_.size() - pos_;
+    return get(size);
+  }
+
+private:
+  const char* get(std::size_t size) {
+    if(size > buffer_.size() - pos_)
+      throw std::runtime_error("malformed message of the dawn service");
+    const char* data = buffer_.data() + pos_;
+    pos_ += size;
+    return data;
+  }
+};
+
+/// @brief Encode the result of a compilation (`TU` is `NULL` on failure)
+std::string encodeResult(const dawn::codegen::TranslationUnit* TU,
+                         const std::vector<dawn::DiagnosticsMessage>& diagnostics) {
+  std::string payload;
+  Encoder encoder(payload);
+
+  encoder.putInt(TU != nullptr);
+  encoder.putInt(diagnostics.size());
+  for(const auto& diag : diagnostics) {
+    encoder.putInt(static_cast<std::uint64_t>(diag.getDiagKind()));
+    encoder.putInt(static_cast<std::int64_t>(diag.getSourceLocation().Line));
+    encoder.putInt(static_cast<std::int64_t>(diag.getSourceLocation().Column));
+    encoder.putString(diag.getFilename());
+    encoder.putString(diag.getMessage());
+  }
+
+  if(!TU)
+    return payload;
+
+  auto putMap = [&](const std::map<std::string, std::string>& map) {
+    encoder.putInt(map.size());
+    for(const auto& keyValuePair : map) {
+      encoder.putString(keyValuePair.first);
+      encoder.putString(keyValuePair.second);
+    }
+  };
+
+  encoder.putString(TU->getFilename());
+  encoder.putInt(TU->getPPDefines().size());
+  for(const auto& ppDefine : TU->getPPDefines())
+    encoder.putString(ppDefine);
+  encoder.putString(TU->getGlobals());
+  putMap(TU->getStencils());
+  putMap(TU->getFiles());
+  return payload;
+}
+
+/// @brief Decode the result of a compilation
+///
+/// @returns the translation unit or `NULL` if the compilation failed
+std::unique_ptr<dawn::codegen::TranslationUnit>
+decodeResult(const std::string& payload, std::vector<dawn::DiagnosticsMessage>& diagnostics) {
+  Decoder decoder(payload);
+
+  bool success = decoder.getInt();
+  for(std::uint64_t i = 0, size = decoder.getInt(); i < size; ++i) {
+    auto kind = static_cast<dawn::DiagnosticsKind>(decoder.getInt());
+    int line = static_cast<std::int64_t>(decoder.getInt());
+    int column = static_cast<std::int64_t>(decoder.getInt());
+    std::string filename = decoder.getString();
+    diagnostics.emplace_back(kind, dawn::SourceLocation(line, column), filename,
+                             decoder.getString());
+  }
+
+  if(!success)
+    return nullptr;
+
+  auto getMap = [&]() {
+    std::map<std::string, std::string> map;
+    for(std::uint64_t i = 0, size = decoder.getInt(); i < size; ++i) {
+      std::string key = decoder.getString();
+      map.emplace(std::move(key), decoder.getString());
+    }
+    return map;
+  };
+
+  std::string filename = decoder.getString();
+  std::vector<std::string> ppDefines;
+  for(std::uint64_t i = 0, size = decoder.getInt(); i < size; ++i)
+    ppDefines.push_back(decoder.getString());
+  std::string globals = decoder.getString();
+  std::map<std::string, std::string> stencils = getMap();
+
+  auto TU = dawn::make_unique<dawn::codegen::TranslationUnit>(
+      filename, std::move(ppDefines), std::move(stencils), std::move(globals));
+  TU->setFiles(getMap());
+  return TU;
+}
+
+/// @brief Compile the request `payload` (backend followed by the serialized SIR) with `handle`
+std::string compileRequest(CompilerHandle* handle, const std::string& payload) {
+  std::vector<dawn::DiagnosticsMessage> diagnostics;
+  std::unique_ptr<dawn::codegen::TranslationUnit> TU;
+  try {
+    Decoder decoder(payload);
+    std::uint64_t codeGenKind = decoder.getInt();
+    if(codeGenKind != DC_GTClang && codeGenKind != DC_GTClangNaiveCXX)
+      throw std::runtime_error("unsupported code generation backend");
+
+    std::size_t size;
+    const char* SIR = decoder.getRest(size);
+    TU = handle->compile(SIR, size, static_cast<DawnCodeGenKind>(codeGenKind), diagnostics);
+  } catch(std::exception& e) {
+    diagnostics.emplace_back(dawn::DiagnosticsKind::Error, dawn::SourceLocation(), "", e.what());
+  }
+  return encodeResult(TU.get(), diagnostics);
+}
+
+bool makeAddress(const char* socketPath, sockaddr_un& address) {
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if(std::strlen(socketPath) >= sizeof(address.sun_path))
+    return false;
+  std::strcpy(address.sun_path, socketPath);
+  return true;
+}
+
+/// @brief Send the request `payload` to the service listening on `socketPath` and return the
+/// payload of its response
+///
+/// @throws std::runtime_error    The service could not be reached
+std::string request(const char* socketPath, MessageKind kind, const std::string& payload) {
+  if(payload.size() > MaxMessageSize)
+    throw std::runtime_error("request exceeds the maximum message size of the dawn service");
+
+  sockaddr_un address;
+  if(!makeAddress(socketPath, address))
+    throw std::runtime_error(std::string("socket path '") + socketPath + "' is too long");
+
+  Socket client(::socket(AF_UNIX, SOCK_STREAM, 0));
+  if(client.get() < 0 ||
+     ::connect(client.get(), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    throw std::runtime_error(getErrorMessage("cannot connect to dawn service", socketPath));
+
+  MessageKind responseKind;
+  std::string response;
+  if(!sendMessage(client.get(), kind, payload) ||
+     !receiveMessage(client.get(), responseKind, response) || responseKind != MK_Result)
+    throw std::runtime_error(std::string("lost connection to dawn service '") + socketPath + "'");
+  return response;
+}
+
+/// @brief Check whether a service is listening on the socket at `address`
+bool isSocketInUse(const sockaddr_un& address) {
+  Socket client(::socket(AF_UNIX, SOCK_STREAM, 0));
+  return client.get() >= 0 && ::connect(client.get(), reinterpret_cast<const sockaddr*>(&address),
+                                        sizeof(address)) == 0;
+}
+
+/// @brief Connections of the service which are currently being served
+class ConnectionSet : dawn::NonCopyable {
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::set<int> clients_;
+  bool shutdown_ = false;
+
+public:
+  /// @brief Register the connection `client`
+  ///
+  /// @returns `false` if the service is shutting down
+  bool add(int client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(shutdown_)
+      return false;
+    clients_.insert(client);
+    return true;
+  }
+
+  /// @brief Remove the connection `client` (after it has been served)
+  void remove(int client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    clients_.erase(client);
+    condition_.notify_all();
+  }
+
+  /// @brief Start shutting down, the pending receives of the other connections are interrupted
+  ///
+  /// @returns `false` if the service was already shutting down
+  bool shutdown() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(shutdown_)
+      return false;
+    shutdown_ = true;
+    for(int client : clients_)
+      ::shutdown(client, SHUT_RD);
+    return true;
+  }
+
+  /// @brief Wait until all connections have been served
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() { return clients_.empty(); });
+  }
+};
+
+/// @brief Serve the requests of `client` until it closes the connection, sends an invalid request
+/// or requests the service to shut down
+///
+/// @returns `true` if a shutdown was requested
+bool serveConnection(CompilerHandle* handle, int client) {
+  MessageKind kind;
+  std::string payload;
+  while(receiveMessage(client, kind, payload)) {
+    if(kind == MK_Shutdown) {
+      sendMessage(client, MK_Result, "");
+      return true;
+    }
+    if(kind != MK_Compile || !sendMessage(client, MK_Result, compileRequest(handle, payload)))
+      break;
+  }
+  return false;
+}
+
+/// @brief Serve the requests on the listening socket `server` until a shutdown request arrives
+///
+/// Each connection is served by its own thread, hence idle or slow clients do not hold up the
+/// others. The compilations themselves are serialized by the compiler handle.
+///
+/// @throws std::runtime_error    Accepting connections failed
+void serve(CompilerHandle* handle, int server, const sockaddr_un& address,
+           const char* socketPath) {
+  ConnectionSet connections;
+
+  while(true) {
+    int client = ::accept(server, nullptr, nullptr);
+    if(client < 0) {
+      if(errno == EINTR)
+        continue;
+      std::string message = getErrorMessage("cannot accept connections on", socketPath);
+      connections.shutdown();
+      connections.wait();
+      throw std::runtime_error(message);
+    }
+
+    if(!connections.add(client)) {
+      // The connection which woke us up after a shutdown request
+      ::close(client);
+      break;
+    }
+
+    std::thread([handle, client, &connections, &address]() {
+      if(serveConnection(handle, client) && connections.shutdown())
+        isSocketInUse(address); // Wake up the accepting thread
+
+      // `serve` may return as soon as the last connection is removed
+      connections.remove(client);
+      ::close(client);
+    }).detach();
+  }
+
+  connections.wait();
+}
+
+} // anonymous namespace
+
+int dawnServiceRun(dawnCompiler_t* compiler, const char* socketPath) {
+  CompilerHandle* handle = toCompilerHandle(compiler);
+
+  sockaddr_un address;
+  if(!makeAddress(socketPath, address)) {
+    dawnFatalError((std::string("socket path '") + socketPath + "' is too long").c_str());
+    return 1;
+  }
+
+  // Replace the stale socket of an earlier service, but never one which is still in use
+  struct stat status;
+  if(::lstat(socketPath, &status) == 0 && S_ISSOCK(status.st_mode)) {
+    if(isSocketInUse(address)) {
+      dawnFatalError((std::string("socket '") + socketPath + "' is in use").c_str());
+      return 1;
+    }
+    ::unlink(socketPath);
+  }
+
+  Socket server(::socket(AF_UNIX, SOCK_STREAM, 0));
+  if(server.get() < 0 ||
+     ::bind(server.get(), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    dawnFatalError(getErrorMessage("cannot bind to", socketPath).c_str());
+    return 1;
+  }
+
+  int ret = 0;
+  try {
+    if(::listen(server.get(), SOMAXCONN) != 0)
+      throw std::runtime_error(getErrorMessage("cannot listen on", socketPath));
+    serve(handle, server.get(), address, socketPath);
+  } catch(std::exception& e) {
+    dawnFatalError(e.what());
+    ret = 1;
+  }
+
+  ::unlink(socketPath);
+  return ret;
+}
+
+dawnTranslationUnit_t* dawnServiceCompile(const char* socketPath, const char* SIR, size_t size,
+                                          DawnCodeGenKind codeGenKind) {
+  dawnTranslationUnit_t* translationUnit = nullptr;
+
+  try {
+    std::string payload;
+    Encoder(payload).putInt(codeGenKind);
+    payload.append(SIR, size);
+
+    std::vector<dawn::DiagnosticsMessage> diagnostics;
+    auto TU = decodeResult(request(socketPath, MK_Compile, payload), diagnostics);
+    reportDiagnostics(diagnostics);
+
+    if(!TU)
+      throw std::runtime_error("compilation failed");
+    translationUnit = allocateTranslationUnit(std::move(TU));
+
+  } catch(std::exception& e) {
+    dawnFatalError(e.what());
+  }
+
+  return translationUnit;
+}
+
+int dawnServiceShutdown(const char* socketPath) {
+  try {
+    request(socketPath, MK_Shutdown, "");
+  } catch(std::exception& e) {
+    dawnFatalError(e.what());
+    return 1;
+  }
+  return 0;
+}
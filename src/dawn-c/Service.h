@@ -0,0 +1,76 @@
+/*===----------------------------------------------------------------------------------*- C -*-===*\
+ *                          _
+ *                         | |
+ *                       __| | __ ___      ___ ___
+ *                      / _` |/ _` \ \ /\ / / '_  |
+ *                     | (_| | (_| |\ V  V /| | | |
+ *                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+ *
+ *
+ *  This file is distributed under the MIT License (MIT).
+ *  See LICENSE.txt for details.
+ *
+\*===------------------------------------------------------------------------------------------===*/
+
+#ifndef DAWN_C_SERVICE_H
+#define DAWN_C_SERVICE_H
+
+#include "dawn-c/Types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @ingroup dawn_c
+ * @{
+ */
+
+/**
+ * @brief Serve compile requests on the Unix domain socket `socketPath`
+ *
+ * All requests are compiled with `compiler` (see @ref dawnCompilerCreate), i.e many front-end
+ * processes can share one warm compiler and its cache. Each connection is served by its own
+ * thread, i.e an idle client does not hold up the others (the compilations themselves are
+ * serialized). Connections sending oversized (more than 1 GiB) or malformed messages are closed.
+ * A stale socket left at `socketPath` by an earlier service is replaced, the socket is removed
+ * again when the service shuts down.
+ *
+ * This function blocks until a shutdown request is received (see @ref dawnServiceShutdown).
+ *
+ * @param compiler    Compiler used for all requests
+ * @param socketPath  Path of the socket
+ * @return 0 after a shutdown request, 1 if the socket could not be set up (e.g because another
+ *         service is listening on `socketPath`) or serving the requests failed (after calling
+ *         `dawnFatalError`)
+ */
+extern int dawnServiceRun(dawnCompiler_t* compiler, const char* socketPath);
+
+/**
+ * @brief Compile the byte-string serialized SIR with the service listening on `socketPath`
+ *
+ * The diagnostics of the compilation are reported via @ref dawnReportDiagnostic.
+ *
+ * @param socketPath  Path of the socket of the service (see @ref dawnServiceRun)
+ * @param SIR         Byte string serialized data of the SIR
+ * @param size        Size of the serialized SIR data
+ * @param codeGenKind Code generation backend to use
+ * @return Translation unit of the generated code or `NULL` on failure
+ */
+extern dawnTranslationUnit_t* dawnServiceCompile(const char* socketPath, const char* SIR,
+                                                 size_t size, DawnCodeGenKind codeGenKind);
+
+/**
+ * @brief Request the service listening on `socketPath` to shut down
+ *
+ * @return 0 on success, 1 if the service could not be reached (after calling `dawnFatalError`)
+ */
+extern int dawnServiceShutdown(const char* socketPath);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
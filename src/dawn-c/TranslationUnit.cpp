@@ -51,3 +51,104 @@ char* dawnTranslationUnitGetGlobals(const dawnTranslationUnit_t* translationUnit
   const dawn::codegen::TranslationUnit* TU = toConstTranslationUnit(translationUnit);
   return allocateAndCopyString(TU->getGlobals());
 }
+
+void dawnTranslationUnitGetFilenames(const dawnTranslationUnit_t* translationUnit,
+                                     char*** filenames, int* size) {
+  const dawn::codegen::TranslationUnit* TU = toConstTranslationUnit(translationUnit);
+  const auto& files = TU->getFiles();
+
+  char** filenameArray = allocate<char*>(files.size());
+  int i = 0;
+  for(const auto& filenameCodePair : files)
+    filenameArray[i++] = allocateAndCopyString(filenameCodePair.first);
+
+  *size = files.size();
+  *filenames = filenameArray;
+}
+
+char* dawnTranslationUnitGetFile(const dawnTranslationUnit_t* translationUnit,
+                                 const char* filename) {
+  const dawn::codegen::TranslationUnit* TU = toConstTranslationUnit(translationUnit);
+  auto it = TU->getFiles().find(filename);
+  return it == TU->getFiles().end() ? nullptr : allocateAndCopyString(it->second);
+}
+
+/// @brief Set the view `data`/`size` of `str`
+static void setView(const std::string& str, const char** data, std::size_t* size) {
+  if(data)
+    *data = str.c_str();
+  if(size)
+    *size = str.size();
+}
+
+/// @brief Set the view of the entry `name` of `map` (or an empty view if there is no such entry)
+static int setMapView(const std::map<std::string, std::string>& map, const char* name,
+                      const char** data, std::size_t* size) {
+  auto it = map.find(name);
+  if(it == map.end()) {
+    if(data)
+      *data = nullptr;
+    if(size)
+      *size = 0;
+    return 0;
+  }
+  setView(it->second, data, size);
+  return 1;
+}
+
+int dawnTranslationUnitViewStencil(const dawnTranslationUnit_t* translationUnit,
+                                   const char* name, const char** code, size_t* size) {
+  return setMapView(toConstTranslationUnit(translationUnit)->getStencils(), name, code, size);
+}
+
+void dawnTranslationUnitViewGlobals(const dawnTranslationUnit_t* translationUnit,
+                                    const char** code, size_t* size) {
+  setView(toConstTranslationUnit(translationUnit)->getGlobals(), code, size);
+}
+
+int dawnTranslationUnitGetNumPPDefines(const dawnTranslationUnit_t* translationUnit) {
+  return toConstTranslationUnit(translationUnit)->getPPDefines().size();
+}
+
+void dawnTranslationUnitViewPPDefine(const dawnTranslationUnit_t* translationUnit, int index,
+                                     const char** define, size_t* size) {
+  const auto& ppDefines = toConstTranslationUnit(translationUnit)->getPPDefines();
+  if(index < 0 || index >= static_cast<int>(ppDefines.size()))
+    dawnFatalError("preprocessor define index out of bounds");
+  setView(ppDefines[index], define, size);
+}
+
+int dawnTranslationUnitViewFile(const dawnTranslationUnit_t* translationUnit,
+                                const char* filename, const char** content, size_t* size) {
+  return setMapView(toConstTranslationUnit(translationUnit)->getFiles(), filename, content, size);
+}
+
+dawnStencilIterator_t*
+dawnTranslationUnitGetStencilIterator(const dawnTranslationUnit_t* translationUnit) {
+  const auto& stencils = toConstTranslationUnit(translationUnit)->getStencils();
+
+  dawnStencilIterator_t* iterator = allocate<dawnStencilIterator_t>();
+  iterator->Impl = new StencilIterator{stencils.begin(), stencils.end()};
+  iterator->OwnsData = 1;
+  return iterator;
+}
+
+int dawnStencilIteratorNext(dawnStencilIterator_t* iterator, const char** name, size_t* nameSize,
+                            const char** code, size_t* codeSize) {
+  StencilIterator* it = toStencilIterator(iterator);
+  if(it->Current == it->End)
+    return 0;
+  setView(it->Current->first, name, nameSize);
+  setView(it->Current->second, code, codeSize);
+  ++it->Current;
+  return 1;
+}
+
+void dawnStencilIteratorDestroy(dawnStencilIterator_t* iterator) {
+  if(iterator) {
+    StencilIterator* it = toStencilIterator(iterator);
+    if(iterator->OwnsData)
+      delete it;
+    std::free(iterator);
+  }
+}
@@ -60,6 +60,119 @@ extern char* dawnTranslationUnitGetStencil(const dawnTranslationUnit_t* translat
  */
 extern char* dawnTranslationUnitGetGlobals(const dawnTranslationUnit_t* translationUnit);
 
+/**
+ * @brief Get the generated file `filename` of the split output mode (`-split-tu`)
+ *
+ * @param[in]   translationUnit   Translation unit to use
+ * @param[out]  filenames         Array of '\0' terminated strings of length `size` which contains
+ *                                the names of the generated files (shared header, one header and
+ *                                source file per stencil and a CMake fragment)
+ * @param[out]  size              Size of array `filenames` (0 if the translation unit was not
+ *                                split)
+ */
+extern void dawnTranslationUnitGetFilenames(const dawnTranslationUnit_t* translationUnit,
+                                            char*** filenames, int* size);
+
+/**
+ * @brief Get the content of the generated file `filename` of the split output mode
+ *
+ * @param[in]   translationUnit   Translation unit to use
+ * @param[in]   filename          Name of the file (see @ref dawnTranslationUnitGetFilenames)
+ * @returns newly allocated '\0' terminated string of the content of file `filename` (returns
+ *          `NULL` if file `filename` was not found)
+ */
+extern char* dawnTranslationUnitGetFile(const dawnTranslationUnit_t* translationUnit,
+                                        const char* filename);
+
+/**
+ * @name Borrowing accessors
+ *
+ * The following functions return views into the translation unit instead of copies: the returned
+ * pointers are valid as long as the translation unit is alive and must not be freed. The views are
+ * '\0' terminated, their size excludes the terminator.
+ * @{
+ */
+
+/**
+ * @brief Get a view of the generated code of the stencil `name`
+ *
+ * @param[in]   translationUnit   Translation unit to use
+ * @param[in]   name              Name of the stencil
+ * @param[out]  code              Generated code of the stencil (`NULL` if it was not found)
+ * @param[out]  size              Size of `code` in bytes
+ * @returns 1 if stencil `name` was found, 0 otherwise
+ */
+extern int dawnTranslationUnitViewStencil(const dawnTranslationUnit_t* translationUnit,
+                                          const char* name, const char** code, size_t* size);
+
+/**
+ * @brief Get a view of the generated code for the global variables
+ *
+ * @param[in]   translationUnit   Translation unit to use
+ * @param[out]  code              Generated code of the globals
+ * @param[out]  size              Size of `code` in bytes
+ */
+extern void dawnTranslationUnitViewGlobals(const dawnTranslationUnit_t* translationUnit,
+                                           const char** code, size_t* size);
+
+/**
+ * @brief Get the number of preprocessor defines
+ */
+extern int dawnTranslationUnitGetNumPPDefines(const dawnTranslationUnit_t* translationUnit);
+
+/**
+ * @brief Get a view of the preprocessor define at position `index`
+ *
+ * @param[in]   translationUnit   Translation unit to use
+ * @param[in]   index             Position of the define in [0, @ref
+ *                                dawnTranslationUnitGetNumPPDefines)
+ * @param[out]  define            Preprocessor define
+ * @param[out]  size              Size of `define` in bytes
+ */
+extern void dawnTranslationUnitViewPPDefine(const dawnTranslationUnit_t* translationUnit,
+                                            int index, const char** define, size_t* size);
+
+/**
+ * @brief Get a view of the content of the generated file `filename` of the split output mode
+ *
+ * @param[in]   translationUnit   Translation unit to use
+ * @param[in]   filename          Name of the file (see @ref dawnTranslationUnitGetFilenames)
+ * @param[out]  content           Content of the file (`NULL` if it was not found)
+ * @param[out]  size              Size of `content` in bytes
+ * @returns 1 if file `filename` was found, 0 otherwise
+ */
+extern int dawnTranslationUnitViewFile(const dawnTranslationUnit_t* translationUnit,
+                                       const char* filename, const char** content, size_t* size);
+
+/**
+ * @brief Create an iterator over the stencils of the translation unit (ordered by name)
+ *
+ * The iterator needs to be destroyed via @ref dawnStencilIteratorDestroy and must not outlive the
+ * translation unit.
+ */
+extern dawnStencilIterator_t*
+dawnTranslationUnitGetStencilIterator(const dawnTranslationUnit_t* translationUnit);
+
+/**
+ * @brief Get views of the name and the generated code of the next stencil and advance `iterator`
+ *
+ * @param[in]   iterator          Iterator to advance
+ * @param[out]  name              Name of the stencil (may be `NULL`)
+ * @param[out]  nameSize          Size of `name` in bytes (may be `NULL`)
+ * @param[out]  code              Generated code of the stencil (may be `NULL`)
+ * @param[out]  codeSize          Size of `code` in bytes (may be `NULL`)
+ * @returns 1 if there was a next stencil, 0 if the iterator reached the end
+ */
+extern int dawnStencilIteratorNext(dawnStencilIterator_t* iterator, const char** name,
+                                   size_t* nameSize, const char** code, size_t* codeSize);
+
+/**
+ * @brief Destroy the iterator
+ */
+extern void dawnStencilIteratorDestroy(dawnStencilIterator_t* iterator);
+
+/** @} */
+
 /** @} */
 
 #ifdef __cplusplus
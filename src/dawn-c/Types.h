@@ -47,6 +47,17 @@ enum DawnCodeGenKind { DC_GTClang, DC_GTClangNaiveCXX, DC_GTClangOptCXX };
  */
 enum DawnDiagnosticsKind { DD_Note, DD_Warning, DD_Error };
 
+/**
+ * @brief Diagnostic emitted during compilation
+ */
+typedef struct {
+  DawnDiagnosticsKind Kind; /**< Kind of the diagnostic */
+  int Line;                 /**< Line in the source (or -1 if unknown) */
+  int Column;               /**< Column in the source (or -1 if unknown) */
+  char* Filename;           /**< File where the diagnostic occurred */
+  char* Message;            /**< Message of the diagnostic */
+} dawnDiagnostic_t;
+
 /**
  * @brief Refrence to the Options
  */
@@ -68,10 +79,18 @@ typedef struct {
  * @brief Refrence to the Compiler
  */
 typedef struct {
-  void* Impl;   /**< Pointer to the allocated dawn::DawnCompiler */
+  void* Impl;   /**< Pointer to the allocated dawn::util::CompilerHandle */
   int OwnsData; /**< Ownership flag */
 } dawnCompiler_t;
 
+/**
+ * @brief Refrence to an asynchronous compilation
+ */
+typedef struct {
+  void* Impl;   /**< Pointer to the allocated dawn::util::CompileFuture */
+  int OwnsData; /**< Ownership flag */
+} dawnCompileFuture_t;
+
 /**
  * @brief Refrence to a TranslationUnit
  */
@@ -80,6 +99,14 @@ typedef struct {
   int OwnsData; /**< Ownership flag */
 } dawnTranslationUnit_t;
 
+/**
+ * @brief Refrence to an iterator over the stencils of a TranslationUnit
+ */
+typedef struct {
+  void* Impl;   /**< Pointer to the allocated dawn::util::StencilIterator */
+  int OwnsData; /**< Ownership flag */
+} dawnStencilIterator_t;
+
 /** @} */
 
 #ifdef __cplusplus
@@ -0,0 +1,108 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn-c/util/CompileFutureWrapper.h"
+#include "dawn-c/util/CompilerWrapper.h"
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Support/ThreadPool.h"
+#include <stdexcept>
+
+namespace dawn {
+
+namespace util {
+
+CompileFuture::CompileFuture(CompileFunction compile, std::function<void()> onFinished)
+    : state_(std::make_shared<State>()) {
+  auto state = state_;
+
+  ThreadPool::getGlobal().enqueue([=]() {
+    std::unique_ptr<codegen::TranslationUnit> TU;
+    std::vector<DiagnosticsMessage> diagnostics;
+    std::exception_ptr exception;
+    try {
+      TU = compile(diagnostics);
+    } catch(...) {
+      exception = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(state->Mutex);
+      state->TranslationUnit = std::move(TU);
+      state->Diagnostics = std::move(diagnostics);
+      state->Exception = exception;
+      state->Done = true;
+    }
+    state->Finished.notify_all();
+
+    if(onFinished)
+      onFinished();
+  });
+}
+
+/// @brief Compile function owning copies of `SIR` and `options`
+static std::function<std::unique_ptr<codegen::TranslationUnit>(std::vector<DiagnosticsMessage>&)>
+makeOwningCompile(const char* SIR, std::size_t size, const Options& options,
+                  DawnCodeGenKind codeGenKind) {
+  auto buffer = std::make_shared<std::string>(SIR, size);
+  auto compileOptions = std::make_shared<Options>(options);
+  return [=](std::vector<DiagnosticsMessage>& diagnostics) {
+    DawnCompiler compiler(compileOptions.get());
+    return compileSIR(compiler, buffer->data(), buffer->size(), codeGenKind, diagnostics);
+  };
+}
+
+CompileFuture::CompileFuture(const char* SIR, std::size_t size, const Options& options,
+                             DawnCodeGenKind codeGenKind, std::function<void()> onFinished)
+    : CompileFuture(makeOwningCompile(SIR, size, options, codeGenKind), std::move(onFinished)) {}
+
+std::unique_ptr<CompileFuture> CompileFuture::borrow(const char* SIR, std::size_t size,
+                                                     Options& options,
+                                                     DawnCodeGenKind codeGenKind) {
+  Options* compileOptions = &options;
+  return std::unique_ptr<CompileFuture>(new CompileFuture(
+      [=](std::vector<DiagnosticsMessage>& diagnostics) {
+        DawnCompiler compiler(compileOptions);
+        return compileSIR(compiler, SIR, size, codeGenKind, diagnostics);
+      },
+      nullptr));
+}
+
+bool CompileFuture::isDone() const {
+  std::lock_guard<std::mutex> lock(state_->Mutex);
+  return state_->Done;
+}
+
+void CompileFuture::wait() const {
+  std::unique_lock<std::mutex> lock(state_->Mutex);
+  state_->Finished.wait(lock, [this]() { return state_->Done; });
+}
+
+std::unique_ptr<codegen::TranslationUnit>
+CompileFuture::get(std::vector<DiagnosticsMessage>& diagnostics) {
+  std::unique_lock<std::mutex> lock(state_->Mutex);
+  state_->Finished.wait(lock, [this]() { return state_->Done; });
+
+  if(state_->Retrieved)
+    throw std::runtime_error("result of the compilation was already retrieved");
+  state_->Retrieved = true;
+
+  if(state_->Exception)
+    std::rethrow_exception(state_->Exception);
+  diagnostics.insert(diagnostics.end(), state_->Diagnostics.begin(), state_->Diagnostics.end());
+  return std::move(state_->TranslationUnit);
+}
+
+} // namespace util
+
+} // namespace dawn
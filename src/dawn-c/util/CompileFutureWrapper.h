@@ -0,0 +1,113 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_C_UTIL_COMPILEFUTUREWRAPPER_H
+#define DAWN_C_UTIL_COMPILEFUTUREWRAPPER_H
+
+#include "dawn-c/Compiler.h"
+#include "dawn-c/ErrorHandling.h"
+#include "dawn/CodeGen/TranslationUnit.h"
+#include "dawn/Compiler/DiagnosticsMessage.h"
+#include "dawn/Compiler/Options.h"
+#include "dawn/Support/NonCopyable.h"
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dawn {
+
+namespace util {
+
+/// @brief Compilation running on the global ThreadPool, referenced by a `dawnCompileFuture_t`
+///
+/// The compilation owns copies of the serialized SIR and of the options, i.e the buffers of the
+/// caller can be released right after the compilation was started (unless it was started via
+/// `borrow`). Destroying the future before the compilation finished discards the result.
+///
+/// @ingroup dawn_c_util
+class CompileFuture : NonCopyable {
+  using CompileFunction =
+      std::function<std::unique_ptr<codegen::TranslationUnit>(std::vector<DiagnosticsMessage>&)>;
+
+  /// @brief State shared with the task of the thread pool
+  struct State {
+    std::mutex Mutex;
+    std::condition_variable Finished;
+    bool Done = false;
+    bool Retrieved = false;
+
+    std::unique_ptr<codegen::TranslationUnit> TranslationUnit; ///< `nullptr` on failure
+    std::vector<DiagnosticsMessage> Diagnostics;
+    std::exception_ptr Exception; ///< Exception thrown by the compilation (if any)
+  };
+
+  std::shared_ptr<State> state_;
+
+  /// @brief Run `compile` on the global ThreadPool
+  CompileFuture(CompileFunction compile, std::function<void()> onFinished);
+
+public:
+  /// @brief Start the compilation of the byte-string serialized `SIR`
+  ///
+  /// @param onFinished   Invoked by the worker thread once the result is available (may be empty)
+  CompileFuture(const char* SIR, std::size_t size, const Options& options,
+                DawnCodeGenKind codeGenKind, std::function<void()> onFinished = nullptr);
+
+  /// @brief Start the compilation of the byte-string serialized `SIR` without copying it
+  ///
+  /// `SIR` and `options` are referenced by the compilation, they need to stay alive until `wait` or
+  /// `get` returned.
+  static std::unique_ptr<CompileFuture> borrow(const char* SIR, std::size_t size, Options& options,
+                                               DawnCodeGenKind codeGenKind);
+
+  /// @brief Check if the compilation finished (never blocks)
+  bool isDone() const;
+
+  /// @brief Block until the compilation finished
+  void wait() const;
+
+  /// @brief Block until the compilation finished and take its result
+  ///
+  /// The result can only be taken once.
+  /// @param diagnostics  Diagnostics of the compilation are appended to this vector
+  /// @throws std::exception    Compilation threw or the result was already taken
+  /// @returns compiled TranslationUnit on success, `nullptr` otherwise
+  std::unique_ptr<codegen::TranslationUnit> get(std::vector<DiagnosticsMessage>& diagnostics);
+};
+
+/// @brief Convert `dawnCompileFuture_t` to `CompileFuture`
+/// @ingroup dawn_c_util
+/// @{
+inline const CompileFuture* toConstCompileFuture(const dawnCompileFuture_t* future) {
+  if(!future->Impl)
+    dawnFatalError("uninitialized CompileFuture");
+  return reinterpret_cast<const CompileFuture*>(future->Impl);
+}
+
+inline CompileFuture* toCompileFuture(dawnCompileFuture_t* future) {
+  if(!future->Impl)
+    dawnFatalError("uninitialized CompileFuture");
+  return reinterpret_cast<CompileFuture*>(future->Impl);
+}
+/// @}
+
+} // namespace util
+
+} // namespace dawn
+
+#endif
@@ -0,0 +1,180 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn-c/util/CompilerWrapper.h"
+#include "dawn-c/util/Allocate.h"
+#include "dawn/SIR/SIRSerializer.h"
+#include "dawn/Support/Assert.h"
+#include "dawn/Support/HashCombine.h"
+#include "dawn/Support/STLExtras.h"
+#include "dawn/Support/Unreachable.h"
+#include <cstring>
+#include <iterator>
+
+namespace dawn {
+
+namespace util {
+
+static DawnCompiler::CodeGenKind getCodeGenKind(DawnCodeGenKind codegen) {
+  switch(codegen) {
+  case DC_GTClang:
+    return DawnCompiler::CG_GTClang;
+  case DC_GTClangNaiveCXX:
+    return DawnCompiler::CG_GTClangNaiveCXX;
+  case DC_GTClangOptCXX:
+    return DawnCompiler::CG_GTClangOptCXX;
+  default:
+    dawn_unreachable("invalid CodeGenKind");
+  }
+}
+
+static DawnDiagnosticsKind getDawnDiagnosticsKind(DiagnosticsKind diag) {
+  switch(diag) {
+  case DiagnosticsKind::Note:
+    return DD_Note;
+  case DiagnosticsKind::Warning:
+    return DD_Warning;
+  case DiagnosticsKind::Error:
+    return DD_Error;
+  default:
+    dawn_unreachable("invalid dawn::DiagnosticsKind");
+  }
+}
+
+/// @brief 64-bit FNV-1a hash of `size` bytes at `data`
+static std::uint64_t hashBytes(const char* data, std::size_t size) {
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for(std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::unique_ptr<codegen::TranslationUnit>
+compileSIR(DawnCompiler& compiler, const char* SIR, std::size_t size, DawnCodeGenKind codeGenKind,
+           std::vector<DiagnosticsMessage>& diagnostics) {
+  // Deserialize the SIR (lazily, only the stencils which are compiled are decoded). The SIR
+  // borrows the buffer of the caller, it must not outlive this call.
+  auto inMemorySIR = SIRSerializer::deserializeLazyFromBuffer(SIR, size, SIRSerializer::SK_Byte);
+
+  // Run the compiler
+  auto TU = compiler.compile(inMemorySIR, getCodeGenKind(codeGenKind));
+  DAWN_ASSERT_MSG(inMemorySIR.unique(), "lazily deserialized SIR outlives its buffer");
+  for(const auto& diag : compiler.getDiagnostics().getQueue())
+    diagnostics.push_back(*diag);
+
+  if(compiler.getDiagnostics().hasErrors())
+    return nullptr;
+  return TU;
+}
+
+void reportDiagnostics(const std::vector<DiagnosticsMessage>& diagnostics) {
+  for(const auto& diag : diagnostics)
+    dawnReportDiagnostic(getDawnDiagnosticsKind(diag.getDiagKind()), diag.getSourceLocation().Line,
+                         diag.getSourceLocation().Column, diag.getFilename().c_str(),
+                         diag.getMessage().c_str());
+}
+
+void collectDiagnostics(const std::vector<DiagnosticsMessage>& diagnostics,
+                        dawnDiagnosticsCallback_t callback, void* userData,
+                        dawnDiagnostic_t** diagnosticsArray, int* numDiagnostics) {
+  if(callback)
+    for(const auto& diag : diagnostics)
+      callback(getDawnDiagnosticsKind(diag.getDiagKind()), diag.getSourceLocation().Line,
+               diag.getSourceLocation().Column, diag.getFilename().c_str(),
+               diag.getMessage().c_str(), userData);
+
+  if(numDiagnostics)
+    *numDiagnostics = diagnostics.size();
+
+  if(diagnosticsArray) {
+    *diagnosticsArray = nullptr;
+    if(diagnostics.empty())
+      return;
+
+    dawnDiagnostic_t* array = allocate<dawnDiagnostic_t>(diagnostics.size());
+    for(std::size_t i = 0; i < diagnostics.size(); ++i) {
+      array[i].Kind = getDawnDiagnosticsKind(diagnostics[i].getDiagKind());
+      array[i].Line = diagnostics[i].getSourceLocation().Line;
+      array[i].Column = diagnostics[i].getSourceLocation().Column;
+      array[i].Filename = allocateAndCopyString(diagnostics[i].getFilename());
+      array[i].Message = allocateAndCopyString(diagnostics[i].getMessage());
+    }
+    *diagnosticsArray = array;
+  }
+}
+
+std::unique_ptr<codegen::TranslationUnit>
+CompilerHandle::compile(const char* SIR, std::size_t size, DawnCodeGenKind codeGenKind,
+                        std::vector<DiagnosticsMessage>& diagnostics) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Compilations which write the IIR to disk are not cached as they have side effects
+  if(!compiler_.getOptions().SerializeIIR.empty())
+    return compileSIR(compiler_, SIR, size, codeGenKind, diagnostics);
+
+  CacheKey key{codeGenKind, size, hashBytes(SIR, size)};
+
+  // Entries with the same key are only reused if the SIR is identical (the hash may collide)
+  auto range = cacheIndex_.equal_range(key);
+  auto it = range.first;
+  while(it != range.second && std::memcmp(it->second->SIR.data(), SIR, size) != 0)
+    ++it;
+
+  if(it != range.second) {
+    // Move the entry to the front of the LRU list
+    cache_.splice(cache_.begin(), cache_, it->second);
+  } else {
+    CacheEntry entry;
+    entry.Key = key;
+    entry.SIR.assign(SIR, size);
+    entry.TranslationUnit = compileSIR(compiler_, SIR, size, codeGenKind, entry.Diagnostics);
+    cache_.push_front(std::move(entry));
+    it = cacheIndex_.emplace(key, cache_.begin());
+
+    if(cache_.size() > MaxCacheEntries) {
+      auto lastEntry = std::prev(cache_.end());
+      auto lastRange = cacheIndex_.equal_range(lastEntry->Key);
+      for(auto indexIt = lastRange.first; indexIt != lastRange.second; ++indexIt)
+        if(indexIt->second == lastEntry) {
+          cacheIndex_.erase(indexIt);
+          break;
+        }
+      cache_.pop_back();
+    }
+  }
+
+  const CacheEntry& entry = *it->second;
+  diagnostics.insert(diagnostics.end(), entry.Diagnostics.begin(), entry.Diagnostics.end());
+  if(!entry.TranslationUnit)
+    return nullptr;
+  return make_unique<codegen::TranslationUnit>(*entry.TranslationUnit);
+}
+
+void CompilerHandle::clearCache() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cacheIndex_.clear();
+  cache_.clear();
+}
+
+std::size_t CompilerHandle::CacheKeyHash::operator()(const CacheKey& key) const {
+  std::size_t seed = 0;
+  hash_combine(seed, static_cast<int>(key.CodeGenKind), key.Size, key.Hash);
+  return seed;
+}
+
+} // namespace util
+
+} // namespace dawn
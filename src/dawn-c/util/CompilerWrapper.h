@@ -18,24 +18,119 @@
 #include "dawn-c/Compiler.h"
 #include "dawn-c/ErrorHandling.h"
 #include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Compiler/DiagnosticsMessage.h"
+#include "dawn/Support/NonCopyable.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace dawn {
 
 namespace util {
 
-/// @brief Convert `dawnCompiler_t` to `DawnCompiler`
+/// @brief Compile the byte-string serialized `SIR` with `compiler`
+///
+/// @param diagnostics  Diagnostics of the compilation are appended to this vector
+/// @throws std::exception    Failed to deserialize the SIR
+/// @returns compiled TranslationUnit on success, `nullptr` otherwise
+/// @ingroup dawn_c_util
+extern std::unique_ptr<codegen::TranslationUnit>
+compileSIR(DawnCompiler& compiler, const char* SIR, std::size_t size, DawnCodeGenKind codeGenKind,
+           std::vector<DiagnosticsMessage>& diagnostics);
+
+/// @brief Report `diagnostics` via the installed DiagnosticsHandler
+/// @ingroup dawn_c_util
+extern void reportDiagnostics(const std::vector<DiagnosticsMessage>& diagnostics);
+
+/// @brief Pass `diagnostics` to `callback` (if not `nullptr`) and copy them to a newly allocated
+/// array stored in `diagnosticsArray` (if not `nullptr`)
+/// @ingroup dawn_c_util
+extern void collectDiagnostics(const std::vector<DiagnosticsMessage>& diagnostics,
+                               dawnDiagnosticsCallback_t callback, void* userData,
+                               dawnDiagnostic_t** diagnosticsArray, int* numDiagnostics);
+
+/// @brief Compiler referenced by a `dawnCompiler_t`
+///
+/// The compiler keeps its options and the translation units it generated across compilations,
+/// identical requests are answered from the cache. The cache is indexed by a hash of the serialized
+/// SIR (together with its size and the code generation backend); the serialized SIR itself is
+/// stored with each entry and compared on every hit, hence colliding requests are never mixed up.
+/// The cache holds at most `MaxCacheEntries` translation units, the least recently used one is
+/// evicted first.
+/// Compilations of the same compiler are serialized.
+///
+/// @ingroup dawn_c_util
+class CompilerHandle : NonCopyable {
+public:
+  /// @brief Maximum number of cached translation units
+  static const std::size_t MaxCacheEntries = 64;
+
+private:
+  /// @brief Identification of a compilation request
+  struct CacheKey {
+    DawnCodeGenKind CodeGenKind;
+    std::size_t Size;   ///< Size of the serialized SIR
+    std::uint64_t Hash; ///< 64-bit FNV-1a hash of the serialized SIR
+
+    bool operator==(const CacheKey& other) const {
+      return CodeGenKind == other.CodeGenKind && Size == other.Size && Hash == other.Hash;
+    }
+  };
+
+  struct CacheKeyHash {
+    std::size_t operator()(const CacheKey& key) const;
+  };
+
+  /// @brief Result of a compilation
+  struct CacheEntry {
+    CacheKey Key;
+    std::string SIR; ///< Serialized SIR
+    std::unique_ptr<codegen::TranslationUnit> TranslationUnit; ///< `nullptr` on failure
+    std::vector<DiagnosticsMessage> Diagnostics;
+  };
+
+  DawnCompiler compiler_;
+  std::mutex mutex_;
+
+  /// Cached compilations, the most recently used one first
+  std::list<CacheEntry> cache_;
+  std::unordered_multimap<CacheKey, std::list<CacheEntry>::iterator, CacheKeyHash> cacheIndex_;
+
+public:
+  CompilerHandle(Options* options) : compiler_(options) {}
+
+  /// @brief Compile the byte-string serialized `SIR` (or look up the result of an identical
+  /// earlier compilation)
+  ///
+  /// @see compileSIR
+  std::unique_ptr<codegen::TranslationUnit> compile(const char* SIR, std::size_t size,
+                                                    DawnCodeGenKind codeGenKind,
+                                                    std::vector<DiagnosticsMessage>& diagnostics);
+
+  /// @brief Drop all cached translation units
+  void clearCache();
+
+  /// @brief Get the compiler
+  DawnCompiler& getCompiler() { return compiler_; }
+};
+
+/// @brief Convert `dawnCompiler_t` to `CompilerHandle`
 /// @ingroup dawn_c_util
 /// @{
-inline const DawnCompiler* toConstCompiler(const dawnCompiler_t* compiler) {
+inline const CompilerHandle* toConstCompilerHandle(const dawnCompiler_t* compiler) {
   if(!compiler->Impl)
     dawnFatalError("uninitialized Compiler");
-  return reinterpret_cast<const DawnCompiler*>(compiler->Impl);
+  return reinterpret_cast<const CompilerHandle*>(compiler->Impl);
 }
 
-inline DawnCompiler* toCompiler(dawnCompiler_t* compiler) {
+inline CompilerHandle* toCompilerHandle(dawnCompiler_t* compiler) {
   if(!compiler->Impl)
     dawnFatalError("uninitialized Compiler");
-  return reinterpret_cast<DawnCompiler*>(compiler->Impl);
+  return reinterpret_cast<CompilerHandle*>(compiler->Impl);
 }
 /// @}
 
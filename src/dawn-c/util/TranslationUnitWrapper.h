@@ -17,7 +17,9 @@
 
 #include "dawn-c/ErrorHandling.h"
 #include "dawn-c/TranslationUnit.h"
+#include "dawn-c/util/Allocate.h"
 #include "dawn/CodeGen/TranslationUnit.h"
+#include <memory>
 
 namespace dawn {
 
@@ -39,6 +41,31 @@ inline codegen::TranslationUnit* toTranslationUnit(dawnTranslationUnit_t* TU) {
 }
 /// @}
 
+/// @brief Wrap `TU` in a newly allocated `dawnTranslationUnit_t` which owns it
+/// @ingroup dawn_c_util
+inline dawnTranslationUnit_t*
+allocateTranslationUnit(std::unique_ptr<codegen::TranslationUnit> TU) {
+  dawnTranslationUnit_t* translationUnit = allocate<dawnTranslationUnit_t>();
+  translationUnit->Impl = TU.release();
+  translationUnit->OwnsData = 1;
+  return translationUnit;
+}
+
+/// @brief Position of a `dawnStencilIterator_t` in the stencils of a TranslationUnit
+/// @ingroup dawn_c_util
+struct StencilIterator {
+  codegen::TranslationUnit::const_iterator Current;
+  codegen::TranslationUnit::const_iterator End;
+};
+
+/// @brief Convert `dawnStencilIterator_t` to `StencilIterator`
+/// @ingroup dawn_c_util
+inline StencilIterator* toStencilIterator(dawnStencilIterator_t* iterator) {
+  if(!iterator->Impl)
+    dawnFatalError("uninitialized StencilIterator");
+  return reinterpret_cast<StencilIterator*>(iterator->Impl);
+}
+
 } // namespace util
 
 } // namespace dawn
@@ -28,15 +28,15 @@ ASTCodeGenCXX::~ASTCodeGenCXX() {}
 //     Stmt
 //===------------------------------------------------------------------------------------------===//
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<BlockStmt>& stmt) {
+void ASTCodeGenCXX::visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>& node) {
   scopeDepth_++;
   ss_ << std::string(indent_, ' ') << "{\n";
 
   indent_ += DAWN_PRINT_INDENT;
   auto indent = std::string(indent_, ' ');
-  for(const auto& s : stmt->getStatements()) {
+  for(const auto& s : stmt.getStatements()) {
     ss_ << indent;
-    s->accept(*this);
+    visit(s);
   }
   indent_ -= DAWN_PRINT_INDENT;
 
@@ -44,19 +44,19 @@ void ASTCodeGenCXX::visit(const std::shared_ptr<BlockStmt>& stmt) {
   scopeDepth_--;
 }
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<ExprStmt>& stmt) {
+void ASTCodeGenCXX::visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>& node) {
   if(scopeDepth_ == 0)
     ss_ << std::string(indent_, ' ');
 
-  stmt->getExpr()->accept(*this);
+  visit(stmt.getExpr());
   ss_ << ";\n";
 }
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<VarDeclStmt>& stmt) {
+void ASTCodeGenCXX::visitVarDeclStmt(const VarDeclStmt& stmt, const std::shared_ptr<Stmt>& node) {
   if(scopeDepth_ == 0)
     ss_ << std::string(indent_, ' ');
 
-  const auto& type = stmt->getType();
+  const auto& type = stmt.getType();
   if(type.isConst())
     ss_ << "const ";
   if(type.isVolatile())
@@ -66,20 +66,20 @@ void ASTCodeGenCXX::visit(const std::shared_ptr<VarDeclStmt>& stmt) {
     ss_ << ASTCodeGenCXX::builtinTypeIDToCXXType(type.getBuiltinTypeID(), true);
   else
     ss_ << type.getName();
-  ss_ << " " << getName(stmt);
+  ss_ << " " << getName(node);
 
-  if(stmt->isArray())
-    ss_ << "[" << stmt->getDimension() << "]";
+  if(stmt.isArray())
+    ss_ << "[" << stmt.getDimension() << "]";
 
-  if(stmt->hasInit()) {
-    ss_ << " " << stmt->getOp() << " ";
-    if(!stmt->isArray())
-      stmt->getInitList().front()->accept(*this);
+  if(stmt.hasInit()) {
+    ss_ << " " << stmt.getOp() << " ";
+    if(!stmt.isArray())
+      visit(stmt.getInitList().front());
     else {
       ss_ << "{";
-      int numInit = stmt->getInitList().size();
+      int numInit = stmt.getInitList().size();
       for(int i = 0; i < numInit; ++i) {
-        stmt->getInitList()[i]->accept(*this);
+        visit(stmt.getInitList()[i]);
         ss_ << ((i != (numInit - 1)) ? ", " : "");
       }
       ss_ << "}";
@@ -88,18 +88,18 @@ void ASTCodeGenCXX::visit(const std::shared_ptr<VarDeclStmt>& stmt) {
   ss_ << ";\n";
 }
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<IfStmt>& stmt) {
+void ASTCodeGenCXX::visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node) {
   if(scopeDepth_ == 0)
     ss_ << std::string(indent_, ' ');
 
   ss_ << "if(";
-  stmt->getCondExpr()->accept(*this);
+  visit(stmt.getCondExpr());
   ss_ << ")\n";
 
-  stmt->getThenStmt()->accept(*this);
-  if(stmt->hasElse()) {
+  visit(stmt.getThenStmt());
+  if(stmt.hasElse()) {
     ss_ << std::string(indent_, ' ') << "else\n";
-    stmt->getElseStmt()->accept(*this);
+    visit(stmt.getElseStmt());
   }
 }
 
@@ -107,50 +107,55 @@ void ASTCodeGenCXX::visit(const std::shared_ptr<IfStmt>& stmt) {
 //     Expr
 //===------------------------------------------------------------------------------------------===//
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<UnaryOperator>& expr) {
-  ss_ << "(" << expr->getOp();
-  expr->getOperand()->accept(*this);
+void ASTCodeGenCXX::visitUnaryOperator(const UnaryOperator& expr,
+                                       const std::shared_ptr<Expr>& node) {
+  ss_ << "(" << expr.getOp();
+  visit(expr.getOperand());
   ss_ << ")";
 }
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<BinaryOperator>& expr) {
+void ASTCodeGenCXX::visitBinaryOperator(const BinaryOperator& expr,
+                                        const std::shared_ptr<Expr>& node) {
   ss_ << "(";
-  expr->getLeft()->accept(*this);
-  ss_ << " " << expr->getOp() << " ";
-  expr->getRight()->accept(*this);
+  visit(expr.getLeft());
+  ss_ << " " << expr.getOp() << " ";
+  visit(expr.getRight());
   ss_ << ")";
 }
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<AssignmentExpr>& expr) {
-  expr->getLeft()->accept(*this);
-  ss_ << " " << expr->getOp() << " ";
-  expr->getRight()->accept(*this);
+void ASTCodeGenCXX::visitAssignmentExpr(const AssignmentExpr& expr,
+                                        const std::shared_ptr<Expr>& node) {
+  visit(expr.getLeft());
+  ss_ << " " << expr.getOp() << " ";
+  visit(expr.getRight());
 }
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<TernaryOperator>& expr) {
+void ASTCodeGenCXX::visitTernaryOperator(const TernaryOperator& expr,
+                                         const std::shared_ptr<Expr>& node) {
   ss_ << "(";
-  expr->getCondition()->accept(*this);
-  ss_ << " " << expr->getOp() << " ";
-  expr->getLeft()->accept(*this);
-  ss_ << " " << expr->getSeperator() << " ";
-  expr->getRight()->accept(*this);
+  visit(expr.getCondition());
+  ss_ << " " << expr.getOp() << " ";
+  visit(expr.getLeft());
+  ss_ << " " << expr.getSeperator() << " ";
+  visit(expr.getRight());
   ss_ << ")";
 }
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<FunCallExpr>& expr) {
-  ss_ << expr->getCallee() << "(";
+void ASTCodeGenCXX::visitFunCallExpr(const FunCallExpr& expr, const std::shared_ptr<Expr>& node) {
+  ss_ << expr.getCallee() << "(";
 
-  std::size_t numArgs = expr->getArguments().size();
+  std::size_t numArgs = expr.getArguments().size();
   for(std::size_t i = 0; i < numArgs; ++i) {
-    expr->getArguments()[i]->accept(*this);
+    visit(expr.getArguments()[i]);
     ss_ << (i == numArgs - 1 ? "" : ", ");
   }
   ss_ << ")";
 }
 
-void ASTCodeGenCXX::visit(const std::shared_ptr<LiteralAccessExpr>& expr) {
-  std::string type(ASTCodeGenCXX::builtinTypeIDToCXXType(expr->getBuiltinType(), false));
-  ss_ << (type.empty() ? "" : "(" + type + ") ") << expr->getValue();
+void ASTCodeGenCXX::visitLiteralAccessExpr(const LiteralAccessExpr& expr,
+                                           const std::shared_ptr<Expr>& node) {
+  std::string type(ASTCodeGenCXX::builtinTypeIDToCXXType(expr.getBuiltinType(), false));
+  ss_ << (type.empty() ? "" : "(" + type + ") ") << expr.getValue();
 }
 
 void ASTCodeGenCXX::setIndent(int indent) { indent_ = indent; }
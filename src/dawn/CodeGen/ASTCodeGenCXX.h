@@ -15,7 +15,7 @@
 #ifndef DAWN_CODEGEN_ASTCODEGENCXX_H
 #define DAWN_CODEGEN_ASTCODEGENCXX_H
 
-#include "dawn/SIR/ASTVisitor.h"
+#include "dawn/SIR/ASTKindVisitor.h"
 #include "dawn/Support/NonCopyable.h"
 #include "dawn/Support/Type.h"
 #include <sstream>
@@ -24,8 +24,11 @@ namespace dawn {
 namespace codegen {
 
 /// @brief Abstract base class of all C++ code generation visitor
+///
+/// The nodes are dispatched by kind (see `ASTKindVisitor`) to the virtual handlers below, which
+/// are implemented by the code generators of the backends.
 /// @ingroup codegen
-class ASTCodeGenCXX : public ASTVisitor, public NonCopyable {
+class ASTCodeGenCXX : public ASTKindVisitor<ASTCodeGenCXX>, public NonCopyable {
 protected:
   /// Indent of each statement
   int indent_;
@@ -42,27 +45,35 @@ public:
 
   /// @name Statement implementation
   /// @{
-  virtual void visit(const std::shared_ptr<BlockStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<ExprStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<VarDeclStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<IfStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<ReturnStmt>& stmt) override = 0;
-  virtual void visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) override = 0;
-  virtual void visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) override = 0;
+  virtual void visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>& node);
+  virtual void visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>& node);
+  virtual void visitVarDeclStmt(const VarDeclStmt& stmt, const std::shared_ptr<Stmt>& node);
+  virtual void visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node);
+  virtual void visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) = 0;
+  virtual void visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                           const std::shared_ptr<Stmt>& node) = 0;
+  virtual void visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                        const std::shared_ptr<Stmt>& node) = 0;
+  virtual void visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                              const std::shared_ptr<Stmt>& node) = 0;
   /// @}
 
   /// @name Expression implementation
   /// @{
-  virtual void visit(const std::shared_ptr<UnaryOperator>& expr) override;
-  virtual void visit(const std::shared_ptr<BinaryOperator>& expr) override;
-  virtual void visit(const std::shared_ptr<AssignmentExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<TernaryOperator>& expr) override;
-  virtual void visit(const std::shared_ptr<FunCallExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override = 0;
-  virtual void visit(const std::shared_ptr<StencilFunArgExpr>& expr) override = 0;
-  virtual void visit(const std::shared_ptr<VarAccessExpr>& expr) override = 0;
-  virtual void visit(const std::shared_ptr<LiteralAccessExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<FieldAccessExpr>& expr) override = 0;
+  virtual void visitUnaryOperator(const UnaryOperator& expr, const std::shared_ptr<Expr>& node);
+  virtual void visitBinaryOperator(const BinaryOperator& expr, const std::shared_ptr<Expr>& node);
+  virtual void visitAssignmentExpr(const AssignmentExpr& expr, const std::shared_ptr<Expr>& node);
+  virtual void visitTernaryOperator(const TernaryOperator& expr, const std::shared_ptr<Expr>& node);
+  virtual void visitFunCallExpr(const FunCallExpr& expr, const std::shared_ptr<Expr>& node);
+  virtual void visitStencilFunCallExpr(const StencilFunCallExpr& expr,
+                                       const std::shared_ptr<Expr>& node) = 0;
+  virtual void visitStencilFunArgExpr(const StencilFunArgExpr& expr,
+                                      const std::shared_ptr<Expr>& node) = 0;
+  virtual void visitVarAccessExpr(const VarAccessExpr& expr, const std::shared_ptr<Expr>& node) = 0;
+  virtual void visitLiteralAccessExpr(const LiteralAccessExpr& expr,
+                                      const std::shared_ptr<Expr>& node);
+  virtual void visitFieldAccessExpr(const FieldAccessExpr& expr,
+                                    const std::shared_ptr<Expr>& node) = 0;
   /// @}
 
   /// @brief Get the generated code and reset the internal string stream
@@ -57,64 +57,91 @@ int ASTStencilBody::getAccessID(const std::shared_ptr<Expr>& expr) const {
 //     Stmt
 //===------------------------------------------------------------------------------------------===//
 
-void ASTStencilBody::visit(const std::shared_ptr<BlockStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilBody::visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitBlockStmt(stmt, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<ExprStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilBody::visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitExprStmt(stmt, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<ReturnStmt>& stmt) {
+void ASTStencilBody::visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) {
   if(scopeDepth_ == 0)
     ss_ << std::string(indent_, ' ');
 
   ss_ << "return ";
 
-  stmt->getExpr()->accept(*this);
+  visit(stmt.getExpr());
   ss_ << ";\n";
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<VarDeclStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilBody::visitVarDeclStmt(const VarDeclStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitVarDeclStmt(stmt, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) {
+void ASTStencilBody::visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                                 const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT_MSG(0, "VerticalRegionDeclStmt not allowed in this context");
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) {
+void ASTStencilBody::visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                              const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT_MSG(0, "StencilCallDeclStmt not allowed in this context");
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) {
+void ASTStencilBody::visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                                    const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT_MSG(0, "BoundaryConditionDeclStmt not allowed in this context");
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<IfStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilBody::visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitIfStmt(stmt, node);
+}
 
 //===------------------------------------------------------------------------------------------===//
 //     Expr
 //===------------------------------------------------------------------------------------------===//
 
-void ASTStencilBody::visit(const std::shared_ptr<UnaryOperator>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitUnaryOperator(const UnaryOperator& expr,
+                                        const std::shared_ptr<Expr>& node) {
+  Base::visitUnaryOperator(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<BinaryOperator>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitBinaryOperator(const BinaryOperator& expr,
+                                         const std::shared_ptr<Expr>& node) {
+  Base::visitBinaryOperator(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<AssignmentExpr>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitAssignmentExpr(const AssignmentExpr& expr,
+                                         const std::shared_ptr<Expr>& node) {
+  Base::visitAssignmentExpr(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<TernaryOperator>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitTernaryOperator(const TernaryOperator& expr,
+                                          const std::shared_ptr<Expr>& node) {
+  Base::visitTernaryOperator(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<FunCallExpr>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitFunCallExpr(const FunCallExpr& expr, const std::shared_ptr<Expr>& node) {
+  Base::visitFunCallExpr(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
+void ASTStencilBody::visitStencilFunCallExpr(const StencilFunCallExpr& expr,
+                                             const std::shared_ptr<Expr>& node) {
   if(nestingOfStencilFunArgLists_++)
     ss_ << ", ";
 
+  auto callExpr = std::static_pointer_cast<StencilFunCallExpr>(node);
   const std::shared_ptr<dawn::StencilFunctionInstantiation>& stencilFun =
-      currentFunction_ ? currentFunction_->getStencilFunctionInstantiation(expr)
-                       : instantiation_->getStencilFunctionInstantiation(expr);
+      currentFunction_ ? currentFunction_->getStencilFunctionInstantiation(callExpr)
+                       : instantiation_->getStencilFunctionInstantiation(callExpr);
 
   ss_ << dawn::StencilFunctionInstantiation::makeCodeGenName(*stencilFun) << "(i,j,k";
 
   //  int n = 0;
   ASTStencilFunctionParamVisitor fieldAccessVisitor(currentFunction_, instantiation_);
 
-  for(auto& arg : expr->getArguments()) {
+  for(auto& arg : expr.getArguments()) {
 
     arg->accept(fieldAccessVisitor);
     //    ++n;
@@ -125,34 +152,40 @@ void ASTStencilBody::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
   ss_ << ")";
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<StencilFunArgExpr>& expr) {}
+void ASTStencilBody::visitStencilFunArgExpr(const StencilFunArgExpr& expr,
+                                            const std::shared_ptr<Expr>& node) {}
 
-void ASTStencilBody::visit(const std::shared_ptr<VarAccessExpr>& expr) {
-  std::string name = getName(expr);
-  int AccessID = getAccessID(expr);
+void ASTStencilBody::visitVarAccessExpr(const VarAccessExpr& expr,
+                                        const std::shared_ptr<Expr>& node) {
+  std::string name = getName(node);
+  int AccessID = getAccessID(node);
 
   if(instantiation_->isGlobalVariable(AccessID)) {
     ss_ << "globals::get()." << name << ".get_value()";
   } else {
     ss_ << name;
 
-    if(expr->isArrayAccess()) {
+    if(expr.isArrayAccess()) {
       ss_ << "[";
-      expr->getIndex()->accept(*this);
+      visit(expr.getIndex());
       ss_ << "]";
     }
   }
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<LiteralAccessExpr>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitLiteralAccessExpr(const LiteralAccessExpr& expr,
+                                            const std::shared_ptr<Expr>& node) {
+  Base::visitLiteralAccessExpr(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<FieldAccessExpr>& expr) {
+void ASTStencilBody::visitFieldAccessExpr(const FieldAccessExpr& expr,
+                                          const std::shared_ptr<Expr>& node) {
 
   if(currentFunction_) {
     // extract the arg index, from the AccessID
     int argIndex = -1;
     for(auto idx : currentFunction_->ArgumentIndexToCallerAccessIDMap()) {
-      if(idx.second == currentFunction_->getAccessIDFromExpr(expr))
+      if(idx.second == currentFunction_->getAccessIDFromExpr(node))
         argIndex = idx.first;
     }
 
@@ -183,7 +216,7 @@ void ASTStencilBody::visit(const std::shared_ptr<FieldAccessExpr>& expr) {
         // parse the argument if it is a field. Ignore offsets/directions,
         // since they are "inlined" in the code generation of the function
         if(argStencilFn.isArgField(argIdx)) {
-          Array3i offset = currentFunction_->evalOffsetOfFieldAccessExpr(expr, false);
+          Array3i offset = currentFunction_->evalOffsetOfFieldAccessExpr(expr, node, false);
 
           std::string accessName =
               currentFunction_->getArgNameFromFunctionCall(argStencilFn.getName());
@@ -205,14 +238,21 @@ void ASTStencilBody::visit(const std::shared_ptr<FieldAccessExpr>& expr) {
 
     } else {
       std::string accessName = currentFunction_->getOriginalNameFromCallerAccessID(
-          currentFunction_->getAccessIDFromExpr(expr));
+          currentFunction_->getAccessIDFromExpr(node));
       ss_ << accessName
-          << offsetPrinter_(ijkfyOffset(currentFunction_->evalOffsetOfFieldAccessExpr(expr, false),
-                                        accessName));
+          << offsetPrinter_(ijkfyOffset(
+                 currentFunction_->evalOffsetOfFieldAccessExpr(expr, node, false), accessName));
     }
   } else {
-    std::string accessName = getName(expr);
-    ss_ << accessName << offsetPrinter_(ijkfyOffset(expr->getOffset(), accessName));
+    std::string accessName = getName(node);
+    auto offset = ijkfyOffset(expr.getOffset(), accessName);
+
+    auto it = kWindows_.find(instantiation_->getAccessIDFromExpr(node));
+    if(it != kWindows_.end()) {
+      std::string window = std::to_string(it->second);
+      offset[2] = it->second == 1 ? "0" : "(" + offset[2] + "+" + window + ")%" + window;
+    }
+    ss_ << accessName << offsetPrinter_(offset);
   }
 }
 
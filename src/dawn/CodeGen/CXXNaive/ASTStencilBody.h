@@ -19,6 +19,7 @@
 #include "dawn/CodeGen/CodeGenProperties.h"
 #include "dawn/Optimizer/Interval.h"
 #include "dawn/Support/StringUtil.h"
+#include <map>
 #include <stack>
 #include <unordered_map>
 
@@ -43,6 +44,9 @@ protected:
   /// Nesting level of argument lists of stencil function *calls*
   int nestingOfStencilFunArgLists_;
 
+  /// Number of vertical levels of the temporaries stored in ring buffers (by AccessID)
+  std::map<int, int> kWindows_;
+
   StencilContext stencilContext_;
 
   ///
@@ -76,34 +80,52 @@ public:
 
   /// @name Statement implementation
   /// @{
-  virtual void visit(const std::shared_ptr<BlockStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<ExprStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<ReturnStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<VarDeclStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<IfStmt>& stmt) override;
+  virtual void visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>& node) override;
+  virtual void visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>& node) override;
+  virtual void visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) override;
+  virtual void visitVarDeclStmt(const VarDeclStmt& stmt,
+                                const std::shared_ptr<Stmt>& node) override;
+  virtual void visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                           const std::shared_ptr<Stmt>& node) override;
+  virtual void visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                        const std::shared_ptr<Stmt>& node) override;
+  virtual void visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                              const std::shared_ptr<Stmt>& node) override;
+  virtual void visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node) override;
   /// @}
 
   /// @name Expression implementation
   /// @{
-  virtual void visit(const std::shared_ptr<UnaryOperator>& expr) override;
-  virtual void visit(const std::shared_ptr<BinaryOperator>& expr) override;
-  virtual void visit(const std::shared_ptr<AssignmentExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<TernaryOperator>& expr) override;
-  virtual void visit(const std::shared_ptr<FunCallExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<StencilFunArgExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<VarAccessExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<LiteralAccessExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<FieldAccessExpr>& expr) override;
+  virtual void visitUnaryOperator(const UnaryOperator& expr,
+                                  const std::shared_ptr<Expr>& node) override;
+  virtual void visitBinaryOperator(const BinaryOperator& expr,
+                                   const std::shared_ptr<Expr>& node) override;
+  virtual void visitAssignmentExpr(const AssignmentExpr& expr,
+                                   const std::shared_ptr<Expr>& node) override;
+  virtual void visitTernaryOperator(const TernaryOperator& expr,
+                                    const std::shared_ptr<Expr>& node) override;
+  virtual void visitFunCallExpr(const FunCallExpr& expr,
+                                const std::shared_ptr<Expr>& node) override;
+  virtual void visitStencilFunCallExpr(const StencilFunCallExpr& expr,
+                                       const std::shared_ptr<Expr>& node) override;
+  virtual void visitStencilFunArgExpr(const StencilFunArgExpr& expr,
+                                      const std::shared_ptr<Expr>& node) override;
+  virtual void visitVarAccessExpr(const VarAccessExpr& expr,
+                                  const std::shared_ptr<Expr>& node) override;
+  virtual void visitLiteralAccessExpr(const LiteralAccessExpr& expr,
+                                      const std::shared_ptr<Expr>& node) override;
+  virtual void visitFieldAccessExpr(const FieldAccessExpr& expr,
+                                    const std::shared_ptr<Expr>& node) override;
   /// @}
 
   /// @brief Set the current stencil function (can be NULL)
   void
   setCurrentStencilFunction(const std::shared_ptr<StencilFunctionInstantiation>& currentFunction);
 
+  /// @brief Set the number of vertical levels of the temporaries stored in ring buffers (the
+  /// vertical index of their accesses wraps around)
+  void setTemporaryKWindows(const std::map<int, int>& kWindows) { kWindows_ = kWindows; }
+
   /// @brief Mapping of VarDeclStmt and Var/FieldAccessExpr to their name
   std::string getName(const std::shared_ptr<Expr>& expr) const override;
   std::string getName(const std::shared_ptr<Stmt>& stmt) const override;
@@ -40,23 +40,27 @@ std::string ASTStencilDesc::getName(const std::shared_ptr<Expr>& expr) const {
 //     Stmt
 //===------------------------------------------------------------------------------------------===//
 
-void ASTStencilDesc::visit(const std::shared_ptr<ReturnStmt>& stmt) {
+void ASTStencilDesc::visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT_MSG(0, "ReturnStmt not allowed in StencilDesc AST");
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) {
+void ASTStencilDesc::visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                                 const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT_MSG(0, "VerticalRegionDeclStmt not allowed in StencilDesc AST");
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) {
-  int stencilID = instantiation_->getStencilCallToStencilIDMap().find(stmt)->second;
+void ASTStencilDesc::visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                              const std::shared_ptr<Stmt>& node) {
+  auto stencilCall = std::static_pointer_cast<StencilCallDeclStmt>(node);
+  int stencilID = instantiation_->getStencilCallToStencilIDMap().find(stencilCall)->second;
 
   std::string stencilName =
       codeGenProperties_.getStencilName(StencilContext::SC_Stencil, stencilID);
   ss_ << "m_" << stencilName + "->run();\n";
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) {
+void ASTStencilDesc::visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                                    const std::shared_ptr<Stmt>& node) {
   //  DAWN_ASSERT_MSG(0, "BoundaryConditionDeclStmt not yet implemented");
 }
 
@@ -64,28 +68,32 @@ void ASTStencilDesc::visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stm
 //     Expr
 //===------------------------------------------------------------------------------------------===//
 
-void ASTStencilDesc::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
+void ASTStencilDesc::visitStencilFunCallExpr(const StencilFunCallExpr& expr,
+                                             const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT_MSG(0, "StencilFunCallExpr not allowed in StencilDesc AST");
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<StencilFunArgExpr>& expr) {
+void ASTStencilDesc::visitStencilFunArgExpr(const StencilFunArgExpr& expr,
+                                            const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT_MSG(0, "StencilFunArgExpr not allowed in StencilDesc AST");
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<VarAccessExpr>& expr) {
-  if(instantiation_->isGlobalVariable(instantiation_->getAccessIDFromExpr(expr)))
+void ASTStencilDesc::visitVarAccessExpr(const VarAccessExpr& expr,
+                                        const std::shared_ptr<Expr>& node) {
+  if(instantiation_->isGlobalVariable(instantiation_->getAccessIDFromExpr(node)))
     ss_ << "globals::get().";
 
-  ss_ << getName(expr);
+  ss_ << getName(node);
 
-  if(expr->isArrayAccess()) {
+  if(expr.isArrayAccess()) {
     ss_ << "[";
-    expr->getIndex()->accept(*this);
+    visit(expr.getIndex());
     ss_ << "]";
   }
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<FieldAccessExpr>& expr) {
+void ASTStencilDesc::visitFieldAccessExpr(const FieldAccessExpr& expr,
+                                          const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT_MSG(0, "FieldAccessExpr not allowed in StencilDesc AST");
 }
 
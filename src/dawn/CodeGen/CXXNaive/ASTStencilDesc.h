@@ -46,18 +46,25 @@ public:
 
   /// @name Statement implementation
   /// @{
-  virtual void visit(const std::shared_ptr<ReturnStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) override;
-  virtual void visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) override;
+  virtual void visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) override;
+  virtual void visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                           const std::shared_ptr<Stmt>& node) override;
+  virtual void visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                        const std::shared_ptr<Stmt>& node) override;
+  virtual void visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                              const std::shared_ptr<Stmt>& node) override;
   /// @}
 
   /// @name Expression implementation
   /// @{
-  virtual void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<StencilFunArgExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<VarAccessExpr>& expr) override;
-  virtual void visit(const std::shared_ptr<FieldAccessExpr>& expr) override;
+  virtual void visitStencilFunCallExpr(const StencilFunCallExpr& expr,
+                                       const std::shared_ptr<Expr>& node) override;
+  virtual void visitStencilFunArgExpr(const StencilFunArgExpr& expr,
+                                      const std::shared_ptr<Expr>& node) override;
+  virtual void visitVarAccessExpr(const VarAccessExpr& expr,
+                                  const std::shared_ptr<Expr>& node) override;
+  virtual void visitFieldAccessExpr(const FieldAccessExpr& expr,
+                                    const std::shared_ptr<Expr>& node) override;
   /// @}
 
   std::string getName(const std::shared_ptr<Stmt>& stmt) const override;
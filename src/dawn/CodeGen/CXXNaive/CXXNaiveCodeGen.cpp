@@ -24,6 +24,7 @@
 #include "dawn/Support/Logging.h"
 #include "dawn/Support/StringUtil.h"
 #include <algorithm>
+#include <cstdlib>
 #include <vector>
 
 namespace dawn {
@@ -61,6 +62,112 @@ static std::string makeKLoop(const std::string dom, bool isBackward, Interval co
                     : makeLoopImpl(Extent{}, "k", lower, upper, "<=", "++");
 }
 
+namespace {
+
+/// @brief Generate the body of the stencil function of a boundary condition applied to the point
+/// (i,j,k) of the fields of the boundary condition statement
+class BoundaryConditionBody : public ASTCodeGenCXX {
+  const sir::StencilFunction& function_;
+  const BoundaryConditionDeclStmt& bc_;
+  const SIR& sir_;
+
+public:
+  using Base = ASTCodeGenCXX;
+
+  BoundaryConditionBody(const sir::StencilFunction& function, const BoundaryConditionDeclStmt& bc,
+                        const SIR& sir)
+      : function_(function), bc_(bc), sir_(sir) {}
+
+  void visitFieldAccessExpr(const FieldAccessExpr& expr,
+                            const std::shared_ptr<Expr>& node) override {
+    auto argIt = std::find_if(function_.Args.begin(), function_.Args.end(),
+                              [&](const std::shared_ptr<sir::StencilFunctionArg>& arg) {
+                                return arg->Name == expr.getName();
+                              });
+    std::size_t argIndex = std::distance(function_.Args.begin(), argIt);
+    DAWN_ASSERT_MSG(argIndex < bc_.getFields().size(), "invalid boundary condition argument");
+
+    const Array3i& offset = expr.getOffset();
+    ss_ << bc_.getFields()[argIndex]->Name << "(i+" << offset[0] << ",j+" << offset[1] << ",k+"
+        << offset[2] << ")";
+  }
+
+  void visitVarAccessExpr(const VarAccessExpr& expr, const std::shared_ptr<Expr>& node) override {
+    if(sir_.GlobalVariableMap->count(expr.getName()))
+      ss_ << "globals::get()." << expr.getName() << ".get_value()";
+    else
+      ss_ << expr.getName();
+
+    if(expr.isArrayAccess()) {
+      ss_ << "[";
+      visit(expr.getIndex());
+      ss_ << "]";
+    }
+  }
+
+  void visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) override {
+    DAWN_ASSERT_MSG(0, "ReturnStmt not allowed in this context");
+  }
+  void visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                   const std::shared_ptr<Stmt>& node) override {
+    DAWN_ASSERT_MSG(0, "VerticalRegionDeclStmt not allowed in this context");
+  }
+  void visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                const std::shared_ptr<Stmt>& node) override {
+    DAWN_ASSERT_MSG(0, "StencilCallDeclStmt not allowed in this context");
+  }
+  void visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                      const std::shared_ptr<Stmt>& node) override {
+    DAWN_ASSERT_MSG(0, "BoundaryConditionDeclStmt not allowed in this context");
+  }
+  void visitStencilFunCallExpr(const StencilFunCallExpr& expr,
+                               const std::shared_ptr<Expr>& node) override {
+    DAWN_ASSERT_MSG(0, "StencilFunCallExpr not allowed in this context");
+  }
+  void visitStencilFunArgExpr(const StencilFunArgExpr& expr,
+                              const std::shared_ptr<Expr>& node) override {
+    DAWN_ASSERT_MSG(0, "StencilFunArgExpr not allowed in this context");
+  }
+
+  std::string getName(const std::shared_ptr<Stmt>& stmt) const override {
+    return std::static_pointer_cast<VarDeclStmt>(stmt)->getName();
+  }
+  std::string getName(const std::shared_ptr<Expr>& expr) const override {
+    return std::static_pointer_cast<VarAccessExpr>(expr)->getName();
+  }
+};
+
+} // anonymous namespace
+
+/// @brief Apply the boundary condition `bc` to the boundary points of the vertical level `k`
+static void addBoundaryCondition(MemberFunction& method,
+                                 const StencilInstantiation& stencilInstantiation,
+                                 const std::shared_ptr<BoundaryConditionDeclStmt>& bc) {
+  std::shared_ptr<sir::StencilFunction> function =
+      stencilInstantiation.getSIR()->getStencilFunction(bc->getFunctor());
+  DAWN_ASSERT_MSG(function, "boundary condition is not a stencil function");
+
+  Extents extents = stencilInstantiation.getBoundaryConditionExtentsFromBCStmt(bc);
+  auto makeHaloLoop = [&](int dim, const std::string& name) {
+    return makeIJLoop(Extent(-std::abs(extents[dim].Minus), std::abs(extents[dim].Plus)), "m_dom",
+                      name);
+  };
+  auto isOutside = [](const std::string& name) {
+    return name + " < m_dom." + name + "minus() || " + name + " > m_dom." + name +
+           "size() - m_dom." + name + "plus() - 1";
+  };
+
+  method.addBlockStatement(makeHaloLoop(0, "i"), [&]() {
+    method.addBlockStatement(makeHaloLoop(1, "j"), [&]() {
+      method.addBlockStatement("if(" + isOutside("i") + " || " + isOutside("j") + ")", [&]() {
+        BoundaryConditionBody body(*function, *bc, *stencilInstantiation.getSIR());
+        body.visit(*function->Asts[0]);
+        method << body.getCodeAndResetStream();
+      });
+    });
+  });
+}
+
 CXXNaiveCodeGen::CXXNaiveCodeGen(OptimizerContext* context) : CodeGen(context) {}
 
 CXXNaiveCodeGen::~CXXNaiveCodeGen() {}
@@ -163,7 +270,7 @@ CXXNaiveCodeGen::generateStencilInstantiation(const StencilInstantiation* stenci
       stencilBodyCXXVisitor.setCurrentStencilFunction(stencilFun);
       stencilBodyCXXVisitor.setIndent(stencilFunMethod.getIndent());
       for(const auto& statementAccessesPair : stencilFun->getStatementAccessesPairs()) {
-        statementAccessesPair->getStatement()->ASTStmt->accept(stencilBodyCXXVisitor);
+        stencilBodyCXXVisitor.visit(statementAccessesPair->getStatement()->ASTStmt);
         stencilFunMethod.indentStatment();
         stencilFunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
       }
@@ -230,6 +337,7 @@ CXXNaiveCodeGen::generateStencilInstantiation(const StencilInstantiation* stenci
     }
 
     ASTStencilBody stencilBodyCXXVisitor(stencilInstantiation, StencilContext::SC_Stencil);
+    stencilBodyCXXVisitor.setTemporaryKWindows(getTemporaryKWindows(stencil));
 
     StencilClass.addComment("Members");
     StencilClass.addComment("Temporary storages");
@@ -241,7 +349,7 @@ CXXNaiveCodeGen::generateStencilInstantiation(const StencilInstantiation* stenci
       StencilClass.addMember(StencilTemplates[fieldIt.idx()] + "&", "m_" + (*fieldIt).Name);
     }
 
-    addTmpStorageDeclaration(StencilClass, tempFields);
+    addTmpStorageDeclaration(StencilClass, stencil, tempFields);
 
     StencilClass.changeAccessibility("public");
 
@@ -332,14 +440,19 @@ CXXNaiveCodeGen::generateStencilInstantiation(const StencilInstantiation* stenci
                                 continue;
                               for(const auto& statementAccessesPair :
                                   doMethod.getStatementAccessesPairs()) {
-                                statementAccessesPair->getStatement()->ASTStmt->accept(
-                                    stencilBodyCXXVisitor);
+                                stencilBodyCXXVisitor.visit(
+                                    statementAccessesPair->getStatement()->ASTStmt);
                                 StencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
                               }
                             }
 
                           });
                     });
+
+                // Boundary conditions fused into the stage are applied while the level is still
+                // in cache
+                for(const auto& bc : stage.getBoundaryConditions())
+                  addBoundaryCondition(StencilRunMethod, *stencilInstantiation, bc);
               }
             });
       }
@@ -365,13 +478,7 @@ CXXNaiveCodeGen::generateStencilInstantiation(const StencilInstantiation* stenci
   // Members
   //
   // Define allocated memebers if necessary
-  if(stencilInstantiation->hasAllocatedFields()) {
-    StencilWrapperClass.addMember(c_gtc() + "meta_data_t", "m_meta_data");
-
-    for(int AccessID : stencilInstantiation->getAllocatedFieldAccessIDs())
-      StencilWrapperClass.addMember(c_gtc() + "storage_t",
-                                    "m_" + stencilInstantiation->getNameFromAccessID(AccessID));
-  }
+  addAllocatedStorageDeclaration(StencilWrapperClass, *stencilInstantiation);
 
   // Generate stencil wrapper constructor
   decltype(stencilInstantiation->getSIRStencil()->Fields) SIRFieldsWithoutTemps;
@@ -387,17 +494,18 @@ CXXNaiveCodeGen::generateStencilInstantiation(const StencilInstantiation* stenci
     codeGenProperties.insertParam(i, SIRFieldsWithoutTemps[i]->Name, StencilWrapperRunTemplates[i]);
   }
 
-  auto StencilWrapperConstructor = StencilWrapperClass.addConstructor(RangeToString(", ", "", "")(
-      StencilWrapperRunTemplates, [](const std::string& str) { return "class " + str; }));
-
-  StencilWrapperConstructor.addArg("const " + c_gtc() + "domain& dom");
-  std::string ctrArgs("(dom");
-  for(int i = 0; i < SIRFieldsWithoutTemps.size(); ++i) {
-    StencilWrapperConstructor.addArg(
+  std::vector<std::string> StencilWrapperConstructorArgs{"const " + c_gtc().str() + "domain& dom"};
+  for(int i = 0; i < SIRFieldsWithoutTemps.size(); ++i)
+    StencilWrapperConstructorArgs.push_back(
         codeGenProperties.getParamType(SIRFieldsWithoutTemps[i]->Name) + "& " +
         SIRFieldsWithoutTemps[i]->Name);
-    ctrArgs += "," + SIRFieldsWithoutTemps[i]->Name;
-  }
+
+  auto StencilWrapperConstructor = StencilWrapperClass.addConstructor(
+      RangeToString(", ", "", "")(StencilWrapperRunTemplates,
+                                  [](const std::string& str) { return "class " + str; }),
+      StencilWrapperConstructorArgs,
+      getWrapperConstructorDefinitionStream(stencilInstantiation->getName()),
+      getWrapperNamespace());
 
   // add the ctr initialization of each stencil
   for(std::size_t stencilIdx = 0; stencilIdx < stencils.size(); ++stencilIdx) {
@@ -418,9 +526,10 @@ CXXNaiveCodeGen::generateStencilInstantiation(const StencilInstantiation* stenci
     for(auto field : StencilFields) {
       if(field.IsTemporary)
         continue;
-      initCtr += (i != 0 ? "," : "<") + (stencilInstantiation->isAllocatedField(field.AccessID)
-                                             ? (c_gtc().str() + "storage_t")
-                                             : (codeGenProperties.getParamType(field.Name)));
+      initCtr += (i != 0 ? "," : "<") +
+                 (stencilInstantiation->isAllocatedField(field.AccessID)
+                      ? getAllocatedStorageTypeName(*stencilInstantiation, field.AccessID)
+                      : (codeGenProperties.getParamType(field.Name)));
       i++;
     }
 
@@ -435,13 +544,7 @@ CXXNaiveCodeGen::generateStencilInstantiation(const StencilInstantiation* stenci
     StencilWrapperConstructor.addInit(initCtr);
   }
 
-  if(stencilInstantiation->hasAllocatedFields()) {
-    std::vector<std::string> tempFields;
-    for(auto accessID : stencilInstantiation->getAllocatedFieldAccessIDs()) {
-      tempFields.push_back(stencilInstantiation->getNameFromAccessID(accessID));
-    }
-    addTmpStorageInit_wrapper(StencilWrapperConstructor, stencils, tempFields);
-  }
+  addTmpStorageInit_wrapper(StencilWrapperConstructor, stencils, *stencilInstantiation);
 
   StencilWrapperConstructor.commit();
 
@@ -454,7 +557,7 @@ CXXNaiveCodeGen::generateStencilInstantiation(const StencilInstantiation* stenci
   ASTStencilDesc stencilDescCGVisitor(stencilInstantiation, codeGenProperties);
   stencilDescCGVisitor.setIndent(RunMethod.getIndent());
   for(const auto& statement : stencilInstantiation->getStencilDescStatements()) {
-    statement->ASTStmt->accept(stencilDescCGVisitor);
+    stencilDescCGVisitor.visit(statement->ASTStmt);
     RunMethod.addStatement(stencilDescCGVisitor.getCodeAndResetStream());
   }
 
@@ -511,9 +614,13 @@ std::string CXXNaiveCodeGen::generateGlobals(std::shared_ptr<SIR> const& sir) {
 
   GlobalsStruct.commit();
 
-  // Add the symbol for the singleton
-  codegen::Statement(ss) << "template<> " << StructName << "* " << BaseName
-                         << "::s_instance = nullptr";
+  // Add the symbol for the singleton (in split mode it is only declared here and defined in a
+  // separate source file)
+  if(context_->getOptions().SplitTranslationUnit)
+    codegen::Statement(ss) << "template<> " << StructName << "* " << BaseName << "::s_instance";
+  else
+    codegen::Statement(ss) << "template<> " << StructName << "* " << BaseName
+                           << "::s_instance = nullptr";
 
   cxxnaiveNamespace.commit();
 
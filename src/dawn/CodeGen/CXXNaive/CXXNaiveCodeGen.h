@@ -40,6 +40,12 @@ public:
   virtual ~CXXNaiveCodeGen();
   virtual std::unique_ptr<TranslationUnit> generateCode() override;
 
+protected:
+  virtual std::string getWrapperNamespace() const override { return "cxxnaive"; }
+  virtual std::string makeWrapperStorageArgType(const std::string& storageType) const override {
+    return storageType + "&";
+  }
+
 private:
   std::string generateStencilInstantiation(const StencilInstantiation* stencilInstantiation);
   std::string generateGlobals(const std::shared_ptr<SIR>& sir);
@@ -20,6 +20,7 @@
 #include "dawn/Support/Twine.h"
 #include <functional>
 #include <sstream>
+#include <vector>
 
 namespace dawn {
 
@@ -514,6 +515,48 @@ struct Structure : public Statement {
     return memFun;
   }
 
+  /// @brief Add a constructor with the arguments `args`
+  ///
+  /// If `outOfLineDefinition` is not null, the constructor is only declared in the structure and
+  /// the returned function is defined in `outOfLineDefinition` with its name qualified by `scope`.
+  ///
+  /// @b Signature:
+  /// @code
+  ///   template< templateName >
+  ///   Structure(args...);
+  ///
+  ///   template< templateName >
+  ///   scope::Structure::Structure(args...) {...}
+  /// @endcode
+  MemberFunction addConstructor(const Twine& templateName, const std::vector<std::string>& args,
+                                std::stringstream* outOfLineDefinition,
+                                const Twine& scope = Twine::createNull()) {
+    std::string templateDecl =
+        templateName.isTriviallyEmpty() ? "" : "template<" + templateName.str() + ">\n";
+    std::string name = StructureName;
+    int il = IndentLevel + 1;
+
+    newlineImpl();
+    if(outOfLineDefinition) {
+      if(!templateDecl.empty())
+        indentImpl(IndentLevel + 1) << templateDecl;
+      indentImpl(IndentLevel + 1) << StructureName << RangeToString(", ", "(", ");\n")(args);
+      name = StructureName + "::" + StructureName;
+      if(!scope.isTriviallyEmpty())
+        name = scope.str() + "::" + name;
+      il = 0;
+    }
+
+    std::stringstream& s = outOfLineDefinition ? *outOfLineDefinition : ss();
+    if(!templateDecl.empty())
+      internal::indent(il, s) << templateDecl;
+    MemberFunction memFun(Twine::createNull(), name, s, il);
+    memFun.CanHaveInit = true;
+    for(const auto& arg : args)
+      memFun.addArg(arg);
+    return memFun;
+  }
+
   /// @brief Add a destructor
   ///
   /// @b Signature:
@@ -1,8 +1,53 @@
 #include "dawn/CodeGen/CodeGen.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/Support/Assert.h"
+#include "dawn/Support/FileUtil.h"
+#include "dawn/Support/StringUtil.h"
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <sstream>
 
 namespace dawn {
 namespace codegen {
 
+namespace {
+
+/// @brief Suffix of the storage and meta data types of a field with the given dimensions (empty
+/// for three dimensional fields)
+std::string makeDimensionsSuffix(const Array3i& dimensions) {
+  if(dimensions == Array3i{{1, 1, 1}})
+    return "";
+  const char* dimNames[] = {"i", "j", "k"};
+  std::string suffix = "_";
+  for(int i = 0; i < 3; ++i)
+    if(dimensions[i])
+      suffix += dimNames[i];
+  return suffix;
+}
+
+/// @brief Distinct dimensions of the fields allocated by the stencil wrapper (in order of their
+/// first appearance)
+std::vector<Array3i> getAllocatedFieldDimensions(const StencilInstantiation& stencilInstantiation) {
+  std::vector<Array3i> dimensions;
+  for(int AccessID : stencilInstantiation.getAllocatedFieldAccessIDs()) {
+    Array3i dims = stencilInstantiation.getFieldDimensions(AccessID);
+    if(std::find(dimensions.begin(), dimensions.end(), dims) == dimensions.end())
+      dimensions.push_back(dims);
+  }
+  return dimensions;
+}
+
+std::string makeIncludeGuard(const std::string& filename) {
+  std::string guard = "DAWN_GENERATED_";
+  for(char c : filename)
+    guard += std::isalnum(c) ? std::toupper(c) : '_';
+  return guard;
+}
+
+} // anonymous namespace
+
 size_t CodeGen::getVerticalTmpHaloSize(Stencil const& stencil) {
   std::shared_ptr<Interval> tmpInterval = stencil.getEnclosingIntervalTemporaries();
   return (tmpInterval != nullptr) ? std::max(tmpInterval->overEnd(), tmpInterval->belowBegin()) : 0;
@@ -39,10 +84,19 @@ void CodeGen::addTempStorageTypedef(Structure& stencilClass, Stencil const& sten
 }
 
 void CodeGen::addTmpStorageDeclaration(
-    Structure& stencilClass,
+    Structure& stencilClass, const Stencil& stencil,
     IndexRange<const std::vector<dawn::Stencil::FieldInfo>>& tempFields) const {
   if(!(tempFields.empty())) {
-    stencilClass.addMember(tmpMetadataTypename_, tmpMetadataName_);
+    std::map<int, int> kWindows = getTemporaryKWindows(stencil);
+    std::set<int> windows;
+    for(const auto& AccessIDWindowPair : kWindows)
+      windows.insert(AccessIDWindowPair.second);
+
+    if(kWindows.size() != tempFields.size())
+      stencilClass.addMember(tmpMetadataTypename_, tmpMetadataName_);
+    for(int window : windows)
+      stencilClass.addMember(tmpMetadataTypename_,
+                             tmpMetadataName_ + "_k" + std::to_string(window));
 
     for(auto field : tempFields)
       stencilClass.addMember(tmpStorageTypename_, "m_" + (*field).Name);
@@ -53,25 +107,173 @@ void CodeGen::addTmpStorageInit(
     MemberFunction& ctr, Stencil const& stencil,
     IndexRange<const std::vector<dawn::Stencil::FieldInfo>>& tempFields) const {
   if(!(tempFields.empty())) {
-    ctr.addInit(tmpMetadataName_ + "(dom_.isize(), dom_.jsize(), dom_.ksize() + 2*" +
-                std::to_string(getVerticalTmpHaloSize(stencil)) + ")");
+    std::map<int, int> kWindows = getTemporaryKWindows(stencil);
+    std::set<int> windows;
+    for(const auto& AccessIDWindowPair : kWindows)
+      windows.insert(AccessIDWindowPair.second);
+
+    if(kWindows.size() != tempFields.size())
+      ctr.addInit(tmpMetadataName_ + "(dom_.isize(), dom_.jsize(), dom_.ksize() + 2*" +
+                  std::to_string(getVerticalTmpHaloSize(stencil)) + ")");
+    for(int window : windows)
+      ctr.addInit(tmpMetadataName_ + "_k" + std::to_string(window) +
+                  "(dom_.isize(), dom_.jsize(), " + std::to_string(window) + ")");
+
     for(auto fieldIt : tempFields) {
-      ctr.addInit("m_" + (*fieldIt).Name + "(" + tmpMetadataName_ + ")");
+      auto it = kWindows.find((*fieldIt).AccessID);
+      ctr.addInit("m_" + (*fieldIt).Name + "(" + tmpMetadataName_ +
+                  (it != kWindows.end() ? "_k" + std::to_string(it->second) : "") + ")");
     }
   }
 }
 
+std::stringstream* CodeGen::getWrapperConstructorDefinitionStream(const std::string& stencilName) {
+  if(!context_->getOptions().SplitTranslationUnit)
+    return nullptr;
+  return &clear(wrapperConstructorDefinitions_[stencilName]);
+}
+
+std::map<int, int> CodeGen::getTemporaryKWindows(const Stencil& stencil) {
+  std::map<int, int> kWindows;
+  for(const auto& multiStagePtr : stencil.getMultiStages())
+    for(const auto& AccessIDCachePair : multiStagePtr->getCaches())
+      if(AccessIDCachePair.second.getWindow())
+        kWindows.emplace(AccessIDCachePair.first, *AccessIDCachePair.second.getWindow());
+  return kWindows;
+}
+
+std::string CodeGen::getAllocatedStorageTypeName(const StencilInstantiation& stencilInstantiation,
+                                                 int AccessID) {
+  return c_gtc().str() + "storage" +
+         makeDimensionsSuffix(stencilInstantiation.getFieldDimensions(AccessID)) + "_t";
+}
+
+void CodeGen::addAllocatedStorageDeclaration(
+    Structure& wrapperClass, const StencilInstantiation& stencilInstantiation) const {
+  for(const Array3i& dimensions : getAllocatedFieldDimensions(stencilInstantiation)) {
+    std::string suffix = makeDimensionsSuffix(dimensions);
+    wrapperClass.addMember(c_gtc() + "meta_data" + suffix + "_t", bigWrapperMetadata_ + suffix);
+  }
+
+  for(int AccessID : stencilInstantiation.getAllocatedFieldAccessIDs())
+    wrapperClass.addMember(getAllocatedStorageTypeName(stencilInstantiation, AccessID),
+                           "m_" + stencilInstantiation.getNameFromAccessID(AccessID));
+}
+
 void CodeGen::addTmpStorageInit_wrapper(MemberFunction& ctr,
                                         const std::vector<std::shared_ptr<Stencil>>& stencils,
-                                        const std::vector<std::string>& tempFields) const {
-  if(!(tempFields.empty())) {
-    auto verticalExtent = getVerticalTmpHaloSizeForMultipleStencils(stencils);
-    ctr.addInit(bigWrapperMetadata_ + "(dom.isize(), dom.jsize(), dom.ksize() + 2*" +
-                std::to_string(verticalExtent) + ")");
-    for(auto fieldName : tempFields) {
-      ctr.addInit("m_" + fieldName + " (" + bigWrapperMetadata_ + ", \"" + fieldName + "\")");
-    }
+                                        const StencilInstantiation& stencilInstantiation) const {
+  if(!stencilInstantiation.hasAllocatedFields())
+    return;
+
+  auto verticalExtent = getVerticalTmpHaloSizeForMultipleStencils(stencils);
+  for(const Array3i& dimensions : getAllocatedFieldDimensions(stencilInstantiation)) {
+    // Dimensions in which the field does not extend have size one
+    ctr.addInit(bigWrapperMetadata_ + makeDimensionsSuffix(dimensions) + "(" +
+                (dimensions[0] ? "dom.isize()" : "1") + ", " +
+                (dimensions[1] ? "dom.jsize()" : "1") + ", " +
+                (dimensions[2] ? "dom.ksize() + 2*" + std::to_string(verticalExtent) : "1") +
+                ")");
+  }
+
+  for(int AccessID : stencilInstantiation.getAllocatedFieldAccessIDs()) {
+    const std::string& fieldName = stencilInstantiation.getNameFromAccessID(AccessID);
+    ctr.addInit("m_" + fieldName + " (" + bigWrapperMetadata_ +
+                makeDimensionsSuffix(stencilInstantiation.getFieldDimensions(AccessID)) + ", \"" +
+                fieldName + "\")");
+  }
+}
+
+void CodeGen::splitTranslationUnit(TranslationUnit& translationUnit) const {
+  std::string baseName = getFilenameWithoutExtension(translationUnit.getFilename()).str();
+  if(baseName.empty())
+    baseName = "dawn_generated";
+
+  const std::string headerName = baseName + ".hpp";
+  const std::string wrapperNamespace = getWrapperNamespace();
+  std::map<std::string, std::string> files;
+  std::vector<std::string> sources;
+
+  // Shared header: preprocessor defines, the DSL header and the globals struct
+  std::stringstream ss;
+  ss << "#ifndef " << makeIncludeGuard(headerName) << "\n";
+  ss << "#define " << makeIncludeGuard(headerName) << "\n\n";
+  for(const auto& define : translationUnit.getPPDefines())
+    ss << define << "\n";
+  ss << "\n#include \"gridtools/clang_dsl.hpp\"\n\n";
+  ss << translationUnit.getGlobals() << "\n";
+  ss << "#endif\n";
+  files.emplace(headerName, ss.str());
+
+  // The singleton of the globals is only declared in the shared header and defined once here
+  if(!translationUnit.getGlobals().empty()) {
+    const std::string sourceName = baseName + "_globals.cpp";
+    clear(ss);
+    ss << "#include \"" << headerName << "\"\n\n";
+    ss << "namespace " << wrapperNamespace << " {\n";
+    ss << "template<> globals* " << c_gtc().str()
+       << "globals_impl<globals>::s_instance = nullptr;\n";
+    ss << "} // namespace " << wrapperNamespace << "\n";
+    files.emplace(sourceName, ss.str());
+    sources.push_back(sourceName);
   }
+
+  for(const auto& stencilNameCodePair : translationUnit.getStencils()) {
+    const std::string& stencilName = stencilNameCodePair.first;
+    const std::string stencilHeaderName = baseName + "_" + stencilName + ".hpp";
+    const std::string stencilSourceName = baseName + "_" + stencilName + ".cpp";
+
+    auto stencilInstantiationIt = context_->getStencilInstantiationMap().find(stencilName);
+    DAWN_ASSERT_MSG(stencilInstantiationIt != context_->getStencilInstantiationMap().end(),
+                    "generated stencil has no stencil instantiation");
+
+    auto ctrDefinitionIt = wrapperConstructorDefinitions_.find(stencilName);
+    DAWN_ASSERT_MSG(ctrDefinitionIt != wrapperConstructorDefinitions_.end(),
+                    "stencil wrapper constructor was not generated out of line");
+
+    // Signature of the stencil wrapper constructor instantiated with the storage types of the
+    // fields
+    const StencilInstantiation& stencilInstantiation = *stencilInstantiationIt->second;
+    std::vector<std::string> ctrArgs{"const " + c_gtc().str() + "domain&"};
+    for(const auto& field : stencilInstantiation.getSIRStencil()->Fields)
+      if(!field->IsTemporary)
+        ctrArgs.push_back(makeWrapperStorageArgType(getAllocatedStorageTypeName(
+            stencilInstantiation, stencilInstantiation.getAccessIDFromName(field->Name))));
+
+    const std::string ctr = wrapperNamespace + "::" + stencilName + "::" + stencilName +
+                            RangeToString(", ", "(", ")")(ctrArgs);
+
+    clear(ss);
+    ss << "#ifndef " << makeIncludeGuard(stencilHeaderName) << "\n";
+    ss << "#define " << makeIncludeGuard(stencilHeaderName) << "\n\n";
+    ss << "#include \"" << headerName << "\"\n\n";
+    ss << stencilNameCodePair.second << "\n";
+    ss << "#endif\n";
+    files.emplace(stencilHeaderName, ss.str());
+
+    clear(ss);
+    ss << "#include \"" << stencilHeaderName << "\"\n\n";
+    ss << ctrDefinitionIt->second.str() << "\n";
+    ss << "template " << ctr << ";\n";
+    files.emplace(stencilSourceName, ss.str());
+    sources.push_back(stencilSourceName);
+  }
+
+  // CMake fragment which compiles each stencil in its own translation unit
+  clear(ss);
+  ss << "# Generated by dawn from '" << translationUnit.getFilename() << "'\n";
+  ss << "set(" << baseName << "_sources\n";
+  for(const auto& source : sources)
+    ss << "  \"${CMAKE_CURRENT_LIST_DIR}/" << source << "\"\n";
+  ss << ")\n";
+  if(!sources.empty()) {
+    ss << "add_library(" << baseName << "_stencils OBJECT ${" << baseName << "_sources})\n";
+    ss << "target_include_directories(" << baseName
+       << "_stencils PUBLIC \"${CMAKE_CURRENT_LIST_DIR}\")\n";
+  }
+  files.emplace(baseName + ".cmake", ss.str());
+
+  translationUnit.setFiles(std::move(files));
 }
 
 } // namespace codegen
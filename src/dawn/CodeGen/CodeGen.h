@@ -19,6 +19,7 @@
 #include "dawn/CodeGen/TranslationUnit.h"
 #include "dawn/Optimizer/OptimizerContext.h"
 #include "dawn/Support/IndexRange.h"
+#include <map>
 #include <memory>
 
 namespace dawn {
@@ -35,13 +36,44 @@ protected:
       const std::vector<std::shared_ptr<Stencil>>& stencils) const;
   void addTempStorageTypedef(Structure& stencilClass, Stencil const& stencil) const;
   void addTmpStorageDeclaration(
-      Structure& stencilClass,
+      Structure& stencilClass, const Stencil& stencil,
       IndexRange<const std::vector<dawn::Stencil::FieldInfo>>& tmpFields) const;
   void addTmpStorageInit(MemberFunction& ctr, const Stencil& stencil,
                          IndexRange<const std::vector<dawn::Stencil::FieldInfo>>& tempFields) const;
+
+  /// @brief Number of vertical levels of the temporaries of `stencil` which are stored in ring
+  /// buffers (temporaries with a K-cache window), keyed by AccessID
+  static std::map<int, int> getTemporaryKWindows(const Stencil& stencil);
+
+  /// @brief Declare the meta data and storages of the fields allocated by the stencil wrapper
+  void addAllocatedStorageDeclaration(Structure& wrapperClass,
+                                      const StencilInstantiation& stencilInstantiation) const;
+
+  /// @brief Initialize the meta data and storages of the fields allocated by the stencil wrapper
   void addTmpStorageInit_wrapper(MemberFunction& ctr,
                                  const std::vector<std::shared_ptr<Stencil>>& stencils,
-                                 const std::vector<std::string>& tempFields) const;
+                                 const StencilInstantiation& stencilInstantiation) const;
+
+  /// @brief Storage type of the field `AccessID` allocated by the stencil wrapper (fields which do
+  /// not extend in all three dimensions, e.g 2D temporaries, use the matching storage type)
+  static std::string getAllocatedStorageTypeName(const StencilInstantiation& stencilInstantiation,
+                                                 int AccessID);
+
+  /// @brief Namespace in which the stencil wrapper classes are generated
+  virtual std::string getWrapperNamespace() const = 0;
+
+  /// @brief Type of the constructor argument of a stencil wrapper which binds a storage of type
+  /// `storageType` (storages are passed by value by default)
+  virtual std::string makeWrapperStorageArgType(const std::string& storageType) const {
+    return storageType;
+  }
+
+  /// @brief Stream receiving the out of line definition of the constructor of the stencil wrapper
+  /// `stencilName` or null if the constructor is defined inline (see `splitTranslationUnit`)
+  std::stringstream* getWrapperConstructorDefinitionStream(const std::string& stencilName);
+
+  /// @brief Out of line definitions of the stencil wrapper constructors mapped by stencil name
+  std::map<std::string, std::stringstream> wrapperConstructorDefinitions_;
 
   const std::string tmpStorageTypename_ = "tmp_storage_t";
   const std::string tmpMetadataTypename_ = "tmp_meta_data_t";
@@ -56,6 +88,16 @@ public:
   /// @brief Generate code
   virtual std::unique_ptr<TranslationUnit> generateCode() = 0;
 
+  /// @brief Split the generated code into a shared header (preprocessor defines and globals), a
+  /// header/source pair per stencil wrapper and a CMake fragment listing the sources
+  ///
+  /// The header of each stencil wrapper only declares the wrapper constructor, which is defined and
+  /// explicitly instantiated for the `gridtools::clang` storage types of the fields in the source
+  /// file, hence the expensive template instantiations happen exactly once and the stencils can be
+  /// compiled in parallel. The files are stored in `translationUnit` (see
+  /// `TranslationUnit::getFiles`).
+  void splitTranslationUnit(TranslationUnit& translationUnit) const;
+
   /// @brief Get the optimizer context
   const OptimizerContext* getOptimizerContext() const { return context_; }
 };
@@ -56,15 +56,17 @@ int ASTStencilBody::getAccessID(const std::shared_ptr<Expr>& expr) const {
 //     Stmt
 //===------------------------------------------------------------------------------------------===//
 
-void ASTStencilBody::visit(const std::shared_ptr<BlockStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilBody::visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitBlockStmt(stmt, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<ExprStmt>& stmt) {
-  if(isa<StencilFunCallExpr>(*(stmt->getExpr())))
+void ASTStencilBody::visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  if(isa<StencilFunCallExpr>(*(stmt.getExpr())))
     triggerCallProc_ = true;
-  Base::visit(stmt);
+  Base::visitExprStmt(stmt, node);
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<ReturnStmt>& stmt) {
+void ASTStencilBody::visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) {
   if(scopeDepth_ == 0)
     ss_ << std::string(indent_, ' ');
 
@@ -75,47 +77,70 @@ void ASTStencilBody::visit(const std::shared_ptr<ReturnStmt>& stmt) {
   else
     ss_ << "return ";
 
-  stmt->getExpr()->accept(*this);
+  visit(stmt.getExpr());
   ss_ << ";\n";
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<VarDeclStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilBody::visitVarDeclStmt(const VarDeclStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitVarDeclStmt(stmt, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) {
+void ASTStencilBody::visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                                 const std::shared_ptr<Stmt>& node) {
   dawn_unreachable("VerticalRegionDeclStmt not allowed in this context");
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) {
+void ASTStencilBody::visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                              const std::shared_ptr<Stmt>& node) {
   dawn_unreachable("StencilCallDeclStmt not allowed in this context");
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) {
+void ASTStencilBody::visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                                    const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT_MSG(0, "BoundaryConditionDeclStmt not allowed in this context");
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<IfStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilBody::visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitIfStmt(stmt, node);
+}
 
 //===------------------------------------------------------------------------------------------===//
 //     Expr
 //===------------------------------------------------------------------------------------------===//
 
-void ASTStencilBody::visit(const std::shared_ptr<UnaryOperator>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitUnaryOperator(const UnaryOperator& expr,
+                                        const std::shared_ptr<Expr>& node) {
+  Base::visitUnaryOperator(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<BinaryOperator>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitBinaryOperator(const BinaryOperator& expr,
+                                         const std::shared_ptr<Expr>& node) {
+  Base::visitBinaryOperator(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<AssignmentExpr>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitAssignmentExpr(const AssignmentExpr& expr,
+                                         const std::shared_ptr<Expr>& node) {
+  Base::visitAssignmentExpr(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<TernaryOperator>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitTernaryOperator(const TernaryOperator& expr,
+                                          const std::shared_ptr<Expr>& node) {
+  Base::visitTernaryOperator(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<FunCallExpr>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitFunCallExpr(const FunCallExpr& expr, const std::shared_ptr<Expr>& node) {
+  Base::visitFunCallExpr(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
+void ASTStencilBody::visitStencilFunCallExpr(const StencilFunCallExpr& expr,
+                                             const std::shared_ptr<Expr>& node) {
   if(nestingOfStencilFunArgLists_++)
     ss_ << ", ";
 
+  auto callExpr = std::static_pointer_cast<StencilFunCallExpr>(node);
   const std::shared_ptr<StencilFunctionInstantiation> stencilFun =
-      currentFunction_ ? currentFunction_->getStencilFunctionInstantiation(expr)
-                       : instantiation_->getStencilFunctionInstantiation(expr);
+      currentFunction_ ? currentFunction_->getStencilFunctionInstantiation(callExpr)
+                       : instantiation_->getStencilFunctionInstantiation(callExpr);
 
   ss_ << (triggerCallProc_ ? "gridtools::call_proc<" : "gridtools::call<")
       << StencilFunctionInstantiation::makeCodeGenName(*stencilFun) << ", "
@@ -123,13 +148,13 @@ void ASTStencilBody::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
 
   triggerCallProc_ = false;
 
-  for(auto& arg : expr->getArguments()) {
-    arg->accept(*this);
+  for(auto& arg : expr.getArguments()) {
+    visit(arg);
   }
 
   // we record in a set all global variables passed to the stencil call
   std::set<int> globalVariablesInCallStmt;
-  for(auto& arg : expr->getArguments()) {
+  for(auto& arg : expr.getArguments()) {
     if(!isa<FieldAccessExpr>(*arg))
       continue;
     int accessID = currentFunction_ ? currentFunction_->getAccessIDFromExpr(arg)
@@ -150,11 +175,13 @@ void ASTStencilBody::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
   ss_ << ")";
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<StencilFunArgExpr>& expr) {}
+void ASTStencilBody::visitStencilFunArgExpr(const StencilFunArgExpr& expr,
+                                            const std::shared_ptr<Expr>& node) {}
 
-void ASTStencilBody::visit(const std::shared_ptr<VarAccessExpr>& expr) {
-  std::string name = getName(expr);
-  int AccessID = getAccessID(expr);
+void ASTStencilBody::visitVarAccessExpr(const VarAccessExpr& expr,
+                                        const std::shared_ptr<Expr>& node) {
+  std::string name = getName(node);
+  int AccessID = getAccessID(node);
 
   if(instantiation_->isGlobalVariable(AccessID)) {
     if(!nestingOfStencilFunArgLists_)
@@ -170,17 +197,21 @@ void ASTStencilBody::visit(const std::shared_ptr<VarAccessExpr>& expr) {
   } else {
     ss_ << name;
 
-    if(expr->isArrayAccess()) {
+    if(expr.isArrayAccess()) {
       ss_ << "[";
-      expr->getIndex()->accept(*this);
+      visit(expr.getIndex());
       ss_ << "]";
     }
   }
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<LiteralAccessExpr>& expr) { Base::visit(expr); }
+void ASTStencilBody::visitLiteralAccessExpr(const LiteralAccessExpr& expr,
+                                            const std::shared_ptr<Expr>& node) {
+  Base::visitLiteralAccessExpr(expr, node);
+}
 
-void ASTStencilBody::visit(const std::shared_ptr<FieldAccessExpr>& expr) {
+void ASTStencilBody::visitFieldAccessExpr(const FieldAccessExpr& expr,
+                                          const std::shared_ptr<Expr>& node) {
   if(!nestingOfStencilFunArgLists_)
     ss_ << "eval(";
   else
@@ -188,10 +219,10 @@ void ASTStencilBody::visit(const std::shared_ptr<FieldAccessExpr>& expr) {
 
   if(currentFunction_) {
     ss_ << currentFunction_->getOriginalNameFromCallerAccessID(
-               currentFunction_->getAccessIDFromExpr(expr))
-        << offsetPrinter_(currentFunction_->evalOffsetOfFieldAccessExpr(expr, false));
+               currentFunction_->getAccessIDFromExpr(node))
+        << offsetPrinter_(currentFunction_->evalOffsetOfFieldAccessExpr(expr, node, false));
   } else
-    ss_ << getName(expr) << offsetPrinter_(expr->getOffset());
+    ss_ << getName(node) << offsetPrinter_(expr.getOffset());
 
   if(!nestingOfStencilFunArgLists_)
     ss_ << ")";
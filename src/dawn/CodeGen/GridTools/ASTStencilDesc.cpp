@@ -42,37 +42,48 @@ std::string ASTStencilDesc::getName(const std::shared_ptr<Expr>& expr) const {
 //     Stmt
 //===------------------------------------------------------------------------------------------===//
 
-void ASTStencilDesc::visit(const std::shared_ptr<BlockStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilDesc::visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitBlockStmt(stmt, node);
+}
 
-void ASTStencilDesc::visit(const std::shared_ptr<ExprStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilDesc::visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitExprStmt(stmt, node);
+}
 
-void ASTStencilDesc::visit(const std::shared_ptr<ReturnStmt>& stmt) {
+void ASTStencilDesc::visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) {
   dawn_unreachable("ReturnStmt not allowed in StencilDesc AST");
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<VarDeclStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilDesc::visitVarDeclStmt(const VarDeclStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitVarDeclStmt(stmt, node);
+}
 
-void ASTStencilDesc::visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) {
+void ASTStencilDesc::visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                                 const std::shared_ptr<Stmt>& node) {
   dawn_unreachable("VerticalRegionDeclStmt not allowed in StencilDesc AST");
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) {
-  int StencilID = instantiation_->getStencilCallToStencilIDMap().find(stmt)->second;
+void ASTStencilDesc::visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                              const std::shared_ptr<Stmt>& node) {
+  auto stencilCall = std::static_pointer_cast<StencilCallDeclStmt>(node);
+  int StencilID = instantiation_->getStencilCallToStencilIDMap().find(stencilCall)->second;
 
   for(const std::string& stencilName : StencilIDToStencilNameMap_.find(StencilID)->second) {
     ss_ << std::string(indent_, ' ') << stencilName << ".get_stencil()->run();\n";
   }
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) {
-  Extents extents = instantiation_->getBoundaryConditionExtentsFromBCStmt(stmt);
+void ASTStencilDesc::visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                                    const std::shared_ptr<Stmt>& node) {
+  Extents extents = instantiation_->getBoundaryConditionExtentsFromBCStmt(
+      std::static_pointer_cast<BoundaryConditionDeclStmt>(node));
   int haloIMinus = abs(extents[0].Minus);
   int haloIPlus = abs(extents[0].Plus);
   int haloJMinus = abs(extents[1].Minus);
   int haloJPlus = abs(extents[1].Plus);
   int haloKMinus = abs(extents[2].Minus);
   int haloKPlus = abs(extents[2].Plus);
-  std::string fieldname = stmt->getFields()[0]->Name;
+  std::string fieldname = stmt.getFields()[0]->Name;
 
   // Set up the halos
   std::string halosetup = dawn::format(
@@ -91,16 +102,16 @@ void ASTStencilDesc::visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stm
   std::string makeView = "";
 
   // Create the views for the fields
-  for(int i = 0; i < stmt->getFields().size(); ++i) {
-    auto fieldName = stmt->getFields()[i]->Name;
+  for(int i = 0; i < stmt.getFields().size(); ++i) {
+    auto fieldName = stmt.getFields()[i]->Name;
     makeView +=
         dawn::format("auto %s_view = GT_BACKEND_DECISION_viewmaker(%s);\n", fieldName, fieldName);
   }
-  std::string bcapply = "GT_BACKEND_DECISION_bcapply<" + stmt->getFunctor() + " >(halos, " +
-                        stmt->getFunctor() + "()).apply(";
-  for(int i = 0; i < stmt->getFields().size(); ++i) {
-    bcapply += stmt->getFields()[i]->Name + "_view";
-    if(i < stmt->getFields().size() - 1) {
+  std::string bcapply = "GT_BACKEND_DECISION_bcapply<" + stmt.getFunctor() + " >(halos, " +
+                        stmt.getFunctor() + "()).apply(";
+  for(int i = 0; i < stmt.getFields().size(); ++i) {
+    bcapply += stmt.getFields()[i]->Name + "_view";
+    if(i < stmt.getFields().size() - 1) {
       bcapply += ", ";
     }
   }
@@ -111,46 +122,69 @@ void ASTStencilDesc::visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stm
   ss_ << bcapply;
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<IfStmt>& stmt) { Base::visit(stmt); }
+void ASTStencilDesc::visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node) {
+  Base::visitIfStmt(stmt, node);
+}
 
 //===------------------------------------------------------------------------------------------===//
 //     Expr
 //===------------------------------------------------------------------------------------------===//
 
-void ASTStencilDesc::visit(const std::shared_ptr<UnaryOperator>& expr) { Base::visit(expr); }
+void ASTStencilDesc::visitUnaryOperator(const UnaryOperator& expr,
+                                        const std::shared_ptr<Expr>& node) {
+  Base::visitUnaryOperator(expr, node);
+}
 
-void ASTStencilDesc::visit(const std::shared_ptr<BinaryOperator>& expr) { Base::visit(expr); }
+void ASTStencilDesc::visitBinaryOperator(const BinaryOperator& expr,
+                                         const std::shared_ptr<Expr>& node) {
+  Base::visitBinaryOperator(expr, node);
+}
 
-void ASTStencilDesc::visit(const std::shared_ptr<AssignmentExpr>& expr) { Base::visit(expr); }
+void ASTStencilDesc::visitAssignmentExpr(const AssignmentExpr& expr,
+                                         const std::shared_ptr<Expr>& node) {
+  Base::visitAssignmentExpr(expr, node);
+}
 
-void ASTStencilDesc::visit(const std::shared_ptr<TernaryOperator>& expr) { Base::visit(expr); }
+void ASTStencilDesc::visitTernaryOperator(const TernaryOperator& expr,
+                                          const std::shared_ptr<Expr>& node) {
+  Base::visitTernaryOperator(expr, node);
+}
 
-void ASTStencilDesc::visit(const std::shared_ptr<FunCallExpr>& expr) { Base::visit(expr); }
+void ASTStencilDesc::visitFunCallExpr(const FunCallExpr& expr, const std::shared_ptr<Expr>& node) {
+  Base::visitFunCallExpr(expr, node);
+}
 
-void ASTStencilDesc::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
+void ASTStencilDesc::visitStencilFunCallExpr(const StencilFunCallExpr& expr,
+                                             const std::shared_ptr<Expr>& node) {
   dawn_unreachable("StencilFunCallExpr not allowed in StencilDesc AST");
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<StencilFunArgExpr>& expr) {
+void ASTStencilDesc::visitStencilFunArgExpr(const StencilFunArgExpr& expr,
+                                            const std::shared_ptr<Expr>& node) {
   dawn_unreachable("StencilFunArgExpr not allowed in StencilDesc AST");
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<VarAccessExpr>& expr) {
-  if(instantiation_->isGlobalVariable(instantiation_->getAccessIDFromExpr(expr)))
+void ASTStencilDesc::visitVarAccessExpr(const VarAccessExpr& expr,
+                                        const std::shared_ptr<Expr>& node) {
+  if(instantiation_->isGlobalVariable(instantiation_->getAccessIDFromExpr(node)))
     ss_ << "globals::get().";
 
-  ss_ << getName(expr);
+  ss_ << getName(node);
 
-  if(expr->isArrayAccess()) {
+  if(expr.isArrayAccess()) {
     ss_ << "[";
-    expr->getIndex()->accept(*this);
+    visit(expr.getIndex());
     ss_ << "]";
   }
 }
 
-void ASTStencilDesc::visit(const std::shared_ptr<LiteralAccessExpr>& expr) { Base::visit(expr); }
+void ASTStencilDesc::visitLiteralAccessExpr(const LiteralAccessExpr& expr,
+                                            const std::shared_ptr<Expr>& node) {
+  Base::visitLiteralAccessExpr(expr, node);
+}
 
-void ASTStencilDesc::visit(const std::shared_ptr<FieldAccessExpr>& expr) {
+void ASTStencilDesc::visitFieldAccessExpr(const FieldAccessExpr& expr,
+                                          const std::shared_ptr<Expr>& node) {
   dawn_unreachable("FieldAccessExpr not allowed in StencilDesc AST");
 }
 
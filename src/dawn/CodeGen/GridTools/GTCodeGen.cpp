@@ -25,6 +25,8 @@
 #include "dawn/Support/Logging.h"
 #include "dawn/Support/StringUtil.h"
 #include <boost/optional.hpp>
+#include <map>
+#include <set>
 #include <unordered_map>
 
 namespace dawn {
@@ -118,7 +120,7 @@ public:
                                const std::shared_ptr<sir::StencilFunction>& functionToAnalyze)
       : function(functionToAnalyze), instantiation_(stencilInstantiation) {}
 
-  void visit(const std::shared_ptr<FieldAccessExpr>& expr) {
+  void visitFieldAccessExpr(const FieldAccessExpr& expr, const std::shared_ptr<Expr>& node) {
     auto printOffset = [](const Array3i& argumentoffsets) {
       std::string retval = "";
       std::array<std::string, 3> dims{"i", "j", "k"};
@@ -129,7 +131,7 @@ public:
       }
       return retval;
     };
-    expr->getName();
+    expr.getName();
     auto getArgumentIndex = [&](const std::string& name) {
       size_t pos =
           std::distance(function->Args.begin(),
@@ -141,38 +143,41 @@ public:
       DAWN_ASSERT_MSG(pos < function->Args.size(), "");
       return pos;
     };
-    ss_ << dawn::format("data_field_%i(%s)", getArgumentIndex(expr->getName()),
-                        printOffset(expr->getOffset()));
+    ss_ << dawn::format("data_field_%i(%s)", getArgumentIndex(expr.getName()),
+                        printOffset(expr.getOffset()));
   }
-  void visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) {
+  void visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                   const std::shared_ptr<Stmt>& node) {
     DAWN_ASSERT_MSG(0, "VerticalRegionDeclStmt not allowed in this context");
   }
-  void visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) {
+  void visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                const std::shared_ptr<Stmt>& node) {
     DAWN_ASSERT_MSG(0, "StencilCallDeclStmt not allowed in this context");
   }
-  void visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) {
+  void visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                      const std::shared_ptr<Stmt>& node) {
     DAWN_ASSERT_MSG(0, "BoundaryConditionDeclStmt not allowed in this context");
   }
-  void visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
+  void visitStencilFunCallExpr(const StencilFunCallExpr& expr, const std::shared_ptr<Expr>& node) {
     DAWN_ASSERT_MSG(0, "StencilFunCallExpr not allowed in this context");
   }
-  void visit(const std::shared_ptr<StencilFunArgExpr>& expr) {
+  void visitStencilFunArgExpr(const StencilFunArgExpr& expr, const std::shared_ptr<Expr>& node) {
     DAWN_ASSERT_MSG(0, "StencilFunArgExpr not allowed in this context");
   }
 
-  void visit(const std::shared_ptr<ReturnStmt>& stmt) {
+  void visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) {
     DAWN_ASSERT_MSG(0, "ReturnStmt not allowed in this context");
   }
 
-  void visit(const std::shared_ptr<VarAccessExpr>& expr) {
-    if(instantiation_->isGlobalVariable(instantiation_->getAccessIDFromExpr(expr)))
+  void visitVarAccessExpr(const VarAccessExpr& expr, const std::shared_ptr<Expr>& node) {
+    if(instantiation_->isGlobalVariable(instantiation_->getAccessIDFromExpr(node)))
       ss_ << "globals::get().";
 
-    ss_ << getName(expr);
+    ss_ << getName(node);
 
-    if(expr->isArrayAccess()) {
+    if(expr.isArrayAccess()) {
       ss_ << "[";
-      expr->getIndex()->accept(*this);
+      visit(expr.getIndex());
       ss_ << "]";
     }
   }
@@ -203,32 +208,34 @@ GTCodeGen::generateStencilInstantiation(const StencilInstantiation* stencilInsta
 
   bool isEmpty = true;
   // Functions for boundary conditions
-  for(auto usedBoundaryCondition : stencilInstantiation->getBoundaryConditions()) {
-    for(const auto& sf : stencilInstantiation->getSIR()->StencilFunctions) {
-      if(sf->Name == usedBoundaryCondition.second->getFunctor()) {
-
-        Structure BoundaryCondition = StencilWrapperClass.addStruct(Twine(sf->Name));
-        std::string templatefunctions = "typename Direction ";
-        std::string functionargs = "Direction ";
-
-        // A templated datafield for every function argument
-        for(int i = 0; i < usedBoundaryCondition.second->getFields().size(); i++) {
-          templatefunctions += dawn::format(",typename DataField_%i", i);
-          functionargs += dawn::format(", DataField_%i &data_field_%i", i, i);
-        }
-        functionargs += ", int i , int j, int k";
-        auto BC = BoundaryCondition.addMemberFunction(
-            Twine("GT_FUNCTION void"), Twine("operator()"), Twine(templatefunctions));
-        BC.isConst(true);
-        BC.addArg(functionargs);
-        BC.startBody();
-        StencilFunctionAsBCGenerator reader(stencilInstantiation, sf);
-        sf->Asts[0]->accept(reader);
-        std::string output = reader.getCodeAndResetStream();
-        BC << output;
-        BC.commit();
-        break;
+  // (sorted by field name, i.e independently of the order the optimizer registered them in)
+  std::map<std::string, std::shared_ptr<BoundaryConditionDeclStmt>> boundaryConditions(
+      stencilInstantiation->getBoundaryConditions().begin(),
+      stencilInstantiation->getBoundaryConditions().end());
+  for(auto usedBoundaryCondition : boundaryConditions) {
+    auto sf = stencilInstantiation->getSIR()->getStencilFunction(
+        usedBoundaryCondition.second->getFunctor());
+    if(sf) {
+      Structure BoundaryCondition = StencilWrapperClass.addStruct(Twine(sf->Name));
+      std::string templatefunctions = "typename Direction ";
+      std::string functionargs = "Direction ";
+
+      // A templated datafield for every function argument
+      for(int i = 0; i < usedBoundaryCondition.second->getFields().size(); i++) {
+        templatefunctions += dawn::format(",typename DataField_%i", i);
+        functionargs += dawn::format(", DataField_%i &data_field_%i", i, i);
       }
+      functionargs += ", int i , int j, int k";
+      auto BC = BoundaryCondition.addMemberFunction(
+          Twine("GT_FUNCTION void"), Twine("operator()"), Twine(templatefunctions));
+      BC.isConst(true);
+      BC.addArg(functionargs);
+      BC.startBody();
+      StencilFunctionAsBCGenerator reader(stencilInstantiation, sf);
+      reader.visit(*sf->Asts[0]);
+      std::string output = reader.getCodeAndResetStream();
+      BC << output;
+      BC.commit();
     }
   }
 
@@ -373,7 +380,7 @@ GTCodeGen::generateStencilInstantiation(const StencilInstantiation* stencilInsta
         stencilBodyCGVisitor.setCurrentStencilFunction(stencilFun);
         stencilBodyCGVisitor.setIndent(DoMethod.getIndent());
         for(const auto& statementAccessesPair : stencilFun->getStatementAccessesPairs()) {
-          statementAccessesPair->getStatement()->ASTStmt->accept(stencilBodyCGVisitor);
+          stencilBodyCGVisitor.visit(statementAccessesPair->getStatement()->ASTStmt);
           DoMethod.indentStatment();
           DoMethod << stencilBodyCGVisitor.getCodeAndResetStream();
         }
@@ -405,10 +412,11 @@ GTCodeGen::generateStencilInstantiation(const StencilInstantiation* stencilInsta
         ssMS << multiStage.getLoopOrder();
       ssMS << ">(),";
 
-      // Add the MultiStage caches
+      // Add the MultiStage caches (sorted by AccessID)
       if(!multiStage.getCaches().empty()) {
+        std::map<int, Cache> caches(multiStage.getCaches().begin(), multiStage.getCaches().end());
         ssMS << RangeToString(", ", "gridtools::define_caches(", "),")(
-            multiStage.getCaches(),
+            caches,
             [&](const std::pair<int, Cache>& AccessIDCachePair) -> std::string {
               auto const& cache = AccessIDCachePair.second;
               DAWN_ASSERT(cache.getInterval().is_initialized() ||
@@ -517,7 +525,7 @@ GTCodeGen::generateStencilInstantiation(const StencilInstantiation* stencilInsta
 
           stencilBodyCGVisitor.setIndent(DoMethodCodeGen.getIndent());
           for(const auto& statementAccessesPair : doMethod.getStatementAccessesPairs()) {
-            statementAccessesPair->getStatement()->ASTStmt->accept(stencilBodyCGVisitor);
+            stencilBodyCGVisitor.visit(statementAccessesPair->getStatement()->ASTStmt);
             DoMethodCodeGen << stencilBodyCGVisitor.getCodeAndResetStream();
           }
         }
@@ -675,7 +683,7 @@ GTCodeGen::generateStencilInstantiation(const StencilInstantiation* stencilInsta
   StencilWrapperClass.addComment("Fields that require Boundary Conditions");
   // add all fields that require a boundary condition as members since they need to be called from
   // this class and not from individual stencils
-  std::unordered_set<std::string> memberfields;
+  std::set<std::string> memberfields;
   for(auto usedBoundaryCondition : stencilInstantiation->getBoundaryConditions()) {
     for(const auto& field : usedBoundaryCondition.second->getFields()) {
       memberfields.emplace(field->Name);
@@ -687,13 +695,7 @@ GTCodeGen::generateStencilInstantiation(const StencilInstantiation* stencilInsta
 
   StencilWrapperClass.addComment("Stencil-Data");
   // Define allocated memebers if necessary
-  if(stencilInstantiation->hasAllocatedFields()) {
-    StencilWrapperClass.addMember(c_gtc() + "meta_data_t", "m_meta_data");
-
-    for(int AccessID : stencilInstantiation->getAllocatedFieldAccessIDs())
-      StencilWrapperClass.addMember(c_gtc() + "storage_t",
-                                    "m_" + stencilInstantiation->getNameFromAccessID(AccessID));
-  }
+  addAllocatedStorageDeclaration(StencilWrapperClass, *stencilInstantiation);
 
   // Stencil members
   std::vector<std::string> stencilMembers;
@@ -720,22 +722,20 @@ GTCodeGen::generateStencilInstantiation(const StencilInstantiation* stencilInsta
   for(int i = 0; i < SIRFieldsWithoutTemps.size(); ++i)
     StencilWrapperConstructorTemplates.push_back("S" + std::to_string(i + 1));
 
-  auto StencilWrapperConstructor = StencilWrapperClass.addConstructor(RangeToString(", ", "", "")(
-      StencilWrapperConstructorTemplates, [](const std::string& str) { return "class " + str; }));
-
-  StencilWrapperConstructor.addArg("const " + c_gtc() + "domain& dom");
+  std::vector<std::string> StencilWrapperConstructorArgs{"const " + c_gtc().str() + "domain& dom"};
   for(int i = 0; i < SIRFieldsWithoutTemps.size(); ++i)
-    StencilWrapperConstructor.addArg(StencilWrapperConstructorTemplates[i] + " " +
-                                     SIRFieldsWithoutTemps[i]->Name);
+    StencilWrapperConstructorArgs.push_back(StencilWrapperConstructorTemplates[i] + " " +
+                                            SIRFieldsWithoutTemps[i]->Name);
+
+  auto StencilWrapperConstructor = StencilWrapperClass.addConstructor(
+      RangeToString(", ", "", "")(StencilWrapperConstructorTemplates,
+                                  [](const std::string& str) { return "class " + str; }),
+      StencilWrapperConstructorArgs,
+      getWrapperConstructorDefinitionStream(stencilInstantiation->getName()),
+      getWrapperNamespace());
 
   // Initialize allocated fields
-  if(stencilInstantiation->hasAllocatedFields()) {
-    std::vector<std::string> tempFields;
-    for(auto accessID : stencilInstantiation->getAllocatedFieldAccessIDs()) {
-      tempFields.push_back(stencilInstantiation->getNameFromAccessID(accessID));
-    }
-    addTmpStorageInit_wrapper(StencilWrapperConstructor, stencils, tempFields);
-  }
+  addTmpStorageInit_wrapper(StencilWrapperConstructor, stencils, *stencilInstantiation);
   // Initialize storages that require boundary conditions
   for(const auto& memberfield : memberfields) {
     StencilWrapperConstructor.addInit(memberfield + "(" + memberfield + ")");
@@ -781,7 +781,7 @@ GTCodeGen::generateStencilInstantiation(const StencilInstantiation* stencilInsta
   ASTStencilDesc stencilDescCGVisitor(stencilInstantiation, stencilIDToStencilNameMap);
   stencilDescCGVisitor.setIndent(RunMethod.getIndent());
   for(const auto& statement : stencilInstantiation->getStencilDescStatements()) {
-    statement->ASTStmt->accept(stencilDescCGVisitor);
+    stencilDescCGVisitor.visit(statement->ASTStmt);
     RunMethod << stencilDescCGVisitor.getCodeAndResetStream();
   }
 
@@ -852,9 +852,13 @@ std::string GTCodeGen::generateGlobals(std::shared_ptr<SIR> const& Sir) {
 
   GlobalsStruct.commit();
 
-  // Add the symbol for the singleton
-  codegen::Statement(ss) << "template<> " << StructName << "* " << BaseName
-                         << "::s_instance = nullptr";
+  // Add the symbol for the singleton (in split mode it is only declared here and defined in a
+  // separate source file)
+  if(context_->getOptions().SplitTranslationUnit)
+    codegen::Statement(ss) << "template<> " << StructName << "* " << BaseName << "::s_instance";
+  else
+    codegen::Statement(ss) << "template<> " << StructName << "* " << BaseName
+                           << "::s_instance = nullptr";
 
   gridtoolsNamespace.commit();
 
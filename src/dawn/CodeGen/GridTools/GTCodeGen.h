@@ -60,6 +60,9 @@ public:
     std::unordered_map<std::shared_ptr<Stage>, std::vector<Interval>> StageIntervals;
   };
 
+protected:
+  virtual std::string getWrapperNamespace() const override { return "gridtools"; }
+
 private:
   std::string generateStencilInstantiation(const StencilInstantiation* stencilInstantiation);
   std::string generateGlobals(const std::shared_ptr<SIR>& Sir);
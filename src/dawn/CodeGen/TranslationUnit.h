@@ -29,6 +29,7 @@ class TranslationUnit {
   std::vector<std::string> ppDefines_;          ///< Preprocessor defines
   std::string globals_;                         ///< Code for globals struct
   std::map<std::string, std::string> stencils_; ///< Code for each stencil mapped by name
+  std::map<std::string, std::string> files_;    ///< Split output files mapped by filename
 
 public:
   using const_iterator = std::map<std::string, std::string>::const_iterator;
@@ -51,6 +52,15 @@ public:
 
   /// @brief Get the code for the globals struct
   const std::string& getGlobals() const { return globals_; }
+
+  /// @brief Get the files of the split output mode (filename/code pair)
+  ///
+  /// The map is empty unless the translation unit was split into a shared header, one source file
+  /// per stencil and a CMake fragment (see `-split-tu`).
+  const std::map<std::string, std::string>& getFiles() const { return files_; }
+
+  /// @brief Set the files of the split output mode by consuming `files`
+  void setFiles(std::map<std::string, std::string>&& files) { files_ = std::move(files); }
 };
 
 } // namespace codegen
@@ -17,10 +17,16 @@
 #include "dawn/CodeGen/CodeGen.h"
 #include "dawn/CodeGen/GridTools/GTCodeGen.h"
 #include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/PassAlgebraicSimplification.h"
+#include "dawn/Optimizer/PassBoundaryConditionFusion.h"
+#include "dawn/Optimizer/PassCommonSubexpressionElimination.h"
 #include "dawn/Optimizer/PassComputeStageExtents.h"
+#include "dawn/Optimizer/PassConstantFolding.h"
 #include "dawn/Optimizer/PassDataLocalityMetric.h"
+#include "dawn/Optimizer/PassDeadCodeElimination.h"
 #include "dawn/Optimizer/PassFieldVersioning.h"
 #include "dawn/Optimizer/PassInlining.h"
+#include "dawn/Optimizer/PassLoopInvariantCodeMotion.h"
 #include "dawn/Optimizer/PassMultiStageSplitter.h"
 #include "dawn/Optimizer/PassPrintStencilGraph.h"
 #include "dawn/Optimizer/PassSSA.h"
@@ -32,17 +38,26 @@
 #include "dawn/Optimizer/PassStageMerger.h"
 #include "dawn/Optimizer/PassStageReordering.h"
 #include "dawn/Optimizer/PassStageSplitter.h"
+#include "dawn/Optimizer/PassStencilFusion.h"
 #include "dawn/Optimizer/PassStencilSplitter.h"
 #include "dawn/Optimizer/PassTemporaryFirstAccess.h"
 #include "dawn/Optimizer/PassTemporaryMerger.h"
+#include "dawn/Optimizer/PassTemporaryStorage.h"
 #include "dawn/Optimizer/PassTemporaryToStencilFunction.h"
 #include "dawn/Optimizer/PassTemporaryType.h"
 #include "dawn/SIR/SIR.h"
+#include "dawn/Support/Array.h"
 #include "dawn/Support/EditDistance.h"
+#include "dawn/Support/Format.h"
 #include "dawn/Support/Logging.h"
+#include "dawn/Support/StringRef.h"
 #include "dawn/Support/StringSwitch.h"
 #include "dawn/Support/StringUtil.h"
 #include "dawn/Support/Unreachable.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
 
 namespace dawn {
 
@@ -100,6 +115,123 @@ DiagnosticsBuilder buildDiag(const std::string& option, const T& value, std::str
   return diag;
 }
 
+/// @brief Parse the pinned value `str` of a global variable of type `type`
+///
+/// @returns `false` if `str` is not a valid value of the given type
+bool parseGlobalVariableValue(const std::string& str, sir::Value::TypeKind type,
+                              sir::Value& value) {
+  if(str.empty())
+    return false;
+
+  if(type == sir::Value::None) {
+    // The type of the variable is not known, deduce it from the value
+    if(str == "true" || str == "false")
+      type = sir::Value::Boolean;
+    else if(str.find_first_of(".eE") != std::string::npos)
+      type = sir::Value::Double;
+    else
+      type = sir::Value::Integer;
+  }
+
+  char* end = nullptr;
+  switch(type) {
+  case sir::Value::Boolean:
+    if(str != "true" && str != "false" && str != "1" && str != "0")
+      return false;
+    value.setValue(str == "true" || str == "1");
+    return true;
+  case sir::Value::Integer: {
+    long integer = std::strtol(str.c_str(), &end, 10);
+    if(*end != '\0' || integer < std::numeric_limits<int>::min() ||
+       integer > std::numeric_limits<int>::max())
+      return false;
+    value.setValue(static_cast<int>(integer));
+    return true;
+  }
+  case sir::Value::Double: {
+    double floating = std::strtod(str.c_str(), &end);
+    if(*end != '\0')
+      return false;
+    value.setValue(floating);
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+/// @brief Parse the domain size `str` (`nx,ny,nz`) into `size`
+///
+/// @returns `true` if `str` consists of three positive integers
+bool parseDomainSize(const std::string& str, Array3i& size) {
+  std::vector<std::string> list = splitList(str);
+  if(list.size() != 3)
+    return false;
+
+  for(int i = 0; i < 3; ++i) {
+    std::string value = StringRef(list[i]).trim();
+    char* end = nullptr;
+    long integer = std::strtol(value.c_str(), &end, 10);
+    if(value.empty() || *end != '\0' || integer <= 0 || integer > std::numeric_limits<int>::max())
+      return false;
+    size[i] = static_cast<int>(integer);
+  }
+  return true;
+}
+
+/// @brief Pin the global variables given in `list` (`name=value` pairs) to compile-time constants
+///
+/// The SIR is not modified, the pinned variables are replaced in a shallow copy of the SIR.
+///
+/// @returns the specialized SIR or `NULL` if `list` is invalid
+std::shared_ptr<SIR> pinGlobalVariables(const std::shared_ptr<SIR>& sir, const std::string& list,
+                                        DiagnosticsEngine& diagnostics) {
+  auto specializedSIR = std::make_shared<SIR>();
+  specializedSIR->Filename = sir->Filename;
+  specializedSIR->Stencils = sir->Stencils;
+  specializedSIR->StencilFunctions = sir->StencilFunctions;
+  specializedSIR->Lazy = sir->Lazy;
+  specializedSIR->GlobalVariableMap =
+      std::make_shared<sir::GlobalVariableMap>(*sir->GlobalVariableMap);
+  auto& globalVariableMap = *specializedSIR->GlobalVariableMap;
+
+  for(const std::string& pair : splitList(list)) {
+    std::size_t pos = pair.find('=');
+    if(pos == std::string::npos) {
+      diagnostics.report(buildDiag("-pin-globals", pair, "expected '<name>=<value>'"));
+      return nullptr;
+    }
+
+    std::string name = StringRef(pair).substr(0, pos).trim();
+    std::string str = StringRef(pair).substr(pos + 1).trim();
+
+    auto it = globalVariableMap.find(name);
+    if(it == globalVariableMap.end()) {
+      std::vector<std::string> names;
+      for(const auto& nameValuePair : globalVariableMap)
+        names.push_back(nameValuePair.first);
+      std::sort(names.begin(), names.end());
+      diagnostics.report(buildDiag("-pin-globals", name, "", names));
+      return nullptr;
+    }
+
+    sir::Value::TypeKind type = it->second->getType();
+    auto value = std::make_shared<sir::Value>();
+    if(!parseGlobalVariableValue(str, type, *value)) {
+      diagnostics.report(buildDiag(
+          "-pin-globals", pair,
+          "expected a value of type '" +
+              std::string(sir::Value::typeToString(type == sir::Value::None ? value->getType()
+                                                                            : type)) +
+              "'"));
+      return nullptr;
+    }
+    value->setIsConstexpr(true);
+    it->second = value;
+  }
+  return specializedSIR;
+}
+
 } // anonymous namespace
 
 DawnCompiler::DawnCompiler(Options* options) : diagnostics_(make_unique<DiagnosticsEngine>()) {
@@ -113,10 +245,12 @@ std::unique_ptr<OptimizerContext> DawnCompiler::runOptimizer(std::shared_ptr<SIR
                                           .Case("none", InlineStrategyKind::IK_None)
                                           .Case("cof", InlineStrategyKind::IK_ComputationOnTheFly)
                                           .Case("pc", InlineStrategyKind::IK_Precomputation)
+                                          .Case("auto", InlineStrategyKind::IK_Auto)
                                           .Default(InlineStrategyKind::IK_Unknown);
 
   if(inlineStrategy == InlineStrategyKind::IK_Unknown) {
-    diagnostics_->report(buildDiag("-inline", options_->InlineStrategy, "", {"none", "cof", "pc"}));
+    diagnostics_->report(
+        buildDiag("-inline", options_->InlineStrategy, "", {"none", "cof", "pc", "auto"}));
     return nullptr;
   }
 
@@ -146,13 +280,43 @@ std::unique_ptr<OptimizerContext> DawnCompiler::runOptimizer(std::shared_ptr<SIR
   // -max-fields
   int maxFields = options_->MaxFieldsPerStencil;
 
+  // -precision
+  int bytesPerElement = StringSwitch<int>(options_->Precision)
+                            .Case("float", sizeof(float))
+                            .Case("double", sizeof(double))
+                            .Default(0);
+  if(!bytesPerElement) {
+    diagnostics_->report(buildDiag("-precision", options_->Precision, "", {"float", "double"}));
+    return nullptr;
+  }
+
+  // -domain-size
+  Array3i domainSize;
+  if(!parseDomainSize(options_->DomainSize, domainSize)) {
+    diagnostics_->report(
+        buildDiag("-domain-size", options_->DomainSize, "expected three positive integers"));
+    return nullptr;
+  }
+
+  // -pin-globals
+  std::shared_ptr<dawn::SIR> specializedSIR = SIR;
+  if(!options_->PinGlobals.empty()) {
+    specializedSIR = pinGlobalVariables(SIR, options_->PinGlobals, getDiagnostics());
+    if(!specializedSIR)
+      return nullptr;
+  }
+
   // Initialize optimizer
   std::unique_ptr<OptimizerContext> optimizer =
-      make_unique<OptimizerContext>(getDiagnostics(), getOptions(), SIR);
+      make_unique<OptimizerContext>(getDiagnostics(), getOptions(), specializedSIR);
   PassManager& passManager = optimizer->getPassManager();
+  passManager.setCollectStatistics(options_->TimePasses);
 
   // Setup pass interface
   optimizer->checkAndPushBack<PassInlining>(inlineStrategy);
+  optimizer->checkAndPushBack<PassConstantFolding>();
+  optimizer->checkAndPushBack<PassAlgebraicSimplification>();
+  optimizer->checkAndPushBack<PassCommonSubexpressionElimination>();
   optimizer->checkAndPushBack<PassTemporaryFirstAccess>();
   optimizer->checkAndPushBack<PassFieldVersioning>();
   optimizer->checkAndPushBack<PassSSA>();
@@ -165,18 +329,25 @@ std::unique_ptr<OptimizerContext> DawnCompiler::runOptimizer(std::shared_ptr<SIR
   optimizer->checkAndPushBack<PassStageReordering>(reorderStrategy);
   optimizer->checkAndPushBack<PassStageMerger>();
   optimizer->checkAndPushBack<PassStencilSplitter>(maxFields);
+  optimizer->checkAndPushBack<PassStencilFusion>(reorderStrategy);
   optimizer->checkAndPushBack<PassTemporaryType>();
-  optimizer->checkAndPushBack<PassTemporaryMerger>();
+  optimizer->checkAndPushBack<PassLoopInvariantCodeMotion>();
+  optimizer->checkAndPushBack<PassTemporaryMerger>(bytesPerElement, domainSize);
   optimizer->checkAndPushBack<PassTemporaryToStencilFunction>();
+  optimizer->checkAndPushBack<PassDeadCodeElimination>();
+  optimizer->checkAndPushBack<PassTemporaryStorage>();
   optimizer->checkAndPushBack<PassSetNonTempCaches>();
   optimizer->checkAndPushBack<PassSetCaches>();
   optimizer->checkAndPushBack<PassComputeStageExtents>();
   optimizer->checkAndPushBack<PassSetBoundaryCondition>();
+  optimizer->checkAndPushBack<PassBoundaryConditionFusion>();
   optimizer->checkAndPushBack<PassDataLocalityMetric>();
 
-  DAWN_LOG(INFO) << "All the passes ran with the current command line arugments:";
-  for(const auto& a : passManager.getPasses()) {
-    DAWN_LOG(INFO) << a->getName();
+  if(DAWN_LOG_IS_ON(INFO)) {
+    DAWN_LOG(INFO) << "All the passes ran with the current command line arugments:";
+    for(const auto& a : passManager.getPasses()) {
+      DAWN_LOG(INFO) << a->getName();
+    }
   }
 
   // Run optimization passes
@@ -190,6 +361,17 @@ std::unique_ptr<OptimizerContext> DawnCompiler::runOptimizer(std::shared_ptr<SIR
                    << "`";
   }
 
+  // -time-passes
+  if(options_->TimePasses) {
+    std::cout << "\nPASS TIMING: " << SIR->Filename << "\n";
+    std::cout << format("%-40s %6s %12s %12s %12s\n", "pass", "runs", "time [ms]", "RSS [KB]",
+                        "peak [KB]");
+    for(const PassStatistics& statistics : passManager.getStatistics())
+      std::cout << format("%-40s %6i %12.3f %12i %12i\n", statistics.Name, statistics.NumRuns,
+                          statistics.Seconds * 1e3, statistics.RSSDeltaInKB,
+                          statistics.PeakRSSDeltaInKB);
+  }
+
   return optimizer;
 }
 
@@ -207,6 +389,15 @@ std::unique_ptr<codegen::TranslationUnit> DawnCompiler::compile(const std::share
     return nullptr;
   }
 
+  // -stencils
+  std::vector<std::string> stencilNames = SIR->getStencilNames();
+  for(const std::string& name : splitList(options_->Stencils)) {
+    if(std::find(stencilNames.begin(), stencilNames.end(), name) == stencilNames.end()) {
+      diagnostics_->report(buildDiag("-stencils", name, "", stencilNames));
+      return nullptr;
+    }
+  }
+
   // Initialize optimizer
   auto optimizer = runOptimizer(SIR);
 
@@ -215,20 +406,60 @@ std::unique_ptr<codegen::TranslationUnit> DawnCompiler::compile(const std::share
     return nullptr;
   }
 
-  // Generate code
+  // -serialize-iir
+  if(!options_->SerializeIIR.empty()) {
+    const std::string& file = options_->SerializeIIR;
+    auto kind = StringRef(file).endswith(".json") ? IIRSerializer::SK_Json : IIRSerializer::SK_Byte;
+    try {
+      IIRSerializer::serialize(file, optimizer.get(), kind);
+    } catch(std::exception& error) {
+      diagnostics_->report(DiagnosticsBuilder(DiagnosticsKind::Error) << error.what());
+      return nullptr;
+    }
+  }
+
+  return generateCode(optimizer.get(), codeGen);
+}
+
+std::unique_ptr<codegen::TranslationUnit>
+DawnCompiler::compileFromIIR(const std::string& file, CodeGenKind codeGen,
+                             IIRSerializer::SerializationKind kind) {
+  diagnostics_->clear();
+  diagnostics_->setFilename(file);
+
+  std::unique_ptr<OptimizerContext> optimizer;
+  try {
+    optimizer = IIRSerializer::deserialize(file, *diagnostics_, *options_, kind);
+  } catch(std::exception& error) {
+    diagnostics_->report(DiagnosticsBuilder(DiagnosticsKind::Error) << error.what());
+    return nullptr;
+  }
+
+  return generateCode(optimizer.get(), codeGen);
+}
+
+std::unique_ptr<codegen::TranslationUnit> DawnCompiler::generateCode(OptimizerContext* optimizer,
+                                                                     CodeGenKind codeGen) {
   std::unique_ptr<codegen::CodeGen> CG;
   switch(codeGen) {
   case CodeGenKind::CG_GTClang:
-    CG = make_unique<codegen::gt::GTCodeGen>(optimizer.get());
+    CG = make_unique<codegen::gt::GTCodeGen>(optimizer);
     break;
   case CodeGenKind::CG_GTClangNaiveCXX:
-    CG = make_unique<codegen::cxxnaive::CXXNaiveCodeGen>(optimizer.get());
+    CG = make_unique<codegen::cxxnaive::CXXNaiveCodeGen>(optimizer);
     break;
   case CodeGenKind::CG_GTClangOptCXX:
     dawn_unreachable("GTClangOptCXX not supported yet");
     break;
   }
-  return CG->generateCode();
+
+  std::unique_ptr<codegen::TranslationUnit> translationUnit = CG->generateCode();
+
+  // -split-tu
+  if(translationUnit && options_->SplitTranslationUnit)
+    CG->splitTranslationUnit(*translationUnit);
+
+  return translationUnit;
 }
 
 const DiagnosticsEngine& DawnCompiler::getDiagnostics() const { return *diagnostics_.get(); }
@@ -18,6 +18,7 @@
 #include "dawn/CodeGen/TranslationUnit.h"
 #include "dawn/Compiler/DiagnosticsEngine.h"
 #include "dawn/Compiler/Options.h"
+#include "dawn/Optimizer/IIRSerializer.h"
 #include "dawn/Optimizer/OptimizerContext.h"
 #include "dawn/Support/NonCopyable.h"
 #include <memory>
@@ -45,6 +46,16 @@ public:
   std::unique_ptr<codegen::TranslationUnit> compile(std::shared_ptr<SIR> const& SIR,
                                                     CodeGenKind codeGen);
 
+  /// @brief Compile a serialized IIR (see `-serialize-iir`) using the provided code generation
+  /// routine
+  ///
+  /// The optimizer is not run, the code is generated directly from the deserialized
+  /// StencilInstantiations.
+  /// @returns compiled TranslationUnit on success, `nullptr` otherwise
+  std::unique_ptr<codegen::TranslationUnit>
+  compileFromIIR(const std::string& file, CodeGenKind codeGen,
+                 IIRSerializer::SerializationKind kind = IIRSerializer::SK_Byte);
+
   std::unique_ptr<OptimizerContext> runOptimizer(std::shared_ptr<SIR> const& SIR);
 
   /// @brief Get options
@@ -54,6 +65,11 @@ public:
   /// @brief Get the diagnostics engine
   const DiagnosticsEngine& getDiagnostics() const;
   DiagnosticsEngine& getDiagnostics();
+
+private:
+  /// @brief Run the code generation backend on the optimized StencilInstantiations of `optimizer`
+  std::unique_ptr<codegen::TranslationUnit> generateCode(OptimizerContext* optimizer,
+                                                         CodeGenKind codeGen);
 };
 
 } // namespace dawn
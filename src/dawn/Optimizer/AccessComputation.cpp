@@ -18,7 +18,7 @@
 #include "dawn/Optimizer/StencilFunctionInstantiation.h"
 #include "dawn/Optimizer/StencilInstantiation.h"
 #include "dawn/SIR/AST.h"
-#include "dawn/SIR/ASTVisitor.h"
+#include "dawn/SIR/ASTKindVisitor.h"
 #include <iostream>
 #include <stack>
 
@@ -27,7 +27,7 @@ namespace dawn {
 namespace {
 
 /// @brief Compute and fill the access map of the given statement
-class AccessMapper : public ASTVisitor {
+class AccessMapper : public ASTKindVisitor<AccessMapper> {
   StencilInstantiation* instantiation_;
 
   /// Keep track of the current statement access pair
@@ -115,7 +115,7 @@ public:
     // Add all accesses of all parent if-cond expressions
     for(const auto& pair : curStatementAccessPairStack_)
       if(pair->IfCondExpr)
-        pair->IfCondExpr->accept(*this);
+        visit(pair->IfCondExpr);
   }
 
   /// @brief Pop the last added child access from the caller and callee accesses list
@@ -132,81 +132,75 @@ public:
 
   /// @brief Add a write extent/offset to the caller and callee accesses
   /// @{
-  void mergeWriteOffset(const std::shared_ptr<FieldAccessExpr>& field) {
+  void mergeWriteOffset(const FieldAccessExpr& field, const std::shared_ptr<Expr>& node) {
+    int AccessID = getAccessIDFromExpr(node);
     auto getOffset = [&](bool computeInitialOffset) {
-      return (stencilFun_ ? stencilFun_->evalOffsetOfFieldAccessExpr(field, computeInitialOffset)
-                          : field->getOffset());
+      return (stencilFun_
+                  ? stencilFun_->evalOffsetOfFieldAccessExpr(field, node, computeInitialOffset)
+                  : field.getOffset());
     };
 
     for(auto& callerAccesses : callerAccessesList_)
-      callerAccesses->mergeWriteOffset(getAccessIDFromExpr(field), getOffset(true));
+      callerAccesses->mergeWriteOffset(AccessID, getOffset(true));
 
     for(auto& calleeAccesses : calleeAccessesList_)
-      calleeAccesses->mergeWriteOffset(getAccessIDFromExpr(field), getOffset(false));
+      calleeAccesses->mergeWriteOffset(AccessID, getOffset(false));
   }
 
-  void mergeWriteOffset(const std::shared_ptr<VarAccessExpr>& var) {
+  /// @brief Variables (`VarAccessExpr` and `VarDeclStmt`) are always accessed without offset
+  void mergeWriteOffset(int AccessID) {
     for(auto& callerAccesses : callerAccessesList_)
-      callerAccesses->mergeWriteOffset(getAccessIDFromExpr(var), Array3i{{0, 0, 0}});
+      callerAccesses->mergeWriteOffset(AccessID, Array3i{{0, 0, 0}});
 
     for(auto& calleeAccesses : calleeAccessesList_)
-      calleeAccesses->mergeWriteOffset(getAccessIDFromExpr(var), Array3i{{0, 0, 0}});
+      calleeAccesses->mergeWriteOffset(AccessID, Array3i{{0, 0, 0}});
   }
 
-  void mergeWriteOffset(const std::shared_ptr<VarDeclStmt>& var) {
-    for(auto& callerAccesses : callerAccessesList_)
-      callerAccesses->mergeWriteOffset(getAccessIDFromStmt(var), Array3i{{0, 0, 0}});
+  void mergeWriteExtent(const std::shared_ptr<Expr>& field, const Extents& extent) {
+    int AccessID = getAccessIDFromExpr(field);
 
-    for(auto& calleeAccesses : calleeAccessesList_)
-      calleeAccesses->mergeWriteOffset(getAccessIDFromStmt(var), Array3i{{0, 0, 0}});
-  }
-
-  void mergeWriteExtent(const std::shared_ptr<FieldAccessExpr>& field, const Extents& extent) {
     for(auto& callerAccesses : callerAccessesList_)
-      callerAccesses->mergeWriteExtent(getAccessIDFromExpr(field), extent);
+      callerAccesses->mergeWriteExtent(AccessID, extent);
 
     for(auto& calleeAccesses : calleeAccessesList_)
-      calleeAccesses->mergeWriteExtent(getAccessIDFromExpr(field), extent);
+      calleeAccesses->mergeWriteExtent(AccessID, extent);
   }
   /// @}
 
   /// @brief Add a read offset/extent to the caller and callee accesses
   /// @{
-  void mergeReadOffset(const std::shared_ptr<FieldAccessExpr>& field) {
+  void mergeReadOffset(const FieldAccessExpr& field, const std::shared_ptr<Expr>& node) {
+    int AccessID = getAccessIDFromExpr(node);
     auto getOffset = [&](bool computeInitialOffset) {
-      return (stencilFun_ ? stencilFun_->evalOffsetOfFieldAccessExpr(field, computeInitialOffset)
-                          : field->getOffset());
+      return (stencilFun_
+                  ? stencilFun_->evalOffsetOfFieldAccessExpr(field, node, computeInitialOffset)
+                  : field.getOffset());
     };
 
     for(auto& callerAccesses : callerAccessesList_)
-      callerAccesses->mergeReadOffset(getAccessIDFromExpr(field), getOffset(true));
+      callerAccesses->mergeReadOffset(AccessID, getOffset(true));
 
     for(auto& calleeAccesses : calleeAccessesList_)
-      calleeAccesses->mergeReadOffset(getAccessIDFromExpr(field), getOffset(false));
+      calleeAccesses->mergeReadOffset(AccessID, getOffset(false));
   }
 
-  void mergeReadOffset(const std::shared_ptr<VarAccessExpr>& var) {
+  /// @brief Variables and literals are always accessed without offset
+  void mergeReadOffset(int AccessID) {
     for(auto& callerAccesses : callerAccessesList_)
-      callerAccesses->mergeReadOffset(getAccessIDFromExpr(var), Array3i{{0, 0, 0}});
+      callerAccesses->mergeReadOffset(AccessID, Array3i{{0, 0, 0}});
 
     for(auto& calleeAccesses : calleeAccessesList_)
-      calleeAccesses->mergeReadOffset(getAccessIDFromExpr(var), Array3i{{0, 0, 0}});
+      calleeAccesses->mergeReadOffset(AccessID, Array3i{{0, 0, 0}});
   }
 
-  void mergeReadOffset(const std::shared_ptr<LiteralAccessExpr>& lit) {
-    for(auto& callerAccesses : callerAccessesList_)
-      callerAccesses->mergeReadOffset(getAccessIDFromExpr(lit), Array3i{{0, 0, 0}});
+  void mergeReadExtent(const std::shared_ptr<Expr>& field, const Extents& extent) {
+    int AccessID = getAccessIDFromExpr(field);
 
-    for(auto& calleeAccesses : calleeAccessesList_)
-      calleeAccesses->mergeReadOffset(getAccessIDFromExpr(lit), Array3i{{0, 0, 0}});
-  }
-
-  void mergeReadExtent(const std::shared_ptr<FieldAccessExpr>& field, const Extents& extent) {
     for(auto& callerAccesses : callerAccessesList_)
-      callerAccesses->mergeReadExtent(getAccessIDFromExpr(field), extent);
+      callerAccesses->mergeReadExtent(AccessID, extent);
 
     for(auto& calleeAccesses : calleeAccessesList_)
-      calleeAccesses->mergeReadExtent(getAccessIDFromExpr(field), extent);
+      calleeAccesses->mergeReadExtent(AccessID, extent);
   }
   /// @}
 
@@ -242,89 +236,88 @@ public:
     }
   }
 
-  virtual void visit(const std::shared_ptr<BlockStmt>& stmt) override {
+  void visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>& node) {
     // If we are inside the else block of an if-statement we need to continue iterating
     // the children as the if/then/else block of the if-statement has been collapsed into one single
     // vector of children
     if(!curStatementAccessPairStack_.back()->IfCondExpr)
       curStatementAccessPairStack_.back()->ChildIndex = 0;
 
-    for(auto& s : stmt->getStatements()) {
+    for(const auto& s : stmt.getStatements()) {
       curStatementAccessPairStack_.push_back(make_unique<CurrentStatementAccessPair>(
           curStatementAccessPairStack_.back()
               ->Pair->getChildren()[curStatementAccessPairStack_.back()->ChildIndex]));
 
       // Process the statement
-      s->accept(*this);
+      visit(s);
 
       curStatementAccessPairStack_.pop_back();
       curStatementAccessPairStack_.back()->ChildIndex++;
     }
   }
 
-  virtual void visit(const std::shared_ptr<ExprStmt>& stmt) override {
+  void visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>& node) {
     appendNewAccesses();
-    stmt->getExpr()->accept(*this);
+    visit(stmt.getExpr());
     removeLastChildAccesses();
   }
 
-  virtual void visit(const std::shared_ptr<ReturnStmt>& stmt) override {
+  void visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) {
     appendNewAccesses();
-    stmt->getExpr()->accept(*this);
+    visit(stmt.getExpr());
     removeLastChildAccesses();
   }
 
-  void visit(const std::shared_ptr<IfStmt>& stmt) override {
+  void visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node) {
     appendNewAccesses();
-    stmt->getCondExpr()->accept(*this);
+    visit(stmt.getCondExpr());
 
-    curStatementAccessPairStack_.back()->IfCondExpr = stmt->getCondExpr();
+    curStatementAccessPairStack_.back()->IfCondExpr = stmt.getCondExpr();
 
-    stmt->getThenStmt()->accept(*this);
-    if(stmt->hasElse())
-      stmt->getElseStmt()->accept(*this);
+    visit(stmt.getThenStmt());
+    if(stmt.hasElse())
+      visit(stmt.getElseStmt());
 
     curStatementAccessPairStack_.back()->IfCondExpr = nullptr;
 
     removeLastChildAccesses();
   }
 
-  virtual void visit(const std::shared_ptr<VarDeclStmt>& stmt) override {
+  void visitVarDeclStmt(const VarDeclStmt& stmt, const std::shared_ptr<Stmt>& node) {
     appendNewAccesses();
 
     // Declaration of variables are by defintion writes
-    mergeWriteOffset(stmt);
+    mergeWriteOffset(getAccessIDFromStmt(node));
 
-    for(const auto& expr : stmt->getInitList())
-      expr->accept(*this);
+    for(const auto& expr : stmt.getInitList())
+      visit(expr);
 
     removeLastChildAccesses();
   }
 
-  virtual void visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) override {
+  void visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                   const std::shared_ptr<Stmt>& node) {
     DAWN_ASSERT_MSG(0, "VerticalRegionDeclStmt not allowed in this context");
   }
-  virtual void visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) override {
+
+  void visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                const std::shared_ptr<Stmt>& node) {
     DAWN_ASSERT_MSG(0, "StencilCallDeclStmt not allowed in this context");
   }
 
-  virtual void visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) override {
+  void visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                      const std::shared_ptr<Stmt>& node) {
     DAWN_ASSERT_MSG(0, "BoundaryConditionDeclStmt not allowed in this context");
   }
 
-  virtual void visit(const std::shared_ptr<FunCallExpr>& expr) override {
-    for(auto& s : expr->getChildren())
-      s->accept(*this);
-  }
-
-  virtual void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override {
+  void visitStencilFunCallExpr(const StencilFunCallExpr& expr, const std::shared_ptr<Expr>& node) {
     StencilFunctionCallScope* previousStencilFunCallScope = nullptr;
     if(!stencilFunCalls_.empty())
       previousStencilFunCallScope = stencilFunCalls_.top().get();
 
     // Compute the accesses of the stencil function
-    stencilFunCalls_.push(
-        make_unique<StencilFunctionCallScope>(getStencilFunctionInstantiation(expr)));
+    stencilFunCalls_.push(make_unique<StencilFunctionCallScope>(
+        getStencilFunctionInstantiation(std::static_pointer_cast<StencilFunCallExpr>(node))));
 
     std::shared_ptr<StencilFunctionInstantiation> curStencilFunCall =
         stencilFunCalls_.top()->FunctionInstantiation;
@@ -334,8 +327,8 @@ public:
     curStencilFunCall->update();
 
     // Traverse the Arguments
-    for(const auto& arg : expr->getArguments())
-      arg->accept(*this);
+    for(const auto& arg : expr.getArguments())
+      visit(arg);
 
     // If the current stencil function is called within the argument list of another stencil
     // function, we need to merge the extents
@@ -357,65 +350,50 @@ public:
     stencilFunCalls_.pop();
   }
 
-  virtual void visit(const std::shared_ptr<StencilFunArgExpr>& expr) override {
+  void visitStencilFunArgExpr(const StencilFunArgExpr& expr, const std::shared_ptr<Expr>& node) {
     stencilFunCalls_.top()->ArgumentIndex += 1;
   }
 
-  void visit(const std::shared_ptr<AssignmentExpr>& expr) override {
+  void visitAssignmentExpr(const AssignmentExpr& expr, const std::shared_ptr<Expr>& node) {
     // LHS is a write, we resolve this manually as we only care about FieldAccessExpr and
     // VarAccessExpr. However, if we have an expression `a += 5` we need to register the access as
     // write and read!
-    bool readAndWrite = StringRef(expr->getOp()) == "+=" || StringRef(expr->getOp()) == "-=" ||
-                        StringRef(expr->getOp()) == "/=" || StringRef(expr->getOp()) == "*=" ||
-                        StringRef(expr->getOp()) == "|=" || StringRef(expr->getOp()) == "&=";
+    bool readAndWrite = StringRef(expr.getOp()) == "+=" || StringRef(expr.getOp()) == "-=" ||
+                        StringRef(expr.getOp()) == "/=" || StringRef(expr.getOp()) == "*=" ||
+                        StringRef(expr.getOp()) == "|=" || StringRef(expr.getOp()) == "&=";
 
-    if(isa<FieldAccessExpr>(expr->getLeft().get())) {
-      auto field = std::static_pointer_cast<FieldAccessExpr>(expr->getLeft());
-      mergeWriteOffset(field);
+    const std::shared_ptr<Expr>& left = expr.getLeft();
+    if(const FieldAccessExpr* field = dyn_cast<FieldAccessExpr>(left.get())) {
+      mergeWriteOffset(*field, left);
       if(readAndWrite)
-        mergeReadOffset(field);
-    } else if(isa<VarAccessExpr>(expr->getLeft().get())) {
-      auto var = std::static_pointer_cast<VarAccessExpr>(expr->getLeft());
-      mergeWriteOffset(var);
+        mergeReadOffset(*field, left);
+    } else if(isa<VarAccessExpr>(left.get())) {
+      int AccessID = getAccessIDFromExpr(left);
+      mergeWriteOffset(AccessID);
       if(readAndWrite)
-        mergeReadOffset(var);
+        mergeReadOffset(AccessID);
     }
 
     // RHS are read accesses
-    expr->getRight()->accept(*this);
-  }
-
-  void visit(const std::shared_ptr<UnaryOperator>& expr) override {
-    for(auto& s : expr->getChildren())
-      s->accept(*this);
-  }
-
-  void visit(const std::shared_ptr<BinaryOperator>& expr) override {
-    for(auto& s : expr->getChildren())
-      s->accept(*this);
-  }
-
-  void visit(const std::shared_ptr<TernaryOperator>& expr) override {
-    for(auto& s : expr->getChildren())
-      s->accept(*this);
+    visit(expr.getRight());
   }
 
-  void visit(const std::shared_ptr<VarAccessExpr>& expr) override {
+  void visitVarAccessExpr(const VarAccessExpr& expr, const std::shared_ptr<Expr>& node) {
     // This is always a read access (writes are resolved in handling of the declaration of the
     // variable and in the assignment)
-    mergeReadOffset(expr);
+    mergeReadOffset(getAccessIDFromExpr(node));
 
     // Resolve the index if this is an array access
-    if(expr->isArrayAccess())
-      expr->getIndex()->accept(*this);
+    if(expr.isArrayAccess())
+      visit(expr.getIndex());
   }
 
-  void visit(const std::shared_ptr<LiteralAccessExpr>& expr) override {
+  void visitLiteralAccessExpr(const LiteralAccessExpr& expr, const std::shared_ptr<Expr>& node) {
     // Literals can, by defintion, only be read
-    mergeReadOffset(expr);
+    mergeReadOffset(getAccessIDFromExpr(node));
   }
 
-  void visit(const std::shared_ptr<FieldAccessExpr>& expr) override {
+  void visitFieldAccessExpr(const FieldAccessExpr& expr, const std::shared_ptr<Expr>& node) {
     if(!stencilFunCalls_.empty()) {
 
       std::shared_ptr<StencilFunctionInstantiation> functionInstantiation =
@@ -426,16 +404,16 @@ public:
       const Field& field = functionInstantiation->getCallerFieldFromArgumentIndex(ArgumentIndex);
 
       if(field.getIntend() == Field::IK_Input || field.getIntend() == Field::IK_InputOutput)
-        mergeReadExtent(expr, field.getExtents());
+        mergeReadExtent(node, field.getExtents());
 
       if(field.getIntend() == Field::IK_Output || field.getIntend() == Field::IK_InputOutput)
-        mergeWriteExtent(expr, field.getExtents());
+        mergeWriteExtent(node, field.getExtents());
 
       ArgumentIndex += 1;
 
     } else {
       // This is always a read access (writes are resolved in the the assignment)
-      mergeReadOffset(expr);
+      mergeReadOffset(expr, node);
     }
   }
 };
@@ -447,7 +425,7 @@ void computeAccesses(StencilInstantiation* instantiation,
   for(const auto& statementAccessesPair : statementAccessesPairs) {
     DAWN_ASSERT(instantiation);
     AccessMapper mapper(instantiation, statementAccessesPair, nullptr);
-    statementAccessesPair->getStatement()->ASTStmt->accept(mapper);
+    mapper.visit(statementAccessesPair->getStatement()->ASTStmt);
   }
 }
 
@@ -456,7 +434,7 @@ void computeAccesses(std::shared_ptr<StencilFunctionInstantiation> stencilFuncti
   for(const auto& statementAccessesPair : statementAccessesPairs) {
     AccessMapper mapper(stencilFunctionInstantiation->getStencilInstantiation(),
                         statementAccessesPair, stencilFunctionInstantiation);
-    statementAccessesPair->getStatement()->ASTStmt->accept(mapper);
+    mapper.visit(statementAccessesPair->getStatement()->ASTStmt);
   }
 }
 
@@ -16,7 +16,7 @@
 #define DAWN_OPTIMIZER_ACCESSES_H
 
 #include "dawn/Optimizer/Extents.h"
-#include <unordered_map>
+#include <map>
 
 namespace dawn {
 
@@ -28,8 +28,8 @@ class StencilFunctionInstantiation;
 /// Accesses are either part of a `StencilInstantiation` or `StencilFunctionInstantiation`.
 /// @ingroup optimizer
 class Accesses {
-  std::unordered_map<int, Extents> writeAccesses_;
-  std::unordered_map<int, Extents> readAccesses_;
+  std::map<int, Extents> writeAccesses_;
+  std::map<int, Extents> readAccesses_;
 
 public:
   Accesses() = default;
@@ -73,11 +73,11 @@ public:
   const Extents& getWriteAccess(int AccessID) const;
 
   /// @brief Get the accesses maps
-  std::unordered_map<int, Extents>& getReadAccesses() { return readAccesses_; }
-  const std::unordered_map<int, Extents>& getReadAccesses() const { return readAccesses_; }
+  std::map<int, Extents>& getReadAccesses() { return readAccesses_; }
+  const std::map<int, Extents>& getReadAccesses() const { return readAccesses_; }
 
-  std::unordered_map<int, Extents>& getWriteAccesses() { return writeAccesses_; }
-  const std::unordered_map<int, Extents>& getWriteAccesses() const { return writeAccesses_; }
+  std::map<int, Extents>& getWriteAccesses() { return writeAccesses_; }
+  const std::map<int, Extents>& getWriteAccesses() const { return writeAccesses_; }
 
   /// @brief Convert the accesses of a stencil or stencil-function instantiation to string
   /// @{
@@ -25,6 +25,10 @@ int Cache::getCachedFieldAccessID() const { return AccessID_; }
 
 boost::optional<Interval> Cache::getInterval() const { return interval_; }
 
+boost::optional<int> Cache::getWindow() const { return window_; }
+
+void Cache::setWindow(int window) { window_ = window; }
+
 Cache::CacheTypeKind Cache::getCacheType() const { return type_; }
 
 std::string Cache::getCacheTypeAsString() const {
@@ -67,6 +67,12 @@ public:
   /// @brief Get the I/O policy of the cache
   boost::optional<Interval> getInterval() const;
 
+  /// @brief Get the number of vertical levels of the ring buffer which is sufficient to store the
+  /// cached field (only set for local caches of temporaries which are not accessed outside of the
+  /// multi-stage, the window of IJ-caches is a single level)
+  boost::optional<int> getWindow() const;
+  void setWindow(int window);
+
   /// @name Comparison operator
   /// @{
   bool operator==(const Cache& other) const {
@@ -80,6 +86,7 @@ private:
   CacheIOPolicy policy_;
   int AccessID_;
   boost::optional<Interval> interval_;
+  boost::optional<int> window_;
 };
 
 } // namespace dawn
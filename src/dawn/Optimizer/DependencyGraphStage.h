@@ -33,14 +33,15 @@ enum class DependencyGraphStageEdgeData { EK_Depends };
 class DependencyGraphStage
     : public DependencyGraph<DependencyGraphStage, DependencyGraphStageEdgeData> {
 
-  std::shared_ptr<StencilInstantiation> stencilInstantiation_;
+  /// The graph is owned by a stencil of the instantiation, a shared pointer would form a cycle
+  StencilInstantiation* stencilInstantiation_;
 
 public:
   using Base = DependencyGraph<DependencyGraphStage, DependencyGraphStageEdgeData>;
   using EdgeData = DependencyGraphStageEdgeData;
 
   DependencyGraphStage(const std::shared_ptr<StencilInstantiation>& stencilInstantiation)
-      : Base(), stencilInstantiation_(stencilInstantiation) {}
+      : Base(), stencilInstantiation_(stencilInstantiation.get()) {}
 
   void insertEdge(int StageIDFrom, int StageIDTo);
 
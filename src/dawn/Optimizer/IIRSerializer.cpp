@@ -0,0 +1,1015 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/IIRSerializer.h"
+#include "dawn/Optimizer/IIR.pb.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/Stage.h"
+#include "dawn/Optimizer/StatementAccessesPair.h"
+#include "dawn/Optimizer/StencilFunctionInstantiation.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/ASTVisitor.h"
+#include "dawn/SIR/SIRProto.h"
+#include "dawn/Support/Casting.h"
+#include "dawn/Support/Format.h"
+#include "dawn/Support/MappedFile.h"
+#include "dawn/Support/STLExtras.h"
+#include "dawn/Support/Unreachable.h"
+#include <algorithm>
+#include <fstream>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/util/json_util.h>
+#include <limits>
+#include <map>
+#include <tuple>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Pre-order enumeration of the nodes of a statement
+///
+/// The node indices are the same for a statement and its serialized and deserialized copy, they are
+/// used to identify the nodes of the annotated IIR statements.
+class NodeIndex {
+  /// Node `i` is either a statement (`stmts_[i] != nullptr`) or an expression
+  /// (`exprs_[i] != nullptr`)
+  std::vector<std::shared_ptr<Stmt>> stmts_;
+  std::vector<std::shared_ptr<Expr>> exprs_;
+  std::unordered_map<const Stmt*, int> stmtToIndex_;
+
+  class Enumerator : public ASTVisitorForwarding {
+    NodeIndex& index_;
+
+  public:
+    Enumerator(NodeIndex& index) : index_(index) {}
+
+#define NODEINDEX_VISIT_STMT_IMPL(Type)                                                            \
+  void visit(const std::shared_ptr<Type>& stmt) override {                                         \
+    index_.stmtToIndex_.emplace(stmt.get(), index_.stmts_.size());                                 \
+    index_.stmts_.push_back(stmt);                                                                 \
+    index_.exprs_.push_back(nullptr);                                                              \
+    ASTVisitorForwarding::visit(stmt);                                                             \
+  }
+#define NODEINDEX_VISIT_EXPR_IMPL(Type)                                                            \
+  void visit(const std::shared_ptr<Type>& expr) override {                                         \
+    index_.stmts_.push_back(nullptr);                                                              \
+    index_.exprs_.push_back(expr);                                                                 \
+    ASTVisitorForwarding::visit(expr);                                                             \
+  }
+
+    NODEINDEX_VISIT_STMT_IMPL(BlockStmt)
+    NODEINDEX_VISIT_STMT_IMPL(ExprStmt)
+    NODEINDEX_VISIT_STMT_IMPL(ReturnStmt)
+    NODEINDEX_VISIT_STMT_IMPL(VarDeclStmt)
+    NODEINDEX_VISIT_STMT_IMPL(VerticalRegionDeclStmt)
+    NODEINDEX_VISIT_STMT_IMPL(StencilCallDeclStmt)
+    NODEINDEX_VISIT_STMT_IMPL(BoundaryConditionDeclStmt)
+    NODEINDEX_VISIT_STMT_IMPL(IfStmt)
+    NODEINDEX_VISIT_EXPR_IMPL(UnaryOperator)
+    NODEINDEX_VISIT_EXPR_IMPL(BinaryOperator)
+    NODEINDEX_VISIT_EXPR_IMPL(AssignmentExpr)
+    NODEINDEX_VISIT_EXPR_IMPL(TernaryOperator)
+    NODEINDEX_VISIT_EXPR_IMPL(FunCallExpr)
+    NODEINDEX_VISIT_EXPR_IMPL(StencilFunCallExpr)
+    NODEINDEX_VISIT_EXPR_IMPL(StencilFunArgExpr)
+    NODEINDEX_VISIT_EXPR_IMPL(VarAccessExpr)
+    NODEINDEX_VISIT_EXPR_IMPL(FieldAccessExpr)
+    NODEINDEX_VISIT_EXPR_IMPL(LiteralAccessExpr)
+
+#undef NODEINDEX_VISIT_STMT_IMPL
+#undef NODEINDEX_VISIT_EXPR_IMPL
+  };
+
+public:
+  explicit NodeIndex(const std::shared_ptr<Stmt>& root) {
+    Enumerator enumerator(*this);
+    root->accept(enumerator);
+  }
+
+  int size() const { return stmts_.size(); }
+
+  const std::shared_ptr<Stmt>& getStmt(int index) const { return stmts_[index]; }
+  const std::shared_ptr<Expr>& getExpr(int index) const { return exprs_[index]; }
+
+  /// @brief Get the index of `stmt` or -1 if `stmt` is not part of the statement
+  int getIndexOfStmt(const Stmt* stmt) const {
+    auto it = stmtToIndex_.find(stmt);
+    return it != stmtToIndex_.end() ? it->second : -1;
+  }
+
+  /// @brief Get the statement at `index` and throw if there is none
+  const std::shared_ptr<Stmt>& getStmtChecked(int index) const {
+    if(index < 0 || index >= size() || !stmts_[index])
+      throw std::runtime_error(format("invalid statement node index %i", index));
+    return stmts_[index];
+  }
+};
+
+/// @brief Copy the (unordered) map into a sorted map
+///
+/// All tables are stored and restored in sorted order which makes the serialized IIR
+/// deterministic. The code generators iterate the hash maps they emit code for (caches, boundary
+/// conditions) in sorted order as well, the insertion order of the reloaded maps does not matter.
+template <class MapT>
+std::map<typename MapT::key_type, typename MapT::mapped_type> sorted(const MapT& map) {
+  return std::map<typename MapT::key_type, typename MapT::mapped_type>(map.begin(), map.end());
+}
+
+/// @brief Insert the entries of `map` into the protobuf map `protoMap` in sorted order
+template <class ProtoMapT, class MapT>
+void insertSorted(ProtoMapT* protoMap, const MapT& map) {
+  for(const auto& pair : sorted(map))
+    (*protoMap)[pair.first] = pair.second;
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Serialization
+//===------------------------------------------------------------------------------------------===//
+
+static void setInterval(iir::proto::Interval* intervalProto, const Interval& interval) {
+  intervalProto->set_lower_level(interval.lowerLevel());
+  intervalProto->set_upper_level(interval.upperLevel());
+  intervalProto->set_lower_offset(interval.lowerOffset());
+  intervalProto->set_upper_offset(interval.upperOffset());
+}
+
+static void setExtents(iir::proto::Extents* extentsProto, const Extents& extents) {
+  for(const Extent& extent : extents.getExtents()) {
+    auto extentProto = extentsProto->add_extents();
+    extentProto->set_minus(extent.Minus);
+    extentProto->set_plus(extent.Plus);
+  }
+}
+
+static void setAccesses(iir::proto::Accesses* accessesProto,
+                        const std::shared_ptr<Accesses>& accesses) {
+  for(const auto& accessIDExtentsPair : accesses->getReadAccesses()) {
+    auto accessProto = accessesProto->add_read_accesses();
+    accessProto->set_access_id(accessIDExtentsPair.first);
+    setExtents(accessProto->mutable_extents(), accessIDExtentsPair.second);
+  }
+  for(const auto& accessIDExtentsPair : accesses->getWriteAccesses()) {
+    auto accessProto = accessesProto->add_write_accesses();
+    accessProto->set_access_id(accessIDExtentsPair.first);
+    setExtents(accessProto->mutable_extents(), accessIDExtentsPair.second);
+  }
+}
+
+/// @brief Convert a single StencilInstantiation to protobuf
+class IIRBuilder {
+  const StencilInstantiation* instantiation_;
+  iir::proto::StencilInstantiation* proto_;
+
+  /// Index of each stencil function instantiation in the flat list of instantiations
+  std::unordered_map<const StencilFunctionInstantiation*, int> functionToIndex_;
+
+  /// Index of the stencil function instantiation of each `StencilFunCallExpr`
+  std::unordered_map<const Expr*, int> callToFunctionIndex_;
+
+public:
+  IIRBuilder(const StencilInstantiation* instantiation, iir::proto::StencilInstantiation* proto)
+      : instantiation_(instantiation), proto_(proto) {}
+
+  void build() {
+    const auto& functions = instantiation_->getStencilFunctionInstantiations();
+    for(int i = 0; i < functions.size(); ++i)
+      functionToIndex_.emplace(functions[i].get(), i);
+
+    using CallToFunctionMap = std::unordered_map<std::shared_ptr<StencilFunCallExpr>,
+                                                 std::shared_ptr<StencilFunctionInstantiation>>;
+    auto registerCalls = [&](const CallToFunctionMap& callToFunctionMap) {
+      for(const auto& callFunctionPair : callToFunctionMap) {
+        auto it = functionToIndex_.find(callFunctionPair.second.get());
+        if(it != functionToIndex_.end())
+          callToFunctionIndex_.emplace(callFunctionPair.first.get(), it->second);
+      }
+    };
+    registerCalls(instantiation_->getExprToStencilFunctionInstantiationMap());
+    for(const auto& function : functions)
+      registerCalls(function->getExprToStencilFunctionInstantiationMap());
+
+    setTables();
+
+    for(const auto& function : functions)
+      setStencilFunctionInstantiation(proto_->add_stencil_function_instantiations(), function);
+
+    for(const auto& stencil : instantiation_->getStencils())
+      setStencil(proto_->add_stencils(), stencil);
+
+    std::vector<NodeIndex> descIndices;
+    for(const auto& statement : instantiation_->getStencilDescStatements())
+      descIndices.emplace_back(
+          setStatement(proto_->add_stencil_desc_statements(), statement->ASTStmt, nullptr));
+
+    setBoundaryConditions(descIndices);
+  }
+
+private:
+  void setTables() {
+    proto_->set_stencil_name(instantiation_->getName());
+    proto_->set_next_uid(instantiation_->getUIDGenerator().peek());
+
+    insertSorted(proto_->mutable_access_id_to_name(), instantiation_->getAccessIDToNameMap());
+    insertSorted(proto_->mutable_name_to_access_id(), instantiation_->getNameToAccessIDMap());
+    insertSorted(proto_->mutable_literal_access_id_to_name(),
+                 instantiation_->getLiteralAccessIDToNameMap());
+    insertSorted(proto_->mutable_stage_id_to_name(), instantiation_->getStageIDToNameMap());
+
+    for(int AccessID : instantiation_->getFieldAccessIDSet())
+      proto_->add_field_access_ids(AccessID);
+    for(int AccessID : instantiation_->getTemporaryFieldAccessIDSet())
+      proto_->add_temporary_field_access_ids(AccessID);
+    for(int AccessID : instantiation_->getAllocatedFieldAccessIDSet())
+      proto_->add_allocated_field_access_ids(AccessID);
+    for(int AccessID : instantiation_->getGlobalVariableAccessIDSet())
+      proto_->add_global_variable_access_ids(AccessID);
+    for(const auto& accessIDDimensionsPair : instantiation_->getFieldDimensionsMap()) {
+      auto& dimensionsProto = (*proto_->mutable_field_dimensions())[accessIDDimensionsPair.first];
+      for(int dimension : accessIDDimensionsPair.second)
+        dimensionsProto.add_dimensions(dimension);
+    }
+    for(int AccessID : instantiation_->getCachedVariableSet())
+      proto_->add_cached_variable_access_ids(AccessID);
+
+    // Several AccessIDs share the same list of versions
+    const VariableVersions& variableVersions = instantiation_->getVariableVersions();
+    std::map<const std::vector<int>*, iir::proto::VariableVersions*> versionsToProto;
+    for(const auto& accessIDVersionsPair :
+        sorted(variableVersions.getVariableVersionsMap())) {
+      auto& versionsProto = versionsToProto[accessIDVersionsPair.second.get()];
+      if(!versionsProto) {
+        versionsProto = proto_->add_variable_versions();
+        for(int version : *accessIDVersionsPair.second)
+          versionsProto->add_versions(version);
+      }
+      versionsProto->add_access_ids(accessIDVersionsPair.first);
+    }
+    insertSorted(proto_->mutable_version_to_original_version(),
+                 variableVersions.getVersionToOriginalVersionMap());
+  }
+
+  /// @brief Serialize `stmt` and annotate its nodes
+  ///
+  /// @param function   Stencil function instantiation the statement belongs to (if any)
+  NodeIndex setStatement(iir::proto::Statement* statementProto, const std::shared_ptr<Stmt>& stmt,
+                         const StencilFunctionInstantiation* function) {
+    setStmt(statementProto->mutable_stmt(), stmt);
+
+    NodeIndex index(stmt);
+    for(int i = 0; i < index.size(); ++i) {
+      if(const auto& node = index.getStmt(i)) {
+        auto accessIt = instantiation_->getStmtToAccessIDMap().find(node);
+        if(accessIt != instantiation_->getStmtToAccessIDMap().end())
+          (*statementProto->mutable_access_ids())[i] = accessIt->second;
+
+        if(function) {
+          auto callerIt = function->getStmtToCallerAccessIDMap().find(node);
+          if(callerIt != function->getStmtToCallerAccessIDMap().end())
+            (*statementProto->mutable_caller_access_ids())[i] = callerIt->second;
+        }
+
+        if(auto stencilCall = dyn_pointer_cast<StencilCallDeclStmt>(node)) {
+          auto stencilIt = instantiation_->getStencilCallToStencilIDMap().find(stencilCall);
+          if(stencilIt != instantiation_->getStencilCallToStencilIDMap().end())
+            (*statementProto->mutable_stencil_ids())[i] = stencilIt->second;
+        }
+      } else {
+        const auto& expr = index.getExpr(i);
+        auto accessIt = instantiation_->getExprToAccessIDMap().find(expr);
+        if(accessIt != instantiation_->getExprToAccessIDMap().end())
+          (*statementProto->mutable_access_ids())[i] = accessIt->second;
+
+        if(function) {
+          auto callerIt = function->getExprToCallerAccessIDMap().find(expr);
+          if(callerIt != function->getExprToCallerAccessIDMap().end())
+            (*statementProto->mutable_caller_access_ids())[i] = callerIt->second;
+        }
+
+        auto functionIt = callToFunctionIndex_.find(expr.get());
+        if(functionIt != callToFunctionIndex_.end())
+          (*statementProto->mutable_stencil_function_instantiations())[i] = functionIt->second;
+      }
+    }
+    return index;
+  }
+
+  /// @brief Serialize the statement accesses pair
+  ///
+  /// The statement is referenced by its node index if it is part of the `enclosing` statement.
+  void setStatementAccessesPair(iir::proto::StatementAccessesPair* pairProto,
+                                const std::shared_ptr<StatementAccessesPair>& pair,
+                                const NodeIndex* enclosing,
+                                const StencilFunctionInstantiation* function) {
+    const auto& stmt = pair->getStatement()->ASTStmt;
+
+    std::unique_ptr<NodeIndex> ownIndex;
+    int nodeIndex = enclosing ? enclosing->getIndexOfStmt(stmt.get()) : -1;
+    if(nodeIndex != -1) {
+      pairProto->set_node_index(nodeIndex);
+    } else {
+      ownIndex =
+          make_unique<NodeIndex>(setStatement(pairProto->mutable_statement(), stmt, function));
+      enclosing = ownIndex.get();
+    }
+
+    if(pair->getCallerAccesses())
+      setAccesses(pairProto->mutable_caller_accesses(), pair->getCallerAccesses());
+    if(pair->getCalleeAccesses())
+      setAccesses(pairProto->mutable_callee_accesses(), pair->getCalleeAccesses());
+
+    for(const auto& child : pair->getChildren())
+      setStatementAccessesPair(pairProto->add_children(), child, enclosing, function);
+  }
+
+  void
+  setStencilFunctionInstantiation(iir::proto::StencilFunctionInstantiation* functionProto,
+                                  const std::shared_ptr<StencilFunctionInstantiation>& function) {
+    setStencilFunction(functionProto->mutable_function(), function->getStencilFunction().get());
+    setExpr(functionProto->mutable_expr(), function->getExpression());
+
+    // Find the owner of the instantiation
+    int caller = -2;
+    for(const auto& callFunctionPair : instantiation_->getExprToStencilFunctionInstantiationMap())
+      if(callFunctionPair.second == function)
+        caller = -1;
+    for(const auto& other : instantiation_->getStencilFunctionInstantiations()) {
+      if(caller != -2)
+        break;
+      for(const auto& callFunctionPair : other->getExprToStencilFunctionInstantiationMap())
+        if(callFunctionPair.second == function)
+          caller = functionToIndex_.at(other.get());
+    }
+    functionProto->set_caller(caller);
+
+    setInterval(functionProto->mutable_interval(), function->getInterval());
+    functionProto->set_has_return(function->hasReturn());
+    functionProto->set_is_nested(function->isNested());
+    functionProto->set_args_bound(function->isArgsBound());
+
+    for(int argIdx = 0; argIdx < function->getArguments().size(); ++argIdx) {
+      if(function->isArgBoundAsFieldAccess(argIdx))
+        (*functionProto->mutable_argument_index_to_caller_access_id())[argIdx] =
+            function->getCallerAccessIDOfArgField(argIdx);
+      if(function->isArgBoundAsFunctionInstantiation(argIdx))
+        (*functionProto->mutable_argument_index_to_stencil_function_instantiation())[argIdx] =
+            functionToIndex_.at(function->getFunctionInstantiationOfArgField(argIdx).get());
+      if(function->isArgBoundAsDirection(argIdx))
+        (*functionProto->mutable_argument_index_to_caller_direction())[argIdx] =
+            function->getCallerDimensionOfArgDirection(argIdx);
+      if(function->isArgBoundAsOffset(argIdx)) {
+        const Array2i& offset = function->getCallerOffsetOfArgOffset(argIdx);
+        auto& offsetProto = (*functionProto->mutable_argument_index_to_caller_offset())[argIdx];
+        offsetProto.set_dimension(offset[0]);
+        offsetProto.set_offset(offset[1]);
+      }
+    }
+
+    for(const auto& accessIDOffsetPair : function->getCallerAccessIDToInitialOffsetMap()) {
+      auto& offsetProto =
+          (*functionProto->mutable_caller_access_id_to_initial_offset())[accessIDOffsetPair.first];
+      for(int offset : accessIDOffsetPair.second)
+        offsetProto.add_offset(offset);
+    }
+    for(int AccessID : function->getAccessIDSetProvidedByStencilFunctionCalls())
+      functionProto->add_provided_by_stencil_function_call(AccessID);
+
+    insertSorted(functionProto->mutable_access_id_to_name(), function->getAccessIDToNameMap());
+    insertSorted(functionProto->mutable_literal_access_id_to_name(),
+                 function->getLiteralAccessIDToNameMap());
+    for(int AccessID : function->getAccessIDSetGlobalVariables())
+      functionProto->add_global_variable_access_ids(AccessID);
+
+    NodeIndex astIndex =
+        setStatement(functionProto->mutable_ast(), function->getAST()->getRoot(), function.get());
+    for(const auto& pair : function->getStatementAccessesPairs())
+      setStatementAccessesPair(functionProto->add_statement_accesses_pairs(), pair, &astIndex,
+                               function.get());
+  }
+
+  void setStencil(iir::proto::Stencil* stencilProto, const std::shared_ptr<Stencil>& stencil) {
+    stencilProto->set_stencil_id(stencil->getStencilID());
+
+    for(const auto& multiStage : stencil->getMultiStages()) {
+      auto multiStageProto = stencilProto->add_multi_stages();
+      multiStageProto->set_loop_order(
+          static_cast<iir::proto::MultiStage::LoopOrder>(multiStage->getLoopOrder()));
+
+      for(const auto& stage : multiStage->getStages()) {
+        auto stageProto = multiStageProto->add_stages();
+        stageProto->set_stage_id(stage->getStageID());
+        setExtents(stageProto->mutable_extents(), stage->getExtents());
+        for(const Field& field : stage->getFields())
+          stageProto->add_field_access_ids(field.getAccessID());
+
+        for(const auto& doMethod : stage->getDoMethods()) {
+          auto doMethodProto = stageProto->add_do_methods();
+          setInterval(doMethodProto->mutable_interval(), doMethod->getInterval());
+          for(const auto& pair : doMethod->getStatementAccessesPairs())
+            setStatementAccessesPair(doMethodProto->add_statement_accesses_pairs(), pair, nullptr,
+                                     nullptr);
+        }
+      }
+
+      for(const auto& accessIDCachePair : sorted(multiStage->getCaches())) {
+        const Cache& cache = accessIDCachePair.second;
+        auto cacheProto = multiStageProto->add_caches();
+        cacheProto->set_access_id(cache.getCachedFieldAccessID());
+        cacheProto->set_type(static_cast<iir::proto::Cache::CacheType>(cache.getCacheType()));
+        cacheProto->set_policy(
+            static_cast<iir::proto::Cache::CacheIOPolicy>(cache.getCacheIOPolicy()));
+        if(cache.getInterval())
+          setInterval(cacheProto->mutable_interval(), *cache.getInterval());
+        if(cache.getWindow())
+          cacheProto->set_window(*cache.getWindow());
+      }
+    }
+  }
+
+  void setBoundaryConditions(const std::vector<NodeIndex>& descIndices) {
+    // Position of a statement in the stencil description statements (or {-1, -1} if it is not
+    // part of them)
+    auto getDescPosition = [&](const std::shared_ptr<BoundaryConditionDeclStmt>& bc) {
+      for(int i = 0; i < descIndices.size(); ++i) {
+        int nodeIndex = descIndices[i].getIndexOfStmt(bc.get());
+        if(nodeIndex != -1)
+          return std::make_pair(i, nodeIndex);
+      }
+      return std::make_pair(-1, -1);
+    };
+
+    // The same boundary condition can be applied to several fields. The identity of the statement
+    // matters as the extents are looked up by the statement.
+    std::unordered_map<const BoundaryConditionDeclStmt*, int> bcToIndex;
+    auto getBoundaryConditionIndex = [&](const std::shared_ptr<BoundaryConditionDeclStmt>& bc) {
+      auto it = bcToIndex.find(bc.get());
+      if(it != bcToIndex.end())
+        return it->second;
+
+      int bcIndex = proto_->boundary_conditions_size();
+      bcToIndex.emplace(bc.get(), bcIndex);
+      auto bcProto = proto_->add_boundary_conditions();
+
+      auto extentsIt = instantiation_->getBoundaryConditionToExtentsMap().find(bc);
+      if(extentsIt != instantiation_->getBoundaryConditionToExtentsMap().end())
+        setExtents(bcProto->mutable_extents(), extentsIt->second);
+
+      auto position = getDescPosition(bc);
+      if(position.first != -1) {
+        bcProto->mutable_node()->set_statement_index(position.first);
+        bcProto->mutable_node()->set_node_index(position.second);
+      } else
+        setStmt(bcProto->mutable_stmt(), bc);
+      return bcIndex;
+    };
+
+    for(const auto& fieldBCPair : sorted(instantiation_->getBoundaryConditions())) {
+      auto fieldBCProto = proto_->add_field_boundary_conditions();
+      fieldBCProto->set_field_name(fieldBCPair.first);
+      fieldBCProto->set_boundary_condition(getBoundaryConditionIndex(fieldBCPair.second));
+    }
+
+    // The extents map is keyed by pointer, its entries are sorted by their position in the stencil
+    // description (followed by the statements which are not part of it, sorted by functor and
+    // fields)
+    auto getSortKey = [&](const std::shared_ptr<BoundaryConditionDeclStmt>& bc) {
+      auto position = getDescPosition(bc);
+      std::vector<std::string> names{bc->getFunctor()};
+      for(const auto& field : bc->getFields())
+        names.push_back(field->Name);
+      return std::make_tuple(position.first == -1, position, names);
+    };
+    std::vector<std::shared_ptr<BoundaryConditionDeclStmt>> bcsWithExtents;
+    for(const auto& bcExtentsPair : instantiation_->getBoundaryConditionToExtentsMap())
+      bcsWithExtents.push_back(bcExtentsPair.first);
+    std::stable_sort(bcsWithExtents.begin(), bcsWithExtents.end(),
+                     [&](const std::shared_ptr<BoundaryConditionDeclStmt>& a,
+                         const std::shared_ptr<BoundaryConditionDeclStmt>& b) {
+                       return getSortKey(a) < getSortKey(b);
+                     });
+    for(const auto& bc : bcsWithExtents)
+      getBoundaryConditionIndex(bc);
+
+    for(int i = 0; i < instantiation_->getStencils().size(); ++i) {
+      const auto& multiStages = instantiation_->getStencils()[i]->getMultiStages();
+      auto multiStageIt = multiStages.begin();
+      for(auto& multiStageProto : *proto_->mutable_stencils(i)->mutable_multi_stages()) {
+        auto stageIt = (*multiStageIt++)->getStages().begin();
+        for(auto& stageProto : *multiStageProto.mutable_stages())
+          for(const auto& bc : (*stageIt++)->getBoundaryConditions())
+            stageProto.add_boundary_conditions(getBoundaryConditionIndex(bc));
+      }
+    }
+  }
+};
+
+static std::string serializeImpl(const OptimizerContext* context,
+                                 IIRSerializer::SerializationKind kind) {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+  ProtobufLogger::init();
+
+  // Convert the IIR to protobuf
+  iir::proto::IIR iirProto;
+  setSIR(iirProto.mutable_sir(), context->getSIR().get());
+  for(const auto& nameInstantiationPair : context->getStencilInstantiationMap())
+    IIRBuilder(nameInstantiationPair.second.get(), iirProto.add_stencil_instantiations()).build();
+
+  // Encode the message
+  std::string str;
+  switch(kind) {
+  case dawn::IIRSerializer::SK_Json: {
+    google::protobuf::util::JsonPrintOptions options;
+    options.add_whitespace = true;
+    options.always_print_primitive_fields = true;
+    options.preserve_proto_field_names = true;
+    auto status = google::protobuf::util::MessageToJsonString(iirProto, &str, options);
+    if(!status.ok())
+      throw std::runtime_error(format("cannot serialize IIR: %s", status.ToString()));
+    break;
+  }
+  case dawn::IIRSerializer::SK_Byte: {
+    google::protobuf::io::StringOutputStream outputStream(&str);
+    google::protobuf::io::CodedOutputStream codedStream(&outputStream);
+    codedStream.SetSerializationDeterministic(true);
+    if(!iirProto.SerializeToCodedStream(&codedStream))
+      throw std::runtime_error(dawn::format(
+          "cannot serialize IIR: %s", ProtobufLogger::getInstance().getErrorMessagesAndReset()));
+    break;
+  }
+  default:
+    dawn_unreachable("invalid SerializationKind");
+  }
+
+  return str;
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Deserialization
+//===------------------------------------------------------------------------------------------===//
+
+static Interval makeInterval(const iir::proto::Interval& intervalProto) {
+  return Interval(intervalProto.lower_level(), intervalProto.upper_level(),
+                  intervalProto.lower_offset(), intervalProto.upper_offset());
+}
+
+static Extents makeExtents(const iir::proto::Extents& extentsProto) {
+  if(extentsProto.extents_size() != 3)
+    throw std::runtime_error(
+        format("invalid extents: expected 3 dimensions, got %i", extentsProto.extents_size()));
+  const auto& e = extentsProto.extents();
+  return Extents(e[0].minus(), e[0].plus(), e[1].minus(), e[1].plus(), e[2].minus(), e[2].plus());
+}
+
+static std::shared_ptr<Accesses> makeAccesses(const iir::proto::Accesses& accessesProto) {
+  auto accesses = std::make_shared<Accesses>();
+  for(const auto& accessProto : accessesProto.read_accesses())
+    accesses->addReadExtent(accessProto.access_id(), makeExtents(accessProto.extents()));
+  for(const auto& accessProto : accessesProto.write_accesses())
+    accesses->addWriteExtent(accessProto.access_id(), makeExtents(accessProto.extents()));
+  return accesses;
+}
+
+/// @brief Rebuild a single StencilInstantiation from protobuf
+class IIRLoader {
+  const iir::proto::StencilInstantiation& proto_;
+  std::shared_ptr<StencilInstantiation> instantiation_;
+  std::vector<std::shared_ptr<StencilFunctionInstantiation>> functions_;
+
+public:
+  IIRLoader(const iir::proto::StencilInstantiation& proto) : proto_(proto) {}
+
+  std::shared_ptr<StencilInstantiation> load(OptimizerContext* context) {
+    const auto& SIR = context->getSIR();
+    auto sirStencilIt = std::find_if(
+        SIR->Stencils.begin(), SIR->Stencils.end(),
+        [&](const std::shared_ptr<sir::Stencil>& s) { return s->Name == proto_.stencil_name(); });
+    if(sirStencilIt == SIR->Stencils.end())
+      throw std::runtime_error(
+          format("stencil '%s' does not exist in the SIR", proto_.stencil_name()));
+
+    instantiation_ = std::make_shared<StencilInstantiation>(context, *sirStencilIt, SIR, false);
+    loadTables();
+
+    // Stencil function instantiations can reference each other, create all of them first
+    for(const auto& functionProto : proto_.stencil_function_instantiations())
+      functions_.emplace_back(makeStencilFunctionInstantiation(functionProto));
+    for(int i = 0; i < functions_.size(); ++i)
+      loadStencilFunctionInstantiation(proto_.stencil_function_instantiations(i), functions_[i]);
+
+    for(const auto& stencilProto : proto_.stencils())
+      instantiation_->getStencils().emplace_back(makeStencil(stencilProto));
+
+    std::vector<NodeIndex> descIndices;
+    for(const auto& statementProto : proto_.stencil_desc_statements()) {
+      std::shared_ptr<Stmt> stmt = makeStmt(statementProto.stmt());
+      descIndices.emplace_back(loadStatement(statementProto, stmt, nullptr));
+      instantiation_->getStencilDescStatements().emplace_back(
+          std::make_shared<Statement>(stmt, nullptr));
+    }
+
+    std::vector<std::shared_ptr<BoundaryConditionDeclStmt>> bcs =
+        loadBoundaryConditions(descIndices);
+
+    // Register the stencil function instantiations (now that all call expressions are known) and
+    // recompute the fields of the functions and stages
+    for(int i = 0; i < functions_.size(); ++i) {
+      int caller = proto_.stencil_function_instantiations(i).caller();
+      if(caller == -1)
+        instantiation_->insertExprToStencilFunction(functions_[i]);
+      else if(caller >= 0)
+        getFunction(caller)->insertExprToStencilFunction(functions_[i]);
+      instantiation_->getStencilFunctionInstantiations().push_back(functions_[i]);
+    }
+    for(const auto& function : functions_)
+      function->update();
+
+    for(int i = 0; i < proto_.stencils_size(); ++i) {
+      const auto& stencilProto = proto_.stencils(i);
+      auto multiStageIt = instantiation_->getStencils()[i]->getMultiStages().begin();
+      for(const auto& multiStageProto : stencilProto.multi_stages()) {
+        auto stageIt = (*multiStageIt++)->getStages().begin();
+        for(const auto& stageProto : multiStageProto.stages()) {
+          for(int bcIndex : stageProto.boundary_conditions()) {
+            if(bcIndex < 0 || bcIndex >= bcs.size())
+              throw std::runtime_error(format("invalid boundary condition index %i", bcIndex));
+            (*stageIt)->getBoundaryConditions().push_back(bcs[bcIndex]);
+          }
+          loadStageFields(stageProto, *stageIt++);
+        }
+      }
+    }
+
+    return instantiation_;
+  }
+
+private:
+  const std::shared_ptr<StencilFunctionInstantiation>& getFunction(int index) const {
+    if(index < 0 || index >= functions_.size())
+      throw std::runtime_error(format("invalid stencil function instantiation index %i", index));
+    return functions_[index];
+  }
+
+  /// @brief Recompute the fields of the stage and restore their order
+  void loadStageFields(const iir::proto::Stage& stageProto, const std::shared_ptr<Stage>& stage) {
+    stage->update();
+
+    std::unordered_map<int, int> position;
+    for(int i = 0; i < stageProto.field_access_ids_size(); ++i)
+      position.emplace(stageProto.field_access_ids(i), i);
+    auto getPosition = [&](const Field& field) {
+      auto it = position.find(field.getAccessID());
+      return it != position.end() ? it->second : static_cast<int>(position.size());
+    };
+    std::stable_sort(
+        stage->getFields().begin(), stage->getFields().end(),
+        [&](const Field& a, const Field& b) { return getPosition(a) < getPosition(b); });
+  }
+
+  void loadTables() {
+    instantiation_->getUIDGenerator().reset(proto_.next_uid());
+
+    for(const auto& pair : sorted(proto_.access_id_to_name()))
+      instantiation_->getAccessIDToNameMap().emplace(pair);
+    for(const auto& pair : sorted(proto_.name_to_access_id()))
+      instantiation_->getNameToAccessIDMap().emplace(pair);
+    for(const auto& pair : sorted(proto_.literal_access_id_to_name()))
+      instantiation_->getLiteralAccessIDToNameMap().emplace(pair);
+    for(const auto& pair : sorted(proto_.stage_id_to_name()))
+      instantiation_->getStageIDToNameMap().emplace(pair);
+
+    instantiation_->getFieldAccessIDSet().insert(proto_.field_access_ids().begin(),
+                                                 proto_.field_access_ids().end());
+    instantiation_->getTemporaryFieldAccessIDSet().insert(
+        proto_.temporary_field_access_ids().begin(), proto_.temporary_field_access_ids().end());
+    instantiation_->getAllocatedFieldAccessIDSet().insert(
+        proto_.allocated_field_access_ids().begin(), proto_.allocated_field_access_ids().end());
+    instantiation_->getGlobalVariableAccessIDSet().insert(
+        proto_.global_variable_access_ids().begin(), proto_.global_variable_access_ids().end());
+    for(int AccessID : proto_.cached_variable_access_ids())
+      instantiation_->insertCachedVariable(AccessID);
+    for(const auto& pair : sorted(proto_.field_dimensions())) {
+      if(pair.second.dimensions_size() != 3)
+        throw std::runtime_error(format("invalid dimensions of field %i", pair.first));
+      std::copy(pair.second.dimensions().begin(), pair.second.dimensions().end(),
+                instantiation_->getFieldDimensionsMap()[pair.first].begin());
+    }
+
+    VariableVersions& variableVersions = instantiation_->getVariableVersions();
+    for(const auto& versionsProto : proto_.variable_versions()) {
+      auto versions = std::make_shared<std::vector<int>>(versionsProto.versions().begin(),
+                                                         versionsProto.versions().end());
+      for(int AccessID : versionsProto.access_ids())
+        variableVersions.insert(AccessID, versions);
+    }
+    variableVersions.getVersionToOriginalVersionMap().clear();
+    for(const auto& pair : sorted(proto_.version_to_original_version()))
+      variableVersions.getVersionToOriginalVersionMap().emplace(pair);
+  }
+
+  /// @brief Restore the annotations of the nodes of `stmt` (the deserialized statement of
+  /// `statementProto`)
+  NodeIndex loadStatement(const iir::proto::Statement& statementProto,
+                          const std::shared_ptr<Stmt>& stmt,
+                          const std::shared_ptr<StencilFunctionInstantiation>& function) {
+    NodeIndex index(stmt);
+    auto checkIndex = [&](int i) {
+      if(i < 0 || i >= index.size())
+        throw std::runtime_error(format("invalid node index %i", i));
+    };
+
+    for(const auto& pair : sorted(statementProto.access_ids())) {
+      checkIndex(pair.first);
+      if(const auto& node = index.getStmt(pair.first))
+        instantiation_->mapStmtToAccessID(node, pair.second);
+      else
+        instantiation_->mapExprToAccessID(index.getExpr(pair.first), pair.second);
+    }
+
+    if(!function && statementProto.caller_access_ids_size() != 0)
+      throw std::runtime_error("caller AccessIDs outside of a stencil function");
+    for(const auto& pair : sorted(statementProto.caller_access_ids())) {
+      checkIndex(pair.first);
+      if(const auto& node = index.getStmt(pair.first))
+        function->mapStmtToAccessID(node, pair.second);
+      else
+        function->mapExprToAccessID(index.getExpr(pair.first), pair.second);
+    }
+
+    for(const auto& pair : sorted(statementProto.stencil_function_instantiations())) {
+      checkIndex(pair.first);
+      auto call = dyn_pointer_cast<StencilFunCallExpr>(index.getExpr(pair.first));
+      if(!call)
+        throw std::runtime_error(format("node %i is not a stencil function call", pair.first));
+      getFunction(pair.second)->setExpression(call);
+    }
+
+    for(const auto& pair : sorted(statementProto.stencil_ids())) {
+      checkIndex(pair.first);
+      auto stencilCall = dyn_pointer_cast<StencilCallDeclStmt>(index.getStmt(pair.first));
+      if(!stencilCall)
+        throw std::runtime_error(format("node %i is not a stencil call", pair.first));
+      instantiation_->getStencilCallToStencilIDMap().emplace(stencilCall, pair.second);
+      instantiation_->getIDToStencilCallMap().emplace(pair.second, stencilCall);
+    }
+    return index;
+  }
+
+  std::shared_ptr<StatementAccessesPair>
+  makeStatementAccessesPair(const iir::proto::StatementAccessesPair& pairProto,
+                            const NodeIndex* enclosing,
+                            const std::shared_ptr<StencilFunctionInstantiation>& function) {
+    std::shared_ptr<Stmt> stmt;
+    std::unique_ptr<NodeIndex> ownIndex;
+    if(pairProto.has_statement()) {
+      stmt = makeStmt(pairProto.statement().stmt());
+      ownIndex = make_unique<NodeIndex>(loadStatement(pairProto.statement(), stmt, function));
+      enclosing = ownIndex.get();
+    } else {
+      if(!enclosing)
+        throw std::runtime_error("statement accesses pair without statement");
+      stmt = enclosing->getStmtChecked(pairProto.node_index());
+    }
+
+    auto pair = std::make_shared<StatementAccessesPair>(std::make_shared<Statement>(stmt, nullptr));
+    if(pairProto.has_caller_accesses())
+      pair->setCallerAccesses(makeAccesses(pairProto.caller_accesses()));
+    if(pairProto.has_callee_accesses())
+      pair->setCalleeAccesses(makeAccesses(pairProto.callee_accesses()));
+
+    for(const auto& childProto : pairProto.children())
+      pair->getChildren().emplace_back(makeStatementAccessesPair(childProto, enclosing, function));
+    return pair;
+  }
+
+  std::shared_ptr<StencilFunctionInstantiation>
+  makeStencilFunctionInstantiation(const iir::proto::StencilFunctionInstantiation& functionProto) {
+    auto call = dyn_pointer_cast<StencilFunCallExpr>(makeExpr(functionProto.expr()));
+    if(!call)
+      throw std::runtime_error("stencil function instantiation without call expression");
+
+    auto function = std::make_shared<StencilFunctionInstantiation>(
+        instantiation_.get(), call, makeStencilFunction(functionProto.function()), nullptr,
+        makeInterval(functionProto.interval()), functionProto.is_nested());
+    function->setReturn(functionProto.has_return());
+    function->setArgsBound(functionProto.args_bound());
+    return function;
+  }
+
+  void loadStencilFunctionInstantiation(
+      const iir::proto::StencilFunctionInstantiation& functionProto,
+      const std::shared_ptr<StencilFunctionInstantiation>& function) {
+    for(const auto& pair : sorted(functionProto.argument_index_to_caller_access_id()))
+      function->setCallerAccessIDOfArgField(pair.first, pair.second);
+    for(const auto& pair : sorted(functionProto.argument_index_to_stencil_function_instantiation()))
+      function->setFunctionInstantiationOfArgField(pair.first, getFunction(pair.second));
+    for(const auto& pair : sorted(functionProto.argument_index_to_caller_direction()))
+      function->setCallerDimensionOfArgDirection(pair.first, pair.second);
+    for(const auto& pair : sorted(functionProto.argument_index_to_caller_offset()))
+      function->setCallerOffsetOfArgOffset(
+          pair.first, Array2i{{pair.second.dimension(), pair.second.offset()}});
+
+    for(const auto& pair : sorted(functionProto.caller_access_id_to_initial_offset())) {
+      if(pair.second.offset_size() != 3)
+        throw std::runtime_error("invalid initial offset: expected 3 dimensions");
+      const auto& offset = pair.second.offset();
+      function->setCallerInitialOffsetFromAccessID(pair.first,
+                                                   Array3i{{offset[0], offset[1], offset[2]}});
+    }
+    for(int AccessID : functionProto.provided_by_stencil_function_call())
+      function->setIsProvidedByStencilFunctionCall(AccessID);
+
+    for(const auto& pair : sorted(functionProto.access_id_to_name()))
+      function->getAccessIDToNameMap().emplace(pair);
+    for(const auto& pair : sorted(functionProto.literal_access_id_to_name()))
+      function->getLiteralAccessIDToNameMap().emplace(pair);
+    for(int AccessID : functionProto.global_variable_access_ids())
+      function->setAccessIDOfGlobalVariable(AccessID);
+
+    auto root = dyn_pointer_cast<BlockStmt>(makeStmt(functionProto.ast().stmt()));
+    if(!root)
+      throw std::runtime_error("root of stencil function is not a block statement");
+    NodeIndex astIndex = loadStatement(functionProto.ast(), root, function);
+    function->getAST() = std::make_shared<AST>(root);
+
+    for(const auto& pairProto : functionProto.statement_accesses_pairs())
+      function->getStatementAccessesPairs().emplace_back(
+          makeStatementAccessesPair(pairProto, &astIndex, function));
+  }
+
+  std::shared_ptr<Stencil> makeStencil(const iir::proto::Stencil& stencilProto) {
+    auto stencil = std::make_shared<Stencil>(*instantiation_, instantiation_->getSIRStencil(),
+                                             stencilProto.stencil_id());
+
+    for(const auto& multiStageProto : stencilProto.multi_stages()) {
+      auto multiStage = std::make_shared<MultiStage>(
+          *instantiation_, static_cast<LoopOrderKind>(multiStageProto.loop_order()));
+
+      for(const auto& stageProto : multiStageProto.stages()) {
+        auto stage = std::make_shared<Stage>(*instantiation_, multiStage.get(),
+                                             stageProto.stage_id(),
+                                             Interval(sir::Interval::Start, sir::Interval::End));
+        stage->getDoMethods().clear();
+        stage->getExtents() = makeExtents(stageProto.extents());
+
+        for(const auto& doMethodProto : stageProto.do_methods()) {
+          auto doMethod =
+              make_unique<DoMethod>(stage.get(), makeInterval(doMethodProto.interval()));
+          for(const auto& pairProto : doMethodProto.statement_accesses_pairs())
+            doMethod->getStatementAccessesPairs().emplace_back(
+                makeStatementAccessesPair(pairProto, nullptr, nullptr));
+          stage->getDoMethods().emplace_back(std::move(doMethod));
+        }
+        multiStage->getStages().emplace_back(stage);
+      }
+
+      for(const auto& cacheProto : multiStageProto.caches()) {
+        boost::optional<Interval> interval;
+        if(cacheProto.has_interval())
+          interval = makeInterval(cacheProto.interval());
+        Cache& cache =
+            multiStage->getCaches()
+                .emplace(cacheProto.access_id(),
+                         Cache(static_cast<Cache::CacheTypeKind>(cacheProto.type()),
+                               static_cast<Cache::CacheIOPolicy>(cacheProto.policy()),
+                               cacheProto.access_id(), interval))
+                .first->second;
+        if(cacheProto.window() > 0)
+          cache.setWindow(cacheProto.window());
+      }
+      stencil->getMultiStages().emplace_back(multiStage);
+    }
+    return stencil;
+  }
+
+  std::vector<std::shared_ptr<BoundaryConditionDeclStmt>>
+  loadBoundaryConditions(const std::vector<NodeIndex>& descIndices) {
+    std::vector<std::shared_ptr<BoundaryConditionDeclStmt>> bcs;
+    for(const auto& bcProto : proto_.boundary_conditions()) {
+      std::shared_ptr<Stmt> stmt;
+      if(bcProto.has_node()) {
+        int statementIndex = bcProto.node().statement_index();
+        if(statementIndex < 0 || statementIndex >= descIndices.size())
+          throw std::runtime_error(format("invalid statement index %i", statementIndex));
+        stmt = descIndices[statementIndex].getStmtChecked(bcProto.node().node_index());
+      } else {
+        stmt = makeStmt(bcProto.stmt());
+      }
+
+      auto bc = dyn_pointer_cast<BoundaryConditionDeclStmt>(stmt);
+      if(!bc)
+        throw std::runtime_error("boundary condition is not a boundary condition statement");
+      if(bcProto.has_extents())
+        instantiation_->getBoundaryConditionToExtentsMap().emplace(bc,
+                                                                   makeExtents(bcProto.extents()));
+      bcs.push_back(bc);
+    }
+
+    for(const auto& fieldBCProto : proto_.field_boundary_conditions()) {
+      int bcIndex = fieldBCProto.boundary_condition();
+      if(bcIndex < 0 || bcIndex >= bcs.size())
+        throw std::runtime_error(format("invalid boundary condition index %i", bcIndex));
+      instantiation_->getBoundaryConditions().emplace(fieldBCProto.field_name(), bcs[bcIndex]);
+    }
+    return bcs;
+  }
+};
+
+/// @brief Decode the serialized IIR in the buffer `[data, data + size)` into `iirProto`
+static void parseIIRProto(const char* data, std::size_t size,
+                          IIRSerializer::SerializationKind kind, iir::proto::IIR* iirProto) {
+  switch(kind) {
+  case dawn::IIRSerializer::SK_Json: {
+    auto status = google::protobuf::util::JsonStringToMessage(std::string(data, size), iirProto);
+    if(!status.ok())
+      throw std::runtime_error(dawn::format("cannot deserialize IIR: %s", status.ToString()));
+    break;
+  }
+  case dawn::IIRSerializer::SK_Byte: {
+    if(size > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+      throw std::runtime_error("cannot deserialize IIR: buffer exceeds 2GB");
+
+    google::protobuf::io::ArrayInputStream inputStream(data, static_cast<int>(size));
+    if(!iirProto->ParseFromZeroCopyStream(&inputStream))
+      throw std::runtime_error(dawn::format(
+          "cannot deserialize IIR: %s", ProtobufLogger::getInstance().getErrorMessagesAndReset()));
+    break;
+  }
+  default:
+    dawn_unreachable("invalid SerializationKind");
+  }
+}
+
+static std::unique_ptr<OptimizerContext> deserializeImpl(const char* data, std::size_t size,
+                                                         DiagnosticsEngine& diagnostics,
+                                                         Options& options,
+                                                         IIRSerializer::SerializationKind kind) {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+  ProtobufLogger::init();
+
+  google::protobuf::Arena arena;
+  iir::proto::IIR& iirProto = *google::protobuf::Arena::CreateMessage<iir::proto::IIR>(&arena);
+  parseIIRProto(data, size, kind, &iirProto);
+
+  // Convert protobuf IIR to IIR
+  try {
+    auto context =
+        make_unique<OptimizerContext>(diagnostics, options, makeSIR(iirProto.sir()), false);
+    for(const auto& instantiationProto : iirProto.stencil_instantiations())
+      context->getStencilInstantiationMap().emplace(
+          instantiationProto.stencil_name(), IIRLoader(instantiationProto).load(context.get()));
+    return context;
+  } catch(std::runtime_error& error) {
+    throw std::runtime_error(dawn::format("cannot deserialize IIR: %s", error.what()));
+  }
+}
+
+} // anonymous namespace
+
+void IIRSerializer::serialize(const std::string& file, const OptimizerContext* context,
+                              SerializationKind kind) {
+  std::ofstream ofs(file);
+  if(!ofs.is_open())
+    throw std::runtime_error(format("cannot serialize IIR: failed to open file \"%s\"", file));
+
+  auto str = serializeImpl(context, kind);
+  std::copy(str.begin(), str.end(), std::ostreambuf_iterator<char>(ofs));
+}
+
+std::string IIRSerializer::serializeToString(const OptimizerContext* context,
+                                             SerializationKind kind) {
+  return serializeImpl(context, kind);
+}
+
+std::unique_ptr<OptimizerContext> IIRSerializer::deserialize(const std::string& file,
+                                                             DiagnosticsEngine& diagnostics,
+                                                             Options& options,
+                                                             SerializationKind kind) {
+  std::unique_ptr<MappedFile> mappedFile;
+  try {
+    mappedFile = make_unique<MappedFile>(file);
+  } catch(std::runtime_error& error) {
+    throw std::runtime_error(dawn::format("cannot deserialize IIR: %s", error.what()));
+  }
+  return deserializeImpl(mappedFile->data(), mappedFile->size(), diagnostics, options, kind);
+}
+
+std::unique_ptr<OptimizerContext> IIRSerializer::deserializeFromString(
+    const std::string& str, DiagnosticsEngine& diagnostics, Options& options,
+    SerializationKind kind) {
+  return deserializeImpl(str.data(), str.size(), diagnostics, options, kind);
+}
+
+} // namespace dawn
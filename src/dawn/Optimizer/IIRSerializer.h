@@ -0,0 +1,93 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_OPTIMIZER_IIRSERIALIZER_H
+#define DAWN_OPTIMIZER_IIRSERIALIZER_H
+
+#include <memory>
+#include <string>
+
+namespace dawn {
+
+class DiagnosticsEngine;
+class OptimizerContext;
+struct Options;
+
+/// @brief Serialize/Deserialize the optimized internal representation (IIR)
+///
+/// The IIR consists of the SIR and all StencilInstantiations of an `OptimizerContext` after the
+/// optimizer passes have been run (stencils, multi-stages, stages, Do-Methods, statements and their
+/// accesses, caches, extents, AccessID tables and stencil function instantiations). Reloading a
+/// serialized IIR yields a context which can be passed directly to the code generators, i.e the
+/// optimizer does not have to be run again.
+///
+/// The stack traces of the statements and the dependency graphs are not serialized.
+///
+/// @ingroup optimizer
+class IIRSerializer {
+public:
+  IIRSerializer() = delete;
+
+  /// @brief Type of serialization algorithm to use
+  enum SerializationKind {
+    SK_Json, ///< JSON serialization
+    SK_Byte  ///< Protobuf's internal byte format
+  };
+
+  /// @brief Deserialize the IIR from `file`
+  ///
+  /// @param file         Path the file
+  /// @param diagnostics  Diagnostics engine of the new context
+  /// @param options      Options of the new context
+  /// @param kind         The kind of serialization used in `file` (Json or Byte)
+  /// @throws std::excetpion    Failed to deserialize
+  /// @returns newly allocated OptimizerContext on success
+  static std::unique_ptr<OptimizerContext> deserialize(const std::string& file,
+                                                       DiagnosticsEngine& diagnostics,
+                                                       Options& options,
+                                                       SerializationKind kind = SK_Byte);
+
+  /// @brief Deserialize the IIR from the given Byte or JSON formatted `string`
+  ///
+  /// @param str          Byte or JSON string to deserializee
+  /// @param diagnostics  Diagnostics engine of the new context
+  /// @param options      Options of the new context
+  /// @param kind         The kind of serialization used in `str` (Json or Byte)
+  /// @throws std::excetpion    Failed to deserialize
+  /// @returns newly allocated OptimizerContext on success
+  static std::unique_ptr<OptimizerContext> deserializeFromString(const std::string& str,
+                                                                 DiagnosticsEngine& diagnostics,
+                                                                 Options& options,
+                                                                 SerializationKind kind = SK_Byte);
+
+  /// @brief Serialize the IIR of `context` as a Json or Byte formatted string to `file`
+  ///
+  /// @param file     Path the file
+  /// @param context  Context of the optimized StencilInstantiations
+  /// @param kind     The kind of serialization to use to write to `file` (Json or Byte)
+  /// @throws std::excetpion    Failed to open `file`
+  static void serialize(const std::string& file, const OptimizerContext* context,
+                        SerializationKind kind = SK_Byte);
+
+  /// @brief Serialize the IIR of `context` as a Json or Byte formatted string
+  ///
+  /// @param context  Context of the optimized StencilInstantiations
+  /// @param kind     The kind of serialization to use when writing to the string (Json or Byte)
+  static std::string serializeToString(const OptimizerContext* context,
+                                       SerializationKind kind = SK_Byte);
+};
+
+} // namespace dawn
+
+#endif
@@ -18,21 +18,35 @@
 #include "dawn/SIR/SIR.h"
 #include "dawn/Support/Logging.h"
 #include "dawn/Support/STLExtras.h"
+#include "dawn/Support/StringUtil.h"
+#include <algorithm>
 
 namespace dawn {
 
 OptimizerContext::OptimizerContext(DiagnosticsEngine& diagnostics, Options& options,
-                                   const std::shared_ptr<SIR>& SIR)
+                                   const std::shared_ptr<SIR>& SIR, bool instantiateStencils)
     : diagnostics_(diagnostics), options_(options), SIR_(SIR) {
   DAWN_LOG(INFO) << "Intializing OptimizerContext ... ";
+  if(!instantiateStencils)
+    return;
 
-  for(const auto& stencil : SIR_->Stencils)
+  // -stencils
+  std::vector<std::string> selectedStencils = splitList(options_.Stencils);
+
+  for(const auto& name : SIR_->getStencilNames()) {
+    if(!selectedStencils.empty() &&
+       std::find(selectedStencils.begin(), selectedStencils.end(), name) == selectedStencils.end())
+      continue;
+
+    // Only the stencils which are compiled (and the stencils they call) are materialized
+    std::shared_ptr<sir::Stencil> stencil = SIR_->getStencil(name);
     if(!stencil->Attributes.has(sir::Attr::AK_NoCodeGen)) {
       stencilInstantiationMap_.insert(std::make_pair(
           stencil->Name, std::make_shared<StencilInstantiation>(this, stencil, SIR)));
     } else {
       DAWN_LOG(INFO) << "Skipping processing of `" << stencil->Name << "`";
     }
+  }
 }
 
 std::map<std::string, std::shared_ptr<StencilInstantiation>>&
@@ -51,8 +51,11 @@ class OptimizerContext : NonCopyable {
 
 public:
   /// @brief Initialize the context with a SIR
+  ///
+  /// If `instantiateStencils` is `false`, no StencilInstantiations are created (they are inserted
+  /// later on, e.g by the `IIRSerializer`).
   OptimizerContext(DiagnosticsEngine& diagnostics, Options& options,
-                   const std::shared_ptr<SIR>& SIR);
+                   const std::shared_ptr<SIR>& SIR, bool instantiateStencils = true);
 
   /// @brief Get StencilInstantiation map
   std::map<std::string, std::shared_ptr<StencilInstantiation>>& getStencilInstantiationMap();
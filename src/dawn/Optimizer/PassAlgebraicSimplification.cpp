@@ -0,0 +1,579 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/PassAlgebraicSimplification.h"
+#include "dawn/Optimizer/AccessComputation.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/StatementAccessesPair.h"
+#include "dawn/Optimizer/Stencil.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/AST.h"
+#include "dawn/SIR/ASTUtil.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/Support/Casting.h"
+#include "dawn/Support/StringRef.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Kinds of rewrites (the counts are reported with `-report-pass-algebraic-simplification`)
+enum RewriteKind {
+  RK_Identity,           ///< `-(-x)`, `+x`, `x * 1`, `x / 1`, `x - 0`
+  RK_PowerOfTwoDivision, ///< `x / 2^n` to `x * 2^-n`
+  RK_TrivialPower,       ///< `pow(x, 1)` and `pow(x, 0)`
+  RK_Reciprocal,         ///< `x / c` to `x * (1 / c)` (fast-math)
+  RK_SharedReciprocal,   ///< Repeated divisions by the same field (fast-math)
+  RK_PowerExpansion,     ///< `pow(f, n)` to multiplications (fast-math)
+  RK_Factorization,      ///< `a * b + a * c` to `a * (b + c)` (fast-math)
+  RK_SqrtPow,            ///< Special cases of `sqrt` and `pow` (fast-math)
+  RK_NumRewriteKinds
+};
+
+const char* RewriteKindNames[RK_NumRewriteKinds] = {"identities",
+                                                    "power-of-two divisions",
+                                                    "trivial powers",
+                                                    "reciprocals",
+                                                    "shared reciprocals",
+                                                    "expanded powers",
+                                                    "factorizations",
+                                                    "sqrt/pow special cases"};
+
+/// @brief Largest exponent of `pow` which is expanded into multiplications
+const int MaxExpandedExponent = 8;
+
+/// @brief Name of the function `callee` without its namespace (e.g `pow` for `math::pow`)
+StringRef getUnqualifiedName(const std::string& callee) {
+  std::size_t pos = callee.rfind("::");
+  return pos == std::string::npos ? StringRef(callee) : StringRef(callee).substr(pos + 2);
+}
+
+/// @brief Name of the function `name` in the namespace of `callee` (e.g `math::sqrt` for
+/// `math::pow`)
+std::string getSiblingName(const std::string& callee, const std::string& name) {
+  std::size_t pos = callee.rfind("::");
+  return pos == std::string::npos ? name : callee.substr(0, pos + 2) + name;
+}
+
+/// @brief Get the value of the (signed) literal `expr`
+///
+/// @returns `false` if `expr` is not a literal
+bool getConstant(const std::shared_ptr<Expr>& expr, double& value, BuiltinTypeID& type) {
+  const Expr* literal = expr.get();
+  if(const UnaryOperator* op = dyn_cast<UnaryOperator>(literal))
+    if(StringRef(op->getOp()) == "-" || StringRef(op->getOp()) == "+")
+      literal = op->getOperand().get();
+  if(!isa<LiteralAccessExpr>(literal))
+    return false;
+
+  type = cast<LiteralAccessExpr>(literal)->getBuiltinType();
+  return (type == BuiltinTypeID::Integer || type == BuiltinTypeID::Float) &&
+         evalExprAsDouble(expr, value) && std::isfinite(value);
+}
+
+/// @brief Check if `expr` is a floating point expression (conservatively, the types of local
+/// variables are unknown)
+bool isFloatExpr(const Expr* expr) {
+  switch(expr->getKind()) {
+  case Expr::EK_FieldAccessExpr:
+  case Expr::EK_FunCallExpr:
+    return true;
+  case Expr::EK_LiteralAccessExpr:
+    return cast<LiteralAccessExpr>(expr)->getBuiltinType() == BuiltinTypeID::Float;
+  case Expr::EK_UnaryOperator: {
+    const UnaryOperator* op = cast<UnaryOperator>(expr);
+    StringRef opStr(op->getOp());
+    return (opStr == "-" || opStr == "+") && isFloatExpr(op->getOperand().get());
+  }
+  case Expr::EK_BinaryOperator: {
+    const BinaryOperator* op = cast<BinaryOperator>(expr);
+    StringRef opStr(op->getOp());
+    return (opStr == "+" || opStr == "-" || opStr == "*" || opStr == "/") &&
+           (isFloatExpr(op->getLeft().get()) || isFloatExpr(op->getRight().get()));
+  }
+  case Expr::EK_TernaryOperator: {
+    const TernaryOperator* op = cast<TernaryOperator>(expr);
+    return isFloatExpr(op->getLeft().get()) || isFloatExpr(op->getRight().get());
+  }
+  default:
+    return false;
+  }
+}
+
+/// @brief Check if `expr` is the literal `value` and removing it does not change the type of the
+/// expression it is applied to (`other`)
+bool isNeutralConstant(const std::shared_ptr<Expr>& expr, double value, const Expr* other) {
+  double constant;
+  BuiltinTypeID type;
+  return getConstant(expr, constant, type) && constant == value &&
+         (type == BuiltinTypeID::Integer || isFloatExpr(other));
+}
+
+/// @brief Check if `a` and `b` compute the same value
+bool isSameValue(const std::shared_ptr<Expr>& a, const std::shared_ptr<Expr>& b) {
+  return a->equals(b.get()) && isPureExpr(a);
+}
+
+/// @brief Check if `expr` is a call of the function `name` with `numArgs` arguments
+FunCallExpr* getCall(const std::shared_ptr<Expr>& expr, const char* name, std::size_t numArgs) {
+  FunCallExpr* call = dyn_cast<FunCallExpr>(expr.get());
+  if(!call || getUnqualifiedName(call->getCallee()) != name ||
+     call->getArguments().size() != numArgs)
+    return nullptr;
+  return call;
+}
+
+/// @brief Get the right-hand side of a top-level statement (assignments and initializations of
+/// scalar variables) or NULL
+std::shared_ptr<Expr> getRHS(const std::shared_ptr<Stmt>& stmt) {
+  if(ExprStmt* exprStmt = dyn_cast<ExprStmt>(stmt.get())) {
+    if(AssignmentExpr* assignment = dyn_cast<AssignmentExpr>(exprStmt->getExpr().get()))
+      return assignment->getRight();
+  } else if(VarDeclStmt* varDecl = dyn_cast<VarDeclStmt>(stmt.get())) {
+    if(!varDecl->isArray() && varDecl->getInitList().size() == 1)
+      return varDecl->getInitList().front();
+  }
+  return nullptr;
+}
+
+/// @brief Simplify the expressions of the statements of the Do-Methods
+class AlgebraicSimplifier {
+  StencilInstantiation* instantiation_;
+  bool fastMath_;
+  std::array<int, RK_NumRewriteKinds> numRewrites_;
+
+  /// @brief Division of an expression by a field
+  struct Division {
+    std::shared_ptr<StatementAccessesPair> Pair; ///< Statement containing the division
+    std::shared_ptr<BinaryOperator> Expr;
+  };
+
+public:
+  AlgebraicSimplifier(StencilInstantiation* instantiation, bool fastMath)
+      : instantiation_(instantiation), fastMath_(fastMath) {
+    numRewrites_.fill(0);
+  }
+
+  const std::array<int, RK_NumRewriteKinds>& getNumRewrites() const { return numRewrites_; }
+
+  /// @brief Process the statements of `doMethod`
+  ///
+  /// @returns `true` if the Do-Method was modified
+  bool run(DoMethod& doMethod) {
+    bool modified = false;
+    for(const auto& pair : doMethod.getStatementAccessesPairs()) {
+      int numRewrites = getTotal();
+      const std::shared_ptr<Stmt>& root = pair->getStatement()->ASTStmt;
+      simplifyStmt(root, root);
+      if(numRewrites != getTotal()) {
+        computeAccesses(instantiation_, pair);
+        modified = true;
+      }
+    }
+
+    if(fastMath_)
+      modified |= shareReciprocals(doMethod);
+    return modified;
+  }
+
+private:
+  int getTotal() const {
+    int total = 0;
+    for(int numRewrites : numRewrites_)
+      total += numRewrites;
+    return total;
+  }
+
+  /// @brief Simplify the expressions of `stmt` (`root` is the top-level statement)
+  void simplifyStmt(const std::shared_ptr<Stmt>& root, const std::shared_ptr<Stmt>& stmt) {
+    switch(stmt->getKind()) {
+    case Stmt::SK_ExprStmt:
+      simplifyExpr(root, cast<ExprStmt>(stmt.get())->getExpr());
+      break;
+    case Stmt::SK_VarDeclStmt: {
+      std::vector<std::shared_ptr<Expr>> initList = cast<VarDeclStmt>(stmt.get())->getInitList();
+      for(const auto& expr : initList)
+        simplifyExpr(root, expr);
+      break;
+    }
+    case Stmt::SK_IfStmt:
+    case Stmt::SK_BlockStmt: {
+      std::vector<std::shared_ptr<Stmt>> children(stmt->getChildren().begin(),
+                                                  stmt->getChildren().end());
+      for(const auto& child : children)
+        simplifyStmt(root, child);
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  /// @brief Simplify `expr` bottom-up (`root` is the top-level statement)
+  void simplifyExpr(const std::shared_ptr<Stmt>& root, const std::shared_ptr<Expr>& expr) {
+    // The arguments are bound to the stencil function instantiation
+    if(isa<StencilFunCallExpr>(expr.get()))
+      return;
+
+    std::vector<std::shared_ptr<Expr>> children(expr->getChildren().begin(),
+                                                expr->getChildren().end());
+    for(const auto& child : children)
+      simplifyExpr(root, child);
+
+    RewriteKind kind;
+    if(std::shared_ptr<Expr> newExpr = rewrite(expr, kind)) {
+      replaceOldExprWithNewExprInStmt(root, expr, newExpr);
+      numRewrites_[kind]++;
+      simplifyExpr(root, newExpr);
+    }
+  }
+
+  /// @brief Rewrite `expr` (whose operands are already simplified)
+  ///
+  /// @returns the replacement of `expr` or NULL if no rewrite applies
+  std::shared_ptr<Expr> rewrite(const std::shared_ptr<Expr>& expr, RewriteKind& kind) {
+    switch(expr->getKind()) {
+    case Expr::EK_UnaryOperator:
+      return rewriteUnaryOperator(cast<UnaryOperator>(expr.get()), kind);
+    case Expr::EK_BinaryOperator:
+      return rewriteBinaryOperator(cast<BinaryOperator>(expr.get()), kind);
+    case Expr::EK_FunCallExpr:
+      return rewriteFunCall(cast<FunCallExpr>(expr.get()), kind);
+    default:
+      return nullptr;
+    }
+  }
+
+  std::shared_ptr<Expr> rewriteUnaryOperator(UnaryOperator* op, RewriteKind& kind) {
+    StringRef opStr(op->getOp());
+    const std::shared_ptr<Expr>& operand = op->getOperand();
+    kind = RK_Identity;
+
+    // -(-x) -> x
+    if(opStr == "-")
+      if(UnaryOperator* inner = dyn_cast<UnaryOperator>(operand.get()))
+        if(StringRef(inner->getOp()) == "-")
+          return inner->getOperand();
+
+    // +x -> x
+    if(opStr == "+" && isFloatExpr(operand.get()))
+      return operand;
+    return nullptr;
+  }
+
+  std::shared_ptr<Expr> rewriteBinaryOperator(BinaryOperator* op, RewriteKind& kind) {
+    StringRef opStr(op->getOp());
+    const std::shared_ptr<Expr>& left = op->getLeft();
+    const std::shared_ptr<Expr>& right = op->getRight();
+
+    kind = RK_Identity;
+    if(opStr == "*") {
+      // x * 1 -> x, 1 * x -> x
+      if(isNeutralConstant(right, 1.0, left.get()))
+        return left;
+      if(isNeutralConstant(left, 1.0, right.get()))
+        return right;
+
+      // sqrt(x) * sqrt(x) -> x
+      FunCallExpr* leftSqrt = getCall(left, "sqrt", 1);
+      FunCallExpr* rightSqrt = getCall(right, "sqrt", 1);
+      if(fastMath_ && leftSqrt && rightSqrt &&
+         isSameValue(leftSqrt->getArguments()[0], rightSqrt->getArguments()[0]) &&
+         isFloatExpr(leftSqrt->getArguments()[0].get())) {
+        kind = RK_SqrtPow;
+        return leftSqrt->getArguments()[0];
+      }
+    } else if(opStr == "/") {
+      // x / 1 -> x
+      if(isNeutralConstant(right, 1.0, left.get()))
+        return left;
+
+      // x / c -> x * (1 / c)
+      double divisor;
+      BuiltinTypeID type;
+      if(getConstant(right, divisor, type) && type == BuiltinTypeID::Float && divisor != 0.0) {
+        int exponent;
+        bool isPowerOfTwo = std::frexp(divisor, &exponent) == (divisor < 0 ? -0.5 : 0.5);
+        double reciprocal = 1.0 / divisor;
+        if((isPowerOfTwo || fastMath_) && std::isnormal(reciprocal)) {
+          kind = isPowerOfTwo ? RK_PowerOfTwoDivision : RK_Reciprocal;
+          return std::make_shared<BinaryOperator>(left, "*", makeLiteral(reciprocal));
+        }
+      }
+    } else if(opStr == "-") {
+      // x - 0 -> x
+      if(isNeutralConstant(right, 0.0, left.get()))
+        return left;
+    }
+
+    // a * b + a * c -> a * (b + c)
+    if(fastMath_ && (opStr == "+" || opStr == "-")) {
+      BinaryOperator* leftMul = dyn_cast<BinaryOperator>(left.get());
+      BinaryOperator* rightMul = dyn_cast<BinaryOperator>(right.get());
+      if(!leftMul || !rightMul || StringRef(leftMul->getOp()) != "*" ||
+         StringRef(rightMul->getOp()) != "*")
+        return nullptr;
+
+      kind = RK_Factorization;
+      for(bool commonOnLeft : {true, false}) {
+        const std::shared_ptr<Expr>& common =
+            commonOnLeft ? leftMul->getLeft() : leftMul->getRight();
+        const std::shared_ptr<Expr>& b = commonOnLeft ? leftMul->getRight() : leftMul->getLeft();
+        if(isSameValue(common, rightMul->getLeft()))
+          return factorize(common, b, opStr, rightMul->getRight(), commonOnLeft);
+        if(isSameValue(common, rightMul->getRight()))
+          return factorize(common, b, opStr, rightMul->getLeft(), commonOnLeft);
+      }
+    }
+    return nullptr;
+  }
+
+  /// @brief Build `common * (b op c)` (or `(b op c) * common`)
+  static std::shared_ptr<Expr> factorize(const std::shared_ptr<Expr>& common,
+                                         const std::shared_ptr<Expr>& b, StringRef op,
+                                         const std::shared_ptr<Expr>& c, bool commonOnLeft) {
+    auto sum = std::make_shared<BinaryOperator>(b, op.str(), c);
+    return commonOnLeft ? std::make_shared<BinaryOperator>(common, "*", sum)
+                        : std::make_shared<BinaryOperator>(sum, "*", common);
+  }
+
+  std::shared_ptr<Expr> rewriteFunCall(FunCallExpr* call, RewriteKind& kind) {
+    const std::string& callee = call->getCallee();
+
+    if(getUnqualifiedName(callee) == "pow" && call->getArguments().size() == 2) {
+      const std::shared_ptr<Expr>& base = call->getArguments()[0];
+      double exponent;
+      BuiltinTypeID type;
+      if(!getConstant(call->getArguments()[1], exponent, type))
+        return nullptr;
+
+      // pow(x, 1) -> x, pow(x, 0) -> 1
+      kind = RK_TrivialPower;
+      if(exponent == 1.0 && isFloatExpr(base.get()))
+        return base;
+      if(exponent == 0.0 && isPureExpr(base))
+        return makeLiteral(1.0);
+
+      if(!fastMath_)
+        return nullptr;
+
+      // pow(f, n) -> f * ... * f
+      FieldAccessExpr* field = dyn_cast<FieldAccessExpr>(base.get());
+      if(field && !field->hasArguments() && exponent == std::trunc(exponent) &&
+         std::fabs(exponent) <= MaxExpandedExponent && exponent != 0.0) {
+        kind = RK_PowerExpansion;
+        int n = static_cast<int>(std::fabs(exponent));
+        std::shared_ptr<Expr> product = base;
+        for(int i = 1; i < n; ++i)
+          product = std::make_shared<BinaryOperator>(product, "*", cloneAccess(base));
+        if(exponent < 0)
+          return std::make_shared<BinaryOperator>(makeLiteral(1.0), "/", product);
+        return product;
+      }
+
+      // pow(x, 0.5) -> sqrt(x), pow(x, -1) -> 1 / x
+      kind = RK_SqrtPow;
+      if(exponent == 0.5) {
+        auto sqrt = std::make_shared<FunCallExpr>(getSiblingName(callee, "sqrt"));
+        sqrt->insertArgument(base);
+        return sqrt;
+      }
+      if(exponent == -1.0)
+        return std::make_shared<BinaryOperator>(makeLiteral(1.0), "/", base);
+      return nullptr;
+    }
+
+    // sqrt(x * x) -> fabs(x)
+    if(fastMath_ && getUnqualifiedName(callee) == "sqrt" && call->getArguments().size() == 1) {
+      BinaryOperator* square = dyn_cast<BinaryOperator>(call->getArguments()[0].get());
+      if(square && StringRef(square->getOp()) == "*" &&
+         isSameValue(square->getLeft(), square->getRight())) {
+        kind = RK_SqrtPow;
+        auto fabs = std::make_shared<FunCallExpr>(getSiblingName(callee, "fabs"));
+        fabs->insertArgument(square->getLeft());
+        return fabs;
+      }
+    }
+    return nullptr;
+  }
+
+  /// @brief Replace repeated divisions by the same field within `doMethod` by a multiplication with
+  /// its reciprocal (computed once in a new local variable)
+  ///
+  /// @returns `true` if the Do-Method was modified
+  bool shareReciprocals(DoMethod& doMethod) {
+    auto& stmtAccessesPairs = doMethod.getStatementAccessesPairs();
+
+    // Group the divisions by the same field value, a group ends at the next write to the field
+    std::vector<std::vector<Division>> openGroups, groups;
+    for(std::size_t i = 0; i < stmtAccessesPairs.size(); ++i) {
+      std::vector<std::shared_ptr<BinaryOperator>> divisions;
+      if(std::shared_ptr<Expr> rhs = getRHS(stmtAccessesPairs[i]->getStatement()->ASTStmt))
+        collectDivisions(rhs, divisions);
+
+      for(const auto& division : divisions) {
+        auto groupIt = std::find_if(openGroups.begin(), openGroups.end(),
+                                    [&](const std::vector<Division>& group) {
+                                      return isSameDivisor(group.front().Expr, division);
+                                    });
+        if(groupIt == openGroups.end()) {
+          openGroups.emplace_back();
+          groupIt = std::prev(openGroups.end());
+        }
+        groupIt->push_back({stmtAccessesPairs[i], division});
+      }
+
+      const auto& writeAccesses = stmtAccessesPairs[i]->getAccesses()->getWriteAccesses();
+      for(auto groupIt = openGroups.begin(); groupIt != openGroups.end();) {
+        if(writeAccesses.count(getDivisorAccessID(groupIt->front().Expr))) {
+          groups.push_back(std::move(*groupIt));
+          groupIt = openGroups.erase(groupIt);
+        } else
+          ++groupIt;
+      }
+    }
+    std::move(openGroups.begin(), openGroups.end(), std::back_inserter(groups));
+
+    // The groups refer to the statements by pointer, inserting the reciprocals does not invalidate
+    // them
+    bool modified = false;
+    for(const auto& group : groups) {
+      if(group.size() < 2)
+        continue;
+
+      int AccessID = instantiation_->nextUID();
+      std::string name = StencilInstantiation::makeLocalVariablename("rcp", AccessID);
+      auto varDecl = std::make_shared<VarDeclStmt>(
+          Type(BuiltinTypeID::Float, CVQualifier::Const), name, 0, "=",
+          std::vector<std::shared_ptr<Expr>>{std::make_shared<BinaryOperator>(
+              makeLiteral(1.0), "/", cloneAccess(group.front().Expr->getRight()))});
+      instantiation_->setAccessIDNamePair(AccessID, name);
+      instantiation_->mapStmtToAccessID(varDecl, AccessID);
+
+      std::vector<std::shared_ptr<StatementAccessesPair>> modifiedPairs;
+      for(const Division& division : group) {
+        auto varAccess = std::make_shared<VarAccessExpr>(name);
+        instantiation_->mapExprToAccessID(varAccess, AccessID);
+
+        const auto& pair = division.Pair;
+        replaceOldExprWithNewExprInStmt(
+            pair->getStatement()->ASTStmt, division.Expr,
+            std::make_shared<BinaryOperator>(division.Expr->getLeft(), "*", varAccess));
+        if(modifiedPairs.empty() || modifiedPairs.back() != pair)
+          modifiedPairs.push_back(pair);
+      }
+
+      auto insertIt =
+          std::find(stmtAccessesPairs.begin(), stmtAccessesPairs.end(), group.front().Pair);
+      auto newPair = std::make_shared<StatementAccessesPair>(
+          std::make_shared<Statement>(varDecl, (*insertIt)->getStatement()->StackTrace));
+      modifiedPairs.push_back(newPair);
+      computeAccesses(instantiation_, modifiedPairs);
+      stmtAccessesPairs.insert(insertIt, newPair);
+
+      numRewrites_[RK_SharedReciprocal] += group.size();
+      modified = true;
+    }
+    return modified;
+  }
+
+  /// @brief Collect the divisions by a field in `expr` (outer divisions first)
+  static void collectDivisions(const std::shared_ptr<Expr>& expr,
+                               std::vector<std::shared_ptr<BinaryOperator>>& divisions) {
+    if(isa<StencilFunCallExpr>(expr.get()))
+      return;
+
+    if(auto op = std::dynamic_pointer_cast<BinaryOperator>(expr)) {
+      FieldAccessExpr* divisor = dyn_cast<FieldAccessExpr>(op->getRight().get());
+      if(StringRef(op->getOp()) == "/" && divisor && !divisor->hasArguments())
+        divisions.push_back(op);
+    }
+
+    for(const auto& child : expr->getChildren())
+      collectDivisions(child, divisions);
+  }
+
+  int getDivisorAccessID(const std::shared_ptr<BinaryOperator>& division) const {
+    return instantiation_->getAccessIDFromExpr(division->getRight());
+  }
+
+  bool isSameDivisor(const std::shared_ptr<BinaryOperator>& a,
+                     const std::shared_ptr<BinaryOperator>& b) const {
+    return getDivisorAccessID(a) == getDivisorAccessID(b) &&
+           a->getRight()->equals(b->getRight().get());
+  }
+
+  /// @brief Clone the field or variable access `expr` (the clone refers to the same AccessID)
+  std::shared_ptr<Expr> cloneAccess(const std::shared_ptr<Expr>& expr) {
+    std::shared_ptr<Expr> clone = expr->clone();
+    instantiation_->mapExprToAccessID(clone, instantiation_->getAccessIDFromExpr(expr));
+    return clone;
+  }
+
+  /// @brief Create a floating point literal holding `value`
+  std::shared_ptr<Expr> makeLiteral(double value) {
+    auto literal = std::make_shared<LiteralAccessExpr>(sir::Value(value).toString(),
+                                                       BuiltinTypeID::Float);
+    int AccessID = -instantiation_->nextUID();
+    instantiation_->getLiteralAccessIDToNameMap().emplace(AccessID, literal->getValue());
+    instantiation_->mapExprToAccessID(literal, AccessID);
+    return literal;
+  }
+};
+
+} // anonymous namespace
+
+PassAlgebraicSimplification::PassAlgebraicSimplification()
+    : Pass("PassAlgebraicSimplification") {}
+
+bool PassAlgebraicSimplification::run(
+    const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
+  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+  if(!context->getOptions().Simplify)
+    return true;
+
+  AlgebraicSimplifier simplifier(stencilInstantiation.get(), context->getOptions().FastMath);
+
+  for(auto& stencilPtr : stencilInstantiation->getStencils())
+    for(auto& multiStagePtr : stencilPtr->getMultiStages())
+      for(auto& stagePtr : multiStagePtr->getStages()) {
+        bool modified = false;
+        for(auto& doMethodPtr : stagePtr->getDoMethods())
+          modified |= simplifier.run(*doMethodPtr);
+        if(modified)
+          stagePtr->update();
+      }
+
+  if(context->getOptions().ReportPassAlgebraicSimplification) {
+    std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName() << ":";
+    const auto& numRewrites = simplifier.getNumRewrites();
+    int total = 0;
+    for(int kind = 0; kind < RK_NumRewriteKinds; ++kind) {
+      if(numRewrites[kind] == 0)
+        continue;
+      std::cout << (total == 0 ? " " : ", ") << RewriteKindNames[kind] << ": " << numRewrites[kind];
+      total += numRewrites[kind];
+    }
+    std::cout << (total == 0 ? " no rewrites\n" : "\n");
+  }
+
+  return true;
+}
+
+} // namespace dawn
@@ -0,0 +1,61 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_OPTIMIZER_PASSALGEBRAICSIMPLIFICATION_H
+#define DAWN_OPTIMIZER_PASSALGEBRAICSIMPLIFICATION_H
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief Simplify the arithmetic expressions of the Do-Methods and replace expensive operations by
+/// cheaper ones
+///
+/// The following rewrites preserve the result bit for bit and are always applied:
+///
+///   - `-(-x)`, `+x`, `x * 1`, `1 * x`, `x / 1` and `x - 0` become `x`
+///   - `x / c` becomes `x * (1 / c)` if `c` is a floating point power of two
+///   - `pow(x, 1)` becomes `x` and `pow(x, 0)` becomes `1`
+///
+/// Identities which would change the type of the expression (e.g `i * 1.0` with an integer `i`)
+/// are left alone. The following rewrites may change the rounding of the result and are only
+/// applied with `-fast-math`:
+///
+///   - `x / c` becomes `x * (1 / c)` for any floating point literal `c`
+///   - Repeated divisions by the same field within a Do-Method are replaced by a multiplication
+///     with its reciprocal, which is computed once in a new local variable (as long as the field
+///     is not written in between)
+///   - `pow(f, n)` with a field `f` and an integral exponent `|n| <= 8` is expanded into
+///     multiplications
+///   - `a * b + a * c` becomes `a * (b + c)` (and likewise for `-` and `a` on the right)
+///   - `pow(x, 0.5)` becomes `sqrt(x)`, `pow(x, -1)` becomes `1 / x`, `sqrt(x) * sqrt(x)` becomes
+///     `x` and `sqrt(x * x)` becomes `fabs(x)`
+///
+/// The pass runs after constant folding and before the elimination of common subexpressions. The
+/// bodies of stencil functions which are not inlined are left untouched.
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassAlgebraicSimplification : public Pass {
+public:
+  PassAlgebraicSimplification();
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) override;
+};
+
+} // namespace dawn
+
+#endif
@@ -0,0 +1,237 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/PassBoundaryConditionFusion.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/Stencil.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/AST.h"
+#include "dawn/SIR/ASTVisitor.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/Support/Casting.h"
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <unordered_map>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Collect the stencil which is called right before each occurrence of a boundary condition
+/// in the stencil description
+class BoundaryConditionPlacement {
+  const std::shared_ptr<StencilInstantiation>& instantiation_;
+
+  /// Number of calls of each stencil (by StencilID)
+  std::unordered_map<int, int> numCalls_;
+
+  /// Boundary conditions in the order of their first occurrence
+  std::vector<std::shared_ptr<BoundaryConditionDeclStmt>> boundaryConditions_;
+
+  /// StencilIDs of the stencils called right before each occurrence of a boundary condition (-1 if
+  /// the boundary condition does not directly follow a stencil call)
+  std::unordered_map<std::shared_ptr<BoundaryConditionDeclStmt>, std::vector<int>> predecessors_;
+
+public:
+  BoundaryConditionPlacement(const std::shared_ptr<StencilInstantiation>& instantiation)
+      : instantiation_(instantiation) {
+    int lastStencilID = -1;
+    for(const auto& statement : instantiation_->getStencilDescStatements())
+      lastStencilID = visit(statement->ASTStmt, lastStencilID);
+  }
+
+  /// @brief Get the boundary conditions of the stencil description in the order of their first
+  /// occurrence
+  const std::vector<std::shared_ptr<BoundaryConditionDeclStmt>>& getBoundaryConditions() const {
+    return boundaryConditions_;
+  }
+
+  /// @brief Get the StencilID of the stencil after which `bc` can be applied or -1 if there is no
+  /// such stencil
+  int getProducingStencilID(const std::shared_ptr<BoundaryConditionDeclStmt>& bc) const {
+    auto it = predecessors_.find(bc);
+    if(it == predecessors_.end())
+      return -1;
+
+    const std::vector<int>& stencilIDs = it->second;
+    int stencilID = stencilIDs.front();
+    if(stencilID == -1 || std::count(stencilIDs.begin(), stencilIDs.end(), stencilID) !=
+                              static_cast<int>(stencilIDs.size()))
+      return -1;
+    return numCalls_.at(stencilID) == static_cast<int>(stencilIDs.size()) ? stencilID : -1;
+  }
+
+private:
+  /// @brief Visit `stmt` which is executed right after the stencil `lastStencilID` (-1 if it is
+  /// not executed right after a stencil call)
+  ///
+  /// @returns the StencilID of the stencil called last by `stmt` (-1 if `stmt` does not end with a
+  /// stencil call)
+  int visit(const std::shared_ptr<Stmt>& stmt, int lastStencilID) {
+    if(auto call = dyn_pointer_cast<StencilCallDeclStmt>(stmt)) {
+      int stencilID = instantiation_->getStencilCallToStencilIDMap().at(call);
+      numCalls_[stencilID]++;
+      return stencilID;
+    }
+
+    // Boundary conditions are applied to the boundary points of their field only, they do not
+    // affect the data the preceding stencil computed in the other fields
+    if(auto bc = dyn_pointer_cast<BoundaryConditionDeclStmt>(stmt)) {
+      auto& predecessors = predecessors_[bc];
+      if(predecessors.empty())
+        boundaryConditions_.push_back(bc);
+      predecessors.push_back(lastStencilID);
+      return lastStencilID;
+    }
+
+    if(isa<BlockStmt>(stmt.get())) {
+      for(const auto& child : stmt->getChildren())
+        lastStencilID = visit(child, lastStencilID);
+      return lastStencilID;
+    }
+
+    // Control flow, the nested statements are not necessarily executed right after the stencil
+    for(const auto& child : stmt->getChildren())
+      visit(child, -1);
+    return -1;
+  }
+};
+
+/// @brief Check if a boundary condition functor, or a stencil function it calls, accesses a field
+/// with a vertical offset
+///
+/// The fused boundary condition is applied at each vertical level right after the stage computed
+/// it, hence it must not read other levels.
+class VerticalOffsetFinder : public ASTVisitorForwarding {
+  SIR& sir_;
+  std::set<std::string> visitedFunctions_;
+  bool hasVerticalOffset_ = false;
+
+public:
+  using Base = ASTVisitorForwarding;
+
+  VerticalOffsetFinder(SIR& sir) : sir_(sir) {}
+
+  /// @brief Check the stencil function `name` (unknown functions are assumed to have offsets)
+  bool hasVerticalOffset(const std::string& name) {
+    visitFunction(name);
+    return hasVerticalOffset_;
+  }
+
+  void visit(const std::shared_ptr<FieldAccessExpr>& expr) override {
+    const FieldAccessExpr& field = *expr;
+    if(field.getOffset()[2] != 0 || field.getArgumentMap()[2] != -1 ||
+       field.getArgumentOffset()[2] != 0)
+      hasVerticalOffset_ = true;
+    Base::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<StencilFunArgExpr>& expr) override {
+    if(expr->getDimension() == 2 && expr->getOffset() != 0)
+      hasVerticalOffset_ = true;
+    Base::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override {
+    visitFunction(static_cast<const StencilFunCallExpr&>(*expr).getCallee());
+    Base::visit(expr);
+  }
+
+private:
+  void visitFunction(const std::string& name) {
+    if(hasVerticalOffset_ || !visitedFunctions_.insert(name).second)
+      return;
+
+    std::shared_ptr<sir::StencilFunction> function = sir_.getStencilFunction(name);
+    if(!function) {
+      hasVerticalOffset_ = true;
+      return;
+    }
+    for(const auto& ast : function->Asts)
+      ast->accept(*this);
+  }
+};
+
+/// @brief Get the stage of `stencil` into which the boundary condition of the field `AccessID` can
+/// be fused (NULL if there is no such stage)
+std::shared_ptr<Stage> getProducingStage(const Stencil& stencil, int AccessID) {
+  std::shared_ptr<Stage> producingStage;
+  for(const auto& multiStagePtr : stencil.getMultiStages())
+    for(const auto& stagePtr : multiStagePtr->getStages())
+      for(const Field& field : stagePtr->getFields())
+        if(field.getAccessID() == AccessID) {
+          if(producingStage || field.getIntend() != Field::IK_Output)
+            return nullptr;
+          producingStage = stagePtr;
+        }
+
+  if(!producingStage || !producingStage->hasSingleDoMethod() ||
+     !(producingStage->getSingleDoMethod().getInterval() ==
+       Interval(sir::Interval::Start, sir::Interval::End)))
+    return nullptr;
+  return producingStage;
+}
+
+} // anonymous namespace
+
+PassBoundaryConditionFusion::PassBoundaryConditionFusion() : Pass("PassBoundaryConditionFusion") {
+  dependencies_.push_back("PassSetBoundaryCondition");
+}
+
+bool PassBoundaryConditionFusion::run(
+    const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
+  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+  if(!context->getOptions().FuseBoundaryConditions)
+    return true;
+
+  BoundaryConditionPlacement placement(stencilInstantiation);
+
+  for(const auto& bc : placement.getBoundaryConditions()) {
+    auto extentsIt = stencilInstantiation->getBoundaryConditionToExtentsMap().find(bc);
+    if(extentsIt == stencilInstantiation->getBoundaryConditionToExtentsMap().end())
+      continue;
+    const Extents& extents = extentsIt->second;
+    if(bc->getFields().size() != 1 || extents[2].Minus != 0 || extents[2].Plus != 0)
+      continue;
+    if(VerticalOffsetFinder(*stencilInstantiation->getSIR()).hasVerticalOffset(bc->getFunctor()))
+      continue;
+
+    int stencilID = placement.getProducingStencilID(bc);
+    if(stencilID == -1)
+      continue;
+
+    const std::string& fieldName = bc->getFields()[0]->Name;
+    if(!stencilInstantiation->getNameToAccessIDMap().count(fieldName))
+      continue;
+    int AccessID = stencilInstantiation->getAccessIDFromName(fieldName);
+
+    for(const auto& stencil : stencilInstantiation->getStencils()) {
+      if(stencil->getStencilID() != stencilID)
+        continue;
+
+      if(std::shared_ptr<Stage> stage = getProducingStage(*stencil, AccessID)) {
+        stage->getBoundaryConditions().push_back(bc);
+
+        if(context->getOptions().ReportBoundaryConditions)
+          std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName()
+                    << ": boundary condition of field '" << fieldName << "' fused into stage "
+                    << stage->getStageID() << " of stencil_" << stencilID << std::endl;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace dawn
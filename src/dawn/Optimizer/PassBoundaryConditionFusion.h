@@ -0,0 +1,51 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_OPTIMIZER_PASSBOUNDARYCONDITIONFUSION_H
+#define DAWN_OPTIMIZER_PASSBOUNDARYCONDITIONFUSION_H
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief Fuse the boundary conditions inserted by `PassSetBoundaryCondition` into the stage
+/// computing the field
+///
+/// A boundary condition is applied as a separate traversal of the boundary points between two
+/// stencil calls. If the stencil computing the field is called right before the boundary condition,
+/// the boundary condition is attached to the stage computing the field instead. Code generators
+/// which support it apply the boundary condition to each vertical level right after the stage
+/// computed the level, i.e while the data is still in cache. A boundary condition is fused if
+///
+///   - every occurrence of the boundary condition in the stencil description directly follows a
+///     call to the same stencil and every call to this stencil is followed by the boundary
+///     condition,
+///   - the boundary condition is applied to a single field and does not extend in the vertical,
+///   - the field is only accessed by one stage of the stencil, which writes but does not read it,
+///   - and this stage computes all vertical levels in a single Do-Method.
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassBoundaryConditionFusion : public Pass {
+public:
+  PassBoundaryConditionFusion();
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) override;
+};
+
+} // namespace dawn
+
+#endif
@@ -0,0 +1,416 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/Optimizer/PassCommonSubexpressionElimination.h"
+#include "dawn/Optimizer/AccessComputation.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/StatementAccessesPair.h"
+#include "dawn/Optimizer/Stencil.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/AST.h"
+#include "dawn/SIR/ASTUtil.h"
+#include "dawn/Support/Casting.h"
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Occurrence of a side-effect free expression in the right-hand side of a statement
+struct Occurrence {
+  std::size_t StmtIdx;        ///< Index of the statement in the Do-Method
+  std::shared_ptr<Expr> Root; ///< The expression
+  int Flops;                  ///< Number of operations needed to evaluate the expression
+  std::vector<int> ReadIDs;   ///< AccessIDs of the fields and variables read by the expression
+  BuiltinTypeID Type;         ///< Type of the value (`Invalid` if it cannot be deduced)
+  bool IsConditional;         ///< Only evaluated in a branch of a ternary or logical operator
+};
+
+/// @brief Type of the result of an arithmetic operation (or a conditional) on `lhs` and `rhs`
+///
+/// Follows the usual arithmetic conversions of C++: booleans are promoted to integers and
+/// integers are converted to floating point numbers if the other operand is one.
+BuiltinTypeID promoteTypes(BuiltinTypeID lhs, BuiltinTypeID rhs) {
+  if(lhs == BuiltinTypeID::Invalid || rhs == BuiltinTypeID::Invalid)
+    return BuiltinTypeID::Invalid;
+  if(lhs == BuiltinTypeID::Float || rhs == BuiltinTypeID::Float)
+    return BuiltinTypeID::Float;
+  return BuiltinTypeID::Integer;
+}
+
+/// @brief Check if the binary operator `op` yields a boolean
+bool isBooleanOperator(const char* op) {
+  for(const char* booleanOp : {"==", "!=", "<", ">", "<=", ">=", "&&", "||"})
+    if(std::strcmp(op, booleanOp) == 0)
+      return true;
+  return false;
+}
+
+/// @brief Get the right-hand side of a top-level statement which is eligible for the elimination
+/// (assignments and initializations of scalar variables) or NULL
+std::shared_ptr<Expr> getRHS(const std::shared_ptr<Stmt>& stmt) {
+  if(ExprStmt* exprStmt = dyn_cast<ExprStmt>(stmt.get())) {
+    if(AssignmentExpr* assignment = dyn_cast<AssignmentExpr>(exprStmt->getExpr().get()))
+      return assignment->getRight();
+  } else if(VarDeclStmt* varDecl = dyn_cast<VarDeclStmt>(stmt.get())) {
+    if(!varDecl->isArray() && varDecl->getInitList().size() == 1)
+      return varDecl->getInitList().front();
+  }
+  return nullptr;
+}
+
+/// @brief Replace the right-hand side (see `getRHS`) of `stmt` by `expr`
+void setRHS(const std::shared_ptr<Stmt>& stmt, const std::shared_ptr<Expr>& expr) {
+  if(ExprStmt* exprStmt = dyn_cast<ExprStmt>(stmt.get()))
+    cast<AssignmentExpr>(exprStmt->getExpr().get())->setRight(expr);
+  else
+    cast<VarDeclStmt>(stmt.get())->replaceChildren(getRHS(stmt), expr);
+}
+
+/// @brief Collect the side-effect free subexpressions of the right-hand side of a statement
+///
+/// Subexpressions in a branch of a ternary operator or in the right operand of `&&` and `||` are
+/// only evaluated conditionally and are marked as such: they must not be evaluated ahead of the
+/// statement (they may divide by zero) but can reuse the value of an unconditional occurrence.
+class OccurrenceCollector {
+  const StencilInstantiation* instantiation_;
+  const std::unordered_map<int, BuiltinTypeID>& variableTypes_;
+  std::size_t stmtIdx_;
+  std::vector<Occurrence>& occurrences_;
+
+  /// Set to false if the expression has side effects (the statement is then skipped entirely)
+  bool isPure_;
+
+public:
+  OccurrenceCollector(const StencilInstantiation* instantiation,
+                      const std::unordered_map<int, BuiltinTypeID>& variableTypes,
+                      std::size_t stmtIdx, std::vector<Occurrence>& occurrences)
+      : instantiation_(instantiation), variableTypes_(variableTypes), stmtIdx_(stmtIdx),
+        occurrences_(occurrences), isPure_(true) {}
+
+  /// @brief Collect the occurrences of `expr`
+  ///
+  /// @returns `false` if the expression has side effects
+  bool collect(const std::shared_ptr<Expr>& expr) {
+    std::size_t numOccurrences = occurrences_.size();
+    Occurrence occurrence;
+    visit(expr, false, occurrence);
+    if(!isPure_)
+      occurrences_.resize(numOccurrences);
+    return isPure_;
+  }
+
+private:
+  /// @brief Type of the variable `AccessID` (local or global)
+  BuiltinTypeID getVariableType(int AccessID) const {
+    if(instantiation_->isGlobalVariable(AccessID))
+      return sir::Value::typeToBuiltinTypeID(
+          instantiation_->getGlobalVariableValue(instantiation_->getNameFromAccessID(AccessID))
+              .getType());
+    auto it = variableTypes_.find(AccessID);
+    return it != variableTypes_.end() ? it->second : BuiltinTypeID::Invalid;
+  }
+
+  /// @brief Visit `expr` and accumulate its operations and read accesses in `result`
+  ///
+  /// The type of `expr` is stored in `result.Type`.
+  ///
+  /// @returns `true` if `expr` is side-effect free (and can be evaluated anywhere in between the
+  /// writes to the fields and variables it reads)
+  bool visit(const std::shared_ptr<Expr>& expr, bool isConditional, Occurrence& result) {
+    bool isPure = isPureNode(expr.get());
+    bool isOperation = false;
+    int firstConditionalChild = -1;
+    result.Type = BuiltinTypeID::Invalid;
+    if(hasSideEffects(expr.get()))
+      isPure_ = false;
+
+    switch(expr->getKind()) {
+    case Expr::EK_BinaryOperator: {
+      const char* op = cast<BinaryOperator>(expr.get())->getOp();
+      if(std::strcmp(op, "&&") == 0 || std::strcmp(op, "||") == 0)
+        firstConditionalChild = 1;
+      isOperation = true;
+      break;
+    }
+    case Expr::EK_TernaryOperator:
+      firstConditionalChild = 1;
+      isOperation = true;
+      break;
+    case Expr::EK_UnaryOperator:
+    case Expr::EK_FunCallExpr:
+      isOperation = true;
+      break;
+    case Expr::EK_FieldAccessExpr:
+      result.ReadIDs.push_back(instantiation_->getAccessIDFromExpr(expr));
+      result.Type = BuiltinTypeID::Float;
+      break;
+    case Expr::EK_VarAccessExpr: {
+      int AccessID = instantiation_->getAccessIDFromExpr(expr);
+      result.ReadIDs.push_back(AccessID);
+      result.Type = getVariableType(AccessID);
+      break;
+    }
+    case Expr::EK_LiteralAccessExpr:
+      result.Type = cast<LiteralAccessExpr>(expr.get())->getBuiltinType();
+      if(result.Type == BuiltinTypeID::Auto)
+        result.Type = BuiltinTypeID::Invalid;
+      break;
+    case Expr::EK_AssignmentExpr:
+      break;
+    default:
+      // Calls to stencil functions (and their arguments) are left alone as the optimizer keeps one
+      // stencil function instantiation per call
+      return false;
+    }
+
+    Occurrence occurrence;
+    occurrence.Flops = isOperation ? 1 : 0;
+    std::vector<BuiltinTypeID> childTypes;
+    int childIdx = 0;
+    for(const auto& child : expr->getChildren()) {
+      bool isChildConditional =
+          isConditional || (firstConditionalChild != -1 && childIdx >= firstConditionalChild);
+      childIdx++;
+      isPure &= visit(child, isChildConditional, occurrence);
+      childTypes.push_back(occurrence.Type);
+    }
+    if(isOperation)
+      result.Type = getOperationType(expr, childTypes);
+
+    if(isPure && isOperation && !occurrence.ReadIDs.empty() &&
+       result.Type != BuiltinTypeID::Invalid) {
+      occurrence.StmtIdx = stmtIdx_;
+      occurrence.Root = expr;
+      occurrence.Type = result.Type;
+      occurrence.IsConditional = isConditional;
+      occurrences_.push_back(occurrence);
+    }
+
+    result.Flops += occurrence.Flops;
+    result.ReadIDs.insert(result.ReadIDs.end(), occurrence.ReadIDs.begin(),
+                          occurrence.ReadIDs.end());
+    return isPure;
+  }
+
+  /// @brief Type of the result of the operation `expr` whose operands are of type `operandTypes`
+  static BuiltinTypeID getOperationType(const std::shared_ptr<Expr>& expr,
+                                        const std::vector<BuiltinTypeID>& operandTypes) {
+    switch(expr->getKind()) {
+    case Expr::EK_UnaryOperator:
+      if(std::strcmp(cast<UnaryOperator>(expr.get())->getOp(), "!") == 0)
+        return BuiltinTypeID::Boolean;
+      return promoteTypes(operandTypes[0], operandTypes[0]);
+    case Expr::EK_BinaryOperator:
+      if(isBooleanOperator(cast<BinaryOperator>(expr.get())->getOp()))
+        return operandTypes[0] != BuiltinTypeID::Invalid &&
+                       operandTypes[1] != BuiltinTypeID::Invalid
+                   ? BuiltinTypeID::Boolean
+                   : BuiltinTypeID::Invalid;
+      return promoteTypes(operandTypes[0], operandTypes[1]);
+    case Expr::EK_TernaryOperator:
+      if(operandTypes[1] == operandTypes[2])
+        return operandTypes[1];
+      return promoteTypes(operandTypes[1], operandTypes[2]);
+    case Expr::EK_FunCallExpr: {
+      // Only the floating point overloads of the math functions are known to return the type of
+      // their arguments
+      for(BuiltinTypeID type : operandTypes)
+        if(type != BuiltinTypeID::Float)
+          return BuiltinTypeID::Invalid;
+      return BuiltinTypeID::Float;
+    }
+    default:
+      return BuiltinTypeID::Invalid;
+    }
+  }
+};
+
+/// @brief Check if `a` and `b` compute the same value
+bool isSameValue(const Occurrence& a, const Occurrence& b) {
+  // The structural hashes are cached in the nodes, the full comparison is only needed if they match
+  if(a.Flops != b.Flops || a.Type != b.Type || a.ReadIDs != b.ReadIDs ||
+     a.Root->getHash() != b.Root->getHash())
+    return false;
+  return a.Root->equals(b.Root.get());
+}
+
+/// @brief Eliminate the common subexpressions of a Do-Method
+class CommonSubexpressionEliminator {
+  StencilInstantiation* instantiation_;
+  std::vector<std::shared_ptr<StatementAccessesPair>>& stmtAccessesPairs_;
+
+public:
+  CommonSubexpressionEliminator(StencilInstantiation* instantiation, DoMethod& doMethod)
+      : instantiation_(instantiation), stmtAccessesPairs_(doMethod.getStatementAccessesPairs()) {}
+
+  /// @brief Eliminate the subexpression with the largest savings
+  ///
+  /// @returns the number of saved operations or 0 if there are no common subexpressions left
+  int eliminateOne() {
+    // Types of the local variables declared in the Do-Method
+    std::unordered_map<int, BuiltinTypeID> variableTypes;
+    for(const auto& pair : stmtAccessesPairs_)
+      if(VarDeclStmt* varDecl = dyn_cast<VarDeclStmt>(pair->getStatement()->ASTStmt.get()))
+        if(!varDecl->isArray())
+          variableTypes.emplace(instantiation_->getAccessIDFromStmt(pair->getStatement()->ASTStmt),
+                                varDecl->getType().getBuiltinTypeID());
+
+    std::vector<Occurrence> occurrences;
+    for(std::size_t i = 0; i < stmtAccessesPairs_.size(); ++i) {
+      if(std::shared_ptr<Expr> rhs = getRHS(stmtAccessesPairs_[i]->getStatement()->ASTStmt))
+        OccurrenceCollector(instantiation_, variableTypes, i, occurrences).collect(rhs);
+    }
+
+    // Group the occurrences which compute the same value (the first occurrence of each group is
+    // its leader) and pick the group with the largest savings. The leader is evaluated ahead of
+    // its statement and thus has to be evaluated unconditionally, the other occurrences of the
+    // group merely reuse its value.
+    std::vector<bool> grouped(occurrences.size(), false);
+    std::vector<std::size_t> group, bestGroup;
+    int bestSavings = 0;
+
+    for(std::size_t i = 0; i < occurrences.size(); ++i) {
+      int maxSavings = occurrences[i].Flops * static_cast<int>(occurrences.size() - i - 1);
+      if(grouped[i] || occurrences[i].IsConditional || maxSavings <= bestSavings)
+        continue;
+
+      group.assign(1, i);
+      std::size_t availableUntil = findNextWrite(occurrences[i]);
+      for(std::size_t j = i + 1; j < occurrences.size(); ++j) {
+        if(occurrences[j].StmtIdx > availableUntil)
+          break;
+        if(!grouped[j] && isSameValue(occurrences[i], occurrences[j]))
+          group.push_back(j);
+      }
+
+      if(group.size() < 2)
+        continue;
+      for(std::size_t idx : group)
+        grouped[idx] = true;
+
+      int savings = occurrences[i].Flops * static_cast<int>(group.size() - 1);
+      if(savings > bestSavings) {
+        bestSavings = savings;
+        bestGroup = group;
+      }
+    }
+
+    if(bestGroup.empty())
+      return 0;
+
+    const Occurrence& leader = occurrences[bestGroup.front()];
+    std::size_t insertIdx = leader.StmtIdx;
+
+    // Store the value of the leader in a new local variable of the same type ...
+    int AccessID = instantiation_->nextUID();
+    std::string name = StencilInstantiation::makeLocalVariablename("cse", AccessID);
+    instantiation_->setAccessIDNamePair(AccessID, name);
+
+    // ... and replace all occurrences by an access to the variable
+    std::vector<std::shared_ptr<StatementAccessesPair>> modifiedPairs;
+    for(std::size_t idx : bestGroup) {
+      const Occurrence& occurrence = occurrences[idx];
+      auto varAccess = std::make_shared<VarAccessExpr>(name);
+      instantiation_->mapExprToAccessID(varAccess, AccessID);
+
+      const auto& pair = stmtAccessesPairs_[occurrence.StmtIdx];
+      const std::shared_ptr<Stmt>& stmt = pair->getStatement()->ASTStmt;
+      if(getRHS(stmt) == occurrence.Root)
+        setRHS(stmt, varAccess);
+      else
+        replaceOldExprWithNewExprInStmt(stmt, occurrence.Root, varAccess);
+
+      if(modifiedPairs.empty() || modifiedPairs.back() != pair)
+        modifiedPairs.push_back(pair);
+    }
+    auto varDecl =
+        std::make_shared<VarDeclStmt>(Type(leader.Type, CVQualifier::Const), name, 0, "=",
+                                      std::vector<std::shared_ptr<Expr>>{leader.Root});
+    instantiation_->mapStmtToAccessID(varDecl, AccessID);
+
+    auto newPair = std::make_shared<StatementAccessesPair>(std::make_shared<Statement>(
+        varDecl, stmtAccessesPairs_[insertIdx]->getStatement()->StackTrace));
+    modifiedPairs.push_back(newPair);
+    computeAccesses(instantiation_, modifiedPairs);
+    stmtAccessesPairs_.insert(stmtAccessesPairs_.begin() + insertIdx, newPair);
+
+    return bestSavings;
+  }
+
+private:
+  /// @brief Index of the first statement (starting with the statement of `occurrence`) which
+  /// writes to a field or variable read by `occurrence`
+  ///
+  /// The value of `occurrence` can be reused up to (and including) the right-hand side of this
+  /// statement.
+  std::size_t findNextWrite(const Occurrence& occurrence) const {
+    for(std::size_t i = occurrence.StmtIdx; i < stmtAccessesPairs_.size(); ++i) {
+      const auto& writeAccesses = stmtAccessesPairs_[i]->getAccesses()->getWriteAccesses();
+      for(int AccessID : occurrence.ReadIDs)
+        if(writeAccesses.count(AccessID))
+          return i;
+    }
+    return stmtAccessesPairs_.size();
+  }
+};
+
+} // anonymous namespace
+
+PassCommonSubexpressionElimination::PassCommonSubexpressionElimination()
+    : Pass("PassCommonSubexpressionElimination") {}
+
+bool PassCommonSubexpressionElimination::run(
+    const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
+  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+  if(!context->getOptions().CSE)
+    return true;
+
+  int numEliminated = 0;
+  int numSavedFlops = 0;
+
+  for(auto& stencilPtr : stencilInstantiation->getStencils()) {
+    for(auto& multiStagePtr : stencilPtr->getMultiStages()) {
+      for(auto& stagePtr : multiStagePtr->getStages()) {
+        Stage& stage = *stagePtr;
+        bool modified = false;
+
+        for(auto& doMethodPtr : stage.getDoMethods()) {
+          CommonSubexpressionEliminator eliminator(stencilInstantiation.get(), *doMethodPtr);
+          while(int savedFlops = eliminator.eliminateOne()) {
+            numEliminated++;
+            numSavedFlops += savedFlops;
+            modified = true;
+          }
+        }
+
+        if(modified)
+          stage.update();
+      }
+    }
+  }
+
+  if(context->getOptions().ReportPassCSE)
+    std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName()
+              << ": eliminated " << numEliminated << " common subexpressions (" << numSavedFlops
+              << " FLOPs saved per grid point)\n";
+
+  return true;
+}
+
+} // namespace dawn
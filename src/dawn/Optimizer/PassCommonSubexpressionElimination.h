@@ -0,0 +1,49 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#ifndef DAWN_OPTIMIZER_PASSCOMMONSUBEXPRESSIONELIMINATION_H
+#define DAWN_OPTIMIZER_PASSCOMMONSUBEXPRESSIONELIMINATION_H
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief Eliminate common subexpressions within the Do-Methods of the stencils
+///
+/// Structurally equal, side-effect free expressions (compared with `Expr::equals` and the
+/// AccessIDs of the accessed fields and variables) on the right-hand side of the top-level
+/// statements of a Do-Method are computed once and stored in a new local variable, provided none
+/// of the fields or variables they read is written in between. The largest savings (number of
+/// arithmetic operations times the number of redundant occurrences) are eliminated first. The
+/// variable has the type of the expression, which is deduced from its operands; expressions whose
+/// type cannot be deduced are left alone.
+///
+/// The pass runs right after inlining, i.e before the stages are split. Local variables whose
+/// uses end up in different stages are later promoted to temporaries by `PassTemporaryType`.
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassCommonSubexpressionElimination : public Pass {
+public:
+  PassCommonSubexpressionElimination();
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) override;
+};
+
+} // namespace dawn
+
+#endif
@@ -0,0 +1,372 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/Optimizer/PassConstantFolding.h"
+#include "dawn/Optimizer/AccessComputation.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/StatementAccessesPair.h"
+#include "dawn/Optimizer/Stencil.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/AST.h"
+#include "dawn/SIR/ASTUtil.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/Support/Casting.h"
+#include "dawn/Support/StringRef.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Compute the type of the constant expression `expr` following the C++ promotion rules
+///
+/// @returns `BuiltinTypeID::Invalid` if `expr` is not a constant expression or cannot be evaluated
+/// exactly in double precision (i.e integer divisions)
+BuiltinTypeID getConstantType(const Expr* expr) {
+  auto isFloat = [](BuiltinTypeID type) { return type == BuiltinTypeID::Float; };
+
+  switch(expr->getKind()) {
+  case Expr::EK_LiteralAccessExpr:
+    return cast<LiteralAccessExpr>(expr)->getBuiltinType();
+
+  case Expr::EK_UnaryOperator: {
+    const UnaryOperator* op = cast<UnaryOperator>(expr);
+    BuiltinTypeID type = getConstantType(op->getOperand().get());
+    if(type == BuiltinTypeID::Invalid)
+      return BuiltinTypeID::Invalid;
+    if(StringRef(op->getOp()) == "!")
+      return BuiltinTypeID::Boolean;
+    return isFloat(type) ? BuiltinTypeID::Float : BuiltinTypeID::Integer;
+  }
+
+  case Expr::EK_BinaryOperator: {
+    const BinaryOperator* op = cast<BinaryOperator>(expr);
+    BuiltinTypeID left = getConstantType(op->getLeft().get());
+    BuiltinTypeID right = getConstantType(op->getRight().get());
+    if(left == BuiltinTypeID::Invalid || right == BuiltinTypeID::Invalid)
+      return BuiltinTypeID::Invalid;
+
+    StringRef opStr(op->getOp());
+    if(opStr == "==" || opStr == "!=" || opStr == "<" || opStr == ">" || opStr == "<=" ||
+       opStr == ">=" || opStr == "&&" || opStr == "||")
+      return BuiltinTypeID::Boolean;
+    if(isFloat(left) || isFloat(right))
+      return BuiltinTypeID::Float;
+    return opStr == "/" ? BuiltinTypeID::Invalid : BuiltinTypeID::Integer;
+  }
+
+  case Expr::EK_TernaryOperator: {
+    const TernaryOperator* op = cast<TernaryOperator>(expr);
+    BuiltinTypeID cond = getConstantType(op->getCondition().get());
+    BuiltinTypeID left = getConstantType(op->getLeft().get());
+    BuiltinTypeID right = getConstantType(op->getRight().get());
+    if(cond == BuiltinTypeID::Invalid || left == BuiltinTypeID::Invalid ||
+       right == BuiltinTypeID::Invalid)
+      return BuiltinTypeID::Invalid;
+    if(left == right)
+      return left;
+    return isFloat(left) || isFloat(right) ? BuiltinTypeID::Float : BuiltinTypeID::Integer;
+  }
+
+  default:
+    return BuiltinTypeID::Invalid;
+  }
+}
+
+/// @brief Fold the constant expressions and remove the dead branches of the statements
+class ConstantFolder {
+  StencilInstantiation* instantiation_;
+
+  int numFoldedExprs_;
+  int numRemovedBranches_;
+
+public:
+  ConstantFolder(StencilInstantiation* instantiation)
+      : instantiation_(instantiation), numFoldedExprs_(0), numRemovedBranches_(0) {}
+
+  int getNumFoldedExprs() const { return numFoldedExprs_; }
+  int getNumRemovedBranches() const { return numRemovedBranches_; }
+
+  /// @brief Process the statements of `doMethod`
+  ///
+  /// @returns `true` if the Do-Method was modified
+  bool run(DoMethod& doMethod) {
+    auto& stmtAccessesPairs = doMethod.getStatementAccessesPairs();
+    bool modified = false;
+
+    for(auto it = stmtAccessesPairs.begin(); it != stmtAccessesPairs.end();) {
+      std::shared_ptr<StatementAccessesPair> pair = *it;
+      const std::shared_ptr<Stmt>& root = pair->getStatement()->ASTStmt;
+
+      int numFoldedExprs = numFoldedExprs_;
+      int numRemovedBranches = numRemovedBranches_;
+      foldStmt(root, root);
+
+      IfStmt* ifStmt = dyn_cast<IfStmt>(root.get());
+      bool cond;
+      if(ifStmt && evalExprAsBoolean(ifStmt->getCondExpr(), cond)) {
+        // Replace the if-statement by the statements of the taken branch
+        std::vector<std::shared_ptr<Stmt>> stmts;
+        if(cond)
+          appendStatements(ifStmt->getThenStmt(), stmts);
+        else if(ifStmt->hasElse())
+          appendStatements(ifStmt->getElseStmt(), stmts);
+        numRemovedBranches_++;
+
+        std::vector<std::shared_ptr<StatementAccessesPair>> newPairs;
+        for(const auto& stmt : stmts) {
+          newPairs.emplace_back(std::make_shared<StatementAccessesPair>(
+              std::make_shared<Statement>(stmt, pair->getStatement()->StackTrace)));
+          makeChildren(newPairs.back());
+        }
+        computeAccesses(instantiation_, newPairs);
+
+        it = stmtAccessesPairs.erase(it);
+        it = stmtAccessesPairs.insert(it, newPairs.begin(), newPairs.end());
+        std::advance(it, newPairs.size());
+        modified = true;
+        continue;
+      }
+
+      if(numFoldedExprs != numFoldedExprs_ || numRemovedBranches != numRemovedBranches_) {
+        // The children of if-statements may have changed
+        makeChildren(pair);
+        computeAccesses(instantiation_, pair);
+        modified = true;
+      }
+      ++it;
+    }
+    return modified;
+  }
+
+private:
+  /// @brief Append `stmt` to `stmts` (or its statements if it is a block statement)
+  static void appendStatements(const std::shared_ptr<Stmt>& stmt,
+                               std::vector<std::shared_ptr<Stmt>>& stmts) {
+    if(BlockStmt* block = dyn_cast<BlockStmt>(stmt.get())) {
+      for(const auto& s : block->getStatements())
+        appendStatements(s, stmts);
+    } else
+      stmts.push_back(stmt);
+  }
+
+  /// @brief (Re-)create the children of `pair` from its statement (the statements of the branches
+  /// of if-statements become children, see `StatementMapper`)
+  static void makeChildren(const std::shared_ptr<StatementAccessesPair>& pair) {
+    pair->getChildren().clear();
+    IfStmt* ifStmt = dyn_cast<IfStmt>(pair->getStatement()->ASTStmt.get());
+    if(!ifStmt)
+      return;
+
+    std::vector<std::shared_ptr<Stmt>> stmts;
+    appendStatements(ifStmt->getThenStmt(), stmts);
+    if(ifStmt->hasElse())
+      appendStatements(ifStmt->getElseStmt(), stmts);
+
+    for(const auto& stmt : stmts) {
+      pair->getChildren().emplace_back(std::make_shared<StatementAccessesPair>(
+          std::make_shared<Statement>(stmt, pair->getStatement()->StackTrace)));
+      makeChildren(pair->getChildren().back());
+    }
+  }
+
+  /// @brief Fold the expressions of `stmt` and remove the dead branches of the nested
+  /// if-statements (`root` is the top-level statement)
+  void foldStmt(const std::shared_ptr<Stmt>& root, const std::shared_ptr<Stmt>& stmt) {
+    switch(stmt->getKind()) {
+    case Stmt::SK_ExprStmt:
+      foldExpr(root, cast<ExprStmt>(stmt.get())->getExpr());
+      break;
+    case Stmt::SK_VarDeclStmt: {
+      std::vector<std::shared_ptr<Expr>> initList = cast<VarDeclStmt>(stmt.get())->getInitList();
+      for(const auto& expr : initList)
+        foldExpr(root, expr);
+      break;
+    }
+    case Stmt::SK_IfStmt: {
+      IfStmt* ifStmt = cast<IfStmt>(stmt.get());
+      foldExpr(root, ifStmt->getCondExpr());
+      foldStmt(root, ifStmt->getThenStmt());
+      if(ifStmt->hasElse())
+        foldStmt(root, ifStmt->getElseStmt());
+      break;
+    }
+    case Stmt::SK_BlockStmt: {
+      BlockStmt* block = cast<BlockStmt>(stmt.get());
+      auto& stmts = block->getStatements();
+      for(auto it = stmts.begin(); it != stmts.end();) {
+        std::shared_ptr<Stmt> s = *it;
+        foldStmt(root, s);
+
+        // Splice the taken branch of nested if-statements with a constant condition into the block
+        IfStmt* ifStmt = dyn_cast<IfStmt>(s.get());
+        bool cond;
+        if(ifStmt && evalExprAsBoolean(ifStmt->getCondExpr(), cond)) {
+          std::vector<std::shared_ptr<Stmt>> branch;
+          if(cond)
+            appendStatements(ifStmt->getThenStmt(), branch);
+          else if(ifStmt->hasElse())
+            appendStatements(ifStmt->getElseStmt(), branch);
+          numRemovedBranches_++;
+
+          it = block->erase(it);
+          it = block->insert(it, branch.begin(), branch.end());
+          std::advance(it, branch.size());
+        } else
+          ++it;
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  /// @brief Fold the constant subexpressions of `expr` (`root` is the top-level statement)
+  void foldExpr(const std::shared_ptr<Stmt>& root, std::shared_ptr<Expr> expr) {
+    // Signed literals are already as folded as it gets
+    if(UnaryOperator* op = dyn_cast<UnaryOperator>(expr.get()))
+      if(isa<LiteralAccessExpr>(op->getOperand().get()))
+        return;
+
+    switch(expr->getKind()) {
+    case Expr::EK_UnaryOperator:
+    case Expr::EK_BinaryOperator:
+    case Expr::EK_TernaryOperator: {
+      if(std::shared_ptr<Expr> literal = evaluate(expr)) {
+        replaceOldExprWithNewExprInStmt(root, expr, literal);
+        numFoldedExprs_++;
+        return;
+      }
+
+      // Replace ternary operators with a constant condition by the taken branch
+      TernaryOperator* op = dyn_cast<TernaryOperator>(expr.get());
+      bool cond;
+      if(op && evalExprAsBoolean(op->getCondition(), cond)) {
+        std::shared_ptr<Expr> branch = cond ? op->getLeft() : op->getRight();
+        replaceOldExprWithNewExprInStmt(root, expr, branch);
+        numFoldedExprs_++;
+        foldExpr(root, branch);
+        return;
+      }
+      break;
+    }
+    case Expr::EK_StencilFunCallExpr:
+      // The arguments are bound to the stencil function instantiation
+      return;
+    default:
+      break;
+    }
+
+    std::vector<std::shared_ptr<Expr>> children(expr->getChildren().begin(),
+                                                expr->getChildren().end());
+    for(const auto& child : children)
+      foldExpr(root, child);
+  }
+
+  /// @brief Evaluate the constant expression `expr`
+  ///
+  /// @returns the literal holding the value of `expr` or `NULL` if `expr` is not constant
+  std::shared_ptr<Expr> evaluate(const std::shared_ptr<Expr>& expr) {
+    BuiltinTypeID type = getConstantType(expr.get());
+    double result;
+    if(type == BuiltinTypeID::Invalid || !evalExprAsDouble(expr, result) || !std::isfinite(result))
+      return nullptr;
+
+    sir::Value value;
+    switch(type) {
+    case BuiltinTypeID::Boolean:
+      value.setValue(result != 0.0);
+      break;
+    case BuiltinTypeID::Integer:
+      if(result < std::numeric_limits<int>::min() || result > std::numeric_limits<int>::max())
+        return nullptr;
+      value.setValue(static_cast<int>(result));
+      break;
+    case BuiltinTypeID::Float:
+      value.setValue(result);
+      break;
+    default:
+      return nullptr;
+    }
+
+    auto literal = std::make_shared<LiteralAccessExpr>(value.toString(), type);
+    int AccessID = -instantiation_->nextUID();
+    instantiation_->getLiteralAccessIDToNameMap().emplace(AccessID, literal->getValue());
+    instantiation_->mapExprToAccessID(literal, AccessID);
+    return literal;
+  }
+};
+
+} // anonymous namespace
+
+PassConstantFolding::PassConstantFolding() : Pass("PassConstantFolding") {}
+
+bool PassConstantFolding::run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
+  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+  if(!context->getOptions().FoldConstants && context->getOptions().PinGlobals.empty())
+    return true;
+
+  ConstantFolder folder(stencilInstantiation.get());
+
+  for(auto& stencilPtr : stencilInstantiation->getStencils()) {
+    auto& multiStages = stencilPtr->getMultiStages();
+    for(auto multiStageIt = multiStages.begin(); multiStageIt != multiStages.end();) {
+      auto& stages = (*multiStageIt)->getStages();
+      for(auto stageIt = stages.begin(); stageIt != stages.end();) {
+        Stage& stage = **stageIt;
+        bool modified = false;
+        for(auto& doMethodPtr : stage.getDoMethods())
+          modified |= folder.run(*doMethodPtr);
+
+        if(!modified) {
+          ++stageIt;
+          continue;
+        }
+
+        // Remove the Do-Methods (and stages) whose statements were all removed
+        auto& doMethods = stage.getDoMethods();
+        doMethods.erase(std::remove_if(doMethods.begin(), doMethods.end(),
+                                       [](const std::unique_ptr<DoMethod>& doMethod) {
+                                         return doMethod->getStatementAccessesPairs().empty();
+                                       }),
+                        doMethods.end());
+        if(doMethods.empty()) {
+          stageIt = stages.erase(stageIt);
+        } else {
+          stage.update();
+          ++stageIt;
+        }
+      }
+
+      if(stages.empty())
+        multiStageIt = multiStages.erase(multiStageIt);
+      else
+        ++multiStageIt;
+    }
+  }
+
+  if(context->getOptions().ReportPassConstantFolding)
+    std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName() << ": folded "
+              << folder.getNumFoldedExprs() << " expressions, removed "
+              << folder.getNumRemovedBranches() << " branches\n";
+
+  return true;
+}
+
+} // namespace dawn
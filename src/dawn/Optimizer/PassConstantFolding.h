@@ -0,0 +1,46 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#ifndef DAWN_OPTIMIZER_PASSCONSTANTFOLDING_H
+#define DAWN_OPTIMIZER_PASSCONSTANTFOLDING_H
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief Fold constant expressions and remove dead branches in the Do-Methods of the stencils
+///
+/// Expressions which only consist of operators on literals (this includes `constexpr` global
+/// variables and global variables pinned with `-pin-globals`, which are replaced by literals when
+/// the statements are mapped) are evaluated with `evalExprAsDouble` and replaced by a literal of
+/// the same type. If-statements and ternary operators with a constant condition are replaced by
+/// the taken branch.
+///
+/// The bodies of stencil functions which are not inlined are left untouched.
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassConstantFolding : public Pass {
+public:
+  PassConstantFolding();
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) override;
+};
+
+} // namespace dawn
+
+#endif
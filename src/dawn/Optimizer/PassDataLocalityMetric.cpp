@@ -16,7 +16,7 @@
 #include "dawn/Optimizer/OptimizerContext.h"
 #include "dawn/Optimizer/StencilInstantiation.h"
 #include "dawn/SIR/AST.h"
-#include "dawn/SIR/ASTVisitor.h"
+#include "dawn/SIR/ASTKindVisitor.h"
 #include "dawn/Support/Format.h"
 #include "dawn/Support/StringUtil.h"
 #include <deque>
@@ -28,7 +28,7 @@ namespace dawn {
 
 namespace {
 
-class ReadWriteCounter : public ASTVisitorForwarding {
+class ReadWriteCounter : public ASTKindVisitor<ReadWriteCounter> {
   const std::shared_ptr<StencilInstantiation>& instantiation_;
 
   std::size_t numReads_, numWrites_;
@@ -108,10 +108,10 @@ public:
                                     : stencilFunCalls_.top()->getStencilFunctionInstantiation(expr);
   }
 
-  Array3i getOffset(const std::shared_ptr<FieldAccessExpr>& field) {
+  Array3i getOffset(const FieldAccessExpr& field, const std::shared_ptr<Expr>& node) {
     return stencilFunCalls_.empty()
-               ? field->getOffset()
-               : stencilFunCalls_.top()->evalOffsetOfFieldAccessExpr(field, true);
+               ? field.getOffset()
+               : stencilFunCalls_.top()->evalOffsetOfFieldAccessExpr(field, node, true);
   };
 
   void updateKCache(int AccessID) {
@@ -138,7 +138,7 @@ public:
     kCacheLoaded_.insert(AccessID);
   }
 
-  void processWriteAccess(const std::shared_ptr<FieldAccessExpr>& field) {
+  void processWriteAccess(const std::shared_ptr<Expr>& field) {
     int AccessID = getAccessIDFromExpr(field);
 
     // Is field stored in cache?
@@ -154,9 +154,9 @@ public:
     }
   }
 
-  void processReadAccess(const std::shared_ptr<FieldAccessExpr>& fieldExpr) {
-    int AccessID = getAccessIDFromExpr(fieldExpr);
-    int kOffset = fieldExpr->getOffset()[2];
+  void processReadAccess(const FieldAccessExpr& fieldExpr, const std::shared_ptr<Expr>& node) {
+    int AccessID = getAccessIDFromExpr(node);
+    int kOffset = fieldExpr.getOffset()[2];
 
     auto it = fields_.find(AccessID);
     DAWN_ASSERT(it != fields_.end());
@@ -166,7 +166,7 @@ public:
       if(!register_.count(AccessID)) {
 
         // Cache the center access
-        if(getOffset(fieldExpr) == Array3i{{0, 0, 0}})
+        if(getOffset(fieldExpr, node) == Array3i{{0, 0, 0}})
           register_.insert(AccessID);
 
         // Check if the field is either cached or stored in the texture cache
@@ -181,7 +181,7 @@ public:
       if(!multiStage_.isCached(AccessID)) {
 
         // Check if the center is stored in a register
-        if(!(register_.count(AccessID) && getOffset(fieldExpr) == Array3i{{0, 0, 0}})) {
+        if(!(register_.count(AccessID) && getOffset(fieldExpr, node) == Array3i{{0, 0, 0}})) {
           numReads_++;
           individualReadWrites_[AccessID].numReads++;
         }
@@ -195,30 +195,34 @@ public:
       updateTextureCache(AccessID, kOffset);
   }
 
-  void visit(const std::shared_ptr<AssignmentExpr>& expr) override {
+  void visitAssignmentExpr(const AssignmentExpr& expr, const std::shared_ptr<Expr>& node) {
     // LHS is a write and maybe a read if we have an expression like `a += 5`
-    bool readAndWrite = StringRef(expr->getOp()) == "+=" || StringRef(expr->getOp()) == "-=" ||
-                        StringRef(expr->getOp()) == "/=" || StringRef(expr->getOp()) == "*=" ||
-                        StringRef(expr->getOp()) == "|=" || StringRef(expr->getOp()) == "&=";
+    bool readAndWrite = StringRef(expr.getOp()) == "+=" || StringRef(expr.getOp()) == "-=" ||
+                        StringRef(expr.getOp()) == "/=" || StringRef(expr.getOp()) == "*=" ||
+                        StringRef(expr.getOp()) == "|=" || StringRef(expr.getOp()) == "&=";
 
-    if(isa<FieldAccessExpr>(expr->getLeft().get())) {
-      auto field = std::static_pointer_cast<FieldAccessExpr>(expr->getLeft());
-      processWriteAccess(field);
+    const std::shared_ptr<Expr>& left = expr.getLeft();
+    if(const FieldAccessExpr* field = dyn_cast<FieldAccessExpr>(left.get())) {
+      processWriteAccess(left);
       if(readAndWrite)
-        processReadAccess(field);
+        processReadAccess(*field, left);
     }
 
     // RHS are read accesses
-    expr->getRight()->accept(*this);
+    visit(expr.getRight());
   }
 
-  void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override {
-    stencilFunCalls_.push(getStencilFunctionInstantiation(expr));
-    stencilFunCalls_.top()->getAST()->accept(*this);
+  void visitStencilFunCallExpr(const StencilFunCallExpr& expr, const std::shared_ptr<Expr>& node) {
+    stencilFunCalls_.push(
+        getStencilFunctionInstantiation(std::static_pointer_cast<StencilFunCallExpr>(node)));
+    visit(*stencilFunCalls_.top()->getAST());
     stencilFunCalls_.pop();
   }
 
-  void visit(const std::shared_ptr<FieldAccessExpr>& expr) override { processReadAccess(expr); }
+  void visitFieldAccessExpr(const FieldAccessExpr& expr, const std::shared_ptr<Expr>& node) {
+    processReadAccess(expr, node);
+  }
+
   const std::unordered_map<int, ReadWriteAccumulator>& getIndividualReadWrites() const {
     return individualReadWrites_;
   }
@@ -283,7 +287,7 @@ std::unordered_map<int, ReadWriteAccumulator> computeReadWriteAccessesMetricPerA
   for(const auto& stage : multiStage.getStages())
     for(const auto& DoMethod : stage->getDoMethods())
       for(const auto& statementAccessesPair : DoMethod->getStatementAccessesPairs()) {
-        statementAccessesPair->getStatement()->ASTStmt->accept(readWriteCounter);
+        readWriteCounter.visit(statementAccessesPair->getStatement()->ASTStmt);
       }
 
   return readWriteCounter.getIndividualReadWrites();
@@ -298,7 +302,7 @@ computeReadWriteAccessesMetric(const std::shared_ptr<StencilInstantiation>& inst
   for(const auto& stage : multiStage.getStages())
     for(const auto& DoMethod : stage->getDoMethods())
       for(const auto& statementAccessesPair : DoMethod->getStatementAccessesPairs()) {
-        statementAccessesPair->getStatement()->ASTStmt->accept(readWriteCounter);
+        readWriteCounter.visit(statementAccessesPair->getStatement()->ASTStmt);
       }
 
   return std::make_pair(readWriteCounter.getNumReads(), readWriteCounter.getNumWrites());
@@ -0,0 +1,207 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/Optimizer/PassDeadCodeElimination.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/StatementAccessesPair.h"
+#include "dawn/Optimizer/Stencil.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include <algorithm>
+#include <iostream>
+#include <set>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Check if `AccessID` is a temporary or a local variable, i.e if the writes to it are
+/// only observable by the statements of the stencil
+bool isLocalToStencil(const StencilInstantiation* instantiation, int AccessID) {
+  if(instantiation->isField(AccessID))
+    return instantiation->isTemporaryField(AccessID);
+  return instantiation->isVariable(AccessID) && !instantiation->isGlobalVariable(AccessID);
+}
+
+/// @brief Find the dead statements of `stencil`
+class DeadStatementFinder {
+  const StencilInstantiation* instantiation_;
+
+  /// AccessIDs read by the statements visited so far (i.e executed after the current statement)
+  std::set<int> liveAccessIDs_;
+
+  /// Temporaries read with a vertical offset in the current multi-stage
+  std::set<int> verticalReadAccessIDs_;
+
+  std::set<const StatementAccessesPair*>& deadPairs_;
+
+public:
+  DeadStatementFinder(const StencilInstantiation* instantiation,
+                      std::set<const StatementAccessesPair*>& deadPairs)
+      : instantiation_(instantiation), deadPairs_(deadPairs) {}
+
+  void run(const Stencil& stencil) {
+    const auto& multiStages = stencil.getMultiStages();
+    for(auto multiStageIt = multiStages.rbegin(); multiStageIt != multiStages.rend();
+        ++multiStageIt) {
+      const auto& stages = (*multiStageIt)->getStages();
+
+      verticalReadAccessIDs_.clear();
+      for(const auto& stagePtr : stages)
+        for(const auto& doMethodPtr : stagePtr->getDoMethods())
+          for(const auto& pair : doMethodPtr->getStatementAccessesPairs())
+            for(const auto& accessIDExtentsPair : pair->getAccesses()->getReadAccesses())
+              if(!accessIDExtentsPair.second.isVerticalPointwise())
+                verticalReadAccessIDs_.insert(accessIDExtentsPair.first);
+
+      for(auto stageIt = stages.rbegin(); stageIt != stages.rend(); ++stageIt) {
+        const auto& doMethods = (*stageIt)->getDoMethods();
+        for(auto doMethodIt = doMethods.rbegin(); doMethodIt != doMethods.rend(); ++doMethodIt) {
+          const auto& pairs = (*doMethodIt)->getStatementAccessesPairs();
+          for(auto pairIt = pairs.rbegin(); pairIt != pairs.rend(); ++pairIt)
+            visit(**pairIt);
+        }
+      }
+    }
+  }
+
+private:
+  void visit(const StatementAccessesPair& pair) {
+    // A statement which writes nothing is kept, it is not known to be free of side effects
+    const auto& writeAccesses = pair.getAccesses()->getWriteAccesses();
+    bool isDead =
+        !writeAccesses.empty() &&
+        std::all_of(writeAccesses.begin(), writeAccesses.end(),
+                    [&](const std::pair<int, Extents>& access) {
+                      return isLocalToStencil(instantiation_, access.first) &&
+                             !liveAccessIDs_.count(access.first) &&
+                             !verticalReadAccessIDs_.count(access.first);
+                    });
+
+    if(isDead) {
+      deadPairs_.insert(&pair);
+      return;
+    }
+
+    for(const auto& accessIDExtentsPair : pair.getAccesses()->getReadAccesses())
+      liveAccessIDs_.insert(accessIDExtentsPair.first);
+  }
+};
+
+} // anonymous namespace
+
+PassDeadCodeElimination::PassDeadCodeElimination() : Pass("PassDeadCodeElimination") {}
+
+bool PassDeadCodeElimination::run(
+    const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
+  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+  if(!context->getOptions().DCE)
+    return true;
+
+  std::set<const StatementAccessesPair*> deadPairs;
+  for(const auto& stencilPtr : stencilInstantiation->getStencils())
+    DeadStatementFinder(stencilInstantiation.get(), deadPairs).run(*stencilPtr);
+
+  // Remove the dead statements and the Do-Methods, stages and multi-stages which become empty
+  std::set<int> unusedAccessIDs;
+  int numRemovedStages = 0;
+  int numRemovedMultiStages = 0;
+
+  for(auto& stencilPtr : stencilInstantiation->getStencils()) {
+    auto& multiStages = stencilPtr->getMultiStages();
+    for(auto multiStageIt = multiStages.begin(); multiStageIt != multiStages.end();) {
+      auto& stages = (*multiStageIt)->getStages();
+      for(auto stageIt = stages.begin(); stageIt != stages.end();) {
+        Stage& stage = **stageIt;
+        bool modified = false;
+
+        for(auto& doMethodPtr : stage.getDoMethods()) {
+          auto& pairs = doMethodPtr->getStatementAccessesPairs();
+          auto deadBegin =
+              std::stable_partition(pairs.begin(), pairs.end(),
+                                    [&](const std::shared_ptr<StatementAccessesPair>& pair) {
+                                      return !deadPairs.count(pair.get());
+                                    });
+          for(auto it = deadBegin; it != pairs.end(); ++it) {
+            for(const auto& access : (*it)->getAccesses()->getWriteAccesses())
+              unusedAccessIDs.insert(access.first);
+            for(const auto& access : (*it)->getAccesses()->getReadAccesses())
+              unusedAccessIDs.insert(access.first);
+            modified = true;
+          }
+          pairs.erase(deadBegin, pairs.end());
+        }
+
+        if(!modified) {
+          ++stageIt;
+          continue;
+        }
+
+        auto& doMethods = stage.getDoMethods();
+        doMethods.erase(std::remove_if(doMethods.begin(), doMethods.end(),
+                                       [](const std::unique_ptr<DoMethod>& doMethod) {
+                                         return doMethod->getStatementAccessesPairs().empty();
+                                       }),
+                        doMethods.end());
+        if(doMethods.empty()) {
+          stageIt = stages.erase(stageIt);
+          numRemovedStages++;
+        } else {
+          stage.update();
+          ++stageIt;
+        }
+      }
+
+      if(stages.empty()) {
+        multiStageIt = multiStages.erase(multiStageIt);
+        numRemovedMultiStages++;
+      } else
+        ++multiStageIt;
+    }
+  }
+
+  // Release the temporaries and local variables which are not accessed anymore
+  for(const auto& stencilPtr : stencilInstantiation->getStencils())
+    stencilPtr->forEachStatementAccessesPair(
+        [&](ArrayRef<std::shared_ptr<StatementAccessesPair>> pairs) {
+          for(const auto& pair : pairs) {
+            for(const auto& access : pair->getAccesses()->getWriteAccesses())
+              unusedAccessIDs.erase(access.first);
+            for(const auto& access : pair->getAccesses()->getReadAccesses())
+              unusedAccessIDs.erase(access.first);
+          }
+        });
+
+  int numRemovedTemporaries = 0;
+  int numRemovedVariables = 0;
+  for(int AccessID : unusedAccessIDs) {
+    if(!isLocalToStencil(stencilInstantiation.get(), AccessID))
+      continue;
+    if(stencilInstantiation->isTemporaryField(AccessID))
+      numRemovedTemporaries++;
+    else
+      numRemovedVariables++;
+    stencilInstantiation->removeAccessID(AccessID);
+  }
+
+  if(context->getOptions().ReportPassDCE)
+    std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName() << ": removed "
+              << deadPairs.size() << " statements, " << numRemovedTemporaries << " temporaries, "
+              << numRemovedVariables << " local variables, " << numRemovedStages << " stages and "
+              << numRemovedMultiStages << " multi-stages\n";
+
+  return true;
+}
+
+} // namespace dawn
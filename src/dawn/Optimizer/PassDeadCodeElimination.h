@@ -0,0 +1,49 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#ifndef DAWN_OPTIMIZER_PASSDEADCODEELIMINATION_H
+#define DAWN_OPTIMIZER_PASSDEADCODEELIMINATION_H
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief Remove statements whose results are never read and the temporaries and local variables
+/// which are no longer used
+///
+/// A top-level statement is dead if it writes to at least one field or variable and only to
+/// temporaries and local variables which are not read by any statement executed after it (in the
+/// order of the multi-stages, stages and statements of a stencil). Temporaries which are read with
+/// a vertical offset are kept alive in the whole multi-stage as they may be read on another
+/// vertical level before they are written. The statements are visited backwards, hence statements
+/// which only feed dead statements are removed as well.
+///
+/// The AccessIDs of the unused temporaries and local variables are released and the Do-Methods,
+/// stages and multi-stages which become empty are removed.
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassDeadCodeElimination : public Pass {
+public:
+  PassDeadCodeElimination();
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) override;
+};
+
+} // namespace dawn
+
+#endif
@@ -20,6 +20,7 @@
 #include "dawn/SIR/AST.h"
 #include "dawn/SIR/ASTUtil.h"
 #include "dawn/SIR/ASTVisitor.h"
+#include <algorithm>
 #include <iostream>
 #include <stack>
 #include <unordered_map>
@@ -30,16 +31,159 @@ namespace dawn {
 namespace {
 
 class Inliner;
+class StrategyResolver;
 
 static std::pair<bool, std::shared_ptr<Inliner>> tryInlineStencilFunction(
-    PassInlining::InlineStrategyKind strategy,
+    StrategyResolver& resolver, PassInlining::InlineStrategyKind callStrategy,
     const std::shared_ptr<StencilFunctionInstantiation>& stencilFunctioninstantiation,
     const std::shared_ptr<StatementAccessesPair>& oldStmt,
     std::vector<std::shared_ptr<StatementAccessesPair>>& newStmts, int AccessIDOfCaller);
 
+/// Bytes moved per grid point if the result of a stencil function is precomputed into a temporary
+/// (one write and one read, the further reads of its consumers are assumed to hit the cache)
+constexpr double TemporaryTrafficInBytes = 2 * 8;
+
+/// Number of operations which can be executed in the time it takes to move one byte (a
+/// conservative machine balance, current CPUs and GPUs are well above one)
+constexpr double FlopsPerByte = 1;
+
+/// @brief Count the operations of the AST of a stencil function and the reads of each field
+class OperationCounter : public ASTVisitorForwarding {
+  const std::shared_ptr<StencilFunctionInstantiation>& function_;
+  double numOps_;
+  std::unordered_map<std::string, int> numReads_;
+
+public:
+  using Base = ASTVisitorForwarding;
+
+  OperationCounter(const std::shared_ptr<StencilFunctionInstantiation>& function)
+      : function_(function), numOps_(0) {}
+
+  double getNumOps() const { return numOps_; }
+
+  /// @brief Number of reads of the field `name` (i.e the consumers of an argument function)
+  int getNumReads(const std::string& name) const {
+    auto it = numReads_.find(name);
+    return it != numReads_.end() ? it->second : 0;
+  }
+
+  void visit(const std::shared_ptr<UnaryOperator>& expr) override {
+    numOps_++;
+    Base::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<BinaryOperator>& expr) override {
+    numOps_++;
+    Base::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<TernaryOperator>& expr) override {
+    numOps_++;
+    Base::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<FunCallExpr>& expr) override {
+    numOps_++;
+    Base::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override;
+
+  void visit(const std::shared_ptr<FieldAccessExpr>& expr) override {
+    numReads_[expr->getName()]++;
+  }
+};
+
+/// @brief Cost (operations per grid point) of a stencil function call and the calls in its
+/// argument list
+struct CallCost {
+  double OnTheFly;    ///< The call is recomputed for each consumer of its result
+  double Precomputed; ///< The call is computed once, argument functions are stored in temporaries
+};
+
+/// @brief Estimate the cost of calling `function` whose result is read by `numConsumers`
+/// expressions (the memory traffic of the temporaries is converted to operations using the machine
+/// balance)
+///
+/// With a single consumer the precomputation only adds the traffic of the temporary.
+static CallCost getCallCost(const std::shared_ptr<StencilFunctionInstantiation>& function,
+                            int numConsumers) {
+  OperationCounter counter(function);
+  function->getAST()->accept(counter);
+
+  CallCost cost{counter.getNumOps(), counter.getNumOps()};
+  for(std::size_t argIdx = 0; argIdx < function->numArgs(); ++argIdx) {
+    if(!function->isArgStencilFunctionInstantiation(argIdx))
+      continue;
+
+    CallCost argCost =
+        getCallCost(function->getFunctionInstantiationOfArgField(argIdx),
+                    std::max(1, counter.getNumReads(function->getArguments()[argIdx]->Name)));
+    cost.OnTheFly += argCost.OnTheFly;
+    cost.Precomputed += argCost.Precomputed + TemporaryTrafficInBytes * FlopsPerByte;
+  }
+  cost.OnTheFly *= numConsumers;
+  return cost;
+}
+
+void OperationCounter::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
+  // Calls within the body are decided on their own once the body is inlined
+  CallCost cost = getCallCost(function_->getStencilFunctionInstantiation(expr), 1);
+  numOps_ += std::min(cost.OnTheFly, cost.Precomputed);
+}
+
+/// @brief Resolve the strategy of the calls which are not part of the argument list of another
+/// stencil function
+///
+/// The call and all the calls in its argument list are either inlined and precomputed or all kept,
+/// a stencil function can only be inlined if its arguments are precomputed. Each call is decided
+/// (and reported) once, the decision is shared by the detection of the inline candidates and the
+/// inlining of the calls within the inlined functions.
+class StrategyResolver {
+  PassInlining::InlineStrategyKind strategy_;
+  std::unordered_map<std::shared_ptr<StencilFunctionInstantiation>,
+                     PassInlining::InlineStrategyKind>
+      callStrategies_;
+
+public:
+  StrategyResolver(PassInlining::InlineStrategyKind strategy) : strategy_(strategy) {}
+
+  /// @brief Strategy of the call to `function`
+  PassInlining::InlineStrategyKind
+  resolve(const std::shared_ptr<StencilFunctionInstantiation>& function) {
+    if(strategy_ != PassInlining::IK_Auto)
+      return strategy_;
+
+    // Functions without a return are always inlined
+    if(!function->hasReturn())
+      return PassInlining::IK_Precomputation;
+
+    auto it = callStrategies_.find(function);
+    if(it != callStrategies_.end())
+      return it->second;
+
+    // The result of a call in a statement is read once
+    CallCost cost = getCallCost(function, 1);
+    PassInlining::InlineStrategyKind callStrategy = cost.Precomputed < cost.OnTheFly
+                                                        ? PassInlining::IK_Precomputation
+                                                        : PassInlining::IK_ComputationOnTheFly;
+    callStrategies_.emplace(function, callStrategy);
+
+    StencilInstantiation* instantiation = function->getStencilInstantiation();
+    if(instantiation->getOptimizerContext()->getOptions().ReportPassInlining)
+      std::cout << "\nPASS: PassInlining: " << instantiation->getName() << ": "
+                << function->getName() << ": "
+                << (callStrategy == PassInlining::IK_Precomputation ? "precompute"
+                                                                     : "compute on the fly")
+                << " (cost on the fly: " << cost.OnTheFly << ", precomputed: " << cost.Precomputed
+                << ")" << std::endl;
+    return callStrategy;
+  }
+};
+
 /// @brief Perform the inlining of a stencil-function
 class Inliner : public ASTVisitor {
-  PassInlining::InlineStrategyKind strategy_;
+  StrategyResolver& resolver_;
   const std::shared_ptr<StencilFunctionInstantiation>& curStencilFunctioninstantiation_;
   StencilInstantiation* instantiation_;
 
@@ -51,8 +195,8 @@ class Inliner : public ASTVisitor {
 
   /// If a stencil function is called within the argument list of another stencil function, this
   /// stores the AccessID of the "temporary" storage we would need to store the return value of the
-  /// stencil function (See StatementMapper::visit(const std::shared_ptr<StencilFunCallExpr>& expr)
-  /// in StencilInstantiation.cpp). An AccessID of 0 indicates we are not in this scenario.
+  /// stencil function (See StatementMapper::visitStencilFunCallExpr in
+  /// StatementMapper.cpp). An AccessID of 0 indicates we are not in this scenario.
   int AccessIDOfCaller_;
 
   /// Nesting of the scopes
@@ -63,22 +207,24 @@ class Inliner : public ASTVisitor {
 
   /// Scope of the current argument list being parsed
   struct ArgListScope {
-    ArgListScope(const std::shared_ptr<StencilFunctionInstantiation>& function)
-        : Function(function), ArgumentIndex(0) {}
+    ArgListScope(const std::shared_ptr<StencilFunctionInstantiation>& function,
+                 PassInlining::InlineStrategyKind strategy)
+        : Function(function), ArgumentIndex(0), Strategy(strategy) {}
 
     const std::shared_ptr<StencilFunctionInstantiation>& Function;
     int ArgumentIndex;
+    PassInlining::InlineStrategyKind Strategy; ///< Strategy of the call of `Function`
   };
 
   std::stack<ArgListScope> argListScope_;
 
 public:
-  Inliner(PassInlining::InlineStrategyKind strategy,
+  Inliner(StrategyResolver& resolver,
           const std::shared_ptr<StencilFunctionInstantiation>& stencilFunctioninstantiation,
           const std::shared_ptr<StatementAccessesPair>& oldStmtAccessesPair,
           std::vector<std::shared_ptr<StatementAccessesPair>>& newStmtAccessesPairs,
           int AccessIDOfCaller = 0)
-      : strategy_(strategy), curStencilFunctioninstantiation_(stencilFunctioninstantiation),
+      : resolver_(resolver), curStencilFunctioninstantiation_(stencilFunctioninstantiation),
         instantiation_(stencilFunctioninstantiation->getStencilInstantiation()),
         oldStmtAccessesPair_(oldStmtAccessesPair), newStmtAccessesPairs_(newStmtAccessesPairs),
         AccessIDOfCaller_(AccessIDOfCaller), scopeDepth_(0), newExpr_(nullptr) {}
@@ -220,15 +366,20 @@ public:
       DAWN_ASSERT(curFunc->isProvidedByStencilFunctionCall(AccessIDOfCaller));
     }
 
+    // Calls in an argument list follow the strategy of the enclosing call
+    PassInlining::InlineStrategyKind callStrategy =
+        argListScope_.empty() ? resolver_.resolve(func) : argListScope_.top().Strategy;
+
     // Resolve the arguments
-    argListScope_.push(ArgListScope(func));
+    argListScope_.push(ArgListScope(func, callStrategy));
     for(const auto& arg : expr->getArguments())
       arg->accept(*this);
     argListScope_.pop();
 
     // Try to inline the stencil-function
-    auto inlineResult = tryInlineStencilFunction(strategy_, func, oldStmtAccessesPair_,
-                                                 newStmtAccessesPairs_, AccessIDOfCaller);
+    auto inlineResult =
+        tryInlineStencilFunction(resolver_, callStrategy, func, oldStmtAccessesPair_,
+                                 newStmtAccessesPairs_, AccessIDOfCaller);
     if(inlineResult.first) {
 
       // Compute the index of the statement of our current stencil-function call
@@ -307,7 +458,7 @@ public:
 
 /// @brief Detect inline candidates
 class DetectInlineCandiates : public ASTVisitorForwarding {
-  PassInlining::InlineStrategyKind strategy_;
+  StrategyResolver resolver_;
   const std::shared_ptr<StencilInstantiation>& instantiation_;
 
   /// The statement we are currently analyzing
@@ -324,11 +475,13 @@ class DetectInlineCandiates : public ASTVisitorForwarding {
 
   /// Scope of the current argument list being parsed
   struct ArgListScope {
-    ArgListScope(const std::shared_ptr<StencilFunctionInstantiation>& function)
-        : Function(function), ArgumentIndex(0) {}
+    ArgListScope(const std::shared_ptr<StencilFunctionInstantiation>& function,
+                 PassInlining::InlineStrategyKind strategy)
+        : Function(function), ArgumentIndex(0), Strategy(strategy) {}
 
     const std::shared_ptr<StencilFunctionInstantiation>& Function;
     int ArgumentIndex;
+    PassInlining::InlineStrategyKind Strategy; ///< Strategy of the call of `Function`
   };
 
   std::stack<ArgListScope> argListScope_;
@@ -338,7 +491,7 @@ public:
 
   DetectInlineCandiates(PassInlining::InlineStrategyKind strategy,
                         const std::shared_ptr<StencilInstantiation>& instantiation)
-      : strategy_(strategy), instantiation_(instantiation), inlineCandiatesFound_(false) {}
+      : resolver_(strategy), instantiation_(instantiation), inlineCandiatesFound_(false) {}
 
   /// @brief Process the given statement
   void processStatment(const std::shared_ptr<StatementAccessesPair>& stmtAccesesPair) {
@@ -390,13 +543,17 @@ public:
       DAWN_ASSERT(curFunc->isProvidedByStencilFunctionCall(AccessIDOfCaller));
     }
 
-    argListScope_.push(ArgListScope(func));
+    PassInlining::InlineStrategyKind callStrategy =
+        argListScope_.empty() ? resolver_.resolve(func) : argListScope_.top().Strategy;
+
+    argListScope_.push(ArgListScope(func, callStrategy));
     for(const auto& arg : expr->getArguments())
       arg->accept(*this);
     argListScope_.pop();
 
-    auto inlineResult = tryInlineStencilFunction(strategy_, func, oldStmtAccessesPair_,
-                                                 newStmtAccessesPairs_, AccessIDOfCaller);
+    auto inlineResult =
+        tryInlineStencilFunction(resolver_, callStrategy, func, oldStmtAccessesPair_,
+                                 newStmtAccessesPairs_, AccessIDOfCaller);
 
     inlineCandiatesFound_ |= inlineResult.first;
     if(inlineResult.first) {
@@ -428,8 +585,10 @@ public:
 /// @brief Decides if a stencil function is suitable for inlining and performs the inlining by
 /// appending to `newStmts`
 ///
-/// @param strategy          Inlining strategy to use (decides between computation on the fly and
-///                          precomputation)
+/// @param resolver          Resolves the strategy of the calls within the inlined function
+/// @param callStrategy      Strategy of this call (decides between computation on the fly and
+///                          precomputation, differs from the strategy of the pass if the latter
+///                          is `IK_Auto`)
 /// @param stencilFunc       The stencil function to be considered for inlining
 /// @param oldStmt           The statement we are currently analyzing
 /// @param newStmts          The list of new statements which serve as a replacement for `oldStmt`
@@ -440,7 +599,8 @@ public:
 /// @returns `true` if the stencil-function was inlined, `false` otherwise (the corresponding
 /// `Inliner` instance (or NULL) is returned as well)
 static std::pair<bool, std::shared_ptr<Inliner>>
-tryInlineStencilFunction(PassInlining::InlineStrategyKind strategy,
+tryInlineStencilFunction(StrategyResolver& resolver,
+                         PassInlining::InlineStrategyKind callStrategy,
                          const std::shared_ptr<StencilFunctionInstantiation>& stencilFunc,
                          const std::shared_ptr<StatementAccessesPair>& oldStmtAccessesPair,
                          std::vector<std::shared_ptr<StatementAccessesPair>>& newStmtAccessesPairs,
@@ -448,8 +608,8 @@ tryInlineStencilFunction(PassInlining::InlineStrategyKind strategy,
 
   // Function which do not return a value are *always* inlined. Function which do return a value
   // are only inlined if we favor precomputations.
-  if(!stencilFunc->hasReturn() || strategy == PassInlining::IK_Precomputation) {
-    auto inliner = std::make_shared<Inliner>(strategy, stencilFunc, oldStmtAccessesPair,
+  if(!stencilFunc->hasReturn() || callStrategy == PassInlining::IK_Precomputation) {
+    auto inliner = std::make_shared<Inliner>(resolver, stencilFunc, oldStmtAccessesPair,
                                              newStmtAccessesPairs, AccessIDOfCaller);
     stencilFunc->getAST()->accept(*inliner);
     return std::pair<bool, std::shared_ptr<Inliner>>(true, std::move(inliner));
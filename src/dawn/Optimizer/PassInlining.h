@@ -23,7 +23,9 @@ namespace dawn {
 ///
 /// Stencil functions which do not have a return are always inlined (if the pass is not disabled).
 /// Depending on the strategy, stencil functions which do have a return are only inlined if we
-/// favor precomputations.
+/// favor precomputations. The automatic strategy weighs, for each call which is not part of the
+/// argument list of another call, the operations recomputed for every consumer reading the result
+/// of an argument function against the memory traffic of precomputing it into a temporary.
 ///
 /// If a stencil function is inlined the AST is modified and it may happen that certain statements
 /// and expressions do not carry a valid SourceLocation anymore!
@@ -38,7 +40,8 @@ public:
     IK_Unknown,
     IK_None,                ///< Skip inlining pass
     IK_ComputationOnTheFly, ///< Favor computations on the fly
-    IK_Precomputation       ///< Favor precomputation when possible
+    IK_Precomputation,      ///< Favor precomputation when possible
+    IK_Auto                 ///< Decide per call site using a cost model
   };
 
   PassInlining(InlineStrategyKind strategy);
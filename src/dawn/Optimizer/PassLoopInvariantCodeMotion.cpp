@@ -0,0 +1,324 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/Optimizer/PassLoopInvariantCodeMotion.h"
+#include "dawn/Optimizer/AccessComputation.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/PassSetStageName.h"
+#include "dawn/Optimizer/StatementAccessesPair.h"
+#include "dawn/Optimizer/Stencil.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/AST.h"
+#include "dawn/SIR/ASTUtil.h"
+#include "dawn/Support/Casting.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <vector>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Maximal vertically invariant subexpression of a statement
+struct Occurrence {
+  Stage* ParentStage;                          ///< Stage of the statement
+  std::shared_ptr<StatementAccessesPair> Pair; ///< Top-level statement containing the expression
+  std::shared_ptr<Expr> Root;                  ///< The expression
+};
+
+/// @brief Collect the maximal vertically invariant subexpressions of a statement which are worth
+/// hoisting (they perform at least one operation and read at least one field)
+///
+/// The hoisted expressions are evaluated at every grid point, hence expressions which are only
+/// evaluated conditionally (in a branch of an if-statement, a ternary operator or the right operand
+/// of a logical operator) are not hoisted if they may trap (divisions, which may be integer
+/// divisions by zero).
+class InvariantExpressionCollector {
+  const StencilInstantiation* instantiation_;
+  const std::set<int>& writtenAccessIDs_;
+  std::vector<std::shared_ptr<Expr>>& roots_;
+
+  struct ExprInfo {
+    bool IsInvariant;
+    int Flops;
+    bool ReadsField;
+  };
+
+public:
+  InvariantExpressionCollector(const StencilInstantiation* instantiation,
+                               const std::set<int>& writtenAccessIDs,
+                               std::vector<std::shared_ptr<Expr>>& roots)
+      : instantiation_(instantiation), writtenAccessIDs_(writtenAccessIDs), roots_(roots) {}
+
+  /// @brief Collect the expressions of `stmt` (including its nested statements)
+  void collect(const std::shared_ptr<Stmt>& stmt, bool isConditional = false) {
+    if(const IfStmt* ifStmt = dyn_cast<IfStmt>(stmt.get())) {
+      collect(ifStmt->getCondStmt(), isConditional);
+      collect(ifStmt->getThenStmt(), true);
+      if(ifStmt->hasElse())
+        collect(ifStmt->getElseStmt(), true);
+      return;
+    }
+
+    if(const ExprStmt* exprStmt = dyn_cast<ExprStmt>(stmt.get()))
+      collect(exprStmt->getExpr(), isConditional);
+    else if(const ReturnStmt* returnStmt = dyn_cast<ReturnStmt>(stmt.get()))
+      collect(returnStmt->getExpr(), isConditional);
+    else if(const VarDeclStmt* varDecl = dyn_cast<VarDeclStmt>(stmt.get()))
+      for(const auto& init : varDecl->getInitList())
+        collect(init, isConditional);
+
+    for(const auto& child : stmt->getChildren())
+      collect(child, isConditional);
+  }
+
+private:
+  void collect(const std::shared_ptr<Expr>& expr, bool isConditional) {
+    ExprInfo info = visit(expr, isConditional);
+    if(info.IsInvariant)
+      record(expr, info);
+  }
+
+  void record(const std::shared_ptr<Expr>& expr, const ExprInfo& info) {
+    if(info.Flops > 0 && info.ReadsField)
+      roots_.push_back(expr);
+  }
+
+  /// @brief Check if `expr` is invariant and record its maximal invariant subexpressions if it is
+  /// not
+  ExprInfo visit(const std::shared_ptr<Expr>& expr, bool isConditional) {
+    ExprInfo info{true, 0, false};
+    int firstConditionalChild = -1;
+
+    switch(expr->getKind()) {
+    case Expr::EK_UnaryOperator: {
+      const char* op = cast<UnaryOperator>(expr.get())->getOp();
+      info.IsInvariant = std::strcmp(op, "++") != 0 && std::strcmp(op, "--") != 0;
+      info.Flops = 1;
+      break;
+    }
+    case Expr::EK_BinaryOperator: {
+      const char* op = cast<BinaryOperator>(expr.get())->getOp();
+      info.IsInvariant =
+          !isConditional || (std::strcmp(op, "/") != 0 && std::strcmp(op, "%") != 0);
+      if(std::strcmp(op, "&&") == 0 || std::strcmp(op, "||") == 0)
+        firstConditionalChild = 1;
+      info.Flops = 1;
+      break;
+    }
+    case Expr::EK_TernaryOperator:
+      firstConditionalChild = 1;
+      info.Flops = 1;
+      break;
+    case Expr::EK_FunCallExpr:
+      info.Flops = 1;
+      break;
+    case Expr::EK_FieldAccessExpr: {
+      int AccessID = instantiation_->getAccessIDFromExpr(expr);
+      info.IsInvariant = !cast<FieldAccessExpr>(expr.get())->hasArguments() &&
+                         instantiation_->isHorizontalField(AccessID) &&
+                         !writtenAccessIDs_.count(AccessID);
+      info.ReadsField = true;
+      break;
+    }
+    case Expr::EK_VarAccessExpr:
+      info.IsInvariant =
+          !cast<VarAccessExpr>(expr.get())->isArrayAccess() &&
+          instantiation_->isGlobalVariable(instantiation_->getAccessIDFromExpr(expr));
+      break;
+    case Expr::EK_LiteralAccessExpr:
+      break;
+    case Expr::EK_AssignmentExpr:
+      info.IsInvariant = false;
+      break;
+    default:
+      // Calls to stencil functions (and their arguments) are left alone as the optimizer keeps one
+      // stencil function instantiation per call
+      return ExprInfo{false, 0, false};
+    }
+
+    std::vector<std::pair<std::shared_ptr<Expr>, ExprInfo>> children;
+    int childIdx = 0;
+    for(const auto& child : expr->getChildren()) {
+      bool isChildConditional =
+          isConditional || (firstConditionalChild != -1 && childIdx >= firstConditionalChild);
+      childIdx++;
+      ExprInfo childInfo = visit(child, isChildConditional);
+      info.IsInvariant &= childInfo.IsInvariant;
+      info.Flops += childInfo.Flops;
+      info.ReadsField |= childInfo.ReadsField;
+      children.emplace_back(child, childInfo);
+    }
+
+    if(!info.IsInvariant)
+      for(const auto& childInfoPair : children)
+        if(childInfoPair.second.IsInvariant)
+          record(childInfoPair.first, childInfoPair.second);
+
+    return info;
+  }
+};
+
+} // anonymous namespace
+
+PassLoopInvariantCodeMotion::PassLoopInvariantCodeMotion()
+    : Pass("PassLoopInvariantCodeMotion") {}
+
+bool PassLoopInvariantCodeMotion::run(
+    const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
+  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+  if(!context->getOptions().LICM)
+    return true;
+
+  // Fields written anywhere in the stencil instantiation are not invariant (the stencils may be
+  // called several times)
+  std::set<int> writtenAccessIDs;
+  for(const auto& stencilPtr : stencilInstantiation->getStencils())
+    for(const auto& multiStagePtr : stencilPtr->getMultiStages())
+      for(const auto& stagePtr : multiStagePtr->getStages())
+        for(const Field& field : stagePtr->getFields())
+          if(field.getIntend() != Field::IK_Input)
+            writtenAccessIDs.insert(field.getAccessID());
+
+  int numHoisted = 0;
+  int numFields = 0;
+
+  for(auto& stencilPtr : stencilInstantiation->getStencils()) {
+    auto& multiStages = stencilPtr->getMultiStages();
+
+    // Group the occurrences which compute the same value
+    std::vector<std::vector<Occurrence>> groups;
+    auto firstMultiStageIt = multiStages.end();
+    Interval firstInterval(0, 0);
+
+    for(auto multiStageIt = multiStages.begin(); multiStageIt != multiStages.end();
+        ++multiStageIt) {
+      for(const auto& stagePtr : (*multiStageIt)->getStages()) {
+        for(const auto& doMethodPtr : stagePtr->getDoMethods()) {
+          for(const auto& pair : doMethodPtr->getStatementAccessesPairs()) {
+            std::vector<std::shared_ptr<Expr>> roots;
+            InvariantExpressionCollector(stencilInstantiation.get(), writtenAccessIDs, roots)
+                .collect(pair->getStatement()->ASTStmt);
+
+            for(const auto& root : roots) {
+              auto groupIt = std::find_if(groups.begin(), groups.end(),
+                                          [&](const std::vector<Occurrence>& group) {
+                                            return group.front().Root->equals(root.get());
+                                          });
+              if(groupIt == groups.end())
+                groupIt = groups.emplace(groups.end());
+              groupIt->push_back(Occurrence{stagePtr.get(), pair, root});
+            }
+
+            if(!roots.empty() && firstMultiStageIt == multiStages.end()) {
+              firstMultiStageIt = multiStageIt;
+              firstInterval = doMethodPtr->getInterval();
+            }
+          }
+        }
+      }
+    }
+
+    // The stencils were already split, each hoisted expression adds a field to the stencil which
+    // must not exceed the maximal number of fields (the expressions with the most occurrences are
+    // kept)
+    if(context->getOptions().SplitStencils) {
+      int maxNumGroups = std::max(0, context->getOptions().MaxFieldsPerStencil -
+                                         static_cast<int>(stencilPtr->getFields().size()));
+      if(static_cast<int>(groups.size()) > maxNumGroups) {
+        std::stable_sort(groups.begin(), groups.end(),
+                         [](const std::vector<Occurrence>& a, const std::vector<Occurrence>& b) {
+                           return a.size() > b.size();
+                         });
+        groups.erase(groups.begin() + maxNumGroups, groups.end());
+      }
+    }
+
+    if(groups.empty())
+      continue;
+
+    // The hoisted expressions are computed on a single vertical level (the lower bound of the first
+    // Do-Method using them) in a new multi-stage which runs before the first multi-stage using them
+    Interval interval(firstInterval.lowerLevel(), firstInterval.lowerLevel(),
+                      firstInterval.lowerOffset(), firstInterval.lowerOffset());
+    auto multiStage =
+        std::make_shared<MultiStage>(*stencilInstantiation, LoopOrderKind::LK_Parallel);
+    auto stage = std::make_shared<Stage>(*stencilInstantiation, multiStage.get(),
+                                         stencilInstantiation->nextUID(), interval);
+    auto& hoistedPairs = stage->getSingleDoMethod().getStatementAccessesPairs();
+
+    std::vector<std::shared_ptr<StatementAccessesPair>> modifiedPairs;
+    std::set<Stage*> modifiedStages;
+
+    for(const auto& group : groups) {
+      // Register the new horizontal field which is allocated by the stencil wrapper
+      int AccessID = stencilInstantiation->nextUID();
+      std::string name = StencilInstantiation::makeTemporaryFieldname("licm", AccessID);
+      stencilInstantiation->setAccessIDNamePairOfField(AccessID, name, true);
+      stencilInstantiation->promoteTemporaryFieldToAllocatedField(AccessID);
+      stencilInstantiation->setFieldDimensions(AccessID, Array3i{{1, 1, 0}});
+
+      // Compute the expression ...
+      const Occurrence& leader = group.front();
+      auto fieldAccess = std::make_shared<FieldAccessExpr>(name);
+      stencilInstantiation->mapExprToAccessID(fieldAccess, AccessID);
+      auto assignment = std::make_shared<ExprStmt>(
+          std::make_shared<AssignmentExpr>(fieldAccess, leader.Root, "="));
+      hoistedPairs.push_back(std::make_shared<StatementAccessesPair>(
+          std::make_shared<Statement>(assignment, leader.Pair->getStatement()->StackTrace)));
+
+      // ... and replace all occurrences by an access to the field
+      for(const Occurrence& occurrence : group) {
+        auto access = std::make_shared<FieldAccessExpr>(name);
+        stencilInstantiation->mapExprToAccessID(access, AccessID);
+        replaceOldExprWithNewExprInStmt(occurrence.Pair->getStatement()->ASTStmt, occurrence.Root,
+                                        access);
+
+        if(std::find(modifiedPairs.begin(), modifiedPairs.end(), occurrence.Pair) ==
+           modifiedPairs.end())
+          modifiedPairs.push_back(occurrence.Pair);
+        modifiedStages.insert(occurrence.ParentStage);
+      }
+
+      numHoisted += group.size();
+      numFields++;
+    }
+
+    computeAccesses(stencilInstantiation.get(), hoistedPairs);
+    computeAccesses(stencilInstantiation.get(), modifiedPairs);
+
+    stage->update();
+    for(Stage* modifiedStage : modifiedStages)
+      modifiedStage->update();
+
+    multiStage->getStages().push_back(stage);
+    multiStages.insert(firstMultiStageIt, multiStage);
+  }
+
+  // Name the new stages
+  if(numFields != 0)
+    PassSetStageName().run(stencilInstantiation);
+
+  if(context->getOptions().ReportPassLICM)
+    std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName() << ": hoisted "
+              << numHoisted << " loop-invariant expressions into " << numFields
+              << " horizontal fields\n";
+
+  return true;
+}
+
+} // namespace dawn
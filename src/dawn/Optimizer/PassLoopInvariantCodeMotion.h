@@ -0,0 +1,49 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#ifndef DAWN_OPTIMIZER_PASSLOOPINVARIANTCODEMOTION_H
+#define DAWN_OPTIMIZER_PASSLOOPINVARIANTCODEMOTION_H
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief Hoist expressions which do not depend on the vertical level out of the vertical loops
+///
+/// An expression is invariant along the vertical if it only reads horizontal (2D) fields which are
+/// not written by the stencil instantiation, global variables and literals. The maximal invariant
+/// subexpressions of the statements which perform at least one operation and read at least one
+/// field are stored in a new horizontal field (identical expressions share the same field). The
+/// fields are computed once per column in a new multi-stage, which runs on a single vertical level
+/// before the first multi-stage using them, and are allocated by the stencil wrapper as 2D
+/// storages.
+///
+/// The pass runs after the multi-stages and stages have been split and merged, i.e the new
+/// multi-stage is not touched by the reordering.
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassLoopInvariantCodeMotion : public Pass {
+public:
+  PassLoopInvariantCodeMotion();
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) override;
+};
+
+} // namespace dawn
+
+#endif
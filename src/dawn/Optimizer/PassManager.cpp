@@ -16,6 +16,8 @@
 #include "dawn/Optimizer/OptimizerContext.h"
 #include "dawn/Optimizer/StencilInstantiation.h"
 #include "dawn/Support/Logging.h"
+#include "dawn/Support/ResourceUsage.h"
+#include <chrono>
 #include <vector>
 
 namespace dawn {
@@ -46,7 +48,10 @@ bool PassManager::runPassOnStecilInstantiation(
     const std::shared_ptr<StencilInstantiation>& instantiation, Pass* pass) {
   DAWN_LOG(INFO) << "Starting " << pass->getName() << " ...";
 
-  if(!pass->run(instantiation)) {
+  bool success = collectStatistics_ ? runPassAndCollectStatistics(instantiation, pass)
+                                    : pass->run(instantiation);
+
+  if(!success) {
     DAWN_LOG(WARNING) << "Done with " << pass->getName() << " : FAIL";
     return false;
   }
@@ -55,4 +60,32 @@ bool PassManager::runPassOnStecilInstantiation(
   return true;
 }
 
+bool PassManager::runPassAndCollectStatistics(
+    const std::shared_ptr<StencilInstantiation>& instantiation, Pass* pass) {
+  long rss = getResidentSetSizeInKB();
+  long peakRSS = getPeakResidentSetSizeInKB();
+  auto start = std::chrono::steady_clock::now();
+
+  bool success = pass->run(instantiation);
+
+  PassStatistics& statistics = statistics_[pass];
+  statistics.Name = pass->getName();
+  statistics.NumRuns++;
+  statistics.Seconds +=
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  statistics.RSSDeltaInKB += static_cast<long>(getResidentSetSizeInKB()) - rss;
+  statistics.PeakRSSDeltaInKB += static_cast<long>(getPeakResidentSetSizeInKB()) - peakRSS;
+  return success;
+}
+
+std::vector<PassStatistics> PassManager::getStatistics() const {
+  std::vector<PassStatistics> statistics;
+  for(const auto& pass : passes_) {
+    auto it = statistics_.find(pass.get());
+    if(it != statistics_.end())
+      statistics.push_back(it->second);
+  }
+  return statistics;
+}
+
 } // namespace dawn
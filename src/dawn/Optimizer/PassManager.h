@@ -20,14 +20,36 @@
 #include "dawn/Support/STLExtras.h"
 #include <list>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace dawn {
 
 class StencilInstantiation;
 
+/// @brief Time and memory spent in a pass (accumulated over all runs of the pass)
+///
+/// The resident set sizes are measured for the whole process. They are only meaningful if a single
+/// compilation runs at a time, i.e not for the concurrent compilations on the thread pool of the C
+/// API.
+struct PassStatistics {
+  std::string Name;
+  int NumRuns = 0;
+  double Seconds = 0;        ///< Wall time
+  long RSSDeltaInKB = 0;     ///< Change of the resident set size of the process
+  long PeakRSSDeltaInKB = 0; ///< Increase of the peak resident set size of the process
+};
+
 /// @brief Handle registering and running of passes
 class PassManager : public NonCopyable {
   std::list<std::unique_ptr<Pass>> passes_;
+  std::unordered_map<const Pass*, PassStatistics> statistics_;
+  bool collectStatistics_ = false;
+
+  /// @brief Run `pass` on the `instantiation` and accumulate its statistics
+  bool runPassAndCollectStatistics(const std::shared_ptr<StencilInstantiation>& instantiation,
+                                   Pass* pass);
 
 public:
   /// @brief Create a new pass at the end of the pass list
@@ -55,6 +77,16 @@ public:
   /// @brief Get all registered passes
   std::list<std::unique_ptr<Pass>>& getPasses() { return passes_; }
   const std::list<std::unique_ptr<Pass>>& getPasses() const { return passes_; }
+
+  /// @brief Collect the statistics of the passes which run from now on (disabled by default as
+  /// measuring the memory usage requires system calls)
+  void setCollectStatistics(bool collectStatistics) { collectStatistics_ = collectStatistics; }
+
+  /// @brief Get the statistics of the passes which ran (in the order of the pass list)
+  ///
+  /// Only the passes which ran while collecting the statistics are reported (see
+  /// `setCollectStatistics`).
+  std::vector<PassStatistics> getStatistics() const;
 };
 
 } // namespace dawn
@@ -247,6 +247,11 @@ bool PassSetBoundaryCondition::run(
               // If the access is horizontally pointwise we do not need to trigger a BC
               if(readaccess.second.isHorizontalPointwise())
                 continue;
+              // Allocated fields (e.g temporaries shared between stencils) which are computed in
+              // this stencil before they are read do not depend on the previous stencils
+              if(stencilInstantiation->isAllocatedField(originalID) &&
+                 stencilDirtyFields.count(originalID))
+                continue;
               auto IDtoBCpair = allBCs.find(originalID);
               // Check if a boundary condition for this variable was defined
               if(IDtoBCpair == allBCs.end()) {
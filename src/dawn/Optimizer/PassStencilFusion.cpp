@@ -0,0 +1,267 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/PassStencilFusion.h"
+#include "dawn/Optimizer/BoundaryExtent.h"
+#include "dawn/Optimizer/DependencyGraphAccesses.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/PassSetStageGraph.h"
+#include "dawn/Optimizer/PassStageMerger.h"
+#include "dawn/Optimizer/PassStageReordering.h"
+#include "dawn/Optimizer/StatementAccessesPair.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/ASTVisitor.h"
+#include "dawn/Support/StringRef.h"
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <unordered_set>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Collect the statements of the stencil description which affect the fusion of the
+/// surrounding stencil calls (nested stencil calls, assigned variables and nested blocks)
+class StencilDescAnalyzer : public ASTVisitorForwarding {
+  bool hasStencilCall_;
+  std::set<std::string> assignedVariables_;
+  std::vector<std::shared_ptr<BlockStmt>> blocks_;
+
+public:
+  using Base = ASTVisitorForwarding;
+
+  StencilDescAnalyzer() : hasStencilCall_(false) {}
+
+  /// @brief The statement contains a stencil call (or a boundary condition)
+  bool hasStencilCall() const { return hasStencilCall_; }
+
+  /// @brief Names of the variables assigned by the statement
+  const std::set<std::string>& getAssignedVariables() const { return assignedVariables_; }
+
+  /// @brief Blocks nested in the statement
+  const std::vector<std::shared_ptr<BlockStmt>>& getBlocks() const { return blocks_; }
+
+  void visit(const std::shared_ptr<BlockStmt>& stmt) override {
+    blocks_.push_back(stmt);
+    Base::visit(stmt);
+  }
+
+  void visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) override { hasStencilCall_ = true; }
+
+  void visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) override {
+    hasStencilCall_ = true;
+  }
+
+  void visit(const std::shared_ptr<AssignmentExpr>& expr) override {
+    if(const VarAccessExpr* var = dyn_cast<VarAccessExpr>(expr->getLeft().get()))
+      assignedVariables_.insert(var->getName());
+    Base::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<UnaryOperator>& expr) override {
+    if(const VarAccessExpr* var = dyn_cast<VarAccessExpr>(expr->getOperand().get()))
+      if(StringRef(expr->getOp()) == "++" || StringRef(expr->getOp()) == "--")
+        assignedVariables_.insert(var->getName());
+    Base::visit(expr);
+  }
+};
+
+class StencilFuser {
+  const std::shared_ptr<StencilInstantiation>& instantiation_;
+  const Options& options_;
+  int numFused_;
+
+public:
+  StencilFuser(const std::shared_ptr<StencilInstantiation>& instantiation)
+      : instantiation_(instantiation),
+        options_(instantiation->getOptimizerContext()->getOptions()), numFused_(0) {}
+
+  int getNumFused() const { return numFused_; }
+
+  /// @brief Fuse the stencil calls of the stencil description statements and all nested blocks
+  void fuseStencilCalls() {
+    std::vector<std::shared_ptr<BlockStmt>> blocks = fuseStencilCalls(
+        instantiation_->getStencilDescStatements(),
+        [](const std::shared_ptr<Statement>& statement) -> const std::shared_ptr<Stmt>& {
+          return statement->ASTStmt;
+        });
+
+    while(!blocks.empty()) {
+      std::shared_ptr<BlockStmt> block = blocks.back();
+      blocks.pop_back();
+
+      auto nestedBlocks = fuseStencilCalls(
+          block->getStatements(),
+          [](const std::shared_ptr<Stmt>& stmt) -> const std::shared_ptr<Stmt>& { return stmt; });
+      block->invalidateHash();
+      blocks.insert(blocks.end(), nestedBlocks.begin(), nestedBlocks.end());
+    }
+  }
+
+private:
+  /// @brief Fuse the stencil calls in the list of statements `stmts` (`getStmt` returns the AST
+  /// statement of an element)
+  ///
+  /// @returns the blocks nested in the statements
+  template <class Container, class GetStmtFunc>
+  std::vector<std::shared_ptr<BlockStmt>> fuseStencilCalls(Container& stmts,
+                                                           GetStmtFunc&& getStmt) {
+    std::shared_ptr<Stencil> firstStencil;
+    std::set<std::string> assignedVariables;
+    std::vector<std::shared_ptr<BlockStmt>> blocks;
+
+    for(auto it = stmts.begin(); it != stmts.end();) {
+      const std::shared_ptr<Stmt>& stmt = getStmt(*it);
+
+      if(StencilCallDeclStmt* call = dyn_cast<StencilCallDeclStmt>(stmt.get())) {
+        std::shared_ptr<Stencil> stencil = getStencil(call);
+        if(firstStencil && stencil && canFuse(*firstStencil, *stencil, assignedVariables)) {
+          fuse(firstStencil, stencil, std::static_pointer_cast<StencilCallDeclStmt>(stmt));
+          it = stmts.erase(it);
+          continue;
+        }
+        firstStencil = stencil;
+        assignedVariables.clear();
+        ++it;
+        continue;
+      }
+
+      StencilDescAnalyzer analyzer;
+      stmt->accept(analyzer);
+      if(analyzer.hasStencilCall())
+        firstStencil = nullptr;
+      assignedVariables.insert(analyzer.getAssignedVariables().begin(),
+                               analyzer.getAssignedVariables().end());
+      blocks.insert(blocks.end(), analyzer.getBlocks().begin(), analyzer.getBlocks().end());
+      ++it;
+    }
+    return blocks;
+  }
+
+  std::shared_ptr<Stencil> getStencil(StencilCallDeclStmt* call) const {
+    for(const auto& stencilCallIDPair : instantiation_->getStencilCallToStencilIDMap())
+      if(stencilCallIDPair.first.get() == call)
+        for(const auto& stencil : instantiation_->getStencils())
+          if(stencil->getStencilID() == stencilCallIDPair.second)
+            return stencil;
+    return nullptr;
+  }
+
+  /// @brief Check if `second` can be executed together with `first`, i.e before the statements
+  /// (assigning `assignedVariables`) in between the two calls
+  bool canFuse(const Stencil& first, const Stencil& second,
+               const std::set<std::string>& assignedVariables) const {
+    // The global variables read by `second` are not modified in between
+    for(const auto& multiStagePtr : second.getMultiStages())
+      for(const auto& stagePtr : multiStagePtr->getStages())
+        for(const auto& doMethodPtr : stagePtr->getDoMethods())
+          for(const auto& stmtAccessesPair : doMethodPtr->getStatementAccessesPairs())
+            for(const auto& AccessIDExtentsPair :
+                stmtAccessesPair->getAccesses()->getReadAccesses())
+              if(instantiation_->isGlobalVariable(AccessIDExtentsPair.first) &&
+                 assignedVariables.count(
+                     instantiation_->getNameFromAccessID(AccessIDExtentsPair.first)))
+                return false;
+
+    // The fused stencil does not exceed the maximum number of fields
+    if(options_.SplitStencils) {
+      std::unordered_set<int> fields;
+      for(const Stencil* stencil : {&first, &second})
+        for(const auto& field : stencil->getFields())
+          fields.insert(field.AccessID);
+      if(fields.size() > options_.MaxFieldsPerStencil)
+        return false;
+    }
+
+    // Boundary conditions of the fields written by `first` are applied before `second` reads them
+    // with horizontal offsets
+    std::unordered_set<int> writtenFields;
+    for(const auto& multiStagePtr : first.getMultiStages())
+      for(const auto& stagePtr : multiStagePtr->getStages())
+        for(const Field& field : stagePtr->getFields())
+          if(field.getIntend() != Field::IK_Input)
+            writtenFields.insert(field.getAccessID());
+
+    for(const auto& multiStagePtr : second.getMultiStages())
+      for(const auto& stagePtr : multiStagePtr->getStages())
+        for(const Field& field : stagePtr->getFields())
+          if(field.getIntend() != Field::IK_Output && writtenFields.count(field.getAccessID()) &&
+             !field.getExtents().isHorizontalPointwise() &&
+             instantiation_->getBoundaryConditions().count(
+                 instantiation_->getOriginalNameFromAccessID(field.getAccessID())))
+            return false;
+
+    // The fused stencil does not exceed the maximum number of halo points
+    DependencyGraphAccesses graph(instantiation_.get());
+    for(const Stencil* stencil : {&first, &second})
+      for(const auto& multiStagePtr : stencil->getMultiStages())
+        for(const auto& stagePtr : multiStagePtr->getStages())
+          for(const auto& doMethodPtr : stagePtr->getDoMethods())
+            graph.merge(doMethodPtr->getDependencyGraph().get());
+    return graph.isDAG() && !exceedsMaxBoundaryPoints(&graph, options_.MaxHaloPoints);
+  }
+
+  /// @brief Append the multi-stages of `second` to `first` and remove the call to `second`
+  void fuse(const std::shared_ptr<Stencil>& first, const std::shared_ptr<Stencil>& second,
+            const std::shared_ptr<StencilCallDeclStmt>& secondCall) {
+    if(options_.ReportPassStencilFusion)
+      std::cout << "\nPASS: PassStencilFusion: " << instantiation_->getName() << ": stencil_"
+                << second->getStencilID() << " fused into stencil_" << first->getStencilID()
+                << std::endl;
+
+    for(const auto& multiStagePtr : second->getMultiStages())
+      first->getMultiStages().push_back(multiStagePtr);
+    first->updateFields();
+
+    auto& stencils = instantiation_->getStencils();
+    stencils.erase(std::find(stencils.begin(), stencils.end(), second));
+    instantiation_->getStencilCallToStencilIDMap().erase(secondCall);
+    instantiation_->getIDToStencilCallMap().erase(second->getStencilID());
+    numFused_++;
+  }
+};
+
+} // anonymous namespace
+
+PassStencilFusion::PassStencilFusion(ReorderStrategy::ReorderStrategyKind strategy)
+    : Pass("PassStencilFusion"), strategy_(strategy) {
+  dependencies_.push_back("PassSetStageGraph");
+}
+
+bool PassStencilFusion::run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
+  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+
+  if(!context->getOptions().FuseStencils)
+    return true;
+
+  StencilFuser fuser(stencilInstantiation);
+  fuser.fuseStencilCalls();
+
+  if(context->getOptions().ReportPassStencilFusion && fuser.getNumFused() == 0)
+    std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName()
+              << ": no stencils fused" << std::endl;
+
+  if(fuser.getNumFused() == 0)
+    return true;
+
+  // Reorder and merge the stages of the fused stencils
+  PassSetStageGraph setStageGraph;
+  PassStageReordering reordering(strategy_);
+  PassStageMerger merger;
+  return setStageGraph.run(stencilInstantiation) && reordering.run(stencilInstantiation) &&
+         merger.run(stencilInstantiation);
+}
+
+} // namespace dawn
@@ -0,0 +1,55 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_OPTIMIZER_PASSSTENCILFUSION_H
+#define DAWN_OPTIMIZER_PASSSTENCILFUSION_H
+
+#include "dawn/Optimizer/Pass.h"
+#include "dawn/Optimizer/ReorderStrategy.h"
+
+namespace dawn {
+
+/// @brief Fuse consecutive stencil calls of the stencil description into a single stencil
+///
+/// Stencil calls of the SIR are already inlined into the stencil of the caller. Separate stencils
+/// of a StencilInstantiation are created by control flow in the stencil description and by
+/// `PassStencilSplitter`. Two calls in the same statement list are fused if
+///
+///   - the statements between them do not call stencils and do not assign global variables the
+///     second stencil reads (the fused stencil runs the second stencil before these statements),
+///   - the combined stage dependency graph is a DAG which does not exceed `-max-halo`,
+///   - the second stencil does not read a field written by the first one with horizontal offsets
+///     if the field has a boundary condition (it needs to be applied in between) and
+///   - the fused stencil does not exceed `-max-fields` if stencils are split.
+///
+/// The multi-stages of the second stencil are appended to the first one, afterwards the stage
+/// graphs are recomputed and the stages of the fused stencils are reordered and merged again.
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassStencilFusion : public Pass {
+public:
+  PassStencilFusion(ReorderStrategy::ReorderStrategyKind strategy);
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) override;
+
+private:
+  ReorderStrategy::ReorderStrategyKind strategy_;
+};
+
+} // namespace dawn
+
+#endif
@@ -13,173 +13,316 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn/Optimizer/PassTemporaryMerger.h"
-#include "dawn/Optimizer/DependencyGraph.h"
-#include "dawn/Optimizer/DependencyGraphAccesses.h"
 #include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/StatementAccessesPair.h"
 #include "dawn/Optimizer/StencilInstantiation.h"
 #include "dawn/Support/Format.h"
 #include "dawn/Support/StringUtil.h"
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <set>
 
 namespace dawn {
 
-PassTemporaryMerger::PassTemporaryMerger() : Pass("PassTemporaryMerger") {}
+namespace {
+
+/// @brief Live range of a temporary within a stencil
+///
+/// The statements of a stencil are numbered in execution order (multi-stages, stages, Do-Methods
+/// and statements). The temporary is live from its first to its last access and only touches the
+/// vertical `Intervals` (the intervals of the Do-Methods extended by the vertical access extents).
+struct LiveRange {
+  int Begin = std::numeric_limits<int>::max();
+  int End = -1;
+  std::vector<Interval> Intervals;
+
+  void extend(int begin, int end) {
+    Begin = std::min(Begin, begin);
+    End = std::max(End, end);
+  }
 
-bool PassTemporaryMerger::run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
-  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+  bool interferes(const LiveRange& other) const {
+    if(End < other.Begin || other.End < Begin)
+      return false;
+    for(const Interval& interval : Intervals)
+      for(const Interval& otherInterval : other.Intervals)
+        if(interval.overlaps(otherInterval))
+          return true;
+    return false;
+  }
+};
+
+/// @brief Compute the live ranges of the temporaries of `stencil`
+///
+/// The statements of a stage are executed point by point, hence a temporary which is accessed with
+/// horizontal offsets stays live until the end of its stage. The stages of a multi-stage are
+/// executed level by level, hence a temporary which is accessed with vertical offsets is live
+/// during the whole multi-stage.
+std::map<int, LiveRange> computeLiveRanges(const StencilInstantiation& instantiation,
+                                           const Stencil& stencil) {
+  std::map<int, LiveRange> liveRanges;
+
+  int position = 0;
+  for(const auto& multiStagePtr : stencil.getMultiStages()) {
+    const int multiStageBegin = position;
+    std::set<int> verticallyAccessedAccessIDs;
+
+    for(const auto& stagePtr : multiStagePtr->getStages()) {
+      const int stageBegin = position;
+      std::set<int> horizontallyAccessedAccessIDs;
+
+      for(const auto& doMethodPtr : stagePtr->getDoMethods()) {
+        const Interval& interval = doMethodPtr->getInterval();
+
+        for(const auto& statementAccessesPair : doMethodPtr->getStatementAccessesPairs()) {
+          auto recordAccess = [&](const std::pair<const int, Extents>& accessIDExtentsPair) {
+            const int AccessID = accessIDExtentsPair.first;
+            const Extents& extents = accessIDExtentsPair.second;
+            if(!instantiation.isTemporaryField(AccessID))
+              return;
+
+            LiveRange& liveRange = liveRanges[AccessID];
+            liveRange.extend(position, position);
+            liveRange.Intervals.push_back(interval.extendInterval(extents));
+
+            if(!extents.isVerticalPointwise())
+              verticallyAccessedAccessIDs.insert(AccessID);
+            if(!extents.isHorizontalPointwise())
+              horizontallyAccessedAccessIDs.insert(AccessID);
+          };
+
+          const Accesses& accesses = *statementAccessesPair->getAccesses();
+          std::for_each(accesses.getReadAccesses().begin(), accesses.getReadAccesses().end(),
+                        recordAccess);
+          std::for_each(accesses.getWriteAccesses().begin(), accesses.getWriteAccesses().end(),
+                        recordAccess);
+          position++;
+        }
+      }
+
+      for(int AccessID : horizontallyAccessedAccessIDs)
+        liveRanges[AccessID].extend(stageBegin, position - 1);
+    }
 
-  using Edge = DependencyGraphAccesses::Edge;
-  using Vertex = DependencyGraphAccesses::Vertex;
+    for(int AccessID : verticallyAccessedAccessIDs)
+      liveRanges[AccessID].extend(multiStageBegin, position - 1);
+  }
 
-  bool merged = false;
+  return liveRanges;
+}
+
+/// @brief Color the interference graph with the DSatur heuristic of Brelaz
+///
+/// The next vertex to color is the one with the most distinctly colored neighbors (ties are broken
+/// by the degree and then by the smallest AccessID); it gets the smallest color not used by any of
+/// its neighbors.
+std::map<int, int> colorGraph(const std::map<int, std::set<int>>& graph) {
+  std::map<int, int> coloring;
+  std::map<int, std::set<int>> neighborColors;
+
+  while(coloring.size() < graph.size()) {
+    int nextAccessID = -1;
+    std::size_t maxSaturation = 0, maxDegree = 0;
+    for(const auto& vertexNeighborsPair : graph) {
+      const int AccessID = vertexNeighborsPair.first;
+      if(coloring.count(AccessID))
+        continue;
+
+      std::size_t saturation = neighborColors[AccessID].size();
+      std::size_t degree = vertexNeighborsPair.second.size();
+      if(nextAccessID == -1 || saturation > maxSaturation ||
+         (saturation == maxSaturation && degree > maxDegree)) {
+        nextAccessID = AccessID;
+        maxSaturation = saturation;
+        maxDegree = degree;
+      }
+    }
+
+    int color = 0;
+    while(neighborColors[nextAccessID].count(color))
+      color++;
+    coloring[nextAccessID] = color;
+
+    for(int neighbor : graph.at(nextAccessID))
+      neighborColors[neighbor].insert(color);
+  }
+
+  return coloring;
+}
+
+/// @brief Write the interference graph to the dot file `filename`
+void dumpInterferenceGraph(const StencilInstantiation& instantiation,
+                           const std::map<int, std::set<int>>& graph, const std::string& filename) {
+  std::ofstream ofs(filename);
+  ofs << "graph G {\n";
+  for(const auto& vertexNeighborsPair : graph) {
+    ofs << "  \"" << instantiation.getNameFromAccessID(vertexNeighborsPair.first) << "\";\n";
+    for(int neighbor : vertexNeighborsPair.second)
+      if(vertexNeighborsPair.first < neighbor)
+        ofs << "  \"" << instantiation.getNameFromAccessID(vertexNeighborsPair.first)
+            << "\" -- \"" << instantiation.getNameFromAccessID(neighbor) << "\";\n";
+  }
+  ofs << "}\n";
+}
+
+} // anonymous namespace
+
+PassTemporaryMerger::PassTemporaryMerger(int bytesPerElement, const Array3i& domainSize)
+    : Pass("PassTemporaryMerger"), bytesPerElement_(bytesPerElement), domainSize_(domainSize) {}
+
+std::size_t PassTemporaryMerger::getBytes(const Array3i& dimensions) const {
+  std::size_t bytes = bytesPerElement_;
+  for(int i = 0; i < 3; ++i)
+    if(dimensions[i])
+      bytes *= domainSize_[i];
+  return bytes;
+}
+
+bool PassTemporaryMerger::run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
+  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+  const Options& options = context->getOptions();
 
   bool stencilNeedsMergePass = false;
   for(const auto& stencilPtr : stencilInstantiation->getStencils())
     stencilNeedsMergePass |=
         stencilPtr->getSIRStencil()->Attributes.has(sir::Attr::AK_MergeTemporaries);
 
-  if(!(context->getOptions().MergeTemporaries || stencilNeedsMergePass))
+  if(!(options.MergeTemporaries || options.MergeTemporariesAcrossStencils ||
+       stencilNeedsMergePass))
     return true;
 
-  // Pair of nodes to visit and AccessID of the last temporary (or -1 if no temporary has been
-  // processed yet)
-  std::vector<std::pair<std::size_t, int>> nodesToVisit;
-  std::unordered_set<std::size_t> visitedNodes;
+  auto reportMerge = [&](const std::string& prefix, const std::vector<int>& AccessIDs) {
+    std::vector<std::string> names;
+    for(int AccessID : AccessIDs)
+      names.emplace_back(stencilInstantiation->getNameFromAccessID(AccessID));
+    std::sort(names.begin(), names.end());
+    std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName() << ": "
+              << prefix << ": " << RangeToString(", ", "", "\n")(names);
+  };
+
+  bool merged = false;
+
+  // Storages of each stencil (the AccessID of each set of merged temporaries)
+  using Storage = std::pair<Stencil*, int>;
+  std::vector<std::vector<Storage>> storagesOfStencils;
 
   int stencilIdx = 0;
   for(const auto& stencilPtr : stencilInstantiation->getStencils()) {
     Stencil& stencil = *stencilPtr;
-
-    // Build the dependency graph of the stencil (merge all dependency graphs of the multi-stages)
-    DependencyGraphAccesses AccessesDAG(stencilInstantiation.get());
-    for(const auto& multiStagePtr : stencilPtr->getMultiStages()) {
-      MultiStage& multiStage = *multiStagePtr;
-      AccessesDAG.merge(multiStage.getDependencyGraphOfAxis().get());
-    }
-    const auto& adjacencyList = AccessesDAG.getAdjacencyList();
-
-    // Build the dependency graph of the temporaries
-    DependencyGraphAccesses TemporaryDAG(stencilInstantiation.get());
-    int AccessIDOfLastTemporary = -1;
-    for(std::size_t VertexID : AccessesDAG.getOutputVertexIDs()) {
-      nodesToVisit.clear();
-      visitedNodes.clear();
-
-      nodesToVisit.emplace_back(VertexID, AccessIDOfLastTemporary = -1);
-      while(!nodesToVisit.empty()) {
-
-        // Process the current node
-        std::size_t FromVertexID = nodesToVisit.back().first;
-        int FromAccessID = AccessesDAG.getIDFromVertexID(FromVertexID);
-        AccessIDOfLastTemporary = nodesToVisit.back().second;
-        nodesToVisit.pop_back();
-
-        if(stencilInstantiation->isTemporaryField(FromAccessID)) {
-          TemporaryDAG.insertNode(FromAccessID);
-          AccessIDOfLastTemporary = FromAccessID;
-        }
-
-        // Check if we already visited this node
-        if(visitedNodes.count(FromVertexID))
-          continue;
-        else
-          visitedNodes.insert(FromVertexID);
-
-        // Follow edges of the current node and update the node extents
-        for(const Edge& edge : *adjacencyList[FromVertexID]) {
-          std::size_t ToVertexID = edge.ToVertexID;
-          int ToAccessID = AccessesDAG.getIDFromVertexID(ToVertexID);
-          int newAccessIDOfLastTemporary = AccessIDOfLastTemporary;
-
-          if(stencilInstantiation->isTemporaryField(ToAccessID) && AccessIDOfLastTemporary != -1) {
-            TemporaryDAG.insertEdge(AccessIDOfLastTemporary, ToAccessID);
-            newAccessIDOfLastTemporary = ToAccessID;
-          }
-
-          nodesToVisit.emplace_back(ToVertexID, newAccessIDOfLastTemporary);
+    std::map<int, LiveRange> liveRanges = computeLiveRanges(*stencilInstantiation, stencil);
+
+    // Build the interference graph. Temporaries of different dimensions can never be merged.
+    std::map<int, std::set<int>> graph;
+    for(auto it = liveRanges.begin(); it != liveRanges.end(); ++it) {
+      graph[it->first];
+      for(auto otherIt = std::next(it); otherIt != liveRanges.end(); ++otherIt) {
+        if(stencilInstantiation->getFieldDimensions(it->first) !=
+               stencilInstantiation->getFieldDimensions(otherIt->first) ||
+           it->second.interferes(otherIt->second)) {
+          graph[it->first].insert(otherIt->first);
+          graph[otherIt->first].insert(it->first);
         }
       }
     }
 
-    std::cout << TemporaryDAG.toDot() << std::endl;
+    if(options.DumpTemporaryGraphs)
+      dumpInterferenceGraph(*stencilInstantiation, graph, format("tmp_stencil_%i.dot", stencilIdx));
 
-    if(TemporaryDAG.empty())
-      continue;
+    // Rename all temporaries of the same color to the smallest AccessID of the color
+    std::map<int, std::vector<int>> colorToAccessIDsMap;
+    for(const auto& AccessIDColorPair : colorGraph(graph))
+      colorToAccessIDsMap[AccessIDColorPair.second].push_back(AccessIDColorPair.first);
 
-    // Add dependencies due to overlapping lifetime of the temporaries. The dependencies will assure
-    // that these temporaries can not be merged into one i.e have different colors.
-    std::unordered_set<int> temporaries;
-    std::for_each(TemporaryDAG.getVertices().begin(), TemporaryDAG.getVertices().end(),
-                  [&](const std::pair<int, Vertex>& vertexPair) {
-                    temporaries.emplace(vertexPair.second.ID);
-                  });
-    auto LifeTimeMap = stencil.getLifetime(temporaries);
+    std::size_t bytesSaved = 0;
+    std::vector<Storage> storages;
+    for(const auto& colorAccessIDsPair : colorToAccessIDsMap) {
+      const std::vector<int>& AccessIDs = colorAccessIDsPair.second;
+      const int newAccessID = AccessIDs.front();
+      storages.emplace_back(stencilPtr.get(), newAccessID);
 
-    for(const auto& FromAccessIDLifetimePair : LifeTimeMap) {
-      const int FromAccessID = FromAccessIDLifetimePair.first;
-      const Stencil::Lifetime& FromLifetime = FromAccessIDLifetimePair.second;
+      if(AccessIDs.size() < 2)
+        continue;
 
-      for(const auto& ToAccessIDLifetimePair : LifeTimeMap) {
-        const int ToAccessID = ToAccessIDLifetimePair.first;
-        const Stencil::Lifetime& ToLifetime = ToAccessIDLifetimePair.second;
+      if(options.ReportPassTemporaryMerger)
+        reportMerge(format("stencil %i: merging", stencil.getStencilID()), AccessIDs);
 
-        if(FromAccessID == ToAccessID)
-          continue;
-
-        if(FromLifetime.overlaps(ToLifetime)) {
-          TemporaryDAG.insertEdge(FromAccessID, ToAccessID);
-        }
-      }
+      bytesSaved +=
+          (AccessIDs.size() - 1) * getBytes(stencilInstantiation->getFieldDimensions(newAccessID));
+      for(std::size_t i = 1; i < AccessIDs.size(); ++i)
+        stencilInstantiation->renameAllOccurrences(stencilPtr.get(), AccessIDs[i], newAccessID);
+      merged = true;
     }
 
-    if(context->getOptions().DumpTemporaryGraphs)
-      TemporaryDAG.toDot(format("tmp_stencil_%i.dot", stencilIdx));
-
-    // Color the temporary graph
-    std::unordered_map<int, int> coloring;
-    TemporaryDAG.greedyColoring(coloring);
-
-    // Compute the candiates for renaming. We will rename all fields of the same color to the same
-    // AccessID.
-    std::unordered_map<int, std::vector<int>> colorToAccessIDOfRenameCandidatesMap;
-    for(const auto& colorAccessIDPair : coloring) {
-      int AccessID = colorAccessIDPair.first;
-      int color = colorAccessIDPair.second;
-      auto it = colorToAccessIDOfRenameCandidatesMap.find(color);
-      if(it == colorToAccessIDOfRenameCandidatesMap.end())
-        colorToAccessIDOfRenameCandidatesMap.emplace(color, std::vector<int>{AccessID});
-      else
-        colorToAccessIDOfRenameCandidatesMap[color].push_back(AccessID);
-    }
+    if(options.ReportPassTemporaryMerger && !liveRanges.empty())
+      std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName()
+                << ": stencil " << stencil.getStencilID() << ": " << liveRanges.size()
+                << " temporaries in " << storages.size() << " storages, " << bytesSaved
+                << " bytes saved\n";
 
-    for(const auto& colorRenameCandidatesPair : colorToAccessIDOfRenameCandidatesMap) {
-      const std::vector<int>& AccessIDOfRenameCandiates = colorRenameCandidatesPair.second;
+    storagesOfStencils.push_back(std::move(storages));
+    stencilIdx++;
+  }
 
-      // Print the rename candiates in alphabetical order
-      if(context->getOptions().ReportPassTemporaryMerger && AccessIDOfRenameCandiates.size() >= 2) {
-        std::vector<std::string> renameCandiatesNames;
-        for(int AccessID : AccessIDOfRenameCandiates)
-          renameCandiatesNames.emplace_back(stencilInstantiation->getNameFromAccessID(AccessID));
-        std::sort(renameCandiatesNames.begin(), renameCandiatesNames.end());
-        std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName()
-                  << ": merging: " << RangeToString(", ", "", "\n")(renameCandiatesNames);
-      }
+  // The stencils are run one after another and temporaries do not carry values from one stencil to
+  // the next, hence the storages of different stencils never interfere. The i-th storage (of the
+  // same dimensions) of each stencil is shared, which requires the wrapper to allocate it.
+  if(options.MergeTemporariesAcrossStencils && storagesOfStencils.size() > 1) {
+    std::map<Array3i, std::vector<std::vector<Storage>>> dimensionsToStoragesOfStencilsMap;
+    for(const auto& storages : storagesOfStencils) {
+      std::map<Array3i, std::vector<Storage>> dimensionsToStoragesMap;
+      for(const Storage& storage : storages)
+        dimensionsToStoragesMap[stencilInstantiation->getFieldDimensions(storage.second)]
+            .push_back(storage);
+      for(auto& dimensionsStoragesPair : dimensionsToStoragesMap)
+        dimensionsToStoragesOfStencilsMap[dimensionsStoragesPair.first].push_back(
+            std::move(dimensionsStoragesPair.second));
+    }
 
-      int newAccessID = AccessIDOfRenameCandiates[0];
+    // Bytes saved by each stencil (the first stencil of each shared storage keeps its storage)
+    std::map<int, std::size_t> stencilIDToBytesSavedMap;
+    for(const auto& dimensionsStoragesOfStencilsPair : dimensionsToStoragesOfStencilsMap) {
+      const auto& storagesOfStencilsWithDimensions = dimensionsStoragesOfStencilsPair.second;
+      for(std::size_t i = 0;; ++i) {
+        std::vector<Storage> sharedStorages;
+        for(const auto& storages : storagesOfStencilsWithDimensions)
+          if(i < storages.size())
+            sharedStorages.push_back(storages[i]);
+        if(sharedStorages.empty())
+          break;
+        if(sharedStorages.size() < 2)
+          continue;
 
-      // Rename all other fields of the color to the AccessID of the first field (note that it
-      // wouldn't matter which AccessID we choose)
-      for(int i = 1; i < AccessIDOfRenameCandiates.size(); ++i) {
+        std::vector<int> AccessIDs;
+        for(const Storage& storage : sharedStorages)
+          AccessIDs.push_back(storage.second);
+        if(options.ReportPassTemporaryMerger)
+          reportMerge("sharing across stencils", AccessIDs);
+
+        const int newAccessID = AccessIDs.front();
+        for(std::size_t j = 1; j < sharedStorages.size(); ++j)
+          stencilInstantiation->renameAllOccurrences(sharedStorages[j].first,
+                                                     sharedStorages[j].second, newAccessID);
+        stencilInstantiation->promoteTemporaryFieldToAllocatedField(newAccessID);
+
+        for(std::size_t j = 1; j < sharedStorages.size(); ++j)
+          stencilIDToBytesSavedMap[sharedStorages[j].first->getStencilID()] +=
+              getBytes(dimensionsStoragesOfStencilsPair.first);
         merged = true;
-        int oldAccessID = AccessIDOfRenameCandiates[i];
-        stencilInstantiation->renameAllOccurrences(stencilPtr.get(), oldAccessID, newAccessID);
       }
     }
 
-    stencilIdx++;
+    if(options.ReportPassTemporaryMerger)
+      for(const auto& stencilIDBytesSavedPair : stencilIDToBytesSavedMap)
+        std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName()
+                  << ": stencil " << stencilIDBytesSavedPair.first
+                  << ": sharing across stencils: " << stencilIDBytesSavedPair.second
+                  << " bytes saved\n";
   }
 
-  if(context->getOptions().ReportPassTemporaryMerger && !merged)
+  if(options.ReportPassTemporaryMerger && !merged)
     std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName()
               << ": no merge\n";
 
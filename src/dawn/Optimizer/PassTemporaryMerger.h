@@ -16,19 +16,37 @@
 #define DAWN_OPTIMIZER_PASSTEMPORARYMERGER_H
 
 #include "dawn/Optimizer/Pass.h"
+#include "dawn/Support/Array.h"
+#include <cstddef>
 
 namespace dawn {
 
 /// @brief Pass to merge temporaries
 /// @ingroup optimizer
 ///
+/// Temporaries whose live ranges (computed per statement and per vertical interval) do not overlap
+/// are merged into a single storage. The interference graph of the temporaries of each stencil is
+/// colored with the DSatur heuristic. With `MergeTemporariesAcrossStencils` the merged storages are
+/// additionally shared between the stencils of the instantiation (they become allocated fields).
+///
+/// The memory saved per stencil is reported for fields of `bytesPerElement` bytes on a domain of
+/// `domainSize` grid points (see `-precision` and `-domain-size`).
+///
 /// This pass is not necessary to create legal code and is hence not in the debug-group
 class PassTemporaryMerger : public Pass {
+  int bytesPerElement_;
+  Array3i domainSize_;
+
 public:
-  PassTemporaryMerger();
+  PassTemporaryMerger(int bytesPerElement = sizeof(double),
+                      const Array3i& domainSize = Array3i{{128, 128, 80}});
 
   /// @brief Pass implementation
   bool run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) override;
+
+private:
+  /// @brief Bytes of a storage with the given dimensions
+  std::size_t getBytes(const Array3i& dimensions) const;
 };
 
 } // namespace dawn
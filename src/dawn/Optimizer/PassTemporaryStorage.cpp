@@ -0,0 +1,159 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/PassTemporaryStorage.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/PassTemporaryType.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/AST.h"
+#include "dawn/Support/Casting.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <unordered_set>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Check if every read of the field `AccessID` in `multiStage` is preceded by a write of the
+/// field at the same vertical level
+///
+/// The stages of a multi-stage are executed in order at each vertical level. The value of a field
+/// which is read before it is written at a level comes from the previous level, which is lost if
+/// the field only stores a single level. Writes within if-statements might not be executed and are
+/// ignored.
+bool isWrittenBeforeReadAtEachLevel(const MultiStage& multiStage, int AccessID) {
+  std::vector<Interval> writeIntervals;
+  for(const auto& stagePtr : multiStage.getStages())
+    for(const auto& doMethodPtr : stagePtr->getDoMethods()) {
+      const Interval& interval = doMethodPtr->getInterval();
+      for(const auto& statementAccessesPair : doMethodPtr->getStatementAccessesPairs()) {
+        const Accesses& accesses = *statementAccessesPair->getAccesses();
+
+        // The right-hand side of a statement is read before its left-hand side is written
+        if(accesses.hasReadAccess(AccessID) &&
+           std::none_of(writeIntervals.begin(), writeIntervals.end(),
+                        [&](const Interval& writeInterval) {
+                          return writeInterval.contains(interval);
+                        }))
+          return false;
+
+        if(accesses.hasWriteAccess(AccessID) &&
+           !isa<IfStmt>(statementAccessesPair->getStatement()->ASTStmt.get()))
+          writeIntervals.push_back(interval);
+      }
+    }
+  return true;
+}
+
+} // anonymous namespace
+
+PassTemporaryStorage::PassTemporaryStorage() : Pass("PassTemporaryStorage") {}
+
+bool PassTemporaryStorage::run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) {
+  OptimizerContext* context = stencilInstantiation->getOptimizerContext();
+
+  if(!context->getOptions().DemoteTemporaries)
+    return true;
+
+  int numDemoted = 0;
+  for(const auto& stencilPtr : stencilInstantiation->getStencils()) {
+    Stencil& stencil = *stencilPtr;
+
+    // Multi-stages accessing each temporary
+    std::map<int, std::vector<int>> temporaryToMultiStageIndicesMap;
+    for(int multiStageIdx = 0; multiStageIdx < stencil.getMultiStages().size(); ++multiStageIdx)
+      for(const auto& AccessIDFieldPair :
+          stencil.getMultiStageFromMultiStageIndex(multiStageIdx)->getFields())
+        if(stencilInstantiation->isTemporaryField(AccessIDFieldPair.first))
+          temporaryToMultiStageIndicesMap[AccessIDFieldPair.first].push_back(multiStageIdx);
+
+    std::unordered_set<int> temporaries;
+    for(const auto& AccessIDMultiStageIndicesPair : temporaryToMultiStageIndicesMap)
+      temporaries.insert(AccessIDMultiStageIndicesPair.first);
+    auto lifetimeMap = stencil.getLifetime(temporaries);
+
+    for(const auto& AccessIDMultiStageIndicesPair : temporaryToMultiStageIndicesMap) {
+      const int AccessID = AccessIDMultiStageIndicesPair.first;
+      if(AccessIDMultiStageIndicesPair.second.size() != 1)
+        continue;
+
+      MultiStage& multiStage =
+          *stencil.getMultiStageFromMultiStageIndex(AccessIDMultiStageIndicesPair.second.front());
+      const Extents extents = multiStage.getFields().at(AccessID).getExtents();
+      const Stencil::Lifetime& lifetime = lifetimeMap.at(AccessID);
+      const bool usedInStencilFun =
+          PassTemporaryType::usedAsArgumentInStencilFun(stencilPtr, AccessID);
+
+      auto report = [&](const std::string& storage) {
+        if(context->getOptions().ReportPassTemporaryStorage)
+          std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName() << ": "
+                    << stencilInstantiation->getOriginalNameFromAccessID(AccessID) << ": "
+                    << storage << std::endl;
+        numDemoted++;
+      };
+
+      if(lifetime.Begin.inSameDoMethod(lifetime.End) && extents.isPointwise() &&
+         !usedInStencilFun) {
+        report("column");
+        stencilInstantiation->demoteTemporaryFieldToLocalVariable(stencilPtr.get(), AccessID,
+                                                                 lifetime);
+        continue;
+      }
+
+      // Parallel multi-stages are executed as forward loops unless the code generators are allowed
+      // to split the vertical dimension among threads
+      LoopOrderKind loopOrder = multiStage.getLoopOrder();
+      if(loopOrder == LoopOrderKind::LK_Parallel) {
+        if(context->getOptions().UseParallelEP)
+          continue;
+        loopOrder = LoopOrderKind::LK_Forward;
+      }
+
+      // The ring buffer is indexed by the vertical level, which is only known to the naive C++
+      // code generator if the field is accessed directly
+      if(extents.isHorizontalPointwise() && !usedInStencilFun &&
+         !extents.getVerticalLoopOrderAccesses(loopOrder).CounterLoopOrder) {
+        const Extent& verticalExtent = extents[2];
+        const int window = std::max(-verticalExtent.Minus, verticalExtent.Plus) + 1;
+        report("k-window of " + std::to_string(window) + " levels");
+
+        auto interval = multiStage.computeEnclosingAccessInterval(AccessID);
+        DAWN_ASSERT(interval.is_initialized());
+        multiStage.getCaches().erase(AccessID);
+        multiStage.setCache(Cache::K, Cache::local, AccessID, *interval).setWindow(window);
+        continue;
+      }
+
+      // A local IJ-cache is a single horizontal plane per block in GridTools, the naive C++ code
+      // generator stores the field in a ring buffer of a single level
+      if(extents.isVerticalPointwise() && !usedInStencilFun &&
+         isWrittenBeforeReadAtEachLevel(multiStage, AccessID)) {
+        report("ij-plane");
+        multiStage.getCaches().erase(AccessID);
+        multiStage.setCache(Cache::IJ, Cache::local, AccessID).setWindow(1);
+        stencilInstantiation->insertCachedVariable(AccessID);
+      }
+    }
+  }
+
+  if(context->getOptions().ReportPassTemporaryStorage && numDemoted == 0)
+    std::cout << "\nPASS: " << getName() << ": " << stencilInstantiation->getName()
+              << ": no temporary demoted" << std::endl;
+
+  return true;
+}
+
+} // namespace dawn
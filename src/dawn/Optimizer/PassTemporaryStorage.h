@@ -0,0 +1,52 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_OPTIMIZER_PASSTEMPORARYSTORAGE_H
+#define DAWN_OPTIMIZER_PASSTEMPORARYSTORAGE_H
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief Choose the smallest storage of each temporary field
+///
+/// Temporaries are 3D storages by default. A temporary which is only accessed within a single
+/// multi-stage does not need to keep all vertical levels:
+///
+///   - @b column: accessed within a single Do-Method without any offset, it is demoted to a local
+///     variable (as done by `PassTemporaryType`)
+///   - @b k-window: accessed without horizontal offsets and only at the current and the previous
+///     levels (in loop order) of a forward or backward multi-stage, it gets a local K-cache whose
+///     window is the number of levels of the ring buffer storing the field
+///   - @b ij-plane: accessed at the current level of a forward or backward multi-stage and written
+///     before it is read at each level, it gets a local IJ-cache with a window of one level (a
+///     plane per block in GridTools, a single level ring buffer in the naive C++ backend)
+///
+/// Parallel multi-stages keep 3D temporaries if `-use-parallel-ep` lets the vertical levels run in
+/// parallel, otherwise they are treated as forward loops (the order the code generators emit).
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassTemporaryStorage : public Pass {
+public:
+  PassTemporaryStorage();
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<StencilInstantiation>& stencilInstantiation) override;
+};
+
+} // namespace dawn
+
+#endif
@@ -264,7 +264,7 @@ public:
                                     cloneStencilFun->getStatementAccessesPairs(), interval_,
                                     fieldsMap, cloneStencilFun);
 
-    cloneStencilFun->getAST()->accept(statementMapper);
+    statementMapper.visit(*cloneStencilFun->getAST());
 
     // final checks
     cloneStencilFun->checkFunctionBindings();
@@ -384,7 +384,7 @@ bool PassTemporaryToStencilFunction::run(
 
                 std::shared_ptr<BlockStmt> blockStmt =
                     std::make_shared<BlockStmt>(std::vector<std::shared_ptr<Stmt>>{stmt->ASTStmt});
-                blockStmt->accept(statementMapper);
+                statementMapper.visit(blockStmt);
                 DAWN_ASSERT(listStmtPair.size() == 1);
 
                 std::shared_ptr<StatementAccessesPair> stmtPair = listStmtPair[0];
@@ -54,15 +54,6 @@ public:
   bool usedInStencilFun() const { return usedInStencilFun_; }
 };
 
-/// @brief Check if a field, given by `AccessID` is used as an argument of a stencil-function inside
-/// any statement of the `stencil`
-/// @returns `true` if field is used as an argument
-bool usedAsArgumentInStencilFun(const std::shared_ptr<Stencil>& stencil, int AccessID) {
-  StencilFunArgumentDetector visitor(stencil->getStencilInstantiation(), AccessID);
-  stencil->accept(visitor);
-  return visitor.usedInStencilFun();
-}
-
 /// @brief Representation of a Temporary field or variable
 struct Temporary {
   enum TemporaryType { TT_LocalVariable, TT_Field };
@@ -88,6 +79,13 @@ struct Temporary {
 
 PassTemporaryType::PassTemporaryType() : Pass("PassTemporaryType", true) {}
 
+bool PassTemporaryType::usedAsArgumentInStencilFun(const std::shared_ptr<Stencil>& stencil,
+                                                   int AccessID) {
+  StencilFunArgumentDetector visitor(stencil->getStencilInstantiation(), AccessID);
+  stencil->accept(visitor);
+  return visitor.usedInStencilFun();
+}
+
 bool PassTemporaryType::run(const std::shared_ptr<StencilInstantiation>& instantiation) {
   OptimizerContext* context = instantiation->getOptimizerContext();
 
@@ -107,7 +105,7 @@ bool PassTemporaryType::run(const std::shared_ptr<StencilInstantiation>& instant
         for(auto& doMethodPtr : stagePtr->getDoMethods()) {
           for(const auto& statementAccessesPair : doMethodPtr->getStatementAccessesPairs()) {
 
-            auto processAccessMap = [&](const std::unordered_map<int, Extents>& accessMap) {
+            auto processAccessMap = [&](const std::map<int, Extents>& accessMap) {
               for(const auto& AccessIDExtentPair : accessMap) {
                 int AccessID = AccessIDExtentPair.first;
                 const Extents& extent = AccessIDExtentPair.second;
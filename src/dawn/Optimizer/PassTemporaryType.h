@@ -76,6 +76,11 @@ public:
   static void
   fixTemporariesSpanningMultipleStencils(StencilInstantiation* instantiation,
                                          const std::vector<std::shared_ptr<Stencil>>& stencils);
+
+  /// @brief Check if a field, given by `AccessID` is used as an argument of a stencil-function
+  /// inside any statement of the `stencil`
+  /// @returns `true` if field is used as an argument
+  static bool usedAsArgumentInStencilFun(const std::shared_ptr<Stencil>& stencil, int AccessID);
 };
 
 } // namespace dawn
@@ -19,6 +19,7 @@
 #include "dawn/Optimizer/StencilInstantiation.h"
 #include "dawn/SIR/ASTVisitor.h"
 #include "dawn/SIR/Statement.h"
+#include <map>
 #include <unordered_map>
 
 namespace dawn {
@@ -65,7 +66,7 @@ public:
 };
 
 /// @brief Remap all accesses from `oldAccessID` to `newAccessID` in the `accessesMap`
-static void renameAccessesMaps(std::unordered_map<int, Extents>& accessesMap, int oldAccessID,
+static void renameAccessesMaps(std::map<int, Extents>& accessesMap, int oldAccessID,
                                int newAccessID) {
   for(auto it = accessesMap.begin(); it != accessesMap.end();) {
     if(it->first == oldAccessID) {
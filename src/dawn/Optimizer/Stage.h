@@ -27,6 +27,7 @@
 
 namespace dawn {
 
+class BoundaryConditionDeclStmt;
 class StencilInstantiation;
 class DependencyGraphAccesses;
 class MultiStage;
@@ -58,6 +59,9 @@ class Stage {
 
   Extents extents_;
 
+  /// Boundary conditions applied to the boundary points right after this stage computed them
+  std::vector<std::shared_ptr<BoundaryConditionDeclStmt>> boundaryConditions_;
+
 public:
   /// @name Constructors and Assignment
   /// @{
@@ -186,6 +190,20 @@ public:
 
   Extents const& getExtents() const { return extents_; }
   /// @}
+
+  /// @brief Get the boundary conditions fused into this stage (see `PassBoundaryConditionFusion`)
+  ///
+  /// The boundary conditions are applied to the boundary points of each vertical level after the
+  /// stage computed the level. The boundary condition statements remain in the stencil
+  /// description for code generators which can not fuse them.
+  /// @{
+  std::vector<std::shared_ptr<BoundaryConditionDeclStmt>>& getBoundaryConditions() {
+    return boundaryConditions_;
+  }
+  const std::vector<std::shared_ptr<BoundaryConditionDeclStmt>>& getBoundaryConditions() const {
+    return boundaryConditions_;
+  }
+  /// @}
 };
 
 } // namespace dawn
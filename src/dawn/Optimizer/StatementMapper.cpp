@@ -61,25 +61,24 @@ void StatementMapper::removeLastChildStatementAccessesPair() {
   scope_.top()->CurentStmtAccessesPair.pop();
 }
 
-void StatementMapper::visit(const std::shared_ptr<BlockStmt>& stmt) {
+void StatementMapper::visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>& node) {
   initializedWithBlockStmt_ = true;
   scope_.top()->ScopeDepth++;
 
-  for(const auto& s : stmt->getStatements()) {
-    s->accept(*this);
-  }
+  for(const auto& s : stmt.getStatements())
+    visit(s);
 
   scope_.top()->ScopeDepth--;
 }
 
-void StatementMapper::visit(const std::shared_ptr<ExprStmt>& stmt) {
+void StatementMapper::visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
-  appendNewStatementAccessesPair(stmt);
-  stmt->getExpr()->accept(*this);
+  appendNewStatementAccessesPair(node);
+  visit(stmt.getExpr());
   removeLastChildStatementAccessesPair();
 }
 
-void StatementMapper::visit(const std::shared_ptr<ReturnStmt>& stmt) {
+void StatementMapper::visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
   DAWN_ASSERT(scope_.top()->FunctionInstantiation);
   std::shared_ptr<const StencilFunctionInstantiation> curFunc = scope_.top()->FunctionInstantiation;
@@ -93,25 +92,25 @@ void StatementMapper::visit(const std::shared_ptr<ReturnStmt>& stmt) {
   }
   scope_.top()->FunctionInstantiation->setReturn(true);
 
-  appendNewStatementAccessesPair(stmt);
-  stmt->getExpr()->accept(*this);
+  appendNewStatementAccessesPair(node);
+  visit(stmt.getExpr());
   removeLastChildStatementAccessesPair();
 }
 
-void StatementMapper::visit(const std::shared_ptr<IfStmt>& stmt) {
+void StatementMapper::visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
-  appendNewStatementAccessesPair(stmt);
-  stmt->getCondExpr()->accept(*this);
+  appendNewStatementAccessesPair(node);
+  visit(stmt.getCondExpr());
 
-  stmt->getThenStmt()->accept(*this);
-  if(stmt->hasElse())
-    stmt->getElseStmt()->accept(*this);
+  visit(stmt.getThenStmt());
+  if(stmt.hasElse())
+    visit(stmt.getElseStmt());
 
   removeLastChildStatementAccessesPair();
 }
 
-void StatementMapper::visit(const std::shared_ptr<VarDeclStmt>& stmt) {
+void StatementMapper::visitVarDeclStmt(const VarDeclStmt& stmt, const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
   // This is the first time we encounter this variable. We have to make sure the name is not
@@ -120,112 +119,112 @@ void StatementMapper::visit(const std::shared_ptr<VarDeclStmt>& stmt) {
 
   std::string globalName;
   if(instantiation_->getOptimizerContext()->getOptions().KeepVarnames)
-    globalName = stmt->getName();
+    globalName = stmt.getName();
   else
-    globalName = StencilInstantiation::makeLocalVariablename(stmt->getName(), AccessID);
+    globalName = StencilInstantiation::makeLocalVariablename(stmt.getName(), AccessID);
 
   // We generate a new AccessID and insert it into the AccessMaps (using the global name)
   auto& function = scope_.top()->FunctionInstantiation;
   if(function) {
     function->getAccessIDToNameMap().emplace(AccessID, globalName);
-    function->mapStmtToAccessID(stmt, AccessID);
+    function->mapStmtToAccessID(node, AccessID);
   } else {
     instantiation_->setAccessIDNamePair(AccessID, globalName);
-    instantiation_->getStmtToAccessIDMap().emplace(stmt, AccessID);
+    instantiation_->getStmtToAccessIDMap().emplace(node, AccessID);
   }
 
   // Add the mapping to the local scope
-  scope_.top()->LocalVarNameToAccessIDMap.emplace(stmt->getName(), AccessID);
+  scope_.top()->LocalVarNameToAccessIDMap.emplace(stmt.getName(), AccessID);
 
   // Push back the statement and move on
-  appendNewStatementAccessesPair(stmt);
+  appendNewStatementAccessesPair(node);
 
   // Resolve the RHS
-  for(const auto& expr : stmt->getInitList())
-    expr->accept(*this);
+  for(const auto& expr : stmt.getInitList())
+    visit(expr);
 
   removeLastChildStatementAccessesPair();
 }
 
-void StatementMapper::visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) {
+void StatementMapper::visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                                  const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT_MSG(0, "VerticalRegionDeclStmt not allowed in this context");
 }
 
-void StatementMapper::visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) {
+void StatementMapper::visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt,
+                                               const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT_MSG(0, "StencilCallDeclStmt not allowed in this context");
 }
 
-void StatementMapper::visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) {
+void StatementMapper::visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                                     const std::shared_ptr<Stmt>& node) {
   DAWN_ASSERT_MSG(0, "StencilCallDeclStmt not allowed in this context");
 }
 
-void StatementMapper::visit(const std::shared_ptr<AssignmentExpr>& expr) {
+void StatementMapper::visitAssignmentExpr(const AssignmentExpr& expr,
+                                          const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
-  for(auto& s : expr->getChildren())
-    s->accept(*this);
+  ASTKindVisitor<StatementMapper>::visitAssignmentExpr(expr, node);
 }
 
-void StatementMapper::visit(const std::shared_ptr<UnaryOperator>& expr) {
+void StatementMapper::visitUnaryOperator(const UnaryOperator& expr,
+                                         const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
-  for(auto& s : expr->getChildren())
-    s->accept(*this);
+  ASTKindVisitor<StatementMapper>::visitUnaryOperator(expr, node);
 }
 
-void StatementMapper::visit(const std::shared_ptr<BinaryOperator>& expr) {
+void StatementMapper::visitBinaryOperator(const BinaryOperator& expr,
+                                          const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
-  for(auto& s : expr->getChildren())
-    s->accept(*this);
+  ASTKindVisitor<StatementMapper>::visitBinaryOperator(expr, node);
 }
 
-void StatementMapper::visit(const std::shared_ptr<TernaryOperator>& expr) {
+void StatementMapper::visitTernaryOperator(const TernaryOperator& expr,
+                                           const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
-  for(auto& s : expr->getChildren())
-    s->accept(*this);
+  ASTKindVisitor<StatementMapper>::visitTernaryOperator(expr, node);
 }
 
-void StatementMapper::visit(const std::shared_ptr<FunCallExpr>& expr) {
+void StatementMapper::visitFunCallExpr(const FunCallExpr& expr, const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
-  for(auto& s : expr->getChildren())
-    s->accept(*this);
+  ASTKindVisitor<StatementMapper>::visitFunCallExpr(expr, node);
 }
 
-void StatementMapper::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
+void StatementMapper::visitStencilFunCallExpr(const StencilFunCallExpr& expr,
+                                              const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
   // Find the referenced stencil function
   std::shared_ptr<StencilFunctionInstantiation> stencilFun = nullptr;
   const Interval& interval = scope_.top()->VerticalInterval;
 
-  for(auto& SIRStencilFun : instantiation_->getSIR()->StencilFunctions) {
-    if(SIRStencilFun->Name == expr->getCallee()) {
-
-      std::shared_ptr<AST> ast = nullptr;
-      if(SIRStencilFun->isSpecialized()) {
-        // Select the correct overload
-        ast = SIRStencilFun->getASTOfInterval(interval.asSIRInterval());
-        if(ast == nullptr) {
-          DiagnosticsBuilder diag(DiagnosticsKind::Error, expr->getSourceLocation());
-          diag << "no viable Do-Method overload for stencil function call '" << expr->getCallee()
-               << "'";
-          instantiation_->getOptimizerContext()->getDiagnostics().report(diag);
-          return;
-        }
-      } else {
-        ast = SIRStencilFun->Asts.front();
+  if(auto SIRStencilFun = instantiation_->getSIR()->getStencilFunction(expr.getCallee())) {
+    std::shared_ptr<AST> ast = nullptr;
+    if(SIRStencilFun->isSpecialized()) {
+      // Select the correct overload
+      ast = SIRStencilFun->getASTOfInterval(interval.asSIRInterval());
+      if(ast == nullptr) {
+        DiagnosticsBuilder diag(DiagnosticsKind::Error, expr.getSourceLocation());
+        diag << "no viable Do-Method overload for stencil function call '" << expr.getCallee()
+             << "'";
+        instantiation_->getOptimizerContext()->getDiagnostics().report(diag);
+        return;
       }
+    } else {
+      ast = SIRStencilFun->Asts.front();
+    }
 
-      // Clone the AST s.t each stencil function has their own AST which is modifiable
-      ast = ast->clone();
+    // Clone the AST s.t each stencil function has their own AST which is modifiable
+    ast = ast->clone();
 
-      stencilFun = instantiation_->makeStencilFunctionInstantiation(
-          expr, SIRStencilFun, ast, interval, scope_.top()->FunctionInstantiation);
-      break;
-    }
+    stencilFun = instantiation_->makeStencilFunctionInstantiation(
+        std::static_pointer_cast<StencilFunCallExpr>(node), SIRStencilFun, ast, interval,
+        scope_.top()->FunctionInstantiation);
   }
   DAWN_ASSERT(stencilFun);
 
@@ -242,8 +241,8 @@ void StatementMapper::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
                                                             stencilFun->getInterval(), stencilFun));
 
   // Resolve the arguments
-  for(auto& arg : expr->getArguments())
-    arg->accept(*this);
+  for(const auto& arg : expr.getArguments())
+    visit(arg);
 
   instantiation_->finalizeStencilFunctionSetup(stencilFun);
 
@@ -261,7 +260,7 @@ void StatementMapper::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
   // Resolve the function
   scope_.push(scope_.top()->CandiateScopes.top());
 
-  scope_.top()->FunctionInstantiation->getAST()->accept(*this);
+  visit(*scope_.top()->FunctionInstantiation->getAST());
 
   stencilFun->checkFunctionBindings();
 
@@ -275,7 +274,8 @@ void StatementMapper::visit(const std::shared_ptr<StencilFunCallExpr>& expr) {
   scope_.top()->CandiateScopes.pop();
 }
 
-void StatementMapper::visit(const std::shared_ptr<StencilFunArgExpr>& expr) {
+void StatementMapper::visitStencilFunArgExpr(const StencilFunArgExpr& expr,
+                                             const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
   DAWN_ASSERT(!scope_.top()->CandiateScopes.empty());
@@ -283,47 +283,49 @@ void StatementMapper::visit(const std::shared_ptr<StencilFunArgExpr>& expr) {
   auto& function = scope_.top()->FunctionInstantiation;
   auto stencilFun = getCurrentCandidateScope()->FunctionInstantiation;
   auto& argumentIndex = getCurrentCandidateScope()->ArgumentIndex;
-  bool needsLazyEval = expr->getArgumentIndex() != -1;
+  bool needsLazyEval = expr.getArgumentIndex() != -1;
 
   if(stencilFun->isArgOffset(argumentIndex)) {
     // Argument is an offset
     stencilFun->setCallerOffsetOfArgOffset(
         argumentIndex, needsLazyEval
-                           ? function->getCallerOffsetOfArgOffset(expr->getArgumentIndex())
-                           : Array2i{{expr->getDimension(), expr->getOffset()}});
+                           ? function->getCallerOffsetOfArgOffset(expr.getArgumentIndex())
+                           : Array2i{{expr.getDimension(), expr.getOffset()}});
   } else {
     // Argument is a direction
     stencilFun->setCallerDimensionOfArgDirection(
         argumentIndex, needsLazyEval
-                           ? function->getCallerDimensionOfArgDirection(expr->getArgumentIndex())
-                           : expr->getDimension());
+                           ? function->getCallerDimensionOfArgDirection(expr.getArgumentIndex())
+                           : expr.getDimension());
   }
 
   argumentIndex += 1;
 }
 
-void StatementMapper::visit(const std::shared_ptr<VarAccessExpr>& expr) {
+void StatementMapper::visitVarAccessExpr(const VarAccessExpr& expr,
+                                         const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
   auto& function = scope_.top()->FunctionInstantiation;
-  const auto& varname = expr->getName();
+  const auto& varname = expr.getName();
 
-  if(expr->isExternal()) {
-    DAWN_ASSERT_MSG(!expr->isArrayAccess(), "global array access is not supported");
+  if(expr.isExternal()) {
+    DAWN_ASSERT_MSG(!expr.isArrayAccess(), "global array access is not supported");
 
     const auto& value = instantiation_->getGlobalVariableValue(varname);
     if(value.isConstexpr()) {
       // Replace the variable access with the actual value
       DAWN_ASSERT_MSG(!value.empty(), "constant global variable with no value");
 
+      // (`node` refers to the slot of the parent which is overwritten, keep `expr` alive)
+      std::shared_ptr<Expr> oldExpr = node;
       auto newExpr = std::make_shared<dawn::LiteralAccessExpr>(
           value.toString(), sir::Value::typeToBuiltinTypeID(value.getType()));
       replaceOldExprWithNewExprInStmt(
-          scope_.top()->StatementAccessesPairs.back()->getStatement()->ASTStmt, expr, newExpr);
+          scope_.top()->StatementAccessesPairs.back()->getStatement()->ASTStmt, oldExpr, newExpr);
 
-      int AccessID = instantiation_->nextUID();
-      instantiation_->getLiteralAccessIDToNameMap().emplace(AccessID, newExpr->getValue());
-      instantiation_->mapExprToAccessID(newExpr, AccessID);
+      // Register the literal (in the stencil function if we are inside one)
+      visit(newExpr);
 
     } else {
       StencilInstantiation* stencilInstantiation =
@@ -341,26 +343,27 @@ void StatementMapper::visit(const std::shared_ptr<VarAccessExpr>& expr) {
         function->setAccessIDOfGlobalVariable(AccessID);
 
       if(function) {
-        function->mapExprToAccessID(expr, AccessID);
-        instantiation_->mapExprToAccessID(expr, AccessID);
+        function->mapExprToAccessID(node, AccessID);
+        instantiation_->mapExprToAccessID(node, AccessID);
       } else
-        instantiation_->mapExprToAccessID(expr, AccessID);
+        instantiation_->mapExprToAccessID(node, AccessID);
     }
 
   } else {
     // Register the mapping between VarAccessExpr and AccessID.
     if(function)
-      function->mapExprToAccessID(expr, scope_.top()->LocalVarNameToAccessIDMap[varname]);
+      function->mapExprToAccessID(node, scope_.top()->LocalVarNameToAccessIDMap[varname]);
     else
-      instantiation_->mapExprToAccessID(expr, scope_.top()->LocalVarNameToAccessIDMap[varname]);
+      instantiation_->mapExprToAccessID(node, scope_.top()->LocalVarNameToAccessIDMap[varname]);
 
     // Resolve the index if this is an array access
-    if(expr->isArrayAccess())
-      expr->getIndex()->accept(*this);
+    if(expr.isArrayAccess())
+      visit(expr.getIndex());
   }
 }
 
-void StatementMapper::visit(const std::shared_ptr<LiteralAccessExpr>& expr) {
+void StatementMapper::visitLiteralAccessExpr(const LiteralAccessExpr& expr,
+                                             const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
   // Register a literal access (Note: the negative AccessID we assign!)
@@ -368,25 +371,26 @@ void StatementMapper::visit(const std::shared_ptr<LiteralAccessExpr>& expr) {
 
   auto& function = scope_.top()->FunctionInstantiation;
   if(function) {
-    function->getLiteralAccessIDToNameMap().emplace(AccessID, expr->getValue());
-    function->mapExprToAccessID(expr, AccessID);
+    function->getLiteralAccessIDToNameMap().emplace(AccessID, expr.getValue());
+    function->mapExprToAccessID(node, AccessID);
   } else {
-    instantiation_->getLiteralAccessIDToNameMap().emplace(AccessID, expr->getValue());
-    instantiation_->mapExprToAccessID(expr, AccessID);
+    instantiation_->getLiteralAccessIDToNameMap().emplace(AccessID, expr.getValue());
+    instantiation_->mapExprToAccessID(node, AccessID);
   }
 }
 
-void StatementMapper::visit(const std::shared_ptr<FieldAccessExpr>& expr) {
+void StatementMapper::visitFieldAccessExpr(const FieldAccessExpr& expr,
+                                           const std::shared_ptr<Expr>& node) {
   DAWN_ASSERT(initializedWithBlockStmt_);
 
   // Register the mapping between FieldAccessExpr and AccessID
-  int AccessID = scope_.top()->LocalFieldnameToAccessIDMap[expr->getName()];
+  int AccessID = scope_.top()->LocalFieldnameToAccessIDMap[expr.getName()];
 
   auto& function = scope_.top()->FunctionInstantiation;
   if(function) {
-    function->mapExprToAccessID(expr, AccessID);
+    function->mapExprToAccessID(node, AccessID);
   } else {
-    instantiation_->mapExprToAccessID(expr, AccessID);
+    instantiation_->mapExprToAccessID(node, AccessID);
   }
 
   if(Scope* candiateScope = getCurrentCandidateScope()) {
@@ -395,7 +399,8 @@ void StatementMapper::visit(const std::shared_ptr<FieldAccessExpr>& expr) {
     candiateScope->FunctionInstantiation->setCallerAccessIDOfArgField(candiateScope->ArgumentIndex,
                                                                       AccessID);
     candiateScope->FunctionInstantiation->setCallerInitialOffsetFromAccessID(
-        AccessID, function ? function->evalOffsetOfFieldAccessExpr(expr) : expr->getOffset());
+        AccessID,
+        function ? function->evalOffsetOfFieldAccessExpr(expr, node) : expr.getOffset());
     candiateScope->ArgumentIndex += 1;
   }
 }
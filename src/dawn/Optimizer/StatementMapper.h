@@ -13,6 +13,7 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/ASTKindVisitor.h"
 #include "dawn/SIR/ASTUtil.h"
 #include <stack>
 
@@ -23,7 +24,7 @@ namespace dawn {
 //===------------------------------------------------------------------------------------------===//
 /// @brief Map the statements of the AST to a flat list of statements and assign AccessIDs to all
 /// field, variable and literal accesses. In addition, stencil functions are instantiated.
-class StatementMapper : public ASTVisitor {
+class StatementMapper : public ASTKindVisitor<StatementMapper> {
 
   /// @brief Representation of the current scope which keeps track of the binding of field and
   /// variable names
@@ -85,41 +86,43 @@ public:
 
   void removeLastChildStatementAccessesPair();
 
-  void visit(const std::shared_ptr<BlockStmt>& stmt) override;
+  void visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>& node);
 
-  void visit(const std::shared_ptr<ExprStmt>& stmt) override;
+  void visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>& node);
 
-  void visit(const std::shared_ptr<ReturnStmt>& stmt) override;
+  void visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>& node);
 
-  void visit(const std::shared_ptr<IfStmt>& stmt) override;
+  void visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node);
 
-  void visit(const std::shared_ptr<VarDeclStmt>& stmt) override;
+  void visitVarDeclStmt(const VarDeclStmt& stmt, const std::shared_ptr<Stmt>& node);
 
-  void visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) override;
+  void visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                   const std::shared_ptr<Stmt>& node);
 
-  void visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) override;
+  void visitStencilCallDeclStmt(const StencilCallDeclStmt& stmt, const std::shared_ptr<Stmt>& node);
 
-  void visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) override;
+  void visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt& stmt,
+                                      const std::shared_ptr<Stmt>& node);
 
-  void visit(const std::shared_ptr<AssignmentExpr>& expr) override;
+  void visitAssignmentExpr(const AssignmentExpr& expr, const std::shared_ptr<Expr>& node);
 
-  void visit(const std::shared_ptr<UnaryOperator>& expr) override;
+  void visitUnaryOperator(const UnaryOperator& expr, const std::shared_ptr<Expr>& node);
 
-  void visit(const std::shared_ptr<BinaryOperator>& expr) override;
+  void visitBinaryOperator(const BinaryOperator& expr, const std::shared_ptr<Expr>& node);
 
-  void visit(const std::shared_ptr<TernaryOperator>& expr) override;
+  void visitTernaryOperator(const TernaryOperator& expr, const std::shared_ptr<Expr>& node);
 
-  void visit(const std::shared_ptr<FunCallExpr>& expr) override;
+  void visitFunCallExpr(const FunCallExpr& expr, const std::shared_ptr<Expr>& node);
 
-  void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override;
+  void visitStencilFunCallExpr(const StencilFunCallExpr& expr, const std::shared_ptr<Expr>& node);
 
-  virtual void visit(const std::shared_ptr<StencilFunArgExpr>& expr) override;
+  void visitStencilFunArgExpr(const StencilFunArgExpr& expr, const std::shared_ptr<Expr>& node);
 
-  void visit(const std::shared_ptr<VarAccessExpr>& expr) override;
+  void visitVarAccessExpr(const VarAccessExpr& expr, const std::shared_ptr<Expr>& node);
 
-  void visit(const std::shared_ptr<LiteralAccessExpr>& expr) override;
+  void visitLiteralAccessExpr(const LiteralAccessExpr& expr, const std::shared_ptr<Expr>& node);
 
-  void visit(const std::shared_ptr<FieldAccessExpr>& expr) override;
+  void visitFieldAccessExpr(const FieldAccessExpr& expr, const std::shared_ptr<Expr>& node);
 };
 
 } // namespace dawn
@@ -358,7 +358,7 @@ Stencil::getLifetime(const std::unordered_set<int>& AccessIDs) const {
           const Accesses& accesses =
               *doMethod.getStatementAccessesPairs()[statementIdx]->getAccesses();
 
-          auto processAccessMap = [&](const std::unordered_map<int, Extents>& accessMap) {
+          auto processAccessMap = [&](const std::map<int, Extents>& accessMap) {
             for(const auto& AccessIDExtentPair : accessMap) {
               int AccessID = AccessIDExtentPair.first;
 
@@ -37,28 +37,33 @@ StencilFunctionInstantiation::StencilFunctionInstantiation(
 
 Array3i StencilFunctionInstantiation::evalOffsetOfFieldAccessExpr(
     const std::shared_ptr<FieldAccessExpr>& expr, bool applyInitialOffset) const {
+  return evalOffsetOfFieldAccessExpr(*expr, expr, applyInitialOffset);
+}
+
+Array3i StencilFunctionInstantiation::evalOffsetOfFieldAccessExpr(
+    const FieldAccessExpr& expr, const std::shared_ptr<Expr>& node, bool applyInitialOffset) const {
 
   // Get the offsets we know so far (i.e the constant offset)
-  Array3i offset = expr->getOffset();
+  Array3i offset = expr.getOffset();
 
   // Apply the initial offset (e.g if we call a function `avg(in(i+1))` we have to shift all
   // accesses of the field `in` by [1, 0, 0])
   if(applyInitialOffset) {
-    const Array3i& initialOffset = getCallerInitialOffsetFromAccessID(getAccessIDFromExpr(expr));
+    const Array3i& initialOffset = getCallerInitialOffsetFromAccessID(getAccessIDFromExpr(node));
     offset[0] += initialOffset[0];
     offset[1] += initialOffset[1];
     offset[2] += initialOffset[2];
   }
 
-  int sign = expr->negateOffset() ? -1 : 1;
+  int sign = expr.negateOffset() ? -1 : 1;
 
   // Iterate the argument map (if index is *not* -1, we have to lookup the dimension or offset of
   // the directional or offset argument)
-  for(int i = 0; i < expr->getArgumentMap().size(); ++i) {
-    const int argIndex = expr->getArgumentMap()[i];
+  for(int i = 0; i < expr.getArgumentMap().size(); ++i) {
+    const int argIndex = expr.getArgumentMap()[i];
 
     if(argIndex != -1) {
-      const int argOffset = expr->getArgumentOffset()[i];
+      const int argOffset = expr.getArgumentOffset()[i];
 
       // Resolve the directions and offsets
       if(isArgDirection(argIndex))
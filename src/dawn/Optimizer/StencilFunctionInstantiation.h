@@ -184,6 +184,9 @@ public:
   /// @brief check if all the stencil function arguments are bound
   bool isArgsBound() const { return argsBound_; }
 
+  /// @brief set if all the stencil function arguments are bound
+  void setArgsBound(bool argsBound) { argsBound_ = argsBound; }
+
   /// @brief returns number of arguments
   size_t numArgs() const;
 
@@ -228,9 +231,16 @@ public:
 
   /// @brief Evaluate the offset of the field access expression (this performs the lazy evaluation
   /// of the offsets)
+  /// @{
   Array3i evalOffsetOfFieldAccessExpr(const std::shared_ptr<FieldAccessExpr>& expr,
                                       bool applyInitialOffset = true) const;
 
+  /// `node` is the pointer owning `expr` which is used to look up its AccessID
+  Array3i evalOffsetOfFieldAccessExpr(const FieldAccessExpr& expr,
+                                      const std::shared_ptr<Expr>& node,
+                                      bool applyInitialOffset = true) const;
+  /// @}
+
   /// @brief returns true if the argument in the argumentIndex position is bound to an offset
   /// argument
   bool isArgBoundAsOffset(int argumentIndex) const;
@@ -286,12 +296,22 @@ public:
   void setCallerInitialOffsetFromAccessID(int callerAccessID, const Array3i& offset);
   /// @}
 
+  /// @brief Get the map of @b caller AccessIDs to their initial offset
+  const std::unordered_map<int, Array3i>& getCallerAccessIDToInitialOffsetMap() const {
+    return CallerAcceessIDToInitialOffsetMap_;
+  }
+
   /// @brief Get/Set if a field (given by its AccessID) is provided via a stencil function call
   /// @{
   bool isProvidedByStencilFunctionCall(int callerAccessID) const;
   void setIsProvidedByStencilFunctionCall(int callerAccessID);
   /// @}
 
+  /// @brief Get the AccessIDs of the fields which are provided via a stencil function call
+  const std::set<int>& getAccessIDSetProvidedByStencilFunctionCalls() const {
+    return isProvidedByStencilFunctionCall_;
+  }
+
   /// @brief Get the argument index of the field (or stencil function instantiation) given the
   /// AccessID
   int getArgumentIndexFromCallerAccessID(int callerAccessID) const;
@@ -346,6 +366,16 @@ public:
   /// @brief Add entry to the map between a given stmt to its access ID
   void mapStmtToAccessID(const std::shared_ptr<Stmt>& stmt, int AccessID);
 
+  /// @brief Get the Expr-to-caller-AccessID map
+  const std::unordered_map<std::shared_ptr<Expr>, int>& getExprToCallerAccessIDMap() const {
+    return ExprToCallerAccessIDMap_;
+  }
+
+  /// @brief Get the Stmt-to-caller-AccessID map
+  const std::unordered_map<std::shared_ptr<Stmt>, int>& getStmtToCallerAccessIDMap() const {
+    return StmtToCallerAccessIDMap_;
+  }
+
   /// @brief Get the Literal-AccessID-to-Name map
   std::unordered_map<int, std::string>& getLiteralAccessIDToNameMap();
   const std::unordered_map<int, std::string>& getLiteralAccessIDToNameMap() const;
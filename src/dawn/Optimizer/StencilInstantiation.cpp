@@ -192,7 +192,7 @@ public:
       void visit(const std::shared_ptr<BlockStmt>& stmt) override {
         for(auto it = stmt->getStatements().begin(); it != stmt->getStatements().end();) {
           if(needsRemoval(*it)) {
-            it = stmt->getStatements().erase(it);
+            it = stmt->erase(it);
           } else {
             (*it)->accept(*this);
             ++it;
@@ -369,7 +369,7 @@ public:
     StatementMapper statementMapper(instantiation_, scope_.top()->StackTrace,
                                     doMethod.getStatementAccessesPairs(), doMethod.getInterval(),
                                     scope_.top()->LocalFieldnameToAccessIDMap, nullptr);
-    ast->accept(statementMapper);
+    statementMapper.visit(*ast);
     DAWN_LOG(INFO) << "Inserted " << doMethod.getStatementAccessesPairs().size() << " statements";
 
     if(instantiation_->getOptimizerContext()->getDiagnostics().hasErrors())
@@ -416,11 +416,9 @@ public:
     candiateScope->StackTrace->push_back(stencilCall);
 
     // Get the sir::Stencil from the callee name
-    auto stencilIt = std::find_if(
-        instantiation_->getSIR()->Stencils.begin(), instantiation_->getSIR()->Stencils.end(),
-        [&](const std::shared_ptr<sir::Stencil>& s) { return s->Name == stencilCall->Callee; });
-    DAWN_ASSERT(stencilIt != instantiation_->getSIR()->Stencils.end());
-    sir::Stencil& stencil = **stencilIt;
+    auto stencilPtr = instantiation_->getSIR()->getStencil(stencilCall->Callee);
+    DAWN_ASSERT(stencilPtr);
+    sir::Stencil& stencil = *stencilPtr;
 
     // We need less or an equal amount of args as temporaries are added implicitly
     DAWN_ASSERT(stencilCall->Args.size() <= stencil.Fields.size());
@@ -535,7 +533,7 @@ public:
             value.toString(), sir::Value::typeToBuiltinTypeID(value.getType()));
         replaceOldExprWithNewExprInStmt(scope_.top()->Statements.back()->ASTStmt, expr, newExpr);
 
-        int AccessID = instantiation_->nextUID();
+        int AccessID = -instantiation_->nextUID();
         instantiation_->getLiteralAccessIDToNameMap().emplace(AccessID, newExpr->getValue());
         instantiation_->mapExprToAccessID(newExpr, AccessID);
 
@@ -579,16 +577,23 @@ public:
 
 StencilInstantiation::StencilInstantiation(OptimizerContext* context,
                                            std::shared_ptr<sir::Stencil> const& SIRStencil,
-                                           std::shared_ptr<SIR> const& SIR)
+                                           std::shared_ptr<SIR> const& SIR, bool initialize)
     : context_(context), SIRStencil_(SIRStencil), SIR_(SIR) {
-  DAWN_LOG(INFO) << "Intializing StencilInstantiation of `" << SIRStencil->Name << "`";
   DAWN_ASSERT_MSG(SIRStencil, "Stencil does not exist");
+  if(!initialize)
+    return;
+
+  DAWN_LOG(INFO) << "Intializing StencilInstantiation of `" << SIRStencil->Name << "`";
 
   // Map the fields of the "main stencil" to unique IDs (which are used in the access maps to
   // indentify the field).
   for(const auto& field : SIRStencil->Fields) {
     int AccessID = nextUID();
     setAccessIDNamePairOfField(AccessID, field->Name, field->IsTemporary);
+
+    // The SIR leaves the dimensions unspecified (all zero) for three dimensional fields
+    if(field->fieldDimensions != Array3i{{0, 0, 0}})
+      setFieldDimensions(AccessID, field->fieldDimensions);
   }
 
   // Process the stencil description of the "main stencil"
@@ -637,6 +642,7 @@ void StencilInstantiation::removeAccessID(int AccessID) {
   AccessIDToNameMap_.erase(AccessID);
   FieldAccessIDSet_.erase(AccessID);
   TemporaryFieldAccessIDSet_.erase(AccessID);
+  FieldDimensionsMap_.erase(AccessID);
 
   if(variableVersions_.hasVariableMultipleVersions(AccessID)) {
     auto versions = variableVersions_.getVersions(AccessID);
@@ -646,6 +652,19 @@ void StencilInstantiation::removeAccessID(int AccessID) {
   }
 }
 
+Array3i StencilInstantiation::getFieldDimensions(int AccessID) const {
+  auto it = FieldDimensionsMap_.find(AccessID);
+  return it != FieldDimensionsMap_.end() ? it->second : Array3i{{1, 1, 1}};
+}
+
+void StencilInstantiation::setFieldDimensions(int AccessID, const Array3i& dimensions) {
+  DAWN_ASSERT(isField(AccessID));
+  if(dimensions == Array3i{{1, 1, 1}})
+    FieldDimensionsMap_.erase(AccessID);
+  else
+    FieldDimensionsMap_[AccessID] = dimensions;
+}
+
 const std::string StencilInstantiation::getName() const { return SIRStencil_->Name; }
 
 const std::unordered_map<std::shared_ptr<Stmt>, int>&
@@ -717,6 +736,8 @@ int StencilInstantiation::createVersionAndRename(int AccessID, Stencil* stencil,
   int newAccessID = nextUID();
 
   if(isField(AccessID)) {
+    Array3i dimensions = getFieldDimensions(AccessID);
+
     if(variableVersions_.hasVariableMultipleVersions(AccessID)) {
       // Field is already multi-versioned, append a new version
       auto versions = variableVersions_.getVersions(AccessID);
@@ -734,6 +755,7 @@ int StencilInstantiation::createVersionAndRename(int AccessID, Stencil* stencil,
       setAccessIDNamePairOfField(newAccessID, originalName + "_" + std::to_string(versions->size()),
                                  false);
       AllocatedFieldAccessIDSet_.insert(newAccessID);
+      setFieldDimensions(newAccessID, dimensions);
 
       versions->push_back(newAccessID);
       variableVersions_.insert(newAccessID, versions);
@@ -748,6 +770,7 @@ int StencilInstantiation::createVersionAndRename(int AccessID, Stencil* stencil,
 
       setAccessIDNamePairOfField(newAccessID, originalName + "_1", false);
       AllocatedFieldAccessIDSet_.insert(newAccessID);
+      setFieldDimensions(newAccessID, dimensions);
 
       variableVersions_.insert(AccessID, versionsVecPtr);
       variableVersions_.insert(newAccessID, versionsVecPtr);
@@ -1192,6 +1215,15 @@ const std::unordered_map<int, std::string>& StencilInstantiation::getStageIDToNa
   return StageIDToNameMap_;
 }
 
+std::unordered_map<std::shared_ptr<Expr>, int>& StencilInstantiation::getExprToAccessIDMap() {
+  return ExprToAccessIDMap_;
+}
+
+const std::unordered_map<std::shared_ptr<Expr>, int>&
+StencilInstantiation::getExprToAccessIDMap() const {
+  return ExprToAccessIDMap_;
+}
+
 std::set<int>& StencilInstantiation::getFieldAccessIDSet() { return FieldAccessIDSet_; }
 
 const std::set<int>& StencilInstantiation::getFieldAccessIDSet() const { return FieldAccessIDSet_; }
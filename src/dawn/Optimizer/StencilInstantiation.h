@@ -22,6 +22,7 @@
 #include "dawn/Support/NonCopyable.h"
 #include "dawn/Support/StringRef.h"
 #include "dawn/Support/UIDGenerator.h"
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -64,6 +65,23 @@ public:
   int getOriginalVersionOfAccessID(const int accessID) const {
     return versionToOriginalVersionMap_.at(accessID);
   }
+
+  /// @brief Get the map of AccessIDs to the list of all AccessIDs of their versions
+  const std::unordered_map<int, std::shared_ptr<std::vector<int>>>&
+  getVariableVersionsMap() const {
+    return variableVersionsMap_;
+  }
+
+  /// @brief Get the map of the versions to the AccessID of their original variable
+  /// @{
+  std::unordered_map<int, int>& getVersionToOriginalVersionMap() {
+    return versionToOriginalVersionMap_;
+  }
+  const std::unordered_map<int, int>& getVersionToOriginalVersionMap() const {
+    return versionToOriginalVersionMap_;
+  }
+  /// @}
+
   VariableVersions() = default;
 };
 
@@ -116,6 +134,10 @@ class StencilInstantiation : NonCopyable {
   /// as temporaries spanning over multiple stencils
   std::set<int> AllocatedFieldAccessIDSet_;
 
+  /// Map of the AccessIDs of the fields which do not extend in all three dimensions to their
+  /// dimensions (e.g `{1, 1, 0}` for a horizontal field which is constant along the vertical)
+  std::map<int, Array3i> FieldDimensionsMap_;
+
   /// Set containing the AccessIDs of "global variable" accesses. Global variable accesses are
   /// represented by global_accessor or if we know the value at compile time we do a constant
   /// folding of the variable
@@ -165,8 +187,12 @@ class StencilInstantiation : NonCopyable {
 
 public:
   /// @brief Assemble StencilInstantiation for stencil
+  ///
+  /// If `initialize` is `false`, the statements of the stencil are not mapped and the
+  /// instantiation is left empty (this is used to reload an already optimized instantiation, see
+  /// `IIRSerializer`).
   StencilInstantiation(OptimizerContext* context, const std::shared_ptr<sir::Stencil>& SIRStencil,
-                       const std::shared_ptr<SIR>& SIR);
+                       const std::shared_ptr<SIR>& SIR, bool initialize = true);
 
   /// @brief Insert a new AccessID - Name pair
   void setAccessIDNamePair(int AccessID, const std::string& name);
@@ -222,6 +248,17 @@ public:
   /// @brief Check if the stencil instantiation needs to allocate fields
   bool hasAllocatedFields() const { return !AllocatedFieldAccessIDSet_.empty(); }
 
+  /// @brief Get the dimensions of the field `AccessID` (`1` if the field extends in the dimension)
+  Array3i getFieldDimensions(int AccessID) const;
+
+  /// @brief Set the dimensions of the field `AccessID`
+  void setFieldDimensions(int AccessID, const Array3i& dimensions);
+
+  /// @brief Check whether the field `AccessID` is constant along the vertical dimension
+  bool isHorizontalField(int AccessID) const {
+    return isField(AccessID) && getFieldDimensions(AccessID)[2] == 0;
+  }
+
   /// @brief Check whether the `AccessID` corresponds to an accesses of a global variable
   bool isGlobalVariable(int AccessID) const { return GlobalVariableAccessIDSet_.count(AccessID); }
   bool isGlobalVariable(const std::string& name) const;
@@ -425,6 +462,9 @@ public:
   int getStencilIDFromStmt(const std::shared_ptr<StencilCallDeclStmt>& stmt) const;
 
   /// @brief Get the stencil description AST
+  std::vector<std::shared_ptr<Statement>>& getStencilDescStatements() {
+    return stencilDescStatements_;
+  }
   const std::vector<std::shared_ptr<Statement>>& getStencilDescStatements() const {
     return stencilDescStatements_;
   }
@@ -442,6 +482,10 @@ public:
   std::unordered_map<std::shared_ptr<Stmt>, int>& getStmtToAccessIDMap();
   const std::unordered_map<std::shared_ptr<Stmt>, int>& getStmtToAccessIDMap() const;
 
+  /// @brief Get map which associates Exprs with AccessIDs
+  std::unordered_map<std::shared_ptr<Expr>, int>& getExprToAccessIDMap();
+  const std::unordered_map<std::shared_ptr<Expr>, int>& getExprToAccessIDMap() const;
+
   /// @brief Get the AccessID-to-Name map
   std::unordered_map<std::string, int>& getNameToAccessIDMap();
   const std::unordered_map<std::string, int>& getNameToAccessIDMap() const;
@@ -466,6 +510,22 @@ public:
   std::set<int>& getGlobalVariableAccessIDSet();
   const std::set<int>& getGlobalVariableAccessIDSet() const;
 
+  /// @brief Get the temporary field-AccessID set
+  std::set<int>& getTemporaryFieldAccessIDSet() { return TemporaryFieldAccessIDSet_; }
+  const std::set<int>& getTemporaryFieldAccessIDSet() const { return TemporaryFieldAccessIDSet_; }
+
+  /// @brief Get the allocated field-AccessID set
+  std::set<int>& getAllocatedFieldAccessIDSet() { return AllocatedFieldAccessIDSet_; }
+  const std::set<int>& getAllocatedFieldAccessIDSet() const { return AllocatedFieldAccessIDSet_; }
+
+  /// @brief Get the map of the fields which do not extend in all three dimensions
+  std::map<int, Array3i>& getFieldDimensionsMap() { return FieldDimensionsMap_; }
+  const std::map<int, Array3i>& getFieldDimensionsMap() const { return FieldDimensionsMap_; }
+
+  /// @brief Get the versions of the multi-versioned fields and variables
+  VariableVersions& getVariableVersions() { return variableVersions_; }
+  const VariableVersions& getVariableVersions() const { return variableVersions_; }
+
   /// @brief Get the SIR
   std::shared_ptr<SIR> const& getSIR() const { return SIR_; }
 
@@ -500,6 +560,10 @@ public:
   /// @brief Get a unique (positive) identifier
   int nextUID() { return UIDGen_.get(); }
 
+  /// @brief Get the generator of the unique identifiers
+  UIDGenerator& getUIDGenerator() { return UIDGen_; }
+  const UIDGenerator& getUIDGenerator() const { return UIDGen_; }
+
   /// @brief Dump the StencilInstantiation to stdout
   void dump() const;
 
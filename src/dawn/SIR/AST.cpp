@@ -61,6 +61,8 @@ std::shared_ptr<AST> AST::clone() const {
   return std::make_shared<AST>(std::static_pointer_cast<BlockStmt>(root_->clone()));
 }
 
+std::size_t AST::getHash() const { return root_->getHash(); }
+
 void AST::clear() { root_.reset(); }
 
 } // namespace dawn
@@ -66,6 +66,9 @@ public:
   /// @brief Clone the AST
   std::shared_ptr<AST> clone() const;
 
+  /// @brief Structural hash of the AST (see `Stmt::getHash`)
+  std::size_t getHash() const;
+
   /// @brief Clear the AST
   void clear();
 };
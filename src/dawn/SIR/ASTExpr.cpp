@@ -17,25 +17,47 @@
 #include "dawn/SIR/ASTVisitor.h"
 #include "dawn/Support/Assert.h"
 #include "dawn/Support/Casting.h"
+#include "dawn/Support/HashCombine.h"
 
 namespace dawn {
 
+//===------------------------------------------------------------------------------------------===//
+//     Expr
+//===------------------------------------------------------------------------------------------===//
+
+std::size_t Expr::getHash() const {
+  return hash_.get([this]() {
+    std::size_t seed = getLocalHash();
+    // `getChildren` does not modify the node, it is merely not declared const
+    for(const auto& child : const_cast<Expr*>(this)->getChildren())
+      hash_combine(seed, child->getHash());
+    return seed;
+  });
+}
+
+std::size_t Expr::getLocalHash() const { return std::hash<int>()(static_cast<int>(kind_)); }
+
 //===------------------------------------------------------------------------------------------===//
 //     UnaryOperator
 //===------------------------------------------------------------------------------------------===//
 
 UnaryOperator::UnaryOperator(const std::shared_ptr<Expr>& operand, std::string op,
                              SourceLocation loc)
-    : Expr(EK_UnaryOperator, loc), operand_(operand), op_(std::move(op)) {}
+    : Expr(EK_UnaryOperator, loc), operand_(operand), op_(std::move(op)) {
+  adopt(operand_);
+}
 
 UnaryOperator::UnaryOperator(const UnaryOperator& expr)
     : Expr(EK_UnaryOperator, expr.getSourceLocation()), operand_(expr.getOperand()->clone()),
-      op_(expr.getOp()) {}
+      op_(expr.getOp()) {
+  adopt(operand_);
+}
 
 UnaryOperator& UnaryOperator::operator=(UnaryOperator expr) {
   assign(expr);
   operand_ = expr.getOperand();
   op_ = expr.getOp();
+  adopt(operand_);
   return *this;
 }
 
@@ -51,10 +73,18 @@ bool UnaryOperator::equals(const Expr* other) const {
          op_ == otherPtr->op_;
 }
 
+std::size_t UnaryOperator::getLocalHash() const {
+  std::size_t seed = Expr::getLocalHash();
+  hash_combine(seed, op_);
+  return seed;
+}
+
 void UnaryOperator::replaceChildren(const std::shared_ptr<Expr>& oldExpr,
                                     const std::shared_ptr<Expr>& newExpr) {
   DAWN_ASSERT(oldExpr == operand_);
   operand_ = newExpr;
+  adopt(operand_);
+  invalidateHash();
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -63,17 +93,25 @@ void UnaryOperator::replaceChildren(const std::shared_ptr<Expr>& oldExpr,
 
 BinaryOperator::BinaryOperator(const std::shared_ptr<Expr>& left, std::string op,
                                const std::shared_ptr<Expr>& right, SourceLocation loc)
-    : Expr(EK_BinaryOperator, loc), operands_{left, right}, op_(std::move(op)) {}
+    : Expr(EK_BinaryOperator, loc), operands_{left, right}, op_(std::move(op)) {
+  adopt(left);
+  adopt(right);
+}
 
 BinaryOperator::BinaryOperator(const BinaryOperator& expr)
     : Expr(EK_BinaryOperator, expr.getSourceLocation()),
-      operands_{expr.getLeft()->clone(), expr.getRight()->clone()}, op_(expr.getOp()) {}
+      operands_{expr.getLeft()->clone(), expr.getRight()->clone()}, op_(expr.getOp()) {
+  adopt(operands_[OK_Left]);
+  adopt(operands_[OK_Right]);
+}
 
 BinaryOperator& BinaryOperator::operator=(BinaryOperator expr) {
   assign(expr);
   operands_[OK_Left] = expr.getLeft();
   operands_[OK_Right] = expr.getRight();
   op_ = expr.getOp();
+  adopt(operands_[OK_Left]);
+  adopt(operands_[OK_Right]);
   return *this;
 }
 
@@ -90,10 +128,18 @@ bool BinaryOperator::equals(const Expr* other) const {
          operands_[OK_Right]->equals(otherPtr->operands_[OK_Right].get()) && op_ == otherPtr->op_;
 }
 
+std::size_t BinaryOperator::getLocalHash() const {
+  std::size_t seed = Expr::getLocalHash();
+  hash_combine(seed, op_);
+  return seed;
+}
+
 void BinaryOperator::replaceChildren(const std::shared_ptr<Expr>& oldExpr,
                                      const std::shared_ptr<Expr>& newExpr) {
   bool success = ASTHelper::replaceOperands(oldExpr, newExpr, operands_);
   DAWN_ASSERT_MSG((success), ("Expression not found"));
+  adopt(newExpr);
+  invalidateHash();
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -118,6 +164,8 @@ AssignmentExpr& AssignmentExpr::operator=(AssignmentExpr expr) {
   operands_[OK_Left] = expr.getLeft();
   operands_[OK_Right] = expr.getRight();
   op_ = expr.getOp();
+  adopt(operands_[OK_Left]);
+  adopt(operands_[OK_Right]);
   return *this;
 }
 
@@ -153,7 +201,7 @@ NOPExpr::~NOPExpr() {}
 
 std::shared_ptr<Expr> NOPExpr::clone() const { return std::make_shared<NOPExpr>(*this); }
 
-bool NOPExpr::equals(const Expr* other) const { return true; }
+bool NOPExpr::equals(const Expr* other) const { return Expr::equals(other); }
 
 //===------------------------------------------------------------------------------------------===//
 //     TernaryOperator
@@ -162,17 +210,25 @@ bool NOPExpr::equals(const Expr* other) const { return true; }
 TernaryOperator::TernaryOperator(const std::shared_ptr<Expr>& cond,
                                  const std::shared_ptr<Expr>& left,
                                  const std::shared_ptr<Expr>& right, SourceLocation loc)
-    : Expr(EK_TernaryOperator, loc), operands_{cond, left, right} {}
+    : Expr(EK_TernaryOperator, loc), operands_{cond, left, right} {
+  for(const auto& operand : operands_)
+    adopt(operand);
+}
 
 TernaryOperator::TernaryOperator(const TernaryOperator& expr)
     : Expr(EK_TernaryOperator, expr.getSourceLocation()),
-      operands_{expr.getCondition()->clone(), expr.getLeft()->clone(), expr.getRight()->clone()} {}
+      operands_{expr.getCondition()->clone(), expr.getLeft()->clone(), expr.getRight()->clone()} {
+  for(const auto& operand : operands_)
+    adopt(operand);
+}
 
 TernaryOperator& TernaryOperator::operator=(TernaryOperator expr) {
   assign(expr);
   operands_[OK_Cond] = expr.getCondition();
   operands_[OK_Left] = expr.getLeft();
   operands_[OK_Right] = expr.getRight();
+  for(const auto& operand : operands_)
+    adopt(operand);
   return *this;
 }
 
@@ -194,6 +250,8 @@ void TernaryOperator::replaceChildren(const std::shared_ptr<Expr>& oldExpr,
                                       const std::shared_ptr<Expr>& newExpr) {
   bool success = ASTHelper::replaceOperands(oldExpr, newExpr, operands_);
   DAWN_ASSERT_MSG((success), ("Expression not found"));
+  adopt(newExpr);
+  invalidateHash();
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -206,13 +264,15 @@ FunCallExpr::FunCallExpr(const std::string& callee, SourceLocation loc)
 FunCallExpr::FunCallExpr(const FunCallExpr& expr)
     : Expr(EK_FunCallExpr, expr.getSourceLocation()), callee_(expr.getCallee()) {
   for(auto e : expr.getArguments())
-    arguments_.push_back(e->clone());
+    insertArgument(e->clone());
 }
 
 FunCallExpr& FunCallExpr::operator=(FunCallExpr expr) {
   assign(expr);
   callee_ = std::move(expr.getCallee());
   arguments_ = std::move(expr.getArguments());
+  for(const auto& argument : arguments_)
+    adopt(argument);
   return *this;
 }
 
@@ -230,12 +290,24 @@ bool FunCallExpr::equals(const Expr* other) const {
                     });
 }
 
-void FunCallExpr::insertArgument(const std::shared_ptr<Expr>& expr) { arguments_.push_back(expr); }
+std::size_t FunCallExpr::getLocalHash() const {
+  std::size_t seed = Expr::getLocalHash();
+  hash_combine(seed, callee_);
+  return seed;
+}
+
+void FunCallExpr::insertArgument(const std::shared_ptr<Expr>& expr) {
+  arguments_.push_back(expr);
+  adopt(expr);
+  invalidateHash();
+}
 
 void FunCallExpr::replaceChildren(const std::shared_ptr<Expr>& oldExpr,
                                   const std::shared_ptr<Expr>& newExpr) {
   bool success = ASTHelper::replaceOperands(oldExpr, newExpr, arguments_);
   DAWN_ASSERT_MSG((success), ("Expression not found"));
+  adopt(newExpr);
+  invalidateHash();
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -251,13 +323,15 @@ StencilFunCallExpr::StencilFunCallExpr(const StencilFunCallExpr& expr)
     : FunCallExpr(expr.getCallee(), expr.getSourceLocation()) {
   kind_ = EK_StencilFunCallExpr;
   for(auto e : expr.getArguments())
-    arguments_.push_back(e->clone());
+    insertArgument(e->clone());
 }
 
 StencilFunCallExpr& StencilFunCallExpr::operator=(StencilFunCallExpr expr) {
   assign(expr);
   callee_ = std::move(expr.getCallee());
   arguments_ = std::move(expr.getArguments());
+  for(const auto& argument : arguments_)
+    adopt(argument);
   return *this;
 }
 
@@ -310,23 +384,35 @@ bool StencilFunArgExpr::equals(const Expr* other) const {
          offset_ == otherPtr->offset_ && argumentIndex_ == otherPtr->argumentIndex_;
 }
 
+std::size_t StencilFunArgExpr::getLocalHash() const {
+  std::size_t seed = Expr::getLocalHash();
+  hash_combine(seed, dimension_, offset_, argumentIndex_);
+  return seed;
+}
+
 //===------------------------------------------------------------------------------------------===//
 //     VarAccessExpr
 //===------------------------------------------------------------------------------------------===//
 
 VarAccessExpr::VarAccessExpr(const std::string& name, std::shared_ptr<Expr> index,
                              SourceLocation loc)
-    : Expr(EK_VarAccessExpr, loc), name_(name), index_(index), isExternal_(false) {}
+    : Expr(EK_VarAccessExpr, loc), name_(name), index_(index), isExternal_(false) {
+  adopt(index_);
+}
 
 VarAccessExpr::VarAccessExpr(const VarAccessExpr& expr)
     : Expr(EK_VarAccessExpr, expr.getSourceLocation()), name_(expr.getName()),
-      index_(expr.getIndex()), isExternal_(expr.isExternal()) {}
+      index_(expr.isArrayAccess() ? expr.getIndex()->clone() : nullptr),
+      isExternal_(expr.isExternal()) {
+  adopt(index_);
+}
 
 VarAccessExpr& VarAccessExpr::operator=(VarAccessExpr expr) {
   assign(expr);
   name_ = std::move(expr.getName());
   index_ = std::move(expr.getIndex());
   isExternal_ = expr.isExternal();
+  adopt(index_);
   return *this;
 }
 
@@ -343,11 +429,19 @@ bool VarAccessExpr::equals(const Expr* other) const {
          (isArrayAccess() ? index_->equals(otherPtr->index_.get()) : true);
 }
 
+std::size_t VarAccessExpr::getLocalHash() const {
+  std::size_t seed = Expr::getLocalHash();
+  hash_combine(seed, name_, isExternal_, isArrayAccess());
+  return seed;
+}
+
 void VarAccessExpr::replaceChildren(const std::shared_ptr<Expr>& oldExpr,
                                     const std::shared_ptr<Expr>& newExpr) {
   if(isArrayAccess()) {
     DAWN_ASSERT(index_ == oldExpr);
     index_ = newExpr;
+    adopt(index_);
+    invalidateHash();
   } else {
     DAWN_ASSERT_MSG((false), ("Non array vars have no children"));
   }
@@ -384,6 +478,7 @@ void FieldAccessExpr::setPureOffset(const Array3i& offset) {
   offset_ = offset;
   argumentMap_ = Array3i{{-1, -1, -1}};
   argumentOffset_ = Array3i{{0, 0, 0}};
+  invalidateHash();
 }
 
 std::shared_ptr<Expr> FieldAccessExpr::clone() const {
@@ -397,6 +492,12 @@ bool FieldAccessExpr::equals(const Expr* other) const {
          argumentOffset_ == otherPtr->argumentOffset_ && negateOffset_ == otherPtr->negateOffset_;
 }
 
+std::size_t FieldAccessExpr::getLocalHash() const {
+  std::size_t seed = Expr::getLocalHash();
+  hash_combine(seed, name_, offset_, argumentMap_, argumentOffset_, negateOffset_);
+  return seed;
+}
+
 //===------------------------------------------------------------------------------------------===//
 //     LiteralAccessExpr
 //===------------------------------------------------------------------------------------------===//
@@ -428,4 +529,10 @@ bool LiteralAccessExpr::equals(const Expr* other) const {
          builtinType_ == otherPtr->builtinType_;
 }
 
+std::size_t LiteralAccessExpr::getLocalHash() const {
+  std::size_t seed = Expr::getLocalHash();
+  hash_combine(seed, value_, static_cast<int>(builtinType_));
+  return seed;
+}
+
 } // namespace dawn
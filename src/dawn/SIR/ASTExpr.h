@@ -15,6 +15,7 @@
 #ifndef DAWN_SIR_ASTEXPR_H
 #define DAWN_SIR_ASTEXPR_H
 
+#include "dawn/SIR/ASTHash.h"
 #include "dawn/Support/Array.h"
 #include "dawn/Support/ArrayRef.h"
 #include "dawn/Support/SourceLocation.h"
@@ -85,6 +86,25 @@ public:
   virtual bool equals(const Expr* other) const { return kind_ == other->kind_; }
   /// @}
 
+  /// @brief Structural hash of the expression
+  ///
+  /// Expressions which compare equal (see `equals`) have the same hash, the source locations are
+  /// ignored. The hash combines the local hash of the node with the hashes of its children and is
+  /// cached in the nodes until the node or one of its descendants is modified (see
+  /// `ASTHashCache`).
+  std::size_t getHash() const;
+
+  /// @brief Invalidate the cached hash of the expression and of its ancestors
+  ///
+  /// This is only needed after modifying the node through a non-const accessor.
+  void invalidateHash() { hash_.invalidate(); }
+
+  /// @brief Get the cache of the hash of the expression
+  const ASTHashCache& getHashCache() const { return hash_; }
+
+  /// @brief Hash of the kind and the attributes of the node (excluding its children)
+  virtual std::size_t getLocalHash() const;
+
   /// @name Operators
   /// @{
   bool operator==(const Expr& other) const { return other.equals(this); }
@@ -95,11 +115,22 @@ protected:
   void assign(const Expr& other) {
     kind_ = other.kind_;
     loc_ = other.loc_;
+    invalidateHash();
+  }
+
+  /// @brief Link the cached hash of `child` to the one of this node (see `ASTHashCache`)
+  void adopt(const std::shared_ptr<Expr>& child) {
+    if(child)
+      hash_.adopt(child->hash_);
   }
 
 protected:
   ExprKind kind_;
   SourceLocation loc_;
+
+private:
+  friend class Stmt;
+  ASTHashCache hash_;
 };
 
 //===------------------------------------------------------------------------------------------===//
@@ -123,12 +154,17 @@ public:
   virtual ~UnaryOperator();
   /// @}
 
-  void setOperand(const std::shared_ptr<Expr>& operand) { operand_ = operand; }
+  void setOperand(const std::shared_ptr<Expr>& operand) {
+    operand_ = operand;
+    adopt(operand_);
+    invalidateHash();
+  }
   const std::shared_ptr<Expr>& getOperand() const { return operand_; }
   const char* getOp() const { return op_.c_str(); }
 
   virtual std::shared_ptr<Expr> clone() const override;
   virtual bool equals(const Expr* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Expr* expr) { return expr->getKind() == EK_UnaryOperator; }
   virtual ExprRangeType getChildren() override { return ExprRangeType(operand_); }
   virtual void replaceChildren(const std::shared_ptr<Expr>& oldExpr,
@@ -158,11 +194,19 @@ public:
   virtual ~BinaryOperator();
   /// @}
 
-  void setLeft(const std::shared_ptr<Expr>& left) { operands_[OK_Left] = left; }
+  void setLeft(const std::shared_ptr<Expr>& left) {
+    operands_[OK_Left] = left;
+    adopt(left);
+    invalidateHash();
+  }
   const std::shared_ptr<Expr>& getLeft() const { return operands_[OK_Left]; }
   std::shared_ptr<Expr>& getLeft() { return operands_[OK_Left]; }
 
-  void setRight(const std::shared_ptr<Expr>& right) { operands_[OK_Right] = right; }
+  void setRight(const std::shared_ptr<Expr>& right) {
+    operands_[OK_Right] = right;
+    adopt(right);
+    invalidateHash();
+  }
   const std::shared_ptr<Expr>& getRight() const { return operands_[OK_Right]; }
   std::shared_ptr<Expr>& getRight() { return operands_[OK_Right]; }
 
@@ -170,6 +214,7 @@ public:
 
   virtual std::shared_ptr<Expr> clone() const override;
   virtual bool equals(const Expr* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Expr* expr) { return expr->getKind() == EK_BinaryOperator; }
   virtual ExprRangeType getChildren() override { return ExprRangeType(operands_); }
   virtual void replaceChildren(const std::shared_ptr<Expr>& oldExpr,
@@ -244,15 +289,27 @@ public:
   virtual ~TernaryOperator();
   /// @}
 
-  void setCondition(const std::shared_ptr<Expr>& condition) { operands_[OK_Cond] = condition; }
+  void setCondition(const std::shared_ptr<Expr>& condition) {
+    operands_[OK_Cond] = condition;
+    adopt(condition);
+    invalidateHash();
+  }
   const std::shared_ptr<Expr>& getCondition() const { return operands_[OK_Cond]; }
   std::shared_ptr<Expr>& getCondition() { return operands_[OK_Cond]; }
 
-  void setLeft(const std::shared_ptr<Expr>& left) { operands_[OK_Left] = left; }
+  void setLeft(const std::shared_ptr<Expr>& left) {
+    operands_[OK_Left] = left;
+    adopt(left);
+    invalidateHash();
+  }
   const std::shared_ptr<Expr>& getLeft() const { return operands_[OK_Left]; }
   std::shared_ptr<Expr>& getLeft() { return operands_[OK_Left]; }
 
-  void setRight(const std::shared_ptr<Expr>& right) { operands_[OK_Right] = right; }
+  void setRight(const std::shared_ptr<Expr>& right) {
+    operands_[OK_Right] = right;
+    adopt(right);
+    invalidateHash();
+  }
   const std::shared_ptr<Expr>& getRight() const { return operands_[OK_Right]; }
   std::shared_ptr<Expr>& getRight() { return operands_[OK_Right]; }
 
@@ -294,7 +351,10 @@ public:
   std::vector<std::shared_ptr<Expr>>& getArguments() { return arguments_; }
   const std::vector<std::shared_ptr<Expr>>& getArguments() const { return arguments_; }
 
-  void setCallee(std::string name) { callee_ = name; }
+  void setCallee(std::string name) {
+    callee_ = name;
+    invalidateHash();
+  }
 
   void insertArgument(const std::shared_ptr<Expr>& expr);
 
@@ -307,6 +367,7 @@ public:
 
   virtual std::shared_ptr<Expr> clone() const override;
   virtual bool equals(const Expr* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Expr* expr) { return expr->getKind() == EK_FunCallExpr; }
   virtual ExprRangeType getChildren() override { return ExprRangeType(arguments_); }
   virtual void replaceChildren(const std::shared_ptr<Expr>& oldExpr,
@@ -374,6 +435,7 @@ public:
 
   virtual std::shared_ptr<Expr> clone() const override;
   virtual bool equals(const Expr* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Expr* expr) { return expr->getKind() == EK_StencilFunArgExpr; }
   ACCEPTVISITOR(Expr, StencilFunArgExpr)
 };
@@ -402,7 +464,10 @@ public:
   const std::string& getName() const { return name_; }
   std::string& getName() { return name_; }
 
-  void setIsExternal(bool external) { isExternal_ = external; }
+  void setIsExternal(bool external) {
+    isExternal_ = external;
+    invalidateHash();
+  }
 
   /// @brief Is the variable externally defined (e.g access to a global)?
   bool isExternal() const { return isExternal_; }
@@ -413,10 +478,15 @@ public:
   /// @brief Is it an array access (i.e var[i])?
   bool isArrayAccess() const { return index_ != nullptr; }
   const std::shared_ptr<Expr>& getIndex() const { return index_; }
-  void setIndex(const std::shared_ptr<Expr>& index) { index_ = index; }
+  void setIndex(const std::shared_ptr<Expr>& index) {
+    index_ = index;
+    adopt(index_);
+    invalidateHash();
+  }
 
   virtual std::shared_ptr<Expr> clone() const override;
   virtual bool equals(const Expr* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Expr* expr) { return expr->getKind() == EK_VarAccessExpr; }
   virtual ExprRangeType getChildren() override {
     return (isArrayAccess() ? ExprRangeType(index_) : ExprRangeType());
@@ -505,12 +575,19 @@ public:
 
   bool negateOffset() const { return negateOffset_; }
 
-  void setArgumentMap(Array3i const& argMap) { argumentMap_ = argMap; }
+  void setArgumentMap(Array3i const& argMap) {
+    argumentMap_ = argMap;
+    invalidateHash();
+  }
 
-  void setArgumentOffset(Array3i const& argOffset) { argumentOffset_ = argOffset; }
+  void setArgumentOffset(Array3i const& argOffset) {
+    argumentOffset_ = argOffset;
+    invalidateHash();
+  }
 
   virtual std::shared_ptr<Expr> clone() const override;
   virtual bool equals(const Expr* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Expr* expr) { return expr->getKind() == EK_FieldAccessExpr; }
   ACCEPTVISITOR(Expr, FieldAccessExpr)
 };
@@ -543,6 +620,7 @@ public:
 
   virtual std::shared_ptr<Expr> clone() const override;
   virtual bool equals(const Expr* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Expr* expr) { return expr->getKind() == EK_LiteralAccessExpr; }
   ACCEPTVISITOR(Expr, LiteralAccessExpr)
 };
@@ -0,0 +1,105 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_SIR_ASTHASH_H
+#define DAWN_SIR_ASTHASH_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace dawn {
+
+/// @brief Cached structural hash of an AST node (see `Expr::getHash` and `Stmt::getHash`)
+///
+/// Each node caches its hash along with a flag telling whether the hash is still valid. The
+/// mutators of a node (the setters, `replaceChildren`, the assignment operators, ...) clear the
+/// flag of the node and of all its ancestors, the next `getHash` only rehashes these nodes. The
+/// ancestors are reached through a link from each child to its parent, which is established
+/// whenever a node adopts a child (construction, setters and `replaceChildren`). The link does not
+/// own the parent and is reset if the parent is destroyed before its children.
+///
+/// Modifications through the non-const accessors (which return references to the members of a
+/// node) are not tracked, use the mutators or call `invalidateHash` afterwards. The same applies
+/// to the SIR structures referenced by the stencil description statements (vertical regions and
+/// stencil calls). Nodes shared by several parents (see `ExprHashConsTable`) must not be modified,
+/// only the parent which adopted them last is invalidated.
+///
+/// Computing a hash only stores to atomics, hence the hashes of an AST can be computed
+/// concurrently by several threads as long as none of them modifies the AST.
+/// @ingroup sir
+class ASTHashCache {
+  /// @brief Link from the children of a node to the node
+  struct ParentLink {
+    ASTHashCache* Parent;
+  };
+
+  mutable std::atomic<std::size_t> hash_;
+  mutable std::atomic<bool> isValid_;
+
+  /// Link handed to the children (created when the first child is adopted)
+  std::shared_ptr<ParentLink> link_;
+
+  /// Link to the parent (or NULL)
+  std::shared_ptr<ParentLink> parentLink_;
+
+public:
+  ASTHashCache() : hash_(0), isValid_(false) {}
+
+  /// @brief Copies of a node neither share the cached hash nor the links of the node
+  ASTHashCache(const ASTHashCache&) : ASTHashCache() {}
+  ASTHashCache& operator=(const ASTHashCache&) {
+    invalidate();
+    return *this;
+  }
+
+  ~ASTHashCache() {
+    if(link_)
+      link_->Parent = nullptr;
+  }
+
+  /// @brief Link the cache of the child `child` to this cache
+  void adopt(ASTHashCache& child) {
+    if(!link_)
+      link_ = std::make_shared<ParentLink>(ParentLink{this});
+    child.parentLink_ = link_;
+  }
+
+  /// @brief Invalidate the cached hash and the cached hashes of all ancestors
+  void invalidate() {
+    for(ASTHashCache* cache = this; cache != nullptr;
+        cache = cache->parentLink_ ? cache->parentLink_->Parent : nullptr)
+      cache->isValid_.store(false, std::memory_order_release);
+  }
+
+  /// @brief Check if the cached hash is valid
+  bool isValid() const { return isValid_.load(std::memory_order_acquire); }
+
+  /// @brief Get the cached hash or compute (and cache) it with `compute()`
+  template <class ComputeFunctionType>
+  std::size_t get(ComputeFunctionType&& compute) const {
+    if(isValid_.load(std::memory_order_acquire))
+      return hash_.load(std::memory_order_relaxed);
+
+    // Threads computing the hash concurrently store the same value
+    std::size_t hash = compute();
+    hash_.store(hash, std::memory_order_relaxed);
+    isValid_.store(true, std::memory_order_release);
+    return hash;
+  }
+};
+
+} // namespace dawn
+
+#endif
@@ -0,0 +1,99 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/SIR/ASTHashConsing.h"
+#include "dawn/SIR/AST.h"
+#include "dawn/SIR/ASTUtil.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/Support/Casting.h"
+#include "dawn/Support/HashCombine.h"
+
+namespace dawn {
+
+ExprHashConsTable::ExprHashConsTable() : numEntries_(0), numShared_(0) {}
+
+std::shared_ptr<Expr> ExprHashConsTable::internImpl(const std::shared_ptr<Expr>& expr,
+                                                    std::size_t& hash, bool& isPure) {
+  // The hash is computed along with the interning as replacing the children invalidates the cached
+  // hash of the node (the replacements are structurally equal, hence the hash does not change)
+  isPure = isPureNode(expr.get());
+  hash = expr->getLocalHash();
+
+  auto childrenRange = expr->getChildren();
+  std::vector<std::shared_ptr<Expr>> children(childrenRange.begin(), childrenRange.end());
+  for(const auto& child : children) {
+    std::size_t childHash;
+    bool childIsPure;
+    std::shared_ptr<Expr> internedChild = internImpl(child, childHash, childIsPure);
+    if(internedChild != child)
+      expr->replaceChildren(child, internedChild);
+    hash_combine(hash, childHash);
+    isPure &= childIsPure;
+  }
+
+  if(!isPure)
+    return expr;
+
+  std::vector<std::shared_ptr<Expr>>& bucket = table_[hash];
+  for(const auto& interned : bucket) {
+    if(interned == expr)
+      return expr;
+    if(interned->equals(expr.get())) {
+      numShared_++;
+      return interned;
+    }
+  }
+  bucket.push_back(expr);
+  numEntries_++;
+  return expr;
+}
+
+std::shared_ptr<Expr> ExprHashConsTable::intern(const std::shared_ptr<Expr>& expr) {
+  std::size_t hash;
+  bool isPure;
+  return internImpl(expr, hash, isPure);
+}
+
+void ExprHashConsTable::intern(const std::shared_ptr<Stmt>& stmt) {
+  if(ExprStmt* exprStmt = dyn_cast<ExprStmt>(stmt.get())) {
+    std::shared_ptr<Expr> expr = intern(exprStmt->getExpr());
+    if(expr != exprStmt->getExpr())
+      exprStmt->setExpr(expr);
+  } else if(ReturnStmt* returnStmt = dyn_cast<ReturnStmt>(stmt.get())) {
+    std::shared_ptr<Expr> expr = intern(returnStmt->getExpr());
+    if(expr != returnStmt->getExpr())
+      returnStmt->setExpr(expr);
+  } else if(VarDeclStmt* varDecl = dyn_cast<VarDeclStmt>(stmt.get())) {
+    for(auto init : varDecl->getInitList()) {
+      std::shared_ptr<Expr> expr = intern(init);
+      if(expr != init)
+        varDecl->replaceChildren(init, expr);
+    }
+  } else if(VerticalRegionDeclStmt* verticalRegion = dyn_cast<VerticalRegionDeclStmt>(stmt.get())) {
+    intern(*verticalRegion->getVerticalRegion()->Ast);
+  }
+
+  for(const auto& child : stmt->getChildren())
+    intern(child);
+}
+
+void ExprHashConsTable::intern(const AST& ast) { intern(ast.getRoot()); }
+
+void ExprHashConsTable::clear() {
+  table_.clear();
+  numEntries_ = 0;
+  numShared_ = 0;
+}
+
+} // namespace dawn
@@ -0,0 +1,89 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_SIR_ASTHASHCONSING_H
+#define DAWN_SIR_ASTHASHCONSING_H
+
+#include "dawn/SIR/ASTFwd.h"
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace dawn {
+
+/// @brief Hash-consing of side-effect free expressions
+///
+/// Interning an expression replaces all its side-effect free subexpressions by the structurally
+/// equal node which was interned first, i.e identical subexpressions (of the same or of different
+/// ASTs) share their storage. Expressions with side effects (assignments, increments and
+/// decrements) are never shared, but their pure subexpressions are. Calls to stencil functions and
+/// accesses of their arguments are not shared either, as the optimizer keeps one instantiation per
+/// call (see `isPureNode`).
+///
+/// Shared nodes must not be modified in place (replace them in their parents instead). The
+/// optimizer maps each node to an AccessID and requires the nodes to be unique, hence hash-consed
+/// ASTs have to be cloned before they are passed to the optimizer (cloning unshares all nodes).
+///
+/// @code
+///   ExprHashConsTable table;
+///   for(const auto& stencilFunction : sir->StencilFunctions)
+///     for(const auto& ast : stencilFunction->Asts)
+///       table.intern(*ast);
+/// @endcode
+/// @ingroup sir
+class ExprHashConsTable {
+  /// Interned expressions by their structural hash
+  std::unordered_map<std::size_t, std::vector<std::shared_ptr<Expr>>> table_;
+
+  std::size_t numEntries_;
+  std::size_t numShared_;
+
+public:
+  ExprHashConsTable();
+
+  /// @brief Intern `expr` and all its subexpressions
+  ///
+  /// The subexpressions of `expr` are replaced in place by their interned nodes.
+  /// @returns the interned node of `expr` (`expr` itself if it has side effects or if it is the
+  /// first structurally equal expression interned)
+  std::shared_ptr<Expr> intern(const std::shared_ptr<Expr>& expr);
+
+  /// @brief Intern all expressions of `stmt` (including the ASTs of vertical regions)
+  void intern(const std::shared_ptr<Stmt>& stmt);
+
+  /// @brief Intern all expressions of `ast`
+  void intern(const AST& ast);
+
+  /// @brief Number of distinct interned expressions
+  std::size_t size() const { return numEntries_; }
+
+  /// @brief Number of expressions which were replaced by a previously interned node
+  std::size_t getNumShared() const { return numShared_; }
+
+  /// @brief Remove all interned expressions
+  void clear();
+
+private:
+  /// @brief Intern `expr` and compute its structural hash
+  ///
+  /// @param hash   Structural hash of `expr` (see `Expr::getHash`)
+  /// @param isPure Set to `true` if `expr` is free of side effects
+  std::shared_ptr<Expr> internImpl(const std::shared_ptr<Expr>& expr, std::size_t& hash,
+                                   bool& isPure);
+};
+
+} // namespace dawn
+
+#endif
@@ -0,0 +1,206 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_SIR_ASTKINDVISITOR_H
+#define DAWN_SIR_ASTKINDVISITOR_H
+
+#include "dawn/SIR/AST.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/Support/Unreachable.h"
+#include <memory>
+
+namespace dawn {
+
+/// @brief Visitor of ASTs and ASTNodes dispatching on the kind of the nodes
+///
+/// In contrast to the `ASTVisitor`, which requires two virtual calls per node and passes freshly
+/// created `shared_ptr`s of the dynamic type of the node (i.e `shared_from_this()`), the dispatch
+/// is a switch over `getKind()` and the handlers of `Derived` (CRTP) receive a reference to the
+/// node together with the `shared_ptr` owning it in the AST. The latter can be used as key of the
+/// `Expr`/`Stmt` maps of the optimizer (e.g the AccessIDs) without copying it.
+///
+/// The handlers of `Derived` hide the default handlers which forward to the children, e.g:
+///
+/// @code
+///   class FieldCounter : public ASTKindVisitor<FieldCounter> {
+///   public:
+///     int NumFields = 0;
+///
+///     void visitFieldAccessExpr(const FieldAccessExpr& expr, const std::shared_ptr<Expr>& node) {
+///       NumFields++;
+///     }
+///   };
+///
+///   FieldCounter counter;
+///   counter.visit(ast);
+/// @endcode
+///
+/// The children are accessed through the const accessors of the nodes. Handlers which modify the
+/// AST have to do so via the setters or `replaceChildren` of the nodes, which invalidate the cached
+/// hashes (see `ASTHashCache`).
+/// @ingroup sir
+template <class Derived>
+class ASTKindVisitor {
+public:
+  /// @brief Visit the root of `ast`
+  void visit(const AST& ast) {
+    std::shared_ptr<Stmt> root = ast.getRoot();
+    visit(root);
+  }
+
+  /// @brief Dispatch `stmt` to the handler of its kind
+  void visit(const std::shared_ptr<Stmt>& stmt) {
+    switch(stmt->getKind()) {
+    case Stmt::SK_BlockStmt:
+      return derived().visitBlockStmt(static_cast<const BlockStmt&>(*stmt), stmt);
+    case Stmt::SK_ExprStmt:
+      return derived().visitExprStmt(static_cast<const ExprStmt&>(*stmt), stmt);
+    case Stmt::SK_ReturnStmt:
+      return derived().visitReturnStmt(static_cast<const ReturnStmt&>(*stmt), stmt);
+    case Stmt::SK_VarDeclStmt:
+      return derived().visitVarDeclStmt(static_cast<const VarDeclStmt&>(*stmt), stmt);
+    case Stmt::SK_StencilCallDeclStmt:
+      return derived().visitStencilCallDeclStmt(static_cast<const StencilCallDeclStmt&>(*stmt),
+                                                stmt);
+    case Stmt::SK_VerticalRegionDeclStmt:
+      return derived().visitVerticalRegionDeclStmt(
+          static_cast<const VerticalRegionDeclStmt&>(*stmt), stmt);
+    case Stmt::SK_BoundaryConditionDeclStmt:
+      return derived().visitBoundaryConditionDeclStmt(
+          static_cast<const BoundaryConditionDeclStmt&>(*stmt), stmt);
+    case Stmt::SK_IfStmt:
+      return derived().visitIfStmt(static_cast<const IfStmt&>(*stmt), stmt);
+    }
+    dawn_unreachable("invalid statement kind");
+  }
+
+  /// @brief Dispatch `expr` to the handler of its kind (`NOPExpr`s are skipped)
+  void visit(const std::shared_ptr<Expr>& expr) {
+    switch(expr->getKind()) {
+    case Expr::EK_UnaryOperator:
+      return derived().visitUnaryOperator(static_cast<const UnaryOperator&>(*expr), expr);
+    case Expr::EK_BinaryOperator:
+      return derived().visitBinaryOperator(static_cast<const BinaryOperator&>(*expr), expr);
+    case Expr::EK_AssignmentExpr:
+      return derived().visitAssignmentExpr(static_cast<const AssignmentExpr&>(*expr), expr);
+    case Expr::EK_TernaryOperator:
+      return derived().visitTernaryOperator(static_cast<const TernaryOperator&>(*expr), expr);
+    case Expr::EK_FunCallExpr:
+      return derived().visitFunCallExpr(static_cast<const FunCallExpr&>(*expr), expr);
+    case Expr::EK_StencilFunCallExpr:
+      return derived().visitStencilFunCallExpr(static_cast<const StencilFunCallExpr&>(*expr),
+                                               expr);
+    case Expr::EK_StencilFunArgExpr:
+      return derived().visitStencilFunArgExpr(static_cast<const StencilFunArgExpr&>(*expr), expr);
+    case Expr::EK_VarAccessExpr:
+      return derived().visitVarAccessExpr(static_cast<const VarAccessExpr&>(*expr), expr);
+    case Expr::EK_FieldAccessExpr:
+      return derived().visitFieldAccessExpr(static_cast<const FieldAccessExpr&>(*expr), expr);
+    case Expr::EK_LiteralAccessExpr:
+      return derived().visitLiteralAccessExpr(static_cast<const LiteralAccessExpr&>(*expr), expr);
+    case Expr::EK_NOPExpr:
+      return;
+    }
+    dawn_unreachable("invalid expression kind");
+  }
+
+  /// @name Statements (the default handlers forward to the children)
+  /// @{
+  void visitBlockStmt(const BlockStmt& stmt, const std::shared_ptr<Stmt>&) {
+    for(const auto& s : stmt.getStatements())
+      derived().visit(s);
+  }
+
+  void visitExprStmt(const ExprStmt& stmt, const std::shared_ptr<Stmt>&) {
+    derived().visit(stmt.getExpr());
+  }
+
+  void visitReturnStmt(const ReturnStmt& stmt, const std::shared_ptr<Stmt>&) {
+    derived().visit(stmt.getExpr());
+  }
+
+  void visitVarDeclStmt(const VarDeclStmt& stmt, const std::shared_ptr<Stmt>&) {
+    for(const auto& expr : stmt.getInitList())
+      derived().visit(expr);
+  }
+
+  void visitVerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt,
+                                   const std::shared_ptr<Stmt>&) {
+    derived().visit(*stmt.getVerticalRegion()->Ast);
+  }
+
+  void visitStencilCallDeclStmt(const StencilCallDeclStmt&, const std::shared_ptr<Stmt>&) {}
+
+  void visitBoundaryConditionDeclStmt(const BoundaryConditionDeclStmt&,
+                                      const std::shared_ptr<Stmt>&) {}
+
+  void visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>&) {
+    derived().visit(stmt.getCondStmt());
+    derived().visit(stmt.getThenStmt());
+    if(stmt.hasElse())
+      derived().visit(stmt.getElseStmt());
+  }
+  /// @}
+
+  /// @name Expressions (the default handlers forward to the children)
+  /// @{
+  void visitUnaryOperator(const UnaryOperator& expr, const std::shared_ptr<Expr>&) {
+    derived().visit(expr.getOperand());
+  }
+
+  void visitBinaryOperator(const BinaryOperator& expr, const std::shared_ptr<Expr>&) {
+    derived().visit(expr.getLeft());
+    derived().visit(expr.getRight());
+  }
+
+  void visitAssignmentExpr(const AssignmentExpr& expr, const std::shared_ptr<Expr>&) {
+    derived().visit(expr.getLeft());
+    derived().visit(expr.getRight());
+  }
+
+  void visitTernaryOperator(const TernaryOperator& expr, const std::shared_ptr<Expr>&) {
+    derived().visit(expr.getCondition());
+    derived().visit(expr.getLeft());
+    derived().visit(expr.getRight());
+  }
+
+  void visitFunCallExpr(const FunCallExpr& expr, const std::shared_ptr<Expr>&) {
+    for(const auto& arg : expr.getArguments())
+      derived().visit(arg);
+  }
+
+  void visitStencilFunCallExpr(const StencilFunCallExpr& expr, const std::shared_ptr<Expr>&) {
+    for(const auto& arg : expr.getArguments())
+      derived().visit(arg);
+  }
+
+  void visitStencilFunArgExpr(const StencilFunArgExpr&, const std::shared_ptr<Expr>&) {}
+
+  void visitVarAccessExpr(const VarAccessExpr& expr, const std::shared_ptr<Expr>&) {
+    if(expr.isArrayAccess())
+      derived().visit(expr.getIndex());
+  }
+
+  void visitFieldAccessExpr(const FieldAccessExpr&, const std::shared_ptr<Expr>&) {}
+
+  void visitLiteralAccessExpr(const LiteralAccessExpr&, const std::shared_ptr<Expr>&) {}
+  /// @}
+
+protected:
+  Derived& derived() { return *static_cast<Derived*>(this); }
+};
+
+} // namespace dawn
+
+#endif
@@ -19,25 +19,52 @@
 #include "dawn/SIR/SIR.h"
 #include "dawn/Support/Assert.h"
 #include "dawn/Support/Casting.h"
+#include "dawn/Support/HashCombine.h"
 
 namespace dawn {
 
+//===------------------------------------------------------------------------------------------===//
+//     Stmt
+//===------------------------------------------------------------------------------------------===//
+
+std::size_t Stmt::getHash() const {
+  return hash_.get([this]() {
+    std::size_t seed = getLocalHash();
+    // `getChildren` does not modify the node, it is merely not declared const
+    for(const auto& child : const_cast<Stmt*>(this)->getChildren())
+      hash_combine(seed, child->getHash());
+    return seed;
+  });
+}
+
+std::size_t Stmt::getLocalHash() const { return std::hash<int>()(static_cast<int>(kind_)); }
+
+void Stmt::adopt(const std::shared_ptr<Expr>& child) {
+  if(child)
+    hash_.adopt(child->hash_);
+}
+
 //===------------------------------------------------------------------------------------------===//
 //     BlockStmt
 //===------------------------------------------------------------------------------------------===//
 
 BlockStmt::BlockStmt(SourceLocation loc) : Stmt(SK_BlockStmt, loc) {}
 BlockStmt::BlockStmt(const std::vector<std::shared_ptr<Stmt>>& statements, SourceLocation loc)
-    : Stmt(SK_BlockStmt, loc), statements_(statements) {}
+    : Stmt(SK_BlockStmt, loc), statements_(statements) {
+  for(const auto& stmt : statements_)
+    adopt(stmt);
+}
 
 BlockStmt::BlockStmt(const BlockStmt& stmt) : Stmt(SK_BlockStmt, stmt.getSourceLocation()) {
   for(auto s : stmt.getStatements())
-    statements_.push_back(s->clone());
+    push_back(s->clone());
 }
 
 BlockStmt& BlockStmt::operator=(BlockStmt const& stmt) {
   assign(stmt);
   statements_ = std::move(stmt.statements_);
+  for(const auto& s : statements_)
+    adopt(s);
   return *this;
 }
 
@@ -58,6 +85,8 @@ void BlockStmt::replaceChildren(std::shared_ptr<Stmt> const& oldStmt,
                                 std::shared_ptr<Stmt> const& newStmt) {
   bool success = ASTHelper::replaceOperands(oldStmt, newStmt, statements_);
   DAWN_ASSERT_MSG((success), ("Expression not found"));
+  adopt(newStmt);
+  invalidateHash();
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -65,14 +94,19 @@ void BlockStmt::replaceChildren(std::shared_ptr<Stmt> const& oldStmt,
 //===------------------------------------------------------------------------------------------===//
 
 ExprStmt::ExprStmt(const std::shared_ptr<Expr>& expr, SourceLocation loc)
-    : Stmt(SK_ExprStmt, loc), expr_(expr) {}
+    : Stmt(SK_ExprStmt, loc), expr_(expr) {
+  adopt(expr_);
+}
 
 ExprStmt::ExprStmt(const ExprStmt& stmt)
-    : Stmt(SK_ExprStmt, stmt.getSourceLocation()), expr_(stmt.getExpr()->clone()) {}
+    : Stmt(SK_ExprStmt, stmt.getSourceLocation()), expr_(stmt.getExpr()->clone()) {
+  adopt(expr_);
+}
 
 ExprStmt& ExprStmt::operator=(ExprStmt stmt) {
   assign(stmt);
   expr_ = stmt.getExpr();
+  adopt(expr_);
   return *this;
 }
 
@@ -85,11 +119,19 @@ bool ExprStmt::equals(const Stmt* other) const {
   return otherPtr && Stmt::equals(other) && expr_->equals(otherPtr->expr_.get());
 }
 
+std::size_t ExprStmt::getLocalHash() const {
+  std::size_t seed = Stmt::getLocalHash();
+  hash_combine(seed, expr_->getHash());
+  return seed;
+}
+
 void ExprStmt::replaceChildren(std::shared_ptr<Expr> const& oldExpr,
                                std::shared_ptr<Expr> const& newExpr) {
   DAWN_ASSERT_MSG((oldExpr == expr_ && oldExpr && newExpr), ("Expression not found"));
 
   expr_ = newExpr;
+  adopt(expr_);
+  invalidateHash();
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -97,14 +139,19 @@ void ExprStmt::replaceChildren(std::shared_ptr<Expr> const& oldExpr,
 //===------------------------------------------------------------------------------------------===//
 
 ReturnStmt::ReturnStmt(const std::shared_ptr<Expr>& expr, SourceLocation loc)
-    : Stmt(SK_ReturnStmt, loc), expr_(expr) {}
+    : Stmt(SK_ReturnStmt, loc), expr_(expr) {
+  adopt(expr_);
+}
 
 ReturnStmt::ReturnStmt(const ReturnStmt& stmt)
-    : Stmt(SK_ReturnStmt, stmt.getSourceLocation()), expr_(stmt.getExpr()->clone()) {}
+    : Stmt(SK_ReturnStmt, stmt.getSourceLocation()), expr_(stmt.getExpr()->clone()) {
+  adopt(expr_);
+}
 
 ReturnStmt& ReturnStmt::operator=(ReturnStmt stmt) {
   assign(stmt);
   expr_ = stmt.getExpr();
+  adopt(expr_);
   return *this;
 }
 
@@ -117,10 +164,18 @@ bool ReturnStmt::equals(const Stmt* other) const {
   return otherPtr && Stmt::equals(other) && expr_->equals(otherPtr->expr_.get());
 }
 
+std::size_t ReturnStmt::getLocalHash() const {
+  std::size_t seed = Stmt::getLocalHash();
+  hash_combine(seed, expr_->getHash());
+  return seed;
+}
+
 void ReturnStmt::replaceChildren(std::shared_ptr<Expr> const& oldExpr,
                                  std::shared_ptr<Expr> const& newExpr) {
   DAWN_ASSERT_MSG((oldExpr == expr_), ("Expression not found"));
   expr_ = newExpr;
+  adopt(expr_);
+  invalidateHash();
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -130,13 +185,18 @@ void ReturnStmt::replaceChildren(std::shared_ptr<Expr> const& oldExpr,
 VarDeclStmt::VarDeclStmt(const Type& type, const std::string& name, int dimension, const char* op,
                          std::vector<std::shared_ptr<Expr>> initList, SourceLocation loc)
     : Stmt(SK_VarDeclStmt, loc), type_(type), name_(name), dimension_(dimension), op_(op),
-      initList_(std::move(initList)) {}
+      initList_(std::move(initList)) {
+  for(const auto& expr : initList_)
+    adopt(expr);
+}
 
 VarDeclStmt::VarDeclStmt(const VarDeclStmt& stmt)
     : Stmt(SK_VarDeclStmt, stmt.getSourceLocation()), type_(stmt.getType()), name_(stmt.getName()),
       dimension_(stmt.getDimension()), op_(stmt.getOp()) {
-  for(const auto& expr : stmt.getInitList())
+  for(const auto& expr : stmt.getInitList()) {
     initList_.push_back(expr->clone());
+    adopt(initList_.back());
+  }
 }
 
 VarDeclStmt& VarDeclStmt::operator=(VarDeclStmt stmt) {
@@ -146,6 +206,8 @@ VarDeclStmt& VarDeclStmt::operator=(VarDeclStmt stmt) {
   dimension_ = stmt.getDimension();
   op_ = stmt.getOp();
   initList_ = std::move(stmt.getInitList());
+  for(const auto& expr : initList_)
+    adopt(expr);
   return *this;
 }
 
@@ -164,10 +226,21 @@ bool VarDeclStmt::equals(const Stmt* other) const {
                     });
 }
 
+std::size_t VarDeclStmt::getLocalHash() const {
+  std::size_t seed = Stmt::getLocalHash();
+  hash_combine(seed, type_.getName(), static_cast<int>(type_.getBuiltinTypeID()),
+               static_cast<int>(type_.getCVQualifier()), name_, dimension_, op_);
+  for(const auto& expr : initList_)
+    hash_combine(seed, expr->getHash());
+  return seed;
+}
+
 void VarDeclStmt::replaceChildren(std::shared_ptr<Expr> const& oldExpr,
                                   std::shared_ptr<Expr> const& newExpr) {
   bool success = ASTHelper::replaceOperands(oldExpr, newExpr, initList_);
   DAWN_ASSERT_MSG((success), ("Expression not found"));
+  adopt(newExpr);
+  invalidateHash();
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -176,15 +249,20 @@ void VarDeclStmt::replaceChildren(std::shared_ptr<Expr> const& oldExpr,
 
 VerticalRegionDeclStmt::VerticalRegionDeclStmt(
     const std::shared_ptr<sir::VerticalRegion>& verticalRegion, SourceLocation loc)
-    : Stmt(SK_VerticalRegionDeclStmt, loc), verticalRegion_(verticalRegion) {}
+    : Stmt(SK_VerticalRegionDeclStmt, loc), verticalRegion_(verticalRegion) {
+  adopt(verticalRegion_->Ast->getRoot());
+}
 
 VerticalRegionDeclStmt::VerticalRegionDeclStmt(const VerticalRegionDeclStmt& stmt)
     : Stmt(SK_VerticalRegionDeclStmt, stmt.getSourceLocation()),
-      verticalRegion_(stmt.getVerticalRegion()->clone()) {}
+      verticalRegion_(stmt.getVerticalRegion()->clone()) {
+  adopt(verticalRegion_->Ast->getRoot());
+}
 
 VerticalRegionDeclStmt& VerticalRegionDeclStmt::operator=(VerticalRegionDeclStmt stmt) {
   assign(stmt);
   verticalRegion_ = std::move(stmt.getVerticalRegion());
+  adopt(verticalRegion_->Ast->getRoot());
   return *this;
 }
 
@@ -200,6 +278,15 @@ bool VerticalRegionDeclStmt::equals(const Stmt* other) const {
          *(verticalRegion_.get()) == *(otherPtr->verticalRegion_.get());
 }
 
+std::size_t VerticalRegionDeclStmt::getLocalHash() const {
+  std::size_t seed = Stmt::getLocalHash();
+  const sir::Interval& interval = *verticalRegion_->VerticalInterval;
+  hash_combine(seed, verticalRegion_->Ast->getHash(), interval.LowerLevel,
+               interval.UpperLevel, interval.LowerOffset, interval.UpperOffset,
+               static_cast<int>(verticalRegion_->LoopOrder));
+  return seed;
+}
+
 //===------------------------------------------------------------------------------------------===//
 //     StencilCallDeclStmt
 //===------------------------------------------------------------------------------------------===//
@@ -230,6 +317,14 @@ bool StencilCallDeclStmt::equals(const Stmt* other) const {
   return otherPtr && Stmt::equals(other) && stencilCall_ == otherPtr->stencilCall_;
 }
 
+std::size_t StencilCallDeclStmt::getLocalHash() const {
+  std::size_t seed = Stmt::getLocalHash();
+  hash_combine(seed, stencilCall_->Callee);
+  for(const auto& field : stencilCall_->Args)
+    hash_combine(seed, field->Name);
+  return seed;
+}
+
 //===------------------------------------------------------------------------------------------===//
 //     BoundaryConditionDeclStmt
 //===------------------------------------------------------------------------------------------===//
@@ -264,24 +359,40 @@ bool BoundaryConditionDeclStmt::equals(const Stmt* other) const {
                     });
 }
 
+std::size_t BoundaryConditionDeclStmt::getLocalHash() const {
+  std::size_t seed = Stmt::getLocalHash();
+  hash_combine(seed, functor_);
+  for(const auto& field : fields_)
+    hash_combine(seed, field->Name, field->IsTemporary);
+  return seed;
+}
+
 //===------------------------------------------------------------------------------------------===//
 //     IfStmt
 //===------------------------------------------------------------------------------------------===//
 
 IfStmt::IfStmt(const std::shared_ptr<Stmt>& condStmt, const std::shared_ptr<Stmt>& thenStmt,
                const std::shared_ptr<Stmt>& elseStmt, SourceLocation loc)
-    : Stmt(SK_IfStmt, loc), subStmts_{condStmt, thenStmt, elseStmt} {}
+    : Stmt(SK_IfStmt, loc), subStmts_{condStmt, thenStmt, elseStmt} {
+  for(const auto& stmt : subStmts_)
+    adopt(stmt);
+}
 
 IfStmt::IfStmt(const IfStmt& stmt)
     : Stmt(SK_IfStmt, stmt.getSourceLocation()),
       subStmts_{stmt.getCondStmt()->clone(), stmt.getThenStmt()->clone(),
-                stmt.hasElse() ? stmt.getElseStmt()->clone() : nullptr} {}
+                stmt.hasElse() ? stmt.getElseStmt()->clone() : nullptr} {
+  for(const auto& s : subStmts_)
+    adopt(s);
+}
 
 IfStmt& IfStmt::operator=(IfStmt stmt) {
   assign(stmt);
   subStmts_[OK_Cond] = std::move(stmt.getCondStmt());
   subStmts_[OK_Then] = std::move(stmt.getThenStmt());
   subStmts_[OK_Else] = std::move(stmt.getElseStmt());
+  for(const auto& s : subStmts_)
+    adopt(s);
   return *this;
 }
 
@@ -302,6 +413,8 @@ bool IfStmt::equals(const Stmt* other) const {
 }
 void IfStmt::replaceChildren(std::shared_ptr<Stmt> const& oldStmt,
                              std::shared_ptr<Stmt> const& newStmt) {
+  adopt(newStmt);
+  invalidateHash();
   if(hasElse()) {
     for(std::shared_ptr<Stmt>& stmt : subStmts_) {
       if(stmt == oldStmt)
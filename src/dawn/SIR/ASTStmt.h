@@ -15,6 +15,7 @@
 #ifndef DAWN_SIR_ASTSTMT_H
 #define DAWN_SIR_ASTSTMT_H
 
+#include "dawn/SIR/ASTHash.h"
 #include "dawn/Support/ArrayRef.h"
 #include "dawn/Support/Casting.h"
 #include "dawn/Support/SourceLocation.h"
@@ -81,6 +82,27 @@ public:
   /// @brief Compare for equality
   virtual bool equals(const Stmt* other) const { return kind_ == other->kind_; }
 
+  /// @brief Structural hash of the statement
+  ///
+  /// Statements which compare equal (see `equals`) have the same hash, the source locations are
+  /// ignored. The hash combines the local hash of the node with the hashes of its child statements
+  /// and is cached in the nodes until the node or one of its descendants is modified (see
+  /// `ASTHashCache`).
+  std::size_t getHash() const;
+
+  /// @brief Invalidate the cached hash of the statement and of its ancestors
+  ///
+  /// This is only needed after modifying the node through a non-const accessor or after modifying
+  /// the vertical region or stencil call of a stencil description statement.
+  void invalidateHash() { hash_.invalidate(); }
+
+  /// @brief Get the cache of the hash of the statement
+  const ASTHashCache& getHashCache() const { return hash_; }
+
+  /// @brief Hash of the kind, the attributes and the expressions of the node (excluding its child
+  /// statements)
+  virtual std::size_t getLocalHash() const;
+
   /// @brief Is the statement used for stencil description and has no real analogon in C++
   /// (e.g a VerticalRegion or StencilCall)?
   virtual bool isStencilDesc() const { return false; }
@@ -95,11 +117,24 @@ protected:
   void assign(const Stmt& other) {
     kind_ = other.kind_;
     loc_ = other.loc_;
+    invalidateHash();
+  }
+
+  /// @brief Link the cached hash of `child` to the one of this node (see `ASTHashCache`)
+  /// @{
+  void adopt(const std::shared_ptr<Stmt>& child) {
+    if(child)
+      hash_.adopt(child->hash_);
   }
+  void adopt(const std::shared_ptr<Expr>& child);
+  /// @}
 
 protected:
   StmtKind kind_;
   SourceLocation loc_;
+
+private:
+  ASTHashCache hash_;
 };
 
 //===------------------------------------------------------------------------------------------===//
@@ -131,10 +166,36 @@ public:
 
   template <class Iterator>
   void insert_back(Iterator begin, Iterator end) {
-    statements_.insert(statements_.end(), begin, end);
+    insert(statements_.end(), begin, end);
   }
 
-  void push_back(const std::shared_ptr<Stmt>& stmt) { statements_.push_back(stmt); }
+  void push_back(const std::shared_ptr<Stmt>& stmt) {
+    statements_.push_back(stmt);
+    adopt(stmt);
+    invalidateHash();
+  }
+
+  /// @brief Insert the statements `[begin, end)` before `pos`
+  ///
+  /// @returns an iterator to the first inserted statement
+  template <class Iterator>
+  StatementList::iterator insert(StatementList::iterator pos, Iterator begin, Iterator end) {
+    std::size_t numStatements = statements_.size();
+    auto first = statements_.insert(pos, begin, end);
+    for(auto it = first; it != first + (statements_.size() - numStatements); ++it)
+      adopt(*it);
+    invalidateHash();
+    return first;
+  }
+
+  /// @brief Remove the statement at `pos`
+  ///
+  /// @returns an iterator to the statement following the removed one
+  StatementList::iterator erase(StatementList::iterator pos) {
+    auto next = statements_.erase(pos);
+    invalidateHash();
+    return next;
+  }
 
   std::vector<std::shared_ptr<Stmt>>& getStatements() { return statements_; }
   const std::vector<std::shared_ptr<Stmt>>& getStatements() const { return statements_; }
@@ -166,7 +227,11 @@ public:
   virtual ~ExprStmt();
   /// @}
 
-  void setExpr(const std::shared_ptr<Expr>& expr) { expr_ = expr; }
+  void setExpr(const std::shared_ptr<Expr>& expr) {
+    expr_ = expr;
+    adopt(expr_);
+    invalidateHash();
+  }
   const std::shared_ptr<Expr>& getExpr() const { return expr_; }
   std::shared_ptr<Expr>& getExpr() { return expr_; }
 
@@ -174,6 +239,7 @@ public:
                                const std::shared_ptr<Expr>& newExpr);
   virtual std::shared_ptr<Stmt> clone() const override;
   virtual bool equals(const Stmt* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Stmt* stmt) { return stmt->getKind() == SK_ExprStmt; }
   ACCEPTVISITOR(Stmt, ExprStmt)
 };
@@ -196,7 +262,11 @@ public:
   virtual ~ReturnStmt();
   /// @}
 
-  void setExpr(const std::shared_ptr<Expr>& expr) { expr_ = expr; }
+  void setExpr(const std::shared_ptr<Expr>& expr) {
+    expr_ = expr;
+    adopt(expr_);
+    invalidateHash();
+  }
   const std::shared_ptr<Expr>& getExpr() const { return expr_; }
   std::shared_ptr<Expr>& getExpr() { return expr_; }
 
@@ -205,6 +275,7 @@ public:
 
   virtual std::shared_ptr<Stmt> clone() const override;
   virtual bool equals(const Stmt* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Stmt* stmt) { return stmt->getKind() == SK_ReturnStmt; }
   ACCEPTVISITOR(Stmt, ReturnStmt)
 };
@@ -255,6 +326,7 @@ public:
 
   virtual std::shared_ptr<Stmt> clone() const override;
   virtual bool equals(const Stmt* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Stmt* stmt) { return stmt->getKind() == SK_VarDeclStmt; }
   ACCEPTVISITOR(Stmt, VarDeclStmt)
 };
@@ -283,6 +355,7 @@ public:
   virtual bool isStencilDesc() const override { return true; }
   virtual std::shared_ptr<Stmt> clone() const override;
   virtual bool equals(const Stmt* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Stmt* stmt) { return stmt->getKind() == SK_VerticalRegionDeclStmt; }
   ACCEPTVISITOR(Stmt, VerticalRegionDeclStmt)
 };
@@ -311,6 +384,7 @@ public:
   virtual bool isStencilDesc() const override { return true; }
   virtual std::shared_ptr<Stmt> clone() const override;
   virtual bool equals(const Stmt* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Stmt* stmt) { return stmt->getKind() == SK_StencilCallDeclStmt; }
   ACCEPTVISITOR(Stmt, StencilCallDeclStmt)
 };
@@ -342,6 +416,7 @@ public:
   virtual bool isStencilDesc() const override { return true; }
   virtual std::shared_ptr<Stmt> clone() const override;
   virtual bool equals(const Stmt* other) const override;
+  virtual std::size_t getLocalHash() const override;
   static bool classof(const Stmt* stmt) { return stmt->getKind() == SK_BoundaryConditionDeclStmt; }
   ACCEPTVISITOR(Stmt, BoundaryConditionDeclStmt)
 };
@@ -378,12 +453,20 @@ public:
 
   const std::shared_ptr<Stmt>& getThenStmt() const { return subStmts_[OK_Then]; }
   std::shared_ptr<Stmt>& getThenStmt() { return subStmts_[OK_Then]; }
-  void setThenStmt(std::shared_ptr<Stmt>& thenStmt) { subStmts_[OK_Then] = thenStmt; }
+  void setThenStmt(std::shared_ptr<Stmt>& thenStmt) {
+    subStmts_[OK_Then] = thenStmt;
+    adopt(thenStmt);
+    invalidateHash();
+  }
 
   const std::shared_ptr<Stmt>& getElseStmt() const { return subStmts_[OK_Else]; }
   std::shared_ptr<Stmt>& getElseStmt() { return subStmts_[OK_Else]; }
   bool hasElse() const { return getElseStmt() != nullptr; }
-  void setElseStmt(std::shared_ptr<Stmt>& elseStmt) { subStmts_[OK_Else] = elseStmt; }
+  void setElseStmt(std::shared_ptr<Stmt>& elseStmt) {
+    subStmts_[OK_Else] = elseStmt;
+    adopt(elseStmt);
+    invalidateHash();
+  }
 
   virtual std::shared_ptr<Stmt> clone() const override;
   virtual bool equals(const Stmt* other) const override;
@@ -16,8 +16,10 @@
 #include "dawn/SIR/ASTUtil.h"
 #include "dawn/SIR/ASTVisitor.h"
 #include "dawn/SIR/Statement.h"
+#include "dawn/Support/Casting.h"
 #include "dawn/Support/StringSwitch.h"
 #include "dawn/Support/Unreachable.h"
+#include <cstring>
 #include <functional>
 
 namespace dawn {
@@ -57,9 +59,9 @@ public:
   }
 
   void visit(const std::shared_ptr<VarDeclStmt>& stmt) override {
-    for(auto& expr : stmt->getInitList()) {
+    for(const auto& expr : stmt->getInitList()) {
       if(expr == oldExpr_)
-        expr = newExpr_;
+        stmt->replaceChildren(oldExpr_, newExpr_);
       else
         expr->accept(*this);
     }
@@ -123,18 +125,18 @@ public:
   }
 
   void visit(const std::shared_ptr<FunCallExpr>& expr) override {
-    for(auto& e : expr->getArguments()) {
+    for(const auto& e : expr->getArguments()) {
       if(e == oldExpr_)
-        e = newExpr_;
+        expr->replaceChildren(oldExpr_, newExpr_);
       else
         e->accept(*this);
     }
   }
 
   void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override {
-    for(auto& e : expr->getArguments()) {
+    for(const auto& e : expr->getArguments()) {
       if(e == oldExpr_)
-        e = newExpr_;
+        expr->replaceChildren(oldExpr_, newExpr_);
       else
         e->accept(*this);
     }
@@ -180,9 +182,9 @@ public:
       : oldStmt_(oldStmt), newStmt_(newStmt) {}
 
   void visit(const std::shared_ptr<BlockStmt>& stmt) override {
-    for(auto& s : stmt->getStatements()) {
+    for(const auto& s : stmt->getStatements()) {
       if(s == oldStmt_)
-        s = newStmt_;
+        stmt->replaceChildren(oldStmt_, newStmt_);
       else
         s->accept(*this);
     }
@@ -506,6 +508,45 @@ private:
   std::vector<dawn::sir::Field> allFields_;
 };
 
+bool hasSideEffects(const Expr* expr) {
+  switch(expr->getKind()) {
+  case Expr::EK_AssignmentExpr:
+    return true;
+  case Expr::EK_UnaryOperator: {
+    const char* op = cast<UnaryOperator>(expr)->getOp();
+    return std::strcmp(op, "++") == 0 || std::strcmp(op, "--") == 0;
+  }
+  default:
+    return false;
+  }
+}
+
+bool isPureNode(const Expr* expr) {
+  switch(expr->getKind()) {
+  case Expr::EK_UnaryOperator:
+    return !hasSideEffects(expr);
+  case Expr::EK_FieldAccessExpr:
+    return !cast<FieldAccessExpr>(expr)->hasArguments();
+  case Expr::EK_BinaryOperator:
+  case Expr::EK_TernaryOperator:
+  case Expr::EK_FunCallExpr:
+  case Expr::EK_VarAccessExpr:
+  case Expr::EK_LiteralAccessExpr:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool isPureExpr(const std::shared_ptr<Expr>& expr) {
+  if(!isPureNode(expr.get()))
+    return false;
+  for(const auto& child : expr->getChildren())
+    if(!isPureExpr(child))
+      return false;
+  return true;
+}
+
 extern std::vector<sir::Field> getFieldFromStencilAST(const std::shared_ptr<AST>& ast) {
   FieldFinder finder;
   ast->accept(finder);
@@ -76,6 +76,28 @@ extern bool evalExprAsBoolean(const std::shared_ptr<Expr>& expr, bool& result,
                                   std::unordered_map<std::string, double>());
 /// @}
 
+/// @brief Check if evaluating the node `expr` (disregarding its children) writes to a field or
+/// variable, i.e if `expr` is an assignment or an increment/decrement
+///
+/// @ingroup sir
+extern bool hasSideEffects(const Expr* expr);
+
+/// @brief Check if the value of the node `expr` (disregarding its children) only depends on its
+/// children and the fields and variables it reads, i.e if the node can be duplicated, dropped or
+/// shared
+///
+/// Nodes with side effects, calls to stencil functions (which are bound to their instantiation) and
+/// accesses of stencil function arguments are not pure.
+///
+/// @ingroup sir
+extern bool isPureNode(const Expr* expr);
+
+/// @brief Check if `expr` and all its subexpressions are pure
+///
+/// @see isPureNode
+/// @ingroup sir
+extern bool isPureExpr(const std::shared_ptr<Expr>& expr);
+
 /// @brief Find all the different fields used in a given statement
 ///
 /// This method iterates trough the complete AST and returns a vector of all the fields used. This
@@ -19,7 +19,10 @@
 #include "dawn/Support/Printing.h"
 #include "dawn/Support/StringUtil.h"
 #include "dawn/Support/Unreachable.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 namespace dawn {
@@ -190,15 +193,20 @@ static std::pair<std::string, bool> pointerMapComparison(const sir::GlobalVariab
 sir::CompareResult SIR::comparison(const SIR& rhs) const {
   std::string output;
 
+  // Lazily deserialized SIRs are compared including the entries which are not materialized yet
+  auto stencils = getAllStencils(), rhsStencils = rhs.getAllStencils();
+  auto stencilFunctions = getAllStencilFunctions(),
+       rhsStencilFunctions = rhs.getAllStencilFunctions();
+
   // Stencils
-  if((Stencils.size() != rhs.Stencils.size()))
+  if((stencils.size() != rhsStencils.size()))
     return sir::CompareResult{"[SIR mismatch] number of Stencils do not match\n", false};
 
-  if(!std::equal(Stencils.begin(), Stencils.end(), rhs.Stencils.begin(),
+  if(!std::equal(stencils.begin(), stencils.end(), rhsStencils.begin(),
                  pointeeComparison<sir::Stencil>)) {
     output += "[SIR mismatch] Stencils do not match\n";
-    for(int i = 0; i < Stencils.size(); ++i) {
-      auto comp = pointeeComparisonWithOutput(Stencils[i], rhs.Stencils[i]);
+    for(int i = 0; i < stencils.size(); ++i) {
+      auto comp = pointeeComparisonWithOutput(stencils[i], rhsStencils[i]);
       if(bool(comp) == false) {
         output += comp.why();
       }
@@ -208,18 +216,18 @@ sir::CompareResult SIR::comparison(const SIR& rhs) const {
   }
 
   // Stencil Functions
-  if(StencilFunctions.size() != rhs.StencilFunctions.size())
+  if(stencilFunctions.size() != rhsStencilFunctions.size())
     return sir::CompareResult{"[SIR mismatch] number of Stencil Functions does not match\n", false};
 
-  if(!std::equal(StencilFunctions.begin(), StencilFunctions.end(), rhs.StencilFunctions.begin(),
+  if(!std::equal(stencilFunctions.begin(), stencilFunctions.end(), rhsStencilFunctions.begin(),
                  pointeeComparison<sir::StencilFunction>)) {
     output += "[SIR mismatch] Stencil Functions do not match\n";
-    for(int i = 0; i < StencilFunctions.size(); ++i) {
-      auto comp = pointeeComparisonWithOutput(StencilFunctions[i], rhs.StencilFunctions[i]);
+    for(int i = 0; i < stencilFunctions.size(); ++i) {
+      auto comp = pointeeComparisonWithOutput(stencilFunctions[i], rhsStencilFunctions[i]);
       if(!bool(comp))
         output +=
             dawn::format("[StencilFunction mismatch] Stencil Function %s does not match\n%s\n",
-                         StencilFunctions[i]->Name, comp.why());
+                         stencilFunctions[i]->Name, comp.why());
     }
 
     return sir::CompareResult{output, false};
@@ -602,6 +610,89 @@ SIR::SIR() : GlobalVariableMap(std::make_shared<sir::GlobalVariableMap>()) {}
 
 void SIR::dump() { std::cout << *this << std::endl; }
 
+std::shared_ptr<sir::Stencil> SIR::getStencil(const std::string& name) {
+  auto it = std::find_if(Stencils.begin(), Stencils.end(),
+                         [&](const std::shared_ptr<sir::Stencil>& s) { return s->Name == name; });
+  if(it != Stencils.end())
+    return *it;
+  if(!Lazy)
+    return nullptr;
+
+  auto stencil = Lazy->makeStencil(name);
+  if(stencil)
+    Stencils.push_back(stencil);
+  return stencil;
+}
+
+std::shared_ptr<sir::StencilFunction> SIR::getStencilFunction(const std::string& name) {
+  auto it = std::find_if(
+      StencilFunctions.begin(), StencilFunctions.end(),
+      [&](const std::shared_ptr<sir::StencilFunction>& sf) { return sf->Name == name; });
+  if(it != StencilFunctions.end())
+    return *it;
+  if(!Lazy)
+    return nullptr;
+
+  auto stencilFunction = Lazy->makeStencilFunction(name);
+  if(stencilFunction)
+    StencilFunctions.push_back(stencilFunction);
+  return stencilFunction;
+}
+
+std::vector<std::string> SIR::getStencilNames() const {
+  std::vector<std::string> names;
+  if(Lazy)
+    names = Lazy->getStencilNames();
+  for(const auto& stencil : Stencils)
+    if(std::find(names.begin(), names.end(), stencil->Name) == names.end())
+      names.push_back(stencil->Name);
+  return names;
+}
+
+std::vector<std::shared_ptr<sir::Stencil>> SIR::getAllStencils() const {
+  // The entries of the serialized SIR first, entries added after the deserialization are kept at
+  // the end
+  std::vector<std::shared_ptr<sir::Stencil>> stencils;
+  if(Lazy)
+    for(const auto& name : Lazy->getStencilNames()) {
+      auto it =
+          std::find_if(Stencils.begin(), Stencils.end(),
+                       [&](const std::shared_ptr<sir::Stencil>& s) { return s->Name == name; });
+      stencils.push_back(it != Stencils.end() ? *it : Lazy->makeStencil(name));
+    }
+  for(const auto& stencil : Stencils)
+    if(std::find(stencils.begin(), stencils.end(), stencil) == stencils.end())
+      stencils.push_back(stencil);
+  return stencils;
+}
+
+std::vector<std::shared_ptr<sir::StencilFunction>> SIR::getAllStencilFunctions() const {
+  std::vector<std::shared_ptr<sir::StencilFunction>> stencilFunctions;
+  if(Lazy)
+    for(const auto& name : Lazy->getStencilFunctionNames()) {
+      auto it = std::find_if(
+          StencilFunctions.begin(), StencilFunctions.end(),
+          [&](const std::shared_ptr<sir::StencilFunction>& sf) { return sf->Name == name; });
+      stencilFunctions.push_back(it != StencilFunctions.end() ? *it
+                                                              : Lazy->makeStencilFunction(name));
+    }
+  for(const auto& stencilFunction : StencilFunctions)
+    if(std::find(stencilFunctions.begin(), stencilFunctions.end(), stencilFunction) ==
+       stencilFunctions.end())
+      stencilFunctions.push_back(stencilFunction);
+  return stencilFunctions;
+}
+
+void SIR::materialize() {
+  if(!Lazy)
+    return;
+  Stencils = getAllStencils();
+  StencilFunctions = getAllStencilFunctions();
+  Lazy = nullptr;
+}
+
+sir::LazySource::~LazySource() {}
+
 const char* sir::Value::typeToString(sir::Value::TypeKind type) {
   switch(type) {
   case None:
@@ -645,9 +736,19 @@ std::string sir::Value::toString() const {
   case Integer:
     ss << getValue<int>();
     break;
-  case Double:
-    ss << getValue<double>();
+  case Double: {
+    // Use the shortest representation which reads back as the same value
+    double value = getValue<double>();
+    for(int precision = ss.precision(); precision <= std::numeric_limits<double>::max_digits10;
+        ++precision) {
+      ss.str("");
+      ss.precision(precision);
+      ss << value;
+      if(std::strtod(ss.str().c_str(), nullptr) == value)
+        break;
+    }
     break;
+  }
   case String:
     ss << "\"" << getValue<std::string>() << "\"";
     break;
@@ -401,6 +401,31 @@ struct Value::TypeInfo<std::string> {
 /// @ingroup sir
 using GlobalVariableMap = std::unordered_map<std::string, std::shared_ptr<sir::Value>>;
 
+//===------------------------------------------------------------------------------------------===//
+//     LazySource
+//===------------------------------------------------------------------------------------------===//
+
+/// @brief Source of the stencils and stencil functions of a lazily deserialized SIR
+///
+/// The source keeps the serialized SIR and builds a stencil (or stencil function) only when it is
+/// requested by name. See `SIRSerializer::deserializeLazy`.
+/// @ingroup sir
+class LazySource : public NonCopyable {
+public:
+  virtual ~LazySource();
+
+  /// @brief Names of all stencils (stencil functions) in the order of the serialized SIR
+  virtual const std::vector<std::string>& getStencilNames() const = 0;
+  virtual const std::vector<std::string>& getStencilFunctionNames() const = 0;
+
+  /// @brief Build the stencil (stencil function) `name` or return `NULL` if there is no such
+  /// stencil (stencil function)
+  ///
+  /// Each call returns a newly allocated object.
+  virtual std::shared_ptr<Stencil> makeStencil(const std::string& name) const = 0;
+  virtual std::shared_ptr<StencilFunction> makeStencilFunction(const std::string& name) const = 0;
+};
+
 } // namespace sir
 
 //===------------------------------------------------------------------------------------------===//
@@ -419,7 +444,9 @@ struct SIR : public dawn::NonCopyable {
 
   /// @brief Compares two SIRs for equality in contents
   ///
-  /// The `Filename` as well as the SourceLocations are not taken into account.
+  /// The `Filename` as well as the SourceLocations are not taken into account. The stencils and
+  /// stencil functions of lazily deserialized SIRs which are not materialized yet are built for
+  /// the comparison (without being added to the SIR) and compared in the order of `materialize`.
   bool operator==(const SIR& rhs) const;
   bool operator!=(const SIR& rhs) const;
 
@@ -431,10 +458,37 @@ struct SIR : public dawn::NonCopyable {
   /// @brief Dump SIR to the given stream
   friend std::ostream& operator<<(std::ostream& os, const SIR& Sir);
 
-  std::string Filename;                                ///< Name of the file the SIR was parsed from
-  std::vector<std::shared_ptr<sir::Stencil>> Stencils; ///< List of stencils
-  std::vector<std::shared_ptr<sir::StencilFunction>> StencilFunctions; ///< List of stencil function
+  /// @brief Get the stencil (stencil function) `name` or `NULL` if there is no such stencil
+  /// (stencil function)
+  ///
+  /// If the SIR was deserialized lazily, the stencil (stencil function) is materialized on first
+  /// access and appended to `Stencils` (`StencilFunctions`).
+  std::shared_ptr<sir::Stencil> getStencil(const std::string& name);
+  std::shared_ptr<sir::StencilFunction> getStencilFunction(const std::string& name);
+
+  /// @brief Names of all stencils, including the ones which have not been materialized yet
+  std::vector<std::string> getStencilNames() const;
+
+  /// @brief Materialize all stencils and stencil functions of a lazily deserialized SIR
+  ///
+  /// Afterwards, `Stencils` and `StencilFunctions` are in the order of the serialized SIR.
+  void materialize();
+
+  std::string Filename; ///< Name of the file the SIR was parsed from
+
+  /// List of stencils (stencil functions). If the SIR was deserialized lazily, these only contain
+  /// the entries which have been materialized so far: use `getStencil` (`getStencilFunction`) to
+  /// look up an entry by name or `materialize` before iterating them.
+  std::vector<std::shared_ptr<sir::Stencil>> Stencils;
+  std::vector<std::shared_ptr<sir::StencilFunction>> StencilFunctions;
   std::shared_ptr<sir::GlobalVariableMap> GlobalVariableMap;           ///< Map of global variables
+  std::shared_ptr<sir::LazySource> Lazy; ///< Source of the unmaterialized entries (or `NULL`)
+
+private:
+  /// @brief All stencils (stencil functions) in the order of `materialize`, the entries which are
+  /// not materialized yet are built but not added to the SIR
+  std::vector<std::shared_ptr<sir::Stencil>> getAllStencils() const;
+  std::vector<std::shared_ptr<sir::StencilFunction>> getAllStencilFunctions() const;
 };
 
 } // namespace dawn
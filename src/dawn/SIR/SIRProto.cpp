@@ -0,0 +1,975 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/SIR/SIRProto.h"
+#include "dawn/SIR/ASTVisitor.h"
+#include "dawn/Support/Format.h"
+#include "dawn/Support/Logging.h"
+#include "dawn/Support/Unreachable.h"
+#include <algorithm>
+#include <mutex>
+#include <stack>
+#include <stdexcept>
+
+namespace dawn {
+
+//===------------------------------------------------------------------------------------------===//
+//     ProtobufLogger
+//===------------------------------------------------------------------------------------------===//
+
+ProtobufLogger* ProtobufLogger::instance_ = nullptr;
+
+thread_local std::list<ProtobufLogger::LogMessage> ProtobufLogger::logStack_;
+
+void ProtobufLogger::LogHandler(google::protobuf::LogLevel level, const char* filename, int line,
+                                const std::string& message) {
+  // Log to the Dawn logger
+  switch(level) {
+  case google::protobuf::LOGLEVEL_INFO:
+    DAWN_LOG(INFO) << "Protobuf: " << message;
+    break;
+  case google::protobuf::LOGLEVEL_WARNING:
+    DAWN_LOG(WARNING) << "Protobuf: " << message;
+    break;
+  case google::protobuf::LOGLEVEL_ERROR:
+    DAWN_LOG(ERROR) << "Protobuf: " << message;
+    break;
+  case google::protobuf::LOGLEVEL_FATAL:
+    DAWN_LOG(FATAL) << "Protobuf: " << message;
+    break;
+  }
+
+  // Cache the messages
+  getInstance().push(LogMessage{level, filename, line, message});
+}
+
+std::string ProtobufLogger::getErrorMessagesAndReset() {
+  std::string str = "Protobuf errors (most recent call last):\n\n";
+  for(const LogMessage& msg : logStack_)
+    if(std::get<0>(msg) >= google::protobuf::LOGLEVEL_ERROR)
+      str += dawn::format("%s:%i: %s\n\n", std::get<1>(msg), std::get<2>(msg), std::get<3>(msg));
+  logStack_.clear();
+  return str;
+}
+
+void ProtobufLogger::init() {
+  static std::once_flag initFlag;
+  std::call_once(initFlag, []() {
+    instance_ = new ProtobufLogger();
+    google::protobuf::SetLogHandler(ProtobufLogger::LogHandler);
+  });
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Serialization
+//===------------------------------------------------------------------------------------------===//
+
+void setLocation(sir::proto::SourceLocation* locProto, const SourceLocation& loc) {
+  locProto->set_column(loc.Column);
+  locProto->set_line(loc.Line);
+}
+
+static void setBuiltinType(sir::proto::BuiltinType* builtinTypeProto,
+                           const BuiltinTypeID& builtinType) {
+  builtinTypeProto->set_type_id(static_cast<sir::proto::BuiltinType_TypeID>(builtinType));
+}
+
+static void setInterval(sir::proto::Interval* intervalProto, const sir::Interval* interval) {
+  if(interval->LowerLevel == sir::Interval::Start)
+    intervalProto->set_special_lower_level(sir::proto::Interval::Start);
+  else if(interval->LowerLevel == sir::Interval::End)
+    intervalProto->set_special_lower_level(sir::proto::Interval::End);
+  else
+    intervalProto->set_lower_level(interval->LowerLevel);
+
+  if(interval->UpperLevel == sir::Interval::Start)
+    intervalProto->set_special_upper_level(sir::proto::Interval::Start);
+  else if(interval->UpperLevel == sir::Interval::End)
+    intervalProto->set_special_upper_level(sir::proto::Interval::End);
+  else
+    intervalProto->set_upper_level(interval->UpperLevel);
+
+  intervalProto->set_lower_offset(interval->LowerOffset);
+  intervalProto->set_upper_offset(interval->UpperOffset);
+}
+
+static void setField(sir::proto::Field* fieldProto, const sir::Field* field) {
+  fieldProto->set_name(field->Name);
+  fieldProto->set_is_temporary(field->IsTemporary);
+  for(const auto& initializedDimension : field->fieldDimensions) {
+    fieldProto->add_field_dimensions(initializedDimension);
+  }
+  setLocation(fieldProto->mutable_loc(), field->Loc);
+}
+
+static void setDirection(sir::proto::Direction* directionProto, const sir::Direction* direction) {
+  directionProto->set_name(direction->Name);
+  setLocation(directionProto->mutable_loc(), direction->Loc);
+}
+
+static void setOffset(sir::proto::Offset* offsetProto, const sir::Offset* offset) {
+  offsetProto->set_name(offset->Name);
+  setLocation(offsetProto->mutable_loc(), offset->Loc);
+}
+
+namespace {
+
+class ProtoStmtBuilder : public ASTVisitor {
+  std::stack<sir::proto::Stmt*> currentStmtProto_;
+  std::stack<sir::proto::Expr*> currentExprProto_;
+
+public:
+  ProtoStmtBuilder(sir::proto::Stmt* stmtProto) { currentStmtProto_.push(stmtProto); }
+  ProtoStmtBuilder(sir::proto::Expr* exprProto) { currentExprProto_.push(exprProto); }
+
+  sir::proto::Stmt* getCurrentStmtProto() {
+    DAWN_ASSERT(!currentStmtProto_.empty());
+    return currentStmtProto_.top();
+  }
+
+  sir::proto::Expr* getCurrentExprProto() {
+    DAWN_ASSERT(!currentExprProto_.empty());
+    return currentExprProto_.top();
+  }
+
+  void visit(const std::shared_ptr<BlockStmt>& stmt) override {
+    auto protoStmt = getCurrentStmtProto()->mutable_block_stmt();
+
+    for(const auto& s : stmt->getStatements()) {
+      currentStmtProto_.push(protoStmt->add_statements());
+      s->accept(*this);
+      currentStmtProto_.pop();
+    }
+
+    setLocation(protoStmt->mutable_loc(), stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<ExprStmt>& stmt) override {
+    auto protoStmt = getCurrentStmtProto()->mutable_expr_stmt();
+    currentExprProto_.push(protoStmt->mutable_expr());
+    stmt->getExpr()->accept(*this);
+    currentExprProto_.pop();
+
+    setLocation(protoStmt->mutable_loc(), stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<ReturnStmt>& stmt) override {
+    auto protoStmt = getCurrentStmtProto()->mutable_return_stmt();
+
+    currentExprProto_.push(protoStmt->mutable_expr());
+    stmt->getExpr()->accept(*this);
+    currentExprProto_.pop();
+
+    setLocation(protoStmt->mutable_loc(), stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<VarDeclStmt>& stmt) override {
+    auto protoStmt = getCurrentStmtProto()->mutable_var_decl_stmt();
+
+    if(stmt->getType().isBuiltinType())
+      setBuiltinType(protoStmt->mutable_type()->mutable_builtin_type(),
+                     stmt->getType().getBuiltinTypeID());
+    else
+      protoStmt->mutable_type()->set_name(stmt->getType().getName());
+    protoStmt->mutable_type()->set_is_const(stmt->getType().isConst());
+    protoStmt->mutable_type()->set_is_volatile(stmt->getType().isVolatile());
+
+    protoStmt->set_name(stmt->getName());
+    protoStmt->set_dimension(stmt->getDimension());
+    protoStmt->set_op(stmt->getOp());
+
+    for(const auto& expr : stmt->getInitList()) {
+      currentExprProto_.push(protoStmt->add_init_list());
+      expr->accept(*this);
+      currentExprProto_.pop();
+    }
+
+    setLocation(protoStmt->mutable_loc(), stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<VerticalRegionDeclStmt>& stmt) override {
+    auto protoStmt = getCurrentStmtProto()->mutable_vertical_region_decl_stmt();
+
+    sir::VerticalRegion* verticalRegion = stmt->getVerticalRegion().get();
+    sir::proto::VerticalRegion* verticalRegionProto = protoStmt->mutable_vertical_region();
+
+    // VerticalRegion.Loc
+    setLocation(verticalRegionProto->mutable_loc(), verticalRegion->Loc);
+
+    // VerticalRegion.Ast
+    setAST(verticalRegionProto->mutable_ast(), verticalRegion->Ast.get());
+
+    // VerticalRegion.VerticalInterval
+    setInterval(verticalRegionProto->mutable_interval(), verticalRegion->VerticalInterval.get());
+
+    // VerticalRegion.LoopOrder
+    verticalRegionProto->set_loop_order(verticalRegion->LoopOrder ==
+                                                sir::VerticalRegion::LK_Backward
+                                            ? sir::proto::VerticalRegion::Backward
+                                            : sir::proto::VerticalRegion::Forward);
+
+    setLocation(protoStmt->mutable_loc(), stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<StencilCallDeclStmt>& stmt) override {
+    auto protoStmt = getCurrentStmtProto()->mutable_stencil_call_decl_stmt();
+
+    sir::StencilCall* stencilCall = stmt->getStencilCall().get();
+    sir::proto::StencilCall* stencilCallProto = protoStmt->mutable_stencil_call();
+
+    // StencilCall.Loc
+    setLocation(stencilCallProto->mutable_loc(), stencilCall->Loc);
+
+    // StencilCall.Callee
+    stencilCallProto->set_callee(stencilCall->Callee);
+
+    // StencilCall.Args
+    for(const auto& arg : stencilCall->Args) {
+      auto argProto = stencilCallProto->add_arguments();
+      argProto->set_name(arg->Name);
+      argProto->set_is_temporary(arg->IsTemporary);
+      argProto->mutable_loc()->set_column(arg->Loc.Column);
+      argProto->mutable_loc()->set_line(arg->Loc.Line);
+    }
+
+    setLocation(protoStmt->mutable_loc(), stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<BoundaryConditionDeclStmt>& stmt) override {
+    auto protoStmt = getCurrentStmtProto()->mutable_boundary_condition_decl_stmt();
+    protoStmt->set_functor(stmt->getFunctor());
+
+    for(const auto& field : stmt->getFields()) {
+      auto fieldProto = protoStmt->add_fields();
+      fieldProto->set_name(field->Name);
+      fieldProto->set_is_temporary(field->IsTemporary);
+      fieldProto->mutable_loc()->set_column(field->Loc.Column);
+      fieldProto->mutable_loc()->set_line(field->Loc.Line);
+    }
+
+    setLocation(protoStmt->mutable_loc(), stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<IfStmt>& stmt) override {
+    auto protoStmt = getCurrentStmtProto()->mutable_if_stmt();
+
+    currentStmtProto_.push(protoStmt->mutable_cond_part());
+    stmt->getCondStmt()->accept(*this);
+    currentStmtProto_.pop();
+
+    currentStmtProto_.push(protoStmt->mutable_then_part());
+    stmt->getThenStmt()->accept(*this);
+    currentStmtProto_.pop();
+
+    if(stmt->hasElse()) {
+      currentStmtProto_.push(protoStmt->mutable_else_part());
+      stmt->getElseStmt()->accept(*this);
+      currentStmtProto_.pop();
+    }
+
+    setLocation(protoStmt->mutable_loc(), stmt->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<UnaryOperator>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_unary_operator();
+    protoExpr->set_op(expr->getOp());
+
+    currentExprProto_.push(protoExpr->mutable_operand());
+    expr->getOperand()->accept(*this);
+    currentExprProto_.pop();
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<BinaryOperator>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_binary_operator();
+    protoExpr->set_op(expr->getOp());
+
+    currentExprProto_.push(protoExpr->mutable_left());
+    expr->getLeft()->accept(*this);
+    currentExprProto_.pop();
+
+    currentExprProto_.push(protoExpr->mutable_right());
+    expr->getRight()->accept(*this);
+    currentExprProto_.pop();
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<AssignmentExpr>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_assignment_expr();
+    protoExpr->set_op(expr->getOp());
+
+    currentExprProto_.push(protoExpr->mutable_left());
+    expr->getLeft()->accept(*this);
+    currentExprProto_.pop();
+
+    currentExprProto_.push(protoExpr->mutable_right());
+    expr->getRight()->accept(*this);
+    currentExprProto_.pop();
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<TernaryOperator>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_ternary_operator();
+
+    currentExprProto_.push(protoExpr->mutable_cond());
+    expr->getCondition()->accept(*this);
+    currentExprProto_.pop();
+
+    currentExprProto_.push(protoExpr->mutable_left());
+    expr->getLeft()->accept(*this);
+    currentExprProto_.pop();
+
+    currentExprProto_.push(protoExpr->mutable_right());
+    expr->getRight()->accept(*this);
+    currentExprProto_.pop();
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<FunCallExpr>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_fun_call_expr();
+    protoExpr->set_callee(expr->getCallee());
+
+    for(const auto& arg : expr->getArguments()) {
+      currentExprProto_.push(protoExpr->add_arguments());
+      arg->accept(*this);
+      currentExprProto_.pop();
+    }
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<StencilFunCallExpr>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_stencil_fun_call_expr();
+    protoExpr->set_callee(expr->getCallee());
+
+    for(const auto& arg : expr->getArguments()) {
+      currentExprProto_.push(protoExpr->add_arguments());
+      arg->accept(*this);
+      currentExprProto_.pop();
+    }
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<StencilFunArgExpr>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_stencil_fun_arg_expr();
+
+    protoExpr->mutable_dimension()->set_direction(
+        expr->getDimension() == -1
+            ? sir::proto::Dimension::Invalid
+            : static_cast<sir::proto::Dimension_Direction>(expr->getDimension()));
+    protoExpr->set_offset(expr->getOffset());
+    protoExpr->set_argument_index(expr->getArgumentIndex());
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<VarAccessExpr>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_var_access_expr();
+
+    protoExpr->set_name(expr->getName());
+    protoExpr->set_is_external(expr->isExternal());
+
+    if(expr->isArrayAccess()) {
+      currentExprProto_.push(protoExpr->mutable_index());
+      expr->getIndex()->accept(*this);
+      currentExprProto_.pop();
+    }
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<FieldAccessExpr>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_field_access_expr();
+
+    protoExpr->set_name(expr->getName());
+
+    for(int offset : expr->getOffset())
+      protoExpr->add_offset(offset);
+
+    for(int argOffset : expr->getArgumentOffset())
+      protoExpr->add_argument_offset(argOffset);
+
+    for(int argMap : expr->getArgumentMap())
+      protoExpr->add_argument_map(argMap);
+
+    protoExpr->set_negate_offset(expr->negateOffset());
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+
+  void visit(const std::shared_ptr<LiteralAccessExpr>& expr) override {
+    auto protoExpr = getCurrentExprProto()->mutable_literal_access_expr();
+
+    protoExpr->set_value(expr->getValue());
+    setBuiltinType(protoExpr->mutable_type(), expr->getBuiltinType());
+
+    setLocation(protoExpr->mutable_loc(), expr->getSourceLocation());
+  }
+};
+
+} // anonymous namespace
+
+void setStmt(sir::proto::Stmt* stmtProto, const std::shared_ptr<Stmt>& stmt) {
+  ProtoStmtBuilder builder(stmtProto);
+  stmt->accept(builder);
+}
+
+void setExpr(sir::proto::Expr* exprProto, const std::shared_ptr<Expr>& expr) {
+  ProtoStmtBuilder builder(exprProto);
+  expr->accept(builder);
+}
+
+void setAST(sir::proto::AST* astProto, const AST* ast) {
+  ProtoStmtBuilder builder(astProto->mutable_root());
+  ast->accept(builder);
+}
+
+void setStencilFunction(sir::proto::StencilFunction* stencilFunctionProto,
+                        const sir::StencilFunction* stencilFunction) {
+  // StencilFunction.Name
+  stencilFunctionProto->set_name(stencilFunction->Name);
+
+  // StencilFunction.Loc
+  setLocation(stencilFunctionProto->mutable_loc(), stencilFunction->Loc);
+
+  // StencilFunction.Args
+  for(const auto& arg : stencilFunction->Args) {
+    auto argProto = stencilFunctionProto->add_arguments();
+    if(sir::Field* field = dyn_cast<sir::Field>(arg.get())) {
+      setField(argProto->mutable_field_value(), field);
+    } else if(sir::Direction* direction = dyn_cast<sir::Direction>(arg.get())) {
+      setDirection(argProto->mutable_direction_value(), direction);
+    } else if(sir::Offset* offset = dyn_cast<sir::Offset>(arg.get())) {
+      setOffset(argProto->mutable_offset_value(), offset);
+    } else {
+      dawn_unreachable("invalid argument");
+    }
+  }
+
+  // StencilFunction.Intervals
+  for(const auto& interval : stencilFunction->Intervals) {
+    auto intervalProto = stencilFunctionProto->add_intervals();
+    setInterval(intervalProto, interval.get());
+  }
+
+  // StencilFunction.Asts
+  for(const auto& ast : stencilFunction->Asts) {
+    auto astProto = stencilFunctionProto->add_asts();
+    setAST(astProto, ast.get());
+  }
+}
+
+void setStencil(sir::proto::Stencil* stencilProto, const sir::Stencil* stencil) {
+  // Stencil.Name
+  stencilProto->set_name(stencil->Name);
+
+  // Stencil.Loc
+  setLocation(stencilProto->mutable_loc(), stencil->Loc);
+
+  // Stencil.StencilDescAst
+  setAST(stencilProto->mutable_ast(), stencil->StencilDescAst.get());
+
+  // Stencil.Fields
+  for(const auto& field : stencil->Fields) {
+    auto fieldProto = stencilProto->add_fields();
+    setField(fieldProto, field.get());
+  }
+}
+
+void setSIR(sir::proto::SIR* sirProto, const SIR* sir) {
+  // SIR.Filename
+  sirProto->set_filename(sir->Filename);
+
+  // SIR.Stencils and SIR.StencilFunctions (the entries of a lazily deserialized SIR, which have not
+  // been materialized yet, are serialized in their original order)
+  std::vector<std::shared_ptr<sir::Stencil>> stencils;
+  std::vector<std::shared_ptr<sir::StencilFunction>> stencilFunctions;
+  if(sir->Lazy) {
+    for(const auto& name : sir->Lazy->getStencilNames()) {
+      auto it =
+          std::find_if(sir->Stencils.begin(), sir->Stencils.end(),
+                       [&](const std::shared_ptr<sir::Stencil>& s) { return s->Name == name; });
+      stencils.push_back(it != sir->Stencils.end() ? *it : sir->Lazy->makeStencil(name));
+    }
+    for(const auto& name : sir->Lazy->getStencilFunctionNames()) {
+      auto it = std::find_if(
+          sir->StencilFunctions.begin(), sir->StencilFunctions.end(),
+          [&](const std::shared_ptr<sir::StencilFunction>& sf) { return sf->Name == name; });
+      stencilFunctions.push_back(it != sir->StencilFunctions.end()
+                                     ? *it
+                                     : sir->Lazy->makeStencilFunction(name));
+    }
+  }
+  for(const auto& stencil : sir->Stencils)
+    if(std::find(stencils.begin(), stencils.end(), stencil) == stencils.end())
+      stencils.push_back(stencil);
+  for(const auto& stencilFunction : sir->StencilFunctions)
+    if(std::find(stencilFunctions.begin(), stencilFunctions.end(), stencilFunction) ==
+       stencilFunctions.end())
+      stencilFunctions.push_back(stencilFunction);
+
+  for(const auto& stencil : stencils)
+    setStencil(sirProto->add_stencils(), stencil.get());
+
+  for(const auto& stencilFunction : stencilFunctions)
+    setStencilFunction(sirProto->add_stencil_functions(), stencilFunction.get());
+
+  // SIR.GlobalVariableMap
+  auto mapProto = sirProto->mutable_global_variables()->mutable_map();
+  for(const auto& nameValuePair : *sir->GlobalVariableMap) {
+    const std::string& name = nameValuePair.first;
+    const sir::Value& value = *nameValuePair.second;
+
+    sir::proto::GlobalVariableValue valueProto;
+    valueProto.set_is_constexpr(value.isConstexpr());
+    if(!value.empty()) {
+      switch(value.getType()) {
+      case sir::Value::Boolean:
+        valueProto.set_boolean_value(value.getValue<bool>());
+        break;
+      case sir::Value::Integer:
+        valueProto.set_integer_value(value.getValue<int>());
+        break;
+      case sir::Value::Double:
+        valueProto.set_double_value(value.getValue<double>());
+        break;
+      case sir::Value::String:
+        valueProto.set_string_value(value.getValue<std::string>());
+        break;
+      case sir::Value::None:
+        break;
+      }
+    }
+
+    mapProto->insert({name, valueProto});
+  }
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Deserialization
+//===------------------------------------------------------------------------------------------===//
+
+static std::shared_ptr<sir::Field> makeField(const sir::proto::Field& fieldProto) {
+  auto field = std::make_shared<sir::Field>(fieldProto.name(), makeLocation(fieldProto));
+  field->IsTemporary = fieldProto.is_temporary();
+  if(!fieldProto.field_dimensions().empty()) {
+    auto throwException = [&fieldProto](const char* member) {
+      throw std::runtime_error(
+          format("Field::%s (loc %s) exceeds 3 dimensions", member, makeLocation(fieldProto)));
+    };
+    if(fieldProto.field_dimensions().size() > 3)
+      throwException("field_dimensions");
+
+    std::copy(fieldProto.field_dimensions().begin(), fieldProto.field_dimensions().end(),
+              field->fieldDimensions.begin());
+  }
+  return field;
+}
+
+static BuiltinTypeID makeBuiltinTypeID(const sir::proto::BuiltinType& builtinTypeProto) {
+  switch(builtinTypeProto.type_id()) {
+  case sir::proto::BuiltinType_TypeID_Invalid:
+    return BuiltinTypeID::Invalid;
+  case sir::proto::BuiltinType_TypeID_Auto:
+    return BuiltinTypeID::Auto;
+  case sir::proto::BuiltinType_TypeID_Boolean:
+    return BuiltinTypeID::Boolean;
+  case sir::proto::BuiltinType_TypeID_Integer:
+    return BuiltinTypeID::Integer;
+  case sir::proto::BuiltinType_TypeID_Float:
+    return BuiltinTypeID::Float;
+  default:
+    return BuiltinTypeID::Invalid;
+  }
+  return BuiltinTypeID::Invalid;
+}
+
+static std::shared_ptr<sir::Direction> makeDirection(const sir::proto::Direction& directionProto) {
+  return std::make_shared<sir::Direction>(directionProto.name(), makeLocation(directionProto));
+}
+
+static std::shared_ptr<sir::Offset> makeOffset(const sir::proto::Offset& offsetProto) {
+  return std::make_shared<sir::Offset>(offsetProto.name(), makeLocation(offsetProto));
+}
+
+static std::shared_ptr<sir::Interval> makeInterval(const sir::proto::Interval& intervalProto) {
+  int lowerLevel = -1, upperLevel = -1, lowerOffset = -1, upperOffset = -1;
+
+  if(intervalProto.LowerLevel_case() == sir::proto::Interval::kSpecialLowerLevel)
+    lowerLevel = intervalProto.special_lower_level() ==
+                         sir::proto::Interval_SpecialLevel::Interval_SpecialLevel_Start
+                     ? sir::Interval::Start
+                     : sir::Interval::End;
+  else
+    lowerLevel = intervalProto.lower_level();
+
+  if(intervalProto.UpperLevel_case() == sir::proto::Interval::kSpecialUpperLevel)
+    upperLevel = intervalProto.special_upper_level() ==
+                         sir::proto::Interval_SpecialLevel::Interval_SpecialLevel_Start
+                     ? sir::Interval::Start
+                     : sir::Interval::End;
+  else
+    upperLevel = intervalProto.upper_level();
+
+  lowerOffset = intervalProto.lower_offset();
+  upperOffset = intervalProto.upper_offset();
+  return std::make_shared<sir::Interval>(lowerLevel, upperLevel, lowerOffset, upperOffset);
+}
+
+static std::shared_ptr<sir::VerticalRegion>
+makeVerticalRegion(const sir::proto::VerticalRegion& verticalRegionProto) {
+  // VerticalRegion.Loc
+  auto loc = makeLocation(verticalRegionProto);
+
+  // VerticalRegion.Ast
+  auto ast = makeAST(verticalRegionProto.ast());
+
+  // VerticalRegion.VerticalInterval
+  auto interval = makeInterval(verticalRegionProto.interval());
+
+  // VerticalRegion.LoopOrder
+  auto loopOrder = verticalRegionProto.loop_order() == sir::proto::VerticalRegion::Backward
+                       ? sir::VerticalRegion::LK_Backward
+                       : sir::VerticalRegion::LK_Forward;
+
+  return std::make_shared<sir::VerticalRegion>(ast, interval, loopOrder, loc);
+}
+
+static std::shared_ptr<sir::StencilCall>
+makeStencilCall(const sir::proto::StencilCall& stencilCallProto) {
+  auto stencilCall =
+      std::make_shared<sir::StencilCall>(stencilCallProto.callee(), makeLocation(stencilCallProto));
+
+  for(const auto& arg : stencilCallProto.arguments())
+    stencilCall->Args.emplace_back(makeField(arg));
+
+  return stencilCall;
+}
+
+std::shared_ptr<Expr> makeExpr(const sir::proto::Expr& expressionProto) {
+  switch(expressionProto.expr_case()) {
+  case sir::proto::Expr::kUnaryOperator: {
+    const auto& exprProto = expressionProto.unary_operator();
+    return std::make_shared<UnaryOperator>(makeExpr(exprProto.operand()), exprProto.op(),
+                                           makeLocation(exprProto));
+  }
+  case sir::proto::Expr::kBinaryOperator: {
+    const auto& exprProto = expressionProto.binary_operator();
+    return std::make_shared<BinaryOperator>(makeExpr(exprProto.left()), exprProto.op(),
+                                            makeExpr(exprProto.right()), makeLocation(exprProto));
+  }
+  case sir::proto::Expr::kAssignmentExpr: {
+    const auto& exprProto = expressionProto.assignment_expr();
+    return std::make_shared<AssignmentExpr>(makeExpr(exprProto.left()), makeExpr(exprProto.right()),
+                                            exprProto.op(), makeLocation(exprProto));
+  }
+  case sir::proto::Expr::kTernaryOperator: {
+    const auto& exprProto = expressionProto.ternary_operator();
+    return std::make_shared<TernaryOperator>(makeExpr(exprProto.cond()), makeExpr(exprProto.left()),
+                                             makeExpr(exprProto.right()), makeLocation(exprProto));
+  }
+  case sir::proto::Expr::kFunCallExpr: {
+    const auto& exprProto = expressionProto.fun_call_expr();
+    auto expr = std::make_shared<FunCallExpr>(exprProto.callee(), makeLocation(exprProto));
+    for(const auto& argProto : exprProto.arguments())
+      expr->insertArgument(makeExpr(argProto));
+    return expr;
+  }
+  case sir::proto::Expr::kStencilFunCallExpr: {
+    const auto& exprProto = expressionProto.stencil_fun_call_expr();
+    auto expr = std::make_shared<StencilFunCallExpr>(exprProto.callee(), makeLocation(exprProto));
+    for(const auto& argProto : exprProto.arguments())
+      expr->insertArgument(makeExpr(argProto));
+    return expr;
+  }
+  case sir::proto::Expr::kStencilFunArgExpr: {
+    const auto& exprProto = expressionProto.stencil_fun_arg_expr();
+    int direction = -1, offset = 0, argumentIndex = -1; // default values
+
+    if(exprProto.has_dimension()) {
+      switch(exprProto.dimension().direction()) {
+      case sir::proto::Dimension_Direction_I:
+        direction = 0;
+        break;
+      case sir::proto::Dimension_Direction_J:
+        direction = 1;
+        break;
+      case sir::proto::Dimension_Direction_K:
+        direction = 2;
+        break;
+      case sir::proto::Dimension_Direction_Invalid:
+      default:
+        direction = -1;
+        break;
+      }
+    }
+    offset = exprProto.offset();
+    argumentIndex = exprProto.argument_index();
+    return std::make_shared<StencilFunArgExpr>(direction, offset, argumentIndex,
+                                               makeLocation(exprProto));
+  }
+  case sir::proto::Expr::kVarAccessExpr: {
+    const auto& exprProto = expressionProto.var_access_expr();
+    auto expr = std::make_shared<VarAccessExpr>(
+        exprProto.name(), exprProto.has_index() ? makeExpr(exprProto.index()) : nullptr,
+        makeLocation(exprProto));
+    expr->setIsExternal(exprProto.is_external());
+    return expr;
+  }
+  case sir::proto::Expr::kFieldAccessExpr: {
+    const auto& exprProto = expressionProto.field_access_expr();
+    auto name = exprProto.name();
+    auto negateOffset = exprProto.negate_offset();
+
+    auto throwException = [&exprProto](const char* member) {
+      throw std::runtime_error(format("FieldAccessExpr::%s (loc %s) exceeds 3 dimensions", member,
+                                      makeLocation(exprProto)));
+    };
+
+    Array3i offset{{0, 0, 0}};
+    if(!exprProto.offset().empty()) {
+      if(exprProto.offset().size() > 3)
+        throwException("offset");
+
+      std::copy(exprProto.offset().begin(), exprProto.offset().end(), offset.begin());
+    }
+
+    Array3i argumentOffset{{0, 0, 0}};
+    if(!exprProto.argument_offset().empty()) {
+      if(exprProto.argument_offset().size() > 3)
+        throwException("argument_offset");
+
+      std::copy(exprProto.argument_offset().begin(), exprProto.argument_offset().end(),
+                argumentOffset.begin());
+    }
+
+    Array3i argumentMap{{-1, -1, -1}};
+    if(!exprProto.argument_map().empty()) {
+      if(exprProto.argument_map().size() > 3)
+        throwException("argument_map");
+
+      std::copy(exprProto.argument_map().begin(), exprProto.argument_map().end(),
+                argumentMap.begin());
+    }
+
+    return std::make_shared<FieldAccessExpr>(name, offset, argumentMap, argumentOffset,
+                                             negateOffset, makeLocation(exprProto));
+  }
+  case sir::proto::Expr::kLiteralAccessExpr: {
+    const auto& exprProto = expressionProto.literal_access_expr();
+    return std::make_shared<LiteralAccessExpr>(
+        exprProto.value(), makeBuiltinTypeID(exprProto.type()), makeLocation(exprProto));
+  }
+  case sir::proto::Expr::EXPR_NOT_SET:
+  default:
+    dawn_unreachable("expr not set");
+  }
+  return nullptr;
+}
+
+std::shared_ptr<Stmt> makeStmt(const sir::proto::Stmt& statementProto) {
+  switch(statementProto.stmt_case()) {
+  case sir::proto::Stmt::kBlockStmt: {
+    const auto& stmtProto = statementProto.block_stmt();
+    auto stmt = std::make_shared<BlockStmt>(makeLocation(stmtProto));
+
+    for(const auto& s : stmtProto.statements())
+      stmt->push_back(makeStmt(s));
+
+    return stmt;
+  }
+  case sir::proto::Stmt::kExprStmt: {
+    const auto& stmtProto = statementProto.expr_stmt();
+    return std::make_shared<ExprStmt>(makeExpr(stmtProto.expr()), makeLocation(stmtProto));
+  }
+  case sir::proto::Stmt::kReturnStmt: {
+    const auto& stmtProto = statementProto.return_stmt();
+    return std::make_shared<ReturnStmt>(makeExpr(stmtProto.expr()), makeLocation(stmtProto));
+  }
+  case sir::proto::Stmt::kVarDeclStmt: {
+    const auto& stmtProto = statementProto.var_decl_stmt();
+
+    std::vector<std::shared_ptr<Expr>> initList;
+    for(const auto& e : stmtProto.init_list())
+      initList.emplace_back(makeExpr(e));
+
+    const sir::proto::Type& typeProto = stmtProto.type();
+    CVQualifier cvQual = CVQualifier::Invalid;
+    if(typeProto.is_const())
+      cvQual |= CVQualifier::Const;
+    if(typeProto.is_volatile())
+      cvQual |= CVQualifier::Volatile;
+    Type type = typeProto.name().empty() ? Type(makeBuiltinTypeID(typeProto.builtin_type()), cvQual)
+                                         : Type(typeProto.name(), cvQual);
+
+    return std::make_shared<VarDeclStmt>(type, stmtProto.name(), stmtProto.dimension(),
+                                         stmtProto.op().c_str(), initList, makeLocation(stmtProto));
+  }
+  case sir::proto::Stmt::kStencilCallDeclStmt: {
+    const auto& stmtProto = statementProto.stencil_call_decl_stmt();
+    return std::make_shared<StencilCallDeclStmt>(makeStencilCall(stmtProto.stencil_call()),
+                                                 makeLocation(stmtProto));
+  }
+  case sir::proto::Stmt::kVerticalRegionDeclStmt: {
+    const auto& stmtProto = statementProto.vertical_region_decl_stmt();
+    return std::make_shared<VerticalRegionDeclStmt>(makeVerticalRegion(stmtProto.vertical_region()),
+                                                    makeLocation(stmtProto));
+  }
+  case sir::proto::Stmt::kBoundaryConditionDeclStmt: {
+    const auto& stmtProto = statementProto.boundary_condition_decl_stmt();
+    auto stmt =
+        std::make_shared<BoundaryConditionDeclStmt>(stmtProto.functor(), makeLocation(stmtProto));
+    for(const auto& fieldProto : stmtProto.fields())
+      stmt->getFields().emplace_back(makeField(fieldProto));
+    return stmt;
+  }
+  case sir::proto::Stmt::kIfStmt: {
+    const auto& stmtProto = statementProto.if_stmt();
+    return std::make_shared<IfStmt>(
+        makeStmt(stmtProto.cond_part()), makeStmt(stmtProto.then_part()),
+        stmtProto.has_else_part() ? makeStmt(stmtProto.else_part()) : nullptr,
+        makeLocation(stmtProto));
+  }
+  case sir::proto::Stmt::STMT_NOT_SET:
+  default:
+    dawn_unreachable("stmt not set");
+  }
+  return nullptr;
+}
+
+std::shared_ptr<AST> makeAST(const sir::proto::AST& astProto) {
+  auto ast = std::make_shared<AST>();
+  auto root = dyn_pointer_cast<BlockStmt>(makeStmt(astProto.root()));
+  if(!root)
+    throw std::runtime_error("root statement of AST is not a 'BlockStmt'");
+  ast->setRoot(root);
+  return ast;
+}
+
+std::shared_ptr<sir::StencilFunction>
+makeStencilFunction(const sir::proto::StencilFunction& stencilFunctionProto) {
+  using namespace sir;
+  std::shared_ptr<StencilFunction> stencilFunction = std::make_shared<StencilFunction>();
+
+  // StencilFunction.Name
+  stencilFunction->Name = stencilFunctionProto.name();
+
+  // Stencil.Loc
+  stencilFunction->Loc = makeLocation(stencilFunctionProto);
+
+  // StencilFunction.Args
+  for(const sir::proto::StencilFunctionArg& sirArg : stencilFunctionProto.arguments()) {
+    switch(sirArg.Arg_case()) {
+    case sir::proto::StencilFunctionArg::kFieldValue:
+      stencilFunction->Args.emplace_back(makeField(sirArg.field_value()));
+      break;
+    case sir::proto::StencilFunctionArg::kDirectionValue:
+      stencilFunction->Args.emplace_back(makeDirection(sirArg.direction_value()));
+      break;
+    case sir::proto::StencilFunctionArg::kOffsetValue:
+      stencilFunction->Args.emplace_back(makeOffset(sirArg.offset_value()));
+      break;
+    case sir::proto::StencilFunctionArg::ARG_NOT_SET:
+    default:
+      dawn_unreachable("argument not set");
+    }
+  }
+
+  // StencilFunction.Intervals
+  for(const sir::proto::Interval& sirInterval : stencilFunctionProto.intervals())
+    stencilFunction->Intervals.emplace_back(makeInterval(sirInterval));
+
+  // StencilFunction.Asts
+  for(const sir::proto::AST& sirAst : stencilFunctionProto.asts())
+    stencilFunction->Asts.emplace_back(makeAST(sirAst));
+
+  return stencilFunction;
+}
+
+void makeGlobalVariableMap(sir::GlobalVariableMap* globalVariableMap,
+                           const sir::proto::GlobalVariableMap& mapProto) {
+  for(const auto& nameValuePair : mapProto.map()) {
+    const std::string& sirName = nameValuePair.first;
+    const sir::proto::GlobalVariableValue& sirValue = nameValuePair.second;
+    std::shared_ptr<sir::Value> value = nullptr;
+
+    switch(sirValue.Value_case()) {
+    case sir::proto::GlobalVariableValue::kBooleanValue:
+      value = std::make_shared<sir::Value>(static_cast<bool>(sirValue.boolean_value()));
+      break;
+    case sir::proto::GlobalVariableValue::kIntegerValue:
+      value = std::make_shared<sir::Value>(static_cast<int>(sirValue.integer_value()));
+      break;
+    case sir::proto::GlobalVariableValue::kDoubleValue:
+      value = std::make_shared<sir::Value>(static_cast<double>(sirValue.double_value()));
+      break;
+    case sir::proto::GlobalVariableValue::kStringValue:
+      value = std::make_shared<sir::Value>(static_cast<std::string>(sirValue.string_value()));
+      break;
+    case sir::proto::GlobalVariableValue::VALUE_NOT_SET:
+    default:
+      dawn_unreachable("value not set");
+    }
+
+    value->setIsConstexpr(sirValue.is_constexpr());
+    globalVariableMap->emplace(sirName, std::move(value));
+  }
+}
+
+std::shared_ptr<sir::Stencil> makeStencil(const sir::proto::Stencil& stencilProto) {
+  std::shared_ptr<sir::Stencil> stencil = std::make_shared<sir::Stencil>();
+
+  // Stencil.Name
+  stencil->Name = stencilProto.name();
+
+  // Stencil.Loc
+  stencil->Loc = makeLocation(stencilProto);
+
+  // Stencil.StencilDescAst
+  stencil->StencilDescAst = makeAST(stencilProto.ast());
+
+  // Stencil.Fields
+  for(const sir::proto::Field& fieldProto : stencilProto.fields())
+    stencil->Fields.emplace_back(makeField(fieldProto));
+
+  return stencil;
+}
+
+std::shared_ptr<SIR> makeSIR(const sir::proto::SIR& sirProto) {
+  using namespace sir;
+  std::shared_ptr<SIR> sir = std::make_shared<SIR>();
+
+  // SIR.Filename
+  sir->Filename = sirProto.filename();
+
+  // SIR.Stencils
+  for(const sir::proto::Stencil& stencilProto : sirProto.stencils())
+    sir->Stencils.emplace_back(makeStencil(stencilProto));
+
+  // SIR.StencilFunctions
+  for(const sir::proto::StencilFunction& stencilFunctionProto : sirProto.stencil_functions())
+    sir->StencilFunctions.emplace_back(makeStencilFunction(stencilFunctionProto));
+
+  // SIR.GlobalVariableMap
+  makeGlobalVariableMap(sir->GlobalVariableMap.get(), sirProto.global_variables());
+
+  return sir;
+}
+
+} // namespace dawn
@@ -0,0 +1,101 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#ifndef DAWN_SIR_SIRPROTO_H
+#define DAWN_SIR_SIRPROTO_H
+
+#include "dawn/SIR/AST.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/SIR/SIR.pb.h"
+#include "dawn/Support/NonCopyable.h"
+#include "dawn/Support/SourceLocation.h"
+#include <google/protobuf/stubs/common.h>
+#include <list>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace dawn {
+
+/// @brief Singleton logger of Protobuf
+///
+/// Forwards the messages of Protobuf to the Dawn logger and caches them s.t they can be attached
+/// to the exceptions thrown by the serializers. The messages are cached per thread, i.e the
+/// serializers can be run concurrently.
+/// @ingroup sir
+class ProtobufLogger : public NonCopyable {
+public:
+  using LogMessage = std::tuple<google::protobuf::LogLevel, std::string, int, std::string>;
+
+  /// @brief Protobufs internal logging handler
+  static void LogHandler(google::protobuf::LogLevel level, const char* filename, int line,
+                         const std::string& message);
+
+  /// @brief Push a `message` to the logging stack of the calling thread
+  void push(LogMessage message) { logStack_.emplace_back(std::move(message)); }
+
+  /// @brief Get a dump of all error messages of the calling thread (in the order of occurence) and
+  /// reset its logging stack
+  std::string getErrorMessagesAndReset();
+
+  /// @brief Initialize and register the Logger (thread-safe, only the first call has an effect)
+  static void init();
+
+  /// @brief Get the singleton instance of the logger
+  static ProtobufLogger& getInstance() noexcept { return *instance_; }
+
+private:
+  static thread_local std::list<LogMessage> logStack_;
+
+  static ProtobufLogger* instance_;
+};
+
+/// @name Conversion of the SIR to its protobuf representation
+/// @ingroup sir
+/// @{
+extern void setLocation(sir::proto::SourceLocation* locProto, const SourceLocation& loc);
+extern void setStmt(sir::proto::Stmt* stmtProto, const std::shared_ptr<Stmt>& stmt);
+extern void setExpr(sir::proto::Expr* exprProto, const std::shared_ptr<Expr>& expr);
+extern void setAST(sir::proto::AST* astProto, const AST* ast);
+extern void setStencilFunction(sir::proto::StencilFunction* stencilFunctionProto,
+                               const sir::StencilFunction* stencilFunction);
+extern void setStencil(sir::proto::Stencil* stencilProto, const sir::Stencil* stencil);
+extern void setSIR(sir::proto::SIR* sirProto, const SIR* sir);
+/// @}
+
+/// @name Conversion of the protobuf representation to the SIR
+///
+/// Malformed messages are reported by throwing `std::runtime_error`.
+/// @ingroup sir
+/// @{
+template <class T>
+SourceLocation makeLocation(const T& proto) {
+  return proto.has_loc() ? SourceLocation(proto.loc().line(), proto.loc().column())
+                         : SourceLocation{};
+}
+extern std::shared_ptr<Stmt> makeStmt(const sir::proto::Stmt& statementProto);
+extern std::shared_ptr<Expr> makeExpr(const sir::proto::Expr& expressionProto);
+extern std::shared_ptr<AST> makeAST(const sir::proto::AST& astProto);
+extern std::shared_ptr<sir::StencilFunction>
+makeStencilFunction(const sir::proto::StencilFunction& stencilFunctionProto);
+extern void makeGlobalVariableMap(sir::GlobalVariableMap* globalVariableMap,
+                                  const sir::proto::GlobalVariableMap& mapProto);
+extern std::shared_ptr<sir::Stencil> makeStencil(const sir::proto::Stencil& stencilProto);
+extern std::shared_ptr<SIR> makeSIR(const sir::proto::SIR& sirProto);
+/// @}
+
+} // namespace dawn
+
+#endif
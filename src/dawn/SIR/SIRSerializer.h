@@ -15,6 +15,7 @@
 #ifndef DAWN_SIR_SIRSERIALIZER_H
 #define DAWN_SIR_SIRSERIALIZER_H
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -36,6 +37,9 @@ public:
 
   /// @brief Deserialize the SIR from `file`
   ///
+  /// The file is mapped into memory and byte encoded SIRs are parsed directly from the mapping
+  /// (i.e the content of the file is never copied into an intermediate string).
+  ///
   /// @param file   Path the file
   /// @param kind   The kind of serialization used in `file` (Json or Byte)
   /// @throws std::excetpion    Failed to deserialize
@@ -52,6 +56,46 @@ public:
   static std::shared_ptr<SIR> deserializeFromString(const std::string& str,
                                                     SerializationKind kind = SK_Json);
 
+  /// @brief Deserialize the SIR from the buffer `[data, data + size)` without copying it
+  ///
+  /// @param data   Pointer to the Byte or JSON encoded SIR
+  /// @param size   Size of the buffer in bytes
+  /// @param kind   The kind of serialization used in `data` (Json or Byte)
+  /// @throws std::excetpion    Failed to deserialize
+  /// @returns newly allocated SIR on success or `NULL`
+  static std::shared_ptr<SIR> deserializeFromBuffer(const char* data, std::size_t size,
+                                                    SerializationKind kind = SK_Json);
+
+  /// @brief Lazily deserialize the SIR from `file`
+  ///
+  /// Only the filename and the global variables are deserialized up front. The stencils and
+  /// stencil functions are indexed by name and materialized on first access via
+  /// `SIR::getStencil` and `SIR::getStencilFunction` (`SIR::materialize` materializes all of them).
+  /// For Byte encoded SIRs, the file stays mapped until the SIR is destroyed or materialized and
+  /// only the requested stencils and stencil functions are decoded.
+  ///
+  /// @param file   Path the file
+  /// @param kind   The kind of serialization used in `file` (Json or Byte)
+  /// @throws std::excetpion    Failed to deserialize
+  /// @returns newly allocated SIR on success
+  static std::shared_ptr<SIR> deserializeLazy(const std::string& file,
+                                              SerializationKind kind = SK_Json);
+
+  /// @brief Lazily deserialize the SIR from the Byte or JSON formatted `str` (see
+  /// `deserializeLazy`)
+  static std::shared_ptr<SIR> deserializeLazyFromString(std::string str,
+                                                        SerializationKind kind = SK_Json);
+
+  /// @brief Lazily deserialize the SIR from the buffer `[data, data + size)` (see
+  /// `deserializeLazy`)
+  ///
+  /// The buffer is not copied: Byte encoded stencils and stencil functions are decoded from it
+  /// when they are first accessed, hence the buffer has to stay valid until the SIR is destroyed
+  /// or materialized (see `SIR::materialize`). Use `deserializeLazyFromString` to hand over the
+  /// ownership of the serialized SIR instead.
+  static std::shared_ptr<SIR> deserializeLazyFromBuffer(const char* data, std::size_t size,
+                                                        SerializationKind kind = SK_Json);
+
   /// @brief Serialize the SIR as a Json or Byte formatted string to `file`
   ///
   /// @param file   Path the file
@@ -24,7 +24,8 @@ StringRef getFilenameWithoutExtension(StringRef path) {
 }
 
 StringRef getExtension(StringRef filename) {
-  return filename.substr(filename.find_last_of(".") - 1);
+  auto pos = filename.find_last_of('.');
+  return pos == StringRef::npos ? StringRef() : filename.substr(pos + 1);
 }
 
 } // namespace dawn
@@ -14,54 +14,53 @@
 
 #include "dawn/Support/Logging.h"
 #include "dawn/Support/Assert.h"
+#include <utility>
 
 namespace dawn {
 
-internal::LoggerProxy::LoggerProxy(LoggingLevel level, std::stringstream& ss, const char* file,
-                                   int line)
-    : level_(level), ss_(ss), file_(file), line_(line) {}
+internal::LoggerProxy::LoggerProxy(LoggingLevel level, const char* file, int line)
+    : level_(level), file_(file), line_(line), active_(true) {}
 
-internal::LoggerProxy::~LoggerProxy() {
-  Logger::getSingleton().log(level_, ss_.get().str(), file_, line_);
-  ss_.get().str("");
-  ss_.get().clear();
+internal::LoggerProxy::LoggerProxy(LoggerProxy&& other)
+    : level_(other.level_), ss_(std::move(other.ss_)), file_(other.file_), line_(other.line_),
+      active_(other.active_) {
+  other.active_ = false;
 }
 
-Logger* Logger::instance_ = nullptr;
+internal::LoggerProxy::~LoggerProxy() {
+  if(active_)
+    Logger::getSingleton().log(level_, ss_.str(), file_, line_);
+}
 
-Logger::Logger() : logger_(nullptr) {}
+Logger::Logger() : logger_(nullptr), level_(static_cast<int>(LoggingLevel::Info)) {}
 
-void Logger::registerLogger(LoggerInterface* logger) { logger_ = logger; }
+void Logger::registerLogger(LoggerInterface* logger) { logger_.store(logger); }
 
-LoggerInterface* Logger::getLogger() { return logger_; }
+LoggerInterface* Logger::getLogger() { return logger_.load(); }
 
 internal::LoggerProxy Logger::logInfo(const char* file, int line) {
-  return internal::LoggerProxy(LoggingLevel::Info, ss_, file, line);
+  return internal::LoggerProxy(LoggingLevel::Info, file, line);
 }
 
 internal::LoggerProxy Logger::logWarning(const char* file, int line) {
-  return internal::LoggerProxy(LoggingLevel::Warning, ss_, file, line);
+  return internal::LoggerProxy(LoggingLevel::Warning, file, line);
 }
 
 internal::LoggerProxy Logger::logError(const char* file, int line) {
-  return internal::LoggerProxy(LoggingLevel::Error, ss_, file, line);
+  return internal::LoggerProxy(LoggingLevel::Error, file, line);
 }
 
 internal::LoggerProxy Logger::logFatal(const char* file, int line) {
-  return internal::LoggerProxy(LoggingLevel::Fatal, ss_, file, line);
+  return internal::LoggerProxy(LoggingLevel::Fatal, file, line);
 }
 
 void Logger::log(LoggingLevel level, const std::string& message, const char* file, int line) {
-  if(logger_ != nullptr) {
-    logger_->log(level, message, file, line);
-  }
-}
+  if(!isEnabled(level))
+    return;
 
-Logger& Logger::getSingleton() {
-  if(instance_ == nullptr) {
-    instance_ = new Logger;
-  }
-  return *instance_;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if(LoggerInterface* logger = logger_.load())
+    logger->log(level, message, file, line);
 }
 
 } // namespace dawn
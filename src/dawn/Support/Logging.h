@@ -15,7 +15,8 @@
 #ifndef DAWN_SUPPORT_LOGGING_H
 #define DAWN_SUPPORT_LOGGING_H
 
-#include <functional>
+#include <atomic>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -43,25 +44,34 @@ public:
 
 namespace internal {
 
+/// @brief Message under construction, the message is passed to the Logger upon destruction
+///
+/// Each proxy formats into its own stream, hence messages of different threads do not interleave.
 class LoggerProxy {
   LoggingLevel level_;
-  std::reference_wrapper<std::stringstream> ss_;
+  std::ostringstream ss_;
   const char* file_;
   int line_;
+  bool active_;
 
 public:
-  LoggerProxy(const LoggerProxy&) = default;
-  LoggerProxy(LoggingLevel level, std::stringstream& ss, const char* file, int line);
+  LoggerProxy(LoggingLevel level, const char* file, int line);
+  LoggerProxy(LoggerProxy&& other);
 
   ~LoggerProxy();
 
   template <class StreamableValueType>
   LoggerProxy& operator<<(StreamableValueType&& value) {
-    ss_.get() << value;
+    ss_ << value;
     return *this;
   }
 };
 
+/// @brief Turn the streaming expression of `DAWN_LOG` into a `void` expression
+struct LoggerVoidify {
+  void operator&(const LoggerProxy&) {}
+};
+
 } // namespace internal
 
 /// @brief DAWN Logger adapter
@@ -70,6 +80,11 @@ public:
 /// Logger via `registerLogger`. The registered Logger has to implement the `LoggerInterface`.
 /// By default no Logger is registered and no logging is performed.
 ///
+/// Messages below the logging level (see `setLevel`) are discarded. `DAWN_LOG` checks the level
+/// and the presence of a Logger before it evaluates its arguments, i.e a disabled log statement
+/// neither formats nor allocates anything. All methods may be called concurrently, the registered
+/// Logger is never called concurrently.
+///
 /// The following snippet can be seen as a minimal working example:
 ///
 /// @code
@@ -85,8 +100,10 @@ public:
 ///   int main() {
 ///     myLogger = new MyLogger;
 ///     dawn::Logger::getSingleton().registerLogger(myLogger);
+///     dawn::Logger::getSingleton().setLevel(dawn::LoggingLevel::Warning);
 ///
-///     DAWN_LOG(INFO) << "Hello world!";
+///     DAWN_LOG(INFO) << "Hello world!";    // Discarded
+///     DAWN_LOG(WARNING) << "Hello world!"; // Logged
 ///
 ///     delete myLogger;
 ///   }
@@ -94,9 +111,9 @@ public:
 ///
 /// @ingroup support
 class Logger {
-  static Logger* instance_;
-  LoggerInterface* logger_;
-  std::stringstream ss_;
+  std::atomic<LoggerInterface*> logger_;
+  std::atomic<int> level_;
+  std::mutex mutex_;
 
 public:
   /// @brief Initialize Logger object
@@ -108,6 +125,16 @@ public:
   /// @brief Get the current logger or NULL if no logger is currently registered
   LoggerInterface* getLogger();
 
+  /// @brief Get/Set the minimum severity of the messages which are logged (`Info` by default)
+  LoggingLevel getLevel() const { return static_cast<LoggingLevel>(level_.load()); }
+  void setLevel(LoggingLevel level) { level_.store(static_cast<int>(level)); }
+
+  /// @brief Check if a message of severity `level` would be logged
+  bool isEnabled(LoggingLevel level) const {
+    return static_cast<int>(level) >= level_.load(std::memory_order_relaxed) &&
+           logger_.load(std::memory_order_relaxed) != nullptr;
+  }
+
   /// @name Start logging
   /// @{
   internal::LoggerProxy logInfo(const char* file, int line);
@@ -120,13 +147,32 @@ public:
   void log(LoggingLevel level, const std::string& message, const char* file, int line);
 
   /// @brief Get singleton instance
-  static Logger& getSingleton();
+  static Logger& getSingleton() {
+    static Logger instance;
+    return instance;
+  }
 };
 
 /// @macro DAWN_LOG
 /// @brief Loggging macros
+///
+/// The streamed values are only evaluated if the message is logged (see `Logger::isEnabled`).
 /// @ingroup support
-#define DAWN_LOG(Level) DAWN_LOG_##Level##_IMPL()
+#define DAWN_LOG(Level)                                                                            \
+  !dawn::Logger::getSingleton().isEnabled(DAWN_LOG_##Level##_LEVEL)                                \
+      ? (void)0                                                                                    \
+      : dawn::internal::LoggerVoidify() & DAWN_LOG_##Level##_IMPL()
+
+/// @macro DAWN_LOG_IS_ON
+/// @brief Check if messages of the given level are logged (to guard code which only prepares log
+/// messages)
+/// @ingroup support
+#define DAWN_LOG_IS_ON(Level) dawn::Logger::getSingleton().isEnabled(DAWN_LOG_##Level##_LEVEL)
+
+#define DAWN_LOG_INFO_LEVEL dawn::LoggingLevel::Info
+#define DAWN_LOG_WARNING_LEVEL dawn::LoggingLevel::Warning
+#define DAWN_LOG_ERROR_LEVEL dawn::LoggingLevel::Error
+#define DAWN_LOG_FATAL_LEVEL dawn::LoggingLevel::Fatal
 
 #define DAWN_LOG_INFO_IMPL() dawn::Logger::getSingleton().logInfo(__FILE__, __LINE__)
 #define DAWN_LOG_WARNING_IMPL() dawn::Logger::getSingleton().logWarning(__FILE__, __LINE__)
@@ -0,0 +1,78 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/MappedFile.h"
+#include "dawn/Support/Format.h"
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DAWN_MAPPEDFILE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dawn {
+
+MappedFile::MappedFile(const std::string& path) : data_(nullptr), size_(0), isMapped_(false) {
+#ifdef DAWN_MAPPEDFILE_USE_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd == -1)
+    throw std::runtime_error(format("failed to open file \"%s\"", path));
+
+  struct stat st;
+  if(::fstat(fd, &st) == -1) {
+    ::close(fd);
+    throw std::runtime_error(format("failed to stat file \"%s\"", path));
+  }
+
+  size_ = static_cast<std::size_t>(st.st_size);
+
+  // Mapping an empty file is an error, we simply leave the buffer empty
+  if(size_ != 0) {
+    void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(addr == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error(format("failed to map file \"%s\"", path));
+    }
+    // The file is read front to back exactly once
+    ::madvise(addr, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(addr);
+    isMapped_ = true;
+  }
+
+  // The mapping stays valid after closing the file descriptor
+  ::close(fd);
+#else
+  std::ifstream ifs(path, std::ios::binary);
+  if(!ifs.is_open())
+    throw std::runtime_error(format("failed to open file \"%s\"", path));
+
+  buffer_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef DAWN_MAPPEDFILE_USE_MMAP
+  if(isMapped_)
+    ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+} // namespace dawn
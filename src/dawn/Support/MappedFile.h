@@ -0,0 +1,59 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_SUPPORT_MAPPEDFILE_H
+#define DAWN_SUPPORT_MAPPEDFILE_H
+
+#include "dawn/Support/NonCopyable.h"
+#include "dawn/Support/StringRef.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace dawn {
+
+/// @brief Read-only view of the content of a file
+///
+/// On UNIX like platforms the file is mapped into memory (`mmap`) which avoids copying the content
+/// into a user-space buffer. On all other platforms the file is read into an internal buffer.
+///
+/// @ingroup support
+class MappedFile : NonCopyable {
+  const char* data_;
+  std::size_t size_;
+  bool isMapped_;
+  std::vector<char> buffer_;
+
+public:
+  /// @brief Map the file `path` into memory
+  /// @throws std::runtime_error  Failed to open or map `path`
+  MappedFile(const std::string& path);
+  ~MappedFile();
+
+  /// @brief Get a pointer to the beginning of the content
+  const char* data() const { return data_; }
+
+  /// @brief Get the size of the content in bytes
+  std::size_t size() const { return size_; }
+
+  /// @brief Check if the content is backed by a memory mapping
+  bool isMapped() const { return isMapped_; }
+
+  /// @brief Get the content as a `StringRef`
+  StringRef getBuffer() const { return StringRef(data_, size_); }
+};
+
+} // namespace dawn
+
+#endif
@@ -0,0 +1,50 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/ResourceUsage.h"
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DAWN_RESOURCEUSAGE_USE_RUSAGE 1
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace dawn {
+
+std::size_t getResidentSetSizeInKB() {
+#if defined(__linux__)
+  // Second entry of statm is the number of resident pages
+  std::ifstream statm("/proc/self/statm");
+  std::size_t size = 0, resident = 0;
+  if(statm >> size >> resident)
+    return resident * (::sysconf(_SC_PAGESIZE) / 1024);
+#endif
+  return 0;
+}
+
+std::size_t getPeakResidentSetSizeInKB() {
+#ifdef DAWN_RESOURCEUSAGE_USE_RUSAGE
+  struct rusage usage;
+  if(::getrusage(RUSAGE_SELF, &usage) == 0)
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+  return 0;
+}
+
+} // namespace dawn
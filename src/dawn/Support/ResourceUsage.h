@@ -0,0 +1,35 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_SUPPORT_RESOURCEUSAGE_H
+#define DAWN_SUPPORT_RESOURCEUSAGE_H
+
+#include <cstddef>
+
+namespace dawn {
+
+/// @ingroup support
+/// @{
+
+/// @brief Get the current resident set size of the process in KB (0 if it cannot be determined)
+extern std::size_t getResidentSetSizeInKB();
+
+/// @brief Get the peak resident set size of the process in KB (0 if it cannot be determined)
+extern std::size_t getPeakResidentSetSizeInKB();
+
+/// @}
+
+} // namespace dawn
+
+#endif
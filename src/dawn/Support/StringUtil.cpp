@@ -13,6 +13,8 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn/Support/StringUtil.h"
+#include "dawn/Support/SmallVector.h"
+#include "dawn/Support/StringRef.h"
 #include <sstream>
 
 namespace dawn {
@@ -58,4 +60,15 @@ std::string indent(const std::string& string, int amount) {
   return oss.str();
 }
 
+std::vector<std::string> splitList(const std::string& list, char separator) {
+  SmallVector<StringRef, 8> values;
+  StringRef(list).split(values, separator, -1, false);
+
+  std::vector<std::string> result;
+  for(StringRef value : values)
+    if(!(value = value.trim()).empty())
+      result.push_back(value.str());
+  return result;
+}
+
 } // namespace dawn
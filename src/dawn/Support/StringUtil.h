@@ -21,6 +21,7 @@
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace dawn {
 
@@ -120,6 +121,17 @@ extern std::string indent(const std::string& string, int amount = 2);
 /// @ingroup support
 extern std::string decimalToOrdinal(int dec);
 
+/// @brief Split a list of values separated by `separator` (surrounding whitespace and empty values
+/// are removed)
+///
+/// @b Example
+/// @code
+///   auto values = splitList("a, b,,c", ','); // == {"a", "b", "c"}
+/// @endcode
+///
+/// @ingroup support
+extern std::vector<std::string> splitList(const std::string& list, char separator = ',');
+
 /// @}
 
 } // namespace dawn
@@ -0,0 +1,75 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_SUPPORT_THREADPOOL_H
+#define DAWN_SUPPORT_THREADPOOL_H
+
+#include "dawn/Support/NonCopyable.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace dawn {
+
+/// @brief Fixed number of worker threads executing tasks in the order they were submitted
+///
+/// Tasks must not wait for tasks submitted after them (they might be queued behind them).
+/// @ingroup support
+class ThreadPool : NonCopyable {
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stop_;
+
+public:
+  /// @brief Start `numThreads` workers (or one per hardware thread if `numThreads` is 0)
+  explicit ThreadPool(unsigned numThreads = 0);
+
+  /// @brief Finish all pending tasks and join the workers
+  ~ThreadPool();
+
+  /// @brief Enqueue `task`
+  void enqueue(std::function<void()> task);
+
+  /// @brief Enqueue `function` and get a future of its result
+  template <class FunctionType>
+  std::future<typename std::result_of<FunctionType()>::type> submit(FunctionType&& function) {
+    using ResultType = typename std::result_of<FunctionType()>::type;
+    auto task =
+        std::make_shared<std::packaged_task<ResultType()>>(std::forward<FunctionType>(function));
+    std::future<ResultType> future = task->get_future();
+    enqueue([task]() { (*task)(); });
+    return future;
+  }
+
+  /// @brief Get the number of workers
+  unsigned getNumThreads() const { return workers_.size(); }
+
+  /// @brief Get the process-wide pool (started on first use with one worker per hardware thread)
+  static ThreadPool& getGlobal();
+
+private:
+  void work();
+};
+
+} // namespace dawn
+
+#endif
@@ -29,6 +29,12 @@ public:
 
   /// @brief Get a unique *strictly* positive identifer
   int get() { return (counter_++); }
+
+  /// @brief Get the identifier which will be returned by the next call to `get()`
+  int peek() const { return counter_; }
+
+  /// @brief Continue generating identifiers starting at `counter`
+  void reset(int counter) { counter_ = counter; }
 };
 
 } // namespace dawn
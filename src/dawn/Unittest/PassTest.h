@@ -0,0 +1,87 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_UNITTEST_PASSTEST_H
+#define DAWN_UNITTEST_PASSTEST_H
+
+#include "dawn/CodeGen/CXXNaive/CXXNaiveCodeGen.h"
+#include "dawn/CodeGen/GridTools/GTCodeGen.h"
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Compiler/Options.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/StatementAccessesPair.h"
+#include "dawn/Optimizer/Stencil.h"
+#include "dawn/Optimizer/StencilInstantiation.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/Support/STLExtras.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dawn {
+
+/// @brief Fixture of the unittests of the optimizer passes
+///
+/// The tests enable the passes under test in `options_` (usually in `SetUp`) and run the optimizer
+/// on a SIR (see `SIRBuilder.h`) with `optimize`. The fixture is header-only as it depends on
+/// gtest, which only the test executables link.
+/// @ingroup unittest
+class PassTest : public ::testing::Test {
+protected:
+  Options options_;
+  std::unique_ptr<DawnCompiler> compiler_;
+  std::unique_ptr<OptimizerContext> context_;
+  std::shared_ptr<StencilInstantiation> instantiation_;
+
+  /// @brief Run the optimizer on `sir` and get the instantiation of the stencil `stencilName`
+  void optimize(const std::shared_ptr<SIR>& sir, const std::string& stencilName = "test") {
+    compiler_ = make_unique<DawnCompiler>(&options_);
+    context_ = compiler_->runOptimizer(sir);
+    ASSERT_TRUE(context_ != nullptr);
+    EXPECT_FALSE(compiler_->getDiagnostics().hasErrors());
+    instantiation_ = context_->getStencilInstantiationMap().at(stencilName);
+  }
+
+  /// @brief Top-level statements of all stencils of the instantiation (in execution order)
+  std::vector<std::shared_ptr<Stmt>> getStatements() const {
+    std::vector<std::shared_ptr<Stmt>> stmts;
+    for(const auto& stencil : instantiation_->getStencils())
+      stencil->forEachStatementAccessesPair(
+          [&](ArrayRef<std::shared_ptr<StatementAccessesPair>> pairs) {
+            for(const auto& pair : pairs)
+              stmts.push_back(pair->getStatement()->ASTStmt);
+          });
+    return stmts;
+  }
+
+  /// @brief Generated code of all stencils of `context` (GridTools and naive C++ backend)
+  static std::string generateCode(OptimizerContext* context) {
+    std::string code;
+    auto append = [&](std::unique_ptr<codegen::TranslationUnit> translationUnit) {
+      for(const auto& nameCodePair : translationUnit->getStencils())
+        code += nameCodePair.second;
+    };
+    append(codegen::gt::GTCodeGen(context).generateCode());
+    append(codegen::cxxnaive::CXXNaiveCodeGen(context).generateCode());
+    return code;
+  }
+
+  /// @brief Generated code of all stencils of the optimized SIR
+  std::string generateCode() const { return generateCode(context_.get()); }
+};
+
+} // namespace dawn
+
+#endif
@@ -0,0 +1,85 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Unittest/SIRBuilder.h"
+#include "dawn/Unittest/ASTSimplifier.h"
+
+namespace dawn {
+
+namespace astgen {
+
+std::shared_ptr<VarAccessExpr> global(const std::string& name) {
+  auto expr = var(name);
+  expr->setIsExternal(true);
+  return expr;
+}
+
+std::shared_ptr<sir::VerticalRegion>
+makeVerticalRegion(const std::vector<std::shared_ptr<Stmt>>& statements, int lowerOffset,
+                   int upperOffset, sir::VerticalRegion::LoopOrderKind loopOrder) {
+  return std::make_shared<sir::VerticalRegion>(
+      std::make_shared<AST>(std::make_shared<BlockStmt>(statements)),
+      std::make_shared<sir::Interval>(sir::Interval::Start, sir::Interval::End, lowerOffset,
+                                      upperOffset),
+      loopOrder);
+}
+
+std::shared_ptr<sir::StencilFunction> makeStencilFunction(const std::string& name,
+                                                          const std::vector<std::string>& args,
+                                                          const std::shared_ptr<BlockStmt>& body) {
+  auto function = std::make_shared<sir::StencilFunction>();
+  function->Name = name;
+  for(const auto& arg : args)
+    function->Args.emplace_back(std::make_shared<sir::Field>(arg));
+  function->Asts.emplace_back(std::make_shared<AST>(body));
+  return function;
+}
+
+std::shared_ptr<BoundaryConditionDeclStmt>
+makeBoundaryCondition(const std::string& functor, const std::vector<std::string>& fields) {
+  auto bc = boundaryCondition(functor);
+  for(const auto& name : fields)
+    bc->getFields().emplace_back(std::make_shared<sir::Field>(name));
+  return bc;
+}
+
+std::shared_ptr<SIR> makeSIR(const std::vector<std::string>& fields,
+                             const std::shared_ptr<BlockStmt>& stencilDesc) {
+  auto sir = std::make_shared<SIR>();
+  sir->Filename = "test.cpp";
+
+  auto stencil = std::make_shared<sir::Stencil>();
+  stencil->Name = "test";
+  for(const auto& name : fields) {
+    stencil->Fields.emplace_back(std::make_shared<sir::Field>(name));
+    stencil->Fields.back()->IsTemporary = name.compare(0, 3, "tmp") == 0;
+  }
+  stencil->StencilDescAst = std::make_shared<AST>(stencilDesc);
+  sir->Stencils.emplace_back(stencil);
+  return sir;
+}
+
+std::shared_ptr<SIR> makeSIR(const std::vector<std::string>& fields,
+                             const std::shared_ptr<sir::VerticalRegion>& verticalRegion) {
+  return makeSIR(fields, block(astgen::verticalRegion(verticalRegion)));
+}
+
+std::shared_ptr<SIR> makeSIR(const std::vector<std::string>& fields,
+                             const std::vector<std::shared_ptr<Stmt>>& statements) {
+  return makeSIR(fields, makeVerticalRegion(statements));
+}
+
+} // namespace astgen
+
+} // namespace dawn
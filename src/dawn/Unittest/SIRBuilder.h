@@ -0,0 +1,74 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_UNITTEST_SIRBUILDER_H
+#define DAWN_UNITTEST_SIRBUILDER_H
+
+#include "dawn/SIR/ASTExpr.h"
+#include "dawn/SIR/ASTStmt.h"
+#include "dawn/SIR/SIR.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dawn {
+
+namespace astgen {
+
+/// @name SIR fixtures of the unittests
+/// @{
+
+/// @brief Access of the global variable `name`
+std::shared_ptr<VarAccessExpr> global(const std::string& name);
+
+/// @brief Make a vertical region executing `statements` over
+/// `[k_start + lowerOffset, k_end + upperOffset]`
+std::shared_ptr<sir::VerticalRegion> makeVerticalRegion(
+    const std::vector<std::shared_ptr<Stmt>>& statements, int lowerOffset = 0, int upperOffset = 0,
+    sir::VerticalRegion::LoopOrderKind loopOrder = sir::VerticalRegion::LK_Forward);
+
+/// @brief Make a stencil function `name` with the field arguments `args` executing `body`
+std::shared_ptr<sir::StencilFunction> makeStencilFunction(const std::string& name,
+                                                          const std::vector<std::string>& args,
+                                                          const std::shared_ptr<BlockStmt>& body);
+
+/// @brief Apply the boundary condition `functor` to the fields `fields`
+std::shared_ptr<BoundaryConditionDeclStmt>
+makeBoundaryCondition(const std::string& functor, const std::vector<std::string>& fields);
+
+/// @brief Build a SIR with a single stencil `test` whose description is `stencilDesc`
+///
+/// Fields whose name starts with `tmp` are temporaries.
+std::shared_ptr<SIR> makeSIR(const std::vector<std::string>& fields,
+                             const std::shared_ptr<BlockStmt>& stencilDesc);
+
+/// @brief Build a SIR with a single stencil `test` executing `verticalRegion`
+///
+/// Fields whose name starts with `tmp` are temporaries.
+std::shared_ptr<SIR> makeSIR(const std::vector<std::string>& fields,
+                             const std::shared_ptr<sir::VerticalRegion>& verticalRegion);
+
+/// @brief Build a SIR with a single stencil `test` executing `statements` in one forward vertical
+/// region over the whole domain
+///
+/// Fields whose name starts with `tmp` are temporaries.
+std::shared_ptr<SIR> makeSIR(const std::vector<std::string>& fields,
+                             const std::vector<std::shared_ptr<Stmt>>& statements);
+/// @}
+
+} // namespace astgen
+
+} // namespace dawn
+
+#endif
@@ -0,0 +1,143 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef DAWN_TEST_BENCHMARK_DAWN_BENCHMARK_H
+#define DAWN_TEST_BENCHMARK_DAWN_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace dawn {
+namespace benchmark {
+
+/// @brief Prevent the compiler from optimizing away the computation of `value`
+template <class T>
+inline void doNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// @brief Minimal harness for microbenchmarks
+///
+/// A benchmark is a function running its body `n` times. The runner calibrates `n` such that one
+/// sample takes at least `--min-time` seconds, takes `--samples` samples and reports the median
+/// (and the minimum and the median absolute deviation) of the time per iteration. The median is
+/// robust against the occasional preempted sample, which keeps the numbers comparable across runs.
+///
+/// Usage: <benchmark> [--filter <substring>] [--samples <n>] [--min-time <seconds>] [--csv]
+class Runner {
+public:
+  using Function = std::function<void(std::size_t)>;
+
+  /// @brief Register the benchmark `name`
+  void add(std::string name, Function fun) {
+    benchmarks_.push_back(Benchmark{std::move(name), std::move(fun)});
+  }
+
+  /// @brief Parse the command line and run the (selected) benchmarks
+  int run(int argc, char* argv[]) {
+    std::string filter;
+    int numSamples = 7;
+    double minTime = 0.05;
+    bool csv = false;
+
+    for(int i = 1; i < argc; ++i) {
+      auto value = [&]() -> const char* {
+        if(i + 1 == argc) {
+          std::fprintf(stderr, "%s: missing value of '%s'\n", argv[0], argv[i]);
+          std::exit(1);
+        }
+        return argv[++i];
+      };
+      if(std::strcmp(argv[i], "--filter") == 0)
+        filter = value();
+      else if(std::strcmp(argv[i], "--samples") == 0)
+        numSamples = std::max(1, std::atoi(value()));
+      else if(std::strcmp(argv[i], "--min-time") == 0)
+        minTime = std::atof(value());
+      else if(std::strcmp(argv[i], "--csv") == 0)
+        csv = true;
+      else {
+        std::fprintf(stderr, "usage: %s [--filter <substring>] [--samples <n>] "
+                             "[--min-time <seconds>] [--csv]\n",
+                     argv[0]);
+        return 1;
+      }
+    }
+
+    if(csv)
+      std::printf("benchmark,iterations,median_ns,min_ns,mad_ns\n");
+    else
+      std::printf("%-60s %12s %12s %12s %8s\n", "benchmark", "iterations", "median [ns]",
+                  "min [ns]", "MAD [%]");
+
+    for(const Benchmark& benchmark : benchmarks_) {
+      if(benchmark.Name.find(filter) == std::string::npos)
+        continue;
+
+      // Calibrate the number of iterations per sample
+      std::size_t iterations = 1;
+      while(time(benchmark.Fun, iterations) < minTime && iterations < (std::size_t(1) << 40))
+        iterations *= 2;
+
+      std::vector<double> samples;
+      for(int i = 0; i < numSamples; ++i)
+        samples.push_back(time(benchmark.Fun, iterations) / iterations * 1e9);
+
+      double med = median(samples);
+      double min = *std::min_element(samples.begin(), samples.end());
+      for(double& sample : samples)
+        sample = std::abs(sample - med);
+      double mad = median(samples);
+
+      if(csv)
+        std::printf("%s,%zu,%.3f,%.3f,%.3f\n", benchmark.Name.c_str(), iterations, med, min, mad);
+      else
+        std::printf("%-60s %12zu %12.3f %12.3f %8.2f\n", benchmark.Name.c_str(), iterations, med,
+                    min, med > 0 ? 100 * mad / med : 0.0);
+      std::fflush(stdout);
+    }
+    return 0;
+  }
+
+private:
+  struct Benchmark {
+    std::string Name;
+    Function Fun;
+  };
+  std::vector<Benchmark> benchmarks_;
+
+  static double time(const Function& fun, std::size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    fun(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    std::size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+  }
+};
+
+} // namespace benchmark
+} // namespace dawn
+
+#endif
@@ -0,0 +1,238 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+// Measure how the compile time and the memory of the compiler scale with the size of the SIR
+//
+// Each SIR file (e.g generated with `python/dawn/synthetic.py --sweep ...`) is compiled with the
+// GridTools backend in a forked child process so that the peak resident set size (`ru_maxrss`) of
+// one compilation is not polluted by the others. The child reports the time spent in the
+// optimizer, in each pass and in the code generation. The results are printed per file followed
+// by a table of the time spent in each pass across all files.
+//
+// Usage: DawnBenchmarkCompileScaling [--csv] <file.sir>...
+
+#include "dawn/CodeGen/GridTools/GTCodeGen.h"
+#include "dawn/CodeGen/TranslationUnit.h"
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Compiler/Options.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/PassManager.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/SIR/SIRSerializer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace dawn;
+
+namespace {
+
+struct Measurement {
+  std::string File;
+  bool Success = false;
+  double ParseSeconds = 0;
+  double OptimizerSeconds = 0;
+  double CodeGenSeconds = 0;
+  long PeakRSSInKB = 0;
+  std::vector<PassStatistics> Passes;
+};
+
+/// @brief Load `file` (Byte format, falling back to JSON)
+std::shared_ptr<SIR> loadSIR(const std::string& file) {
+  try {
+    return SIRSerializer::deserialize(file, SIRSerializer::SK_Byte);
+  } catch(std::exception&) {
+    return SIRSerializer::deserialize(file, SIRSerializer::SK_Json);
+  }
+}
+
+/// @brief Compile `file` and write the measurements to `fd`, one line per value
+void compileInChild(const std::string& file, int fd) {
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  std::ostringstream ss;
+  auto start = Clock::now();
+  std::shared_ptr<SIR> sir = loadSIR(file);
+  ss << "parse " << seconds(start) << "\n";
+
+  // Collect the pass statistics (the table printed by -time-passes is discarded by the parent)
+  Options options;
+  options.TimePasses = true;
+  DawnCompiler compiler(&options);
+  start = Clock::now();
+  std::unique_ptr<OptimizerContext> context = compiler.runOptimizer(sir);
+  if(!context)
+    std::_Exit(1);
+  ss << "optimizer " << seconds(start) << "\n";
+
+  start = Clock::now();
+  auto translationUnit = codegen::gt::GTCodeGen(context.get()).generateCode();
+  if(!translationUnit)
+    std::_Exit(1);
+  ss << "codegen " << seconds(start) << "\n";
+
+  for(const PassStatistics& pass : context->getPassManager().getStatistics())
+    ss << "pass " << pass.Name << " " << pass.NumRuns << " " << pass.Seconds << " "
+       << pass.RSSDeltaInKB << " " << pass.PeakRSSDeltaInKB << "\n";
+
+  std::string str = ss.str();
+  if(::write(fd, str.data(), str.size()) != static_cast<ssize_t>(str.size()))
+    std::_Exit(1);
+  std::_Exit(0);
+}
+
+/// @brief Compile `file` in a child process and collect its measurements
+Measurement measureInChild(const std::string& file) {
+  Measurement m;
+  m.File = file;
+
+  int fds[2];
+  if(::pipe(fds) != 0) {
+    std::perror("pipe");
+    std::exit(1);
+  }
+
+  pid_t pid = ::fork();
+  if(pid == -1) {
+    std::perror("fork");
+    std::exit(1);
+  }
+  if(pid == 0) {
+    ::close(fds[0]);
+    int devNull = ::open("/dev/null", O_WRONLY);
+    if(devNull != -1)
+      ::dup2(devNull, STDOUT_FILENO);
+    try {
+      compileInChild(file, fds[1]);
+    } catch(std::exception& e) {
+      std::fprintf(stderr, "%s: %s\n", file.c_str(), e.what());
+    }
+    std::_Exit(1);
+  }
+
+  ::close(fds[1]);
+  std::string output;
+  char buffer[4096];
+  ssize_t n;
+  while((n = ::read(fds[0], buffer, sizeof(buffer))) > 0)
+    output.append(buffer, n);
+  ::close(fds[0]);
+
+  int status;
+  struct rusage usage;
+  ::wait4(pid, &status, 0, &usage);
+  m.Success = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  m.PeakRSSInKB = usage.ru_maxrss;
+
+  std::istringstream ss(output);
+  std::string key;
+  while(ss >> key) {
+    if(key == "parse")
+      ss >> m.ParseSeconds;
+    else if(key == "optimizer")
+      ss >> m.OptimizerSeconds;
+    else if(key == "codegen")
+      ss >> m.CodeGenSeconds;
+    else if(key == "pass") {
+      PassStatistics pass;
+      ss >> pass.Name >> pass.NumRuns >> pass.Seconds >> pass.RSSDeltaInKB >>
+          pass.PeakRSSDeltaInKB;
+      m.Passes.push_back(pass);
+    }
+  }
+  return m;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  bool csv = false;
+  std::vector<std::string> files;
+  for(int i = 1; i < argc; ++i) {
+    if(std::strcmp(argv[i], "--csv") == 0)
+      csv = true;
+    else
+      files.emplace_back(argv[i]);
+  }
+
+  if(files.empty()) {
+    std::fprintf(stderr, "usage: %s [--csv] <file.sir>...\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<Measurement> measurements;
+  for(const std::string& file : files)
+    measurements.push_back(measureInChild(file));
+
+  // Passes in the order in which they first appear
+  std::vector<std::string> passes;
+  std::vector<std::map<std::string, double>> passSeconds(measurements.size());
+  for(std::size_t i = 0; i < measurements.size(); ++i)
+    for(const PassStatistics& pass : measurements[i].Passes) {
+      if(std::find(passes.begin(), passes.end(), pass.Name) == passes.end())
+        passes.push_back(pass.Name);
+      passSeconds[i][pass.Name] = pass.Seconds;
+    }
+
+  if(csv) {
+    std::printf("file,success,parse_ms,optimizer_ms,codegen_ms,peak_rss_kb");
+    for(const std::string& pass : passes)
+      std::printf(",%s_ms", pass.c_str());
+    std::printf("\n");
+    for(std::size_t i = 0; i < measurements.size(); ++i) {
+      const Measurement& m = measurements[i];
+      std::printf("%s,%d,%.3f,%.3f,%.3f,%ld", m.File.c_str(), m.Success, m.ParseSeconds * 1e3,
+                  m.OptimizerSeconds * 1e3, m.CodeGenSeconds * 1e3, m.PeakRSSInKB);
+      for(const std::string& pass : passes)
+        std::printf(",%.3f", passSeconds[i][pass] * 1e3);
+      std::printf("\n");
+    }
+    return 0;
+  }
+
+  std::printf("%-40s %10s %14s %12s %13s\n", "file", "parse [ms]", "optimizer [ms]",
+              "codegen [ms]", "peak RSS [KB]");
+  for(const Measurement& m : measurements) {
+    if(!m.Success)
+      std::printf("%-40s %10s\n", m.File.c_str(), "FAILED");
+    else
+      std::printf("%-40s %10.3f %14.3f %12.3f %13ld\n", m.File.c_str(), m.ParseSeconds * 1e3,
+                  m.OptimizerSeconds * 1e3, m.CodeGenSeconds * 1e3, m.PeakRSSInKB);
+  }
+
+  std::printf("\n%-40s", "pass [ms]");
+  for(std::size_t i = 0; i < measurements.size(); ++i)
+    std::printf(" %10s", ("#" + std::to_string(i)).c_str());
+  std::printf("\n");
+  for(const std::string& pass : passes) {
+    std::printf("%-40s", pass.c_str());
+    for(std::size_t i = 0; i < measurements.size(); ++i)
+      std::printf(" %10.3f", passSeconds[i][pass] * 1e3);
+    std::printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,239 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+// Microbenchmarks of the primitives of the optimizer (vertical intervals, extents, accesses and
+// the algorithms on the dependency graphs)
+//
+// The inputs are generated with a fixed seed so that the numbers are comparable across runs.
+//
+// Usage: DawnBenchmarkOptimizer [--filter <substring>] [--samples <n>] [--min-time <seconds>]
+//                               [--csv]
+
+#include "dawn/Optimizer/Accesses.h"
+#include "dawn/Optimizer/DependencyGraphAccesses.h"
+#include "dawn/Optimizer/Extents.h"
+#include "dawn/Optimizer/Interval.h"
+#include "test/benchmark/dawn/Benchmark.h"
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+using namespace dawn;
+using namespace dawn::benchmark;
+
+namespace {
+
+/// @brief `num` random intervals within the levels [0, 80]
+std::vector<Interval> makeIntervals(int num) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> level(0, 80);
+  std::vector<Interval> intervals;
+  for(int i = 0; i < num; ++i) {
+    int lower = level(gen), upper = level(gen);
+    intervals.emplace_back(std::min(lower, upper), std::max(lower, upper));
+  }
+  return intervals;
+}
+
+/// @brief `num` non-overlapping intervals `[4 * i, 4 * i + 1]` separated by gaps
+std::vector<Interval> makeDisjointIntervals(int num) {
+  std::vector<Interval> intervals;
+  for(int i = 0; i < num; ++i)
+    intervals.emplace_back(4 * i, 4 * i + 1);
+  return intervals;
+}
+
+/// @brief `num` random offsets within [-3, 3]^3
+std::vector<Array3i> makeOffsets(int num) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> offset(-3, 3);
+  std::vector<Array3i> offsets;
+  for(int i = 0; i < num; ++i)
+    offsets.push_back(Array3i{{offset(gen), offset(gen), offset(gen)}});
+  return offsets;
+}
+
+/// @brief Dependency graph without a StencilInstantiation
+class Graph : public DependencyGraphAccesses {
+  using Base = DependencyGraphAccesses;
+
+public:
+  Graph() : Base(nullptr) {}
+  void insertEdge(int IDFrom, int IDTo, const Extents& extents = Extents{}) {
+    Base::insertNode(IDFrom);
+    Base::insertEdge(IDFrom, IDTo, extents);
+  }
+};
+
+/// @brief `numChains` independent chains of `chainLength` nodes where each node also depends on
+/// the node two positions ahead and, if `cycles` is set, every fourth node closes a cycle of
+/// length four (i.e the graph has strongly connected components)
+std::shared_ptr<Graph> makeGraph(int numChains, int chainLength, bool cycles) {
+  auto graph = std::make_shared<Graph>();
+  auto offsets = makeOffsets(numChains * chainLength);
+  for(int c = 0; c < numChains; ++c) {
+    int first = c * chainLength;
+    for(int i = first; i < first + chainLength - 1; ++i) {
+      graph->insertEdge(i, i + 1, Extents(offsets[i]));
+      if(i + 2 < first + chainLength)
+        graph->insertEdge(i, i + 2);
+      if(cycles && (i - first) % 4 == 3)
+        graph->insertEdge(i, i - 3);
+    }
+  }
+  return graph;
+}
+
+void registerInterval(Runner& runner) {
+  for(int num : {4, 16, 64}) {
+    std::string suffix = "/" + std::to_string(num);
+    std::vector<Interval> intervals = makeIntervals(num);
+
+    runner.add("Interval::computePartition" + suffix, [=](std::size_t n) {
+      for(std::size_t it = 0; it < n; ++it)
+        doNotOptimize(Interval::computePartition(intervals).size());
+    });
+    std::vector<Interval> disjointIntervals = makeDisjointIntervals(num);
+    runner.add("Interval::computeGapIntervals" + suffix, [=](std::size_t n) {
+      Interval axis(0, 4 * num);
+      for(std::size_t it = 0; it < n; ++it)
+        doNotOptimize(Interval::computeGapIntervals(axis, disjointIntervals).size());
+    });
+    runner.add("Interval::computeLevelUnion" + suffix, [=](std::size_t n) {
+      for(std::size_t it = 0; it < n; ++it)
+        doNotOptimize(Interval::computeLevelUnion(intervals).size());
+    });
+    runner.add("Interval::merge" + suffix, [=](std::size_t n) {
+      for(std::size_t it = 0; it < n; ++it) {
+        Interval interval = intervals.front();
+        for(const Interval& other : intervals)
+          interval.merge(other);
+        doNotOptimize(interval);
+      }
+    });
+  }
+}
+
+void registerExtents(Runner& runner) {
+  std::vector<Array3i> offsets = makeOffsets(64);
+  std::vector<Extents> extents(offsets.begin(), offsets.end());
+
+  runner.add("Extents::merge(Array3i)/64", [=](std::size_t n) {
+    for(std::size_t it = 0; it < n; ++it) {
+      Extents result;
+      for(const Array3i& offset : offsets)
+        result.merge(offset);
+      doNotOptimize(result);
+    }
+  });
+  runner.add("Extents::merge(Extents)/64", [=](std::size_t n) {
+    for(std::size_t it = 0; it < n; ++it) {
+      Extents result;
+      for(const Extents& other : extents)
+        result.merge(other);
+      doNotOptimize(result);
+    }
+  });
+  runner.add("Extents::add(Extents)/64", [=](std::size_t n) {
+    for(std::size_t it = 0; it < n; ++it) {
+      Extents result;
+      for(const Extents& other : extents)
+        result.add(other);
+      doNotOptimize(result);
+    }
+  });
+}
+
+void registerAccesses(Runner& runner) {
+  for(int numIDs : {4, 64}) {
+    std::string suffix = "/" + std::to_string(numIDs);
+    std::vector<Array3i> offsets = makeOffsets(256);
+
+    runner.add("Accesses::mergeReadOffset" + suffix, [=](std::size_t n) {
+      for(std::size_t it = 0; it < n; ++it) {
+        Accesses accesses;
+        for(std::size_t i = 0; i < offsets.size(); ++i)
+          accesses.mergeReadOffset(i % numIDs, offsets[i]);
+        doNotOptimize(accesses.getReadAccesses().size());
+      }
+    });
+
+    // Merge the accesses of the statements into the accesses of the enclosing Do-Method
+    std::vector<Accesses> statements(16);
+    for(std::size_t i = 0; i < offsets.size(); ++i) {
+      statements[i % 16].mergeReadOffset(i % numIDs, offsets[i]);
+      statements[(i + 1) % 16].mergeWriteOffset(i % numIDs, Array3i{{0, 0, 0}});
+    }
+    runner.add("Accesses::mergeReadExtent+mergeWriteExtent" + suffix, [=](std::size_t n) {
+      for(std::size_t it = 0; it < n; ++it) {
+        Accesses result;
+        for(const Accesses& statement : statements) {
+          for(const auto& pair : statement.getReadAccesses())
+            result.mergeReadExtent(pair.first, pair.second);
+          for(const auto& pair : statement.getWriteAccesses())
+            result.mergeWriteExtent(pair.first, pair.second);
+        }
+        doNotOptimize(result.getReadAccesses().size());
+      }
+    });
+  }
+}
+
+void registerGraph(Runner& runner) {
+  for(int length : {16, 256}) {
+    std::string suffix = "/4x" + std::to_string(length);
+    std::shared_ptr<Graph> dag = makeGraph(4, length, false);
+    std::shared_ptr<Graph> cyclic = makeGraph(4, length, true);
+
+    runner.add("DependencyGraphAccesses::insertEdge" + suffix,
+               [=](std::size_t n) {
+                 for(std::size_t it = 0; it < n; ++it)
+                   doNotOptimize(makeGraph(4, length, false)->getNumVertices());
+               });
+    runner.add("DependencyGraphAccesses::isDAG" + suffix, [=](std::size_t n) {
+      for(std::size_t it = 0; it < n; ++it)
+        doNotOptimize(dag->isDAG());
+    });
+    runner.add("DependencyGraphAccesses::findStronglyConnectedComponents" + suffix,
+               [=](std::size_t n) {
+                 for(std::size_t it = 0; it < n; ++it) {
+                   std::vector<std::set<int>> scc;
+                   doNotOptimize(cyclic->findStronglyConnectedComponents(scc));
+                 }
+               });
+    runner.add("DependencyGraphAccesses::greedyColoring" + suffix, [=](std::size_t n) {
+      for(std::size_t it = 0; it < n; ++it) {
+        std::unordered_map<int, int> coloring;
+        dag->greedyColoring(coloring);
+        doNotOptimize(coloring.size());
+      }
+    });
+    runner.add("DependencyGraphAccesses::partitionInSubGraphs" + suffix, [=](std::size_t n) {
+      for(std::size_t it = 0; it < n; ++it)
+        doNotOptimize(dag->partitionInSubGraphs().size());
+    });
+  }
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  Runner runner;
+  registerInterval(runner);
+  registerExtents(runner);
+  registerAccesses(runner);
+  registerGraph(runner);
+  return runner.run(argc, argv);
+}
@@ -0,0 +1,162 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+// Compare the load time and peak memory of deserializing a large, synthetic Byte encoded SIR
+//
+//  - string: read the whole file into a std::string and call `deserializeFromString` (the way
+//            `SIRSerializer::deserialize` used to work)
+//  - mapped: call `SIRSerializer::deserialize` which maps the file and parses it in place
+//
+// Each variant runs in a forked child process so that the peak resident set size (`ru_maxrss`)
+// of one variant is not polluted by the other.
+//
+// Usage: DawnBenchmarkSIRSerializer [num-stencils] [num-statements] [repetitions]
+
+#include "dawn/SIR/SIR.h"
+#include "dawn/SIR/SIRSerializer.h"
+#include "dawn/Unittest/ASTSimplifier.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+/// @brief Build a SIR with `numStencils` stencils each containing `numStatements` Laplacian like
+/// statements in a single vertical region
+std::shared_ptr<SIR> makeSyntheticSIR(int numStencils, int numStatements) {
+  auto sir = std::make_shared<SIR>();
+  sir->Filename = "synthetic.cpp";
+
+  for(int s = 0; s < numStencils; ++s) {
+    auto stencil = std::make_shared<sir::Stencil>();
+    stencil->Name = "stencil_" + std::to_string(s);
+    stencil->Fields.emplace_back(std::make_shared<sir::Field>("in"));
+    stencil->Fields.emplace_back(std::make_shared<sir::Field>("out"));
+
+    std::vector<std::shared_ptr<Stmt>> statements;
+    for(int i = 0; i < numStatements; ++i) {
+      auto lap = binop(binop(binop(field("in", {{1, 0, 0}}), "+", field("in", {{-1, 0, 0}})), "+",
+                             binop(field("in", {{0, 1, 0}}), "+", field("in", {{0, -1, 0}}))),
+                       "-", binop(lit("4.0"), "*", field("in")));
+      statements.emplace_back(expr(assign(field("out"), lap)));
+    }
+
+    auto ast = std::make_shared<AST>(std::make_shared<BlockStmt>(statements));
+    auto vr = std::make_shared<sir::VerticalRegion>(
+        ast, std::make_shared<sir::Interval>(sir::Interval::Start, sir::Interval::End),
+        sir::VerticalRegion::LK_Forward);
+    stencil->StencilDescAst = std::make_shared<AST>(block(verticalRegion(vr)));
+    sir->Stencils.emplace_back(stencil);
+  }
+  return sir;
+}
+
+struct Measurement {
+  double Seconds;
+  long PeakRSSInKB;
+};
+
+/// @brief Run `fun` `repetitions` times in a child process and measure the average wall time and
+/// the peak resident set size of the child
+Measurement measureInChild(const std::function<void()>& fun, int repetitions) {
+  int fds[2];
+  if(::pipe(fds) != 0) {
+    std::perror("pipe");
+    std::exit(1);
+  }
+
+  pid_t pid = ::fork();
+  if(pid == -1) {
+    std::perror("fork");
+    std::exit(1);
+  }
+  if(pid == 0) {
+    ::close(fds[0]);
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < repetitions; ++i)
+      fun();
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() /
+        repetitions;
+    if(::write(fds[1], &seconds, sizeof(seconds)) != sizeof(seconds))
+      std::_Exit(1);
+    std::_Exit(0);
+  }
+
+  ::close(fds[1]);
+  double seconds = 0;
+  if(::read(fds[0], &seconds, sizeof(seconds)) != sizeof(seconds))
+    seconds = -1;
+  ::close(fds[0]);
+
+  int status;
+  struct rusage usage;
+  ::wait4(pid, &status, 0, &usage);
+  return Measurement{seconds, usage.ru_maxrss};
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  int numStencils = argc > 1 ? std::atoi(argv[1]) : 200;
+  int numStatements = argc > 2 ? std::atoi(argv[2]) : 200;
+  int repetitions = argc > 3 ? std::atoi(argv[3]) : 5;
+
+  // Generate the SIR in a child process to keep the heap of this process small
+  const std::string file = "BenchmarkSIRSerializer.sir";
+  measureInChild(
+      [&]() {
+        auto sir = makeSyntheticSIR(numStencils, numStatements);
+        SIRSerializer::serialize(file, sir.get(), SIRSerializer::SK_Byte);
+      },
+      1);
+
+  std::ifstream ifs(file, std::ios::binary | std::ios::ate);
+  std::cout << "SIR: " << numStencils << " stencils x " << numStatements << " statements ("
+            << ifs.tellg() / 1024 << " KB)" << std::endl;
+
+  Measurement baseline = measureInChild([]() {}, 1);
+
+  Measurement string = measureInChild(
+      [&]() {
+        std::ifstream in(file, std::ios::binary);
+        std::string str((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        SIRSerializer::deserializeFromString(str, SIRSerializer::SK_Byte);
+      },
+      repetitions);
+
+  Measurement mapped = measureInChild(
+      [&]() { SIRSerializer::deserialize(file, SIRSerializer::SK_Byte); }, repetitions);
+
+  auto report = [&](const char* name, const Measurement& m) {
+    std::printf("%-8s %10.3f ms %10ld KB peak RSS (+%ld KB)\n", name, m.Seconds * 1e3,
+                m.PeakRSSInKB, m.PeakRSSInKB - baseline.PeakRSSInKB);
+  };
+  report("string", string);
+  report("mapped", mapped);
+
+  std::remove(file.c_str());
+  return 0;
+}
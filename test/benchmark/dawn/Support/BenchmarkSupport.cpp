@@ -0,0 +1,141 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+// Microbenchmarks of the containers and string utilities of dawn/Support
+//
+// Usage: DawnBenchmarkSupport [--filter <substring>] [--samples <n>] [--min-time <seconds>] [--csv]
+
+#include "dawn/Support/SmallString.h"
+#include "dawn/Support/SmallVector.h"
+#include "dawn/Support/StringRef.h"
+#include "dawn/Support/Twine.h"
+#include "test/benchmark/dawn/Benchmark.h"
+#include <string>
+#include <vector>
+
+using namespace dawn;
+using namespace dawn::benchmark;
+
+namespace {
+
+/// @brief Append `size` elements to a fresh container
+template <class VectorType>
+void pushBack(std::size_t iterations, int size) {
+  for(std::size_t it = 0; it < iterations; ++it) {
+    VectorType vec;
+    for(int i = 0; i < size; ++i)
+      vec.push_back(i);
+    doNotOptimize(vec.data());
+  }
+}
+
+/// @brief Append `size` elements to a container which is cleared (but not deallocated) in between
+template <class VectorType>
+void pushBackReused(std::size_t iterations, int size) {
+  VectorType vec;
+  for(std::size_t it = 0; it < iterations; ++it) {
+    vec.clear();
+    for(int i = 0; i < size; ++i)
+      vec.push_back(i);
+    doNotOptimize(vec.data());
+  }
+}
+
+void registerSmallVector(Runner& runner) {
+  for(int size : {4, 8, 64, 1024}) {
+    std::string suffix = "/" + std::to_string(size);
+    runner.add("SmallVector<int,8>::push_back" + suffix,
+               [=](std::size_t n) { pushBack<SmallVector<int, 8>>(n, size); });
+    runner.add("std::vector<int>::push_back" + suffix,
+               [=](std::size_t n) { pushBack<std::vector<int>>(n, size); });
+    runner.add("SmallVector<int,8>::push_back(reused)" + suffix,
+               [=](std::size_t n) { pushBackReused<SmallVector<int, 8>>(n, size); });
+  }
+
+  runner.add("SmallVector<int,8>::append/1024", [](std::size_t n) {
+    std::vector<int> values(1024, 1);
+    for(std::size_t it = 0; it < n; ++it) {
+      SmallVector<int, 8> vec;
+      vec.append(values.begin(), values.end());
+      doNotOptimize(vec.data());
+    }
+  });
+}
+
+void registerStrings(Runner& runner) {
+  const std::string prefix = "__tmp_";
+  const std::string name = "field_with_a_moderately_long_name";
+  const std::string suffix = "_12";
+
+  runner.add("std::string::operator+/3", [=](std::size_t n) {
+    for(std::size_t it = 0; it < n; ++it) {
+      std::string str = prefix + name + suffix;
+      doNotOptimize(str.data());
+    }
+  });
+
+  runner.add("Twine::str/3", [=](std::size_t n) {
+    for(std::size_t it = 0; it < n; ++it) {
+      std::string str = (Twine(prefix) + name + suffix).str();
+      doNotOptimize(str.data());
+    }
+  });
+
+  runner.add("Twine::toVector/3", [=](std::size_t n) {
+    for(std::size_t it = 0; it < n; ++it) {
+      SmallString<64> buffer;
+      (Twine(prefix) + name + suffix).toVector(buffer);
+      doNotOptimize(buffer.data());
+    }
+  });
+
+  runner.add("Twine::str/int", [=](std::size_t n) {
+    for(std::size_t it = 0; it < n; ++it) {
+      std::string str = (Twine(prefix) + Twine(static_cast<int>(it))).str();
+      doNotOptimize(str.data());
+    }
+  });
+
+  runner.add("StringRef::operator+=/3", [=](std::size_t n) {
+    StringRef p(prefix), f(name), s(suffix);
+    for(std::size_t it = 0; it < n; ++it) {
+      std::string str;
+      str += p;
+      str += f;
+      str += s;
+      doNotOptimize(str.data());
+    }
+  });
+
+  runner.add("StringRef::find", [=](std::size_t n) {
+    StringRef str(name);
+    for(std::size_t it = 0; it < n; ++it)
+      doNotOptimize(str.find("long"));
+  });
+
+  runner.add("StringRef::startswith", [=](std::size_t n) {
+    StringRef str(prefix + name);
+    for(std::size_t it = 0; it < n; ++it)
+      doNotOptimize(str.startswith(prefix));
+  });
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  Runner runner;
+  registerSmallVector(runner);
+  registerStrings(runner);
+  return runner.run(argc, argv);
+}
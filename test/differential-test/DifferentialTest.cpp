@@ -0,0 +1,375 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+// Differential execution test of the optimizer
+//
+// Each SIR is compiled with the naive C++ backend under several option sets. The generated code of
+// all option sets is built into a single program (against the self-contained `NaiveRuntime.h`)
+// which runs every stencil on the same random inputs and compares all fields in the compute domain
+// to the ones of the `reference` option set (all optional optimizations disabled). Each run is
+// timed, so the results double as a performance regression check.
+//
+// The optimizer is run in a forked child process per option set so that an assertion in one
+// option set is reported as a failure instead of aborting the whole test.
+//
+// Usage: DawnDifferentialTest [--cxx <compiler>] [--runtime <dir>] [--options <name,...>]
+//                             [--repetitions <n>] [--tolerance <tol>] [--keep]
+//                             <file.sir|directory>...
+//
+//  --options  Comma separated names of the option sets to compare to the reference (default: all)
+
+#include "dawn/CodeGen/CXXNaive/CXXNaiveCodeGen.h"
+#include "dawn/CodeGen/TranslationUnit.h"
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Compiler/Options.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/SIR/SIRSerializer.h"
+#include "dawn/Support/FileUtil.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace dawn;
+
+namespace {
+
+/// @brief Named set of options
+struct Configuration {
+  const char* Name;
+  std::function<void(Options&)> Set;
+
+  /// Maximum relative error to the reference (0 to use `--tolerance`), e.g. for option sets which
+  /// may change the rounding of the results
+  double Tolerance;
+};
+
+/// @brief Option sets to compare (the first one is the reference)
+///
+/// `tmp-to-function`, `caches` and `ssa` are known to fail on parts of the test corpus and are not
+/// run by CTest (see CMakeLists.txt for the failing SIRs).
+const std::vector<Configuration>& getConfigurations() {
+  static const std::vector<Configuration> configurations = {
+      {"reference",
+       [](Options& options) {
+         options.InlineStrategy = "none";
+         options.ReorderStrategy = "none";
+         options.MergeDoMethods = false;
+         options.UseKCaches = false;
+       },
+       0},
+      {"default", [](Options&) {}, 0},
+      {"inline-pc", [](Options& options) { options.InlineStrategy = "pc"; }, 0},
+      {"inline-auto", [](Options& options) { options.InlineStrategy = "auto"; }, 0},
+      {"merge",
+       [](Options& options) {
+         options.MergeStages = true;
+         options.MergeTemporaries = true;
+       },
+       0},
+      {"scalar",
+       [](Options& options) {
+         options.FoldConstants = true;
+         options.Simplify = true;
+         options.CSE = true;
+         options.DCE = true;
+         options.LICM = true;
+       },
+       0},
+      {"fast-math",
+       [](Options& options) {
+         options.Simplify = true;
+         options.FastMath = true;
+       },
+       1e-8},
+      {"demote-temporaries", [](Options& options) { options.DemoteTemporaries = true; }, 0},
+      {"fuse-stencils", [](Options& options) { options.FuseStencils = true; }, 0},
+      {"fuse-boundary-conditions",
+       [](Options& options) { options.FuseBoundaryConditions = true; }, 0},
+      {"tmp-to-function", [](Options& options) { options.PassTmpToFunction = true; }, 0},
+      {"caches", [](Options& options) { options.UseNonTempCaches = true; }, 0},
+      {"ssa", [](Options& options) { options.SSA = true; }, 0},
+  };
+  return configurations;
+}
+
+struct Settings {
+  std::string CXX = "c++";
+  std::string RuntimeDir = ".";
+  std::vector<std::string> Options; ///< Option sets to run (all if empty)
+  int Repetitions = 5;
+  double Tolerance = 1e-10;
+  bool Keep = false;
+};
+
+/// @brief Load `file` (Byte format, falling back to JSON)
+std::shared_ptr<SIR> loadSIR(const std::string& file) {
+  try {
+    return SIRSerializer::deserialize(file, SIRSerializer::SK_Byte);
+  } catch(std::exception&) {
+    return SIRSerializer::deserialize(file, SIRSerializer::SK_Json);
+  }
+}
+
+/// @brief Generate the naive C++ code of `sir` with `configuration` in a child process
+///
+/// @returns `false` if the compilation failed (or crashed)
+bool compileInChild(const std::shared_ptr<SIR>& sir, const Configuration& configuration,
+                    std::string& code) {
+  int fds[2];
+  if(::pipe(fds) != 0) {
+    std::perror("pipe");
+    std::exit(1);
+  }
+
+  // Do not duplicate buffered output in the child
+  std::cout.flush();
+  std::fflush(stdout);
+
+  pid_t pid = ::fork();
+  if(pid == -1) {
+    std::perror("fork");
+    ::close(fds[0]);
+    ::close(fds[1]);
+    return false;
+  }
+  if(pid == 0) {
+    ::close(fds[0]);
+    Options options;
+    configuration.Set(options);
+    DawnCompiler compiler(&options);
+    std::unique_ptr<OptimizerContext> context = compiler.runOptimizer(sir);
+    for(const auto& diag : compiler.getDiagnostics().getQueue())
+      std::cerr << "  " << configuration.Name << ": " << diag->getMessage() << "\n";
+    if(!context)
+      std::_Exit(1);
+    auto translationUnit = codegen::cxxnaive::CXXNaiveCodeGen(context.get()).generateCode();
+    if(!translationUnit)
+      std::_Exit(1);
+
+    std::string str;
+    for(const std::string& define : translationUnit->getPPDefines())
+      str += define + "\n";
+    str += '\0';
+    str += translationUnit->getGlobals();
+    for(const auto& nameCodePair : translationUnit->getStencils())
+      str += nameCodePair.second;
+    if(::write(fds[1], str.data(), str.size()) != static_cast<ssize_t>(str.size()))
+      std::_Exit(1);
+    std::_Exit(0);
+  }
+
+  ::close(fds[1]);
+  code.clear();
+  char buffer[4096];
+  ssize_t n;
+  while((n = ::read(fds[0], buffer, sizeof(buffer))) > 0)
+    code.append(buffer, n);
+  ::close(fds[0]);
+
+  int status;
+  ::waitpid(pid, &status, 0);
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/// @brief Run the differential test of `file`
+///
+/// @returns `true` if all option sets compiled and produced the same results as the reference
+bool testFile(const std::string& file, const Settings& settings) {
+  std::cout << "\n" << file << "\n";
+  std::shared_ptr<SIR> sir;
+  try {
+    sir = loadSIR(file);
+  } catch(std::exception& e) {
+    std::cout << "  failed to load: " << e.what() << "\n";
+    return false;
+  }
+
+  const std::vector<Configuration>& configurations = getConfigurations();
+  bool success = true;
+
+  // Generate the test program
+  std::ostringstream program;
+  std::ostringstream body;
+  std::vector<const Configuration*> compiled;
+  for(const Configuration& configuration : configurations) {
+    if(&configuration != &configurations.front() && !settings.Options.empty() &&
+       std::find(settings.Options.begin(), settings.Options.end(), configuration.Name) ==
+           settings.Options.end())
+      continue;
+
+    std::string code;
+    if(!compileInChild(sir, configuration, code)) {
+      std::cout << "  " << configuration.Name << ": compilation FAILED\n";
+      success = false;
+      if(&configuration == &configurations.front())
+        return false;
+      continue;
+    }
+
+    std::size_t split = code.find('\0');
+    if(compiled.empty())
+      program << code.substr(0, split) << "#include \"NaiveRuntime.h\"\n";
+    std::string ns = "config_" + std::to_string(compiled.size());
+    program << "namespace " << ns << " {\n" << code.substr(split + 1) << "\n}\n";
+
+    for(const auto& stencil : sir->Stencils) {
+      std::string fieldNames, fieldArgs;
+      int numFields = 0;
+      for(const auto& field : stencil->Fields) {
+        if(field->IsTemporary)
+          continue;
+        fieldNames += (numFields ? ", \"" : "\"") + field->Name + "\"";
+        fieldArgs += ", fields[" + std::to_string(numFields++) + "]";
+      }
+      body << "  {\n"
+           << "    auto fields = test.makeFields({" << fieldNames << "});\n"
+           << "    " << ns << "::cxxnaive::" << stencil->Name << " stencil(test.dom()" << fieldArgs
+           << ");\n"
+           << "    test.check(\"" << configuration.Name << "\", \"" << stencil->Name << "\", "
+           << (compiled.empty() ? "true" : "false") << ", " << configuration.Tolerance
+           << ", fields, [&]() { stencil.run(); });\n"
+           << "  }\n";
+    }
+    compiled.push_back(&configuration);
+  }
+
+  program << "\nint main(int argc, char* argv[]) {\n"
+          << "  differential::Test test(argc, argv, 2 * GRIDTOOLS_CLANG_HALO_EXTEND);\n"
+          << body.str() << "  return test.result();\n}\n";
+
+  // Build and run it
+  std::string name = getFilenameWithoutExtension(file).str() + "_differential";
+  std::string source = name + ".cpp", executable = "./" + name, output = name + ".out";
+  std::ofstream(source) << program.str();
+
+  std::string build = settings.CXX + " -std=c++11 -O2 -w -I\"" + settings.RuntimeDir + "\" " +
+                      source + " -o " + executable;
+  if(std::system(build.c_str()) != 0) {
+    std::cout << "  build FAILED: " << build << "\n";
+    return false;
+  }
+
+  std::string run = executable + " 12 12 32 " + std::to_string(settings.Repetitions) + " " +
+                    std::to_string(settings.Tolerance) + " > " + output;
+  int status = std::system(run.c_str());
+  if(!WIFEXITED(status) || WEXITSTATUS(status) > 1) {
+    std::cout << "  run FAILED\n";
+    success = false;
+  }
+
+  // Report the results relative to the reference
+  std::ifstream ifs(output);
+  std::string config, stencil, result;
+  double ms, error;
+  std::map<std::string, double> referenceMs;
+  std::printf("  %-24s %-32s %12s %10s %12s %s\n", "options", "stencil", "time [ms]", "speedup",
+              "max error", "result");
+  while(ifs >> config >> stencil >> ms >> error >> result) {
+    if(config == configurations.front().Name)
+      referenceMs[stencil] = ms;
+    double speedup = ms > 0 && referenceMs.count(stencil) ? referenceMs[stencil] / ms : 0;
+    std::printf("  %-24s %-32s %12.4f %9.2fx %12.3e %s\n", config.c_str(), stencil.c_str(), ms,
+                speedup, error, result.c_str());
+    success &= result == "OK";
+  }
+
+  if(!settings.Keep) {
+    std::remove(source.c_str());
+    std::remove(executable.c_str());
+    std::remove(output.c_str());
+  }
+  return success;
+}
+
+/// @brief Expand directories to the `.sir` files they contain
+std::vector<std::string> collectFiles(const std::vector<std::string>& paths) {
+  std::vector<std::string> files;
+  for(const std::string& path : paths) {
+    DIR* dir = ::opendir(path.c_str());
+    if(!dir) {
+      files.push_back(path);
+      continue;
+    }
+    std::vector<std::string> entries;
+    while(struct dirent* entry = ::readdir(dir))
+      if(getExtension(entry->d_name) == "sir")
+        entries.push_back(path + "/" + entry->d_name);
+    ::closedir(dir);
+    std::sort(entries.begin(), entries.end());
+    files.insert(files.end(), entries.begin(), entries.end());
+  }
+  return files;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  Settings settings;
+  std::vector<std::string> paths;
+  for(int i = 1; i < argc; ++i) {
+    auto value = [&]() -> std::string {
+      if(i + 1 == argc) {
+        std::cerr << argv[0] << ": missing value of '" << argv[i] << "'\n";
+        std::exit(1);
+      }
+      return argv[++i];
+    };
+    if(std::strcmp(argv[i], "--cxx") == 0)
+      settings.CXX = value();
+    else if(std::strcmp(argv[i], "--runtime") == 0)
+      settings.RuntimeDir = value();
+    else if(std::strcmp(argv[i], "--options") == 0) {
+      std::istringstream ss(value());
+      for(std::string name; std::getline(ss, name, ',');)
+        settings.Options.push_back(name);
+    } else if(std::strcmp(argv[i], "--repetitions") == 0)
+      settings.Repetitions = std::atoi(value().c_str());
+    else if(std::strcmp(argv[i], "--tolerance") == 0)
+      settings.Tolerance = std::atof(value().c_str());
+    else if(std::strcmp(argv[i], "--keep") == 0)
+      settings.Keep = true;
+    else
+      paths.emplace_back(argv[i]);
+  }
+
+  std::vector<std::string> files = collectFiles(paths);
+  if(files.empty()) {
+    std::cerr << "usage: " << argv[0] << " [--cxx <compiler>] [--runtime <dir>] "
+              << "[--options <name,...>] [--repetitions <n>] [--tolerance <tol>] [--keep] "
+              << "<file.sir|directory>...\n";
+    return 1;
+  }
+
+  std::vector<std::string> failures;
+  for(const std::string& file : files)
+    if(!testFile(file, settings))
+      failures.push_back(file);
+
+  std::cout << "\n" << files.size() - failures.size() << " of " << files.size() << " passed\n";
+  for(const std::string& file : failures)
+    std::cout << "  FAILED: " << file << "\n";
+  return failures.empty() ? 0 : 1;
+}
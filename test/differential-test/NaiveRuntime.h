@@ -0,0 +1,311 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+// Self-contained runtime for the code of the naive C++ backend (`CXXNaiveCodeGen`)
+//
+// This header provides the small subset of the gridtools (clang DSL) interface used by the
+// generated code (domain, storages, views, globals and the math functions) as well as the helpers
+// of the programs generated by `DawnDifferentialTest`. It only depends on the standard library.
+
+#ifndef DAWN_TEST_DIFFERENTIALTEST_NAIVERUNTIME_H
+#define DAWN_TEST_DIFFERENTIALTEST_NAIVERUNTIME_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace gridtools {
+
+template <int IMinus, int IPlus, int KMinus>
+struct halo {};
+
+/// @brief Dimensions of a storage
+///
+/// Storages of fields which do not extend in all dimensions have size one in these dimensions and
+/// ignore the corresponding index.
+struct storage_info {
+  int ISize, JSize, KSize;
+
+  storage_info(int isize, int jsize, int ksize) : ISize(isize), JSize(jsize), KSize(ksize) {}
+  int size() const { return ISize * JSize * KSize; }
+  int index(int i, int j, int k) const {
+    return (KSize > 1 ? k * JSize * ISize : 0) + (JSize > 1 ? j * ISize : 0) + (ISize > 1 ? i : 0);
+  }
+};
+
+/// @brief Three dimensional storage of `T` (zero initialized)
+template <class T, class StorageInfo = storage_info>
+class data_store {
+  storage_info info_;
+  std::vector<T> data_;
+
+public:
+  using value_type = T;
+
+  data_store(const storage_info& info, const std::string& = "")
+      : info_(info), data_(info.size(), T()) {}
+
+  void sync() {}
+  const storage_info& info() const { return info_; }
+  std::vector<T>& data() { return data_; }
+  const std::vector<T>& data() const { return data_; }
+};
+
+/// @brief View of a storage
+template <class StorageType>
+class data_view {
+  const storage_info* info_;
+  typename StorageType::value_type* data_;
+
+public:
+  data_view(StorageType& storage) : info_(&storage.info()), data_(storage.data().data()) {}
+
+  typename StorageType::value_type& operator()(int i, int j, int k) const {
+    assert((info_->ISize == 1 || (0 <= i && i < info_->ISize)) &&
+           (info_->JSize == 1 || (0 <= j && j < info_->JSize)) &&
+           (info_->KSize == 1 || (0 <= k && k < info_->KSize)) && "access out of bounds");
+    return data_[info_->index(i, j, k)];
+  }
+};
+
+template <class StorageType>
+data_view<StorageType> make_host_view(StorageType& storage) {
+  return data_view<StorageType>(storage);
+}
+
+namespace clang {
+
+using float_type = double;
+
+using meta_data_t = storage_info;
+using storage_t = data_store<float_type>;
+
+#define DAWN_NAIVE_RUNTIME_STORAGE(dims)                                                           \
+  using meta_data_##dims##_t = storage_info;                                                       \
+  using storage_##dims##_t = data_store<float_type>;
+DAWN_NAIVE_RUNTIME_STORAGE(ijk)
+DAWN_NAIVE_RUNTIME_STORAGE(ij)
+DAWN_NAIVE_RUNTIME_STORAGE(ik)
+DAWN_NAIVE_RUNTIME_STORAGE(jk)
+DAWN_NAIVE_RUNTIME_STORAGE(i)
+DAWN_NAIVE_RUNTIME_STORAGE(j)
+DAWN_NAIVE_RUNTIME_STORAGE(k)
+#undef DAWN_NAIVE_RUNTIME_STORAGE
+
+struct storage_traits_t {
+  template <int Id, int NumDims, class Halo>
+  using storage_info_t = storage_info;
+
+  template <class T, class StorageInfo>
+  using data_store_t = data_store<T, StorageInfo>;
+};
+
+/// @brief Domain of a stencil (the sizes include the halos)
+class domain {
+  std::array<int, 3> sizes_;
+  std::array<int, 6> halos_;
+
+public:
+  domain(int isize, int jsize, int ksize)
+      : sizes_{{isize, jsize, ksize}}, halos_{{0, 0, 0, 0, 0, 0}} {}
+
+  void set_halos(int iminus, int iplus, int jminus, int jplus, int kminus, int kplus) {
+    halos_ = {{iminus, iplus, jminus, jplus, kminus, kplus}};
+  }
+
+  int isize() const { return sizes_[0]; }
+  int jsize() const { return sizes_[1]; }
+  int ksize() const { return sizes_[2]; }
+  int iminus() const { return halos_[0]; }
+  int iplus() const { return halos_[1]; }
+  int jminus() const { return halos_[2]; }
+  int jplus() const { return halos_[3]; }
+  int kminus() const { return halos_[4]; }
+  int kplus() const { return halos_[5]; }
+};
+
+/// @brief Singleton holding the global variables of a stencil
+template <class Derived>
+struct globals_impl {
+  static Derived* s_instance;
+
+  static Derived& get() {
+    if(!s_instance)
+      s_instance = new Derived;
+    return *s_instance;
+  }
+
+  template <class T>
+  struct variable_adapter_impl {
+    T value_;
+
+    variable_adapter_impl(T value) : value_(value) {}
+    T& get_value() { return value_; }
+  };
+};
+
+namespace math {
+using std::exp;
+using std::fabs;
+using std::floor;
+using std::ceil;
+using std::log;
+using std::pow;
+using std::sqrt;
+using std::sin;
+using std::cos;
+using std::tan;
+
+template <class T>
+T min(T a, T b) {
+  return a < b ? a : b;
+}
+template <class T>
+T max(T a, T b) {
+  return a < b ? b : a;
+}
+} // namespace math
+
+} // namespace clang
+} // namespace gridtools
+
+/// @brief Field argument of a stencil function call (view and offset of the call site)
+template <class DataView>
+struct param_wrapper {
+  DataView dview_;
+  std::array<int, 3> offsets_;
+
+  param_wrapper(DataView dview, std::array<int, 3> offsets) : dview_(dview), offsets_(offsets) {}
+};
+
+inline std::array<int, 3> operator+(std::array<int, 3> a, const std::array<int, 3>& b) {
+  for(int i = 0; i < 3; ++i)
+    a[i] += b[i];
+  return a;
+}
+
+using gridtools::clang::float_type;
+using gridtools::clang::storage_traits_t;
+
+namespace differential {
+
+using storage_t = gridtools::clang::storage_t;
+
+/// @brief Runs the stencils of all configurations and compares them to the reference
+///
+/// Usage: <program> [isize] [jsize] [ksize] [repetitions] [tolerance]
+class Test {
+  gridtools::clang::domain dom_;
+  int halo_;
+  int repetitions_;
+  double tolerance_;
+  bool failed_ = false;
+
+  // Output fields of the reference configuration (per stencil)
+  std::map<std::string, std::vector<storage_t>> reference_;
+
+public:
+  /// @param halo  Number of halo points of the storages in the horizontal dimensions and above the
+  ///               vertical domain
+  Test(int argc, char* argv[], int halo)
+      : dom_(size(argc, argv, 1, 12) + 2 * halo, size(argc, argv, 2, 12) + 2 * halo,
+             size(argc, argv, 3, 32) + halo),
+        halo_(halo), repetitions_(argc > 4 ? std::atoi(argv[4]) : 5),
+        tolerance_(argc > 5 ? std::atof(argv[5]) : 1e-10) {
+    dom_.set_halos(halo, halo, halo, halo, 0, halo);
+  }
+
+  const gridtools::clang::domain& dom() const { return dom_; }
+
+  /// @brief Fields of a stencil (initialized with random values depending on their names)
+  std::vector<storage_t> makeFields(const std::vector<std::string>& names) const {
+    std::vector<storage_t> fields;
+    for(const std::string& name : names) {
+      fields.emplace_back(gridtools::storage_info(dom_.isize(), dom_.jsize(), dom_.ksize()), name);
+      std::mt19937 gen(std::hash<std::string>()(name));
+      std::uniform_real_distribution<double> dist(-1.0, 1.0);
+      for(double& value : fields.back().data())
+        value = dist(gen);
+    }
+    return fields;
+  }
+
+  /// @brief Run `stencil` once and compare the `fields` to the reference (or store them if this is
+  /// the reference configuration) then time `repetitions` further runs
+  ///
+  /// Prints `<config> <stencil> <time per run [ms]> <maximum relative error> <OK|MISMATCH>`.
+  ///
+  /// @param tolerance  Maximum relative error of the configuration (0 for the default tolerance)
+  void check(const std::string& config, const std::string& stencil, bool isReference,
+             double tolerance, std::vector<storage_t>& fields, const std::function<void()>& run) {
+    run();
+
+    double maxError = 0;
+    if(isReference)
+      reference_.emplace(stencil, fields);
+    else {
+      const std::vector<storage_t>& reference = reference_.at(stencil);
+      for(std::size_t f = 0; f < fields.size(); ++f)
+        maxError = std::max(maxError, maxRelativeError(fields[f], reference[f]));
+    }
+    bool ok = maxError <= (tolerance > 0 ? tolerance : tolerance_);
+    failed_ |= !ok;
+
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < repetitions_; ++i)
+      run();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                    .count() /
+                std::max(1, repetitions_);
+
+    std::printf("%s %s %.6f %.3e %s\n", config.c_str(), stencil.c_str(), ms, maxError,
+                ok ? "OK" : "MISMATCH");
+    std::fflush(stdout);
+  }
+
+  int result() const { return failed_ ? 1 : 0; }
+
+private:
+  static int size(int argc, char* argv[], int idx, int defaultSize) {
+    return argc > idx ? std::atoi(argv[idx]) : defaultSize;
+  }
+
+  /// @brief Maximum relative error in the compute domain (the halos are not defined)
+  double maxRelativeError(const storage_t& a, const storage_t& b) const {
+    const gridtools::storage_info& info = a.info();
+    double maxError = 0;
+    for(int k = 0; k < dom_.ksize() - dom_.kplus(); ++k)
+      for(int j = halo_; j < dom_.jsize() - halo_; ++j)
+        for(int i = halo_; i < dom_.isize() - halo_; ++i) {
+          double x = a.data()[info.index(i, j, k)], y = b.data()[info.index(i, j, k)];
+          double error = std::fabs(x - y) / std::max(1.0, std::max(std::fabs(x), std::fabs(y)));
+          if(!(error <= maxError)) // NaN counts as mismatch
+            maxError = std::isnan(error) ? INFINITY : error;
+        }
+    return maxError;
+  }
+};
+
+} // namespace differential
+
+#endif
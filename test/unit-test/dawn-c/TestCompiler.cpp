@@ -13,12 +13,22 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn-c/Compiler.h"
+#include "dawn-c/ErrorHandling.h"
+#include "dawn-c/Options.h"
+#include "dawn-c/Service.h"
 #include "dawn-c/TranslationUnit.h"
 #include "dawn/SIR/SIR.h"
 #include "dawn/SIR/SIRSerializer.h"
 #include "dawn/Unittest/ASTSimplifier.h"
+#include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 namespace {
 
@@ -44,7 +54,7 @@ TEST(CompilerTest, CompileEmptySIR) {
   dawnTranslationUnitDestroy(TU);
 }
 
-TEST(CompilerTest, CompileCopyStencil) {
+static std::string makeCopyStencilSIR() {
   using namespace dawn::astgen;
 
   // Build copy stencil
@@ -71,8 +81,21 @@ TEST(CompilerTest, CompileCopyStencil) {
   stencil->StencilDescAst = std::make_shared<dawn::AST>(block(verticalRegion(vr)));
   sir->Stencils.emplace_back(stencil);
 
-  std::string sirStr =
-      dawn::SIRSerializer::serializeToString(sir.get(), dawn::SIRSerializer::SK_Byte);
+  return dawn::SIRSerializer::serializeToString(sir.get(), dawn::SIRSerializer::SK_Byte);
+}
+
+/// @brief Generated code of the stencil `name` (empty if `TU` is `NULL`)
+static std::string getStencil(const dawnTranslationUnit_t* TU, const char* name) {
+  if(!TU)
+    return "";
+  char* code = dawnTranslationUnitGetStencil(TU, name);
+  std::string str = code ? code : "";
+  std::free(code);
+  return str;
+}
+
+TEST(CompilerTest, CompileCopyStencil) {
+  std::string sirStr = makeCopyStencilSIR();
   dawnTranslationUnit_t* TU = dawnCompile(sirStr.data(), sirStr.size(), nullptr, DC_GTClang);
 
   char* copyCode = dawnTranslationUnitGetStencil(TU, "copy");
@@ -89,4 +112,413 @@ TEST(CompilerTest, CompileCopyStencil) {
   dawnTranslationUnitDestroy(TU);
 }
 
+TEST(CompilerTest, ViewCopyStencil) {
+  std::string sirStr = makeCopyStencilSIR();
+  dawnTranslationUnit_t* TU = dawnCompile(sirStr.data(), sirStr.size(), nullptr, DC_GTClang);
+
+  // The views match the copies
+  const char* code;
+  size_t size;
+  ASSERT_EQ(dawnTranslationUnitViewStencil(TU, "copy", &code, &size), 1);
+  char* copyCode = dawnTranslationUnitGetStencil(TU, "copy");
+  EXPECT_EQ(std::string(code, size), copyCode);
+  EXPECT_EQ(code[size], '\0');
+  std::free(copyCode);
+
+  EXPECT_EQ(dawnTranslationUnitViewStencil(TU, "invalid", &code, &size), 0);
+  EXPECT_EQ(code, nullptr);
+  EXPECT_EQ(size, 0);
+
+  dawnTranslationUnitViewGlobals(TU, &code, &size);
+  char* globals = dawnTranslationUnitGetGlobals(TU);
+  EXPECT_EQ(std::string(code, size), globals);
+  std::free(globals);
+
+  char** ppDefines;
+  int numPPDefines;
+  dawnTranslationUnitGetPPDefines(TU, &ppDefines, &numPPDefines);
+  ASSERT_EQ(dawnTranslationUnitGetNumPPDefines(TU), numPPDefines);
+  for(int i = 0; i < numPPDefines; ++i) {
+    dawnTranslationUnitViewPPDefine(TU, i, &code, &size);
+    EXPECT_EQ(std::string(code, size), ppDefines[i]);
+  }
+  freeCharArray(ppDefines, numPPDefines);
+
+  // The only stencil is `copy`
+  dawnStencilIterator_t* iterator = dawnTranslationUnitGetStencilIterator(TU);
+  const char* name;
+  size_t nameSize;
+  ASSERT_EQ(dawnStencilIteratorNext(iterator, &name, &nameSize, &code, &size), 1);
+  EXPECT_EQ(std::string(name, nameSize), "copy");
+  EXPECT_EQ(std::string(code, size), getStencil(TU, "copy"));
+  EXPECT_EQ(dawnStencilIteratorNext(iterator, &name, &nameSize, &code, &size), 0);
+  dawnStencilIteratorDestroy(iterator);
+
+  dawnTranslationUnitDestroy(TU);
+}
+
+TEST(CompilerTest, CompileCopyStencilSplit) {
+  std::string sirStr = makeCopyStencilSIR();
+
+  dawnOptions_t* options = dawnOptionsCreate();
+  dawnOptionsEntry_t* entry = dawnOptionsEntryCreateInteger(1);
+  dawnOptionsSet(options, "SplitTranslationUnit", entry);
+  dawnOptionsEntryDestroy(entry);
+
+  dawnTranslationUnit_t* TU = dawnCompile(sirStr.data(), sirStr.size(), options, DC_GTClang);
+
+  char** filenames;
+  int size;
+  dawnTranslationUnitGetFilenames(TU, &filenames, &size);
+
+  // Shared header, header and source of `copy` and the CMake fragment
+  ASSERT_EQ(size, 4);
+  EXPECT_STREQ(filenames[0], "dawn_generated.cmake");
+  EXPECT_STREQ(filenames[1], "dawn_generated.hpp");
+  EXPECT_STREQ(filenames[2], "dawn_generated_copy.cpp");
+  EXPECT_STREQ(filenames[3], "dawn_generated_copy.hpp");
+
+  char* source = dawnTranslationUnitGetFile(TU, "dawn_generated_copy.cpp");
+  ASSERT_NE(source, nullptr);
+  EXPECT_NE(std::strstr(source, "gridtools::copy::copy(const gridtools::clang::domain& dom, "),
+            nullptr);
+  EXPECT_NE(std::strstr(source, "template gridtools::copy::copy(const gridtools::clang::domain&, "
+                                "gridtools::clang::storage_t, gridtools::clang::storage_t);"),
+            nullptr);
+
+  // The header only declares the wrapper constructor
+  char* header = dawnTranslationUnitGetFile(TU, "dawn_generated_copy.hpp");
+  ASSERT_NE(header, nullptr);
+  EXPECT_NE(std::strstr(header, "copy(const gridtools::clang::domain& dom, S1 "), nullptr);
+  EXPECT_EQ(std::strstr(header, "m_stencil_0(dom, "), nullptr);
+
+  EXPECT_EQ(dawnTranslationUnitGetFile(TU, "invalid"), nullptr);
+
+  const char* content;
+  size_t contentSize;
+  ASSERT_EQ(dawnTranslationUnitViewFile(TU, "dawn_generated_copy.hpp", &content, &contentSize), 1);
+  EXPECT_EQ(std::string(content, contentSize), header);
+  EXPECT_EQ(dawnTranslationUnitViewFile(TU, "invalid", &content, &contentSize), 0);
+
+  std::free(header);
+  std::free(source);
+  freeCharArray(filenames, size);
+  dawnTranslationUnitDestroy(TU);
+  dawnOptionsDestroy(options);
+}
+
+TEST(CompilerTest, ReuseCompiler) {
+  std::string sirStr = makeCopyStencilSIR();
+  dawnTranslationUnit_t* reference = dawnCompile(sirStr.data(), sirStr.size(), nullptr, DC_GTClang);
+  std::string referenceCode = getStencil(reference, "copy");
+  ASSERT_NE(referenceCode, "");
+
+  // The second compilation is answered from the cache, the third one after clearing it
+  dawnCompiler_t* compiler = dawnCompilerCreate(nullptr);
+  for(int i = 0; i < 3; ++i) {
+    if(i == 2)
+      dawnCompilerClearCache(compiler);
+    dawnTranslationUnit_t* TU =
+        dawnCompilerCompile(compiler, sirStr.data(), sirStr.size(), DC_GTClang);
+    EXPECT_EQ(getStencil(TU, "copy"), referenceCode);
+    dawnTranslationUnitDestroy(TU);
+  }
+
+  // Different backends are cached separately
+  dawnTranslationUnit_t* TU =
+      dawnCompilerCompile(compiler, sirStr.data(), sirStr.size(), DC_GTClangNaiveCXX);
+  EXPECT_NE(getStencil(TU, "copy"), "");
+  EXPECT_NE(getStencil(TU, "copy"), referenceCode);
+
+  dawnTranslationUnitDestroy(TU);
+  dawnCompilerDestroy(compiler);
+  dawnTranslationUnitDestroy(reference);
+}
+
+TEST(CompilerTest, ReuseCompilerAfterFailure) {
+  dawnInstallFatalErrorHandler(dawnStateErrorHandler);
+  dawnCompiler_t* compiler = dawnCompilerCreate(nullptr);
+
+  std::string invalid = "invalid";
+  EXPECT_EQ(dawnCompilerCompile(compiler, invalid.data(), invalid.size(), DC_GTClang), nullptr);
+  EXPECT_TRUE(dawnStateErrorHandlerHasError());
+  dawnStateErrorHandlerResetState();
+
+  std::string sirStr = makeCopyStencilSIR();
+  dawnTranslationUnit_t* TU =
+      dawnCompilerCompile(compiler, sirStr.data(), sirStr.size(), DC_GTClang);
+  EXPECT_NE(getStencil(TU, "copy"), "");
+  EXPECT_FALSE(dawnStateErrorHandlerHasError());
+
+  dawnTranslationUnitDestroy(TU);
+  dawnCompilerDestroy(compiler);
+  dawnInstallFatalErrorHandler(nullptr);
+}
+
+TEST(CompilerTest, CompileBatch) {
+  std::string sirStr = makeCopyStencilSIR();
+  dawnTranslationUnit_t* reference = dawnCompile(sirStr.data(), sirStr.size(), nullptr, DC_GTClang);
+
+  // The third SIR is invalid
+  std::string invalid = "invalid";
+  const int num = 6;
+  std::vector<const char*> SIRs(num, sirStr.data());
+  std::vector<size_t> sizes(num, sirStr.size());
+  SIRs[2] = invalid.data();
+  sizes[2] = invalid.size();
+
+  // The failure is reported as a diagnostic of the SIR, the fatal error handler is not invoked
+  dawnInstallFatalErrorHandler(dawnStateErrorHandler);
+  std::vector<dawnTranslationUnit_t*> TUs(num);
+  std::vector<dawnDiagnostic_t*> diagnostics(num);
+  std::vector<int> numDiagnostics(num);
+  EXPECT_EQ(dawnCompileBatch(SIRs.data(), sizes.data(), num, nullptr, DC_GTClang, TUs.data(),
+                             diagnostics.data(), numDiagnostics.data()),
+            1);
+  EXPECT_FALSE(dawnStateErrorHandlerHasError());
+  dawnInstallFatalErrorHandler(nullptr);
+
+  for(int i = 0; i < num; ++i) {
+    if(i == 2) {
+      EXPECT_EQ(TUs[i], nullptr);
+      ASSERT_GE(numDiagnostics[i], 1);
+      EXPECT_EQ(diagnostics[i][numDiagnostics[i] - 1].Kind, DD_Error);
+    } else {
+      EXPECT_EQ(getStencil(TUs[i], "copy"), getStencil(reference, "copy"));
+      EXPECT_EQ(numDiagnostics[i], 0);
+    }
+    dawnDiagnosticsDestroy(diagnostics[i], numDiagnostics[i]);
+    dawnTranslationUnitDestroy(TUs[i]);
+  }
+  dawnTranslationUnitDestroy(reference);
+}
+
+/// @brief Callback counting the finished compilations
+static void countFinished(void* userData) { ++*static_cast<std::atomic<int>*>(userData); }
+
+TEST(CompilerTest, CompileAsync) {
+  std::string sirStr = makeCopyStencilSIR();
+  dawnTranslationUnit_t* reference = dawnCompile(sirStr.data(), sirStr.size(), nullptr, DC_GTClang);
+
+  std::atomic<int> numFinished(0);
+  std::vector<dawnCompileFuture_t*> futures;
+  for(int i = 0; i < 4; ++i)
+    futures.push_back(dawnCompileAsync(sirStr.data(), sirStr.size(), nullptr, DC_GTClang,
+                                       countFinished, &numFinished));
+
+  for(dawnCompileFuture_t* future : futures) {
+    dawnCompileFutureWait(future);
+    EXPECT_EQ(dawnCompileFuturePoll(future), 1);
+    dawnTranslationUnit_t* TU = dawnCompileFutureGet(future);
+    EXPECT_EQ(getStencil(TU, "copy"), getStencil(reference, "copy"));
+    dawnTranslationUnitDestroy(TU);
+  }
+
+  // The result can only be taken once
+  dawnInstallFatalErrorHandler(dawnStateErrorHandler);
+  EXPECT_EQ(dawnCompileFutureGet(futures.front()), nullptr);
+  EXPECT_TRUE(dawnStateErrorHandlerHasError());
+  dawnStateErrorHandlerResetState();
+
+  // Failures are reported when the result is taken
+  dawnCompileFuture_t* failed =
+      dawnCompileAsync("invalid", 7, nullptr, DC_GTClang, nullptr, nullptr);
+  EXPECT_FALSE(dawnStateErrorHandlerHasError());
+  EXPECT_EQ(dawnCompileFutureGet(failed), nullptr);
+  EXPECT_TRUE(dawnStateErrorHandlerHasError());
+  dawnStateErrorHandlerResetState();
+  dawnInstallFatalErrorHandler(nullptr);
+
+  for(dawnCompileFuture_t* future : futures)
+    dawnCompileFutureDestroy(future);
+  dawnCompileFutureDestroy(failed);
+  dawnTranslationUnitDestroy(reference);
+
+  // The callbacks are invoked after the result is available
+  while(numFinished != 4)
+    std::this_thread::yield();
+}
+
+/// @brief Diagnostics passed to `collectDiagnostic`
+struct DiagnosticsCollector {
+  std::vector<std::pair<DawnDiagnosticsKind, std::string>> Diagnostics;
+};
+
+static void collectDiagnostic(DawnDiagnosticsKind diag, int line, int column,
+                              const char* filename, const char* msg, void* userData) {
+  static_cast<DiagnosticsCollector*>(userData)->Diagnostics.emplace_back(diag, msg);
+}
+
+TEST(CompilerTest, CompileWithDiagnostics) {
+  dawnInstallFatalErrorHandler(dawnStateErrorHandler);
+
+  std::string sirStr = makeCopyStencilSIR();
+  DiagnosticsCollector collector;
+  dawnDiagnostic_t* diagnostics = nullptr;
+  int numDiagnostics = -1;
+  dawnTranslationUnit_t* TU =
+      dawnCompileWithDiagnostics(sirStr.data(), sirStr.size(), nullptr, DC_GTClang,
+                                 collectDiagnostic, &collector, &diagnostics, &numDiagnostics);
+  EXPECT_NE(getStencil(TU, "copy"), "");
+  EXPECT_EQ(numDiagnostics, collector.Diagnostics.size());
+  dawnDiagnosticsDestroy(diagnostics, numDiagnostics);
+  dawnTranslationUnitDestroy(TU);
+
+  // Failures are reported as errors instead of invoking the fatal error handler
+  std::string invalid = "invalid";
+  collector.Diagnostics.clear();
+  EXPECT_EQ(dawnCompileWithDiagnostics(invalid.data(), invalid.size(), nullptr, DC_GTClang,
+                                       collectDiagnostic, &collector, &diagnostics,
+                                       &numDiagnostics),
+            nullptr);
+  EXPECT_FALSE(dawnStateErrorHandlerHasError());
+  ASSERT_EQ(numDiagnostics, 1);
+  EXPECT_EQ(diagnostics[0].Kind, DD_Error);
+  EXPECT_NE(std::strstr(diagnostics[0].Message, "cannot deserialize SIR"), nullptr);
+  ASSERT_EQ(collector.Diagnostics.size(), 1);
+  EXPECT_EQ(collector.Diagnostics[0].second, diagnostics[0].Message);
+  dawnDiagnosticsDestroy(diagnostics, numDiagnostics);
+
+  // The same holds for the reusable compiler
+  dawnCompiler_t* compiler = dawnCompilerCreate(nullptr);
+  EXPECT_EQ(dawnCompilerCompileWithDiagnostics(compiler, invalid.data(), invalid.size(),
+                                               DC_GTClang, nullptr, nullptr, &diagnostics,
+                                               &numDiagnostics),
+            nullptr);
+  EXPECT_EQ(numDiagnostics, 1);
+  EXPECT_FALSE(dawnStateErrorHandlerHasError());
+  dawnDiagnosticsDestroy(diagnostics, numDiagnostics);
+  dawnCompilerDestroy(compiler);
+
+  dawnInstallFatalErrorHandler(nullptr);
+}
+
+TEST(CompilerTest, ConcurrentCompilation) {
+  std::string sirStr = makeCopyStencilSIR();
+  std::string invalid = "invalid";
+  dawnTranslationUnit_t* reference = dawnCompile(sirStr.data(), sirStr.size(), nullptr, DC_GTClang);
+  std::string referenceCode = getStencil(reference, "copy");
+  dawnTranslationUnitDestroy(reference);
+
+  // Every other thread compiles an invalid SIR, the diagnostics of the threads must not mix
+  const int numThreads = 8;
+  std::vector<DiagnosticsCollector> collectors(numThreads);
+  std::vector<std::string> code(numThreads);
+  std::vector<int> hadFatalError(numThreads, 0);
+  dawnInstallFatalErrorHandler(dawnStateErrorHandler);
+
+  std::vector<std::thread> threads;
+  for(int i = 0; i < numThreads; ++i)
+    threads.emplace_back([&, i]() {
+      const std::string& input = i % 2 ? invalid : sirStr;
+      for(int iteration = 0; iteration < 4; ++iteration) {
+        dawnTranslationUnit_t* TU =
+            dawnCompileWithDiagnostics(input.data(), input.size(), nullptr, DC_GTClang,
+                                       collectDiagnostic, &collectors[i], nullptr, nullptr);
+        code[i] = getStencil(TU, "copy");
+        dawnTranslationUnitDestroy(TU);
+
+        // The error state of the state error handler is kept per thread
+        dawnStateErrorHandlerResetState();
+        dawnTranslationUnitDestroy(dawnCompile(input.data(), input.size(), nullptr, DC_GTClang));
+        hadFatalError[i] += dawnStateErrorHandlerHasError();
+      }
+    });
+  for(std::thread& thread : threads)
+    thread.join();
+  dawnStateErrorHandlerResetState();
+  dawnInstallFatalErrorHandler(nullptr);
+
+  for(int i = 0; i < numThreads; ++i) {
+    if(i % 2) {
+      EXPECT_EQ(code[i], "");
+      EXPECT_EQ(collectors[i].Diagnostics.size(), 4);
+      EXPECT_EQ(hadFatalError[i], 4);
+    } else {
+      EXPECT_EQ(code[i], referenceCode);
+      EXPECT_TRUE(collectors[i].Diagnostics.empty());
+      EXPECT_EQ(hadFatalError[i], 0);
+    }
+  }
+}
+
+TEST(ServiceTest, CompileCopyStencil) {
+  std::string sirStr = makeCopyStencilSIR();
+  std::string socketPath = "/tmp/dawn-test-service-" + std::to_string(::getpid()) + ".sock";
+
+  dawnCompiler_t* compiler = dawnCompilerCreate(nullptr);
+  dawnTranslationUnit_t* reference =
+      dawnCompilerCompile(compiler, sirStr.data(), sirStr.size(), DC_GTClang);
+
+  int status = -1;
+  std::thread service([&]() { status = dawnServiceRun(compiler, socketPath.c_str()); });
+
+  // Retry until the service accepts connections
+  dawnInstallFatalErrorHandler(dawnStateErrorHandler);
+  dawnTranslationUnit_t* TU = nullptr;
+  for(int attempt = 0; attempt < 500 && !TU; ++attempt) {
+    dawnStateErrorHandlerResetState();
+    TU = dawnServiceCompile(socketPath.c_str(), sirStr.data(), sirStr.size(), DC_GTClang);
+    if(!TU)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_NE(TU, nullptr);
+  EXPECT_EQ(getStencil(TU, "copy"), getStencil(reference, "copy"));
+
+  // Failed compilations are reported to the client
+  std::string invalid = "invalid";
+  dawnStateErrorHandlerResetState();
+  EXPECT_EQ(dawnServiceCompile(socketPath.c_str(), invalid.data(), invalid.size(), DC_GTClang),
+            nullptr);
+  EXPECT_TRUE(dawnStateErrorHandlerHasError());
+  dawnStateErrorHandlerResetState();
+
+  // A second service can not take over the socket
+  EXPECT_EQ(dawnServiceRun(compiler, socketPath.c_str()), 1);
+  EXPECT_TRUE(dawnStateErrorHandlerHasError());
+  dawnStateErrorHandlerResetState();
+
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, socketPath.c_str());
+
+  // Oversized messages are rejected by closing the connection
+  {
+    int client = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(client, 0);
+    ASSERT_EQ(::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    struct {
+      std::uint32_t Magic, Kind;
+      std::uint64_t Size;
+    } header{0x4e574144, 1, std::uint64_t(1) << 40};
+    EXPECT_EQ(::send(client, &header, sizeof(header), 0), sizeof(header));
+    char byte;
+    EXPECT_EQ(::recv(client, &byte, 1, 0), 0);
+    ::close(client);
+  }
+
+  // An idle client does not hold up the others (nor the shutdown)
+  int idleClient = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_GE(idleClient, 0);
+  ASSERT_EQ(::connect(idleClient, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+  dawnTranslationUnit_t* TU2 =
+      dawnServiceCompile(socketPath.c_str(), sirStr.data(), sirStr.size(), DC_GTClang);
+  ASSERT_NE(TU2, nullptr);
+  EXPECT_EQ(getStencil(TU2, "copy"), getStencil(reference, "copy"));
+  dawnTranslationUnitDestroy(TU2);
+
+  EXPECT_EQ(dawnServiceShutdown(socketPath.c_str()), 0);
+  service.join();
+  EXPECT_EQ(status, 0);
+  ::close(idleClient);
+  EXPECT_NE(::access(socketPath.c_str(), F_OK), 0);
+  dawnInstallFatalErrorHandler(nullptr);
+
+  dawnTranslationUnitDestroy(TU);
+  dawnTranslationUnitDestroy(reference);
+  dawnCompilerDestroy(compiler);
+}
+
 } // anonymous namespace
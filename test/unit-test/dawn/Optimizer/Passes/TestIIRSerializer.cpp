@@ -0,0 +1,139 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/CodeGen/CXXNaive/CXXNaiveCodeGen.h"
+#include "dawn/CodeGen/GridTools/GTCodeGen.h"
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Compiler/Options.h"
+#include "dawn/Optimizer/IIRSerializer.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/SIR/SIRSerializer.h"
+#include "test/unit-test/dawn/Optimizer/TestEnvironment.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <streambuf>
+
+using namespace dawn;
+
+namespace {
+
+/// @brief Generated code of all stencils (GridTools and naive C++ backend)
+std::string generateCode(OptimizerContext* context) {
+  std::string code;
+  auto append = [&](std::unique_ptr<codegen::TranslationUnit> translationUnit) {
+    code += translationUnit->getGlobals();
+    for(const auto& nameCodePair : translationUnit->getStencils())
+      code += nameCodePair.first + "\n" + nameCodePair.second;
+  };
+  append(codegen::gt::GTCodeGen(context).generateCode());
+  append(codegen::cxxnaive::CXXNaiveCodeGen(context).generateCode());
+  return code;
+}
+
+class IIRSerializerTest : public ::testing::TestWithParam<const char*> {
+protected:
+  dawn::DawnCompiler compiler_;
+
+  std::unique_ptr<OptimizerContext> optimize(const std::string& sirFilename) {
+    std::string filename = TestEnvironment::path_ + "/" + sirFilename;
+    std::ifstream file(filename);
+    DAWN_ASSERT_MSG((file.good()), std::string("File " + filename + " does not exists").c_str());
+
+    std::string jsonstr((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::shared_ptr<SIR> sir =
+        SIRSerializer::deserializeFromString(jsonstr, SIRSerializer::SK_Json);
+
+    std::unique_ptr<OptimizerContext> optimizer = compiler_.runOptimizer(sir);
+    EXPECT_FALSE(compiler_.getDiagnostics().hasErrors());
+    return optimizer;
+  }
+
+  void checkRoundTrip(const std::string& sirFilename) {
+    auto optimizer = optimize(sirFilename);
+    std::string reference = generateCode(optimizer.get());
+
+    for(auto kind : {IIRSerializer::SK_Json, IIRSerializer::SK_Byte}) {
+      std::string str = IIRSerializer::serializeToString(optimizer.get(), kind);
+      auto loaded = IIRSerializer::deserializeFromString(str, compiler_.getDiagnostics(),
+                                                         compiler_.getOptions(), kind);
+      ASSERT_EQ(loaded->getStencilInstantiationMap().size(),
+                optimizer->getStencilInstantiationMap().size());
+      EXPECT_EQ(generateCode(loaded.get()), reference) << sirFilename;
+
+      // Serializing the reloaded IIR again yields the same IIR (the order of the entries of the
+      // JSON maps is unspecified)
+      if(kind == IIRSerializer::SK_Byte) {
+        EXPECT_EQ(IIRSerializer::serializeToString(loaded.get(), kind), str) << sirFilename;
+      }
+    }
+  }
+};
+
+TEST_P(IIRSerializerTest, RoundTrip) { checkRoundTrip(GetParam()); }
+
+TEST_P(IIRSerializerTest, RoundTripWithoutInlining) {
+  compiler_.getOptions().InlineStrategy = "none";
+  checkRoundTrip(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    SIRFiles, IIRSerializerTest,
+    ::testing::Values("compute_extent_test_stencil_01.sir", "compute_extent_test_stencil_03.sir",
+                      "compute_extent_test_stencil_05.sir", "test_field_access_interval_02.sir",
+                      "test_field_access_interval_05.sir", "boundary_condition_test_stencil_01.sir",
+                      "boundary_condition_test_stencil_02.sir",
+                      "boundary_condition_test_stencil_03.sir"));
+
+/// @brief Round trip of split stencils with boundary conditions fused into the stages
+class IIRSerializerBoundaryConditionTest : public IIRSerializerTest {};
+
+TEST_P(IIRSerializerBoundaryConditionTest, RoundTripWithFusedBoundaryConditions) {
+  compiler_.getOptions().SplitStencils = true;
+  compiler_.getOptions().MaxFieldsPerStencil = 2;
+  compiler_.getOptions().FuseBoundaryConditions = true;
+  checkRoundTrip(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(SIRFiles, IIRSerializerBoundaryConditionTest,
+                        ::testing::Values("boundary_condition_test_stencil_01.sir",
+                                          "boundary_condition_test_stencil_03.sir"));
+
+TEST(IIRSerializer, InvalidInput) {
+  DiagnosticsEngine diagnostics;
+  Options options;
+  EXPECT_THROW(IIRSerializer::deserializeFromString("{ invalid", diagnostics, options,
+                                                    IIRSerializer::SK_Json),
+               std::runtime_error);
+  EXPECT_THROW(IIRSerializer::deserialize("does-not-exist.iir", diagnostics, options),
+               std::runtime_error);
+}
+
+TEST(IIRSerializer, CompileFromIIR) {
+  std::string filename = TestEnvironment::path_ + "/boundary_condition_test_stencil_01.sir";
+  std::shared_ptr<SIR> sir = SIRSerializer::deserialize(filename, SIRSerializer::SK_Json);
+
+  Options options;
+  options.SerializeIIR = "TestIIRSerializer.iir";
+  DawnCompiler compiler(&options);
+  auto reference = compiler.compile(sir, DawnCompiler::CG_GTClang);
+  ASSERT_TRUE(reference != nullptr);
+
+  auto translationUnit = compiler.compileFromIIR(options.SerializeIIR, DawnCompiler::CG_GTClang);
+  ASSERT_TRUE(translationUnit != nullptr);
+  EXPECT_EQ(translationUnit->getStencils(), reference->getStencils());
+  EXPECT_EQ(translationUnit->getGlobals(), reference->getGlobals());
+  std::remove(options.SerializeIIR.c_str());
+}
+
+} // anonymous namespace
@@ -0,0 +1,162 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/SIR/ASTStringifier.h"
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+/// @brief Call of the function `math::callee`
+std::shared_ptr<FunCallExpr> call(const std::string& callee,
+                                  std::vector<std::shared_ptr<Expr>> arguments) {
+  auto expr = fcall("math::" + callee);
+  for(const auto& argument : arguments)
+    expr->insertArgument(argument);
+  return expr;
+}
+
+class PassAlgebraicSimplificationTest : public PassTest {
+protected:
+  virtual void SetUp() override { options_.Simplify = true; }
+
+  /// @brief Run the optimizer on a stencil `test` with the fields `in`, `a`, `b`, `out` and `out2`
+  /// computing `body` and return the top-level statements of the stencil
+  std::vector<std::shared_ptr<Stmt>> optimize(const std::shared_ptr<BlockStmt>& body) {
+    PassTest::optimize(makeSIR({"in", "a", "b", "out", "out2"}, body->getStatements()));
+    if(!context_)
+      return std::vector<std::shared_ptr<Stmt>>();
+    return getStatements();
+  }
+
+  /// @brief Simplify `out = rhs` and return the simplified right-hand side as a string
+  std::string simplify(const std::shared_ptr<Expr>& rhs) {
+    auto stmts = optimize(block(expr(assign(field("out"), rhs))));
+    if(stmts.size() != 1)
+      return "";
+    return toString(cast<AssignmentExpr>(cast<ExprStmt>(stmts[0].get())->getExpr().get())
+                        ->getRight());
+  }
+
+  static std::string toString(const std::shared_ptr<Expr>& expr) {
+    return ASTStringifer::toString(expr, 0, false);
+  }
+  static std::string toString(const std::shared_ptr<Stmt>& stmt) {
+    return ASTStringifer::toString(stmt, 0, false);
+  }
+};
+
+TEST_F(PassAlgebraicSimplificationTest, Disabled) {
+  options_.Simplify = false;
+  EXPECT_EQ(simplify(unop(unop(field("in"), "-"), "-")), "(-(-in[0, 0, 0]))");
+}
+
+TEST_F(PassAlgebraicSimplificationTest, ExactRules) {
+  EXPECT_EQ(simplify(unop(unop(field("in"), "-"), "-")), "in[0, 0, 0]");
+  EXPECT_EQ(simplify(binop(lit("1", BuiltinTypeID::Integer), "*", field("in"))), "in[0, 0, 0]");
+  EXPECT_EQ(simplify(binop(field("in"), "/", lit("1.0"))), "in[0, 0, 0]");
+  EXPECT_EQ(simplify(binop(field("in"), "-", lit("0.0"))), "in[0, 0, 0]");
+  EXPECT_EQ(simplify(binop(field("in"), "/", lit("4.0"))), "(in[0, 0, 0] * 0.25)");
+  EXPECT_EQ(simplify(call("pow", {field("in"), lit("1", BuiltinTypeID::Integer)})),
+            "in[0, 0, 0]");
+  EXPECT_EQ(simplify(call("pow", {field("in"), lit("0.0")})), "1");
+
+  // Rewrites which change the rounding need -fast-math
+  EXPECT_EQ(simplify(binop(field("in"), "/", lit("3.0"))), "(in[0, 0, 0] / 3.0)");
+  EXPECT_EQ(simplify(call("pow", {field("in"), lit("2", BuiltinTypeID::Integer)})),
+            "fun-call:math::pow(in[0, 0, 0], 2)");
+}
+
+TEST_F(PassAlgebraicSimplificationTest, KeepTypeChangingIdentities) {
+  // `i * 1.0` is a floating point expression while `i` is an integer
+  auto stmts = optimize(block(vardecl("int", "i", lit("1", BuiltinTypeID::Integer)),
+                              expr(assign(field("out"), binop(var("i"), "*", lit("1.0"))))));
+  ASSERT_EQ(stmts.size(), 2);
+  EXPECT_EQ(toString(cast<AssignmentExpr>(cast<ExprStmt>(stmts[1].get())->getExpr().get())
+                         ->getRight()),
+            "(i * 1.0)");
+}
+
+TEST_F(PassAlgebraicSimplificationTest, FastMathRules) {
+  options_.FastMath = true;
+  EXPECT_EQ(simplify(binop(field("in"), "/", lit("3.0"))), "(in[0, 0, 0] * 0.3333333333333333)");
+  EXPECT_EQ(simplify(call("pow", {field("in"), lit("3", BuiltinTypeID::Integer)})),
+            "((in[0, 0, 0] * in[0, 0, 0]) * in[0, 0, 0])");
+  EXPECT_EQ(simplify(call("pow", {field("in"), unop(lit("2.0"), "-")})),
+            "(1 / (in[0, 0, 0] * in[0, 0, 0]))");
+  EXPECT_EQ(simplify(binop(binop(field("a"), "*", field("b")), "-",
+                           binop(field("in"), "*", field("a")))),
+            "(a[0, 0, 0] * (b[0, 0, 0] - in[0, 0, 0]))");
+  EXPECT_EQ(simplify(call("pow", {binop(field("a"), "+", field("b")), lit("0.5")})),
+            "fun-call:math::sqrt((a[0, 0, 0] + b[0, 0, 0]))");
+  EXPECT_EQ(simplify(call("sqrt", {binop(field("in"), "*", field("in"))})),
+            "fun-call:math::fabs(in[0, 0, 0])");
+  EXPECT_EQ(simplify(binop(call("sqrt", {field("in")}), "*", call("sqrt", {field("in")}))),
+            "in[0, 0, 0]");
+
+  // Different offsets are different values
+  EXPECT_EQ(simplify(call("sqrt", {binop(field("in"), "*", field("in", {{1, 0, 0}}))})),
+            "fun-call:math::sqrt((in[0, 0, 0] * in[1, 0, 0]))");
+}
+
+TEST_F(PassAlgebraicSimplificationTest, SharedReciprocal) {
+  options_.FastMath = true;
+
+  // out = a / in; out2 = b / in; in = a; out = b / in;
+  auto stmts = optimize(block(expr(assign(field("out"), binop(field("a"), "/", field("in")))),
+                              expr(assign(field("out2"), binop(field("b"), "/", field("in")))),
+                              expr(assign(field("in"), field("a"))),
+                              expr(assign(field("out"), binop(field("b"), "/", field("in"))))));
+  ASSERT_EQ(stmts.size(), 5);
+
+  VarDeclStmt* varDecl = dyn_cast<VarDeclStmt>(stmts[0].get());
+  ASSERT_TRUE(varDecl != nullptr);
+  EXPECT_EQ(toString(varDecl->getInitList()[0]), "(1 / in[0, 0, 0])");
+
+  // The division after the write to `in` is left alone
+  std::string rcp = varDecl->getName();
+  EXPECT_EQ(toString(stmts[1]), "out[0, 0, 0] = (a[0, 0, 0] * " + rcp + ");");
+  EXPECT_EQ(toString(stmts[2]), "out2[0, 0, 0] = (b[0, 0, 0] * " + rcp + ");");
+  EXPECT_EQ(toString(stmts[4]), "out[0, 0, 0] = (b[0, 0, 0] / in[0, 0, 0]);");
+}
+
+TEST_F(PassAlgebraicSimplificationTest, SharedReciprocalInterleaved) {
+  options_.FastMath = true;
+
+  // out = a / in; out2 = a / b; out = out2 / in; out2 = out / b;
+  auto stmts = optimize(block(expr(assign(field("out"), binop(field("a"), "/", field("in")))),
+                              expr(assign(field("out2"), binop(field("a"), "/", field("b")))),
+                              expr(assign(field("out"), binop(field("out2"), "/", field("in")))),
+                              expr(assign(field("out2"), binop(field("out"), "/", field("b"))))));
+  ASSERT_EQ(stmts.size(), 6);
+
+  // Each reciprocal is declared right before the first division of its group
+  VarDeclStmt* rcpIn = dyn_cast<VarDeclStmt>(stmts[0].get());
+  VarDeclStmt* rcpB = dyn_cast<VarDeclStmt>(stmts[2].get());
+  ASSERT_TRUE(rcpIn != nullptr && rcpB != nullptr);
+  EXPECT_EQ(toString(rcpIn->getInitList()[0]), "(1 / in[0, 0, 0])");
+  EXPECT_EQ(toString(rcpB->getInitList()[0]), "(1 / b[0, 0, 0])");
+
+  EXPECT_EQ(toString(stmts[1]), "out[0, 0, 0] = (a[0, 0, 0] * " + rcpIn->getName() + ");");
+  EXPECT_EQ(toString(stmts[3]), "out2[0, 0, 0] = (a[0, 0, 0] * " + rcpB->getName() + ");");
+  EXPECT_EQ(toString(stmts[4]), "out[0, 0, 0] = (out2[0, 0, 0] * " + rcpIn->getName() + ");");
+  EXPECT_EQ(toString(stmts[5]), "out2[0, 0, 0] = (out[0, 0, 0] * " + rcpB->getName() + ");");
+}
+
+} // anonymous namespace
@@ -0,0 +1,111 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+/// @brief Build a SIR with a stencil `test` computing `stmts` in a single vertical region and the
+/// boundary condition `zero` applied to the field `mid` (which assigns `bcValue` to the boundary)
+std::shared_ptr<SIR> makeBoundarySIR(const std::vector<std::shared_ptr<Stmt>>& stmts,
+                                     const std::shared_ptr<Expr>& bcValue = lit("0.0")) {
+  auto sir = makeSIR({"in", "mid", "out"}, block(makeBoundaryCondition("zero", {"mid"}),
+                                                 verticalRegion(makeVerticalRegion(stmts))));
+  sir->StencilFunctions.emplace_back(
+      makeStencilFunction("zero", {"f"}, block(expr(assign(field("f"), bcValue)))));
+  return sir;
+}
+
+class PassBoundaryConditionFusionTest : public PassTest {
+protected:
+  /// Each statement becomes a stencil as there are at most two fields per stencil
+  virtual void SetUp() override {
+    options_.SplitStencils = true;
+    options_.MaxFieldsPerStencil = 2;
+    options_.FuseBoundaryConditions = true;
+  }
+
+  void optimize(const std::shared_ptr<SIR>& sir) {
+    PassTest::optimize(sir);
+    ASSERT_EQ(instantiation_->getStencils().size(), 2);
+    ASSERT_EQ(instantiation_->getBoundaryConditionToExtentsMap().size(), 1);
+
+    // The boundary condition is still applied by the stencil description of GridTools
+    EXPECT_FALSE(codegen::gt::GTCodeGen(context_.get()).generateCode()->getStencils().empty());
+  }
+
+  /// @brief Number of boundary conditions fused into the stages of the stencils
+  std::vector<int> getNumFusedBoundaryConditions() const {
+    std::vector<int> numFused;
+    for(const auto& stencil : instantiation_->getStencils()) {
+      numFused.push_back(0);
+      for(const auto& multiStagePtr : stencil->getMultiStages())
+        for(const auto& stagePtr : multiStagePtr->getStages())
+          numFused.back() += stagePtr->getBoundaryConditions().size();
+    }
+    return numFused;
+  }
+
+  std::string generateNaiveCode() const {
+    auto translationUnit = codegen::cxxnaive::CXXNaiveCodeGen(context_.get()).generateCode();
+    return translationUnit->getStencils().at("test");
+  }
+};
+
+TEST_F(PassBoundaryConditionFusionTest, FuseIntoProducingStage) {
+  optimize(makeBoundarySIR({expr(assign(field("mid"), field("in"))),
+                            expr(assign(field("out"), field("mid", {{-1, 0, 0}})))}));
+  EXPECT_EQ(getNumFusedBoundaryConditions(), (std::vector<int>{1, 0}));
+
+  // The boundary points of each level are set in the vertical loop of the first stencil
+  std::string code = generateNaiveCode();
+  EXPECT_NE(code.find("if(i < m_dom.iminus() || i > m_dom.isize() - m_dom.iplus() - 1 || "
+                      "j < m_dom.jminus() || j > m_dom.jsize() - m_dom.jplus() - 1)"),
+            std::string::npos);
+  EXPECT_NE(code.find("mid(i+0,j+0,k+0) = (gridtools::clang::float_type) 0.0"), std::string::npos);
+}
+
+TEST_F(PassBoundaryConditionFusionTest, KeepWhenProducerReadsField) {
+  // The first stencil reads `mid` after computing it, the boundary condition would change the
+  // values it reads in the halo
+  optimize(makeBoundarySIR(
+      {expr(assign(field("mid"), field("in"))),
+       expr(assign(field("mid"), binop(field("mid", {{1, 0, 0}}), "+", lit("1.0")))),
+       expr(assign(field("out"), field("mid", {{-1, 0, 0}})))}));
+  EXPECT_EQ(getNumFusedBoundaryConditions(), (std::vector<int>{0, 0}));
+}
+
+TEST_F(PassBoundaryConditionFusionTest, KeepWhenFunctorHasVerticalOffset) {
+  // The functor reads the level below, which is not computed yet in the fused stage
+  optimize(makeBoundarySIR({expr(assign(field("mid"), field("in"))),
+                            expr(assign(field("out"), field("mid", {{-1, 0, 0}})))},
+                           field("f", {{0, 0, -1}})));
+  EXPECT_EQ(getNumFusedBoundaryConditions(), (std::vector<int>{0, 0}));
+}
+
+TEST_F(PassBoundaryConditionFusionTest, Disabled) {
+  options_.FuseBoundaryConditions = false;
+  PassTest::optimize(makeBoundarySIR({expr(assign(field("mid"), field("in"))),
+                                      expr(assign(field("out"), field("mid", {{-1, 0, 0}})))}));
+  EXPECT_EQ(getNumFusedBoundaryConditions(), (std::vector<int>{0, 0}));
+  EXPECT_EQ(generateNaiveCode().find("m_dom.iminus() ||"), std::string::npos);
+}
+
+} // anonymous namespace
@@ -0,0 +1,225 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+/// @brief Number of operators in `expr`
+int countOperations(const std::shared_ptr<Expr>& expr) {
+  int count = isa<BinaryOperator>(expr.get()) && !isa<AssignmentExpr>(expr.get()) ? 1 : 0;
+  for(const auto& child : expr->getChildren())
+    count += countOperations(child);
+  return count;
+}
+
+class PassCSETest : public PassTest {
+protected:
+  /// Number of variables (or temporaries) introduced by the pass
+  int numVariables_ = 0;
+
+  /// Number of operators of all statements
+  int numOperations_ = 0;
+
+  virtual void SetUp() override { options_.CSE = true; }
+
+  void optimize(const std::shared_ptr<SIR>& sir) {
+    PassTest::optimize(sir);
+    for(const auto& AccessIDNamePair : instantiation_->getAccessIDToNameMap())
+      if(AccessIDNamePair.second.find("_cse_") != std::string::npos)
+        numVariables_++;
+
+    for(const auto& stmt : getStatements()) {
+      if(ExprStmt* exprStmt = dyn_cast<ExprStmt>(stmt.get()))
+        numOperations_ += countOperations(exprStmt->getExpr());
+      else if(VarDeclStmt* varDecl = dyn_cast<VarDeclStmt>(stmt.get()))
+        for(const auto& init : varDecl->getInitList())
+          numOperations_ += countOperations(init);
+    }
+  }
+
+  /// @brief Declarations of the variables introduced by the pass
+  std::vector<std::shared_ptr<VarDeclStmt>> getCSEDecls() const {
+    std::vector<std::shared_ptr<VarDeclStmt>> decls;
+    for(const auto& stmt : getStatements())
+      if(auto varDecl = std::dynamic_pointer_cast<VarDeclStmt>(stmt))
+        if(varDecl->getName().find("_cse_") != std::string::npos)
+          decls.push_back(varDecl);
+    return decls;
+  }
+};
+
+TEST_F(PassCSETest, Eliminate) {
+  auto lap = []() { return binop(field("a", {{1, 0, 0}}), "+", field("a", {{-1, 0, 0}})); };
+
+  // out1 = (a[i+1] + a[i-1]) * b;
+  // out2 = (a[i+1] + a[i-1]) * b + c;
+  // out3 = b * (a[i+1] + a[i-1]);
+  optimize(makeSIR({"a", "b", "c", "out1", "out2", "out3"},
+                   {expr(assign(field("out1"), binop(lap(), "*", field("b")))),
+                    expr(assign(field("out2"), binop(binop(lap(), "*", field("b")), "+",
+                                                     field("c")))),
+                    expr(assign(field("out3"), binop(field("b"), "*", lap())))}));
+
+  // __local_cse_0 = a[i+1] + a[i-1];
+  // __local_cse_1 = __local_cse_0 * b;
+  // out1 = __local_cse_1;
+  // out2 = __local_cse_1 + c;
+  // out3 = b * __local_cse_0;
+  EXPECT_EQ(numVariables_, 2);
+  EXPECT_EQ(numOperations_, 4);
+}
+
+TEST_F(PassCSETest, InterveningWrite) {
+  // out1 = a + b;
+  // a = c;
+  // out2 = a + b;
+  optimize(makeSIR({"a", "b", "c", "out1", "out2"},
+                   {expr(assign(field("out1"), binop(field("a"), "+", field("b")))),
+                    expr(assign(field("a"), field("c"))),
+                    expr(assign(field("out2"), binop(field("a"), "+", field("b"))))}));
+  EXPECT_EQ(numVariables_, 0);
+  EXPECT_EQ(numOperations_, 2);
+}
+
+TEST_F(PassCSETest, DifferentOffsets) {
+  // out1 = a[i+1] * b;
+  // out2 = a[i-1] * b;
+  optimize(makeSIR(
+      {"a", "b", "out1", "out2"},
+      {expr(assign(field("out1"), binop(field("a", {{1, 0, 0}}), "*", field("b")))),
+       expr(assign(field("out2"), binop(field("a", {{-1, 0, 0}}), "*", field("b"))))}));
+  EXPECT_EQ(numVariables_, 0);
+}
+
+TEST_F(PassCSETest, AcrossStages) {
+  auto sum = []() { return binop(field("a"), "+", field("b")); };
+
+  // out1 = a + b;
+  // out2 = out1[i+1] * (a + b);
+  //
+  // The second statement ends up in a different stage, the variable is promoted to a temporary
+  optimize(makeSIR(
+      {"a", "b", "out1", "out2"},
+      {expr(assign(field("out1"), sum())),
+       expr(assign(field("out2"), binop(field("out1", {{1, 0, 0}}), "*", sum())))}));
+  EXPECT_EQ(numVariables_, 1);
+  EXPECT_EQ(numOperations_, 2);
+
+  ASSERT_EQ(instantiation_->getTemporaryFieldAccessIDSet().size(), 1);
+  int AccessID = *instantiation_->getTemporaryFieldAccessIDSet().begin();
+  EXPECT_NE(instantiation_->getNameFromAccessID(AccessID).find("_cse_"), std::string::npos);
+}
+
+TEST_F(PassCSETest, IntegerSubexpression) {
+  auto half = []() { return binop(var("n"), "/", lit("2", BuiltinTypeID::Integer)); };
+
+  // int n = 7;
+  // out1 = n / 2 * a;
+  // out2 = n / 2 + b;
+  //
+  // The variable of `n / 2` has to be an integer, otherwise the division is no longer truncated
+  optimize(makeSIR({"a", "b", "out1", "out2"},
+                   {vardecl("int", "n", lit("7", BuiltinTypeID::Integer)),
+                    expr(assign(field("out1"), binop(half(), "*", field("a")))),
+                    expr(assign(field("out2"), binop(half(), "+", field("b"))))}));
+  EXPECT_EQ(numVariables_, 1);
+  EXPECT_EQ(numOperations_, 3);
+
+  auto decls = getCSEDecls();
+  ASSERT_EQ(decls.size(), 1);
+  EXPECT_EQ(decls[0]->getType().getBuiltinTypeID(), BuiltinTypeID::Integer);
+}
+
+/// @brief Check if `expr` is an integer division
+bool isDivision(const std::shared_ptr<Expr>& expr) {
+  BinaryOperator* binop = dyn_cast<BinaryOperator>(expr.get());
+  return binop && !isa<AssignmentExpr>(binop) && std::strcmp(binop->getOp(), "/") == 0;
+}
+
+TEST_F(PassCSETest, ConditionalDivision) {
+  auto quotient = []() { return binop(var("n"), "/", var("x")); };
+  auto isNonZero = []() { return binop(var("x"), "!=", lit("0", BuiltinTypeID::Integer)); };
+
+  // int n = 7;
+  // int x = 0;
+  // out1 = (x != 0 ? n / x : 0) * a;
+  // out2 = (x != 0 ? n / x : 1) * b;
+  //
+  // `n / x` is only evaluated if `x` is non-zero and must not be evaluated ahead of the statements
+  optimize(makeSIR(
+      {"a", "b", "out1", "out2"},
+      {vardecl("int", "n", lit("7", BuiltinTypeID::Integer)),
+       vardecl("int", "x", lit("0", BuiltinTypeID::Integer)),
+       expr(assign(field("out1"), binop(ternop(isNonZero(), quotient(),
+                                               lit("0", BuiltinTypeID::Integer)),
+                                        "*", field("a")))),
+       expr(assign(field("out2"), binop(ternop(isNonZero(), quotient(),
+                                               lit("1", BuiltinTypeID::Integer)),
+                                        "*", field("b"))))}));
+
+  // Only the condition `x != 0` is eliminated
+  auto decls = getCSEDecls();
+  ASSERT_EQ(decls.size(), 1);
+  EXPECT_EQ(decls[0]->getType().getBuiltinTypeID(), BuiltinTypeID::Boolean);
+  EXPECT_FALSE(isDivision(decls[0]->getInitList().front()));
+}
+
+TEST_F(PassCSETest, ConditionalReuse) {
+  auto quotient = []() { return binop(var("n"), "/", var("x")); };
+
+  // int n = 7;
+  // int x = 2;
+  // out1 = n / x * a;
+  // out2 = b > 0 ? n / x : 0;
+  //
+  // `n / x` is evaluated unconditionally by the first statement, the branch reuses its value
+  optimize(makeSIR({"a", "b", "out1", "out2"},
+                   {vardecl("int", "n", lit("7", BuiltinTypeID::Integer)),
+                    vardecl("int", "x", lit("2", BuiltinTypeID::Integer)),
+                    expr(assign(field("out1"), binop(quotient(), "*", field("a")))),
+                    expr(assign(field("out2"),
+                                ternop(binop(field("b"), ">", lit("0", BuiltinTypeID::Integer)),
+                                       quotient(), lit("0", BuiltinTypeID::Integer))))}));
+
+  auto decls = getCSEDecls();
+  ASSERT_EQ(decls.size(), 1);
+  EXPECT_TRUE(isDivision(decls[0]->getInitList().front()));
+}
+
+TEST_F(PassCSETest, CodeGen) {
+  auto lap = []() { return binop(field("a", {{1, 0, 0}}), "+", field("a", {{-1, 0, 0}})); };
+  auto sir = makeSIR({"a", "out1", "out2"},
+                     {expr(assign(field("out1"), lap())),
+                      expr(assign(field("out2"), binop(field("out1", {{0, 1, 0}}), "-", lap())))});
+
+  options_.CSE = true;
+  for(auto codeGen : {DawnCompiler::CG_GTClang, DawnCompiler::CG_GTClangNaiveCXX}) {
+    DawnCompiler compiler(&options_);
+    auto translationUnit = compiler.compile(sir, codeGen);
+    ASSERT_TRUE(translationUnit != nullptr);
+    EXPECT_NE(translationUnit->getStencils().begin()->second.find("_cse_"), std::string::npos);
+  }
+}
+
+} // anonymous namespace
@@ -0,0 +1,172 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/CodeGen/TranslationUnit.h"
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+class PassConstantFoldingTest : public PassTest {
+protected:
+  std::shared_ptr<SIR> sir_;
+
+  /// @brief Stencil `test` with the global variables `use_limiter` (false), `factor` (2.0), `n` (3)
+  /// and `scale` (1.0):
+  ///
+  ///   if(use_limiter)
+  ///     out = in * 0.5;
+  ///   else
+  ///     out = in * (factor * n);
+  ///   out2 = in * scale + 7 / 2;
+  virtual void SetUp() override {
+    auto body = block(
+        ifstmt(expr(global("use_limiter")),
+               block(expr(assign(field("out"), binop(field("in"), "*", lit("0.5"))))),
+               block(expr(assign(field("out"), binop(field("in"), "*", binop(global("factor"), "*",
+                                                                             global("n"))))))),
+        expr(assign(field("out2"),
+                    binop(binop(field("in"), "*", global("scale")), "+",
+                          binop(lit("7", BuiltinTypeID::Integer), "/",
+                                lit("2", BuiltinTypeID::Integer))))));
+
+    sir_ = makeSIR({"in", "out", "out2"}, body->getStatements());
+    sir_->GlobalVariableMap->emplace("use_limiter", std::make_shared<sir::Value>(false));
+    sir_->GlobalVariableMap->emplace("factor", std::make_shared<sir::Value>(2.0));
+    sir_->GlobalVariableMap->emplace("n", std::make_shared<sir::Value>(3));
+    sir_->GlobalVariableMap->emplace("scale", std::make_shared<sir::Value>(1.0));
+  }
+
+  /// @brief Run the optimizer and return the top-level statements of the stencil
+  std::vector<std::shared_ptr<Stmt>> optimize() {
+    PassTest::optimize(sir_);
+    if(!context_)
+      return std::vector<std::shared_ptr<Stmt>>();
+    return getStatements();
+  }
+
+  /// @brief Right-hand side of the assignment `stmt`
+  static std::shared_ptr<Expr> getRHS(const std::shared_ptr<Stmt>& stmt) {
+    return cast<AssignmentExpr>(cast<ExprStmt>(stmt.get())->getExpr().get())->getRight();
+  }
+
+  /// @brief Generated naive C++ code of the stencil
+  std::string generateNaiveCode() {
+    DawnCompiler compiler(&options_);
+    auto translationUnit = compiler.compile(sir_, DawnCompiler::CG_GTClangNaiveCXX);
+    EXPECT_TRUE(translationUnit != nullptr);
+    return translationUnit ? translationUnit->getStencils().begin()->second : "";
+  }
+};
+
+TEST_F(PassConstantFoldingTest, Disabled) {
+  auto stmts = optimize();
+  ASSERT_EQ(stmts.size(), 2);
+  EXPECT_TRUE(isa<IfStmt>(stmts[0].get()));
+}
+
+TEST_F(PassConstantFoldingTest, FoldWithoutPinning) {
+  options_.FoldConstants = true;
+  auto stmts = optimize();
+  ASSERT_EQ(stmts.size(), 2);
+  EXPECT_TRUE(isa<IfStmt>(stmts[0].get()));
+
+  // `7 / 2` is an integer division which is not folded
+  auto rhs = getRHS(stmts[1]);
+  EXPECT_TRUE(isa<BinaryOperator>(cast<BinaryOperator>(rhs.get())->getRight().get()));
+}
+
+TEST_F(PassConstantFoldingTest, PinGlobals) {
+  options_.PinGlobals = "use_limiter=false, factor=0.5, n=3";
+  auto stmts = optimize();
+  ASSERT_EQ(stmts.size(), 2);
+
+  // out = in * 1.5;
+  auto rhs = getRHS(stmts[0]);
+  auto* literal = dyn_cast<LiteralAccessExpr>(cast<BinaryOperator>(rhs.get())->getRight().get());
+  ASSERT_TRUE(literal != nullptr);
+  EXPECT_EQ(literal->getValue(), "1.5");
+  EXPECT_EQ(literal->getBuiltinType(), BuiltinTypeID::Float);
+
+  // The SIR itself is not modified
+  const sir::Value& factor = *sir_->GlobalVariableMap->at("factor");
+  EXPECT_FALSE(factor.isConstexpr());
+  EXPECT_EQ(factor.getValue<double>(), 2.0);
+}
+
+TEST_F(PassConstantFoldingTest, PinGlobalsThenBranch) {
+  options_.PinGlobals = "use_limiter=true";
+  auto stmts = optimize();
+  ASSERT_EQ(stmts.size(), 2);
+  auto rhs = getRHS(stmts[0]);
+  auto* literal = dyn_cast<LiteralAccessExpr>(cast<BinaryOperator>(rhs.get())->getRight().get());
+  ASSERT_TRUE(literal != nullptr);
+  EXPECT_EQ(literal->getValue(), "0.5");
+}
+
+TEST_F(PassConstantFoldingTest, CodeGen) {
+  std::string code = generateNaiveCode();
+  EXPECT_NE(code.find("use_limiter"), std::string::npos);
+  EXPECT_NE(code.find("factor"), std::string::npos);
+
+  options_.PinGlobals = "use_limiter=0,factor=0.25,n=4";
+  code = generateNaiveCode();
+  EXPECT_EQ(code.find("use_limiter"), std::string::npos);
+  EXPECT_EQ(code.find("factor"), std::string::npos);
+  EXPECT_NE(code.find("scale"), std::string::npos);
+}
+
+TEST_F(PassConstantFoldingTest, InvalidPins) {
+  for(const char* pins : {"facor=1.0", "n=1.5", "use_limiter=yes", "factor"}) {
+    options_.PinGlobals = pins;
+    DawnCompiler compiler(&options_);
+    EXPECT_EQ(compiler.compile(sir_, DawnCompiler::CG_GTClang), nullptr) << pins;
+    EXPECT_TRUE(compiler.getDiagnostics().hasErrors()) << pins;
+  }
+
+  options_.PinGlobals = "facor=1.0";
+  DawnCompiler compiler(&options_);
+  compiler.compile(sir_, DawnCompiler::CG_GTClang);
+  EXPECT_NE((*compiler.getDiagnostics().getQueue().begin())->getMessage().find("factor"),
+            std::string::npos);
+}
+
+TEST_F(PassConstantFoldingTest, RemoveEmptyStages) {
+  // vertical_region(k_start, k_end) { if(use_limiter) out = in; }
+  // vertical_region(k_start, k_end) { out2 = in; }
+  sir_->Stencils[0]->StencilDescAst = std::make_shared<AST>(
+      block(verticalRegion(makeVerticalRegion({ifstmt(
+                expr(global("use_limiter")), block(expr(assign(field("out"), field("in")))))})),
+            verticalRegion(makeVerticalRegion({expr(assign(field("out2"), field("in")))}))));
+
+  options_.PinGlobals = "use_limiter=false";
+  auto stmts = optimize();
+  ASSERT_EQ(stmts.size(), 1);
+  EXPECT_EQ(cast<FieldAccessExpr>(
+                cast<AssignmentExpr>(cast<ExprStmt>(stmts[0].get())->getExpr().get())
+                    ->getLeft()
+                    .get())
+                ->getName(),
+            "out2");
+  EXPECT_EQ(generateNaiveCode().find("out ="), std::string::npos);
+}
+
+} // anonymous namespace
@@ -0,0 +1,106 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+class PassDeadCodeEliminationTest : public PassTest {
+protected:
+  virtual void SetUp() override { options_.DCE = true; }
+
+  /// @brief Check if a field or variable whose name contains `name` is registered
+  bool hasAccessID(const std::string& name) const {
+    for(const auto& AccessIDNamePair : instantiation_->getAccessIDToNameMap())
+      if(AccessIDNamePair.second.find(name) != std::string::npos)
+        return true;
+    return false;
+  }
+};
+
+TEST_F(PassDeadCodeEliminationTest, DeadTemporaries) {
+  // tmp1 = in;
+  // tmp2 = tmp1 * 2.0;   (only read by dead statements)
+  // out = in;
+  optimize(makeSIR({"in", "out", "tmp1", "tmp2"},
+                   {expr(assign(field("tmp1"), field("in"))),
+                    expr(assign(field("tmp2"), binop(field("tmp1"), "*", lit("2.0")))),
+                    expr(assign(field("out"), field("in")))}));
+  EXPECT_EQ(getStatements().size(), 1);
+  EXPECT_TRUE(instantiation_->getTemporaryFieldAccessIDSet().empty());
+  EXPECT_FALSE(hasAccessID("tmp1"));
+  EXPECT_FALSE(hasAccessID("tmp2"));
+}
+
+TEST_F(PassDeadCodeEliminationTest, DeadVariable) {
+  // float x = in * 2.0;
+  // float y = in;
+  // out = y;
+  optimize(makeSIR({"in", "out"}, {vardecl("float", "x", binop(field("in"), "*", lit("2.0"))),
+                                   vardecl("float", "y", field("in")),
+                                   expr(assign(field("out"), var("y")))}));
+  EXPECT_EQ(getStatements().size(), 2);
+  EXPECT_FALSE(hasAccessID("_x_"));
+  EXPECT_TRUE(hasAccessID("_y_"));
+}
+
+TEST_F(PassDeadCodeEliminationTest, LiveTemporary) {
+  // tmp = in * 2.0;
+  // out = tmp[i+1];
+  optimize(makeSIR({"in", "out", "tmp"},
+                   {expr(assign(field("tmp"), binop(field("in"), "*", lit("2.0")))),
+                    expr(assign(field("out"), field("tmp", {{1, 0, 0}})))}));
+  EXPECT_EQ(getStatements().size(), 2);
+  EXPECT_EQ(instantiation_->getTemporaryFieldAccessIDSet().size(), 1);
+}
+
+TEST_F(PassDeadCodeEliminationTest, KeepStatementWithoutWrites) {
+  // sync(in);            (writes nothing but may have side effects)
+  // out = in;
+  //
+  // The statement must not be the last one: the multi-stage splitter checks the dependency graph
+  // for read-before-write conflicts after inserting each statement from the back, which asserts
+  // on a graph built from statements without writes only.
+  auto call = fcall("sync");
+  call->insertArgument(field("in"));
+  optimize(makeSIR({"in", "out"}, {expr(call), expr(assign(field("out"), field("in")))}));
+  auto stmts = getStatements();
+  ASSERT_EQ(stmts.size(), 2);
+  ASSERT_TRUE(isa<ExprStmt>(stmts[0].get()));
+  auto survivor = dyn_cast<FunCallExpr>(cast<ExprStmt>(stmts[0].get())->getExpr().get());
+  ASSERT_TRUE(survivor != nullptr);
+  EXPECT_EQ(survivor->getCallee(), "sync");
+}
+
+TEST_F(PassDeadCodeEliminationTest, RemoveEmptyStages) {
+  // tmp1 = in;
+  // tmp2 = tmp1[i+1];    (ends up in its own stage)
+  // out = in;
+  optimize(makeSIR({"in", "out", "tmp1", "tmp2"},
+                   {expr(assign(field("tmp1"), field("in"))),
+                    expr(assign(field("tmp2"), field("tmp1", {{1, 0, 0}}))),
+                    expr(assign(field("out"), field("in")))}));
+  EXPECT_EQ(getStatements().size(), 1);
+  ASSERT_EQ(instantiation_->getStencils().size(), 1);
+  EXPECT_EQ(instantiation_->getStencils().front()->getNumStages(), 1);
+}
+
+} // anonymous namespace
@@ -0,0 +1,114 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+/// @brief Call of the stencil function `callee` with the single argument `argument`
+std::shared_ptr<StencilFunCallExpr> call(const std::string& callee,
+                                         const std::shared_ptr<Expr>& argument) {
+  auto expr = sfcall(callee);
+  expr->insertArgument(argument);
+  return expr;
+}
+
+/// @brief Build a SIR with a stencil `test` computing `out = rhs` and the stencil functions `lap`
+/// (five point Laplacian), `copy` and `poly` (polynomial reading its argument five times)
+std::shared_ptr<SIR> makeLaplacianSIR(const std::shared_ptr<Expr>& rhs) {
+  auto sir = makeSIR({"in", "out"}, {expr(assign(field("out"), rhs))});
+  sir->StencilFunctions.emplace_back(makeStencilFunction(
+      "lap", {"in"},
+      block(ret(binop(binop(binop(field("in", {{1, 0, 0}}), "+", field("in", {{-1, 0, 0}})), "+",
+                            binop(field("in", {{0, 1, 0}}), "+", field("in", {{0, -1, 0}}))),
+                      "-", binop(lit("4.0"), "*", field("in")))))));
+  sir->StencilFunctions.emplace_back(makeStencilFunction("copy", {"in"}, block(ret(field("in")))));
+  sir->StencilFunctions.emplace_back(makeStencilFunction(
+      "poly", {"in"},
+      block(ret(binop(
+          binop(binop(binop(binop(field("in"), "*", field("in")), "+", field("in")), "*",
+                      field("in")),
+                "+", field("in")),
+          "*", lit("0.5"))))));
+  return sir;
+}
+
+class PassInliningTest : public PassTest {
+protected:
+  virtual void SetUp() override { options_.InlineStrategy = "auto"; }
+};
+
+TEST_F(PassInliningTest, PrecomputeExpensiveArgument) {
+  // out = lap(lap(in)): the inner Laplacian would be recomputed at five offsets
+  optimize(makeLaplacianSIR(call("lap", call("lap", field("in")))));
+  EXPECT_TRUE(instantiation_->getStencilFunctionInstantiations().empty());
+  EXPECT_EQ(instantiation_->getTemporaryFieldAccessIDSet().size(), 1);
+}
+
+TEST_F(PassInliningTest, RecomputeCheapArgument) {
+  // out = lap(copy(in)): recomputing the copy is cheaper than storing it
+  optimize(makeLaplacianSIR(call("lap", call("copy", field("in")))));
+  EXPECT_FALSE(instantiation_->getStencilFunctionInstantiations().empty());
+  EXPECT_TRUE(instantiation_->getTemporaryFieldAccessIDSet().empty());
+}
+
+TEST_F(PassInliningTest, RecomputeArgumentWithOneConsumer) {
+  // out = copy(lap(in)): the Laplacian is read once, storing it only adds memory traffic
+  optimize(makeLaplacianSIR(call("copy", call("lap", field("in")))));
+  EXPECT_FALSE(instantiation_->getStencilFunctionInstantiations().empty());
+  EXPECT_TRUE(instantiation_->getTemporaryFieldAccessIDSet().empty());
+}
+
+TEST_F(PassInliningTest, PrecomputeArgumentWithSeveralConsumers) {
+  // out = poly(lap(in)): the Laplacian would be recomputed for each of the five reads (all at the
+  // same offset, the precomputed Laplacian is hence stored in a local variable)
+  optimize(makeLaplacianSIR(call("poly", call("lap", field("in")))));
+  EXPECT_TRUE(instantiation_->getStencilFunctionInstantiations().empty());
+}
+
+TEST_F(PassInliningTest, ReportOncePerCall) {
+  // out = lap(lap(in)) + copy(in)
+  options_.ReportPassInlining = true;
+  testing::internal::CaptureStdout();
+  optimize(makeLaplacianSIR(
+      binop(call("lap", call("lap", field("in"))), "+", call("copy", field("in")))));
+  std::string report = testing::internal::GetCapturedStdout();
+
+  auto count = [&](const std::string& line) {
+    int numOccurrences = 0;
+    for(std::size_t pos = report.find(line); pos != std::string::npos;
+        pos = report.find(line, pos + 1))
+      numOccurrences++;
+    return numOccurrences;
+  };
+  EXPECT_EQ(count("PASS: PassInlining: test: lap: precompute"), 1) << report;
+  EXPECT_EQ(count("PASS: PassInlining: test: copy: compute on the fly"), 1) << report;
+  EXPECT_EQ(count("PASS: PassInlining: "), 2) << report;
+}
+
+TEST_F(PassInliningTest, UnknownStrategy) {
+  options_.InlineStrategy = "fastest";
+  DawnCompiler compiler(&options_);
+  EXPECT_EQ(compiler.runOptimizer(makeLaplacianSIR(call("copy", field("in")))), nullptr);
+  EXPECT_TRUE(compiler.getDiagnostics().hasErrors());
+}
+
+} // anonymous namespace
@@ -0,0 +1,169 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/Optimizer/IIRSerializer.h"
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+class PassLoopInvariantCodeMotionTest : public PassTest {
+protected:
+  /// AccessIDs of the fields introduced by the pass
+  std::vector<int> hoistedFields_;
+
+  /// @brief Run the pass on `sir`, its field `sfc` is made a horizontal (2D) field and the global
+  /// variable `g` is added
+  void optimize(const std::shared_ptr<SIR>& sir) {
+    sir->GlobalVariableMap->emplace("g", std::make_shared<sir::Value>(2.0));
+    for(const auto& field : sir->Stencils.front()->Fields)
+      if(field->Name == "sfc")
+        field->fieldDimensions = Array3i{{1, 1, 0}};
+
+    options_.LICM = true;
+    PassTest::optimize(sir);
+    for(int AccessID : instantiation_->getAllocatedFieldAccessIDs())
+      if(instantiation_->getNameFromAccessID(AccessID).find("_licm_") != std::string::npos)
+        hoistedFields_.push_back(AccessID);
+  }
+};
+
+TEST_F(PassLoopInvariantCodeMotionTest, Hoist) {
+  auto sum = []() { return binop(field("sfc", {{1, 0, 0}}), "+", field("sfc", {{-1, 0, 0}})); };
+
+  // out1 = a * (sfc[i+1] + sfc[i-1]);
+  // out2 = a + (sfc[i+1] + sfc[i-1]);
+  // out3 = a - sfc * g;
+  optimize(makeSIR({"sfc", "a", "out1", "out2", "out3"},
+                   {expr(assign(field("out1"), binop(field("a"), "*", sum()))),
+                    expr(assign(field("out2"), binop(field("a"), "+", sum()))),
+                    expr(assign(field("out3"), binop(field("a"), "-",
+                                                     binop(field("sfc"), "*", global("g")))))}));
+
+  // __tmp_licm_0 = sfc[i+1] + sfc[i-1];
+  // __tmp_licm_1 = sfc * g;
+  ASSERT_EQ(hoistedFields_.size(), 2);
+  for(int AccessID : hoistedFields_)
+    EXPECT_EQ(instantiation_->getFieldDimensions(AccessID), (Array3i{{1, 1, 0}}));
+
+  // The fields are computed on the first vertical level in a new multi-stage
+  const auto& multiStages = instantiation_->getStencils().front()->getMultiStages();
+  ASSERT_EQ(multiStages.size(), 2);
+  const auto& hoistedStages = multiStages.front()->getStages();
+  ASSERT_EQ(hoistedStages.size(), 1);
+  const DoMethod& doMethod = hoistedStages.front()->getSingleDoMethod();
+  EXPECT_EQ(doMethod.getInterval(), Interval(sir::Interval::Start, sir::Interval::Start));
+  EXPECT_EQ(doMethod.getStatementAccessesPairs().size(), 2);
+
+  // The original stages only read the fields
+  for(const auto& stage : multiStages.back()->getStages()) {
+    for(const Field& field : stage->getFields()) {
+      if(std::find(hoistedFields_.begin(), hoistedFields_.end(), field.getAccessID()) !=
+         hoistedFields_.end()) {
+        EXPECT_EQ(field.getIntend(), Field::IK_Input);
+      }
+    }
+  }
+}
+
+TEST_F(PassLoopInvariantCodeMotionTest, NotInvariant) {
+  // sfc2 = a;
+  // out1 = a * (sfc + sfc2);   (sfc2 is written)
+  // out2 = a * (b + g);        (b is three dimensional)
+  // out3 = a * sfc;            (no operation to hoist)
+  optimize(makeSIR({"sfc", "sfc2", "a", "b", "out1", "out2", "out3"},
+                   {expr(assign(field("sfc2"), field("a"))),
+                    expr(assign(field("out1"),
+                                binop(field("a"), "*", binop(field("sfc"), "+", field("sfc2"))))),
+                    expr(assign(field("out2"),
+                                binop(field("a"), "*", binop(field("b"), "+", global("g"))))),
+                    expr(assign(field("out3"), binop(field("a"), "*", field("sfc"))))}));
+  EXPECT_TRUE(hoistedFields_.empty());
+}
+
+TEST_F(PassLoopInvariantCodeMotionTest, KeepTrappingInBranch) {
+  // if(a > 0.0) {
+  //   out1 = a * (sfc / g);   (may trap if evaluated at every grid point)
+  //   out2 = a * (sfc * g);
+  // }
+  optimize(makeSIR(
+      {"sfc", "a", "out1", "out2"},
+      {ifstmt(expr(binop(field("a"), ">", lit("0.0"))),
+              block(expr(assign(field("out1"), binop(field("a"), "*",
+                                                     binop(field("sfc"), "/", global("g"))))),
+                    expr(assign(field("out2"), binop(field("a"), "*",
+                                                     binop(field("sfc"), "*", global("g")))))))}));
+  ASSERT_EQ(hoistedFields_.size(), 1);
+  const auto& hoistedPairs = instantiation_->getStencils()
+                                 .front()
+                                 ->getMultiStages()
+                                 .front()
+                                 ->getStages()
+                                 .front()
+                                 ->getSingleDoMethod()
+                                 .getStatementAccessesPairs();
+  ASSERT_EQ(hoistedPairs.size(), 1);
+  auto assignment = dyn_pointer_cast<AssignmentExpr>(
+      dyn_pointer_cast<ExprStmt>(hoistedPairs.front()->getStatement()->ASTStmt)->getExpr());
+  EXPECT_STREQ(dyn_pointer_cast<BinaryOperator>(assignment->getRight())->getOp(), "*");
+}
+
+TEST_F(PassLoopInvariantCodeMotionTest, MaxFieldsPerStencil) {
+  // out1 = a * (sfc * g);
+  // out2 = a * (sfc + g);
+  // out3 = a - (sfc + g);
+  options_.SplitStencils = true;
+  options_.MaxFieldsPerStencil = 6;
+  optimize(makeSIR({"sfc", "a", "out1", "out2", "out3"},
+                   {expr(assign(field("out1"),
+                                binop(field("a"), "*", binop(field("sfc"), "*", global("g"))))),
+                    expr(assign(field("out2"),
+                                binop(field("a"), "*", binop(field("sfc"), "+", global("g"))))),
+                    expr(assign(field("out3"),
+                                binop(field("a"), "-", binop(field("sfc"), "+", global("g")))))}));
+
+  // Only the expression with the most occurrences fits into the stencil
+  ASSERT_EQ(hoistedFields_.size(), 1);
+  ASSERT_EQ(instantiation_->getStencils().size(), 1);
+  EXPECT_EQ(instantiation_->getStencils().front()->getFields().size(), 6);
+}
+
+TEST_F(PassLoopInvariantCodeMotionTest, CodeGen) {
+  // out = a * (sfc * g + 1.0);
+  optimize(makeSIR({"sfc", "a", "out"},
+                   {expr(assign(field("out"), binop(field("a"), "*",
+                                                    binop(binop(field("sfc"), "*", global("g")),
+                                                          "+", lit("1.0")))))}));
+  ASSERT_EQ(hoistedFields_.size(), 1);
+
+  // The field is allocated by the stencil wrappers as a 2D storage
+  std::string code = generateCode();
+  EXPECT_NE(code.find("storage_ij_t"), std::string::npos);
+  EXPECT_NE(code.find("m_meta_data_ij(dom.isize(), dom.jsize(), 1)"), std::string::npos);
+
+  // The dimensions of the field survive the serialization of the IIR
+  std::string str = IIRSerializer::serializeToString(context_.get());
+  auto loaded =
+      IIRSerializer::deserializeFromString(str, compiler_->getDiagnostics(), options_);
+  EXPECT_EQ(generateCode(loaded.get()), code);
+}
+
+} // anonymous namespace
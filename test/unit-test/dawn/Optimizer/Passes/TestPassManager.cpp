@@ -0,0 +1,62 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Compiler/Options.h"
+#include "dawn/Optimizer/OptimizerContext.h"
+#include "dawn/Optimizer/PassManager.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/SIR/SIRSerializer.h"
+#include "test/unit-test/dawn/Optimizer/TestEnvironment.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+
+namespace {
+
+TEST(PassManagerTest, Statistics) {
+  std::shared_ptr<SIR> sir = SIRSerializer::deserialize(
+      TestEnvironment::path_ + "/compute_extent_test_stencil_01.sir", SIRSerializer::SK_Json);
+
+  Options options;
+  options.TimePasses = true;
+  DawnCompiler compiler(&options);
+  auto context = compiler.runOptimizer(sir);
+  ASSERT_TRUE(context != nullptr);
+
+  // Every pass ran once per stencil, in the order of the pass list
+  const PassManager& passManager = context->getPassManager();
+  std::vector<PassStatistics> statistics = passManager.getStatistics();
+  ASSERT_EQ(statistics.size(), passManager.getPasses().size());
+
+  auto pass = passManager.getPasses().begin();
+  for(const PassStatistics& passStatistics : statistics) {
+    EXPECT_EQ(passStatistics.Name, (*pass++)->getName());
+    EXPECT_EQ(passStatistics.NumRuns, context->getStencilInstantiationMap().size());
+    EXPECT_GE(passStatistics.Seconds, 0);
+    EXPECT_GE(passStatistics.PeakRSSDeltaInKB, 0);
+  }
+}
+
+TEST(PassManagerTest, NoStatisticsByDefault) {
+  std::shared_ptr<SIR> sir = SIRSerializer::deserialize(
+      TestEnvironment::path_ + "/compute_extent_test_stencil_01.sir", SIRSerializer::SK_Json);
+
+  DawnCompiler compiler;
+  auto context = compiler.runOptimizer(sir);
+  ASSERT_TRUE(context != nullptr);
+  EXPECT_TRUE(context->getPassManager().getStatistics().empty());
+}
+
+} // anonymous namespace
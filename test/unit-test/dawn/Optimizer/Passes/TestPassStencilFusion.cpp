@@ -0,0 +1,91 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+/// @brief Build a SIR with a stencil `test` running
+///
+///   vertical_region { `first` }
+///   if(flag) { y = 2.0; }
+///   vertical_region { `second` }
+///
+/// Fields whose name starts with `tmp` are temporaries. The global variables `flag` and `y` are not
+/// compile-time constants. The boundary condition `zero` is applied to the fields `bcFields`.
+std::shared_ptr<SIR> makeFusionSIR(const std::vector<std::string>& fields,
+                                   const std::shared_ptr<Stmt>& first,
+                                   const std::shared_ptr<Stmt>& second,
+                                   const std::vector<std::string>& bcFields = {}) {
+  std::vector<std::shared_ptr<Stmt>> desc;
+  for(const auto& name : bcFields)
+    desc.push_back(makeBoundaryCondition("zero", {name}));
+  desc.push_back(verticalRegion(makeVerticalRegion({first})));
+  desc.push_back(ifstmt(expr(global("flag")), block(expr(assign(global("y"), lit("2.0"))))));
+  desc.push_back(verticalRegion(makeVerticalRegion({second})));
+
+  auto sir = makeSIR(fields, std::make_shared<BlockStmt>(desc));
+  sir->GlobalVariableMap->emplace("flag", std::make_shared<sir::Value>(true));
+  sir->GlobalVariableMap->emplace("y", std::make_shared<sir::Value>(1.0));
+  sir->StencilFunctions.emplace_back(
+      makeStencilFunction("zero", {"f"}, block(expr(assign(field("f"), lit("0.0"))))));
+  return sir;
+}
+
+class PassStencilFusionTest : public PassTest {
+protected:
+  virtual void SetUp() override { options_.FuseStencils = true; }
+
+  void optimize(const std::shared_ptr<SIR>& sir) {
+    PassTest::optimize(sir);
+
+    // The fused stencil instantiation is still valid input for the code generators
+    EXPECT_FALSE(codegen::gt::GTCodeGen(context_.get()).generateCode()->getStencils().empty());
+    EXPECT_FALSE(
+        codegen::cxxnaive::CXXNaiveCodeGen(context_.get()).generateCode()->getStencils().empty());
+  }
+};
+
+TEST_F(PassStencilFusionTest, Fuse) {
+  optimize(makeFusionSIR({"in", "mid", "out"},
+                         expr(assign(field("mid"), field("in", {{1, 0, 0}}))),
+                         expr(assign(field("out"), field("mid")))));
+  EXPECT_EQ(instantiation_->getStencils().size(), 1);
+}
+
+TEST_F(PassStencilFusionTest, KeepWhenGlobalIsAssigned) {
+  optimize(makeFusionSIR({"in", "mid", "out"},
+                         expr(assign(field("mid"), field("in", {{1, 0, 0}}))),
+                         expr(assign(field("out"), binop(field("mid"), "*", global("y"))))));
+  EXPECT_EQ(instantiation_->getStencils().size(), 2);
+}
+
+TEST_F(PassStencilFusionTest, KeepWhenBoundaryConditionIsApplied) {
+  optimize(makeFusionSIR({"in", "mid", "out"}, expr(assign(field("mid"), field("in"))),
+                         expr(assign(field("out"), field("mid", {{1, 0, 0}}))), {"mid"}));
+  EXPECT_EQ(instantiation_->getStencils().size(), 2);
+
+  // Without horizontal offsets the boundary condition does not need to be applied in between
+  optimize(makeFusionSIR({"in", "mid", "out"}, expr(assign(field("mid"), field("in"))),
+                         expr(assign(field("out"), field("mid"))), {"mid"}));
+  EXPECT_EQ(instantiation_->getStencils().size(), 1);
+}
+
+} // anonymous namespace
@@ -0,0 +1,157 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+class PassTemporaryMergerTest : public PassTest {
+protected:
+  virtual void SetUp() override { options_.MergeTemporaries = true; }
+
+  /// @brief Number of distinct temporary fields accessed by the stencils
+  int getNumTemporaries() const {
+    int numTemporaries = 0;
+    for(const auto& stencil : instantiation_->getStencils())
+      for(const auto& field : stencil->getFields())
+        numTemporaries += field.IsTemporary;
+    return numTemporaries;
+  }
+};
+
+TEST_F(PassTemporaryMergerTest, MergeDisjointLiveRanges) {
+  // tmp1 = in;
+  // out1 = tmp1[i+1];
+  // tmp2 = out1[i+1] * 2.0;
+  // out2 = tmp2[i-1];
+  optimize(makeSIR({"in", "out1", "out2", "tmp1", "tmp2"},
+                   block(verticalRegion(makeVerticalRegion(
+                       {expr(assign(field("tmp1"), field("in"))),
+                        expr(assign(field("out1"), field("tmp1", {{1, 0, 0}}))),
+                        expr(assign(field("tmp2"),
+                                    binop(field("out1", {{1, 0, 0}}), "*", lit("2.0")))),
+                        expr(assign(field("out2"), field("tmp2", {{-1, 0, 0}})))})))));
+  EXPECT_EQ(getNumTemporaries(), 1);
+}
+
+TEST_F(PassTemporaryMergerTest, ReportBytesSaved) {
+  // tmp1 = in;
+  // out1 = tmp1[i+1];
+  // tmp2 = out1[i+1] * 2.0;
+  // out2 = tmp2[i-1];
+  options_.ReportPassTemporaryMerger = true;
+  options_.Precision = "float";
+  options_.DomainSize = "10,20,5";
+  testing::internal::CaptureStdout();
+  optimize(makeSIR({"in", "out1", "out2", "tmp1", "tmp2"},
+                   block(verticalRegion(makeVerticalRegion(
+                       {expr(assign(field("tmp1"), field("in"))),
+                        expr(assign(field("out1"), field("tmp1", {{1, 0, 0}}))),
+                        expr(assign(field("tmp2"),
+                                    binop(field("out1", {{1, 0, 0}}), "*", lit("2.0")))),
+                        expr(assign(field("out2"), field("tmp2", {{-1, 0, 0}})))})))));
+  std::string report = testing::internal::GetCapturedStdout();
+
+  // One 3D temporary of 10 x 20 x 5 floats saved
+  EXPECT_NE(report.find("4000 bytes saved"), std::string::npos) << report;
+}
+
+TEST_F(PassTemporaryMergerTest, KeepOverlappingLiveRanges) {
+  // tmp1 = in;
+  // tmp2 = in * 2.0;
+  // out = tmp1[i+1] + tmp2[i-1];
+  optimize(makeSIR(
+      {"in", "out", "tmp1", "tmp2"},
+      block(verticalRegion(makeVerticalRegion(
+          {expr(assign(field("tmp1"), field("in"))),
+           expr(assign(field("tmp2"), binop(field("in"), "*", lit("2.0")))),
+           expr(assign(field("out"), binop(field("tmp1", {{1, 0, 0}}), "+",
+                                           field("tmp2", {{-1, 0, 0}}))))})))));
+  EXPECT_EQ(getNumTemporaries(), 2);
+}
+
+TEST_F(PassTemporaryMergerTest, KeepVerticallyAccessed) {
+  // tmp1 = in;
+  // out1 = tmp1[k-1];    (tmp1 is live during the whole multi-stage)
+  // tmp2 = in * 2.0;
+  // out2 = tmp2[i+1];
+  optimize(makeSIR({"in", "out1", "out2", "tmp1", "tmp2"},
+                   block(verticalRegion(makeVerticalRegion(
+                       {expr(assign(field("tmp1"), field("in"))),
+                        expr(assign(field("out1"), field("tmp1", {{0, 0, -1}}))),
+                        expr(assign(field("tmp2"), binop(field("in"), "*", lit("2.0")))),
+                        expr(assign(field("out2"), field("tmp2", {{1, 0, 0}})))},
+                       1, 0)))));
+  EXPECT_EQ(getNumTemporaries(), 2);
+}
+
+TEST_F(PassTemporaryMergerTest, MergeDisjointIntervals) {
+  // vertical_region(k_start, k_end - 1) { tmp1 = in; out = tmp1[i+1]; }
+  // vertical_region(k_end, k_end)       { tmp2 = in; out = tmp2[i-1]; }
+  optimize(makeSIR(
+      {"in", "out", "tmp1", "tmp2"},
+      block(verticalRegion(makeVerticalRegion(
+                {expr(assign(field("tmp1"), field("in"))),
+                 expr(assign(field("out"), field("tmp1", {{1, 0, 0}})))},
+                0, -1)),
+            verticalRegion(std::make_shared<sir::VerticalRegion>(
+                std::make_shared<AST>(
+                    block(expr(assign(field("tmp2"), field("in"))),
+                          expr(assign(field("out"), field("tmp2", {{-1, 0, 0}}))))),
+                std::make_shared<sir::Interval>(sir::Interval::End, sir::Interval::End),
+                sir::VerticalRegion::LK_Forward)))));
+  EXPECT_EQ(getNumTemporaries(), 1);
+}
+
+TEST_F(PassTemporaryMergerTest, ShareAcrossStencils) {
+  // vertical_region { tmp1 = in; out = tmp1[i+1]; }
+  // if(flag)
+  //   vertical_region { tmp2 = in; out = tmp2[i-1]; }
+  auto makeDesc = [](const char* tmp, int offset) {
+    return verticalRegion(makeVerticalRegion({expr(assign(field(tmp), field("in"))),
+                                              expr(assign(field("out"),
+                                                          field(tmp, {{offset, 0, 0}})))}));
+  };
+  auto sir = makeSIR({"in", "out", "tmp1", "tmp2"},
+                     block(makeDesc("tmp1", 1),
+                           ifstmt(expr(global("flag")), block(makeDesc("tmp2", -1)))));
+  // `flag` is not a compile-time constant
+  sir->GlobalVariableMap->emplace("flag", std::make_shared<sir::Value>(true));
+
+  options_.MergeTemporariesAcrossStencils = true;
+  optimize(sir);
+
+  ASSERT_GE(instantiation_->getStencils().size(), 2);
+  EXPECT_EQ(getNumTemporaries(), 0);
+  ASSERT_EQ(instantiation_->getAllocatedFieldAccessIDSet().size(), 1);
+
+  int AccessID = *instantiation_->getAllocatedFieldAccessIDSet().begin();
+  for(const auto& stencil : instantiation_->getStencils()) {
+    if(stencil->getNumStages() == 0)
+      continue;
+    auto fields = stencil->getFields();
+    EXPECT_TRUE(std::any_of(fields.begin(), fields.end(), [&](const Stencil::FieldInfo& field) {
+      return field.AccessID == AccessID;
+    }));
+  }
+}
+
+} // anonymous namespace
@@ -0,0 +1,167 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/IIRSerializer.h"
+#include "dawn/SIR/SIRSerializer.h"
+#include "dawn/Unittest/ASTSimplifier.h"
+#include "dawn/Unittest/PassTest.h"
+#include "dawn/Unittest/SIRBuilder.h"
+#include "test/unit-test/dawn/Optimizer/TestEnvironment.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+class PassTemporaryStorageTest : public PassTest {
+protected:
+  virtual void SetUp() override { options_.DemoteTemporaries = true; }
+
+  int getAccessID(const std::string& name) const {
+    for(const auto& AccessIDNamePair : instantiation_->getAccessIDToNameMap())
+      if(instantiation_->getOriginalNameFromAccessID(AccessIDNamePair.first) == name)
+        return AccessIDNamePair.first;
+    return -1;
+  }
+
+  /// @brief Cache of the temporary `name` (NULL if there is none)
+  const Cache* getCache(const std::string& name) const {
+    int AccessID = getAccessID(name);
+    for(const auto& stencil : instantiation_->getStencils())
+      for(const auto& multiStage : stencil->getMultiStages()) {
+        auto it = multiStage->getCaches().find(AccessID);
+        if(it != multiStage->getCaches().end())
+          return &it->second;
+      }
+    return nullptr;
+  }
+
+  /// @brief Window of the cache of the temporary `name` (0 if there is none)
+  int getWindow(const std::string& name) const {
+    const Cache* cache = getCache(name);
+    return cache && cache->getWindow() ? *cache->getWindow() : 0;
+  }
+};
+
+TEST_F(PassTemporaryStorageTest, KWindow) {
+  // tmp = in;
+  // out = tmp[k-1] + tmp;
+  optimize(makeSIR({"in", "out", "tmp"},
+                   makeVerticalRegion(
+                       {expr(assign(field("tmp"), field("in"))),
+                        expr(assign(field("out"),
+                                    binop(field("tmp", {{0, 0, -1}}), "+", field("tmp"))))},
+                       1, 0, sir::VerticalRegion::LK_Forward)));
+  EXPECT_TRUE(instantiation_->isTemporaryField(getAccessID("tmp")));
+  EXPECT_EQ(getWindow("tmp"), 2);
+
+  // The naive C++ backend allocates a ring buffer of two levels
+  std::string code = generateCode();
+  EXPECT_NE(code.find("m_tmp_meta_data_k2(dom_.isize(), dom_.jsize(), 2)"), std::string::npos);
+  EXPECT_NE(code.find("(k+-1+2)%2"), std::string::npos);
+
+  // The window survives the serialization of the IIR
+  std::string str = IIRSerializer::serializeToString(context_.get());
+  auto loaded = IIRSerializer::deserializeFromString(str, compiler_->getDiagnostics(), options_);
+  EXPECT_EQ(generateCode(loaded.get()), code);
+}
+
+TEST_F(PassTemporaryStorageTest, IJPlane) {
+  // tmp = in;
+  // out = tmp[i+1];
+  optimize(makeSIR({"in", "out", "tmp"},
+                   makeVerticalRegion({expr(assign(field("tmp"), field("in"))),
+                                       expr(assign(field("out"), field("tmp", {{1, 0, 0}})))},
+                                      1, 0, sir::VerticalRegion::LK_Backward)));
+  EXPECT_TRUE(instantiation_->isTemporaryField(getAccessID("tmp")));
+  ASSERT_TRUE(getCache("tmp") != nullptr);
+  EXPECT_EQ(getCache("tmp")->getCacheType(), Cache::IJ);
+  EXPECT_EQ(getWindow("tmp"), 1);
+
+  // The naive C++ backend stores a single level
+  std::string code = generateCode();
+  EXPECT_NE(code.find("m_tmp_meta_data_k1(dom_.isize(), dom_.jsize(), 1)"), std::string::npos);
+}
+
+TEST_F(PassTemporaryStorageTest, KeepReadBeforeWrite) {
+  // Reduced from compute_extent_test_stencil_02.sir, `flx` is read before it is written at each
+  // level and the value of the previous level would be lost in a single plane
+  //
+  // lap = in[i+1] - in;
+  // if(flx * in > 0)
+  //   flx = 0.0;
+  // else
+  //   flx = lap[i+1] - lap;
+  // out = flx - flx[i-1];
+  optimize(makeSIR(
+      {"in", "out", "tmp_lap", "tmp_flx"},
+      makeVerticalRegion(
+          {expr(assign(field("tmp_lap"), binop(field("in", {{1, 0, 0}}), "-", field("in")))),
+           ifstmt(expr(binop(binop(field("tmp_flx"), "*", field("in")), ">", lit("0.0"))),
+                  block(expr(assign(field("tmp_flx"), lit("0.0")))),
+                  block(expr(assign(field("tmp_flx"), binop(field("tmp_lap", {{1, 0, 0}}), "-",
+                                                            field("tmp_lap")))))),
+           expr(assign(field("out"),
+                       binop(field("tmp_flx"), "-", field("tmp_flx", {{-1, 0, 0}}))))},
+          1, 0, sir::VerticalRegion::LK_Forward)));
+  EXPECT_TRUE(instantiation_->isTemporaryField(getAccessID("tmp_flx")));
+  EXPECT_EQ(getWindow("tmp_flx"), 0);
+  EXPECT_EQ(getWindow("tmp_lap"), 1);
+}
+
+TEST_F(PassTemporaryStorageTest, KeepReadBeforeWriteSIRFile) {
+  optimize(SIRSerializer::deserialize(TestEnvironment::path_ +
+                                      "/compute_extent_test_stencil_02.sir"),
+           "compute_extent_test_stencil");
+  for(const char* name : {"flx", "fly"}) {
+    EXPECT_TRUE(instantiation_->isTemporaryField(getAccessID(name))) << name;
+    EXPECT_EQ(getWindow(name), 0) << name;
+  }
+}
+
+TEST_F(PassTemporaryStorageTest, KeepParallel) {
+  // tmp = in;
+  // out = tmp[i+1];
+  optimize(makeSIR({"in", "out", "tmp"},
+                   makeVerticalRegion({expr(assign(field("tmp"), field("in"))),
+                                       expr(assign(field("out"), field("tmp", {{1, 0, 0}})))},
+                                      1, 0, sir::VerticalRegion::LK_Forward)));
+  EXPECT_EQ(getWindow("tmp"), 1);
+
+  // The multi-stage without vertical dependencies becomes parallel
+  options_.UseParallelEP = true;
+  optimize(makeSIR({"in", "out", "tmp"},
+                   makeVerticalRegion({expr(assign(field("tmp"), field("in"))),
+                                       expr(assign(field("out"), field("tmp", {{1, 0, 0}})))},
+                                      1, 0, sir::VerticalRegion::LK_Forward)));
+  ASSERT_EQ(instantiation_->getStencils().front()->getMultiStages().front()->getLoopOrder(),
+            LoopOrderKind::LK_Parallel);
+  EXPECT_EQ(getWindow("tmp"), 0);
+}
+
+TEST_F(PassTemporaryStorageTest, KeepCounterLoopOrderAccess) {
+  // tmp = in;
+  // out = tmp[k-1] + tmp[k+1];    (one of the levels is not yet computed in either loop order)
+  optimize(makeSIR({"in", "out", "tmp"},
+                   makeVerticalRegion({expr(assign(field("tmp"), field("in"))),
+                                       expr(assign(field("out"),
+                                                   binop(field("tmp", {{0, 0, -1}}), "+",
+                                                         field("tmp", {{0, 0, 1}}))))},
+                                      1, 0, sir::VerticalRegion::LK_Forward)));
+  EXPECT_TRUE(instantiation_->isTemporaryField(getAccessID("tmp")));
+  EXPECT_EQ(getWindow("tmp"), 0);
+}
+
+} // anonymous namespace
@@ -0,0 +1,82 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/CodeGen/TranslationUnit.h"
+#include "dawn/Compiler/DawnCompiler.h"
+#include "dawn/Compiler/Options.h"
+#include "dawn/SIR/SIR.h"
+#include "dawn/SIR/SIRSerializer.h"
+#include "test/unit-test/dawn/Optimizer/TestEnvironment.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+
+namespace {
+
+class StencilSelectionTest : public ::testing::Test {
+protected:
+  /// @brief Lazily deserialized SIR with the stencils `SplitStencil` (calling the boundary
+  /// condition function `zero`) and `compute_extent_test_stencil` (calling the function `delta`)
+  std::shared_ptr<SIR> sir_;
+
+  virtual void SetUp() override {
+    auto sir = SIRSerializer::deserialize(
+        TestEnvironment::path_ + "/boundary_condition_test_stencil_01.sir", SIRSerializer::SK_Json);
+    auto other = SIRSerializer::deserialize(
+        TestEnvironment::path_ + "/compute_extent_test_stencil_03.sir", SIRSerializer::SK_Json);
+    sir->Stencils.insert(sir->Stencils.end(), other->Stencils.begin(), other->Stencils.end());
+    sir->StencilFunctions.insert(sir->StencilFunctions.end(), other->StencilFunctions.begin(),
+                                 other->StencilFunctions.end());
+
+    sir_ = SIRSerializer::deserializeLazyFromString(
+        SIRSerializer::serializeToString(sir.get(), SIRSerializer::SK_Byte),
+        SIRSerializer::SK_Byte);
+  }
+};
+
+TEST_F(StencilSelectionTest, All) {
+  DawnCompiler compiler;
+  auto translationUnit = compiler.compile(sir_, DawnCompiler::CG_GTClang);
+  ASSERT_TRUE(translationUnit != nullptr);
+  EXPECT_EQ(translationUnit->getStencils().size(), 2);
+}
+
+TEST_F(StencilSelectionTest, Subset) {
+  Options options;
+  options.Stencils = "SplitStencil";
+  DawnCompiler compiler(&options);
+  auto translationUnit = compiler.compile(sir_, DawnCompiler::CG_GTClang);
+  ASSERT_TRUE(translationUnit != nullptr);
+  ASSERT_EQ(translationUnit->getStencils().size(), 1);
+  EXPECT_EQ(translationUnit->getStencils().begin()->first, "SplitStencil");
+
+  // The other stencil and its stencil function have never been deserialized
+  ASSERT_EQ(sir_->Stencils.size(), 1);
+  EXPECT_EQ(sir_->Stencils[0]->Name, "SplitStencil");
+  ASSERT_EQ(sir_->StencilFunctions.size(), 1);
+  EXPECT_EQ(sir_->StencilFunctions[0]->Name, "zero");
+}
+
+TEST_F(StencilSelectionTest, UnknownStencil) {
+  Options options;
+  options.Stencils = "SplitStencil, SplitStensil";
+  DawnCompiler compiler(&options);
+  EXPECT_EQ(compiler.compile(sir_, DawnCompiler::CG_GTClang), nullptr);
+  ASSERT_TRUE(compiler.getDiagnostics().hasErrors());
+  EXPECT_NE((*compiler.getDiagnostics().getQueue().begin())->getMessage().find("SplitStensil"),
+            std::string::npos);
+}
+
+} // anonymous namespace
@@ -0,0 +1,167 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/SIR/AST.h"
+#include "dawn/SIR/ASTHashConsing.h"
+#include "dawn/Unittest/ASTSimplifier.h"
+#include <gtest/gtest.h>
+
+using namespace dawn;
+using namespace dawn::astgen;
+
+namespace {
+
+/// @brief `(in(i+1) - in) * (in(i+1) - in)`
+std::shared_ptr<BinaryOperator> makeSquaredGradient() {
+  return binop(binop(field("in", {{1, 0, 0}}), "-", field("in")), "*",
+               binop(field("in", {{1, 0, 0}}), "-", field("in")));
+}
+
+TEST(ASTHashTest, EqualExpressions) {
+  auto square = makeSquaredGradient();
+  EXPECT_EQ(square->getHash(), square->clone()->getHash());
+  EXPECT_EQ(square->getLeft()->getHash(), square->getRight()->getHash());
+
+  // The source location is not part of the hash
+  auto located = std::make_shared<VarAccessExpr>("a", nullptr, SourceLocation(3, 4));
+  EXPECT_EQ(located->getHash(), var("a")->getHash());
+}
+
+TEST(ASTHashTest, DifferentExpressions) {
+  EXPECT_NE(binop(var("a"), "+", var("b"))->getHash(), binop(var("a"), "-", var("b"))->getHash());
+  EXPECT_NE(binop(var("a"), "-", var("b"))->getHash(), binop(var("b"), "-", var("a"))->getHash());
+  EXPECT_NE(binop(var("a"), "=", var("b"))->getHash(), assign(var("a"), var("b"))->getHash());
+  EXPECT_NE(field("in", {{1, 0, 0}})->getHash(), field("in", {{0, 1, 0}})->getHash());
+  EXPECT_NE(lit("1", BuiltinTypeID::Integer)->getHash(), lit("1")->getHash());
+  EXPECT_NE(var("a")->getHash(), field("a")->getHash());
+}
+
+TEST(ASTHashTest, InvalidatedOnModification) {
+  auto square = makeSquaredGradient();
+  std::size_t hash = square->getHash();
+
+  // Replacing a child invalidates the hashes of the ancestors
+  auto left = std::static_pointer_cast<BinaryOperator>(square->getLeft());
+  left->replaceChildren(left->getRight(), field("out"));
+  EXPECT_NE(square->getHash(), hash);
+  EXPECT_EQ(square->getHash(),
+            binop(binop(field("in", {{1, 0, 0}}), "-", field("out")), "*",
+                  binop(field("in", {{1, 0, 0}}), "-", field("in")))
+                ->getHash());
+
+  // So does modifying a node through its setters
+  auto out = std::static_pointer_cast<FieldAccessExpr>(left->getRight());
+  out->getName() = "in";
+  out->invalidateHash();
+  EXPECT_EQ(square->getHash(), hash);
+}
+
+TEST(ASTHashTest, InvalidationIsLocal) {
+  auto product = makeSquaredGradient();
+  auto stmt = expr(assign(var("a"), product));
+  AST ast(block(stmt, expr(assign(var("b"), lit("1")))));
+  ast.getHash();
+
+  auto left = std::static_pointer_cast<BinaryOperator>(product->getLeft());
+  auto right = std::static_pointer_cast<BinaryOperator>(product->getRight());
+  EXPECT_TRUE(left->getHashCache().isValid());
+
+  // Only the modified node and its ancestors are invalidated
+  left->setRight(field("out"));
+  EXPECT_FALSE(left->getHashCache().isValid());
+  EXPECT_FALSE(product->getHashCache().isValid());
+  EXPECT_FALSE(stmt->getHashCache().isValid());
+  EXPECT_FALSE(ast.getRoot()->getHashCache().isValid());
+  EXPECT_TRUE(right->getHashCache().isValid());
+  EXPECT_TRUE(left->getLeft()->getHashCache().isValid());
+  EXPECT_TRUE(ast.getRoot()->getStatements()[1]->getHashCache().isValid());
+
+  // Replacing the modified node by an equal one yields the same hash
+  std::size_t hash = ast.getHash();
+  product->setLeft(binop(field("in", {{1, 0, 0}}), "-", field("out")));
+  EXPECT_FALSE(ast.getRoot()->getHashCache().isValid());
+  EXPECT_EQ(ast.getHash(), hash);
+}
+
+TEST(ASTHashTest, Statements) {
+  auto ifThen = ifstmt(expr(var("c")), block(expr(assign(var("a"), lit("1")))));
+  auto ifThenElse = ifstmt(expr(var("c")), block(expr(assign(var("a"), lit("1")))),
+                           block(expr(assign(var("a"), lit("2")))));
+  EXPECT_EQ(ifThen->getHash(), ifThen->clone()->getHash());
+  EXPECT_EQ(ifThenElse->getHash(), ifThenElse->clone()->getHash());
+  EXPECT_NE(ifThen->getHash(), ifThenElse->getHash());
+
+  EXPECT_NE(vardecl("double", "a", lit("1"))->getHash(),
+            vardecl("float", "a", lit("1"))->getHash());
+  EXPECT_NE(expr(var("a"))->getHash(), ret(var("a"))->getHash());
+
+  AST ast(block(ifThenElse));
+  std::size_t hash = ast.getHash();
+  std::shared_ptr<Stmt> elseStmt = block(expr(assign(var("a"), lit("3"))));
+  ifThenElse->setElseStmt(elseStmt);
+  EXPECT_NE(ast.getHash(), hash);
+}
+
+TEST(ExprHashConsTableTest, SharesPureSubexpressions) {
+  auto first = expr(assign(var("a"), makeSquaredGradient()));
+  auto second = expr(assign(var("b"), binop(makeSquaredGradient(), "+", lit("1"))));
+  AST ast(block(first, second));
+  std::size_t hash = ast.getHash();
+
+  ExprHashConsTable table;
+  table.intern(ast);
+  EXPECT_EQ(ast.getHash(), hash);
+
+  // `in(i+1) - in` is shared within and the product across the statements
+  auto product = std::static_pointer_cast<BinaryOperator>(
+      std::static_pointer_cast<AssignmentExpr>(first->getExpr())->getRight());
+  auto sum = std::static_pointer_cast<BinaryOperator>(
+      std::static_pointer_cast<AssignmentExpr>(second->getExpr())->getRight());
+  EXPECT_EQ(product->getLeft(), product->getRight());
+  EXPECT_EQ(sum->getLeft(), product);
+
+  // a, in(i+1), in, the difference, the product, b, 1 and the sum
+  EXPECT_EQ(table.size(), 8);
+  EXPECT_EQ(table.getNumShared(), 10);
+
+  // Interning again does not change anything
+  table.intern(ast);
+  EXPECT_EQ(table.size(), 8);
+
+  // Cloning unshares the nodes
+  auto clone = ast.clone();
+  auto clonedProduct = std::static_pointer_cast<BinaryOperator>(
+      std::static_pointer_cast<AssignmentExpr>(
+          std::static_pointer_cast<ExprStmt>(clone->getRoot()->getStatements()[0])->getExpr())
+          ->getRight());
+  EXPECT_NE(clonedProduct->getLeft(), clonedProduct->getRight());
+  EXPECT_EQ(clone->getHash(), hash);
+}
+
+TEST(ExprHashConsTableTest, SideEffects) {
+  ExprHashConsTable table;
+  auto increment = unop(var("i"), "++");
+  auto interned = table.intern(binop(unop(var("i"), "++"), "+", var("j")));
+  EXPECT_EQ(table.intern(increment), increment);
+
+  // Only the variable accesses are shared
+  EXPECT_EQ(table.intern(var("j")), std::static_pointer_cast<BinaryOperator>(interned)->getRight());
+  EXPECT_EQ(table.size(), 2);
+
+  auto call = sfcall("f");
+  EXPECT_EQ(table.intern(call), call);
+  EXPECT_NE(table.intern(sfcall("f")), call);
+}
+
+} // anonymous namespace
@@ -13,6 +13,7 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn/SIR/AST.h"
+#include "dawn/SIR/ASTKindVisitor.h"
 #include "dawn/SIR/ASTUtil.h"
 #include "dawn/Support/Casting.h"
 #include "dawn/Support/STLExtras.h"
@@ -242,4 +243,72 @@ TEST_F(ASTPostOrderVisitor, ifblock) {
   ASSERT_TRUE(checker.result());
 }
 
+/// @brief Record the accesses in traversal order (virtual dispatch)
+class AccessRecorder : public ASTVisitorForwarding, public NonCopyable {
+public:
+  std::vector<std::string> Accesses;
+
+  virtual void visit(std::shared_ptr<FieldAccessExpr> const& expr) override {
+    Accesses.push_back(expr->getName());
+  }
+
+  virtual void visit(std::shared_ptr<VarAccessExpr> const& expr) override {
+    Accesses.push_back(expr->getName());
+    ASTVisitorForwarding::visit(expr);
+  }
+
+  virtual void visit(std::shared_ptr<LiteralAccessExpr> const& expr) override {
+    Accesses.push_back(expr->getValue());
+  }
+};
+
+/// @brief Record the accesses in traversal order (kind-switch dispatch)
+class KindAccessRecorder : public ASTKindVisitor<KindAccessRecorder>, public NonCopyable {
+public:
+  std::vector<std::string> Accesses;
+  bool OwnersMatch = true;
+  int NumIfStmts = 0;
+
+  void visitFieldAccessExpr(const FieldAccessExpr& expr, const std::shared_ptr<Expr>& node) {
+    OwnersMatch &= node.get() == &expr;
+    Accesses.push_back(expr.getName());
+  }
+
+  void visitVarAccessExpr(const VarAccessExpr& expr, const std::shared_ptr<Expr>& node) {
+    OwnersMatch &= node.get() == &expr;
+    Accesses.push_back(expr.getName());
+    ASTKindVisitor<KindAccessRecorder>::visitVarAccessExpr(expr, node);
+  }
+
+  void visitLiteralAccessExpr(const LiteralAccessExpr& expr, const std::shared_ptr<Expr>& node) {
+    OwnersMatch &= node.get() == &expr;
+    Accesses.push_back(expr.getValue());
+  }
+
+  void visitIfStmt(const IfStmt& stmt, const std::shared_ptr<Stmt>& node) {
+    OwnersMatch &= node.get() == &stmt;
+    NumIfStmts++;
+    ASTKindVisitor<KindAccessRecorder>::visitIfStmt(stmt, node);
+  }
+};
+
+TEST_F(ASTPostOrderVisitor, kindVisitorMatchesForwardingVisitor) {
+  AccessRecorder recorder;
+  blockStmt_->accept(recorder);
+
+  KindAccessRecorder kindRecorder;
+  kindRecorder.visit(AST(blockStmt_));
+
+  EXPECT_EQ(kindRecorder.Accesses, recorder.Accesses);
+  EXPECT_EQ(kindRecorder.Accesses.size(), 12);
+  EXPECT_TRUE(kindRecorder.OwnersMatch);
+  EXPECT_EQ(kindRecorder.NumIfStmts, 1);
+}
+
+TEST(ASTKindVisitor, NOPExprIsSkipped) {
+  KindAccessRecorder kindRecorder;
+  kindRecorder.visit(std::make_shared<ExprStmt>(std::make_shared<NOPExpr>()));
+  EXPECT_TRUE(kindRecorder.Accesses.empty());
+}
+
 } // anonymous namespace
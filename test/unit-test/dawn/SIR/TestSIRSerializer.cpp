@@ -14,6 +14,7 @@
 
 #include "dawn/SIR/SIR.h"
 #include "dawn/SIR/SIRSerializer.h"
+#include <cstdio>
 #include <gtest/gtest.h>
 
 using namespace dawn;
@@ -148,4 +149,152 @@ TEST_P(GlobalVariableTest, Value) {
 INSTANTIATE_TEST_CASE_P(SIRSerializeTest, GlobalVariableTest,
                         ::testing::Values(SIRSerializer::SK_Json, SIRSerializer::SK_Byte));
 
+class SourceTest : public SIRSerializerTest {
+  virtual void SetUp() override {
+    SIRSerializerTest::SetUp();
+
+    sirRef->Filename = "foo.cpp";
+    sirRef->Stencils.emplace_back(std::make_shared<sir::Stencil>());
+    sirRef->Stencils[0]->Name = "foo";
+    sirRef->Stencils[0]->Fields.emplace_back(std::make_shared<sir::Field>("bar"));
+  }
+};
+
+TEST_P(SourceTest, Buffer) {
+  std::string str = SIRSerializer::serializeToString(sirRef.get(), this->GetParam());
+  SIR_EXCPECT_EQ(sirRef,
+                 SIRSerializer::deserializeFromBuffer(str.data(), str.size(), this->GetParam()));
+}
+
+TEST_P(SourceTest, File) {
+  std::string file = "SIRSerializerTest_SourceTest_File.sir";
+  SIRSerializer::serialize(file, sirRef.get(), this->GetParam());
+  SIR_EXCPECT_EQ(sirRef, SIRSerializer::deserialize(file, this->GetParam()));
+  std::remove(file.c_str());
+}
+
+TEST_P(SourceTest, InvalidFile) {
+  EXPECT_THROW(SIRSerializer::deserialize("not-existing-file.sir", this->GetParam()),
+               std::runtime_error);
+}
+
+INSTANTIATE_TEST_CASE_P(SIRSerializeTest, SourceTest,
+                        ::testing::Values(SIRSerializer::SK_Json, SIRSerializer::SK_Byte));
+
+class LazyTest : public SIRSerializerTest {
+  virtual void SetUp() override {
+    SIRSerializerTest::SetUp();
+
+    sirRef->Filename = "foo.cpp";
+    for(const char* name : {"foo", "bar"}) {
+      sirRef->Stencils.emplace_back(std::make_shared<sir::Stencil>());
+      sirRef->Stencils.back()->Name = name;
+      sirRef->Stencils.back()->Fields.emplace_back(std::make_shared<sir::Field>("field"));
+
+      sirRef->StencilFunctions.emplace_back(std::make_shared<sir::StencilFunction>());
+      sirRef->StencilFunctions.back()->Name = std::string(name) + "_fun";
+      sirRef->StencilFunctions.back()->Args.emplace_back(std::make_shared<sir::Field>("arg"));
+    }
+    sirRef->GlobalVariableMap->emplace("int", std::make_shared<sir::Value>(5));
+  }
+
+protected:
+  std::shared_ptr<SIR> serializeAndDeserializeLazyRef() {
+    return SIRSerializer::deserializeLazyFromString(
+        SIRSerializer::serializeToString(sirRef.get(), this->GetParam()), this->GetParam());
+  }
+};
+
+TEST_P(LazyTest, Materialize) {
+  auto sir = serializeAndDeserializeLazyRef();
+  EXPECT_TRUE(sir->Stencils.empty());
+  EXPECT_TRUE(sir->StencilFunctions.empty());
+  EXPECT_EQ(sir->Filename, "foo.cpp");
+  EXPECT_EQ(sir->GlobalVariableMap->size(), 1);
+  EXPECT_EQ(sir->getStencilNames(), (std::vector<std::string>{"foo", "bar"}));
+
+  // Materialize out of order, `materialize` restores the order of the serialized SIR
+  sir->getStencil("bar");
+  sir->materialize();
+  EXPECT_EQ(sir->Lazy, nullptr);
+  SIR_EXCPECT_EQ(sirRef, sir);
+}
+
+TEST_P(LazyTest, OnDemand) {
+  auto sir = serializeAndDeserializeLazyRef();
+
+  auto fun = sir->getStencilFunction("bar_fun");
+  ASSERT_TRUE(fun != nullptr);
+  EXPECT_EQ(*fun, *sirRef->StencilFunctions[1]);
+  EXPECT_EQ(sir->getStencilFunction("bar_fun"), fun);
+  EXPECT_EQ(sir->StencilFunctions.size(), 1);
+  EXPECT_TRUE(sir->Stencils.empty());
+
+  EXPECT_EQ(sir->getStencil("baz"), nullptr);
+  EXPECT_EQ(sir->getStencilFunction("foo"), nullptr);
+}
+
+TEST_P(LazyTest, Compare) {
+  auto sir = serializeAndDeserializeLazyRef();
+  sir->getStencil("foo");
+  EXPECT_TRUE(*sir == *sirRef);
+  EXPECT_EQ(sir->Stencils.size(), 1);
+
+  // SIRs which only differ in an entry which is not materialized are different
+  auto otherRef = serializeAndDeserializeLazyRef();
+  otherRef->materialize();
+  otherRef->getStencil("bar")->Fields[0]->Name = "other";
+  auto other = SIRSerializer::deserializeLazyFromString(
+      SIRSerializer::serializeToString(otherRef.get(), this->GetParam()), this->GetParam());
+  other->getStencil("foo");
+  EXPECT_FALSE(*sir == *other);
+  EXPECT_FALSE(*other == *sirRef);
+  EXPECT_EQ(sir->Stencils.size(), 1);
+  EXPECT_EQ(other->Stencils.size(), 1);
+}
+
+TEST_P(LazyTest, Serialize) {
+  // Serializing a partially materialized SIR includes the entries which are not materialized
+  auto sir = serializeAndDeserializeLazyRef();
+  sir->getStencil("bar");
+  sir->getStencilFunction("foo_fun");
+  SIR_EXCPECT_EQ(sirRef, SIRSerializer::deserializeFromString(
+                             SIRSerializer::serializeToString(sir.get(), this->GetParam()),
+                             this->GetParam()));
+}
+
+TEST_P(LazyTest, File) {
+  std::string file = "SIRSerializerTest_LazyTest_File.sir";
+  SIRSerializer::serialize(file, sirRef.get(), this->GetParam());
+  auto sir = SIRSerializer::deserializeLazy(file, this->GetParam());
+  sir->materialize();
+  SIR_EXCPECT_EQ(sirRef, sir);
+  std::remove(file.c_str());
+}
+
+TEST_P(LazyTest, Buffer) {
+  // The buffer is borrowed, it only has to stay valid until the SIR is materialized
+  std::shared_ptr<SIR> sir;
+  {
+    std::string str = SIRSerializer::serializeToString(sirRef.get(), this->GetParam());
+    sir = SIRSerializer::deserializeLazyFromBuffer(str.data(), str.size(), this->GetParam());
+    EXPECT_TRUE(sir->Stencils.empty());
+    sir->materialize();
+  }
+  SIR_EXCPECT_EQ(sirRef, sir);
+}
+
+TEST_P(LazyTest, InvalidInput) {
+  EXPECT_THROW(SIRSerializer::deserializeLazy("not-existing-file.sir", this->GetParam()),
+               std::runtime_error);
+
+  std::string str = SIRSerializer::serializeToString(sirRef.get(), this->GetParam());
+  EXPECT_THROW(SIRSerializer::deserializeLazyFromBuffer(str.data(), str.size() / 2,
+                                                        this->GetParam()),
+               std::runtime_error);
+}
+
+INSTANTIATE_TEST_CASE_P(SIRSerializeTest, LazyTest,
+                        ::testing::Values(SIRSerializer::SK_Json, SIRSerializer::SK_Byte));
+
 } // anonymous namespace
@@ -0,0 +1,116 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _                      
+//                         | |                     
+//                       __| | __ ___      ___ ___  
+//                      / _` |/ _` \ \ /\ / / '_  | 
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT). 
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+
+#include "dawn/Support/Logging.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dawn;
+
+namespace {
+
+class RecordingLogger : public LoggerInterface {
+public:
+  std::vector<std::pair<LoggingLevel, std::string>> Messages;
+
+  void log(LoggingLevel level, const std::string& message, const char* file, int line) override {
+    Messages.emplace_back(level, message);
+  }
+};
+
+class LoggingTest : public ::testing::Test {
+protected:
+  RecordingLogger logger_;
+
+  virtual void SetUp() override { Logger::getSingleton().registerLogger(&logger_); }
+  virtual void TearDown() override {
+    Logger::getSingleton().registerLogger(nullptr);
+    Logger::getSingleton().setLevel(LoggingLevel::Info);
+  }
+};
+
+int countEvaluations(int& count) { return ++count; }
+
+TEST_F(LoggingTest, Log) {
+  DAWN_LOG(INFO) << "foo " << 5;
+  DAWN_LOG(ERROR) << "bar";
+  ASSERT_EQ(logger_.Messages.size(), 2);
+  EXPECT_EQ(logger_.Messages[0].first, LoggingLevel::Info);
+  EXPECT_EQ(logger_.Messages[0].second, "foo 5");
+  EXPECT_EQ(logger_.Messages[1].first, LoggingLevel::Error);
+  EXPECT_EQ(logger_.Messages[1].second, "bar");
+}
+
+TEST_F(LoggingTest, Level) {
+  int count = 0;
+  Logger::getSingleton().setLevel(LoggingLevel::Warning);
+  EXPECT_FALSE(DAWN_LOG_IS_ON(INFO));
+  EXPECT_TRUE(DAWN_LOG_IS_ON(WARNING));
+
+  // Disabled log statements do not evaluate their arguments
+  DAWN_LOG(INFO) << countEvaluations(count);
+  EXPECT_EQ(count, 0);
+  EXPECT_TRUE(logger_.Messages.empty());
+
+  DAWN_LOG(WARNING) << countEvaluations(count);
+  EXPECT_EQ(count, 1);
+  ASSERT_EQ(logger_.Messages.size(), 1);
+  EXPECT_EQ(logger_.Messages[0].second, "1");
+}
+
+TEST_F(LoggingTest, NoLogger) {
+  int count = 0;
+  Logger::getSingleton().registerLogger(nullptr);
+  EXPECT_FALSE(DAWN_LOG_IS_ON(FATAL));
+  DAWN_LOG(FATAL) << countEvaluations(count);
+  EXPECT_EQ(count, 0);
+}
+
+TEST_F(LoggingTest, DanglingElse) {
+  bool logged = false;
+  if(logged)
+    DAWN_LOG(INFO) << "foo";
+  else
+    logged = true;
+  EXPECT_TRUE(logged);
+  EXPECT_TRUE(logger_.Messages.empty());
+}
+
+TEST_F(LoggingTest, MultiThreaded) {
+  const int numThreads = 4, numMessages = 200;
+
+  std::vector<std::thread> threads;
+  for(int t = 0; t < numThreads; ++t)
+    threads.emplace_back([=]() {
+      for(int i = 0; i < numMessages; ++i)
+        DAWN_LOG(INFO) << "thread " << t << " message " << i;
+    });
+  for(auto& thread : threads)
+    thread.join();
+
+  // Messages are neither lost nor interleaved
+  ASSERT_EQ(logger_.Messages.size(), numThreads * numMessages);
+  std::vector<int> next(numThreads, 0);
+  for(const auto& message : logger_.Messages) {
+    int t = message.second[7] - '0';
+    ASSERT_TRUE(t >= 0 && t < numThreads) << message.second;
+    EXPECT_EQ(message.second, "thread " + std::to_string(t) + " message " +
+                                  std::to_string(next[t]++));
+  }
+}
+
+} // anonymous namespace
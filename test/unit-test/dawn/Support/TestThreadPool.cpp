@@ -0,0 +1,51 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/ThreadPool.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace dawn;
+
+namespace {
+
+TEST(ThreadPoolTest, RunAllTasks) {
+  std::atomic<int> counter(0);
+  {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.getNumThreads(), 4);
+    for(int i = 0; i < 100; ++i)
+      pool.enqueue([&counter]() { ++counter; });
+  }
+  // The destructor finishes the pending tasks
+  EXPECT_EQ(counter, 100);
+}
+
+TEST(ThreadPoolTest, Submit) {
+  ThreadPool pool(2);
+  std::vector<std::future<int>> futures;
+  for(int i = 0; i < 10; ++i)
+    futures.emplace_back(pool.submit([i]() { return i * i; }));
+  for(int i = 0; i < 10; ++i)
+    EXPECT_EQ(futures[i].get(), i * i);
+}
+
+TEST(ThreadPoolTest, DefaultNumberOfThreads) {
+  ThreadPool pool;
+  EXPECT_GE(pool.getNumThreads(), 1);
+  EXPECT_GE(ThreadPool::getGlobal().getNumThreads(), 1);
+}
+
+} // anonymous namespace